@@ -165,6 +165,15 @@ ezStatus ezTextureAssetDocument::RunTexConv(const char* szTargetFile, const ezAs
   arguments << "-out";
   arguments << szTargetFile;
 
+  // Intermediate cache, shared by all textures of the data directory
+  {
+    ezStringBuilder sCacheDir = ezAssetCurator::GetSingleton()->FindDataDirectoryForAsset(GetDocumentPath());
+    sCacheDir.AppendPath("AssetCache", "TexConv");
+
+    arguments << "-cache";
+    arguments << QString::fromUtf8(sCacheDir.GetData());
+  }
+
   const ezStringBuilder sThumbnail = GetThumbnailFilePath();
   if (bUpdateThumbnail)
   {
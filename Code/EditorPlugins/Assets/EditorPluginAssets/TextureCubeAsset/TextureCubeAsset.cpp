@@ -55,6 +55,15 @@ ezStatus ezTextureCubeAssetDocument::RunTexConv(const char* szTargetFile, const
   arguments << "-out";
   arguments << szTargetFile;
 
+  // Intermediate cache, shared by all textures of the data directory
+  {
+    ezStringBuilder sCacheDir = ezAssetCurator::GetSingleton()->FindDataDirectoryForAsset(GetDocumentPath());
+    sCacheDir.AppendPath("AssetCache", "TexConv");
+
+    arguments << "-cache";
+    arguments << QString::fromUtf8(sCacheDir.GetData());
+  }
+
   const ezStringBuilder sThumbnail = GetThumbnailFilePath();
   if (bUpdateThumbnail)
   {
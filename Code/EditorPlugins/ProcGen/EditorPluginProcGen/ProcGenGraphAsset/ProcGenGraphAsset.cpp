@@ -90,7 +90,7 @@ struct ezProcGenGraphAssetDocument::GenerateContext
 
 ////////////////////////////////////////////////////////////////
 
-EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezProcGenGraphAssetDocument, 5, ezRTTINoAllocator)
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezProcGenGraphAssetDocument, 6, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
 ezProcGenGraphAssetDocument::ezProcGenGraphAssetDocument(const char* szDocumentPath)
@@ -130,6 +130,7 @@ ezStatus ezProcGenGraphAssetDocument::WriteAsset(ezStreamWriter& stream, const e
   chunk.BeginStream(1);
 
   ezExpressionCompiler compiler;
+  compiler.RegisterDefaultFunctions();
 
   auto WriteByteCode = [&](const ezDocumentObject* pOutputNode) {
     context.m_GraphContext.m_VolumeTagSetIndices.Clear();
@@ -535,28 +536,44 @@ void ezProcGenGraphAssetDocument::DumpSelectedOutput(bool bAst, bool bDisassembl
 
   if (bDisassembly)
   {
+    ezExpressionByteCode unoptimizedByteCode;
     ezExpressionByteCode byteCode;
 
+    // the unoptimized bytecode has to be compiled first since the AST is modified in place
     ezExpressionCompiler compiler;
-    if (compiler.Compile(ast, byteCode).Succeeded())
+    compiler.RegisterDefaultFunctions();
+    compiler.SetOptimizationsEnabled(false);
+    const bool bUnoptimizedSucceeded = compiler.Compile(ast, unoptimizedByteCode).Succeeded();
+    compiler.SetOptimizationsEnabled(true);
+
+    if (bUnoptimizedSucceeded && compiler.Compile(ast, byteCode).Succeeded())
     {
       ezStringBuilder sDisassembly;
       byteCode.Disassemble(sDisassembly);
 
-      ezStringBuilder sFileName;
-      sFileName.Format(":appdata/{0}_{1}_ByteCode.txt", sAssetName, sOutputName);
+      // shows which instructions were changed by the optimizations
+      ezStringBuilder sDisassemblyDiff;
+      byteCode.DisassembleDiff(unoptimizedByteCode, sDisassemblyDiff);
 
-      ezFileWriter fileWriter;
-      if (fileWriter.Open(sFileName).Succeeded())
-      {
-        fileWriter.WriteBytes(sDisassembly.GetData(), sDisassembly.GetElementCount()).IgnoreResult();
+      auto WriteFile = [&](const char* szSuffix, const ezStringBuilder& sContent) {
+        ezStringBuilder sFileName;
+        sFileName.Format(":appdata/{0}_{1}_{2}.txt", sAssetName, sOutputName, szSuffix);
 
-        ezLog::Info("Disassembly was dumped to: {0}", sFileName);
-      }
-      else
-      {
-        ezLog::Error("Failed to dump Disassembly to: {0}", sFileName);
-      }
+        ezFileWriter fileWriter;
+        if (fileWriter.Open(sFileName).Succeeded())
+        {
+          fileWriter.WriteBytes(sContent.GetData(), sContent.GetElementCount()).IgnoreResult();
+
+          ezLog::Info("Disassembly was dumped to: {0}", sFileName);
+        }
+        else
+        {
+          ezLog::Error("Failed to dump Disassembly to: {0}", sFileName);
+        }
+      };
+
+      WriteFile("ByteCode", sDisassembly);
+      WriteFile("ByteCodeDiff", sDisassemblyDiff);
     }
     else
     {
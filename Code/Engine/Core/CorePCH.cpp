@@ -31,6 +31,7 @@ EZ_STATICLINK_LIBRARY(Core)
   EZ_STATICLINK_REFERENCE(Core_Graphics_Implementation_Camera);
   EZ_STATICLINK_REFERENCE(Core_Graphics_Implementation_ConvexHull);
   EZ_STATICLINK_REFERENCE(Core_Graphics_Implementation_Geometry);
+  EZ_STATICLINK_REFERENCE(Core_Graphics_Implementation_OcclusionBuffer);
   EZ_STATICLINK_REFERENCE(Core_Input_DeviceTypes_DeviceTypes);
   EZ_STATICLINK_REFERENCE(Core_Input_Implementation_Action);
   EZ_STATICLINK_REFERENCE(Core_Input_Implementation_InputDevice);
@@ -49,6 +50,7 @@ EZ_STATICLINK_LIBRARY(Core)
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_Resource);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceHandle);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceLoading);
+  EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceLoadingQueue);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceManager);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_ResourceTypeLoader);
   EZ_STATICLINK_REFERENCE(Core_ResourceManager_Implementation_WorkerTasks);
@@ -72,6 +74,7 @@ EZ_STATICLINK_LIBRARY(Core)
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SettingsComponent);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialData);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem);
+  EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem_LooseOctree);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem_RegularGrid);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_World);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_WorldData);
@@ -0,0 +1,251 @@
+#include <Core/CorePCH.h>
+
+#include <Core/Graphics/OcclusionBuffer.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+
+namespace
+{
+  constexpr float s_fMinW = 1e-4f;
+
+  EZ_ALWAYS_INLINE float EdgeFunction(float ax, float ay, float bx, float by, float px, float py)
+  {
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+  }
+} // namespace
+
+ezOcclusionBuffer::ezOcclusionBuffer() = default;
+ezOcclusionBuffer::~ezOcclusionBuffer() = default;
+
+void ezOcclusionBuffer::Begin(ezUInt32 uiWidth, ezUInt32 uiHeight, const ezMat4& viewProjection)
+{
+  EZ_ASSERT_DEV(uiWidth > 0 && uiHeight > 0, "Invalid occlusion buffer resolution");
+
+  m_uiWidth = uiWidth;
+  m_uiHeight = uiHeight;
+  m_uiNumTilesX = (uiWidth + TILE_SIZE - 1) / TILE_SIZE;
+  m_uiNumTilesY = (uiHeight + TILE_SIZE - 1) / TILE_SIZE;
+  m_bHasOccluders = false;
+
+  m_ViewProjection = ezSimdConversion::ToMat4(viewProjection);
+  m_vScreenScale.Set(uiWidth * 0.5f, uiHeight * -0.5f, 1.0f, 0.0f);
+  m_vScreenOffset.Set(uiWidth * 0.5f, uiHeight * 0.5f, 0.0f, 0.0f);
+
+  m_Depth.SetCountUninitialized(uiWidth * uiHeight);
+  for (float& fDepth : m_Depth)
+  {
+    fDepth = ezMath::MaxValue<float>();
+  }
+
+  m_TileMaxDepth.SetCountUninitialized(m_uiNumTilesX * m_uiNumTilesY);
+  for (float& fDepth : m_TileMaxDepth)
+  {
+    fDepth = ezMath::MaxValue<float>();
+  }
+}
+
+void ezOcclusionBuffer::RasterizeTriangles(ezArrayPtr<const ezVec3> vertices, ezArrayPtr<const ezUInt32> indices, const ezMat4& transform)
+{
+  EZ_ASSERT_DEV(indices.GetCount() % 3 == 0, "Index count must be a multiple of 3");
+
+  const ezSimdMat4f mvp = m_ViewProjection * ezSimdConversion::ToMat4(transform);
+
+  for (ezUInt32 i = 0; i < indices.GetCount(); i += 3)
+  {
+    const ezSimdVec4f v0 = mvp.TransformPosition(ezSimdConversion::ToVec3(vertices[indices[i + 0]]));
+    const ezSimdVec4f v1 = mvp.TransformPosition(ezSimdConversion::ToVec3(vertices[indices[i + 1]]));
+    const ezSimdVec4f v2 = mvp.TransformPosition(ezSimdConversion::ToVec3(vertices[indices[i + 2]]));
+
+    RasterizeTriangle(v0, v1, v2);
+  }
+}
+
+void ezOcclusionBuffer::RasterizeBox(const ezBoundingBox& box, const ezMat4& transform)
+{
+  ezVec3 corners[8];
+  box.GetCorners(corners);
+
+  // GetCorners enumerates the corners with z changing fastest, then y, then x
+  static const ezUInt32 s_Indices[] = {
+    0, 1, 3, 0, 3, 2, // -x
+    4, 6, 7, 4, 7, 5, // +x
+    0, 4, 5, 0, 5, 1, // -y
+    2, 3, 7, 2, 7, 6, // +y
+    0, 2, 6, 0, 6, 4, // -z
+    1, 5, 7, 1, 7, 3, // +z
+  };
+
+  RasterizeTriangles(ezMakeArrayPtr(corners), ezMakeArrayPtr(s_Indices), transform);
+}
+
+void ezOcclusionBuffer::End()
+{
+  for (ezUInt32 ty = 0; ty < m_uiNumTilesY; ++ty)
+  {
+    const ezUInt32 uiMinY = ty * TILE_SIZE;
+    const ezUInt32 uiMaxY = ezMath::Min(uiMinY + TILE_SIZE, m_uiHeight);
+
+    for (ezUInt32 tx = 0; tx < m_uiNumTilesX; ++tx)
+    {
+      const ezUInt32 uiMinX = tx * TILE_SIZE;
+      const ezUInt32 uiMaxX = ezMath::Min(uiMinX + TILE_SIZE, m_uiWidth);
+
+      float fMaxDepth = -ezMath::MaxValue<float>();
+      for (ezUInt32 y = uiMinY; y < uiMaxY; ++y)
+      {
+        const float* pRow = m_Depth.GetData() + y * m_uiWidth;
+        for (ezUInt32 x = uiMinX; x < uiMaxX; ++x)
+        {
+          fMaxDepth = ezMath::Max(fMaxDepth, pRow[x]);
+        }
+      }
+
+      m_TileMaxDepth[ty * m_uiNumTilesX + tx] = fMaxDepth;
+    }
+  }
+}
+
+bool ezOcclusionBuffer::IsOccluded(const ezSimdBBox& box) const
+{
+  if (!m_bHasOccluders)
+    return false;
+
+  float fMinX = ezMath::MaxValue<float>();
+  float fMinY = ezMath::MaxValue<float>();
+  float fMaxX = -ezMath::MaxValue<float>();
+  float fMaxY = -ezMath::MaxValue<float>();
+  float fMinZ = ezMath::MaxValue<float>();
+
+  // The depth of a projected box is monotonic along its edges, so the closest point is always one of the corners
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    const ezSimdVec4b select((i & 1) != 0, (i & 2) != 0, (i & 4) != 0, false);
+    const ezSimdVec4f corner = ezSimdVec4f::Select(select, box.m_Max, box.m_Min);
+
+    const ezSimdVec4f clip = m_ViewProjection.TransformPosition(corner);
+    const float w = clip.w();
+    if (w < s_fMinW)
+      return false;
+
+    const ezSimdVec4f screen = ezSimdVec4f::MulAdd(clip.CompDiv(clip.Get<ezSwizzle::WWWW>()), m_vScreenScale, m_vScreenOffset);
+
+    const float x = screen.x();
+    const float y = screen.y();
+    fMinX = ezMath::Min(fMinX, x);
+    fMaxX = ezMath::Max(fMaxX, x);
+    fMinY = ezMath::Min(fMinY, y);
+    fMaxY = ezMath::Max(fMaxY, y);
+    fMinZ = ezMath::Min(fMinZ, (float)screen.z());
+  }
+
+  if (fMaxX < 0.0f || fMaxY < 0.0f || fMinX >= m_uiWidth || fMinY >= m_uiHeight)
+    return false;
+
+  // every pixel that the box touches has to be covered by an occluder in front of it
+  const ezUInt32 uiMinX = static_cast<ezUInt32>(ezMath::Max(fMinX, 0.0f));
+  const ezUInt32 uiMinY = static_cast<ezUInt32>(ezMath::Max(fMinY, 0.0f));
+  // clamp before converting, boxes close to the camera project to coordinates that don't fit into an integer
+  const ezUInt32 uiMaxX = static_cast<ezUInt32>(ezMath::Min(fMaxX, static_cast<float>(m_uiWidth - 1)));
+  const ezUInt32 uiMaxY = static_cast<ezUInt32>(ezMath::Min(fMaxY, static_cast<float>(m_uiHeight - 1)));
+
+  for (ezUInt32 ty = uiMinY / TILE_SIZE; ty <= uiMaxY / TILE_SIZE; ++ty)
+  {
+    for (ezUInt32 tx = uiMinX / TILE_SIZE; tx <= uiMaxX / TILE_SIZE; ++tx)
+    {
+      // the whole tile is in front of the box
+      if (m_TileMaxDepth[ty * m_uiNumTilesX + tx] < fMinZ)
+        continue;
+
+      const ezUInt32 uiTileMinX = ezMath::Max(tx * TILE_SIZE, uiMinX);
+      const ezUInt32 uiTileMaxX = ezMath::Min(tx * TILE_SIZE + TILE_SIZE - 1, uiMaxX);
+      const ezUInt32 uiTileMinY = ezMath::Max(ty * TILE_SIZE, uiMinY);
+      const ezUInt32 uiTileMaxY = ezMath::Min(ty * TILE_SIZE + TILE_SIZE - 1, uiMaxY);
+
+      for (ezUInt32 y = uiTileMinY; y <= uiTileMaxY; ++y)
+      {
+        const float* pRow = m_Depth.GetData() + y * m_uiWidth;
+        for (ezUInt32 x = uiTileMinX; x <= uiTileMaxX; ++x)
+        {
+          if (pRow[x] >= fMinZ)
+            return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+void ezOcclusionBuffer::RasterizeTriangle(const ezSimdVec4f& v0, const ezSimdVec4f& v1, const ezSimdVec4f& v2)
+{
+  // Skip triangles that cross the near plane instead of clipping them, this only removes occluders and is thus conservative.
+  if (v0.w() < s_fMinW || v1.w() < s_fMinW || v2.w() < s_fMinW)
+    return;
+
+  const ezSimdVec4f s0 = ezSimdVec4f::MulAdd(v0.CompDiv(v0.Get<ezSwizzle::WWWW>()), m_vScreenScale, m_vScreenOffset);
+  ezSimdVec4f s1 = ezSimdVec4f::MulAdd(v1.CompDiv(v1.Get<ezSwizzle::WWWW>()), m_vScreenScale, m_vScreenOffset);
+  ezSimdVec4f s2 = ezSimdVec4f::MulAdd(v2.CompDiv(v2.Get<ezSwizzle::WWWW>()), m_vScreenScale, m_vScreenOffset);
+
+  float fArea = EdgeFunction(s0.x(), s0.y(), s1.x(), s1.y(), s2.x(), s2.y());
+  if (ezMath::Abs(fArea) < 1e-8f)
+    return;
+
+  // occluders are double sided
+  if (fArea < 0.0f)
+  {
+    ezMath::Swap(s1, s2);
+    fArea = -fArea;
+  }
+
+  const float x0 = s0.x(), y0 = s0.y(), z0 = s0.z();
+  const float x1 = s1.x(), y1 = s1.y(), z1 = s1.z();
+  const float x2 = s2.x(), y2 = s2.y(), z2 = s2.z();
+
+  const float fMinX = ezMath::Max(ezMath::Min(x0, x1, x2), 0.0f);
+  const float fMinY = ezMath::Max(ezMath::Min(y0, y1, y2), 0.0f);
+  const float fMaxX = ezMath::Min(ezMath::Max(x0, x1, x2), (float)m_uiWidth - 0.5f);
+  const float fMaxY = ezMath::Min(ezMath::Max(y0, y1, y2), (float)m_uiHeight - 0.5f);
+
+  if (fMinX > fMaxX || fMinY > fMaxY)
+    return;
+
+  // pixels are sampled at their centers
+  const ezInt32 iMinX = static_cast<ezInt32>(ezMath::Floor(fMinX));
+  const ezInt32 iMinY = static_cast<ezInt32>(ezMath::Floor(fMinY));
+  const ezInt32 iMaxX = static_cast<ezInt32>(ezMath::Floor(fMaxX - 0.5f));
+  const ezInt32 iMaxY = static_cast<ezInt32>(ezMath::Floor(fMaxY - 0.5f));
+
+  // depth is linear in screen space, so it can be interpolated with the barycentric coordinates
+  const float fInvArea = 1.0f / fArea;
+
+  // edge function increments per step along x
+  const float e0dx = y1 - y2;
+  const float e1dx = y2 - y0;
+  const float e2dx = y0 - y1;
+
+  const float fStartX = iMinX + 0.5f;
+  float fStartY = iMinY + 0.5f;
+
+  for (ezInt32 y = iMinY; y <= iMaxY; ++y, fStartY += 1.0f)
+  {
+    float e0 = EdgeFunction(x1, y1, x2, y2, fStartX, fStartY);
+    float e1 = EdgeFunction(x2, y2, x0, y0, fStartX, fStartY);
+    float e2 = EdgeFunction(x0, y0, x1, y1, fStartX, fStartY);
+
+    float* pRow = m_Depth.GetData() + y * m_uiWidth;
+
+    for (ezInt32 x = iMinX; x <= iMaxX; ++x, e0 += e0dx, e1 += e1dx, e2 += e2dx)
+    {
+      if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f)
+        continue;
+
+      const float z = (e0 * z0 + e1 * z1 + e2 * z2) * fInvArea;
+      if (z < pRow[x])
+      {
+        pRow[x] = z;
+        m_bHasOccluders = true;
+      }
+    }
+  }
+}
+
+EZ_STATICLINK_FILE(Core, Core_Graphics_Implementation_OcclusionBuffer);
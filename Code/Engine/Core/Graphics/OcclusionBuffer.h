@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Core/CoreDLL.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/BoundingBox.h>
+#include <Foundation/SimdMath/SimdBBox.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
+
+/// \brief A small software rasterized depth buffer that is used to cull objects which are hidden behind occluders.
+///
+/// Usage per view and frame: call Begin(), rasterize the occluders with RasterizeTriangles() or RasterizeBox(), call End()
+/// and then pass the buffer to ezSpatialSystem::QueryParams::m_pOcclusionBuffer. Objects that are found to be occluded
+/// are not returned by ezSpatialSystem::FindVisibleObjects and do not count as visible for ezSpatialSystem::GetNumFramesSinceVisible.
+///
+/// The buffer stores normalized device depth, so the projection must map larger distances to larger depth values (no reversed depth).
+/// Occluders have to be conservative, i.e. they must not be bigger than the geometry they represent.
+/// Occluder triangles that cross the near plane are skipped.
+///
+/// After End() the buffer is only read, so IsOccluded() may be called from multiple threads at the same time.
+class EZ_CORE_DLL ezOcclusionBuffer
+{
+public:
+  ezOcclusionBuffer();
+  ~ezOcclusionBuffer();
+
+  /// \brief Sets the resolution and the view projection matrix and clears the buffer.
+  void Begin(ezUInt32 uiWidth, ezUInt32 uiHeight, const ezMat4& viewProjection);
+
+  /// \brief Rasterizes an indexed triangle list. Triangles are double sided. The vertices are transformed by 'transform' first.
+  void RasterizeTriangles(ezArrayPtr<const ezVec3> vertices, ezArrayPtr<const ezUInt32> indices, const ezMat4& transform);
+
+  /// \brief Rasterizes the faces of the given box, which is transformed by 'transform' first.
+  void RasterizeBox(const ezBoundingBox& box, const ezMat4& transform);
+
+  /// \brief Finishes rasterization and builds the coarse depth tiles that are used to speed up IsOccluded().
+  void End();
+
+  /// \brief Returns true if the given box is completely hidden behind the rasterized occluders.
+  ///
+  /// Boxes that cross the near plane or lie completely outside the screen are never reported as occluded.
+  bool IsOccluded(const ezSimdBBox& box) const;
+
+  /// \brief Returns whether any occluder pixels have been written since the last Begin().
+  bool HasOccluders() const { return m_bHasOccluders; }
+
+  ezUInt32 GetWidth() const { return m_uiWidth; }
+  ezUInt32 GetHeight() const { return m_uiHeight; }
+
+  /// \brief Returns the depth values row by row, mostly for debug visualizations. Pixels without occluders have a depth of ezMath::MaxValue<float>().
+  ezArrayPtr<const float> GetDepthData() const { return m_Depth; }
+
+private:
+  void RasterizeTriangle(const ezSimdVec4f& v0, const ezSimdVec4f& v1, const ezSimdVec4f& v2);
+
+  enum
+  {
+    TILE_SIZE = 8
+  };
+
+  ezSimdMat4f m_ViewProjection;
+  ezSimdVec4f m_vScreenScale;
+  ezSimdVec4f m_vScreenOffset;
+
+  ezUInt32 m_uiWidth = 0;
+  ezUInt32 m_uiHeight = 0;
+  ezUInt32 m_uiNumTilesX = 0;
+  ezUInt32 m_uiNumTilesY = 0;
+  bool m_bHasOccluders = false;
+
+  ezDynamicArray<float> m_Depth;
+  ezDynamicArray<float> m_TileMaxDepth; ///< The farthest depth of all pixels in a tile
+};
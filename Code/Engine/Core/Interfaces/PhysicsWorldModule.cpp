@@ -49,5 +49,52 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgBuildStaticMesh, 1, ezRTTIDefaultAllocator<
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+ezUInt32 ezPhysicsWorldModuleInterface::RaycastBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsCastBatch& rays, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  const ezUInt32 uiNumRays = rays.GetCount();
+  EZ_ASSERT_DEV(rays.m_Dirs.GetCount() == uiNumRays && rays.m_Distances.GetCount() == uiNumRays, "Invalid ray batch");
+  EZ_ASSERT_DEV(out_Results.GetCount() >= uiNumRays && out_Hits.GetCount() >= uiNumRays, "Output arrays are too small");
+
+  ezUInt32 uiNumHits = 0;
+  for (ezUInt32 i = 0; i < uiNumRays; ++i)
+  {
+    out_Hits[i] = Raycast(out_Results[i], rays.m_Starts[i], rays.m_Dirs[i], rays.m_Distances[i], params, collection);
+    uiNumHits += out_Hits[i] ? 1 : 0;
+  }
+
+  return uiNumHits;
+}
+
+ezUInt32 ezPhysicsWorldModuleInterface::SweepBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsCastBatch& spheres, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  const ezUInt32 uiNumSpheres = spheres.GetCount();
+  EZ_ASSERT_DEV(spheres.m_Dirs.GetCount() == uiNumSpheres && spheres.m_Distances.GetCount() == uiNumSpheres && spheres.m_Radii.GetCount() == uiNumSpheres, "Invalid sweep batch");
+  EZ_ASSERT_DEV(out_Results.GetCount() >= uiNumSpheres && out_Hits.GetCount() >= uiNumSpheres, "Output arrays are too small");
+
+  ezUInt32 uiNumHits = 0;
+  for (ezUInt32 i = 0; i < uiNumSpheres; ++i)
+  {
+    out_Hits[i] = SweepTestSphere(out_Results[i], spheres.m_Radii[i], spheres.m_Starts[i], spheres.m_Dirs[i], spheres.m_Distances[i], params, collection);
+    uiNumHits += out_Hits[i] ? 1 : 0;
+  }
+
+  return uiNumHits;
+}
+
+ezUInt32 ezPhysicsWorldModuleInterface::OverlapBatch(ezArrayPtr<bool> out_Overlaps, const ezPhysicsOverlapBatch& spheres, const ezPhysicsQueryParameters& params) const
+{
+  const ezUInt32 uiNumSpheres = spheres.GetCount();
+  EZ_ASSERT_DEV(spheres.m_Radii.GetCount() == uiNumSpheres, "Invalid overlap batch");
+  EZ_ASSERT_DEV(out_Overlaps.GetCount() >= uiNumSpheres, "Output array is too small");
+
+  ezUInt32 uiNumOverlaps = 0;
+  for (ezUInt32 i = 0; i < uiNumSpheres; ++i)
+  {
+    out_Overlaps[i] = OverlapTestSphere(spheres.m_Radii[i], spheres.m_Positions[i], params);
+    uiNumOverlaps += out_Overlaps[i] ? 1 : 0;
+  }
+
+  return uiNumOverlaps;
+}
 
 EZ_STATICLINK_FILE(Core, Core_Interfaces_PhysicsWorldModule);
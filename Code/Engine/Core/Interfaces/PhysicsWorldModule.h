@@ -73,6 +73,28 @@ enum class ezPhysicsHitCollection
   Any
 };
 
+/// \brief Describes many ray or sphere casts for the batched queries, stored as structure of arrays.
+///
+/// All arrays must have the same number of elements, except for m_Radii which is only needed for sweeps.
+struct ezPhysicsCastBatch
+{
+  ezArrayPtr<const ezVec3> m_Starts;
+  ezArrayPtr<const ezVec3> m_Dirs; ///< Normalized directions
+  ezArrayPtr<const float> m_Distances;
+  ezArrayPtr<const float> m_Radii; ///< Sphere radii for SweepBatch
+
+  ezUInt32 GetCount() const { return m_Starts.GetCount(); }
+};
+
+/// \brief Describes many sphere overlap tests for OverlapBatch, stored as structure of arrays.
+struct ezPhysicsOverlapBatch
+{
+  ezArrayPtr<const ezVec3> m_Positions;
+  ezArrayPtr<const float> m_Radii;
+
+  ezUInt32 GetCount() const { return m_Positions.GetCount(); }
+};
+
 class EZ_CORE_DLL ezPhysicsWorldModuleInterface : public ezWorldModule
 {
   EZ_ADD_DYNAMIC_REFLECTION(ezPhysicsWorldModuleInterface, ezWorldModule);
@@ -100,6 +122,20 @@ public:
 
   virtual void QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Results, float fSphereRadius, const ezVec3& vPosition, const ezPhysicsQueryParameters& params) const = 0;
 
+  /// \brief Casts all rays of the batch. out_Hits[i] tells whether ray i hit something, out_Results[i] is only written for hits.
+  ///
+  /// Both output arrays must have at least as many elements as the batch. Returns the number of hits.
+  /// The default implementation calls Raycast for every ray, physics engines may override this to process the batch more efficiently.
+  virtual ezUInt32 RaycastBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsCastBatch& rays, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const;
+
+  /// \brief Same as RaycastBatch but sweeps spheres with the radii given in the batch.
+  virtual ezUInt32 SweepBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsCastBatch& spheres, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const;
+
+  /// \brief Tests all spheres of the batch for overlaps. out_Overlaps[i] tells whether sphere i overlaps with any shape.
+  ///
+  /// Returns the number of overlapping spheres.
+  virtual ezUInt32 OverlapBatch(ezArrayPtr<bool> out_Overlaps, const ezPhysicsOverlapBatch& spheres, const ezPhysicsQueryParameters& params) const;
+
   virtual ezVec3 GetGravity() const = 0;
 
   virtual void AddStaticCollisionBox(ezGameObject* pObject, ezVec3 boxSize) {}
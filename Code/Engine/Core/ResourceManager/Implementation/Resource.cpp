@@ -131,6 +131,9 @@ void ezResource::CallUnloadData(Unload WhatToUnload)
   e.m_Type = ezResourceEvent::Type::ResourceContentUnloading;
   ezResourceManager::BroadcastResourceEvent(e);
 
+  // make all further acquisitions go through the resource manager before any data is gone
+  m_bIsFullyLoaded.store(false, std::memory_order_release);
+
   ezResourceLoadDesc ld = UnloadData(WhatToUnload);
 
   EZ_ASSERT_DEV(ld.m_State != ezResourceState::Invalid, "UnloadData() did not return a valid resource load state");
@@ -140,6 +143,15 @@ void ezResource::CallUnloadData(Unload WhatToUnload)
   m_LoadingState = ld.m_State;
   m_uiQualityLevelsDiscardable = ld.m_uiQualityLevelsDiscardable;
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
+
+  UpdateIsFullyLoaded();
+}
+
+void ezResource::UpdateIsFullyLoaded()
+{
+  // pairs with the acquire loads in ezResourceManager, every thread that sees the flag set also sees all data that was loaded before
+  const bool bIsFullyLoaded = m_LoadingState == ezResourceState::Loaded && (m_uiQualityLevelsLoadable == 0 || m_uiQualityLevelsDiscardable >= m_uiQualityLevelLimit);
+  m_bIsFullyLoaded.store(bIsFullyLoaded, std::memory_order_release);
 }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -181,6 +193,8 @@ void ezResource::CallUpdateContent(ezStreamReader* Stream)
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
   m_LoadingState = ld.m_State;
 
+  UpdateIsFullyLoaded();
+
   ezResourceEvent e;
   e.m_pResource = this;
   e.m_Type = ezResourceEvent::Type::ResourceContentUpdated;
@@ -265,6 +279,8 @@ void ezResource::VerifyAfterCreateResource(const ezResourceLoadDesc& ld)
   m_uiQualityLevelsDiscardable = ld.m_uiQualityLevelsDiscardable;
   m_uiQualityLevelsLoadable = ld.m_uiQualityLevelsLoadable;
 
+  UpdateIsFullyLoaded();
+
   /* Update Memory Usage*/
   {
     ezResource::MemoryUsage MemUsage;
@@ -16,12 +16,20 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
   if (s_State->s_bShutdown)
     return;
 
+  // Every acquisition of a resource that is not fully loaded ends up here, often from many threads at once.
+  // Reading the state without the lock is fine for these early outs, at worst a resource gets queued one acquisition later.
+  if (pResource->m_bIsFullyLoaded.load(std::memory_order_acquire))
+    return;
+
+  if (!bHighestPriority && IsQueuedForLoading(pResource))
+    return;
+
   EZ_PROFILE_SCOPE("InternalPreloadResource");
 
   EZ_LOCK(s_ResourceMutex);
 
   // if there is nothing else that could be loaded, just return right away
-  if (pResource->GetLoadingState() == ezResourceState::Loaded && pResource->GetNumQualityLevelsLoadable() == 0)
+  if (pResource->GetLoadingState() == ezResourceState::Loaded && (pResource->GetNumQualityLevelsLoadable() == 0 || pResource->GetNumQualityLevelsDiscardable() >= pResource->GetQualityLevelLimit()))
   {
     // due to the threading this can happen for all resource types and is valid
     // EZ_ASSERT_DEV(!IsQueuedForLoading(pResource), "Invalid flag on resource type '{0}'",
@@ -36,13 +44,11 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
   {
     // however, if it now has highest priority and is still in the loading queue (so not yet started)
     // move it to the front of the queue
-    if (bHighestPriority)
+    // if it is not in the queue anymore, it has already been started by some thread
+    if (bHighestPriority && s_State->s_LoadingQueue.Contains(pResource))
     {
-      // if it is not in the queue anymore, it has already been started by some thread
-      if (RemoveFromLoadingQueue(pResource).Succeeded())
-      {
-        AddToLoadingQueue(pResource, bHighestPriority);
-      }
+      pResource->SetPriority(ezResourcePriority::Critical);
+      s_State->s_LoadingQueue.Update(pResource, 0.0f, true);
     }
 
     return;
@@ -51,12 +57,11 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
   {
     AddToLoadingQueue(pResource, bHighestPriority);
 
-    if (bHighestPriority && ezTaskSystem::GetCurrentThreadWorkerType() == ezWorkerThreadType::FileAccess)
-    {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
-    }
+    // if a loader itself waits for this resource, it blocks its lane, so allow one more lane to make progress
+    // this applies to all lanes, no matter whether they run on the file access thread or as long running tasks
+    const bool bAllowExtraLane = bHighestPriority && ezResourceManagerWorkerDataLoad::IsLoadingOnCurrentThread();
 
-    RunWorkerTask(pResource);
+    StartDataLoadLanes(bAllowExtraLane);
   }
 }
 
@@ -93,7 +98,7 @@ void ezResourceManager::SetupWorkerTasks()
   }
 }
 
-void ezResourceManager::RunWorkerTask(ezResource* pResource)
+void ezResourceManager::StartDataLoadLanes(bool bAllowExtraLane)
 {
   if (s_State->s_bShutdown)
     return;
@@ -102,53 +107,94 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
 
   SetupWorkerTasks();
 
-  if (s_State->s_bAllowLaunchDataLoadTask && !s_State->s_LoadingQueue.IsEmpty())
+  // every active lane is busy with one resource and picks up the next one once it is done,
+  // so only start as many new lanes as there are queued resources
+  // a blocked lane may always start one more, otherwise several lanes that wait at the same time could use up all lanes
+  ezUInt32 uiMaxLanes = s_State->s_uiMaxDataLoadLanes;
+  if (bAllowExtraLane)
+  {
+    uiMaxLanes = ezMath::Max(uiMaxLanes, s_State->s_uiNumActiveDataLoadLanes + 1);
+  }
+
+  ezUInt32 uiNumLanesToStart = 0;
+
+  if (s_State->s_uiNumActiveDataLoadLanes < uiMaxLanes)
+  {
+    uiNumLanesToStart = ezMath::Min(uiMaxLanes - s_State->s_uiNumActiveDataLoadLanes, s_State->s_LoadingQueue.GetCount());
+  }
+
+  for (ezUInt32 uiLane = 0; uiLane < uiNumLanesToStart; ++uiLane)
   {
-    s_State->s_bAllowLaunchDataLoadTask = false;
+    // the first lane runs on the file access thread, additional lanes run on the long running task threads
+    const ezTaskPriority::Enum priority = s_State->s_uiNumActiveDataLoadLanes == 0 ? ezTaskPriority::FileAccess : ezTaskPriority::LongRunning;
+
+    ezResourceManagerState::TaskDataDataLoad* pData = nullptr;
 
     for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
     {
       if (s_State->s_WorkerTasksDataLoad[i].m_pTask->IsTaskFinished())
       {
-        s_State->s_WorkerTasksDataLoad[i].m_GroupId =
-          ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask, ezTaskPriority::FileAccess);
-        return;
+        pData = &s_State->s_WorkerTasksDataLoad[i];
+        break;
       }
     }
 
     // could not find any unused task -> need to create a new one
+    if (pData == nullptr)
     {
       ezStringBuilder s;
       s.Format("Resource Data Loader {0}", s_State->s_WorkerTasksDataLoad.GetCount());
-      auto& data = s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
-      data.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
-      data.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
-      data.m_GroupId = ezTaskSystem::StartSingleTask(data.m_pTask, ezTaskPriority::FileAccess);
+      pData = &s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
+      pData->m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
+      pData->m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
     }
+
+    ++s_State->s_uiNumActiveDataLoadLanes;
+    pData->m_GroupId = ezTaskSystem::StartSingleTask(pData->m_pTask, priority);
   }
 }
 
-void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
+ezResource* ezResourceManager::TakeNextResourceToLoad()
 {
-  // Yep, it's really bubble sort!
-  // This will move the entry with the smallest value to the front and move all other values closer to their correct position,
-  // which is exactly what we need for the priority queue.
-  // We do this once a frame, which gives us nice iterative sorting, with relatively deterministic performance characteristics.
-
   EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
 
-  const ezUInt32 uiCount = data.GetCount();
+  ezResourceLoadingQueue& queue = s_State->s_LoadingQueue;
 
-  for (ezUInt32 i = uiCount; i > 1; --i)
-  {
-    const ezUInt32 idx2 = i - 1;
-    const ezUInt32 idx1 = i - 2;
+  // take the most important resource whose type has not reached its concurrency limit yet
+  // critical resources ignore the limit, someone may be blocked on them (BlockTillLoaded), possibly while holding up one of the loads in flight
+  const ezUInt32 uiIndex = queue.FindFirst([](const ezResourceLoadingQueue::Entry& entry) {
+    if (entry.m_pResource->GetPriority() == ezResourcePriority::Critical)
+      return true;
 
-    if (data[idx1].m_fPriority > data[idx1].m_fPriority)
-    {
-      ezMath::Swap(data[idx1], data[idx2]);
-    }
-  }
+    const ResourceTypeInfo& info = GetResourceTypeInfo(entry.m_pResource->GetDynamicRTTI());
+    return info.m_uiMaxConcurrentLoads == 0 || info.m_uiNumLoadsInFlight < info.m_uiMaxConcurrentLoads;
+  });
+
+  if (uiIndex == ezInvalidIndex)
+    return nullptr;
+
+  const ezResourceLoadingQueue::Entry entry = queue.RemoveAt(uiIndex);
+  ++GetResourceTypeInfo(entry.m_pResource->GetDynamicRTTI()).m_uiNumLoadsInFlight;
+
+  const ezTime latency = ezTime::Now() - entry.m_EnqueueTime;
+
+  LoadingQueueStats& stats = s_State->s_LoadingQueueStats[static_cast<int>(entry.m_EnqueuePriority)];
+  ++stats.m_uiNumStarted;
+  stats.m_TotalLatency += latency;
+  stats.m_MaxLatency = ezMath::Max(stats.m_MaxLatency, latency);
+
+  static const char* s_szLatencyNames[] = {
+    "Resources/Queue Latency/Critical",
+    "Resources/Queue Latency/VeryHigh",
+    "Resources/Queue Latency/High",
+    "Resources/Queue Latency/Medium",
+    "Resources/Queue Latency/Low",
+    "Resources/Queue Latency/VeryLow",
+  };
+
+  EZ_PROFILE_HISTOGRAM(s_szLatencyNames[static_cast<int>(entry.m_EnqueuePriority)], latency);
+
+  return entry.m_pResource;
 }
 
 void ezResourceManager::UpdateLoadingDeadlines()
@@ -160,36 +206,26 @@ void ezResourceManager::UpdateLoadingDeadlines()
 
   EZ_PROFILE_SCOPE("UpdateLoadingDeadlines");
 
-  const ezUInt32 uiCount = s_State->s_LoadingQueue.GetCount();
-  s_State->s_uiLastResourcePriorityUpdateIdx = ezMath::Min(s_State->s_uiLastResourcePriorityUpdateIdx, uiCount);
+  // Re-evaluate a limited number of entries per frame, each one only costs O(log n) to re-sort.
+  // Entries move around in the heap while this happens, so this does not strictly visit every entry once per round,
+  // but it keeps the cost per frame bounded and all priorities reasonably up to date.
+  constexpr ezUInt32 uiMaxUpdatesPerFrame = 256;
 
-  ezUInt32 uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
+  ezResourceLoadingQueue& queue = s_State->s_LoadingQueue;
+  const ezUInt32 uiCount = queue.GetCount();
+  const ezUInt32 uiUpdateCount = ezMath::Min(uiMaxUpdatesPerFrame, uiCount);
 
-  if (uiUpdateCount == 0)
-  {
-    s_State->s_uiLastResourcePriorityUpdateIdx = 0;
-    uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
-  }
+  const ezTime tNow = ezTime::Now();
 
-  if (uiUpdateCount > 0)
+  for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
   {
-    {
-      EZ_PROFILE_SCOPE("EvalLoadingDeadlines");
+    if (s_State->s_uiLastResourcePriorityUpdateIdx >= uiCount)
+      s_State->s_uiLastResourcePriorityUpdateIdx = 0;
 
-      const ezTime tNow = ezTime::Now();
+    ezResource* pResource = queue[s_State->s_uiLastResourcePriorityUpdateIdx].m_pResource;
+    queue.Update(pResource, pResource->GetLoadingPriority(tNow), false);
 
-      for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
-      {
-        auto& element = s_State->s_LoadingQueue[s_State->s_uiLastResourcePriorityUpdateIdx];
-        element.m_fPriority = element.m_pResource->GetLoadingPriority(tNow);
-        ++s_State->s_uiLastResourcePriorityUpdateIdx;
-      }
-    }
-
-    {
-      EZ_PROFILE_SCOPE("SortLoadingDeadlines");
-      ReverseBubbleSortStep(s_State->s_LoadingQueue);
-    }
+    ++s_State->s_uiLastResourcePriorityUpdateIdx;
   }
 }
 
@@ -214,6 +250,38 @@ ezResourceState ezResourceManager::GetLoadingState(const ezTypelessResourceHandl
   return hResource.m_pResource->GetLoadingState();
 }
 
+void ezResourceManager::SetResourceQualityLevelLimit(const ezTypelessResourceHandle& hResource, ezUInt8 uiMaxQualityLevels)
+{
+  EZ_ASSERT_DEV(hResource.IsValid(), "Cannot limit the quality levels of an invalid resource handle.");
+
+  ezResource* pResource = hResource.m_pResource;
+
+  EZ_LOCK(s_ResourceMutex);
+
+  pResource->m_uiQualityLevelLimit = uiMaxQualityLevels;
+  pResource->UpdateIsFullyLoaded();
+
+  if (pResource->GetLoadingState() != ezResourceState::Loaded)
+    return;
+
+  if (pResource->GetNumQualityLevelsDiscardable() > uiMaxQualityLevels)
+  {
+    // if a loader already picked up the resource, it will be in a different state soon, try again later
+    if (RemoveFromLoadingQueue(pResource).Failed())
+      return;
+
+    pResource->CallUnloadData(ezResource::Unload::OneQualityLevel);
+
+    ezResource::MemoryUsage MemUsage;
+    pResource->UpdateMemoryUsage(MemUsage);
+    pResource->m_MemoryUsage = MemUsage;
+  }
+  else if (pResource->GetNumQualityLevelsDiscardable() < uiMaxQualityLevels && pResource->GetNumQualityLevelsLoadable() > 0)
+  {
+    InternalPreloadResource(pResource, false);
+  }
+}
+
 ezResult ezResourceManager::RemoveFromLoadingQueue(ezResource* pResource)
 {
   EZ_ASSERT_DEV(s_ResourceMutex.IsLocked(), "Resource mutex must be locked");
@@ -221,10 +289,7 @@ ezResult ezResourceManager::RemoveFromLoadingQueue(ezResource* pResource)
   if (!IsQueuedForLoading(pResource))
     return EZ_SUCCESS;
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
-  if (s_State->s_LoadingQueue.RemoveAndSwap(li))
+  if (s_State->s_LoadingQueue.Remove(pResource))
   {
     pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     return EZ_SUCCESS;
@@ -240,22 +305,49 @@ void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPr
 
   pResource->m_Flags.Add(ezResourceFlags::IsQueuedForLoading);
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
   if (bHighestPriority)
   {
     pResource->SetPriority(ezResourcePriority::Critical);
-    li.m_fPriority = 0.0f;
-    s_State->s_LoadingQueue.PushFront(li);
+    s_State->s_LoadingQueue.Insert(pResource, 0.0f, true, ezTime::Now());
   }
   else
   {
-    li.m_fPriority = pResource->GetLoadingPriority(s_State->s_LastFrameUpdate);
-    s_State->s_LoadingQueue.PushBack(li);
+    s_State->s_LoadingQueue.Insert(pResource, pResource->GetLoadingPriority(s_State->s_LastFrameUpdate), false, ezTime::Now());
   }
 }
 
+void ezResourceManager::SetMaxConcurrentDataLoads(ezUInt32 uiMaxLoads)
+{
+  EZ_ASSERT_DEV(uiMaxLoads > 0, "At least one resource must be allowed to load at a time");
+
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_uiMaxDataLoadLanes = uiMaxLoads;
+
+  StartDataLoadLanes(false);
+}
+
+ezUInt32 ezResourceManager::GetMaxConcurrentDataLoads()
+{
+  return s_State->s_uiMaxDataLoadLanes;
+}
+
+void ezResourceManager::SetResourceTypeMaxConcurrentLoads(const ezRTTI* pResourceType, ezUInt32 uiMaxLoads)
+{
+  EZ_LOCK(s_ResourceMutex);
+  GetResourceTypeInfo(pResourceType).m_uiMaxConcurrentLoads = uiMaxLoads;
+
+  StartDataLoadLanes(false);
+}
+
+ezResourceManager::LoadingQueueStats ezResourceManager::GetLoadingQueueStats(ezResourcePriority priority)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  LoadingQueueStats stats = s_State->s_LoadingQueueStats[static_cast<int>(priority)];
+  stats.m_uiNumQueued = s_State->s_LoadingQueue.GetNumQueued(priority);
+  return stats;
+}
+
 bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
 {
   EZ_LOCK(s_ResourceMutex);
@@ -285,10 +377,7 @@ bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
   {
     bAllowPreloading = false;
 
-    LoadingInfo li;
-    li.m_pResource = pResource;
-
-    if (s_State->s_LoadingQueue.IndexOf(li) == ezInvalidIndex)
+    if (!s_State->s_LoadingQueue.Contains(pResource))
     {
       // the resource is marked as 'loading' but it is not in the queue anymore
       // that means some task is already working on loading it
@@ -0,0 +1,163 @@
+#include <Core/CorePCH.h>
+
+#include <Core/ResourceManager/Implementation/ResourceLoadingQueue.h>
+#include <Core/ResourceManager/Resource.h>
+
+ezResourceLoadingQueue::ezResourceLoadingQueue() = default;
+ezResourceLoadingQueue::~ezResourceLoadingQueue() = default;
+
+void ezResourceLoadingQueue::Insert(ezResource* pResource, float fPriority, bool bFront, ezTime tNow)
+{
+  EZ_ASSERT_DEV(pResource->m_uiLoadingQueueIndex == ezInvalidIndex, "Resource is already in the loading queue");
+
+  Entry entry;
+  entry.m_fPriority = fPriority;
+  entry.m_iSequence = bFront ? m_iNextFrontSequence-- : m_iNextBackSequence++;
+  entry.m_pResource = pResource;
+  entry.m_EnqueueTime = tNow;
+  entry.m_EnqueuePriority = pResource->GetPriority();
+
+  ++m_NumQueued[static_cast<int>(entry.m_EnqueuePriority)];
+
+  const ezUInt32 uiIndex = m_Heap.GetCount();
+  m_Heap.PushBack(entry);
+  pResource->m_uiLoadingQueueIndex = uiIndex;
+
+  SiftUp(uiIndex);
+}
+
+void ezResourceLoadingQueue::Update(ezResource* pResource, float fPriority, bool bFront)
+{
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  EZ_ASSERT_DEV(uiIndex < m_Heap.GetCount() && m_Heap[uiIndex].m_pResource == pResource, "Resource is not in the loading queue");
+
+  Entry& entry = m_Heap[uiIndex];
+  const bool bMovesUp = bFront || fPriority < entry.m_fPriority;
+
+  entry.m_fPriority = fPriority;
+  if (bFront)
+  {
+    entry.m_iSequence = m_iNextFrontSequence--;
+  }
+
+  if (bMovesUp)
+    SiftUp(uiIndex);
+  else
+    SiftDown(uiIndex);
+}
+
+bool ezResourceLoadingQueue::Remove(ezResource* pResource)
+{
+  if (!Contains(pResource))
+    return false;
+
+  RemoveAt(pResource->m_uiLoadingQueueIndex);
+  return true;
+}
+
+ezResourceLoadingQueue::Entry ezResourceLoadingQueue::RemoveAt(ezUInt32 uiIndex)
+{
+  Entry removed = m_Heap[uiIndex];
+  removed.m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+  --m_NumQueued[static_cast<int>(removed.m_EnqueuePriority)];
+
+  const ezUInt32 uiLast = m_Heap.GetCount() - 1;
+  if (uiIndex != uiLast)
+  {
+    Place(uiIndex, m_Heap[uiLast]);
+    m_Heap.PopBack();
+
+    // the moved entry may belong further up or further down
+    if (uiIndex > 0 && IsLess(uiIndex, (uiIndex - 1) / 2))
+      SiftUp(uiIndex);
+    else
+      SiftDown(uiIndex);
+  }
+  else
+  {
+    m_Heap.PopBack();
+  }
+
+  return removed;
+}
+
+bool ezResourceLoadingQueue::Contains(const ezResource* pResource) const
+{
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  return uiIndex < m_Heap.GetCount() && m_Heap[uiIndex].m_pResource == pResource;
+}
+
+void ezResourceLoadingQueue::Clear()
+{
+  for (const Entry& entry : m_Heap)
+  {
+    entry.m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+  }
+
+  m_Heap.Clear();
+
+  for (ezUInt32& uiNumQueued : m_NumQueued)
+  {
+    uiNumQueued = 0;
+  }
+}
+
+bool ezResourceLoadingQueue::IsLess(ezUInt32 uiIndexA, ezUInt32 uiIndexB) const
+{
+  const Entry& a = m_Heap[uiIndexA];
+  const Entry& b = m_Heap[uiIndexB];
+
+  if (a.m_fPriority != b.m_fPriority)
+    return a.m_fPriority < b.m_fPriority;
+
+  return a.m_iSequence < b.m_iSequence;
+}
+
+void ezResourceLoadingQueue::Place(ezUInt32 uiIndex, const Entry& entry)
+{
+  m_Heap[uiIndex] = entry;
+  entry.m_pResource->m_uiLoadingQueueIndex = uiIndex;
+}
+
+void ezResourceLoadingQueue::SiftUp(ezUInt32 uiIndex)
+{
+  while (uiIndex > 0)
+  {
+    const ezUInt32 uiParent = (uiIndex - 1) / 2;
+    if (!IsLess(uiIndex, uiParent))
+      break;
+
+    const Entry tmp = m_Heap[uiParent];
+    Place(uiParent, m_Heap[uiIndex]);
+    Place(uiIndex, tmp);
+
+    uiIndex = uiParent;
+  }
+}
+
+void ezResourceLoadingQueue::SiftDown(ezUInt32 uiIndex)
+{
+  const ezUInt32 uiCount = m_Heap.GetCount();
+
+  while (true)
+  {
+    const ezUInt32 uiLeft = uiIndex * 2 + 1;
+    if (uiLeft >= uiCount)
+      break;
+
+    ezUInt32 uiSmallest = uiLeft;
+    if (uiLeft + 1 < uiCount && IsLess(uiLeft + 1, uiLeft))
+      uiSmallest = uiLeft + 1;
+
+    if (!IsLess(uiSmallest, uiIndex))
+      break;
+
+    const Entry tmp = m_Heap[uiSmallest];
+    Place(uiSmallest, m_Heap[uiIndex]);
+    Place(uiIndex, tmp);
+
+    uiIndex = uiSmallest;
+  }
+}
+
+EZ_STATICLINK_FILE(Core, Core_ResourceManager_Implementation_ResourceLoadingQueue);
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <Core/CoreInternal.h>
+EZ_CORE_INTERNAL_HEADER
+
+#include <Core/ResourceManager/Implementation/Declarations.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/Time/Time.h>
+
+/// \brief [internal] The queue of resources that are waiting to be loaded.
+///
+/// This is a binary min-heap keyed on the loading priority, lower values get loaded first. Every queued resource stores its position in
+/// the heap, so removing a resource or changing its priority is O(log n) as well. Resources with equal priority are loaded in the order in
+/// which they were queued, unless they were explicitly moved to the front.
+///
+/// The queue is not thread-safe, all functions must be called with the resource manager mutex locked.
+class ezResourceLoadingQueue
+{
+public:
+  struct Entry
+  {
+    float m_fPriority = 0.0f;
+    ezInt64 m_iSequence = 0; ///< Breaks ties between entries with equal priority
+    ezResource* m_pResource = nullptr;
+    ezTime m_EnqueueTime;
+    ezResourcePriority m_EnqueuePriority = ezResourcePriority::Medium; ///< The resource priority at the time it was queued, for the queue statistics
+  };
+
+  ezResourceLoadingQueue();
+  ~ezResourceLoadingQueue();
+
+  bool IsEmpty() const { return m_Heap.IsEmpty(); }
+  ezUInt32 GetCount() const { return m_Heap.GetCount(); }
+
+  /// \brief Returns the entry at the given heap position. Index 0 is always the entry that would be loaded next.
+  const Entry& operator[](ezUInt32 uiIndex) const { return m_Heap[uiIndex]; }
+
+  /// \brief Adds the resource to the queue. If bFront is true, it is placed in front of all other entries with the same priority.
+  void Insert(ezResource* pResource, float fPriority, bool bFront, ezTime tNow);
+
+  /// \brief Changes the priority of a queued resource. If bFront is true, it is placed in front of all other entries with the same priority.
+  void Update(ezResource* pResource, float fPriority, bool bFront);
+
+  /// \brief Removes the resource from the queue. Returns false if the resource was not queued.
+  bool Remove(ezResource* pResource);
+
+  /// \brief Removes and returns the entry at the given heap position.
+  Entry RemoveAt(ezUInt32 uiIndex);
+
+  bool Contains(const ezResource* pResource) const;
+
+  /// \brief Returns the heap position of the entry with the lowest priority value that passes the predicate, or ezInvalidIndex.
+  ///
+  /// The heap is searched best-first, so only entries that are better than the returned one and their direct children are visited.
+  template <typename Predicate>
+  ezUInt32 FindFirst(Predicate pred) const;
+
+  void Clear();
+
+  const Entry* begin() const { return m_Heap.GetData(); }
+  const Entry* end() const { return m_Heap.GetData() + m_Heap.GetCount(); }
+
+  /// \brief Returns how many queued resources had the given priority when they were queued.
+  ezUInt32 GetNumQueued(ezResourcePriority priority) const { return m_NumQueued[static_cast<int>(priority)]; }
+
+private:
+  bool IsLess(ezUInt32 uiIndexA, ezUInt32 uiIndexB) const;
+  void Place(ezUInt32 uiIndex, const Entry& entry);
+  void SiftUp(ezUInt32 uiIndex);
+  void SiftDown(ezUInt32 uiIndex);
+
+  ezDynamicArray<Entry> m_Heap;
+  ezInt64 m_iNextBackSequence = 0;
+  ezInt64 m_iNextFrontSequence = -1;
+  ezUInt32 m_NumQueued[static_cast<int>(ezResourcePriority::VeryLow) + 1] = {};
+};
+
+template <typename Predicate>
+ezUInt32 ezResourceLoadingQueue::FindFirst(Predicate pred) const
+{
+  if (m_Heap.IsEmpty())
+    return ezInvalidIndex;
+
+  // the candidates are the children of all rejected entries, there are only few of them, so a linear search for the best one is fine
+  ezHybridArray<ezUInt32, 32> candidates;
+  candidates.PushBack(0);
+
+  while (!candidates.IsEmpty())
+  {
+    ezUInt32 uiBest = 0;
+    for (ezUInt32 i = 1; i < candidates.GetCount(); ++i)
+    {
+      if (IsLess(candidates[i], candidates[uiBest]))
+        uiBest = i;
+    }
+
+    const ezUInt32 uiIndex = candidates[uiBest];
+    if (pred(m_Heap[uiIndex]))
+      return uiIndex;
+
+    candidates.RemoveAtAndSwap(uiBest);
+
+    const ezUInt32 uiChild = uiIndex * 2 + 1;
+    if (uiChild < m_Heap.GetCount())
+      candidates.PushBack(uiChild);
+    if (uiChild + 1 < m_Heap.GetCount())
+      candidates.PushBack(uiChild + 1);
+  }
+
+  return ezInvalidIndex;
+}
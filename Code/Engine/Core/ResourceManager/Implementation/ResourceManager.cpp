@@ -496,6 +496,11 @@ void ezResourceManager::PerFrameUpdate()
     }
 
     s_State->s_ResourcesToUnloadOnMainThread.Clear();
+
+    UpdateLoadingDeadlines();
+
+    EZ_PROFILE_COUNTER("Resources/Loading Queue", s_State->s_LoadingQueue.GetCount());
+    EZ_PROFILE_COUNTER("Resources/Loading Lanes", s_State->s_uiNumActiveDataLoadLanes);
   }
 
   if (s_State->m_AutoFreeUnusedTimeout.IsPositive())
@@ -541,7 +546,6 @@ void ezResourceManager::OnCoreStartup()
   s_State = EZ_DEFAULT_NEW(ezResourceManagerState);
 
   EZ_LOCK(s_ResourceMutex);
-  s_State->s_bAllowLaunchDataLoadTask = true;
   s_State->s_bShutdown = false;
 
   ezPlugin::Events().AddEventHandler(PluginEventHandler);
@@ -558,8 +562,7 @@ void ezResourceManager::EngineAboutToShutdown()
       return;
     }
 
-    s_State->s_bAllowLaunchDataLoadTask = false; // prevent a new one from starting
-    s_State->s_bShutdown = true;
+    s_State->s_bShutdown = true; // prevent new loads from starting
   }
 
   for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
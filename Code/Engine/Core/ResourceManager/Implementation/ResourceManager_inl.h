@@ -110,11 +110,6 @@ ResourceType* ezResourceManager::BeginAcquireResource(const ezTypedResourceHandl
     "The requested resource does not have the same type ('{0}') as the resource handle ('{1}').", pResource->GetDynamicRTTI()->GetTypeName(),
     ezGetStaticRTTI<ResourceType>()->GetTypeName());
 
-  if (mode == ezResourceAcquireMode::AllowLoadingFallback && GetForceNoFallbackAcquisition() > 0)
-  {
-    mode = ezResourceAcquireMode::BlockTillLoaded;
-  }
-
   if (mode == ezResourceAcquireMode::PointerOnly)
   {
     if (out_AcquireResult)
@@ -126,7 +121,27 @@ ResourceType* ezResourceManager::BeginAcquireResource(const ezTypedResourceHandl
 
   // only set the last accessed time stamp, if it is actually needed, pointer-only access might not mean that the resource is used
   // productively
-  pResource->m_LastAcquire = GetLastFrameUpdate();
+  // the same resources are acquired by many threads in the same frame, only writing the time stamp once keeps the cache line shared
+  const ezTime tLastFrameUpdate = GetLastFrameUpdate();
+  if (pResource->m_LastAcquire != tLastFrameUpdate)
+  {
+    pResource->m_LastAcquire = tLastFrameUpdate;
+  }
+
+  // the common case, nothing needs to be loaded, so no lock is needed either
+  if (pResource->m_bIsFullyLoaded.load(std::memory_order_acquire))
+  {
+    if (out_AcquireResult)
+      *out_AcquireResult = ezResourceAcquireResult::Final;
+
+    //pResource->m_iLockCount.Increment();
+    return pResource;
+  }
+
+  if (mode == ezResourceAcquireMode::AllowLoadingFallback && GetForceNoFallbackAcquisition() > 0)
+  {
+    mode = ezResourceAcquireMode::BlockTillLoaded;
+  }
 
   if (pResource->GetLoadingState() != ezResourceState::LoadedResourceMissing)
   {
@@ -162,7 +177,8 @@ ResourceType* ezResourceManager::BeginAcquireResource(const ezTypedResourceHandl
       // as long as there are more quality levels available, schedule the resource for more loading
       // accessing IsQueuedForLoading without a lock here is save because InternalPreloadResource() will lock and early out if necessary
       // and accidentally skipping InternalPreloadResource() is no problem
-      if (IsQueuedForLoading(pResource) == false && pResource->GetNumQualityLevelsLoadable() > 0)
+      if (IsQueuedForLoading(pResource) == false && pResource->GetNumQualityLevelsLoadable() > 0 &&
+          pResource->GetNumQualityLevelsDiscardable() < pResource->GetQualityLevelLimit())
         InternalPreloadResource(pResource, false);
     }
   }
@@ -8,10 +8,55 @@
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
 
+namespace
+{
+  /// \brief Reads the serialized file path from a small buffer and then continues with the file content directly from the mapped memory.
+  class MappedFileStreamReader : public ezStreamReader
+  {
+  public:
+    void Reset(ezArrayPtr<const ezUInt8> header, ezArrayPtr<const ezUInt8> content)
+    {
+      m_Parts[0] = header;
+      m_Parts[1] = content;
+    }
+
+    virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override
+    {
+      ezUInt8* pBuffer = static_cast<ezUInt8*>(pReadBuffer);
+      ezUInt64 uiBytesRead = 0;
+
+      for (ezArrayPtr<const ezUInt8>& part : m_Parts)
+      {
+        const ezUInt32 uiChunk = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiBytesToRead - uiBytesRead, part.GetCount()));
+
+        if (pBuffer != nullptr)
+        {
+          ezMemoryUtils::Copy(pBuffer + uiBytesRead, part.GetPtr(), uiChunk);
+        }
+
+        part = part.GetSubArray(uiChunk);
+        uiBytesRead += uiChunk;
+      }
+
+      return uiBytesRead;
+    }
+
+    virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override { return ReadBytes(nullptr, uiBytesToSkip); }
+
+  private:
+    ezArrayPtr<const ezUInt8> m_Parts[2];
+  };
+} // namespace
+
 struct FileResourceLoadData
 {
   ezBlob m_Storage;
   ezRawMemoryStreamReader m_Reader;
+
+  // used instead of the above, when the file content can be accessed without copying it
+  ezFileReader m_File;
+  ezHybridArray<ezUInt8, 256> m_PathStorage;
+  MappedFileStreamReader m_MappedReader;
 };
 
 ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pResource)
@@ -20,9 +65,14 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   ezResourceLoadData res;
 
-  ezFileReader File;
+  FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
+
+  ezFileReader& File = pData->m_File;
   if (File.Open(pResource->GetResourceID().GetData()).Failed())
+  {
+    EZ_DEFAULT_DELETE(pData);
     return res;
+  }
 
   res.m_sResourceDescription = File.GetFilePathRelative().GetData();
 
@@ -35,7 +85,21 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
 #endif
 
-  FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
+  res.m_pCustomLoaderData = pData;
+
+  const ezArrayPtr<const ezUInt8> mappedContent = File.GetMappedContent();
+  if (mappedContent.GetPtr() != nullptr)
+  {
+    // the file stays open until CloseDataStream(), so the content is read directly from the mapped memory, without a copy
+    ezMemoryStreamContainerWrapperStorage<ezHybridArray<ezUInt8, 256>> storage(&pData->m_PathStorage);
+    ezMemoryStreamWriter w(&storage);
+    w << File.GetFilePathAbsolute();
+
+    pData->m_MappedReader.Reset(pData->m_PathStorage, mappedContent);
+    res.m_pDataStream = &pData->m_MappedReader;
+
+    return res;
+  }
 
   const ezUInt64 uiFileSize = File.GetFileSize();
 
@@ -55,7 +119,8 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   pData->m_Reader.Reset(pBlobPtr, w.GetNumWrittenBytes() + uiFileSize);
   res.m_pDataStream = &pData->m_Reader;
-  res.m_pCustomLoaderData = pData;
+
+  File.Close();
 
   return res;
 }
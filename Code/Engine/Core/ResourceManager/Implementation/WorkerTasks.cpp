@@ -5,10 +5,44 @@
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Profiling/Profiling.h>
 
+static thread_local bool s_bIsLoadingLane = false;
+
 ezResourceManagerWorkerDataLoad::ezResourceManagerWorkerDataLoad() = default;
 ezResourceManagerWorkerDataLoad::~ezResourceManagerWorkerDataLoad() = default;
 
+bool ezResourceManagerWorkerDataLoad::IsLoadingOnCurrentThread()
+{
+  return s_bIsLoadingLane;
+}
+
 void ezResourceManagerWorkerDataLoad::Execute()
+{
+  // a lane that waits for another resource may execute a different lane on the same thread in the mean time
+  const bool bIsNestedLane = s_bIsLoadingLane;
+  s_bIsLoadingLane = true;
+
+  if (bIsNestedLane)
+  {
+    // the outer lane can't continue until this one returns, so only load a single resource and leave the rest to other lanes
+    if (LoadNextResource())
+    {
+      EZ_LOCK(ezResourceManager::s_ResourceMutex);
+      --ezResourceManager::s_State->s_uiNumActiveDataLoadLanes;
+      ezResourceManager::StartDataLoadLanes(false);
+    }
+  }
+  else
+  {
+    // every data load task is one loading lane, it keeps loading resources until there is nothing left that it is allowed to load
+    while (LoadNextResource())
+    {
+    }
+  }
+
+  s_bIsLoadingLane = bIsNestedLane;
+}
+
+bool ezResourceManagerWorkerDataLoad::LoadNextResource()
 {
   EZ_PROFILE_SCOPE("LoadResourceFromDisk");
 
@@ -19,17 +53,16 @@ void ezResourceManagerWorkerDataLoad::Execute()
   {
     EZ_LOCK(ezResourceManager::s_ResourceMutex);
 
-    if (ezResourceManager::s_State->s_LoadingQueue.IsEmpty())
+    if (!ezResourceManager::s_State->s_bShutdown)
     {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
-      return;
+      pResourceToLoad = ezResourceManager::TakeNextResourceToLoad();
     }
 
-    ezResourceManager::UpdateLoadingDeadlines();
-
-    auto it = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
-    pResourceToLoad = it.m_pResource;
-    ezResourceManager::s_State->s_LoadingQueue.PopFront();
+    if (pResourceToLoad == nullptr)
+    {
+      --ezResourceManager::s_State->s_uiNumActiveDataLoadLanes;
+      return false;
+    }
 
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
@@ -48,7 +81,9 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
   EZ_ASSERT_DEV(pLoader != nullptr, "No Loader function available for Resource Type '{0}'", pResourceToLoad->GetDynamicRTTI()->GetTypeName());
 
+  const ezTime tLoadStart = ezTime::Now();
   ezResourceLoadData LoaderData = pLoader->OpenDataStream(pResourceToLoad);
+  EZ_PROFILE_HISTOGRAM("Resources/Load From Disk", ezTime::Now() - tLoadStart);
 
   // we need this info later to do some work in a lock, all the directly following code is outside the lock
   const bool bResourceIsLoadedOnMainThread = pResourceToLoad->GetBaseResourceFlags().IsAnySet(ezResourceFlags::UpdateOnMainThread);
@@ -99,12 +134,10 @@ void ezResourceManagerWorkerDataLoad::Execute()
     *pUpdateContentGroup = ezTaskSystem::StartSingleTask(
       pUpdateContentTask, bResourceIsLoadedOnMainThread ? ezTaskPriority::SomeFrameMainThread : ezTaskPriority::LateNextFrame);
 
-    // restart the next loading task (this one is about to finish)
-    ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
-    ezResourceManager::RunWorkerTask(nullptr);
-
     pCustomLoader.Clear();
   }
+
+  return true;
 }
 
 
@@ -120,12 +153,6 @@ void ezResourceManagerWorkerUpdateContent::Execute()
 
   m_pResourceToLoad->CallUpdateContent(m_LoaderData.m_pDataStream);
 
-  if (m_pResourceToLoad->m_uiQualityLevelsLoadable > 0)
-  {
-    // if the resource can have more details loaded, put it into the preload queue right away again
-    ezResourceManager::PreloadResource(m_pResourceToLoad);
-  }
-
   // update the file modification date, if available
   if (m_LoaderData.m_LoadedFileModificationDate.IsValid())
     m_pResourceToLoad->m_LoadedFileModificationTime = m_LoaderData.m_LoadedFileModificationDate;
@@ -154,6 +181,20 @@ void ezResourceManagerWorkerUpdateContent::Execute()
     EZ_ASSERT_DEV(ezResourceManager::IsQueuedForLoading(m_pResourceToLoad), "Multi-threaded access detected");
     m_pResourceToLoad->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     m_pResourceToLoad->m_LastAcquire = ezResourceManager::GetLastFrameUpdate();
+
+    // the quality level limit may have changed while the content was updated
+    m_pResourceToLoad->UpdateIsFullyLoaded();
+
+    // this may allow a resource of the same type to be loaded, if the type has a concurrency limit
+    --ezResourceManager::GetResourceTypeInfo(m_pResourceToLoad->GetDynamicRTTI()).m_uiNumLoadsInFlight;
+
+    if (m_pResourceToLoad->m_uiQualityLevelsLoadable > 0)
+    {
+      // if the resource can have more details loaded, put it into the preload queue right away again
+      // this has to happen after the resource was removed from the queue, otherwise it is ignored
+      ezResourceManager::PreloadResource(m_pResourceToLoad);
+    }
+    ezResourceManager::StartDataLoadLanes(false);
   }
 
   m_pLoader = nullptr;
@@ -11,6 +11,9 @@ class EZ_CORE_DLL ezResourceManagerWorkerDataLoad final : public ezTask
 public:
   ~ezResourceManagerWorkerDataLoad();
 
+  /// \brief Returns whether the calling thread currently executes a data load task, i.e. whether it is one of the loading lanes.
+  static bool IsLoadingOnCurrentThread();
+
 private:
   friend class ezResourceManager;
   friend class ezResourceManagerState;
@@ -18,6 +21,9 @@ private:
   ezResourceManagerWorkerDataLoad();
 
   virtual void Execute() override;
+
+  /// \brief Loads the next resource from the loading queue and hands it over to an update content task. Returns false if there was nothing to load.
+  bool LoadNextResource();
 };
 
 /// \brief [internal] Worker task for uploading resource data.
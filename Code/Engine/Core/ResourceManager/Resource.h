@@ -5,6 +5,8 @@
 #include <Foundation/Reflection/Reflection.h>
 #include <Foundation/Time/Timestamp.h>
 
+#include <atomic>
+
 /// \brief The base class for all resources.
 class EZ_CORE_DLL ezResource : public ezReflectedClass
 {
@@ -80,6 +82,11 @@ public:
   /// \brief Returns how many quality levels the resource may additionally load.
   EZ_ALWAYS_INLINE ezUInt8 GetNumQualityLevelsLoadable() const { return m_uiQualityLevelsLoadable; }
 
+  /// \brief Returns how many quality levels the resource manager loads at most for this resource.
+  ///
+  /// By default there is no limit (0xFF). See ezResourceManager::SetResourceQualityLevelLimit().
+  EZ_ALWAYS_INLINE ezUInt8 GetQualityLevelLimit() const { return m_uiQualityLevelLimit; }
+
   /// \brief Returns the priority that is used by the resource manager to determine which resource to load next.
   float GetLoadingPriority(ezTime tNow) const;
 
@@ -135,12 +142,16 @@ private:
   friend class ezResourceManager;
   friend class ezResourceManagerWorkerDataLoad;
   friend class ezResourceManagerWorkerUpdateContent;
+  friend class ezResourceLoadingQueue;
 
   /// \brief Called by ezResourceManager shortly after resource creation.
   void SetUniqueID(const char* szUniqueID, bool bIsReloadable);
 
   void CallUnloadData(Unload WhatToUnload);
 
+  /// \brief Recomputes m_bIsFullyLoaded after the loading state, the quality levels or the quality level limit changed.
+  void UpdateIsFullyLoaded();
+
   /// \brief Requests the resource to unload another quality level. If bFullUnload is true, the resource should unload all data, because it
   /// is going to be deleted afterwards.
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) = 0;
@@ -167,6 +178,12 @@ private:
 
   ezUInt8 m_uiQualityLevelsDiscardable = 0;
   ezUInt8 m_uiQualityLevelsLoadable = 0;
+  ezUInt8 m_uiQualityLevelLimit = 0xFF;
+
+  /// Set while the resource is loaded and does not need to load any more quality levels.
+  /// ezResourceManager::BeginAcquireResource() returns such resources right away, without taking any lock.
+  /// Written with release and read with acquire semantics, so that a thread that sees the flag also sees the loaded data.
+  std::atomic<bool> m_bIsFullyLoaded = {false};
 
 
 protected:
@@ -228,6 +245,7 @@ private:
   ezTime m_LastAcquire;
   ezResourcePriority m_Priority = ezResourcePriority::Medium;
   ezTimestamp m_LoadedFileModificationTime;
+  ezUInt32 m_uiLoadingQueueIndex = ezInvalidIndex; ///< Position in the loading queue of the resource manager, only valid while it is queued
 
 private:
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
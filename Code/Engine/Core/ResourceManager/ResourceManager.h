@@ -118,6 +118,50 @@ public:
   /// \brief Returns the current loading state of the given resource.
   static ezResourceState GetLoadingState(const ezTypelessResourceHandle& hResource);
 
+  /// \brief Limits how many quality levels of the given resource are loaded and moves the resource one step towards that limit.
+  ///
+  /// If the resource has more quality levels loaded than allowed, one quality level is unloaded right away (unless the resource is
+  /// currently being loaded). If it has fewer loaded and could load more, it is queued for loading. Once the limit is reached, the
+  /// resource manager does not load further quality levels on its own anymore. Call this repeatedly (e.g. once per frame), to step
+  /// down multiple quality levels. Pass 0xFF to remove the limit again.
+  ///
+  /// This is used to stream resources in and out depending on how much memory is available, e.g. by ezTextureStreamingManager.
+  static void SetResourceQualityLevelLimit(const ezTypelessResourceHandle& hResource, ezUInt8 uiMaxQualityLevels);
+
+  /// \brief Sets how many resources may be loaded from disk at the same time. The default is 4.
+  ///
+  /// The first loader runs on the file access thread, all others run as long running tasks.
+  static void SetMaxConcurrentDataLoads(ezUInt32 uiMaxLoads);
+
+  /// \sa SetMaxConcurrentDataLoads()
+  static ezUInt32 GetMaxConcurrentDataLoads();
+
+  /// \brief Limits how many resources of the given type may be loading at the same time. 0 means no limit, which is the default.
+  ///
+  /// A resource counts as loading from the moment it is taken from the loading queue until its content has been updated.
+  /// This can be used to prevent a few types with very large resources from occupying all loaders.
+  /// Resources with ezResourcePriority::Critical, which includes all resources that are acquired with BlockTillLoaded, ignore the limit.
+  template <typename ResourceType>
+  static void SetResourceTypeMaxConcurrentLoads(ezUInt32 uiMaxLoads)
+  {
+    SetResourceTypeMaxConcurrentLoads(ezGetStaticRTTI<ResourceType>(), uiMaxLoads);
+  }
+
+  /// \sa SetResourceTypeMaxConcurrentLoads()
+  static void SetResourceTypeMaxConcurrentLoads(const ezRTTI* pResourceType, ezUInt32 uiMaxLoads);
+
+  /// \brief Statistics about the loading queue for one ezResourcePriority.
+  struct LoadingQueueStats
+  {
+    ezUInt32 m_uiNumQueued = 0;   ///< Number of resources with this priority that are currently waiting in the queue
+    ezUInt64 m_uiNumStarted = 0;  ///< Number of resources with this priority that have been taken out of the queue for loading so far
+    ezTime m_TotalLatency;        ///< Accumulated time that these resources spent in the queue before loading started
+    ezTime m_MaxLatency;          ///< The longest time a resource with this priority spent in the queue
+  };
+
+  /// \brief Returns the loading queue statistics for resources that had the given priority when they were queued.
+  static LoadingQueueStats GetLoadingQueueStats(ezResourcePriority priority);
+
   ///@}
   /// \name Reloading resources
   ///@{
@@ -437,14 +481,6 @@ private:
     ezHashTable<ezTempHashedString, ezResource*> m_Resources;
   };
 
-  struct LoadingInfo
-  {
-    float m_fPriority = 0;
-    ezResource* m_pResource = nullptr;
-
-    EZ_ALWAYS_INLINE bool operator==(const LoadingInfo& rhs) const { return m_pResource == rhs.m_pResource; }
-    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const { return m_fPriority < rhs.m_fPriority; }
-  };
   static void EnsureResourceLoadingState(ezResource* pResource, const ezResourceState RequestedState);
   static void PreloadResource(ezResource* pResource);
   static void InternalPreloadResource(ezResource* pResource, bool bHighestPriority);
@@ -452,9 +488,9 @@ private:
   template <typename ResourceType>
   static ResourceType* GetResource(const char* szResourceID, bool bIsReloadable);
   static ezResource* GetResource(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable);
-  static void RunWorkerTask(ezResource* pResource);
+  static void StartDataLoadLanes(bool bAllowExtraLane);
+  static ezResource* TakeNextResourceToLoad();
   static void UpdateLoadingDeadlines();
-  static void ReverseBubbleSortStep(ezDeque<LoadingInfo>& data);
   static bool ReloadResource(ezResource* pResource, bool bForce);
 
   static void SetupWorkerTasks();
@@ -470,6 +506,8 @@ private:
   {
     bool m_bIncrementalUnload = true;
     bool m_bAllowNestedAcquireCached = false;
+    ezUInt32 m_uiMaxConcurrentLoads = 0;
+    ezUInt32 m_uiNumLoadsInFlight = 0;
 
     ezHybridArray<const ezRTTI*, 8> m_NestedTypes;
   };
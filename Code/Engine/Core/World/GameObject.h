@@ -571,6 +571,10 @@ private:
     void UpdateGlobalBounds();
     void UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSystem);
 
+    /// \brief Updates the global bounds and returns true, if the spatial data needs to be informed about the new bounds.
+    /// Used to collect bounds changes for ezSpatialSystem::UpdateSpatialDataBoundsBatch.
+    bool UpdateGlobalBoundsAndCheckSpatialData();
+
     void UpdateVelocity(const ezSimdFloat& fInvDeltaSeconds);
 
     void RecreateSpatialData(ezSpatialSystem& spatialSystem);
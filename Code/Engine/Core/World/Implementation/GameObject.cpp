@@ -1072,12 +1072,7 @@ void ezGameObject::TransformationData::UpdateGlobalBounds(ezSpatialSystem* pSpat
 
 void ezGameObject::TransformationData::UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSystem)
 {
-  ezSimdBBoxSphere oldGlobalBounds = m_globalBounds;
-
-  UpdateGlobalBounds();
-
-  const bool bIsAlwaysVisible = m_localBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
-  if (m_hSpatialData.IsInvalidated() == false && bIsAlwaysVisible == false && m_globalBounds != oldGlobalBounds)
+  if (UpdateGlobalBoundsAndCheckSpatialData())
   {
     spatialSystem.UpdateSpatialDataBounds(m_hSpatialData, m_globalBounds);
   }
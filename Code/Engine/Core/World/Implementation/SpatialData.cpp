@@ -57,6 +57,7 @@ const ezBitflags<ezSpatialData::Flags>& ezSpatialData::GetCategoryFlags(Category
 
 ezSpatialData::Category ezDefaultSpatialDataCategories::RenderStatic = ezSpatialData::RegisterCategory("RenderStatic", ezSpatialData::Flags::None);
 ezSpatialData::Category ezDefaultSpatialDataCategories::RenderDynamic = ezSpatialData::RegisterCategory("RenderDynamic", ezSpatialData::Flags::FrequentChanges);
+ezSpatialData::Category ezDefaultSpatialDataCategories::Occluder = ezSpatialData::RegisterCategory("Occluder", ezSpatialData::Flags::None);
 
 
 EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialData);
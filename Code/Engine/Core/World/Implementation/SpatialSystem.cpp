@@ -1,6 +1,9 @@
 #include <Core/CorePCH.h>
 
 #include <Core/World/SpatialSystem.h>
+#include <Foundation/Configuration/CVar.h>
+
+ezCVarInt cvar_SpatialCullingParallelThreshold("Spatial.Culling.ParallelThreshold", 4096, ezCVarFlags::Default, "Minimum number of objects in the visible cells of a visibility query before culling is split into multiple tasks, 0 disables it");
 
 // clang-format off
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem, 1, ezRTTINoAllocator)
@@ -19,6 +22,14 @@ void ezSpatialSystem::StartNewFrame()
   ++m_uiFrameCounter;
 }
 
+void ezSpatialSystem::UpdateSpatialDataBoundsBatch(ezArrayPtr<const BoundsUpdate> updates)
+{
+  for (const BoundsUpdate& update : updates)
+  {
+    UpdateSpatialDataBounds(update.m_hData, *update.m_pBounds);
+  }
+}
+
 void ezSpatialSystem::FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, ezDynamicArray<ezGameObject*>& out_Objects) const
 {
   FindObjectsInSphere(
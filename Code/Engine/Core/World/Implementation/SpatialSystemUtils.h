@@ -0,0 +1,420 @@
+#pragma once
+
+#include <Core/Graphics/OcclusionBuffer.h>
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Math/Frustum.h>
+#include <Foundation/SimdMath/SimdBSphere.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Types/TagSet.h>
+
+extern ezCVarInt cvar_SpatialCullingParallelThreshold;
+
+/// \brief Helper functions that are shared between the spatial system implementations.
+namespace ezSpatialSystemUtils
+{
+  /// \brief Returns true if the given tags should be filtered out by the given include and exclude tags.
+  EZ_ALWAYS_INLINE bool FilterByTags(const ezTagSet& tags, const ezTagSet& includeTags, const ezTagSet& excludeTags)
+  {
+    if (!excludeTags.IsEmpty() && excludeTags.IsAnySet(tags))
+      return true;
+
+    if (!includeTags.IsEmpty() && !includeTags.IsAnySet(tags))
+      return true;
+
+    return false;
+  }
+
+  /// \brief The six frustum planes in SoA layout for the sphere tests below.
+  struct PlaneData
+  {
+    ezSimdVec4f m_x0x1x2x3;
+    ezSimdVec4f m_y0y1y2y3;
+    ezSimdVec4f m_z0z1z2z3;
+    ezSimdVec4f m_w0w1w2w3;
+
+    ezSimdVec4f m_x4x5x4x5;
+    ezSimdVec4f m_y4y5y4y5;
+    ezSimdVec4f m_z4z5z4z5;
+    ezSimdVec4f m_w4w5w4w5;
+
+    // Every plane component broadcast to all lanes, used to test four spheres at once
+    ezSimdVec4f m_PlaneX[6];
+    ezSimdVec4f m_PlaneY[6];
+    ezSimdVec4f m_PlaneZ[6];
+    ezSimdVec4f m_PlaneW[6];
+  };
+
+  inline void SetupPlaneData(const ezFrustum& frustum, PlaneData& out_PlaneData)
+  {
+    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
+    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
+    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
+    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
+    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
+    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
+    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
+
+    ezSimdMat4f helperMat;
+    helperMat.SetRows(plane0, plane1, plane2, plane3);
+
+    out_PlaneData.m_x0x1x2x3 = helperMat.m_col0;
+    out_PlaneData.m_y0y1y2y3 = helperMat.m_col1;
+    out_PlaneData.m_z0z1z2z3 = helperMat.m_col2;
+    out_PlaneData.m_w0w1w2w3 = helperMat.m_col3;
+
+    helperMat.SetRows(plane4, plane5, plane4, plane5);
+
+    out_PlaneData.m_x4x5x4x5 = helperMat.m_col0;
+    out_PlaneData.m_y4y5y4y5 = helperMat.m_col1;
+    out_PlaneData.m_z4z5z4z5 = helperMat.m_col2;
+    out_PlaneData.m_w4w5w4w5 = helperMat.m_col3;
+
+    const ezSimdVec4f planes[6] = {plane0, plane1, plane2, plane3, plane4, plane5};
+    for (ezUInt32 i = 0; i < 6; ++i)
+    {
+      out_PlaneData.m_PlaneX[i] = planes[i].Get<ezSwizzle::XXXX>();
+      out_PlaneData.m_PlaneY[i] = planes[i].Get<ezSwizzle::YYYY>();
+      out_PlaneData.m_PlaneZ[i] = planes[i].Get<ezSwizzle::ZZZZ>();
+      out_PlaneData.m_PlaneW[i] = planes[i].Get<ezSwizzle::WWWW>();
+    }
+  }
+
+  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
+  {
+    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
+    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
+    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
+    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
+
+    ezSimdVec4f dot_0123;
+    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
+
+    ezSimdVec4f dot_4545;
+    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
+
+    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
+    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
+    return (cmp_0123 || cmp_4545).NoneSet<4>();
+  }
+
+  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
+  {
+    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
+    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
+    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
+    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
+
+    ezSimdVec4f dotA_0123;
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
+    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
+
+    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
+    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
+    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
+    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
+
+    ezSimdVec4f dotB_0123;
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
+    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
+
+    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
+    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
+    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
+    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
+
+    ezSimdVec4f dot_A45B45;
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
+    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
+
+    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
+    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
+    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
+
+    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
+    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
+
+    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
+    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
+
+    return result;
+  }
+
+  /// \brief Tests four consecutive spheres against the frustum. Returns a bitmask with bit i set if sphere i intersects the frustum.
+  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect4(const ezSimdBSphere* pSpheres, const PlaneData& planeData)
+  {
+    // transpose into x0x1x2x3, y0y1y2y3, z0z1z2z3, r0r1r2r3
+    ezSimdMat4f spheres;
+    spheres.SetRows(pSpheres[0].m_CenterAndRadius, pSpheres[1].m_CenterAndRadius, pSpheres[2].m_CenterAndRadius, pSpheres[3].m_CenterAndRadius);
+
+    ezSimdVec4b outside(false);
+    for (ezUInt32 i = 0; i < 6; ++i)
+    {
+      ezSimdVec4f dot = ezSimdVec4f::MulAdd(spheres.m_col0, planeData.m_PlaneX[i], planeData.m_PlaneW[i]);
+      dot = ezSimdVec4f::MulAdd(spheres.m_col1, planeData.m_PlaneY[i], dot);
+      dot = ezSimdVec4f::MulAdd(spheres.m_col2, planeData.m_PlaneZ[i], dot);
+
+      outside = outside || (dot > spheres.m_col3);
+    }
+
+    return (!outside).GetBitmask();
+  }
+
+  template <typename T>
+  struct ShapeQueryData
+  {
+    T m_Shape;
+    ezSpatialSystem::QueryCallback m_Callback;
+  };
+
+  /// \brief Tests all objects of a bucket (a grid cell or octree node) against the given shape.
+  ///
+  /// The bucket has to provide m_Bounds and the object arrays m_BoundingSpheres, m_TagSets and m_ObjectPointers.
+  template <typename T, bool UseTagsFilter, typename BucketType, typename StatsType>
+  ezVisitorExecution::Enum ShapeQuery(const BucketType& bucket, const ezSpatialSystem::QueryParams& queryParams, StatsType& stats, const ShapeQueryData<T>& queryData)
+  {
+    T shape = queryData.m_Shape;
+
+    ezSimdBBox bucketBox = bucket.m_Bounds.GetBox();
+    if (!bucketBox.Overlaps(shape))
+      return ezVisitorExecution::Continue;
+
+    auto boundingSpheres = bucket.m_BoundingSpheres.GetData();
+    auto tagSets = bucket.m_TagSets.GetData();
+    auto objectPointers = bucket.m_ObjectPointers.GetData();
+
+    const ezUInt32 numSpheres = bucket.m_BoundingSpheres.GetCount();
+    stats.m_uiNumObjectsTested += numSpheres;
+
+    for (ezUInt32 i = 0; i < numSpheres; ++i)
+    {
+      if (!shape.Overlaps(boundingSpheres[i]))
+        continue;
+
+      if (UseTagsFilter)
+      {
+        if (FilterByTags(tagSets[i], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
+        {
+          stats.m_uiNumObjectsFiltered++;
+          continue;
+        }
+      }
+
+      stats.m_uiNumObjectsPassed++;
+
+      if (queryData.m_Callback(objectPointers[i]) == ezVisitorExecution::Stop)
+        return ezVisitorExecution::Stop;
+    }
+
+    return ezVisitorExecution::Continue;
+  }
+
+  struct FrustumQueryData
+  {
+    PlaneData m_PlaneData;
+    ezDynamicArray<const ezGameObject*>* m_pOutObjects;
+    const ezOcclusionBuffer* m_pOcclusionBuffer;
+    ezUInt64 m_uiFrameCounter;
+  };
+
+  inline void SetupFrustumQueryData(const ezFrustum& frustum, const ezSpatialSystem::QueryParams& queryParams, ezUInt64 uiFrameCounter, ezDynamicArray<const ezGameObject*>& out_Objects, FrustumQueryData& out_QueryData)
+  {
+    SetupPlaneData(frustum, out_QueryData.m_PlaneData);
+
+    out_QueryData.m_pOutObjects = &out_Objects;
+    out_QueryData.m_pOcclusionBuffer = (queryParams.m_pOcclusionBuffer != nullptr && queryParams.m_pOcclusionBuffer->HasOccluders()) ? queryParams.m_pOcclusionBuffer : nullptr;
+    out_QueryData.m_uiFrameCounter = uiFrameCounter;
+  }
+
+  /// \brief Tests all objects of a bucket against the frustum and the optional occlusion buffer, writes the visible ones to pOutObjects
+  /// and marks them as visible in the current frame. Returns the number of visible objects.
+  ///
+  /// pOutObjects must have room for all objects of the bucket.
+  /// In addition to the arrays needed by ShapeQuery, the bucket has to provide m_LastVisibleFrames.
+  template <bool UseTagsFilter, typename BucketType, typename StatsType>
+  ezUInt32 FrustumQuery(const BucketType& bucket, const ezSpatialSystem::QueryParams& queryParams, StatsType& stats, const FrustumQueryData& queryData, const ezGameObject** pOutObjects)
+  {
+    const PlaneData& planeData = queryData.m_PlaneData;
+    const ezOcclusionBuffer* pOcclusionBuffer = queryData.m_pOcclusionBuffer;
+
+    ezSimdBSphere bucketSphere = bucket.m_Bounds.GetSphere();
+    if (!SphereFrustumIntersect(bucketSphere, planeData))
+      return 0;
+
+    if (pOcclusionBuffer != nullptr && pOcclusionBuffer->IsOccluded(bucket.m_Bounds.GetBox()))
+      return 0;
+
+    auto boundingSpheres = bucket.m_BoundingSpheres.GetData();
+    auto tagSets = bucket.m_TagSets.GetData();
+    auto objectPointers = bucket.m_ObjectPointers.GetData();
+    auto lastVisibleFrames = bucket.m_LastVisibleFrames.GetData();
+
+    const ezUInt32 numSpheres = bucket.m_BoundingSpheres.GetCount();
+    stats.m_uiNumObjectsTested += numSpheres;
+
+    ezUInt32 uiNumVisible = 0;
+
+    auto addObject = [&](ezUInt32 i) {
+      if (UseTagsFilter)
+      {
+        if (FilterByTags(tagSets[i], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
+        {
+          stats.m_uiNumObjectsFiltered++;
+          return;
+        }
+      }
+
+      if (pOcclusionBuffer != nullptr)
+      {
+        const ezSimdVec4f& centerAndRadius = boundingSpheres[i].m_CenterAndRadius;
+
+        ezSimdBBox objectBox;
+        objectBox.SetCenterAndHalfExtents(centerAndRadius, centerAndRadius.Get<ezSwizzle::WWWW>());
+
+        if (pOcclusionBuffer->IsOccluded(objectBox))
+        {
+          stats.m_uiNumObjectsOccluded++;
+          return;
+        }
+      }
+
+      lastVisibleFrames[i] = queryData.m_uiFrameCounter;
+      pOutObjects[uiNumVisible] = objectPointers[i];
+      ++uiNumVisible;
+
+      stats.m_uiNumObjectsPassed++;
+    };
+
+    ezUInt32 currentIndex = 0;
+
+    while (currentIndex < numSpheres)
+    {
+      if (numSpheres - currentIndex >= 32)
+      {
+        ezUInt32 mask = 0;
+
+        // eight spheres per iteration as two independent groups of four
+        for (ezUInt32 i = 0; i < 32; i += 8)
+        {
+          const ezUInt32 maskA = SphereFrustumIntersect4(boundingSpheres + currentIndex + i + 0, planeData);
+          const ezUInt32 maskB = SphereFrustumIntersect4(boundingSpheres + currentIndex + i + 4, planeData);
+
+          mask |= (maskA | (maskB << 4)) << i;
+        }
+
+        while (mask > 0)
+        {
+          ezUInt32 i = ezMath::FirstBitLow(mask) + currentIndex;
+          mask &= mask - 1;
+
+          addObject(i);
+        }
+
+        currentIndex += 32;
+      }
+      else
+      {
+        ezUInt32 i = currentIndex;
+        ++currentIndex;
+
+        if (!SphereFrustumIntersect(boundingSpheres[i], planeData))
+          continue;
+
+        addObject(i);
+      }
+    }
+
+    return uiNumVisible;
+  }
+
+  /// \brief Runs FrustumQuery for all given buckets and appends the visible objects to queryData.m_pOutObjects.
+  ///
+  /// If the buckets contain more objects than cvar_SpatialCullingParallelThreshold, they are distributed over multiple tasks.
+  /// Every bucket writes into its own section of the output array which is compacted afterwards,
+  /// so the result has the same order as in the serial case.
+  template <bool UseTagsFilter, typename BucketType, typename StatsType>
+  void FrustumQueryBuckets(ezArrayPtr<const BucketType*> buckets, const ezSpatialSystem::QueryParams& queryParams, StatsType& stats, const FrustumQueryData& queryData)
+  {
+    ezUInt32 uiMaxNumVisible = 0;
+    for (const BucketType* pBucket : buckets)
+    {
+      uiMaxNumVisible += pBucket->m_BoundingSpheres.GetCount();
+    }
+
+    auto& outObjects = *queryData.m_pOutObjects;
+    const ezUInt32 uiStartIndex = outObjects.GetCount();
+    outObjects.SetCountUninitialized(uiStartIndex + uiMaxNumVisible);
+
+    const ezGameObject** pOutObjects = outObjects.GetData() + uiStartIndex;
+    ezUInt32 uiNumVisible = 0;
+
+    const ezUInt32 uiParallelThreshold = static_cast<ezUInt32>(ezMath::Max(cvar_SpatialCullingParallelThreshold.GetValue(), 0));
+    if (buckets.GetCount() < 2 || uiParallelThreshold == 0 || uiMaxNumVisible < uiParallelThreshold)
+    {
+      for (const BucketType* pBucket : buckets)
+      {
+        uiNumVisible += FrustumQuery<UseTagsFilter>(*pBucket, queryParams, stats, queryData, pOutObjects + uiNumVisible);
+      }
+    }
+    else
+    {
+      struct BucketResult
+      {
+        ezUInt32 m_uiOffset = 0;
+        ezUInt32 m_uiNumVisible = 0;
+        StatsType m_Stats;
+      };
+
+      ezDynamicArray<BucketResult> results;
+      results.SetCount(buckets.GetCount());
+
+      ezUInt32 uiOffset = 0;
+      for (ezUInt32 i = 0; i < buckets.GetCount(); ++i)
+      {
+        results[i].m_uiOffset = uiOffset;
+        uiOffset += buckets[i]->m_BoundingSpheres.GetCount();
+      }
+
+      ezParallelForParams parallelForParams;
+      parallelForParams.splitMode = ezParallelForSplitMode::Lazy;
+      parallelForParams.uiBinSize = 1;
+
+      ezTaskSystem::ParallelForIndexed(
+        0, buckets.GetCount(),
+        [&](ezUInt32 uiStartBucket, ezUInt32 uiEndBucket) {
+          for (ezUInt32 i = uiStartBucket; i < uiEndBucket; ++i)
+          {
+            BucketResult& result = results[i];
+            result.m_uiNumVisible = FrustumQuery<UseTagsFilter>(*buckets[i], queryParams, result.m_Stats, queryData, pOutObjects + result.m_uiOffset);
+          }
+        },
+        "FrustumCulling", parallelForParams);
+
+      for (const BucketResult& result : results)
+      {
+        if (result.m_uiNumVisible > 0 && result.m_uiOffset != uiNumVisible)
+        {
+          ezMemoryUtils::CopyOverlapped(pOutObjects + uiNumVisible, pOutObjects + result.m_uiOffset, result.m_uiNumVisible);
+        }
+
+        uiNumVisible += result.m_uiNumVisible;
+
+        stats.m_uiNumObjectsTested += result.m_Stats.m_uiNumObjectsTested;
+        stats.m_uiNumObjectsPassed += result.m_Stats.m_uiNumObjectsPassed;
+        stats.m_uiNumObjectsFiltered += result.m_Stats.m_uiNumObjectsFiltered;
+        stats.m_uiNumObjectsOccluded += result.m_Stats.m_uiNumObjectsOccluded;
+      }
+    }
+
+    outObjects.SetCountUninitialized(uiStartIndex + uiNumVisible);
+  }
+} // namespace ezSpatialSystemUtils
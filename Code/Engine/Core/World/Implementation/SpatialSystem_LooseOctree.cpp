@@ -0,0 +1,711 @@
+#include <Core/CorePCH.h>
+
+#include <Core/World/Implementation/SpatialSystemUtils.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Time/Stopwatch.h>
+
+namespace
+{
+  enum
+  {
+    MAX_DEPTH = 24
+  };
+
+  // Always visible data is stored with bounds that overlap every query, just like in ezSpatialSystem_RegularGrid
+  constexpr float s_fAlwaysVisibleHalfExtent = 128.0f * ((1 << 20) - 1);
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+struct NodeDataMapping
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezUInt32 m_uiNodeIndex = ezInvalidIndex;
+  ezUInt32 m_uiNodeDataIndex = ezInvalidIndex;
+};
+
+struct ezSpatialSystem_LooseOctree::Node
+{
+  Node(ezAllocatorBase* pAlignedAllocator, ezAllocatorBase* pAllocator)
+    : m_BoundingSpheres(pAlignedAllocator)
+    , m_TagSets(pAllocator)
+    , m_ObjectPointers(pAllocator)
+    , m_LastVisibleFrames(pAllocator)
+    , m_DataIndices(pAllocator)
+  {
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      m_Children[i] = ezInvalidIndex;
+    }
+  }
+
+  void Setup(const ezVec3& vCenter, float fHalfExtent, ezUInt32 uiParentIndex, ezUInt32 uiIndexInParent)
+  {
+    m_vCenter = vCenter;
+    m_fHalfExtent = fHalfExtent;
+    m_uiParentIndex = uiParentIndex;
+    m_uiIndexInParent = uiIndexInParent;
+
+    // the loose bounds are twice the size of the node
+    m_Bounds = ezSimdBBoxSphere(ezSimdBBox(ezSimdConversion::ToVec3(vCenter - ezVec3(fHalfExtent * 2.0f)), ezSimdConversion::ToVec3(vCenter + ezVec3(fHalfExtent * 2.0f))));
+  }
+
+  EZ_FORCE_INLINE ezUInt32 AddData(const ezSimdBBoxSphere& bounds, const ezTagSet& tags, ezGameObject* pObject, ezUInt64 uiLastVisibleFrame, ezUInt32 uiDataIndex)
+  {
+    m_BoundingSpheres.PushBack(bounds.GetSphere());
+    m_TagSets.PushBack(tags);
+    m_ObjectPointers.PushBack(pObject);
+    m_LastVisibleFrames.PushBack(uiLastVisibleFrame);
+    m_DataIndices.PushBack(uiDataIndex);
+
+    return m_BoundingSpheres.GetCount() - 1;
+  }
+
+  // Returns the data index of the moved data
+  EZ_FORCE_INLINE ezUInt32 RemoveData(ezUInt32 uiNodeDataIndex)
+  {
+    ezUInt32 uiMovedDataIndex = m_DataIndices.PeekBack();
+
+    m_BoundingSpheres.RemoveAtAndSwap(uiNodeDataIndex);
+    m_TagSets.RemoveAtAndSwap(uiNodeDataIndex);
+    m_ObjectPointers.RemoveAtAndSwap(uiNodeDataIndex);
+    m_LastVisibleFrames.RemoveAtAndSwap(uiNodeDataIndex);
+    m_DataIndices.RemoveAtAndSwap(uiNodeDataIndex);
+    EZ_ASSERT_DEBUG(m_DataIndices.GetCount() == uiNodeDataIndex || m_DataIndices[uiNodeDataIndex] == uiMovedDataIndex, "Implementation error");
+
+    return uiMovedDataIndex;
+  }
+
+  EZ_ALWAYS_INLINE ezBoundingBox GetBoundingBox() const { return ezSimdConversion::ToBBoxSphere(m_Bounds).GetBox(); }
+
+  ezSimdBBoxSphere m_Bounds; ///< The loose bounds of the node
+
+  ezVec3 m_vCenter;
+  float m_fHalfExtent = 0.0f; ///< Half edge length of the node, without the loose border
+
+  ezUInt32 m_Children[8];
+  ezUInt32 m_uiParentIndex = ezInvalidIndex;
+  ezUInt32 m_uiIndexInParent = 0;
+  ezUInt32 m_uiNumObjectsInSubtree = 0;
+
+  ezDynamicArray<ezSimdBSphere> m_BoundingSpheres;
+  ezDynamicArray<ezTagSet> m_TagSets;
+  ezDynamicArray<ezGameObject*> m_ObjectPointers;
+  mutable ezDynamicArray<ezUInt64> m_LastVisibleFrames; // multi-threaded access is ok, since all threads will set the same value
+  ezDynamicArray<ezUInt32> m_DataIndices;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::Tree
+{
+  Tree(ezSpatialSystem_LooseOctree& system, ezSpatialData::Category category)
+    : m_System(system)
+    , m_Nodes(&system.m_Allocator)
+    , m_FreeNodes(&system.m_Allocator)
+    , m_NodeDataMappings(&system.m_Allocator)
+    , m_Category(category)
+  {
+    const float fRootHalfExtent = m_System.m_fRootHalfExtent;
+    AllocateNode(ezVec3::ZeroVector(), fRootHalfExtent, ezInvalidIndex, 0);
+
+    ezSimdBBox overflowBox;
+    overflowBox.SetCenterAndHalfExtents(ezSimdVec4f::ZeroVector(), ezSimdVec4f(s_fAlwaysVisibleHalfExtent));
+
+    ezUInt32 uiOverflowNodeIndex = AllocateNode(ezVec3::ZeroVector(), s_fAlwaysVisibleHalfExtent, ezInvalidIndex, 0);
+    m_Nodes[uiOverflowNodeIndex]->m_Bounds = overflowBox;
+  }
+
+  ezUInt32 AllocateNode(const ezVec3& vCenter, float fHalfExtent, ezUInt32 uiParentIndex, ezUInt32 uiIndexInParent)
+  {
+    ezUInt32 uiNodeIndex;
+    if (!m_FreeNodes.IsEmpty())
+    {
+      uiNodeIndex = m_FreeNodes.PeekBack();
+      m_FreeNodes.PopBack();
+    }
+    else
+    {
+      uiNodeIndex = m_Nodes.GetCount();
+      m_Nodes.PushBack(EZ_NEW(&m_System.m_AlignedAllocator, Node, &m_System.m_AlignedAllocator, &m_System.m_Allocator));
+    }
+
+    m_Nodes[uiNodeIndex]->Setup(vCenter, fHalfExtent, uiParentIndex, uiIndexInParent);
+    return uiNodeIndex;
+  }
+
+  void FreeNode(ezUInt32 uiNodeIndex)
+  {
+    Node& node = *m_Nodes[uiNodeIndex];
+    EZ_ASSERT_DEBUG(node.m_uiNumObjectsInSubtree == 0, "Only empty nodes can be freed");
+
+    m_Nodes[node.m_uiParentIndex]->m_Children[node.m_uiIndexInParent] = ezInvalidIndex;
+    node.m_uiParentIndex = ezInvalidIndex;
+
+    m_FreeNodes.PushBack(uiNodeIndex);
+  }
+
+  // Objects that are not inside the root node or too big for it go into the overflow node
+  EZ_FORCE_INLINE bool FitsIntoRoot(const ezSimdBBoxSphere& bounds) const
+  {
+    const ezSimdVec4f vRootHalfExtent(m_System.m_fRootHalfExtent);
+    return (bounds.m_BoxHalfExtents <= vRootHalfExtent).AllSet<3>() && (bounds.m_CenterAndRadius.Abs() <= vRootHalfExtent).AllSet<3>();
+  }
+
+  ezUInt32 GetOrCreateNode(const ezSimdBBoxSphere& bounds)
+  {
+    if (!FitsIntoRoot(bounds))
+      return m_uiOverflowNodeIndex;
+
+    const ezVec3 vCenter = ezSimdConversion::ToVec3(bounds.m_CenterAndRadius);
+    const ezVec3 vHalfExtents = ezSimdConversion::ToVec3(bounds.m_BoxHalfExtents);
+    const float fMaxHalfExtent = ezMath::Max(vHalfExtents.x, vHalfExtents.y, vHalfExtents.z);
+
+    float fHalfExtent = m_System.m_fRootHalfExtent;
+
+    // Since every node extends its bounds by half its size, an object fits into the node that contains its center as long as it is
+    // not bigger than the node itself. Descend until the next level would be too small.
+    ezUInt32 uiNodeIndex = m_uiRootNodeIndex;
+    for (ezUInt32 uiDepth = 0; uiDepth < m_System.m_uiMaxDepth && fHalfExtent * 0.5f >= fMaxHalfExtent; ++uiDepth)
+    {
+      const ezVec3 vNodeCenter = m_Nodes[uiNodeIndex]->m_vCenter;
+      fHalfExtent *= 0.5f;
+
+      ezUInt32 uiChildIndex = 0;
+      ezVec3 vChildCenter = vNodeCenter;
+
+      if (vCenter.x >= vNodeCenter.x)
+      {
+        uiChildIndex |= 1;
+        vChildCenter.x += fHalfExtent;
+      }
+      else
+      {
+        vChildCenter.x -= fHalfExtent;
+      }
+
+      if (vCenter.y >= vNodeCenter.y)
+      {
+        uiChildIndex |= 2;
+        vChildCenter.y += fHalfExtent;
+      }
+      else
+      {
+        vChildCenter.y -= fHalfExtent;
+      }
+
+      if (vCenter.z >= vNodeCenter.z)
+      {
+        uiChildIndex |= 4;
+        vChildCenter.z += fHalfExtent;
+      }
+      else
+      {
+        vChildCenter.z -= fHalfExtent;
+      }
+
+      ezUInt32 uiChildNodeIndex = m_Nodes[uiNodeIndex]->m_Children[uiChildIndex];
+      if (uiChildNodeIndex == ezInvalidIndex)
+      {
+        uiChildNodeIndex = AllocateNode(vChildCenter, fHalfExtent, uiNodeIndex, uiChildIndex);
+        m_Nodes[uiNodeIndex]->m_Children[uiChildIndex] = uiChildNodeIndex;
+      }
+
+      uiNodeIndex = uiChildNodeIndex;
+    }
+
+    return uiNodeIndex;
+  }
+
+  void AddSpatialData(const ezSimdBBoxSphere& bounds, const ezTagSet& tags, ezGameObject* pObject, ezUInt64 uiLastVisibleFrame, const ezSpatialDataHandle& hData)
+  {
+    ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+    ezUInt32 uiNodeIndex = GetOrCreateNode(bounds);
+    ezUInt32 uiNodeDataIndex = m_Nodes[uiNodeIndex]->AddData(bounds, tags, pObject, uiLastVisibleFrame, uiDataIndex);
+
+    for (ezUInt32 i = uiNodeIndex; i != ezInvalidIndex; i = m_Nodes[i]->m_uiParentIndex)
+    {
+      m_Nodes[i]->m_uiNumObjectsInSubtree++;
+    }
+
+    m_NodeDataMappings.EnsureCount(uiDataIndex + 1);
+    EZ_ASSERT_DEBUG(m_NodeDataMappings[uiDataIndex].m_uiNodeIndex == ezInvalidIndex, "data has already been added to a node");
+    m_NodeDataMappings[uiDataIndex] = {uiNodeIndex, uiNodeDataIndex};
+  }
+
+  void RemoveSpatialData(const ezSpatialDataHandle& hData)
+  {
+    ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+    auto& mapping = m_NodeDataMappings[uiDataIndex];
+    const ezUInt32 uiNodeIndex = mapping.m_uiNodeIndex;
+
+    ezUInt32 uiMovedDataIndex = m_Nodes[uiNodeIndex]->RemoveData(mapping.m_uiNodeDataIndex);
+    if (uiMovedDataIndex != uiDataIndex)
+    {
+      m_NodeDataMappings[uiMovedDataIndex].m_uiNodeDataIndex = mapping.m_uiNodeDataIndex;
+    }
+
+    mapping = {};
+
+    // Free all nodes that became empty, the root and the overflow node don't have a parent and are never freed
+    for (ezUInt32 i = uiNodeIndex; i != ezInvalidIndex;)
+    {
+      Node& node = *m_Nodes[i];
+      const ezUInt32 uiParentIndex = node.m_uiParentIndex;
+
+      if (--node.m_uiNumObjectsInSubtree == 0 && uiParentIndex != ezInvalidIndex)
+      {
+        FreeNode(i);
+      }
+
+      i = uiParentIndex;
+    }
+  }
+
+  template <typename Functor>
+  EZ_FORCE_INLINE void ForEachNodeInBox(const ezSimdBBox& box, Functor func) const
+  {
+    ezHybridArray<ezUInt32, 128> nodeStack;
+    nodeStack.PushBack(m_uiRootNodeIndex);
+
+    while (!nodeStack.IsEmpty())
+    {
+      const Node& node = *m_Nodes[nodeStack.PeekBack()];
+      nodeStack.PopBack();
+
+      if (node.m_uiNumObjectsInSubtree == 0 || !node.m_Bounds.GetBox().Overlaps(box))
+        continue;
+
+      if (!node.m_BoundingSpheres.IsEmpty())
+      {
+        if (func(node) == ezVisitorExecution::Stop)
+          return;
+      }
+
+      for (ezUInt32 i = 0; i < 8; ++i)
+      {
+        if (node.m_Children[i] != ezInvalidIndex)
+        {
+          nodeStack.PushBack(node.m_Children[i]);
+        }
+      }
+    }
+
+    const Node& overflowNode = *m_Nodes[m_uiOverflowNodeIndex];
+    if (!overflowNode.m_BoundingSpheres.IsEmpty())
+    {
+      func(overflowNode);
+    }
+  }
+
+  ezSpatialSystem_LooseOctree& m_System;
+  ezDynamicArray<ezUniquePtr<Node>> m_Nodes;
+  ezDynamicArray<ezUInt32> m_FreeNodes;
+
+  static constexpr ezUInt32 m_uiRootNodeIndex = 0;
+  static constexpr ezUInt32 m_uiOverflowNodeIndex = 1;
+
+  ezDynamicArray<NodeDataMapping> m_NodeDataMappings;
+
+  const ezSpatialData::Category m_Category;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::Stats
+{
+  ezUInt32 m_uiNumObjectsTested = 0;
+  ezUInt32 m_uiNumObjectsPassed = 0;
+  ezUInt32 m_uiNumObjectsFiltered = 0;
+  ezUInt32 m_uiNumObjectsOccluded = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace ezInternal
+{
+  struct LooseOctreeQueryHelper
+  {
+    template <typename T, bool UseTagsFilter>
+    static ezVisitorExecution::Enum ShapeQueryCallback(const ezSpatialSystem_LooseOctree::Node& node, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_LooseOctree::Stats& stats, void* pUserData)
+    {
+      auto pQueryData = static_cast<const ezSpatialSystemUtils::ShapeQueryData<T>*>(pUserData);
+      return ezSpatialSystemUtils::ShapeQuery<T, UseTagsFilter>(node, queryParams, stats, *pQueryData);
+    }
+  };
+} // namespace ezInternal
+
+//////////////////////////////////////////////////////////////////////////
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_LooseOctree, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+ezSpatialSystem_LooseOctree::ezSpatialSystem_LooseOctree(float fWorldSize /*= 65536.0f*/, float fMinNodeSize /*= 16.0f*/)
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_fRootHalfExtent(fWorldSize * 0.5f)
+  , m_Trees(&m_Allocator)
+  , m_DataTable(&m_Allocator)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(Data) == 8);
+  EZ_ASSERT_DEV(fWorldSize > 0.0f && fMinNodeSize > 0.0f && fMinNodeSize <= fWorldSize, "Invalid octree sizes");
+
+  float fNodeSize = fWorldSize;
+  while (fNodeSize * 0.5f >= fMinNodeSize && m_uiMaxDepth < MAX_DEPTH)
+  {
+    fNodeSize *= 0.5f;
+    ++m_uiMaxDepth;
+  }
+
+  m_Trees.SetCount(MAX_NUM_TREES);
+}
+
+ezSpatialSystem_LooseOctree::~ezSpatialSystem_LooseOctree() = default;
+
+ezResult ezSpatialSystem_LooseOctree::GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const
+{
+  Data* pData = nullptr;
+  if (!m_DataTable.TryGetValue(hData.GetInternalID(), pData))
+    return EZ_FAILURE;
+
+  ForEachTree(*pData, hData,
+    [&](Tree& tree, const NodeDataMapping& mapping) {
+      out_BoundingBox = tree.m_Nodes[mapping.m_uiNodeIndex]->GetBoundingBox();
+      return ezVisitorExecution::Stop;
+    });
+
+  return EZ_SUCCESS;
+}
+
+void ezSpatialSystem_LooseOctree::GetAllNodeBoxes(ezDynamicArray<ezBoundingBox>& out_BoundingBoxes, ezSpatialData::Category filterCategory /*= ezInvalidSpatialDataCategory*/) const
+{
+  for (ezUInt32 uiTreeIndex = 0; uiTreeIndex < m_Trees.GetCount(); ++uiTreeIndex)
+  {
+    auto& pTree = m_Trees[uiTreeIndex];
+    if (pTree == nullptr || (filterCategory != ezInvalidSpatialDataCategory && filterCategory.m_uiValue != uiTreeIndex))
+      continue;
+
+    for (ezUInt32 uiNodeIndex = 0; uiNodeIndex < pTree->m_Nodes.GetCount(); ++uiNodeIndex)
+    {
+      auto& pNode = pTree->m_Nodes[uiNodeIndex];
+      if (uiNodeIndex != Tree::m_uiOverflowNodeIndex && !pNode->m_BoundingSpheres.IsEmpty())
+      {
+        out_BoundingBoxes.PushBack(pNode->GetBoundingBox());
+      }
+    }
+  }
+}
+
+ezSpatialDataHandle ezSpatialSystem_LooseOctree::CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  Data data;
+  data.m_uiTreeBitmask = uiCategoryBitmask;
+  data.m_uiAlwaysVisible = 0;
+
+  auto hData = ezSpatialDataHandle(m_DataTable.Insert(data));
+
+  ezUInt32 uiTreeBitmask = uiCategoryBitmask;
+  while (uiTreeBitmask > 0)
+  {
+    ezUInt32 uiTreeIndex = ezMath::FirstBitLow(uiTreeBitmask);
+    uiTreeBitmask &= uiTreeBitmask - 1;
+
+    auto& pTree = m_Trees[uiTreeIndex];
+    if (pTree == nullptr)
+    {
+      pTree = EZ_NEW(&m_Allocator, Tree, *this, ezSpatialData::Category(uiTreeIndex));
+    }
+
+    pTree->AddSpatialData(bounds, tags, pObject, m_uiFrameCounter, hData);
+  }
+
+  return hData;
+}
+
+ezSpatialDataHandle ezSpatialSystem_LooseOctree::CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  ezSimdBBox hugeBox;
+  hugeBox.SetCenterAndHalfExtents(ezSimdVec4f::ZeroVector(), ezSimdVec4f(s_fAlwaysVisibleHalfExtent));
+
+  ezSpatialDataHandle hData = CreateSpatialData(hugeBox, pObject, uiCategoryBitmask, tags);
+  if (!hData.IsInvalidated())
+  {
+    Data* pData = nullptr;
+    m_DataTable.TryGetValue(hData.GetInternalID(), pData);
+    pData->m_uiAlwaysVisible = 1;
+  }
+
+  return hData;
+}
+
+void ezSpatialSystem_LooseOctree::DeleteSpatialData(const ezSpatialDataHandle& hData)
+{
+  Data oldData;
+  EZ_VERIFY(m_DataTable.Remove(hData.GetInternalID(), &oldData), "Invalid spatial data handle");
+
+  ForEachTree(oldData, hData,
+    [&](Tree& tree, const NodeDataMapping& mapping) {
+      tree.RemoveSpatialData(hData);
+      return ezVisitorExecution::Continue;
+    });
+}
+
+EZ_FORCE_INLINE void ezSpatialSystem_LooseOctree::UpdateSpatialDataBoundsInternal(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  // No need to update bounds for always visible data
+  if (pData->m_uiAlwaysVisible != 0)
+    return;
+
+  ForEachTree(*pData, hData,
+    [&](Tree& tree, const NodeDataMapping& mapping) {
+      Node& node = *tree.m_Nodes[mapping.m_uiNodeIndex];
+
+      // Objects in the overflow node are moved as soon as they fit into the root
+      const bool bStaysInNode = (mapping.m_uiNodeIndex == Tree::m_uiOverflowNodeIndex) ? !tree.FitsIntoRoot(bounds) : node.m_Bounds.GetBox().Contains(bounds.GetBox());
+
+      if (bStaysInNode)
+      {
+        node.m_BoundingSpheres[mapping.m_uiNodeDataIndex] = bounds.GetSphere();
+      }
+      else
+      {
+        const ezTagSet tags = node.m_TagSets[mapping.m_uiNodeDataIndex];
+        ezGameObject* objectPointer = node.m_ObjectPointers[mapping.m_uiNodeDataIndex];
+        ezUInt64 uiLastVisibleFrame = node.m_LastVisibleFrames[mapping.m_uiNodeDataIndex];
+
+        tree.RemoveSpatialData(hData);
+
+        tree.AddSpatialData(bounds, tags, objectPointer, uiLastVisibleFrame, hData);
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+}
+
+void ezSpatialSystem_LooseOctree::UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+{
+  UpdateSpatialDataBoundsInternal(hData, bounds);
+}
+
+void ezSpatialSystem_LooseOctree::UpdateSpatialDataBoundsBatch(ezArrayPtr<const BoundsUpdate> updates)
+{
+  EZ_PROFILE_SCOPE("UpdateSpatialDataBoundsBatch");
+
+  for (const BoundsUpdate& update : updates)
+  {
+    UpdateSpatialDataBoundsInternal(update.m_hData, *update.m_pBounds);
+  }
+}
+
+void ezSpatialSystem_LooseOctree::UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject)
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  ForEachTree(*pData, hData,
+    [&](Tree& tree, const NodeDataMapping& mapping) {
+      tree.m_Nodes[mapping.m_uiNodeIndex]->m_ObjectPointers[mapping.m_uiNodeDataIndex] = pObject;
+      return ezVisitorExecution::Continue;
+    });
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE_INTERNED("FindObjectsInSphere");
+
+  ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+  ezSimdBBox simdBox;
+  simdBox.SetCenterAndHalfExtents(simdSphere.m_CenterAndRadius, simdSphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>());
+
+  ezSpatialSystemUtils::ShapeQueryData<ezSimdBSphere> queryData = {simdSphere, callback};
+
+  ForEachNodeInMatchingTrees(simdBox, queryParams,
+    &ezInternal::LooseOctreeQueryHelper::ShapeQueryCallback<ezSimdBSphere, false>,
+    &ezInternal::LooseOctreeQueryHelper::ShapeQueryCallback<ezSimdBSphere, true>,
+    &queryData);
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE_INTERNED("FindObjectsInBox");
+
+  ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  ezSpatialSystemUtils::ShapeQueryData<ezSimdBBox> queryData = {simdBox, callback};
+
+  ForEachNodeInMatchingTrees(simdBox, queryParams,
+    &ezInternal::LooseOctreeQueryHelper::ShapeQueryCallback<ezSimdBBox, false>,
+    &ezInternal::LooseOctreeQueryHelper::ShapeQueryCallback<ezSimdBBox, true>,
+    &queryData);
+}
+
+void ezSpatialSystem_LooseOctree::FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects) const
+{
+  EZ_PROFILE_SCOPE_INTERNED("FindVisibleObjects");
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezStopwatch timer;
+#endif
+
+  ezVec3 cornerPoints[8];
+  frustum.ComputeCornerPoints(cornerPoints);
+
+  ezSimdVec4f simdCornerPoints[8];
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    simdCornerPoints[i] = ezSimdConversion::ToVec3(cornerPoints[i]);
+  }
+
+  ezSimdBBox simdBox;
+  simdBox.SetFromPoints(simdCornerPoints, 8);
+
+  ezSpatialSystemUtils::FrustumQueryData queryData;
+  ezSpatialSystemUtils::SetupFrustumQueryData(frustum, queryParams, m_uiFrameCounter, out_Objects, queryData);
+
+  // Gather the non-empty nodes first so they can be culled in parallel
+  ezHybridArray<const Node*, 256> nodes;
+
+  ForEachMatchingTree(queryParams,
+    [&](const Tree& tree, bool bUseTagsFilter, Stats& stats) {
+      nodes.Clear();
+      tree.ForEachNodeInBox(simdBox,
+        [&](const Node& node) {
+          nodes.PushBack(&node);
+          return ezVisitorExecution::Continue;
+        });
+
+      if (bUseTagsFilter)
+      {
+        ezSpatialSystemUtils::FrustumQueryBuckets<true>(nodes.GetArrayPtr(), queryParams, stats, queryData);
+      }
+      else
+      {
+        ezSpatialSystemUtils::FrustumQueryBuckets<false>(nodes.GetArrayPtr(), queryParams, stats, queryData);
+      }
+    });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_TimeTaken = timer.GetRunningTotal();
+  }
+#endif
+}
+
+ezUInt64 ezSpatialSystem_LooseOctree::GetNumFramesSinceVisible(const ezSpatialDataHandle& hData) const
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  if (pData->m_uiAlwaysVisible != 0)
+    return 0;
+
+  ezUInt64 uiLastFrameVisible = 0;
+  ForEachTree(*pData, hData,
+    [&](const Tree& tree, const NodeDataMapping& mapping) {
+      auto& pNode = tree.m_Nodes[mapping.m_uiNodeIndex];
+      uiLastFrameVisible = ezMath::Max(uiLastFrameVisible, pNode->m_LastVisibleFrames[mapping.m_uiNodeDataIndex]);
+      return ezVisitorExecution::Continue;
+    });
+
+  return (m_uiFrameCounter > uiLastFrameVisible) ? m_uiFrameCounter - uiLastFrameVisible : 0;
+}
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+void ezSpatialSystem_LooseOctree::GetInternalStats(ezStringBuilder& sb) const
+{
+  sb = "Loose Octree:\n";
+
+  for (auto& pTree : m_Trees)
+  {
+    if (pTree == nullptr)
+      continue;
+
+    const ezUInt32 uiNumNodes = pTree->m_Nodes.GetCount() - pTree->m_FreeNodes.GetCount();
+    const ezUInt32 uiNumObjects = pTree->m_Nodes[Tree::m_uiRootNodeIndex]->m_uiNumObjectsInSubtree;
+    const ezUInt32 uiNumOverflowObjects = pTree->m_Nodes[Tree::m_uiOverflowNodeIndex]->m_uiNumObjectsInSubtree;
+
+    sb.AppendFormat(" \nCategory: {}\nNodes: {}\nObjects: {}\nOverflow Objects: {}\n", pTree->m_Category.m_uiValue, uiNumNodes, uiNumObjects, uiNumOverflowObjects);
+  }
+}
+#endif
+
+template <typename Functor>
+EZ_FORCE_INLINE void ezSpatialSystem_LooseOctree::ForEachTree(const Data& data, const ezSpatialDataHandle& hData, Functor func) const
+{
+  ezUInt32 uiTreeBitmask = data.m_uiTreeBitmask;
+  ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+  while (uiTreeBitmask > 0)
+  {
+    ezUInt32 uiTreeIndex = ezMath::FirstBitLow(uiTreeBitmask);
+    uiTreeBitmask &= uiTreeBitmask - 1;
+
+    auto& tree = *m_Trees[uiTreeIndex];
+    auto& mapping = tree.m_NodeDataMappings[uiDataIndex];
+
+    if (func(tree, mapping) == ezVisitorExecution::Stop)
+      break;
+  }
+}
+
+template <typename Functor>
+void ezSpatialSystem_LooseOctree::ForEachMatchingTree(const QueryParams& queryParams, Functor func) const
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+  }
+#endif
+
+  const bool useTagsFilter = queryParams.m_IncludeTags.IsEmpty() == false || queryParams.m_ExcludeTags.IsEmpty() == false;
+
+  ezUInt32 uiTreeBitmask = queryParams.m_uiCategoryBitmask;
+  while (uiTreeBitmask > 0)
+  {
+    ezUInt32 uiTreeIndex = ezMath::FirstBitLow(uiTreeBitmask);
+    uiTreeBitmask &= uiTreeBitmask - 1;
+
+    auto& pTree = m_Trees[uiTreeIndex];
+    if (pTree == nullptr)
+      continue;
+
+    Stats stats;
+    func(*pTree, useTagsFilter, stats);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (queryParams.m_pStats != nullptr)
+    {
+      queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
+      queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+      queryParams.m_pStats->m_uiNumObjectsOccluded += stats.m_uiNumObjectsOccluded;
+    }
+#endif
+  }
+}
+
+void ezSpatialSystem_LooseOctree::ForEachNodeInMatchingTrees(const ezSimdBBox& box, const QueryParams& queryParams, NodeCallback noFilterCallback, NodeCallback filterByTagsCallback, void* pUserData) const
+{
+  ForEachMatchingTree(queryParams,
+    [&](const Tree& tree, bool bUseTagsFilter, Stats& stats) {
+      NodeCallback nodeCallback = bUseTagsFilter ? filterByTagsCallback : noFilterCallback;
+
+      tree.ForEachNodeInBox(box,
+        [&](const Node& node) {
+          return nodeCallback(node, queryParams, stats, pUserData);
+        });
+    });
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_LooseOctree);
@@ -1,5 +1,6 @@
 #include <Core/CorePCH.h>
 
+#include <Core/World/Implementation/SpatialSystemUtils.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Profiling/Profiling.h>
@@ -49,17 +50,6 @@ namespace
     return (uiCategoryBitmask & uiQueryBitmask) == 0;
   }
 
-  EZ_ALWAYS_INLINE bool FilterByTags(const ezTagSet& tags, const ezTagSet& includeTags, const ezTagSet& excludeTags)
-  {
-    if (!excludeTags.IsEmpty() && excludeTags.IsAnySet(tags))
-      return true;
-
-    if (!includeTags.IsEmpty() && !includeTags.IsAnySet(tags))
-      return true;
-
-    return false;
-  }
-
   EZ_ALWAYS_INLINE bool CanBeCached(ezSpatialData::Category category)
   {
     return ezSpatialData::GetCategoryFlags(category).IsSet(ezSpatialData::Flags::FrequentChanges) == false;
@@ -82,86 +72,6 @@ namespace
 
     out_sb.Append(" }");
   }
-
-  struct PlaneData
-  {
-    ezSimdVec4f m_x0x1x2x3;
-    ezSimdVec4f m_y0y1y2y3;
-    ezSimdVec4f m_z0z1z2z3;
-    ezSimdVec4f m_w0w1w2w3;
-
-    ezSimdVec4f m_x4x5x4x5;
-    ezSimdVec4f m_y4y5y4y5;
-    ezSimdVec4f m_z4z5z4z5;
-    ezSimdVec4f m_w4w5w4w5;
-  };
-
-  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
-  {
-    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
-    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
-    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
-    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
-
-    ezSimdVec4f dot_0123;
-    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
-
-    ezSimdVec4f dot_4545;
-    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
-
-    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
-    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
-    return (cmp_0123 || cmp_4545).NoneSet<4>();
-  }
-
-  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
-  {
-    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
-    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
-    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
-    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotA_0123;
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
-
-    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
-    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
-    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
-    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotB_0123;
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
-
-    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
-    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
-    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
-    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
-
-    ezSimdVec4f dot_A45B45;
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
-
-    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
-    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
-    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
-
-    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
-    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
-
-    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
-    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
-
-    return result;
-  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -324,7 +234,7 @@ struct ezSpatialSystem_RegularGrid::Grid
     auto& pOtherCell = other.m_Cells[mapping.m_uiCellIndex];
 
     const ezTagSet& tags = pOtherCell->m_TagSets[mapping.m_uiCellDataIndex];
-    if (FilterByTags(tags, m_IncludeTags, m_ExcludeTags))
+    if (ezSpatialSystemUtils::FilterByTags(tags, m_IncludeTags, m_ExcludeTags))
       return false;
 
     const ezSimdBSphere& bounds = pOtherCell->m_BoundingSpheres[mapping.m_uiCellDataIndex];
@@ -409,6 +319,7 @@ struct ezSpatialSystem_RegularGrid::Stats
   ezUInt32 m_uiNumObjectsTested = 0;
   ezUInt32 m_uiNumObjectsPassed = 0;
   ezUInt32 m_uiNumObjectsFiltered = 0;
+  ezUInt32 m_uiNumObjectsOccluded = 0;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -417,144 +328,11 @@ namespace ezInternal
 {
   struct QueryHelper
   {
-    template <typename T>
-    struct ShapeQueryData
-    {
-      T m_Shape;
-      ezSpatialSystem::QueryCallback m_Callback;
-    };
-
     template <typename T, bool UseTagsFilter>
     static ezVisitorExecution::Enum ShapeQueryCallback(const ezSpatialSystem_RegularGrid::Cell& cell, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_RegularGrid::Stats& stats, void* pUserData)
     {
-      auto pQueryData = static_cast<const ShapeQueryData<T>*>(pUserData);
-      T shape = pQueryData->m_Shape;
-
-      ezSimdBBox cellBox = cell.m_Bounds.GetBox();
-      if (!cellBox.Overlaps(shape))
-        return ezVisitorExecution::Continue;
-
-      auto boundingSpheres = cell.m_BoundingSpheres.GetData();
-      auto tagSets = cell.m_TagSets.GetData();
-      auto objectPointers = cell.m_ObjectPointers.GetData();
-
-      const ezUInt32 numSpheres = cell.m_BoundingSpheres.GetCount();
-      stats.m_uiNumObjectsTested += numSpheres;
-
-      for (ezUInt32 i = 0; i < numSpheres; ++i)
-      {
-        if (!shape.Overlaps(boundingSpheres[i]))
-          continue;
-
-        if (UseTagsFilter)
-        {
-          if (FilterByTags(tagSets[i], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
-          {
-            stats.m_uiNumObjectsFiltered++;
-            continue;
-          }
-        }
-
-        stats.m_uiNumObjectsPassed++;
-
-        if (pQueryData->m_Callback(objectPointers[i]) == ezVisitorExecution::Stop)
-          return ezVisitorExecution::Stop;
-      }
-
-      return ezVisitorExecution::Continue;
-    }
-
-    struct FrustumQueryData
-    {
-      PlaneData m_PlaneData;
-      ezDynamicArray<const ezGameObject*>* m_pOutObjects;
-      ezUInt64 m_uiFrameCounter;
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-
-#endif
-    };
-
-    template <bool UseTagsFilter>
-    static ezVisitorExecution::Enum FrustumQueryCallback(const ezSpatialSystem_RegularGrid::Cell& cell, const ezSpatialSystem::QueryParams& queryParams, ezSpatialSystem_RegularGrid::Stats& stats, void* pUserData)
-    {
-      auto pQueryData = static_cast<FrustumQueryData*>(pUserData);
-      PlaneData planeData = pQueryData->m_PlaneData;
-
-      ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
-      if (!SphereFrustumIntersect(cellSphere, planeData))
-        return ezVisitorExecution::Continue;
-
-      auto boundingSpheres = cell.m_BoundingSpheres.GetData();
-      auto tagSets = cell.m_TagSets.GetData();
-      auto objectPointers = cell.m_ObjectPointers.GetData();
-      auto lastVisibleFrames = cell.m_LastVisibleFrames.GetData();
-
-      const ezUInt32 numSpheres = cell.m_BoundingSpheres.GetCount();
-      stats.m_uiNumObjectsTested += numSpheres;
-
-      ezUInt32 currentIndex = 0;
-
-      while (currentIndex < numSpheres)
-      {
-        if (numSpheres - currentIndex >= 32)
-        {
-          ezUInt32 mask = 0;
-
-          for (ezUInt32 i = 0; i < 32; i += 2)
-          {
-            auto& objectSphereA = boundingSpheres[currentIndex + i + 0];
-            auto& objectSphereB = boundingSpheres[currentIndex + i + 1];
-
-            mask |= SphereFrustumIntersect(objectSphereA, objectSphereB, planeData) << i;
-          }
-
-          while (mask > 0)
-          {
-            ezUInt32 i = ezMath::FirstBitLow(mask) + currentIndex;
-            mask &= mask - 1;
-
-            if (UseTagsFilter)
-            {
-              if (FilterByTags(tagSets[i], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
-              {
-                stats.m_uiNumObjectsFiltered++;
-                continue;
-              }
-            }
-
-            lastVisibleFrames[i] = pQueryData->m_uiFrameCounter;
-            pQueryData->m_pOutObjects->PushBack(objectPointers[i]);
-
-            stats.m_uiNumObjectsPassed++;
-          }
-
-          currentIndex += 32;
-        }
-        else
-        {
-          ezUInt32 i = currentIndex;
-          ++currentIndex;
-
-          if (!SphereFrustumIntersect(boundingSpheres[i], planeData))
-            continue;
-
-          if (UseTagsFilter)
-          {
-            if (FilterByTags(tagSets[i], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
-            {
-              stats.m_uiNumObjectsFiltered++;
-              continue;
-            }
-          }
-
-          lastVisibleFrames[i] = pQueryData->m_uiFrameCounter;
-          pQueryData->m_pOutObjects->PushBack(objectPointers[i]);
-
-          stats.m_uiNumObjectsPassed++;
-        }
-      }
-
-      return ezVisitorExecution::Continue;
+      auto pQueryData = static_cast<const ezSpatialSystemUtils::ShapeQueryData<T>*>(pUserData);
+      return ezSpatialSystemUtils::ShapeQuery<T, UseTagsFilter>(cell, queryParams, stats, *pQueryData);
     }
   };
 } // namespace ezInternal
@@ -717,7 +495,7 @@ void ezSpatialSystem_RegularGrid::DeleteSpatialData(const ezSpatialDataHandle& h
     });
 }
 
-void ezSpatialSystem_RegularGrid::UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::UpdateSpatialDataBoundsInternal(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
 {
   Data* pData = nullptr;
   EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
@@ -749,6 +527,21 @@ void ezSpatialSystem_RegularGrid::UpdateSpatialDataBounds(const ezSpatialDataHan
     });
 }
 
+void ezSpatialSystem_RegularGrid::UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+{
+  UpdateSpatialDataBoundsInternal(hData, bounds);
+}
+
+void ezSpatialSystem_RegularGrid::UpdateSpatialDataBoundsBatch(ezArrayPtr<const BoundsUpdate> updates)
+{
+  EZ_PROFILE_SCOPE("UpdateSpatialDataBoundsBatch");
+
+  for (const BoundsUpdate& update : updates)
+  {
+    UpdateSpatialDataBoundsInternal(update.m_hData, *update.m_pBounds);
+  }
+}
+
 void ezSpatialSystem_RegularGrid::UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject)
 {
   Data* pData = nullptr;
@@ -764,13 +557,13 @@ void ezSpatialSystem_RegularGrid::UpdateSpatialDataObject(const ezSpatialDataHan
 
 void ezSpatialSystem_RegularGrid::FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const
 {
-  EZ_PROFILE_SCOPE("FindObjectsInSphere");
+  EZ_PROFILE_SCOPE_INTERNED("FindObjectsInSphere");
 
   ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
   ezSimdBBox simdBox;
   simdBox.SetCenterAndHalfExtents(simdSphere.m_CenterAndRadius, simdSphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>());
 
-  ezInternal::QueryHelper::ShapeQueryData<ezSimdBSphere> queryData = {simdSphere, callback};
+  ezSpatialSystemUtils::ShapeQueryData<ezSimdBSphere> queryData = {simdSphere, callback};
 
   ForEachCellInBoxInMatchingGrids(simdBox, queryParams,
     &ezInternal::QueryHelper::ShapeQueryCallback<ezSimdBSphere, false>,
@@ -780,11 +573,11 @@ void ezSpatialSystem_RegularGrid::FindObjectsInSphere(const ezBoundingSphere& sp
 
 void ezSpatialSystem_RegularGrid::FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const
 {
-  EZ_PROFILE_SCOPE("FindObjectsInBox");
+  EZ_PROFILE_SCOPE_INTERNED("FindObjectsInBox");
 
   ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
 
-  ezInternal::QueryHelper::ShapeQueryData<ezSimdBBox> queryData = {simdBox, callback};
+  ezSpatialSystemUtils::ShapeQueryData<ezSimdBBox> queryData = {simdBox, callback};
 
   ForEachCellInBoxInMatchingGrids(simdBox, queryParams,
     &ezInternal::QueryHelper::ShapeQueryCallback<ezSimdBBox, false>,
@@ -794,7 +587,7 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBox(const ezBoundingBox& box, con
 
 void ezSpatialSystem_RegularGrid::FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects) const
 {
-  EZ_PROFILE_SCOPE("FindVisibleObjects");
+  EZ_PROFILE_SCOPE_INTERNED("FindVisibleObjects");
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezStopwatch timer;
@@ -812,39 +605,33 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjects(const ezFrustum& frustum, c
   ezSimdBBox simdBox;
   simdBox.SetFromPoints(simdCornerPoints, 8);
 
-  ezInternal::QueryHelper::FrustumQueryData queryData;
-  {
-    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
-    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
-    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
-    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
-    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
-    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
-    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
-
-    ezSimdMat4f helperMat;
-    helperMat.SetRows(plane0, plane1, plane2, plane3);
-
-    queryData.m_PlaneData.m_x0x1x2x3 = helperMat.m_col0;
-    queryData.m_PlaneData.m_y0y1y2y3 = helperMat.m_col1;
-    queryData.m_PlaneData.m_z0z1z2z3 = helperMat.m_col2;
-    queryData.m_PlaneData.m_w0w1w2w3 = helperMat.m_col3;
-
-    helperMat.SetRows(plane4, plane5, plane4, plane5);
-
-    queryData.m_PlaneData.m_x4x5x4x5 = helperMat.m_col0;
-    queryData.m_PlaneData.m_y4y5y4y5 = helperMat.m_col1;
-    queryData.m_PlaneData.m_z4z5z4z5 = helperMat.m_col2;
-    queryData.m_PlaneData.m_w4w5w4w5 = helperMat.m_col3;
-
-    queryData.m_pOutObjects = &out_Objects;
-    queryData.m_uiFrameCounter = m_uiFrameCounter;
-  }
+  ezSpatialSystemUtils::FrustumQueryData queryData;
+  ezSpatialSystemUtils::SetupFrustumQueryData(frustum, queryParams, m_uiFrameCounter, out_Objects, queryData);
 
-  ForEachCellInBoxInMatchingGrids(simdBox, queryParams,
-    &ezInternal::QueryHelper::FrustumQueryCallback<false>,
-    &ezInternal::QueryHelper::FrustumQueryCallback<true>,
-    &queryData);
+  // Gather the non-empty cells first so they can be culled in parallel
+  ezHybridArray<const Cell*, 256> cells;
+
+  ForEachMatchingGrid(queryParams,
+    [&](const Grid& grid, bool bUseTagsFilter, Stats& stats) {
+      cells.Clear();
+      grid.ForEachCellInBox(simdBox,
+        [&](const Cell& cell) {
+          if (!cell.m_BoundingSpheres.IsEmpty())
+          {
+            cells.PushBack(&cell);
+          }
+          return ezVisitorExecution::Continue;
+        });
+
+      if (bUseTagsFilter)
+      {
+        ezSpatialSystemUtils::FrustumQueryBuckets<true>(cells.GetArrayPtr(), queryParams, stats, queryData);
+      }
+      else
+      {
+        ezSpatialSystemUtils::FrustumQueryBuckets<false>(cells.GetArrayPtr(), queryParams, stats, queryData);
+      }
+    });
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   if (queryParams.m_pStats != nullptr)
@@ -927,7 +714,7 @@ ezSpatialDataHandle ezSpatialSystem_RegularGrid::AddSpatialDataToGrids(const ezS
       continue;
 
     if ((pGrid->m_Category.GetBitmask() & uiCategoryBitmask) == 0 ||
-        FilterByTags(tags, pGrid->m_IncludeTags, pGrid->m_ExcludeTags))
+        ezSpatialSystemUtils::FilterByTags(tags, pGrid->m_IncludeTags, pGrid->m_ExcludeTags))
       continue;
 
     data.m_uiGridBitmask |= EZ_BIT(uiCachedGridIndex);
@@ -972,7 +759,8 @@ EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::ForEachGrid(const Data& data,
   }
 }
 
-void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBBox& box, const QueryParams& queryParams, CellCallback noFilterCallback, CellCallback filterByTagsCallback, void* pUserData) const
+template <typename Functor>
+void ezSpatialSystem_RegularGrid::ForEachMatchingGrid(const QueryParams& queryParams, Functor func) const
 {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   if (queryParams.m_pStats != nullptr)
@@ -998,10 +786,7 @@ void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBB
     uiGridBitmask &= ~pGrid->m_Category.GetBitmask();
 
     Stats stats;
-    pGrid->ForEachCellInBox(box,
-      [&](const Cell& cell) {
-        return noFilterCallback(cell, queryParams, stats, pUserData);
-      });
+    func(*pGrid, false, stats);
 
     UpdateCacheCandidate(queryParams.m_IncludeTags, queryParams.m_ExcludeTags, pGrid->m_Category, 0.0f);
 
@@ -1010,13 +795,13 @@ void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBB
     {
       queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
       queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+      queryParams.m_pStats->m_uiNumObjectsOccluded += stats.m_uiNumObjectsOccluded;
     }
 #endif
   }
 
   // then search for the rest
   const bool useTagsFilter = queryParams.m_IncludeTags.IsEmpty() == false || queryParams.m_ExcludeTags.IsEmpty() == false;
-  CellCallback cellCallback = useTagsFilter ? filterByTagsCallback : noFilterCallback;
 
   while (uiGridBitmask > 0)
   {
@@ -1028,14 +813,11 @@ void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBB
       continue;
 
     Stats stats;
-    pGrid->ForEachCellInBox(box,
-      [&](const Cell& cell) {
-        return cellCallback(cell, queryParams, stats, pUserData);
-      });
+    func(*pGrid, useTagsFilter, stats);
 
     if (pGrid->m_bCanBeCached && useTagsFilter)
     {
-      const ezUInt32 totalNumObjectsAfterSpatialTest = stats.m_uiNumObjectsFiltered + stats.m_uiNumObjectsPassed;
+      const ezUInt32 totalNumObjectsAfterSpatialTest = stats.m_uiNumObjectsFiltered + stats.m_uiNumObjectsPassed + stats.m_uiNumObjectsOccluded;
       const ezUInt32 cacheThreshold = ezUInt32(ezMath::Max(cvar_SpatialQueriesCachingThreshold.GetValue(), 1));
 
       // 1.0 => all objects filtered, 0.0 => no object filtered by tags
@@ -1053,11 +835,25 @@ void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBB
     {
       queryParams.m_pStats->m_uiNumObjectsTested += stats.m_uiNumObjectsTested;
       queryParams.m_pStats->m_uiNumObjectsPassed += stats.m_uiNumObjectsPassed;
+      queryParams.m_pStats->m_uiNumObjectsOccluded += stats.m_uiNumObjectsOccluded;
     }
 #endif
   }
 }
 
+void ezSpatialSystem_RegularGrid::ForEachCellInBoxInMatchingGrids(const ezSimdBBox& box, const QueryParams& queryParams, CellCallback noFilterCallback, CellCallback filterByTagsCallback, void* pUserData) const
+{
+  ForEachMatchingGrid(queryParams,
+    [&](const Grid& grid, bool bUseTagsFilter, Stats& stats) {
+      CellCallback cellCallback = bUseTagsFilter ? filterByTagsCallback : noFilterCallback;
+
+      grid.ForEachCellInBox(box,
+        [&](const Cell& cell) {
+          return cellCallback(cell, queryParams, stats, pUserData);
+        });
+    });
+}
+
 void ezSpatialSystem_RegularGrid::MigrateCachedGrid(ezUInt32 uiCandidateIndex)
 {
   ezUInt32 uiTargetGridIndex = ezInvalidIndex;
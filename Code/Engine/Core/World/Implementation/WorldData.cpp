@@ -1,5 +1,6 @@
 #include <Core/CorePCH.h>
 
+#include <Core/World/SpatialSystem_LooseOctree.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 
@@ -90,7 +91,14 @@ namespace ezInternal
 
     if (m_pSpatialSystem == nullptr && desc.m_bAutoCreateSpatialSystem)
     {
-      m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid);
+      if (desc.m_SpatialSystemType == ezSpatialSystemType::LooseOctree)
+      {
+        m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_LooseOctree);
+      }
+      else
+      {
+        m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid);
+      }
     }
 
     if (m_pCoordinateSystemProvider == nullptr)
@@ -306,77 +314,80 @@ namespace ezInternal
 
   void WorldData::UpdateGlobalTransforms(float fInvDeltaSeconds)
   {
-    struct UserData
-    {
-      ezSimdFloat m_fInvDt;
-      ezSpatialSystem* m_pSpatialSystem;
-    };
+    Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
+    if (hierarchy.m_Data.IsEmpty())
+      return;
 
-    UserData userData;
-    userData.m_fInvDt = fInvDeltaSeconds;
-    userData.m_pSpatialSystem = m_pSpatialSystem.Borrow();
+    TransformUpdateContext context;
+    context.m_fInvDeltaSeconds = fInvDeltaSeconds;
 
-    struct RootLevel
+    // If we have no spatial system, we only have to update the transforms and bounds.
+    if (m_pSpatialSystem == nullptr)
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      UpdateGlobalTransformsOfLevel<false, false>(*hierarchy.m_Data[0], context);
+
+      for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
       {
-        WorldData::UpdateGlobalTransform(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
-        return ezVisitorExecution::Continue;
+        UpdateGlobalTransformsOfLevel<true, false>(*hierarchy.m_Data[i], context);
       }
-    };
 
-    struct WithParent
+      return;
+    }
+
+    // Otherwise bounds changes are collected by the transform update tasks, which can then run without locking,
+    // and handed to the spatial system in one batch once all levels are done.
+    ezUInt32 uiTotalNumBlocks = 0;
+    for (const Hierarchy::DataBlockArray* pBlocks : hierarchy.m_Data)
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
-      {
-        WorldData::UpdateGlobalTransformWithParent(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
-        return ezVisitorExecution::Continue;
-      }
-    };
+      uiTotalNumBlocks += pBlocks->GetCount();
+    }
+
+    ezDynamicArray<ezSpatialSystem::BoundsUpdate> boundsUpdates(m_StackAllocator.GetCurrentAllocator());
+    boundsUpdates.SetCountUninitialized(uiTotalNumBlocks * TRANSFORMATION_DATA_PER_BLOCK);
+
+    ezDynamicArray<ezUInt32> numBoundsUpdates(m_StackAllocator.GetCurrentAllocator());
+    numBoundsUpdates.SetCount(uiTotalNumBlocks);
 
-    struct RootLevelWithSpatialData
+    ezUInt32 uiFirstBlockOfLevel = 0;
+    for (ezUInt32 i = 0; i < hierarchy.m_Data.GetCount(); ++i)
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      Hierarchy::DataBlockArray& blocks = *hierarchy.m_Data[i];
+
+      context.m_pBoundsUpdates = boundsUpdates.GetData() + uiFirstBlockOfLevel * TRANSFORMATION_DATA_PER_BLOCK;
+      context.m_pNumBoundsUpdates = numBoundsUpdates.GetData() + uiFirstBlockOfLevel;
+
+      if (i == 0)
       {
-        WorldData::UpdateGlobalTransformAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt, *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        UpdateGlobalTransformsOfLevel<false, true>(blocks, context);
       }
-    };
-
-    struct WithParentWithSpatialData
-    {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      else
       {
-        WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt, *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        UpdateGlobalTransformsOfLevel<true, true>(blocks, context);
       }
-    };
 
-    Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
-    if (!hierarchy.m_Data.IsEmpty())
+      uiFirstBlockOfLevel += blocks.GetCount();
+    }
+
+    // move the sections of all tasks together
+    ezUInt32 uiNumBoundsUpdates = 0;
+    for (ezUInt32 uiBlockIndex = 0; uiBlockIndex < uiTotalNumBlocks; ++uiBlockIndex)
     {
-      auto dataPtr = hierarchy.m_Data.GetData();
+      const ezUInt32 uiCount = numBoundsUpdates[uiBlockIndex];
+      if (uiCount == 0)
+        continue;
 
-      // If we have no spatial system, we perform multi-threaded update as we do not
-      // have to acquire a write lock in the process.
-      if (m_pSpatialSystem == nullptr)
+      const ezUInt32 uiSectionStart = uiBlockIndex * TRANSFORMATION_DATA_PER_BLOCK;
+      if (uiSectionStart != uiNumBoundsUpdates)
       {
-        TraverseHierarchyLevelMultiThreaded<RootLevel>(*dataPtr[0], &userData);
-
-        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
-        {
-          TraverseHierarchyLevelMultiThreaded<WithParent>(*dataPtr[i], &userData);
-        }
+        ezMemoryUtils::CopyOverlapped(boundsUpdates.GetData() + uiNumBoundsUpdates, boundsUpdates.GetData() + uiSectionStart, uiCount);
       }
-      else
-      {
-        TraverseHierarchyLevel<RootLevelWithSpatialData>(*dataPtr[0], &userData);
 
-        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
-        {
-          TraverseHierarchyLevel<WithParentWithSpatialData>(*dataPtr[i], &userData);
-        }
-      }
+      uiNumBoundsUpdates += uiCount;
+    }
+
+    if (uiNumBoundsUpdates > 0)
+    {
+      m_pSpatialSystem->UpdateSpatialDataBoundsBatch(boundsUpdates.GetArrayPtr().GetSubArray(0, uiNumBoundsUpdates));
     }
   }
 
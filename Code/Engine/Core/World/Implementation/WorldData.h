@@ -133,14 +133,25 @@ namespace ezInternal
     void TraverseDepthFirst(VisitorFunc& func);
     static ezVisitorExecution::Enum TraverseObjectDepthFirst(ezGameObject* pObject, VisitorFunc& func);
 
-    static void UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
-    static void UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
+    struct TransformUpdateContext
+    {
+      ezSimdFloat m_fInvDeltaSeconds;
+
+      // Each range of blocks writes its bounds changes to the section that starts at its first block index * TRANSFORMATION_DATA_PER_BLOCK
+      // and stores the number of written entries at its first block index. That way no synchronization between the tasks is needed.
+      ezSpatialSystem::BoundsUpdate* m_pBoundsUpdates = nullptr;
+      ezUInt32* m_pNumBoundsUpdates = nullptr;
+    };
 
-    static void UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
-    static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
+    template <bool bWithParent, bool bCollectSpatialData>
+    static ezSpatialSystem::BoundsUpdate* UpdateGlobalTransformsOfBlock(Hierarchy::DataBlock& block, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem::BoundsUpdate* pBoundsUpdates);
+    template <bool bWithParent, bool bCollectSpatialData>
+    void UpdateGlobalTransformsOfLevel(Hierarchy::DataBlockArray& blocks, const TransformUpdateContext& context);
 
     void UpdateGlobalTransforms(float fInvDeltaSeconds);
 
+    ezParallelForStats m_TransformUpdateStats;
+
     // game object lookups
     ezHashTable<ezUInt64, ezGameObjectId, ezHashHelper<ezUInt64>, ezLocalAllocatorWrapper> m_GlobalKeyToIdTable;
     ezHashTable<ezUInt64, ezHashedString, ezHashHelper<ezUInt64>, ezLocalAllocatorWrapper> m_IdToGlobalKeyTable;
@@ -60,37 +60,78 @@ namespace ezInternal
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
+  template <bool bWithParent, bool bCollectSpatialData>
+  EZ_FORCE_INLINE ezSpatialSystem::BoundsUpdate* WorldData::UpdateGlobalTransformsOfBlock(
+    Hierarchy::DataBlock& block, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem::BoundsUpdate* pBoundsUpdates)
   {
-    pData->UpdateGlobalTransformWithoutParent();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBounds();
-  }
+    ezGameObject::TransformationData* pCurrentData = block.m_pData;
+    ezGameObject::TransformationData* pEndData = block.m_pData + block.m_uiCount;
 
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
-  {
-    pData->UpdateGlobalTransformWithParent();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBounds();
-  }
+    for (; pCurrentData < pEndData; ++pCurrentData)
+    {
+      if (bWithParent)
+      {
+        pCurrentData->UpdateGlobalTransformWithParent();
+      }
+      else
+      {
+        pCurrentData->UpdateGlobalTransformWithoutParent();
+      }
 
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndSpatialData(
-    ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
-  {
-    pData->UpdateGlobalTransformWithoutParent();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+      pCurrentData->UpdateVelocity(fInvDeltaSeconds);
+
+      if (bCollectSpatialData)
+      {
+        if (pCurrentData->UpdateGlobalBoundsAndCheckSpatialData())
+        {
+          pBoundsUpdates->m_hData = pCurrentData->m_hSpatialData;
+          pBoundsUpdates->m_pBounds = &pCurrentData->m_globalBounds;
+          ++pBoundsUpdates;
+        }
+      }
+      else
+      {
+        pCurrentData->UpdateGlobalBounds();
+      }
+    }
+
+    return pBoundsUpdates;
   }
 
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndSpatialData(
-    ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
+  template <bool bWithParent, bool bCollectSpatialData>
+  void WorldData::UpdateGlobalTransformsOfLevel(Hierarchy::DataBlockArray& blocks, const TransformUpdateContext& context)
   {
-    pData->UpdateGlobalTransformWithParent();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+    ezParallelForParams parallelForParams;
+    parallelForParams.uiBinSize = 4;
+    parallelForParams.splitMode = ezParallelForSplitMode::Lazy;
+    parallelForParams.pStats = &m_TransformUpdateStats;
+    parallelForParams.pTaskAllocator = m_StackAllocator.GetCurrentAllocator();
+
+    Hierarchy::DataBlock* pBlocks = blocks.GetData();
+
+    ezTaskSystem::ParallelForIndexed(
+      0, blocks.GetCount(),
+      [pBlocks, &context](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        ezSpatialSystem::BoundsUpdate* pStart = nullptr;
+        ezSpatialSystem::BoundsUpdate* pBoundsUpdates = nullptr;
+
+        if (bCollectSpatialData)
+        {
+          pStart = context.m_pBoundsUpdates + uiStartIndex * TRANSFORMATION_DATA_PER_BLOCK;
+          pBoundsUpdates = pStart;
+        }
+
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          pBoundsUpdates = UpdateGlobalTransformsOfBlock<bWithParent, bCollectSpatialData>(pBlocks[i], context.m_fInvDeltaSeconds, pBoundsUpdates);
+        }
+
+        if (bCollectSpatialData)
+        {
+          context.m_pNumBoundsUpdates[uiStartIndex] = static_cast<ezUInt32>(pBoundsUpdates - pStart);
+        }
+      },
+      "World DataBlock Transform Update", parallelForParams);
   }
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -69,6 +69,12 @@ struct EZ_CORE_DLL ezDefaultSpatialDataCategories
 {
   static ezSpatialData::Category RenderStatic;
   static ezSpatialData::Category RenderDynamic;
+
+  /// \brief Objects with bounds in this category are used as occluders, if software occlusion culling is enabled (see ezOcclusionBuffer).
+  ///
+  /// The combined local bounding box of such an object is rasterized, so it must be completely solid and the object should not add
+  /// any other, larger bounds.
+  static ezSpatialData::Category Occluder;
 };
 
 #define ezInvalidSpatialDataCategory ezSpatialData::Category()
@@ -6,6 +6,8 @@
 #include <Foundation/SimdMath/SimdBBoxSphere.h>
 #include <Foundation/Types/TagSet.h>
 
+class ezOcclusionBuffer;
+
 class EZ_CORE_DLL ezSpatialSystem : public ezReflectedClass
 {
   EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem, ezReflectedClass);
@@ -25,6 +27,20 @@ public:
   virtual void DeleteSpatialData(const ezSpatialDataHandle& hData) = 0;
 
   virtual void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) = 0;
+
+  struct BoundsUpdate
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezSpatialDataHandle m_hData;
+    const ezSimdBBoxSphere* m_pBounds;
+  };
+
+  /// \brief Applies many bounds changes in one go, e.g. all changes that were collected during the world's transform update.
+  ///
+  /// The default implementation calls UpdateSpatialDataBounds for every entry. Implementations should override this to
+  /// avoid the per object overhead.
+  virtual void UpdateSpatialDataBoundsBatch(ezArrayPtr<const BoundsUpdate> updates);
   virtual void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) = 0;
 
   ///@}
@@ -36,10 +52,11 @@ public:
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   struct QueryStats
   {
-    ezUInt32 m_uiTotalNumObjects = 0;  ///< The total number of spatial objects in this system.
-    ezUInt32 m_uiNumObjectsTested = 0; ///< Number of objects tested for the query condition.
-    ezUInt32 m_uiNumObjectsPassed = 0; ///< Number of objects that passed the query condition.
-    ezTime m_TimeTaken;                ///< Time taken to execute the query
+    ezUInt32 m_uiTotalNumObjects = 0;    ///< The total number of spatial objects in this system.
+    ezUInt32 m_uiNumObjectsTested = 0;   ///< Number of objects tested for the query condition.
+    ezUInt32 m_uiNumObjectsPassed = 0;   ///< Number of objects that passed the query condition.
+    ezUInt32 m_uiNumObjectsOccluded = 0; ///< Number of objects that passed the frustum test but were hidden by occluders.
+    ezTime m_TimeTaken;                  ///< Time taken to execute the query
   };
 #endif
 
@@ -48,6 +65,10 @@ public:
     ezUInt32 m_uiCategoryBitmask = 0;
     ezTagSet m_IncludeTags;
     ezTagSet m_ExcludeTags;
+
+    /// \brief Optional, only used by FindVisibleObjects. Objects that are hidden behind the rasterized occluders are not returned
+    /// and are not marked as visible. The buffer must not be modified while the query is running.
+    const ezOcclusionBuffer* m_pOcclusionBuffer = nullptr;
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
     QueryStats* m_pStats = nullptr;
 #endif
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Containers/IdTable.h>
+#include <Foundation/Types/UniquePtr.h>
+
+namespace ezInternal
+{
+  struct LooseOctreeQueryHelper;
+}
+
+/// \brief Spatial system that sorts the spatial data of every category into a loose octree.
+///
+/// Every node extends its bounds by half its size into all directions, so every object can be stored in exactly one node, which is
+/// picked directly from the object's size and center without any searching. Objects that are too big or outside of the root node
+/// are stored in an overflow node that is tested by every query.
+/// Compared to ezSpatialSystem_RegularGrid this adapts to scenes that mix very large and very small objects.
+class EZ_CORE_DLL ezSpatialSystem_LooseOctree : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_LooseOctree, ezSpatialSystem);
+
+public:
+  /// \brief fWorldSize is the edge length of the root node, which is centered at the origin. fMinNodeSize is the edge length of the smallest nodes.
+  ezSpatialSystem_LooseOctree(float fWorldSize = 65536.0f, float fMinNodeSize = 16.0f);
+  ~ezSpatialSystem_LooseOctree();
+
+  /// \brief Returns the loose bounding box of the node associated with the given spatial data. Useful for debug visualizations.
+  ezResult GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const;
+
+  /// \brief Returns the loose bounding boxes of all nodes that currently contain objects.
+  void GetAllNodeBoxes(ezDynamicArray<ezBoundingBox>& out_BoundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory) const;
+
+private:
+  friend ezInternal::LooseOctreeQueryHelper;
+
+  // ezSpatialSystem implementation
+  ezSpatialDataHandle CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+  ezSpatialDataHandle CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+
+  void DeleteSpatialData(const ezSpatialDataHandle& hData) override;
+
+  void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) override;
+  void UpdateSpatialDataBoundsBatch(ezArrayPtr<const BoundsUpdate> updates) override;
+  void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) override;
+
+  void FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const override;
+  void FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const override;
+
+  void FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects) const override;
+
+  ezUInt64 GetNumFramesSinceVisible(const ezSpatialDataHandle& hData) const override;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  virtual void GetInternalStats(ezStringBuilder& sb) const override;
+#endif
+
+  ezProxyAllocator m_AlignedAllocator;
+
+  const float m_fRootHalfExtent;
+  ezUInt32 m_uiMaxDepth = 0;
+
+  enum
+  {
+    MAX_NUM_TREES = (sizeof(ezSpatialData::Category::m_uiValue) * 8)
+  };
+
+  struct Node;
+  struct Tree;
+  ezDynamicArray<ezUniquePtr<Tree>> m_Trees;
+
+  struct Data
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiTreeBitmask;
+    ezUInt32 m_uiAlwaysVisible;
+  };
+
+  ezIdTable<ezSpatialDataId, Data, ezLocalAllocatorWrapper> m_DataTable;
+
+  void UpdateSpatialDataBoundsInternal(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds);
+
+  template <typename Functor>
+  void ForEachTree(const Data& data, const ezSpatialDataHandle& hData, Functor func) const;
+
+  struct Stats;
+
+  template <typename Functor>
+  void ForEachMatchingTree(const QueryParams& queryParams, Functor func) const;
+
+  using NodeCallback = ezDelegate<ezVisitorExecution::Enum(const Node&, const QueryParams&, Stats&, void*)>;
+  void ForEachNodeInMatchingTrees(const ezSimdBBox& box, const QueryParams& queryParams, NodeCallback noFilterCallback, NodeCallback filterByTagsCallback, void* pUserData) const;
+};
@@ -36,6 +36,7 @@ private:
   void DeleteSpatialData(const ezSpatialDataHandle& hData) override;
 
   void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) override;
+  void UpdateSpatialDataBoundsBatch(ezArrayPtr<const BoundsUpdate> updates) override;
   void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) override;
 
   void FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const override;
@@ -81,10 +82,16 @@ private:
 
   ezSpatialDataHandle AddSpatialDataToGrids(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible);
 
+  void UpdateSpatialDataBoundsInternal(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds);
+
   template <typename Functor>
   void ForEachGrid(const Data& data, const ezSpatialDataHandle& hData, Functor func) const;
 
   struct Stats;
+
+  template <typename Functor>
+  void ForEachMatchingGrid(const QueryParams& queryParams, Functor func) const;
+
   using CellCallback = ezDelegate<ezVisitorExecution::Enum(const Cell&, const QueryParams&, Stats&, void*)>;
   void ForEachCellInBoxInMatchingGrids(const ezSimdBBox& box, const QueryParams& queryParams, CellCallback noFilterCallback, CellCallback filterByTagsCallback, void* pUserData) const;
 
@@ -9,6 +9,18 @@
 
 class ezTimeStepSmoothing;
 
+/// \brief Selects the spatial system implementation that a world creates when ezWorldDesc::m_bAutoCreateSpatialSystem is set.
+struct ezSpatialSystemType
+{
+  enum Enum
+  {
+    RegularGrid, ///< ezSpatialSystem_RegularGrid, good for scenes where most objects have a similar size
+    LooseOctree, ///< ezSpatialSystem_LooseOctree, good for scenes that mix very large and very small objects
+
+    Default = RegularGrid
+  };
+};
+
 /// \brief Describes the initial state of a world.
 struct ezWorldDesc
 {
@@ -21,6 +33,7 @@ struct ezWorldDesc
 
   ezUniquePtr<ezSpatialSystem> m_pSpatialSystem;
   bool m_bAutoCreateSpatialSystem = true; ///< automatically create a default spatial system if none is set
+  ezSpatialSystemType::Enum m_SpatialSystemType = ezSpatialSystemType::Default; ///< the type of spatial system that is created automatically
 
   ezSharedPtr<ezCoordinateSystemProvider> m_pCoordinateSystemProvider;
   ezUniquePtr<ezTimeStepSmoothing> m_pTimeStepSmoothing; ///< if nullptr, ezDefaultTimeStepSmoothing will be used
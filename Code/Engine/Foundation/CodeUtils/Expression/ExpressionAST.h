@@ -47,6 +47,7 @@ public:
       FirstTernary,
       Clamp,
       Select,
+      MultiplyAdd, ///< First * Second + Third
       LastTernary,
 
       // Constant
@@ -144,6 +145,14 @@ public:
   Node* ReplaceUnsupportedInstructions(Node* pNode);
   Node* FoldConstants(Node* pNode);
 
+  /// \brief Removes operations without effect, e.g. (1 * x) or abs(abs(x)), and merges the constants of nested min/max, e.g. min(1, min(2, x)) becomes min(1, x).
+  /// Nested additions and multiplications are not merged, since rounding makes float arithmetic non-associative.
+  /// Expects the constants to be the left operand, as FoldConstants produces them.
+  Node* ReduceStrength(Node* pNode);
+
+  /// \brief Replaces additions of a multiplication and another register with a single multiply-add.
+  Node* FuseMultiplyAdd(Node* pNode);
+
 private:
   ezStackAllocator<> m_Allocator;
 };
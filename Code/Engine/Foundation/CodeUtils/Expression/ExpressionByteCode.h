@@ -58,6 +58,14 @@ public:
 
       LastBinary,
 
+      // Ternary
+      FirstTernary,
+
+      MulAdd_RRR,
+      MulAdd_CRR,
+
+      LastTernary,
+
       Call,
 
       Nop,
@@ -93,6 +101,12 @@ public:
   static ezUInt32 GetFunctionArgCount(const StorageType*& pByteCode);
 
   void Disassemble(ezStringBuilder& out_sDisassembly) const;
+
+  /// \brief Writes the disassembly of this bytecode and marks the instructions that were added ('+') or removed ('-')
+  /// compared to the reference bytecode, e.g. the same expression compiled without optimizations.
+  ///
+  /// Register indices are ignored for the comparison, since any change shifts the register assignment of all following instructions.
+  void DisassembleDiff(const ezExpressionByteCode& referenceByteCode, ezStringBuilder& out_sDiff) const;
   static const char* GetOpCodeName(OpCode::Enum opCode);
 
   void Save(ezStreamWriter& stream) const;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/CodeUtils/Expression/ExpressionAST.h>
+#include <Foundation/CodeUtils/Expression/ExpressionFunctions.h>
 #include <Foundation/Types/Delegate.h>
 
 class ezExpressionByteCode;
@@ -11,10 +12,27 @@ public:
   ezExpressionCompiler();
   ~ezExpressionCompiler();
 
+  /// \brief Compiles the AST to bytecode. Note that the AST is transformed in place.
   ezResult Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode);
 
+  /// \brief Registers a function that is evaluated at compile time if all its arguments are constant.
+  ///
+  /// Only register functions that don't depend on the global data, since it is only known at execution time.
+  void RegisterFunction(const char* szName, ezExpressionFunction func);
+
+  /// \brief Registers the default functions of ezExpressionVM for constant folding.
+  void RegisterDefaultFunctions();
+
+  /// \brief Disables all transformations that are not required to generate valid bytecode,
+  /// e.g. to compare the optimized bytecode against with ezExpressionByteCode::DisassembleDiff.
+  void SetOptimizationsEnabled(bool bEnabled) { m_bOptimizationsEnabled = bEnabled; }
+  bool GetOptimizationsEnabled() const { return m_bOptimizationsEnabled; }
+
 private:
   ezResult TransformAndOptimizeAST(ezExpressionAST& ast);
+  void RemoveDeadStores(ezExpressionAST& ast);
+  ezExpressionAST::Node* FoldConstants(ezExpressionAST& ast, ezExpressionAST::Node* pNode);
+  ezExpressionAST::Node* EliminateCommonSubexpressions(ezExpressionAST::Node* pNode);
   ezResult BuildNodeInstructions(const ezExpressionAST& ast);
   ezResult UpdateRegisterLifetime(const ezExpressionAST& ast);
   ezResult AssignRegisters();
@@ -29,6 +47,17 @@ private:
   ezHashTable<const ezExpressionAST::Node*, ezUInt32> m_NodeToRegisterIndex;
   ezHashTable<ezExpressionAST::Node*, ezExpressionAST::Node*> m_TransformCache;
 
+  /// \brief Nodes are equal if they have the same type, value and children.
+  struct NodeStructureHashHelper
+  {
+    static ezUInt32 Hash(const ezExpressionAST::Node* pNode);
+    static bool Equal(const ezExpressionAST::Node* a, const ezExpressionAST::Node* b);
+  };
+
+  ezHashTable<const ezExpressionAST::Node*, ezExpressionAST::Node*, NodeStructureHashHelper> m_CommonSubexpressions;
+  ezHashTable<ezHashedString, ezExpressionFunction> m_ConstantFoldingFunctions;
+  bool m_bOptimizationsEnabled = true;
+
   ezHashTable<ezHashedString, ezUInt32> m_InputToIndex;
   ezHashTable<ezHashedString, ezUInt32> m_OutputToIndex;
   ezHashTable<ezHashedString, ezUInt32> m_FunctionToIndex;
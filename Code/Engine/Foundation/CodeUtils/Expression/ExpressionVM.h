@@ -12,6 +12,49 @@ public:
   ezExpressionVM();
   ~ezExpressionVM();
 
+  struct ExecutionMode
+  {
+    enum Enum
+    {
+      SingleBlock,   ///< Every instruction is executed for all instances before the next instruction is executed.
+      Tiled,         ///< The whole bytecode is executed for a block of instances that fits into the cache, then for the next block.
+      TiledParallel, ///< Like Tiled, but large numbers of instances are distributed over multiple tasks. Registered functions must be thread-safe.
+
+      Default = TiledParallel
+    };
+  };
+
+  /// \brief Sets how the instances are distributed. All modes produce exactly the same results.
+  ///
+  /// Since external functions are called once per block in the tiled modes, they must not rely on seeing all instances at once.
+  /// In ExecutionMode::TiledParallel (the default) they are also called concurrently from multiple worker threads.
+  void SetExecutionMode(ExecutionMode::Enum mode) { m_ExecutionMode = mode; }
+  ExecutionMode::Enum GetExecutionMode() const { return m_ExecutionMode; }
+
+  struct InstructionSet
+  {
+    enum Enum
+    {
+      SSE,    ///< 4 instances per instruction.
+      AVX2,   ///< 8 instances per instruction for the arithmetic instructions, the others fall back to SSE.
+      AVX512, ///< 16 instances per instruction for the arithmetic instructions, the others fall back to SSE.
+              ///< Not the default, since many CPUs lower their clock speed while running AVX-512 code, which slows down everything else.
+
+      Default = AVX2
+    };
+  };
+
+  /// \brief Sets the widest instruction set the VM may use. All instruction sets produce exactly the same results.
+  ///
+  /// The instruction set is only used if the CPU and the OS support it, otherwise the VM falls back to the next narrower one.
+  void SetMaxInstructionSet(InstructionSet::Enum instructionSet) { m_MaxInstructionSet = instructionSet; }
+  InstructionSet::Enum GetMaxInstructionSet() const { return m_MaxInstructionSet; }
+
+  /// \brief Registers an external function that the bytecode can call.
+  ///
+  /// The function is called once per block of instances and, with the default ExecutionMode::TiledParallel, concurrently from worker threads.
+  /// It must therefore be thread-safe, e.g. only read the global data and write nothing but its output.
+  /// Functions that are not thread-safe require ExecutionMode::Tiled or ExecutionMode::SingleBlock.
   void RegisterFunction(const char* szName, ezExpressionFunction func, ezExpressionValidateGlobalData validationFunc = ezExpressionValidateGlobalData());
 
   void RegisterDefaultFunctions();
@@ -21,6 +64,12 @@ public:
 private:
   void ValidateDataSize(const ezProcessingStream& stream, ezUInt32 uiNumInstances, const char* szDataName) const;
 
+  ezResult ExecuteBlock(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezProcessingStream> inputs, ezArrayPtr<ezProcessingStream> outputs,
+    ezUInt32 uiFirstInstance, ezUInt32 uiNumRegisters, ezSimdVec4f* pRegisters, InstructionSet::Enum instructionSet, const ezExpression::GlobalData& globalData) const;
+
+  ExecutionMode::Enum m_ExecutionMode = ExecutionMode::Default;
+  InstructionSet::Enum m_MaxInstructionSet = InstructionSet::Default;
+
   ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_Registers;
 
   ezDynamicArray<ezUInt32> m_InputMapping;
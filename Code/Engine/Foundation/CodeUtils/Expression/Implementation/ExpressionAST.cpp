@@ -50,7 +50,7 @@ namespace
     "", "Add", "Subtract", "Multiply", "Divide", "Min", "Max", "",
 
     // Ternary
-    "", "Clamp", "Select", "",
+    "", "Clamp", "Select", "MultiplyAdd", "",
 
     // Constant
     "FloatConstant",
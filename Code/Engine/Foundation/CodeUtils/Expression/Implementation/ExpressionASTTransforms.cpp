@@ -161,3 +161,79 @@ ezExpressionAST::Node* ezExpressionAST::FoldConstants(Node* pNode)
 
   return pNode;
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+ezExpressionAST::Node* ezExpressionAST::ReduceStrength(Node* pNode)
+{
+  NodeType::Enum nodeType = pNode->m_Type;
+  if (NodeType::IsUnary(nodeType))
+  {
+    auto pUnaryNode = static_cast<const UnaryOperator*>(pNode);
+    if (nodeType == NodeType::Absolute && pUnaryNode->m_pOperand->m_Type == NodeType::Absolute)
+    {
+      return pUnaryNode->m_pOperand;
+    }
+  }
+  else if (NodeType::IsBinary(nodeType))
+  {
+    auto pBinaryNode = static_cast<const BinaryOperator*>(pNode);
+    if (!NodeType::IsConstant(pBinaryNode->m_pLeftOperand->m_Type))
+      return pNode;
+
+    auto pConstantNode = static_cast<Constant*>(pBinaryNode->m_pLeftOperand);
+    const float fValue = pConstantNode->m_Value.Get<float>();
+    auto pOperand = pBinaryNode->m_pRightOperand;
+
+    // Only -0 is the identity of an addition, x + 0 turns -0 into +0
+    if ((nodeType == NodeType::Add && fValue == 0.0f && std::signbit(fValue)) || (nodeType == NodeType::Multiply && fValue == 1.0f))
+    {
+      return pOperand;
+    }
+
+    // Nested min/max with a constant as operand, merge the two constants.
+    // Additions and multiplications are not merged, since rounding makes float arithmetic non-associative.
+    if (pOperand->m_Type == nodeType && (nodeType == NodeType::Min || nodeType == NodeType::Max))
+    {
+      auto pInnerNode = static_cast<const BinaryOperator*>(pOperand);
+      if (NodeType::IsConstant(pInnerNode->m_pLeftOperand->m_Type))
+      {
+        const float fInnerValue = static_cast<const Constant*>(pInnerNode->m_pLeftOperand)->m_Value.Get<float>();
+
+        const float fMergedValue = (nodeType == NodeType::Min) ? ezMath::Min(fValue, fInnerValue) : ezMath::Max(fValue, fInnerValue);
+
+        return ReduceStrength(CreateBinaryOperator(nodeType, CreateConstant(fMergedValue), pInnerNode->m_pRightOperand));
+      }
+    }
+  }
+
+  return pNode;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezExpressionAST::Node* ezExpressionAST::FuseMultiplyAdd(Node* pNode)
+{
+  if (pNode->m_Type != NodeType::Add)
+    return pNode;
+
+  // A constant addend would need a separate mov instruction, so there would be nothing to gain.
+  auto pBinaryNode = static_cast<const BinaryOperator*>(pNode);
+  if (NodeType::IsConstant(pBinaryNode->m_pLeftOperand->m_Type))
+    return pNode;
+
+  // Even if the multiplication is used elsewhere, the multiply-add replaces the addition without adding an instruction.
+  for (ezUInt32 i = 0; i < 2; ++i)
+  {
+    auto pOperand = (i == 0) ? pBinaryNode->m_pLeftOperand : pBinaryNode->m_pRightOperand;
+    auto pAddend = (i == 0) ? pBinaryNode->m_pRightOperand : pBinaryNode->m_pLeftOperand;
+
+    if (pOperand->m_Type == NodeType::Multiply)
+    {
+      auto pMultiplyNode = static_cast<const BinaryOperator*>(pOperand);
+      return CreateTernaryOperator(NodeType::MultiplyAdd, pMultiplyNode->m_pLeftOperand, pMultiplyNode->m_pRightOperand, pAddend);
+    }
+  }
+
+  return pNode;
+}
@@ -50,6 +50,14 @@ namespace
 
     "",
 
+    // Ternary
+    "",
+
+    "MulAdd_RRR",
+    "MulAdd_CRR",
+
+    "",
+
     "Call",
 
     "Nop",
@@ -60,7 +68,7 @@ namespace
   static bool FirstArgIsConstant(ezExpressionByteCode::OpCode::Enum opCode)
   {
     return opCode == ezExpressionByteCode::OpCode::Mov_C || opCode == ezExpressionByteCode::OpCode::Add_CR || opCode == ezExpressionByteCode::OpCode::Sub_CR || opCode == ezExpressionByteCode::OpCode::Mul_CR || opCode == ezExpressionByteCode::OpCode::Div_CR ||
-           opCode == ezExpressionByteCode::OpCode::Min_CR || opCode == ezExpressionByteCode::OpCode::Max_CR;
+           opCode == ezExpressionByteCode::OpCode::Min_CR || opCode == ezExpressionByteCode::OpCode::Max_CR || opCode == ezExpressionByteCode::OpCode::MulAdd_CRR;
   }
 } // namespace
 
@@ -158,6 +166,22 @@ void ezExpressionByteCode::Disassemble(ezStringBuilder& out_sDisassembly) const
         out_sDisassembly.AppendFormat("{0} r{1} r{2} r{3}\n", szOpCode, r, a, b);
       }
     }
+    else if (opCode > OpCode::FirstTernary && opCode < OpCode::LastTernary)
+    {
+      ezUInt32 r = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 a = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 b = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 c = GetRegisterIndex(pByteCode, 1);
+
+      if (FirstArgIsConstant(opCode))
+      {
+        out_sDisassembly.AppendFormat("{0} r{1} {2} r{3} r{4}\n", szOpCode, r, ezArgF(*reinterpret_cast<float*>(&a), 6), b, c);
+      }
+      else
+      {
+        out_sDisassembly.AppendFormat("{0} r{1} r{2} r{3} r{4}\n", szOpCode, r, a, b, c);
+      }
+    }
     else if (opCode == OpCode::Call)
     {
       ezUInt32 uiIndex = GetFunctionIndex(pByteCode);
@@ -193,6 +217,83 @@ void ezExpressionByteCode::Disassemble(ezStringBuilder& out_sDisassembly) const
   }
 }
 
+void ezExpressionByteCode::DisassembleDiff(const ezExpressionByteCode& referenceByteCode, ezStringBuilder& out_sDiff) const
+{
+  ezStringBuilder sReference, sDisassembly;
+  referenceByteCode.Disassemble(sReference);
+  Disassemble(sDisassembly);
+
+  ezDynamicArray<ezStringView> referenceLines, lines;
+  sReference.Split(true, referenceLines, "\n");
+  sDisassembly.Split(true, lines, "\n");
+
+  // Compare the lines without register indices
+  auto GetKeys = [](ezArrayPtr<const ezStringView> lines, ezDynamicArray<ezUInt32>& out_keys) {
+    ezStringBuilder sKey;
+    out_keys.Reserve(lines.GetCount());
+
+    for (ezStringView sLine : lines)
+    {
+      sKey.Clear();
+
+      bool bInRegister = false;
+      for (ezStringView it = sLine; it.IsValid(); ++it)
+      {
+        const ezUInt32 uiChar = it.GetCharacter();
+        if (bInRegister && ezStringUtils::IsDecimalDigit(uiChar))
+          continue;
+
+        bInRegister = (uiChar == 'r');
+        sKey.Append(uiChar);
+      }
+
+      out_keys.PushBack(ezHashingUtils::StringHashTo32(ezHashingUtils::StringHash(sKey)));
+    }
+  };
+
+  ezDynamicArray<ezUInt32> referenceKeys, keys;
+  GetKeys(referenceLines, referenceKeys);
+  GetKeys(lines, keys);
+
+  // Longest common subsequence, the disassembly of a single expression is small enough to do this in quadratic time
+  const ezUInt32 uiNumReferenceLines = referenceLines.GetCount();
+  const ezUInt32 uiNumLines = lines.GetCount();
+  const ezUInt32 uiStride = uiNumLines + 1;
+
+  ezDynamicArray<ezUInt32> commonLength;
+  commonLength.SetCount((uiNumReferenceLines + 1) * uiStride);
+
+  for (ezUInt32 i = uiNumReferenceLines; i-- > 0;)
+  {
+    for (ezUInt32 j = uiNumLines; j-- > 0;)
+    {
+      commonLength[i * uiStride + j] = (referenceKeys[i] == keys[j]) ? commonLength[(i + 1) * uiStride + j + 1] + 1
+                                                                     : ezMath::Max(commonLength[(i + 1) * uiStride + j], commonLength[i * uiStride + j + 1]);
+    }
+  }
+
+  ezUInt32 i = 0, j = 0;
+  while (i < uiNumReferenceLines || j < uiNumLines)
+  {
+    if (i < uiNumReferenceLines && j < uiNumLines && referenceKeys[i] == keys[j])
+    {
+      out_sDiff.AppendFormat("  {}\n", lines[j]);
+      ++i;
+      ++j;
+    }
+    else if (j < uiNumLines && (i == uiNumReferenceLines || commonLength[i * uiStride + j + 1] >= commonLength[(i + 1) * uiStride + j]))
+    {
+      out_sDiff.AppendFormat("+ {}\n", lines[j]);
+      ++j;
+    }
+    else
+    {
+      out_sDiff.AppendFormat("- {}\n", referenceLines[i]);
+      ++i;
+    }
+  }
+}
+
 const char* ezExpressionByteCode::GetOpCodeName(OpCode::Enum opCode)
 {
   return s_szOpCodeNames[opCode];
@@ -217,7 +318,7 @@ void ezExpressionByteCode::Save(ezStreamWriter& stream) const
   }
 
   {
-    chunk.BeginChunk("Code", 2);
+    chunk.BeginChunk("Code", 3);
 
     chunk << m_ByteCode.GetCount();
     chunk.WriteBytes(m_ByteCode.GetData(), m_ByteCode.GetCount() * sizeof(StorageType)).IgnoreResult();
@@ -257,7 +358,8 @@ ezResult ezExpressionByteCode::Load(ezStreamReader& stream)
     }
     else if (chunk.GetCurrentChunk().m_sChunkName == "Code")
     {
-      if (chunk.GetCurrentChunk().m_uiChunkVersion >= 2)
+      // Version 3 inserted the ternary op codes
+      if (chunk.GetCurrentChunk().m_uiChunkVersion >= 3)
       {
         ezUInt32 uiByteCodeCount = 0;
         chunk >> uiByteCodeCount;
@@ -267,7 +369,7 @@ ezResult ezExpressionByteCode::Load(ezStreamReader& stream)
       }
       else
       {
-        ezLog::Error("Invalid Code Chunk Version {0}. Expected >= 2", chunk.GetCurrentChunk().m_uiChunkVersion);
+        ezLog::Error("Invalid Code Chunk Version {0}. Expected >= 3", chunk.GetCurrentChunk().m_uiChunkVersion);
 
         chunk.EndStream();
         return EZ_FAILURE;
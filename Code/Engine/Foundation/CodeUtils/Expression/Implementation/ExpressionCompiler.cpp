@@ -40,6 +40,9 @@ namespace
         return ezExpressionByteCode::OpCode::Min_RR;
       case ezExpressionAST::NodeType::Max:
         return ezExpressionByteCode::OpCode::Max_RR;
+
+      case ezExpressionAST::NodeType::MultiplyAdd:
+        return ezExpressionByteCode::OpCode::MulAdd_RRR;
       default:
         EZ_ASSERT_NOT_IMPLEMENTED;
         return ezExpressionByteCode::OpCode::Nop;
@@ -63,14 +66,167 @@ ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCod
   return EZ_SUCCESS;
 }
 
+void ezExpressionCompiler::RegisterFunction(const char* szName, ezExpressionFunction func)
+{
+  ezHashedString sName;
+  sName.Assign(szName);
+
+  m_ConstantFoldingFunctions.Insert(sName, func);
+}
+
+void ezExpressionCompiler::RegisterDefaultFunctions()
+{
+  RegisterFunction("Random", &ezDefaultExpressionFunctions::Random);
+  RegisterFunction("PerlinNoise", &ezDefaultExpressionFunctions::PerlinNoise);
+}
+
 ezResult ezExpressionCompiler::TransformAndOptimizeAST(ezExpressionAST& ast)
 {
   EZ_SUCCEED_OR_RETURN(TransformASTPreOrder(ast, ezMakeDelegate(&ezExpressionAST::ReplaceUnsupportedInstructions, &ast)));
-  EZ_SUCCEED_OR_RETURN(TransformASTPostOrder(ast, ezMakeDelegate(&ezExpressionAST::FoldConstants, &ast)));
+
+  if (!m_bOptimizationsEnabled)
+    return EZ_SUCCESS;
+
+  RemoveDeadStores(ast);
+
+  EZ_SUCCEED_OR_RETURN(TransformASTPostOrder(ast, [&](ezExpressionAST::Node* pNode) { return FoldConstants(ast, pNode); }));
+  EZ_SUCCEED_OR_RETURN(TransformASTPostOrder(ast, ezMakeDelegate(&ezExpressionAST::ReduceStrength, &ast)));
+
+  m_CommonSubexpressions.Clear();
+  EZ_SUCCEED_OR_RETURN(TransformASTPostOrder(ast, ezMakeDelegate(&ezExpressionCompiler::EliminateCommonSubexpressions, this)));
+
+  // Needs to run last, the other transforms don't know the multiply-add node
+  EZ_SUCCEED_OR_RETURN(TransformASTPostOrder(ast, ezMakeDelegate(&ezExpressionAST::FuseMultiplyAdd, &ast)));
 
   return EZ_SUCCESS;
 }
 
+void ezExpressionCompiler::RemoveDeadStores(ezExpressionAST& ast)
+{
+  // Only the last output with a given name is visible after execution
+  for (ezUInt32 i = ast.m_OutputNodes.GetCount(); i-- > 0;)
+  {
+    auto pOutputNode = ast.m_OutputNodes[i];
+    if (pOutputNode == nullptr)
+      continue;
+
+    for (ezUInt32 j = i + 1; j < ast.m_OutputNodes.GetCount(); ++j)
+    {
+      if (ast.m_OutputNodes[j] != nullptr && ast.m_OutputNodes[j]->m_sName == pOutputNode->m_sName)
+      {
+        ast.m_OutputNodes.RemoveAtAndCopy(i);
+        break;
+      }
+    }
+  }
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::FoldConstants(ezExpressionAST& ast, ezExpressionAST::Node* pNode)
+{
+  if (pNode->m_Type != ezExpressionAST::NodeType::FunctionCall)
+    return ast.FoldConstants(pNode);
+
+  auto pFunctionCall = static_cast<const ezExpressionAST::FunctionCall*>(pNode);
+
+  const ezExpressionFunction* pFunc = m_ConstantFoldingFunctions.GetValue(pFunctionCall->m_sName);
+  if (pFunc == nullptr)
+    return pNode;
+
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> argValues;
+  argValues.Reserve(pFunctionCall->m_Arguments.GetCount());
+
+  for (auto pArg : pFunctionCall->m_Arguments)
+  {
+    if (!ezExpressionAST::NodeType::IsConstant(pArg->m_Type))
+      return pNode;
+
+    argValues.PushBack(ezSimdVec4f(static_cast<const ezExpressionAST::Constant*>(pArg)->m_Value.Get<float>()));
+  }
+
+  ezHybridArray<ezArrayPtr<const ezSimdVec4f>, 8> inputs;
+  for (auto& argValue : argValues)
+  {
+    inputs.PushBack(ezMakeArrayPtr(&argValue, 1));
+  }
+
+  ezSimdVec4f result;
+  (*pFunc)(inputs, ezMakeArrayPtr(&result, 1), ezExpression::GlobalData());
+
+  return ast.CreateConstant(static_cast<float>(result.x()));
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::EliminateCommonSubexpressions(ezExpressionAST::Node* pNode)
+{
+  // The transform runs in post order so all children have already been replaced by their unique version
+  ezExpressionAST::Node* pExistingNode = nullptr;
+  if (m_CommonSubexpressions.TryGetValue(pNode, pExistingNode))
+    return pExistingNode;
+
+  m_CommonSubexpressions.Insert(pNode, pNode);
+  return pNode;
+}
+
+// static
+ezUInt32 ezExpressionCompiler::NodeStructureHashHelper::Hash(const ezExpressionAST::Node* pNode)
+{
+  ezHybridArray<ezUInt64, 8> data;
+  data.PushBack(pNode->m_Type.GetValue());
+
+  ezExpressionAST::NodeType::Enum nodeType = pNode->m_Type;
+  if (ezExpressionAST::NodeType::IsConstant(nodeType))
+  {
+    const float fValue = static_cast<const ezExpressionAST::Constant*>(pNode)->m_Value.Get<float>();
+    data.PushBack(*reinterpret_cast<const ezUInt32*>(&fValue));
+  }
+  else if (ezExpressionAST::NodeType::IsInput(nodeType))
+  {
+    data.PushBack(static_cast<const ezExpressionAST::Input*>(pNode)->m_sName.GetHash());
+  }
+  else if (nodeType == ezExpressionAST::NodeType::FunctionCall)
+  {
+    data.PushBack(static_cast<const ezExpressionAST::FunctionCall*>(pNode)->m_sName.GetHash());
+  }
+
+  for (auto pChild : ezExpressionAST::GetChildren(pNode))
+  {
+    data.PushBack(reinterpret_cast<size_t>(pChild));
+  }
+
+  return ezHashingUtils::xxHash32(data.GetData(), data.GetCount() * sizeof(ezUInt64));
+}
+
+// static
+bool ezExpressionCompiler::NodeStructureHashHelper::Equal(const ezExpressionAST::Node* a, const ezExpressionAST::Node* b)
+{
+  if (a->m_Type != b->m_Type)
+    return false;
+
+  ezExpressionAST::NodeType::Enum nodeType = a->m_Type;
+  if (ezExpressionAST::NodeType::IsConstant(nodeType))
+  {
+    // compare the bits, so 0 and -0 are not merged
+    const float fValueA = static_cast<const ezExpressionAST::Constant*>(a)->m_Value.Get<float>();
+    const float fValueB = static_cast<const ezExpressionAST::Constant*>(b)->m_Value.Get<float>();
+    return ezMemoryUtils::IsEqual(&fValueA, &fValueB);
+  }
+  else if (ezExpressionAST::NodeType::IsInput(nodeType))
+  {
+    auto pInputA = static_cast<const ezExpressionAST::Input*>(a);
+    auto pInputB = static_cast<const ezExpressionAST::Input*>(b);
+    return pInputA->m_sName == pInputB->m_sName && pInputA->m_DataType == pInputB->m_DataType;
+  }
+  else if (nodeType == ezExpressionAST::NodeType::FunctionCall)
+  {
+    // expression functions are required to be state-less
+    if (static_cast<const ezExpressionAST::FunctionCall*>(a)->m_sName != static_cast<const ezExpressionAST::FunctionCall*>(b)->m_sName)
+      return false;
+  }
+
+  auto childrenA = ezExpressionAST::GetChildren(a);
+  auto childrenB = ezExpressionAST::GetChildren(b);
+  return childrenA == childrenB;
+}
+
 ezResult ezExpressionCompiler::BuildNodeInstructions(const ezExpressionAST& ast)
 {
   m_NodeStack.Clear();
@@ -112,6 +268,19 @@ ezResult ezExpressionCompiler::BuildNodeInstructions(const ezExpressionAST& ast)
 
         nodeStackTemp.PushBack(pBinary->m_pRightOperand);
       }
+      else if (pCurrentNode->m_Type == ezExpressionAST::NodeType::MultiplyAdd)
+      {
+        // Same for the first operand of a multiply-add
+        auto pTernary = static_cast<const ezExpressionAST::TernaryOperator*>(pCurrentNode);
+        bool bFirstIsConstant = ezExpressionAST::NodeType::IsConstant(pTernary->m_pFirstOperand->m_Type);
+        if (!bFirstIsConstant)
+        {
+          nodeStackTemp.PushBack(pTernary->m_pFirstOperand);
+        }
+
+        nodeStackTemp.PushBack(pTernary->m_pSecondOperand);
+        nodeStackTemp.PushBack(pTernary->m_pThirdOperand);
+      }
       else
       {
         auto children = ezExpressionAST::GetChildren(pCurrentNode);
@@ -285,6 +454,30 @@ ezResult ezExpressionCompiler::GenerateByteCode(const ezExpressionAST& ast, ezEx
       byteCode.PushBack(bLeftIsConstant ? uiConstantValue : m_NodeToRegisterIndex[pBinary->m_pLeftOperand]);
       byteCode.PushBack(m_NodeToRegisterIndex[pBinary->m_pRightOperand]);
     }
+    else if (ezExpressionAST::NodeType::IsTernary(nodeType))
+    {
+      auto pTernary = static_cast<const ezExpressionAST::TernaryOperator*>(pCurrentNode);
+      bool bFirstIsConstant = ezExpressionAST::NodeType::IsConstant(pTernary->m_pFirstOperand->m_Type);
+      auto opCode = NodeTypeToOpCode(nodeType);
+      if (opCode == ezExpressionByteCode::OpCode::Nop)
+        return EZ_FAILURE;
+
+      ezUInt32 uiConstantValue = 0;
+
+      if (bFirstIsConstant)
+      {
+        opCode = static_cast<ezExpressionByteCode::OpCode::Enum>(opCode + 1);
+
+        auto pConstant = static_cast<const ezExpressionAST::Constant*>(pTernary->m_pFirstOperand);
+        uiConstantValue = *reinterpret_cast<const ezUInt32*>(&pConstant->m_Value.Get<float>());
+      }
+
+      byteCode.PushBack(opCode);
+      byteCode.PushBack(uiTargetRegister);
+      byteCode.PushBack(bFirstIsConstant ? uiConstantValue : m_NodeToRegisterIndex[pTernary->m_pFirstOperand]);
+      byteCode.PushBack(m_NodeToRegisterIndex[pTernary->m_pSecondOperand]);
+      byteCode.PushBack(m_NodeToRegisterIndex[pTernary->m_pThirdOperand]);
+    }
     else if (ezExpressionAST::NodeType::IsConstant(nodeType))
     {
       auto pConstant = static_cast<const ezExpressionAST::Constant*>(pCurrentNode);
@@ -4,6 +4,16 @@
 #include <Foundation/CodeUtils/Expression/ExpressionVM.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/SimdMath/SimdMath.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86) && EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+#  define EZ_EXPRESSIONVM_WIDE_OPERATIONS EZ_ON
+#  include <immintrin.h>
+#else
+#  define EZ_EXPRESSIONVM_WIDE_OPERATIONS EZ_OFF
+#endif
 
 namespace
 {
@@ -15,14 +25,191 @@ namespace
 #  define VM_INLINE EZ_ALWAYS_INLINE
 #endif
 
-  template <typename Func>
-  VM_INLINE void VMOperation1(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  // The registers of one block should stay in the L1 cache while the whole bytecode runs over the block.
+  constexpr ezUInt32 s_uiTargetRegisterBytesPerBlock = 32 * 1024;
+
+  // Every block has to decode the whole bytecode again, so blocks must not become too small.
+  constexpr ezUInt32 s_uiMinNumRegistersPerBlock = 16;
+  constexpr ezUInt32 s_uiMaxNumRegistersPerBlock = 1024;
+
+  // Fewer instances are not worth the overhead of a task.
+  constexpr ezUInt32 s_uiMinNumInstancesPerTask = 4 * 1024;
+
+  using InstructionSet = ezExpressionVM::InstructionSet;
+  using OpCode = ezExpressionByteCode::OpCode;
+
+  InstructionSet::Enum GetSupportedInstructionSet(InstructionSet::Enum maxInstructionSet)
+  {
+#if EZ_ENABLED(EZ_EXPRESSIONVM_WIDE_OPERATIONS)
+    const ezSystemInformation& systemInfo = ezSystemInformation::Get();
+
+    if (maxInstructionSet >= InstructionSet::AVX512 && systemInfo.SupportsAVX512())
+      return InstructionSet::AVX512;
+
+    if (maxInstructionSet >= InstructionSet::AVX2 && systemInfo.SupportsAVX2())
+      return InstructionSet::AVX2;
+#endif
+
+    return InstructionSet::SSE;
+  }
+
+  // Only the arithmetic operations have wide implementations. They produce bit identical results to the SSE implementations,
+  // whereas the approximations in ezSimdMath would have to be duplicated for every instruction set.
+  constexpr bool HasWideOperation(OpCode::Enum opCode)
+  {
+    return opCode == OpCode::Abs_R || opCode == OpCode::Sqrt_R || opCode == OpCode::Mov_R || opCode == OpCode::Mov_C ||
+           (opCode > OpCode::FirstBinary && opCode < OpCode::LastBinary) || (opCode > OpCode::FirstTernary && opCode < OpCode::LastTernary);
+  }
+
+#if EZ_ENABLED(EZ_EXPRESSIONVM_WIDE_OPERATIONS)
+
+  // The wide instructions are only used after checking the CPU features at runtime, so the rest of the file must not be compiled
+  // with them enabled. MSVC allows all intrinsics without special flags.
+#  if EZ_ENABLED(EZ_COMPILER_MSVC)
+#    define VM_TARGET_AVX2
+#    define VM_TARGET_AVX512
+#  else
+#    define VM_TARGET_AVX2 __attribute__((target("avx2")))
+#    define VM_TARGET_AVX512 __attribute__((target("avx512f")))
+#  endif
+
+  // Unused operands are ignored. The operand order matches the SSE implementations, since min and max are not commutative for NaN.
+  // Multiply-add only uses a fused instruction if ezSimdVec4f::MulAdd does, otherwise the rounding would differ.
+  template <OpCode::Enum Op>
+  VM_TARGET_AVX2 EZ_ALWAYS_INLINE __m256 WideOperation_AVX2(__m256 a, __m256 b, __m256 c)
+  {
+    // clang-format off
+    if constexpr (Op == OpCode::Abs_R) return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+    else if constexpr (Op == OpCode::Sqrt_R) return _mm256_sqrt_ps(a);
+    else if constexpr (Op == OpCode::Mov_R || Op == OpCode::Mov_C) return a;
+    else if constexpr (Op == OpCode::Add_RR || Op == OpCode::Add_CR) return _mm256_add_ps(a, b);
+    else if constexpr (Op == OpCode::Sub_RR || Op == OpCode::Sub_CR) return _mm256_sub_ps(a, b);
+    else if constexpr (Op == OpCode::Mul_RR || Op == OpCode::Mul_CR) return _mm256_mul_ps(a, b);
+    else if constexpr (Op == OpCode::Div_RR || Op == OpCode::Div_CR) return _mm256_div_ps(a, b);
+    else if constexpr (Op == OpCode::Min_RR || Op == OpCode::Min_CR) return _mm256_min_ps(a, b);
+    else if constexpr (Op == OpCode::Max_RR || Op == OpCode::Max_CR) return _mm256_max_ps(a, b);
+#  if EZ_SSE_LEVEL >= EZ_SSE_AVX2
+    else if constexpr (Op == OpCode::MulAdd_RRR || Op == OpCode::MulAdd_CRR) return _mm256_fmadd_ps(a, b, c);
+#  else
+    else if constexpr (Op == OpCode::MulAdd_RRR || Op == OpCode::MulAdd_CRR) return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#  endif
+    // clang-format on
+  }
+
+  template <OpCode::Enum Op>
+  VM_TARGET_AVX512 EZ_ALWAYS_INLINE __m512 WideOperation_AVX512(__m512 a, __m512 b, __m512 c)
+  {
+    // clang-format off
+    if constexpr (Op == OpCode::Abs_R) return _mm512_abs_ps(a);
+    else if constexpr (Op == OpCode::Sqrt_R) return _mm512_sqrt_ps(a);
+    else if constexpr (Op == OpCode::Mov_R || Op == OpCode::Mov_C) return a;
+    else if constexpr (Op == OpCode::Add_RR || Op == OpCode::Add_CR) return _mm512_add_ps(a, b);
+    else if constexpr (Op == OpCode::Sub_RR || Op == OpCode::Sub_CR) return _mm512_sub_ps(a, b);
+    else if constexpr (Op == OpCode::Mul_RR || Op == OpCode::Mul_CR) return _mm512_mul_ps(a, b);
+    else if constexpr (Op == OpCode::Div_RR || Op == OpCode::Div_CR) return _mm512_div_ps(a, b);
+    else if constexpr (Op == OpCode::Min_RR || Op == OpCode::Min_CR) return _mm512_min_ps(a, b);
+    else if constexpr (Op == OpCode::Max_RR || Op == OpCode::Max_CR) return _mm512_max_ps(a, b);
+#  if EZ_SSE_LEVEL >= EZ_SSE_AVX2
+    else if constexpr (Op == OpCode::MulAdd_RRR || Op == OpCode::MulAdd_CRR) return _mm512_fmadd_ps(a, b, c);
+#  else
+    // AVX-512 implies FMA, the explicit rounding variants prevent the compiler from contracting the multiplication and addition
+    else if constexpr (Op == OpCode::MulAdd_RRR || Op == OpCode::MulAdd_CRR) return _mm512_add_round_ps(_mm512_mul_round_ps(a, b, _MM_FROUND_CUR_DIRECTION), c, _MM_FROUND_CUR_DIRECTION);
+#  endif
+    // clang-format on
+  }
+
+  // These are deliberately not inlined into the SSE code, so the compiler can insert a vzeroupper on return and
+  // avoid the penalty for mixing wide and SSE instructions.
+  template <OpCode::Enum Op, bool bConstantA>
+  VM_TARGET_AVX2 ezUInt32 VMWideOperation_AVX2(float* r, const float* a, const float* b, const float* c, ezUInt32 uiNumRegisters)
+  {
+    const ezUInt32 uiNumWideRegisters = uiNumRegisters / 2;
+    const float* re = r + uiNumWideRegisters * 8;
+
+    const __m256 constantA = bConstantA ? _mm256_set1_ps(*a) : _mm256_setzero_ps();
+
+    while (r != re)
+    {
+      const __m256 va = bConstantA ? constantA : _mm256_loadu_ps(a);
+      const __m256 vb = (Op > OpCode::FirstBinary) ? _mm256_loadu_ps(b) : va;
+      const __m256 vc = (Op > OpCode::FirstTernary) ? _mm256_loadu_ps(c) : va;
+      _mm256_storeu_ps(r, WideOperation_AVX2<Op>(va, vb, vc));
+
+      r += 8;
+      a += bConstantA ? 0 : 8;
+      b += (Op > OpCode::FirstBinary) ? 8 : 0;
+      c += (Op > OpCode::FirstTernary) ? 8 : 0;
+    }
+
+    return uiNumWideRegisters * 2;
+  }
+
+  template <OpCode::Enum Op, bool bConstantA>
+  VM_TARGET_AVX512 ezUInt32 VMWideOperation_AVX512(float* r, const float* a, const float* b, const float* c, ezUInt32 uiNumRegisters)
+  {
+    const ezUInt32 uiNumWideRegisters = uiNumRegisters / 4;
+    const float* re = r + uiNumWideRegisters * 16;
+
+    const __m512 constantA = bConstantA ? _mm512_set1_ps(*a) : _mm512_setzero_ps();
+
+    while (r != re)
+    {
+      const __m512 va = bConstantA ? constantA : _mm512_loadu_ps(a);
+      const __m512 vb = (Op > OpCode::FirstBinary) ? _mm512_loadu_ps(b) : va;
+      const __m512 vc = (Op > OpCode::FirstTernary) ? _mm512_loadu_ps(c) : va;
+      _mm512_storeu_ps(r, WideOperation_AVX512<Op>(va, vb, vc));
+
+      r += 16;
+      a += bConstantA ? 0 : 16;
+      b += (Op > OpCode::FirstBinary) ? 16 : 0;
+      c += (Op > OpCode::FirstTernary) ? 16 : 0;
+    }
+
+    return uiNumWideRegisters * 4;
+  }
+
+#  undef VM_TARGET_AVX2
+#  undef VM_TARGET_AVX512
+
+#endif
+
+  // Processes as many registers as possible with the given wide instruction set and returns how many have been processed.
+  // The remaining registers have to be processed with SSE.
+  template <OpCode::Enum Op, bool bConstantA>
+  VM_INLINE ezUInt32 VMWideOperation(
+    InstructionSet::Enum instructionSet, ezSimdVec4f* r, const float* a, const ezSimdVec4f* b, const ezSimdVec4f* c, ezUInt32 uiNumRegisters)
+  {
+#if EZ_ENABLED(EZ_EXPRESSIONVM_WIDE_OPERATIONS)
+    if constexpr (HasWideOperation(Op))
+    {
+      float* pR = reinterpret_cast<float*>(r);
+      const float* pB = reinterpret_cast<const float*>(b);
+      const float* pC = reinterpret_cast<const float*>(c);
+
+      if (instructionSet == InstructionSet::AVX512)
+        return VMWideOperation_AVX512<Op, bConstantA>(pR, a, pB, pC, uiNumRegisters);
+
+      if (instructionSet == InstructionSet::AVX2)
+        return VMWideOperation_AVX2<Op, bConstantA>(pR, a, pB, pC, uiNumRegisters);
+    }
+#endif
+
+    return 0;
+  }
+
+  template <OpCode::Enum Op, typename Func>
+  VM_INLINE void VMOperation1(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    InstructionSet::Enum instructionSet, Func func)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
 
     ezSimdVec4f* x = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
 
+    const ezUInt32 uiNumWideRegisters = VMWideOperation<Op, false>(instructionSet, r, reinterpret_cast<const float*>(x), nullptr, nullptr, uiNumRegisters);
+    r += uiNumWideRegisters;
+    x += uiNumWideRegisters;
+
     while (r != re)
     {
       *r = func(*x);
@@ -35,14 +222,18 @@ namespace
     }
   }
 
-  template <typename Func>
-  VM_INLINE void VMOperation1_C(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  template <OpCode::Enum Op, typename Func>
+  VM_INLINE void VMOperation1_C(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    InstructionSet::Enum instructionSet, Func func)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
 
+    const float* pConstant = reinterpret_cast<const float*>(pByteCode);
     ezSimdVec4f x = ezExpressionByteCode::GetConstant(pByteCode);
 
+    r += VMWideOperation<Op, true>(instructionSet, r, pConstant, nullptr, nullptr, uiNumRegisters);
+
     while (r != re)
     {
       *r = func(x);
@@ -54,8 +245,9 @@ namespace
     }
   }
 
-  template <typename Func>
-  VM_INLINE void VMOperation2(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  template <OpCode::Enum Op, typename Func>
+  VM_INLINE void VMOperation2(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    InstructionSet::Enum instructionSet, Func func)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
@@ -63,6 +255,11 @@ namespace
     ezSimdVec4f* a = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* b = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
 
+    const ezUInt32 uiNumWideRegisters = VMWideOperation<Op, false>(instructionSet, r, reinterpret_cast<const float*>(a), b, nullptr, uiNumRegisters);
+    r += uiNumWideRegisters;
+    a += uiNumWideRegisters;
+    b += uiNumWideRegisters;
+
     while (r != re)
     {
       *r = func(*a, *b);
@@ -76,15 +273,21 @@ namespace
     }
   }
 
-  template <typename Func>
-  VM_INLINE void VMOperation2_C(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters, Func func)
+  template <OpCode::Enum Op, typename Func>
+  VM_INLINE void VMOperation2_C(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    InstructionSet::Enum instructionSet, Func func)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
 
+    const float* pConstant = reinterpret_cast<const float*>(pByteCode);
     ezSimdVec4f a = ezExpressionByteCode::GetConstant(pByteCode);
     ezSimdVec4f* b = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
 
+    const ezUInt32 uiNumWideRegisters = VMWideOperation<Op, true>(instructionSet, r, pConstant, b, nullptr, uiNumRegisters);
+    r += uiNumWideRegisters;
+    b += uiNumWideRegisters;
+
     while (r != re)
     {
       *r = func(a, *b);
@@ -97,10 +300,71 @@ namespace
     }
   }
 
+  template <OpCode::Enum Op, typename Func>
+  VM_INLINE void VMOperation3(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    InstructionSet::Enum instructionSet, Func func)
+  {
+    ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* re = r + uiNumRegisters;
+
+    ezSimdVec4f* a = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* b = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* c = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+
+    const ezUInt32 uiNumWideRegisters = VMWideOperation<Op, false>(instructionSet, r, reinterpret_cast<const float*>(a), b, c, uiNumRegisters);
+    r += uiNumWideRegisters;
+    a += uiNumWideRegisters;
+    b += uiNumWideRegisters;
+    c += uiNumWideRegisters;
+
+    while (r != re)
+    {
+      *r = func(*a, *b, *c);
+#ifdef DEBUG_VM
+      EZ_ASSERT_DEV(r->IsValid<4>(), "");
+#endif
+
+      ++r;
+      ++a;
+      ++b;
+      ++c;
+    }
+  }
+
+  template <OpCode::Enum Op, typename Func>
+  VM_INLINE void VMOperation3_C(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    InstructionSet::Enum instructionSet, Func func)
+  {
+    ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* re = r + uiNumRegisters;
+
+    const float* pConstant = reinterpret_cast<const float*>(pByteCode);
+    ezSimdVec4f a = ezExpressionByteCode::GetConstant(pByteCode);
+    ezSimdVec4f* b = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* c = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+
+    const ezUInt32 uiNumWideRegisters = VMWideOperation<Op, true>(instructionSet, r, pConstant, b, c, uiNumRegisters);
+    r += uiNumWideRegisters;
+    b += uiNumWideRegisters;
+    c += uiNumWideRegisters;
+
+    while (r != re)
+    {
+      *r = func(a, *b, *c);
+#ifdef DEBUG_VM
+      EZ_ASSERT_DEV(r->IsValid<4>(), "");
+#endif
+
+      ++r;
+      ++b;
+      ++c;
+    }
+  }
+
   VM_INLINE float ReadInputData(const ezUInt8* pData) { return *reinterpret_cast<const float*>(pData); }
 
   void VMLoadInput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    ezArrayPtr<const ezProcessingStream> inputs, ezArrayPtr<ezUInt32> inputMapping)
+    ezArrayPtr<const ezProcessingStream> inputs, ezArrayPtr<const ezUInt32> inputMapping, ezUInt32 uiFirstInstance)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
@@ -111,6 +375,7 @@ namespace
     ezUInt32 uiByteStride = input.GetElementStride();
     const ezUInt8* pInputData = input.GetData<ezUInt8>();
     const ezUInt8* pInputDataEnd = pInputData + input.GetDataSize() - uiByteStride;
+    pInputData += static_cast<size_t>(uiFirstInstance) * uiByteStride;
 
     while (r != re)
     {
@@ -135,7 +400,7 @@ namespace
   VM_INLINE void StoreOutputData(ezUInt8* pData, float fData) { *reinterpret_cast<float*>(pData) = fData; }
 
   void VMStoreOutput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    ezArrayPtr<ezProcessingStream> outputs, ezArrayPtr<ezUInt32> outputMapping)
+    ezArrayPtr<ezProcessingStream> outputs, ezArrayPtr<const ezUInt32> outputMapping, ezUInt32 uiFirstInstance)
   {
     ezUInt32 uiOutputIndex = ezExpressionByteCode::GetRegisterIndex(pByteCode, 1);
     uiOutputIndex = outputMapping[uiOutputIndex];
@@ -143,6 +408,7 @@ namespace
     ezUInt32 uiByteStride = output.GetElementStride();
     ezUInt8* pOutputData = output.GetWritableData<ezUInt8>();
     ezUInt8* pOutputDataEnd = pOutputData + output.GetDataSize() - uiByteStride;
+    pOutputData += static_cast<size_t>(uiFirstInstance) * uiByteStride;
 
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
@@ -166,7 +432,7 @@ namespace
   }
 
   void VMCall(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    const ezExpression::GlobalData& globalData, ezExpressionFunction& func)
+    const ezExpression::GlobalData& globalData, const ezExpressionFunction& func)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezUInt32 uiNumArgs = ezExpressionByteCode::GetFunctionArgCount(pByteCode);
@@ -305,13 +571,72 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
   }
 
   const ezUInt32 uiNumRegisters = (uiNumInstances + 3) / 4;
-  const ezUInt32 uiLastInstanceIndex = uiNumInstances - 1;
+  if (uiNumRegisters == 0)
+    return EZ_SUCCESS;
+
+  const ezUInt32 uiNumTempRegisters = ezMath::Max(byteCode.GetNumTempRegisters(), 1u);
+
+  // Run the whole bytecode over one block of instances after the other, instead of running every instruction over all instances.
+  // This keeps the registers in the cache. Blocks always start at a multiple of 4 instances, so every lane sees exactly the same data
+  // as it would if all instances were processed at once.
+  ezUInt32 uiNumRegistersPerBlock = uiNumRegisters;
+  if (m_ExecutionMode != ExecutionMode::SingleBlock)
+  {
+    uiNumRegistersPerBlock = s_uiTargetRegisterBytesPerBlock / (uiNumTempRegisters * sizeof(ezSimdVec4f));
+    uiNumRegistersPerBlock = ezMath::Clamp(uiNumRegistersPerBlock, s_uiMinNumRegistersPerBlock, s_uiMaxNumRegistersPerBlock);
+    uiNumRegistersPerBlock = ezMath::Min(uiNumRegistersPerBlock, uiNumRegisters);
+  }
+
+  const ezUInt32 uiNumBlocks = (uiNumRegisters + uiNumRegistersPerBlock - 1) / uiNumRegistersPerBlock;
 
-  const ezUInt32 uiTotalNumRegisters = byteCode.GetNumTempRegisters() * uiNumRegisters;
-  m_Registers.SetCountUninitialized(uiTotalNumRegisters);
+  const InstructionSet::Enum instructionSet = GetSupportedInstructionSet(m_MaxInstructionSet);
 
-  ezSimdVec4f* pRegisters = m_Registers.GetData();
+  ezParallelForParams parallelForParams;
+  parallelForParams.uiBinSize = ezMath::Max(s_uiMinNumInstancesPerTask / (uiNumRegistersPerBlock * 4), 1u);
+
+  if (m_ExecutionMode != ExecutionMode::TiledParallel || uiNumBlocks < parallelForParams.uiBinSize)
+  {
+    m_Registers.SetCountUninitialized(uiNumTempRegisters * uiNumRegistersPerBlock);
+
+    for (ezUInt32 uiBlockIndex = 0; uiBlockIndex < uiNumBlocks; ++uiBlockIndex)
+    {
+      const ezUInt32 uiFirstRegister = uiBlockIndex * uiNumRegistersPerBlock;
+      const ezUInt32 uiNumBlockRegisters = ezMath::Min(uiNumRegistersPerBlock, uiNumRegisters - uiFirstRegister);
+
+      EZ_SUCCEED_OR_RETURN(ExecuteBlock(byteCode, inputs, outputs, uiFirstRegister * 4, uiNumBlockRegisters, m_Registers.GetData(), instructionSet, globalData));
+    }
+
+    return EZ_SUCCESS;
+  }
 
+  ezAtomicInteger32 iNumFailed;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumBlocks,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> registers;
+      registers.SetCountUninitialized(uiNumTempRegisters * uiNumRegistersPerBlock);
+
+      for (ezUInt32 uiBlockIndex = uiStartIndex; uiBlockIndex < uiEndIndex; ++uiBlockIndex)
+      {
+        const ezUInt32 uiFirstRegister = uiBlockIndex * uiNumRegistersPerBlock;
+        const ezUInt32 uiNumBlockRegisters = ezMath::Min(uiNumRegistersPerBlock, uiNumRegisters - uiFirstRegister);
+
+        if (ExecuteBlock(byteCode, inputs, outputs, uiFirstRegister * 4, uiNumBlockRegisters, registers.GetData(), instructionSet, globalData).Failed())
+        {
+          iNumFailed.Increment();
+          return;
+        }
+      }
+    },
+    "ExpressionVM", parallelForParams);
+
+  return iNumFailed == 0 ? EZ_SUCCESS : EZ_FAILURE;
+}
+
+ezResult ezExpressionVM::ExecuteBlock(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezProcessingStream> inputs, ezArrayPtr<ezProcessingStream> outputs,
+  ezUInt32 uiFirstInstance, ezUInt32 uiNumRegisters, ezSimdVec4f* pRegisters, InstructionSet::Enum instructionSet, const ezExpression::GlobalData& globalData) const
+{
   // Execute bytecode
   const ezExpressionByteCode::StorageType* pByteCode = byteCode.GetByteCode();
   const ezExpressionByteCode::StorageType* pByteCodeEnd = byteCode.GetByteCodeEnd();
@@ -334,100 +659,111 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
     {
         // unary
       case ezExpressionByteCode::OpCode::Abs_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return x.Abs(); });
+        VMOperation1<OpCode::Abs_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return x.Abs(); });
         break;
 
       case ezExpressionByteCode::OpCode::Sqrt_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return x.GetSqrt(); });
+        VMOperation1<OpCode::Sqrt_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return x.GetSqrt(); });
         break;
 
       case ezExpressionByteCode::OpCode::Sin_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return ezSimdMath::Sin(x); });
+        VMOperation1<OpCode::Sin_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return ezSimdMath::Sin(x); });
         break;
 
       case ezExpressionByteCode::OpCode::Cos_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return ezSimdMath::Cos(x); });
+        VMOperation1<OpCode::Cos_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return ezSimdMath::Cos(x); });
         break;
 
       case ezExpressionByteCode::OpCode::Tan_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return ezSimdMath::Tan(x); });
+        VMOperation1<OpCode::Tan_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return ezSimdMath::Tan(x); });
         break;
 
       case ezExpressionByteCode::OpCode::ASin_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return ezSimdMath::ASin(x); });
+        VMOperation1<OpCode::ASin_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return ezSimdMath::ASin(x); });
         break;
 
       case ezExpressionByteCode::OpCode::ACos_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return ezSimdMath::ACos(x); });
+        VMOperation1<OpCode::ACos_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return ezSimdMath::ACos(x); });
         break;
 
       case ezExpressionByteCode::OpCode::ATan_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return ezSimdMath::ATan(x); });
+        VMOperation1<OpCode::ATan_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return ezSimdMath::ATan(x); });
         break;
 
       case ezExpressionByteCode::OpCode::Mov_R:
-        VMOperation1(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return x; });
+        VMOperation1<OpCode::Mov_R>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return x; });
         break;
 
       case ezExpressionByteCode::OpCode::Mov_C:
-        VMOperation1_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& x) { return x; });
+        VMOperation1_C<OpCode::Mov_C>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& x) { return x; });
         break;
 
       case ezExpressionByteCode::OpCode::Load:
-        VMLoadInput(pByteCode, pRegisters, uiNumRegisters, inputs, m_InputMapping);
+        VMLoadInput(pByteCode, pRegisters, uiNumRegisters, inputs, m_InputMapping, uiFirstInstance);
         break;
 
       case ezExpressionByteCode::OpCode::Store:
-        VMStoreOutput(pByteCode, pRegisters, uiNumRegisters, outputs, m_OutputMapping);
+        VMStoreOutput(pByteCode, pRegisters, uiNumRegisters, outputs, m_OutputMapping, uiFirstInstance);
         break;
 
         // binary
       case ezExpressionByteCode::OpCode::Add_RR:
-        VMOperation2(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a + b; });
+        VMOperation2<OpCode::Add_RR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a + b; });
         break;
 
       case ezExpressionByteCode::OpCode::Add_CR:
-        VMOperation2_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a + b; });
+        VMOperation2_C<OpCode::Add_CR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a + b; });
         break;
 
       case ezExpressionByteCode::OpCode::Sub_RR:
-        VMOperation2(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a - b; });
+        VMOperation2<OpCode::Sub_RR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a - b; });
         break;
 
       case ezExpressionByteCode::OpCode::Sub_CR:
-        VMOperation2_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a - b; });
+        VMOperation2_C<OpCode::Sub_CR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a - b; });
         break;
 
       case ezExpressionByteCode::OpCode::Mul_RR:
-        VMOperation2(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMul(b); });
+        VMOperation2<OpCode::Mul_RR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMul(b); });
         break;
 
       case ezExpressionByteCode::OpCode::Mul_CR:
-        VMOperation2_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMul(b); });
+        VMOperation2_C<OpCode::Mul_CR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMul(b); });
         break;
 
       case ezExpressionByteCode::OpCode::Div_RR:
-        VMOperation2(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompDiv(b); });
+        VMOperation2<OpCode::Div_RR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompDiv(b); });
         break;
 
       case ezExpressionByteCode::OpCode::Div_CR:
-        VMOperation2_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompDiv(b); });
+        VMOperation2_C<OpCode::Div_CR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompDiv(b); });
         break;
 
       case ezExpressionByteCode::OpCode::Min_RR:
-        VMOperation2(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMin(b); });
+        VMOperation2<OpCode::Min_RR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMin(b); });
         break;
 
       case ezExpressionByteCode::OpCode::Min_CR:
-        VMOperation2_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMin(b); });
+        VMOperation2_C<OpCode::Min_CR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMin(b); });
         break;
 
       case ezExpressionByteCode::OpCode::Max_RR:
-        VMOperation2(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMax(b); });
+        VMOperation2<OpCode::Max_RR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMax(b); });
         break;
 
       case ezExpressionByteCode::OpCode::Max_CR:
-        VMOperation2_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMax(b); });
+        VMOperation2_C<OpCode::Max_CR>(pByteCode, pRegisters, uiNumRegisters, instructionSet, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMax(b); });
+        break;
+
+        // ternary
+      case ezExpressionByteCode::OpCode::MulAdd_RRR:
+        VMOperation3<OpCode::MulAdd_RRR>(pByteCode, pRegisters, uiNumRegisters, instructionSet,
+          [](const ezSimdVec4f& a, const ezSimdVec4f& b, const ezSimdVec4f& c) { return ezSimdVec4f::MulAdd(a, b, c); });
+        break;
+
+      case ezExpressionByteCode::OpCode::MulAdd_CRR:
+        VMOperation3_C<OpCode::MulAdd_CRR>(pByteCode, pRegisters, uiNumRegisters, instructionSet,
+          [](const ezSimdVec4f& a, const ezSimdVec4f& b, const ezSimdVec4f& c) { return ezSimdVec4f::MulAdd(a, b, c); });
         break;
 
         // call
@@ -435,7 +771,7 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
       {
         ezUInt32 uiFunctionIndex = ezExpressionByteCode::GetFunctionIndex(pByteCode);
         uiFunctionIndex = m_FunctionMapping[uiFunctionIndex];
-        auto& func = m_Functions[uiFunctionIndex].m_Func;
+        const auto& func = m_Functions[uiFunctionIndex].m_Func;
 
         VMCall(pByteCode, pRegisters, uiNumRegisters, globalData, func);
       }
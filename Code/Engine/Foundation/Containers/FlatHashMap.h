@@ -0,0 +1,268 @@
+#pragma once
+
+#include <Foundation/Containers/Implementation/FlatHashTableBase.h>
+
+/// \brief Implementation of an open-addressing hashtable which stores key/value pairs.
+///
+/// In contrast to ezHashTable, every slot has a one byte control value which stores 7 bits of the hash of the key.
+/// Lookups compare the control bytes of 16 slots at once (using SSE2 or NEON, where available) and only compare keys
+/// for slots whose control byte matches, which makes both hits and misses very cheap, even at high load.
+/// The table grows when the load gets greater than 87.5%.
+/// The hash function can be customized by providing a Hasher helper class like ezHashHelper.
+///
+/// Inserting or removing elements invalidates all iterators. Inserting elements may additionally move the existing ones in memory.
+
+/// \see ezHashHelper
+template <typename KeyType, typename ValueType, typename Hasher>
+class ezFlatHashMapBase
+{
+private:
+  struct Entry
+  {
+    EZ_DETECT_TYPE_CLASS(KeyType, ValueType);
+
+    KeyType key;
+    ValueType value;
+  };
+
+  using Table = ezInternal::FlatHashTable<Entry, Hasher>;
+
+public:
+  /// \brief Const iterator.
+  struct ConstIterator
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    /// \brief Checks whether this iterator points to a valid element.
+    bool IsValid() const;
+
+    /// \brief Checks whether the two iterators point to the same element.
+    bool operator==(const typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator& rhs) const;
+
+    /// \brief Checks whether the two iterators point to the same element.
+    bool operator!=(const typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator& rhs) const;
+
+    /// \brief Returns the 'key' of the element that this iterator points to.
+    const KeyType& Key() const;
+
+    /// \brief Returns the 'value' of the element that this iterator points to.
+    const ValueType& Value() const;
+
+    /// \brief Advances the iterator to the next element in the map. The iterator will not be valid anymore, if the end is reached.
+    void Next();
+
+    /// \brief Shorthand for 'Next'
+    void operator++();
+
+    /// \brief Returns '*this' to enable foreach
+    EZ_ALWAYS_INLINE ConstIterator& operator*() { return *this; }
+
+  protected:
+    friend class ezFlatHashMapBase<KeyType, ValueType, Hasher>;
+
+    ConstIterator(const Table& table, ezUInt32 uiSlot);
+
+    const Table* m_pTable = nullptr;
+    ezUInt32 m_uiSlot = 0;
+  };
+
+  /// \brief Iterator with write access.
+  struct Iterator : public ConstIterator
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    // this is required to pull in the const version of this function
+    using ConstIterator::Value;
+
+    /// \brief Returns the 'value' of the element that this iterator points to.
+    ValueType& Value();
+
+    /// \brief Returns '*this' to enable foreach
+    EZ_ALWAYS_INLINE Iterator& operator*() { return *this; }
+
+  private:
+    friend class ezFlatHashMapBase<KeyType, ValueType, Hasher>;
+
+    Iterator(const Table& table, ezUInt32 uiSlot);
+  };
+
+protected:
+  /// \brief Creates an empty map. Does not allocate any data yet.
+  explicit ezFlatHashMapBase(ezAllocatorBase* pAllocator);
+
+  /// \brief Creates a copy of the given map.
+  ezFlatHashMapBase(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs, ezAllocatorBase* pAllocator);
+
+  /// \brief Moves data from an existing map into this one.
+  ezFlatHashMapBase(ezFlatHashMapBase<KeyType, ValueType, Hasher>&& rhs, ezAllocatorBase* pAllocator);
+
+  /// \brief Copies the data from another map into this one.
+  void operator=(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs);
+
+  /// \brief Moves data from an existing map into this one.
+  void operator=(ezFlatHashMapBase<KeyType, ValueType, Hasher>&& rhs);
+
+public:
+  /// \brief Compares this map to another map.
+  bool operator==(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs) const;
+
+  /// \brief Compares this map to another map.
+  bool operator!=(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs) const;
+
+  /// \brief Expands the map by over-allocating the internal storage so that the given number of entries can be inserted without
+  /// growing again.
+  void Reserve(ezUInt32 uiCapacity);
+
+  /// \brief Tries to compact the map to avoid wasting memory.
+  ///
+  /// The resulting capacity is at least 'GetCount' (no elements get removed).
+  /// Will deallocate all data, if the map is empty.
+  void Compact();
+
+  /// \brief Returns the number of active entries in the map.
+  ezUInt32 GetCount() const;
+
+  /// \brief Returns true, if the map does not contain any elements.
+  bool IsEmpty() const;
+
+  /// \brief Clears the map.
+  void Clear();
+
+  /// \brief Inserts the key value pair or replaces value if an entry with the given key already exists.
+  ///
+  /// Returns true if an existing value was replaced and optionally writes out the old value to out_oldValue.
+  template <typename CompatibleKeyType, typename CompatibleValueType>
+  bool Insert(CompatibleKeyType&& key, CompatibleValueType&& value, ValueType* out_oldValue = nullptr);
+
+  /// \brief Removes the entry with the given key. Returns whether an entry was removed and optionally writes out the old value to
+  /// out_oldValue.
+  template <typename CompatibleKeyType>
+  bool Remove(const CompatibleKeyType& key, ValueType* out_oldValue = nullptr);
+
+  /// \brief Erases the key/value pair at the given Iterator. Returns an iterator to the element after the given iterator.
+  Iterator Remove(const Iterator& pos);
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the corresponding value to out_value.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, ValueType& out_value) const;
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the pointer to the corresponding value to
+  /// out_pValue.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, const ValueType*& out_pValue) const;
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the pointer to the corresponding value to
+  /// out_pValue.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, ValueType*& out_pValue) const;
+
+  /// \brief Searches for key, returns a ConstIterator to it or an invalid iterator, if no such key is found. O(1) operation.
+  template <typename CompatibleKeyType>
+  ConstIterator Find(const CompatibleKeyType& key) const;
+
+  /// \brief Searches for key, returns an Iterator to it or an invalid iterator, if no such key is found. O(1) operation.
+  template <typename CompatibleKeyType>
+  Iterator Find(const CompatibleKeyType& key);
+
+  /// \brief Returns a pointer to the value of the entry with the given key if found, otherwise returns nullptr.
+  template <typename CompatibleKeyType>
+  const ValueType* GetValue(const CompatibleKeyType& key) const;
+
+  /// \brief Returns a pointer to the value of the entry with the given key if found, otherwise returns nullptr.
+  template <typename CompatibleKeyType>
+  ValueType* GetValue(const CompatibleKeyType& key);
+
+  /// \brief Returns the value to the given key if found or creates a new entry with the given key and a default constructed value.
+  ValueType& operator[](const KeyType& key);
+
+  /// \brief Returns the value stored at the given key. If none exists, one is created. \a bExisted indicates whether an element needed to
+  /// be created.
+  ValueType& FindOrAdd(const KeyType& key, bool* bExisted);
+
+  /// \brief Returns if an entry with given key exists in the map.
+  template <typename CompatibleKeyType>
+  bool Contains(const CompatibleKeyType& key) const;
+
+  /// \brief Returns an Iterator to the very first element.
+  Iterator GetIterator();
+
+  /// \brief Returns an Iterator to the first element that is not part of the map. Needed to support range based for loops.
+  Iterator GetEndIterator();
+
+  /// \brief Returns a constant Iterator to the very first element.
+  ConstIterator GetIterator() const;
+
+  /// \brief Returns a constant Iterator to the first element that is not part of the map. Needed to support range based for loops.
+  ConstIterator GetEndIterator() const;
+
+  /// \brief Returns the allocator that is used by this instance.
+  ezAllocatorBase* GetAllocator() const;
+
+  /// \brief Returns the amount of bytes that are currently allocated on the heap.
+  ezUInt64 GetHeapMemoryUsage() const;
+
+  /// \brief Swaps this map with the other one.
+  void Swap(ezFlatHashMapBase<KeyType, ValueType, Hasher>& other);
+
+private:
+  Table m_Table;
+};
+
+/// \brief \see ezFlatHashMapBase
+template <typename KeyType, typename ValueType, typename Hasher = ezHashHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper>
+class ezFlatHashMap : public ezFlatHashMapBase<KeyType, ValueType, Hasher>
+{
+public:
+  ezFlatHashMap();
+  explicit ezFlatHashMap(ezAllocatorBase* pAllocator);
+
+  ezFlatHashMap(const ezFlatHashMap<KeyType, ValueType, Hasher, AllocatorWrapper>& other);
+  ezFlatHashMap(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& other);
+
+  ezFlatHashMap(ezFlatHashMap<KeyType, ValueType, Hasher, AllocatorWrapper>&& other);
+  ezFlatHashMap(ezFlatHashMapBase<KeyType, ValueType, Hasher>&& other);
+
+  void operator=(const ezFlatHashMap<KeyType, ValueType, Hasher, AllocatorWrapper>& rhs);
+  void operator=(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& rhs);
+
+  void operator=(ezFlatHashMap<KeyType, ValueType, Hasher, AllocatorWrapper>&& rhs);
+  void operator=(ezFlatHashMapBase<KeyType, ValueType, Hasher>&& rhs);
+};
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::Iterator begin(ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator begin(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator cbegin(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::Iterator end(ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetEndIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator end(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetEndIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezFlatHashMapBase<KeyType, ValueType, Hasher>::ConstIterator cend(const ezFlatHashMapBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetEndIterator();
+}
+
+#include <Foundation/Containers/Implementation/FlatHashMap_inl.h>
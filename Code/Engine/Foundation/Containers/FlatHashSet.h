@@ -0,0 +1,188 @@
+#pragma once
+
+#include <Foundation/Containers/Implementation/FlatHashTableBase.h>
+
+/// \brief Implementation of an open-addressing hashset.
+///
+/// Uses the same storage as ezFlatHashMap: every slot has a one byte control value which stores 7 bits of the hash of the key and
+/// lookups compare the control bytes of 16 slots at once (using SSE2 or NEON, where available).
+/// The set grows when the load gets greater than 87.5%.
+/// The hash function can be customized by providing a Hasher helper class like ezHashHelper.
+///
+/// Inserting or removing elements invalidates all iterators. Inserting elements may additionally move the existing ones in memory.
+
+/// \see ezHashHelper
+template <typename KeyType, typename Hasher>
+class ezFlatHashSetBase
+{
+private:
+  struct Entry
+  {
+    EZ_DETECT_TYPE_CLASS(KeyType);
+
+    KeyType key;
+  };
+
+  using Table = ezInternal::FlatHashTable<Entry, Hasher>;
+
+public:
+  /// \brief Const iterator.
+  class ConstIterator
+  {
+  public:
+    /// \brief Checks whether this iterator points to a valid element.
+    bool IsValid() const;
+
+    /// \brief Checks whether the two iterators point to the same element.
+    bool operator==(const typename ezFlatHashSetBase<KeyType, Hasher>::ConstIterator& rhs) const;
+
+    /// \brief Checks whether the two iterators point to the same element.
+    bool operator!=(const typename ezFlatHashSetBase<KeyType, Hasher>::ConstIterator& rhs) const;
+
+    /// \brief Returns the 'key' of the element that this iterator points to.
+    const KeyType& Key() const;
+
+    /// \brief Returns the 'key' of the element that this iterator points to.
+    EZ_ALWAYS_INLINE const KeyType& operator*() { return Key(); }
+
+    /// \brief Advances the iterator to the next element in the set. The iterator will not be valid anymore, if the end is reached.
+    void Next();
+
+    /// \brief Shorthand for 'Next'
+    void operator++();
+
+  protected:
+    friend class ezFlatHashSetBase<KeyType, Hasher>;
+
+    ConstIterator(const Table& table, ezUInt32 uiSlot);
+
+    const Table* m_pTable = nullptr;
+    ezUInt32 m_uiSlot = 0;
+  };
+
+protected:
+  /// \brief Creates an empty set. Does not allocate any data yet.
+  explicit ezFlatHashSetBase(ezAllocatorBase* pAllocator);
+
+  /// \brief Creates a copy of the given set.
+  ezFlatHashSetBase(const ezFlatHashSetBase<KeyType, Hasher>& rhs, ezAllocatorBase* pAllocator);
+
+  /// \brief Moves data from an existing set into this one.
+  ezFlatHashSetBase(ezFlatHashSetBase<KeyType, Hasher>&& rhs, ezAllocatorBase* pAllocator);
+
+  /// \brief Copies the data from another set into this one.
+  void operator=(const ezFlatHashSetBase<KeyType, Hasher>& rhs);
+
+  /// \brief Moves data from an existing set into this one.
+  void operator=(ezFlatHashSetBase<KeyType, Hasher>&& rhs);
+
+public:
+  /// \brief Compares this set to another set.
+  bool operator==(const ezFlatHashSetBase<KeyType, Hasher>& rhs) const;
+
+  /// \brief Compares this set to another set.
+  bool operator!=(const ezFlatHashSetBase<KeyType, Hasher>& rhs) const;
+
+  /// \brief Expands the set by over-allocating the internal storage so that the given number of entries can be inserted without
+  /// growing again.
+  void Reserve(ezUInt32 uiCapacity);
+
+  /// \brief Tries to compact the set to avoid wasting memory.
+  ///
+  /// The resulting capacity is at least 'GetCount' (no elements get removed).
+  /// Will deallocate all data, if the set is empty.
+  void Compact();
+
+  /// \brief Returns the number of active entries in the set.
+  ezUInt32 GetCount() const;
+
+  /// \brief Returns true, if the set does not contain any elements.
+  bool IsEmpty() const;
+
+  /// \brief Clears the set.
+  void Clear();
+
+  /// \brief Inserts the key. Returns whether the key was already existing.
+  template <typename CompatibleKeyType>
+  bool Insert(CompatibleKeyType&& key);
+
+  /// \brief Removes the entry with the given key. Returns if an entry was removed.
+  template <typename CompatibleKeyType>
+  bool Remove(const CompatibleKeyType& key);
+
+  /// \brief Erases the key at the given Iterator. Returns an iterator to the element after the given iterator.
+  ConstIterator Remove(const ConstIterator& pos);
+
+  /// \brief Returns if an entry with given key exists in the set.
+  template <typename CompatibleKeyType>
+  bool Contains(const CompatibleKeyType& key) const;
+
+  /// \brief Searches for key, returns a ConstIterator to it or an invalid iterator, if no such key is found. O(1) operation.
+  template <typename CompatibleKeyType>
+  ConstIterator Find(const CompatibleKeyType& key) const;
+
+  /// \brief Returns a constant Iterator to the very first element.
+  ConstIterator GetIterator() const;
+
+  /// \brief Returns a constant Iterator to the first element that is not part of the set. Needed to support range based for loops.
+  ConstIterator GetEndIterator() const;
+
+  /// \brief Returns the allocator that is used by this instance.
+  ezAllocatorBase* GetAllocator() const;
+
+  /// \brief Returns the amount of bytes that are currently allocated on the heap.
+  ezUInt64 GetHeapMemoryUsage() const;
+
+  /// \brief Swaps this set with the other one.
+  void Swap(ezFlatHashSetBase<KeyType, Hasher>& other);
+
+private:
+  Table m_Table;
+};
+
+/// \brief \see ezFlatHashSetBase
+template <typename KeyType, typename Hasher = ezHashHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper>
+class ezFlatHashSet : public ezFlatHashSetBase<KeyType, Hasher>
+{
+public:
+  ezFlatHashSet();
+  explicit ezFlatHashSet(ezAllocatorBase* pAllocator);
+
+  ezFlatHashSet(const ezFlatHashSet<KeyType, Hasher, AllocatorWrapper>& other);
+  ezFlatHashSet(const ezFlatHashSetBase<KeyType, Hasher>& other);
+
+  ezFlatHashSet(ezFlatHashSet<KeyType, Hasher, AllocatorWrapper>&& other);
+  ezFlatHashSet(ezFlatHashSetBase<KeyType, Hasher>&& other);
+
+  void operator=(const ezFlatHashSet<KeyType, Hasher, AllocatorWrapper>& rhs);
+  void operator=(const ezFlatHashSetBase<KeyType, Hasher>& rhs);
+
+  void operator=(ezFlatHashSet<KeyType, Hasher, AllocatorWrapper>&& rhs);
+  void operator=(ezFlatHashSetBase<KeyType, Hasher>&& rhs);
+};
+
+template <typename KeyType, typename Hasher>
+typename ezFlatHashSetBase<KeyType, Hasher>::ConstIterator begin(const ezFlatHashSetBase<KeyType, Hasher>& set)
+{
+  return set.GetIterator();
+}
+
+template <typename KeyType, typename Hasher>
+typename ezFlatHashSetBase<KeyType, Hasher>::ConstIterator cbegin(const ezFlatHashSetBase<KeyType, Hasher>& set)
+{
+  return set.GetIterator();
+}
+
+template <typename KeyType, typename Hasher>
+typename ezFlatHashSetBase<KeyType, Hasher>::ConstIterator end(const ezFlatHashSetBase<KeyType, Hasher>& set)
+{
+  return set.GetEndIterator();
+}
+
+template <typename KeyType, typename Hasher>
+typename ezFlatHashSetBase<KeyType, Hasher>::ConstIterator cend(const ezFlatHashSetBase<KeyType, Hasher>& set)
+{
+  return set.GetEndIterator();
+}
+
+#include <Foundation/Containers/Implementation/FlatHashSet_inl.h>
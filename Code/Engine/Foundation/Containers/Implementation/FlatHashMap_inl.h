@@ -0,0 +1,426 @@
+
+// ***** Const Iterator *****
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezFlatHashMapBase<K, V, H>::ConstIterator::ConstIterator(const Table& table, ezUInt32 uiSlot)
+  : m_pTable(&table)
+  , m_uiSlot(uiSlot)
+{
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashMapBase<K, V, H>::ConstIterator::IsValid() const
+{
+  return m_uiSlot < m_pTable->m_uiCapacity;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashMapBase<K, V, H>::ConstIterator::operator==(const typename ezFlatHashMapBase<K, V, H>::ConstIterator& rhs) const
+{
+  return m_uiSlot == rhs.m_uiSlot && m_pTable->m_pSlots == rhs.m_pTable->m_pSlots;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashMapBase<K, V, H>::ConstIterator::operator!=(const typename ezFlatHashMapBase<K, V, H>::ConstIterator& rhs) const
+{
+  return !(*this == rhs);
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE const K& ezFlatHashMapBase<K, V, H>::ConstIterator::Key() const
+{
+  return m_pTable->m_pSlots[m_uiSlot].key;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE const V& ezFlatHashMapBase<K, V, H>::ConstIterator::Value() const
+{
+  return m_pTable->m_pSlots[m_uiSlot].value;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashMapBase<K, V, H>::ConstIterator::Next()
+{
+  if (m_uiSlot < m_pTable->m_uiCapacity)
+  {
+    m_uiSlot = m_pTable->GetNextFullSlot(m_uiSlot + 1);
+  }
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashMapBase<K, V, H>::ConstIterator::operator++()
+{
+  Next();
+}
+
+
+// ***** Iterator *****
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezFlatHashMapBase<K, V, H>::Iterator::Iterator(const Table& table, ezUInt32 uiSlot)
+  : ConstIterator(table, uiSlot)
+{
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE V& ezFlatHashMapBase<K, V, H>::Iterator::Value()
+{
+  return this->m_pTable->m_pSlots[this->m_uiSlot].value;
+}
+
+
+// ***** ezFlatHashMapBase *****
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBase<K, V, H>::ezFlatHashMapBase(ezAllocatorBase* pAllocator)
+  : m_Table(pAllocator)
+{
+}
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBase<K, V, H>::ezFlatHashMapBase(const ezFlatHashMapBase<K, V, H>& other, ezAllocatorBase* pAllocator)
+  : m_Table(pAllocator)
+{
+  m_Table.CopyFrom(other.m_Table);
+}
+
+template <typename K, typename V, typename H>
+ezFlatHashMapBase<K, V, H>::ezFlatHashMapBase(ezFlatHashMapBase<K, V, H>&& other, ezAllocatorBase* pAllocator)
+  : m_Table(pAllocator)
+{
+  m_Table.MoveFrom(std::move(other.m_Table));
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::operator=(const ezFlatHashMapBase<K, V, H>& rhs)
+{
+  if (this != &rhs)
+  {
+    m_Table.CopyFrom(rhs.m_Table);
+  }
+}
+
+template <typename K, typename V, typename H>
+void ezFlatHashMapBase<K, V, H>::operator=(ezFlatHashMapBase<K, V, H>&& rhs)
+{
+  if (this != &rhs)
+  {
+    m_Table.MoveFrom(std::move(rhs.m_Table));
+  }
+}
+
+template <typename K, typename V, typename H>
+bool ezFlatHashMapBase<K, V, H>::operator==(const ezFlatHashMapBase<K, V, H>& rhs) const
+{
+  if (GetCount() != rhs.GetCount())
+    return false;
+
+  for (auto it = GetIterator(); it.IsValid(); ++it)
+  {
+    const V* pRhsValue = nullptr;
+    if (!rhs.TryGetValue(it.Key(), pRhsValue))
+      return false;
+
+    if (it.Value() != *pRhsValue)
+      return false;
+  }
+
+  return true;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashMapBase<K, V, H>::operator!=(const ezFlatHashMapBase<K, V, H>& rhs) const
+{
+  return !(*this == rhs);
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashMapBase<K, V, H>::Reserve(ezUInt32 uiCapacity)
+{
+  m_Table.Reserve(uiCapacity);
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashMapBase<K, V, H>::Compact()
+{
+  m_Table.Compact();
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezUInt32 ezFlatHashMapBase<K, V, H>::GetCount() const
+{
+  return m_Table.m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashMapBase<K, V, H>::IsEmpty() const
+{
+  return m_Table.m_uiCount == 0;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashMapBase<K, V, H>::Clear()
+{
+  m_Table.Clear();
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType, typename CompatibleValueType>
+bool ezFlatHashMapBase<K, V, H>::Insert(CompatibleKeyType&& key, CompatibleValueType&& value, V* out_oldValue /*= nullptr*/)
+{
+  bool bExisted = false;
+  const ezUInt32 uiSlot = m_Table.FindOrPrepareInsert(key, bExisted);
+  Entry& entry = m_Table.m_pSlots[uiSlot];
+
+  if (bExisted)
+  {
+    if (out_oldValue != nullptr)
+      *out_oldValue = std::move(entry.value);
+
+    entry.value = std::forward<CompatibleValueType>(value); // Either move or copy assignment.
+    return true;
+  }
+
+  // Both constructions might either be a move or a copy.
+  ezMemoryUtils::CopyOrMoveConstruct(&entry.key, std::forward<CompatibleKeyType>(key));
+  ezMemoryUtils::CopyOrMoveConstruct(&entry.value, std::forward<CompatibleValueType>(value));
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+bool ezFlatHashMapBase<K, V, H>::Remove(const CompatibleKeyType& key, V* out_oldValue /*= nullptr*/)
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  if (uiSlot == ezInvalidIndex)
+    return false;
+
+  if (out_oldValue != nullptr)
+    *out_oldValue = std::move(m_Table.m_pSlots[uiSlot].value);
+
+  m_Table.Erase(uiSlot);
+  return true;
+}
+
+template <typename K, typename V, typename H>
+typename ezFlatHashMapBase<K, V, H>::Iterator ezFlatHashMapBase<K, V, H>::Remove(const typename ezFlatHashMapBase<K, V, H>::Iterator& pos)
+{
+  EZ_ASSERT_DEV(pos.m_pTable == &m_Table && pos.IsValid(), "Invalid iterator");
+
+  // erasing never moves other elements, so the next element can be looked up afterwards
+  m_Table.Erase(pos.m_uiSlot);
+  return Iterator(m_Table, m_Table.GetNextFullSlot(pos.m_uiSlot + 1));
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezFlatHashMapBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, V& out_value) const
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  if (uiSlot != ezInvalidIndex)
+  {
+    out_value = m_Table.m_pSlots[uiSlot].value;
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezFlatHashMapBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, const V*& out_pValue) const
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  if (uiSlot != ezInvalidIndex)
+  {
+    out_pValue = &m_Table.m_pSlots[uiSlot].value;
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezFlatHashMapBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, V*& out_pValue) const
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  if (uiSlot != ezInvalidIndex)
+  {
+    out_pValue = &m_Table.m_pSlots[uiSlot].value;
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline typename ezFlatHashMapBase<K, V, H>::ConstIterator ezFlatHashMapBase<K, V, H>::Find(const CompatibleKeyType& key) const
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  return ConstIterator(m_Table, uiSlot != ezInvalidIndex ? uiSlot : m_Table.m_uiCapacity);
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline typename ezFlatHashMapBase<K, V, H>::Iterator ezFlatHashMapBase<K, V, H>::Find(const CompatibleKeyType& key)
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  return Iterator(m_Table, uiSlot != ezInvalidIndex ? uiSlot : m_Table.m_uiCapacity);
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline const V* ezFlatHashMapBase<K, V, H>::GetValue(const CompatibleKeyType& key) const
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  return (uiSlot != ezInvalidIndex) ? &m_Table.m_pSlots[uiSlot].value : nullptr;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline V* ezFlatHashMapBase<K, V, H>::GetValue(const CompatibleKeyType& key)
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  return (uiSlot != ezInvalidIndex) ? &m_Table.m_pSlots[uiSlot].value : nullptr;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE V& ezFlatHashMapBase<K, V, H>::operator[](const K& key)
+{
+  return FindOrAdd(key, nullptr);
+}
+
+template <typename K, typename V, typename H>
+V& ezFlatHashMapBase<K, V, H>::FindOrAdd(const K& key, bool* bExisted)
+{
+  bool bFound = false;
+  const ezUInt32 uiSlot = m_Table.FindOrPrepareInsert(key, bFound);
+  Entry& entry = m_Table.m_pSlots[uiSlot];
+
+  if (!bFound)
+  {
+    ezMemoryUtils::CopyConstruct(&entry.key, key, 1);
+    ezMemoryUtils::DefaultConstruct(&entry.value, 1);
+  }
+
+  if (bExisted)
+  {
+    *bExisted = bFound;
+  }
+
+  return entry.value;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE bool ezFlatHashMapBase<K, V, H>::Contains(const CompatibleKeyType& key) const
+{
+  return m_Table.Find(key) != ezInvalidIndex;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashMapBase<K, V, H>::Iterator ezFlatHashMapBase<K, V, H>::GetIterator()
+{
+  return Iterator(m_Table, m_Table.GetNextFullSlot(0));
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashMapBase<K, V, H>::Iterator ezFlatHashMapBase<K, V, H>::GetEndIterator()
+{
+  return Iterator(m_Table, m_Table.m_uiCapacity);
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashMapBase<K, V, H>::ConstIterator ezFlatHashMapBase<K, V, H>::GetIterator() const
+{
+  return ConstIterator(m_Table, m_Table.GetNextFullSlot(0));
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashMapBase<K, V, H>::ConstIterator ezFlatHashMapBase<K, V, H>::GetEndIterator() const
+{
+  return ConstIterator(m_Table, m_Table.m_uiCapacity);
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezAllocatorBase* ezFlatHashMapBase<K, V, H>::GetAllocator() const
+{
+  return m_Table.m_pAllocator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezUInt64 ezFlatHashMapBase<K, V, H>::GetHeapMemoryUsage() const
+{
+  return m_Table.GetHeapMemoryUsage();
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashMapBase<K, V, H>::Swap(ezFlatHashMapBase<K, V, H>& other)
+{
+  m_Table.Swap(other.m_Table);
+}
+
+
+// ***** ezFlatHashMap *****
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap()
+  : ezFlatHashMapBase<K, V, H>(A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(ezAllocatorBase* pAllocator)
+  : ezFlatHashMapBase<K, V, H>(pAllocator)
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(const ezFlatHashMap<K, V, H, A>& other)
+  : ezFlatHashMapBase<K, V, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(const ezFlatHashMapBase<K, V, H>& other)
+  : ezFlatHashMapBase<K, V, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(ezFlatHashMap<K, V, H, A>&& other)
+  : ezFlatHashMapBase<K, V, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezFlatHashMap<K, V, H, A>::ezFlatHashMap(ezFlatHashMapBase<K, V, H>&& other)
+  : ezFlatHashMapBase<K, V, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezFlatHashMap<K, V, H, A>::operator=(const ezFlatHashMap<K, V, H, A>& rhs)
+{
+  ezFlatHashMapBase<K, V, H>::operator=(rhs);
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezFlatHashMap<K, V, H, A>::operator=(const ezFlatHashMapBase<K, V, H>& rhs)
+{
+  ezFlatHashMapBase<K, V, H>::operator=(rhs);
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezFlatHashMap<K, V, H, A>::operator=(ezFlatHashMap<K, V, H, A>&& rhs)
+{
+  ezFlatHashMapBase<K, V, H>::operator=(std::move(rhs));
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezFlatHashMap<K, V, H, A>::operator=(ezFlatHashMapBase<K, V, H>&& rhs)
+{
+  ezFlatHashMapBase<K, V, H>::operator=(std::move(rhs));
+}
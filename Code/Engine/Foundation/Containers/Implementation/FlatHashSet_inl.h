@@ -0,0 +1,286 @@
+
+// ***** Const Iterator *****
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE ezFlatHashSetBase<K, H>::ConstIterator::ConstIterator(const Table& table, ezUInt32 uiSlot)
+  : m_pTable(&table)
+  , m_uiSlot(uiSlot)
+{
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashSetBase<K, H>::ConstIterator::IsValid() const
+{
+  return m_uiSlot < m_pTable->m_uiCapacity;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashSetBase<K, H>::ConstIterator::operator==(const typename ezFlatHashSetBase<K, H>::ConstIterator& rhs) const
+{
+  return m_uiSlot == rhs.m_uiSlot && m_pTable->m_pSlots == rhs.m_pTable->m_pSlots;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashSetBase<K, H>::ConstIterator::operator!=(const typename ezFlatHashSetBase<K, H>::ConstIterator& rhs) const
+{
+  return !(*this == rhs);
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE const K& ezFlatHashSetBase<K, H>::ConstIterator::Key() const
+{
+  return m_pTable->m_pSlots[m_uiSlot].key;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashSetBase<K, H>::ConstIterator::Next()
+{
+  if (m_uiSlot < m_pTable->m_uiCapacity)
+  {
+    m_uiSlot = m_pTable->GetNextFullSlot(m_uiSlot + 1);
+  }
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashSetBase<K, H>::ConstIterator::operator++()
+{
+  Next();
+}
+
+
+// ***** ezFlatHashSetBase *****
+
+template <typename K, typename H>
+ezFlatHashSetBase<K, H>::ezFlatHashSetBase(ezAllocatorBase* pAllocator)
+  : m_Table(pAllocator)
+{
+}
+
+template <typename K, typename H>
+ezFlatHashSetBase<K, H>::ezFlatHashSetBase(const ezFlatHashSetBase<K, H>& other, ezAllocatorBase* pAllocator)
+  : m_Table(pAllocator)
+{
+  m_Table.CopyFrom(other.m_Table);
+}
+
+template <typename K, typename H>
+ezFlatHashSetBase<K, H>::ezFlatHashSetBase(ezFlatHashSetBase<K, H>&& other, ezAllocatorBase* pAllocator)
+  : m_Table(pAllocator)
+{
+  m_Table.MoveFrom(std::move(other.m_Table));
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::operator=(const ezFlatHashSetBase<K, H>& rhs)
+{
+  if (this != &rhs)
+  {
+    m_Table.CopyFrom(rhs.m_Table);
+  }
+}
+
+template <typename K, typename H>
+void ezFlatHashSetBase<K, H>::operator=(ezFlatHashSetBase<K, H>&& rhs)
+{
+  if (this != &rhs)
+  {
+    m_Table.MoveFrom(std::move(rhs.m_Table));
+  }
+}
+
+template <typename K, typename H>
+bool ezFlatHashSetBase<K, H>::operator==(const ezFlatHashSetBase<K, H>& rhs) const
+{
+  if (GetCount() != rhs.GetCount())
+    return false;
+
+  for (auto it = GetIterator(); it.IsValid(); ++it)
+  {
+    if (!rhs.Contains(it.Key()))
+      return false;
+  }
+
+  return true;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashSetBase<K, H>::operator!=(const ezFlatHashSetBase<K, H>& rhs) const
+{
+  return !(*this == rhs);
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashSetBase<K, H>::Reserve(ezUInt32 uiCapacity)
+{
+  m_Table.Reserve(uiCapacity);
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashSetBase<K, H>::Compact()
+{
+  m_Table.Compact();
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE ezUInt32 ezFlatHashSetBase<K, H>::GetCount() const
+{
+  return m_Table.m_uiCount;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE bool ezFlatHashSetBase<K, H>::IsEmpty() const
+{
+  return m_Table.m_uiCount == 0;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashSetBase<K, H>::Clear()
+{
+  m_Table.Clear();
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+bool ezFlatHashSetBase<K, H>::Insert(CompatibleKeyType&& key)
+{
+  bool bExisted = false;
+  const ezUInt32 uiSlot = m_Table.FindOrPrepareInsert(key, bExisted);
+
+  if (!bExisted)
+  {
+    // Either move or copy.
+    ezMemoryUtils::CopyOrMoveConstruct(&m_Table.m_pSlots[uiSlot].key, std::forward<CompatibleKeyType>(key));
+  }
+
+  return bExisted;
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+bool ezFlatHashSetBase<K, H>::Remove(const CompatibleKeyType& key)
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  if (uiSlot == ezInvalidIndex)
+    return false;
+
+  m_Table.Erase(uiSlot);
+  return true;
+}
+
+template <typename K, typename H>
+typename ezFlatHashSetBase<K, H>::ConstIterator ezFlatHashSetBase<K, H>::Remove(const typename ezFlatHashSetBase<K, H>::ConstIterator& pos)
+{
+  EZ_ASSERT_DEV(pos.m_pTable == &m_Table && pos.IsValid(), "Invalid iterator");
+
+  // erasing never moves other elements, so the next element can be looked up afterwards
+  m_Table.Erase(pos.m_uiSlot);
+  return ConstIterator(m_Table, m_Table.GetNextFullSlot(pos.m_uiSlot + 1));
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE bool ezFlatHashSetBase<K, H>::Contains(const CompatibleKeyType& key) const
+{
+  return m_Table.Find(key) != ezInvalidIndex;
+}
+
+template <typename K, typename H>
+template <typename CompatibleKeyType>
+inline typename ezFlatHashSetBase<K, H>::ConstIterator ezFlatHashSetBase<K, H>::Find(const CompatibleKeyType& key) const
+{
+  const ezUInt32 uiSlot = m_Table.Find(key);
+  return ConstIterator(m_Table, uiSlot != ezInvalidIndex ? uiSlot : m_Table.m_uiCapacity);
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashSetBase<K, H>::ConstIterator ezFlatHashSetBase<K, H>::GetIterator() const
+{
+  return ConstIterator(m_Table, m_Table.GetNextFullSlot(0));
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE typename ezFlatHashSetBase<K, H>::ConstIterator ezFlatHashSetBase<K, H>::GetEndIterator() const
+{
+  return ConstIterator(m_Table, m_Table.m_uiCapacity);
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE ezAllocatorBase* ezFlatHashSetBase<K, H>::GetAllocator() const
+{
+  return m_Table.m_pAllocator;
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE ezUInt64 ezFlatHashSetBase<K, H>::GetHeapMemoryUsage() const
+{
+  return m_Table.GetHeapMemoryUsage();
+}
+
+template <typename K, typename H>
+EZ_ALWAYS_INLINE void ezFlatHashSetBase<K, H>::Swap(ezFlatHashSetBase<K, H>& other)
+{
+  m_Table.Swap(other.m_Table);
+}
+
+
+// ***** ezFlatHashSet *****
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet()
+  : ezFlatHashSetBase<K, H>(A::GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(ezAllocatorBase* pAllocator)
+  : ezFlatHashSetBase<K, H>(pAllocator)
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(const ezFlatHashSet<K, H, A>& other)
+  : ezFlatHashSetBase<K, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(const ezFlatHashSetBase<K, H>& other)
+  : ezFlatHashSetBase<K, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(ezFlatHashSet<K, H, A>&& other)
+  : ezFlatHashSetBase<K, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+ezFlatHashSet<K, H, A>::ezFlatHashSet(ezFlatHashSetBase<K, H>&& other)
+  : ezFlatHashSetBase<K, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename H, typename A>
+void ezFlatHashSet<K, H, A>::operator=(const ezFlatHashSet<K, H, A>& rhs)
+{
+  ezFlatHashSetBase<K, H>::operator=(rhs);
+}
+
+template <typename K, typename H, typename A>
+void ezFlatHashSet<K, H, A>::operator=(const ezFlatHashSetBase<K, H>& rhs)
+{
+  ezFlatHashSetBase<K, H>::operator=(rhs);
+}
+
+template <typename K, typename H, typename A>
+void ezFlatHashSet<K, H, A>::operator=(ezFlatHashSet<K, H, A>&& rhs)
+{
+  ezFlatHashSetBase<K, H>::operator=(std::move(rhs));
+}
+
+template <typename K, typename H, typename A>
+void ezFlatHashSet<K, H, A>::operator=(ezFlatHashSetBase<K, H>&& rhs)
+{
+  ezFlatHashSetBase<K, H>::operator=(std::move(rhs));
+}
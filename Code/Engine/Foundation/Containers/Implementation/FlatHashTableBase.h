@@ -0,0 +1,462 @@
+#pragma once
+
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Math/Math.h>
+#include <Foundation/Memory/AllocatorWrapper.h>
+
+/// \brief Value used by containers for indices to indicate an invalid index.
+#ifndef ezInvalidIndex
+#  define ezInvalidIndex 0xFFFFFFFF
+#endif
+
+#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define EZ_FLATHASH_USE_SSE2 EZ_ON
+#  define EZ_FLATHASH_USE_NEON EZ_OFF
+#  include <emmintrin.h>
+#elif EZ_ENABLED(EZ_PLATFORM_ARCH_ARM) && (defined(__aarch64__) || defined(_M_ARM64))
+#  define EZ_FLATHASH_USE_SSE2 EZ_OFF
+#  define EZ_FLATHASH_USE_NEON EZ_ON
+#  include <arm_neon.h>
+#else
+#  define EZ_FLATHASH_USE_SSE2 EZ_OFF
+#  define EZ_FLATHASH_USE_NEON EZ_OFF
+#endif
+
+namespace ezInternal
+{
+  /// \brief The control bytes of 16 consecutive slots of a flat hash table.
+  ///
+  /// Every slot has one control byte. Occupied slots store the lower 7 bits of the hash of their key, free slots have the high bit set.
+  /// All 16 control bytes of a group are compared with a single SIMD instruction, the result is a bitmask with one bit per slot.
+  class FlatHashGroup
+  {
+  public:
+    enum : ezUInt8
+    {
+      Empty = 0x80,
+      Deleted = 0xFE,
+    };
+
+    static constexpr ezUInt32 Size = 16;
+
+    EZ_ALWAYS_INLINE explicit FlatHashGroup(const ezUInt8* pControl)
+    {
+#if EZ_ENABLED(EZ_FLATHASH_USE_SSE2)
+      m_Control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pControl));
+#elif EZ_ENABLED(EZ_FLATHASH_USE_NEON)
+      m_Control = vld1q_u8(pControl);
+#else
+      m_pControl = pControl;
+#endif
+    }
+
+    /// \brief Returns a bitmask of all slots that are occupied by a key with the given 7 bit hash.
+    EZ_ALWAYS_INLINE ezUInt32 Match(ezUInt8 uiHash7) const
+    {
+#if EZ_ENABLED(EZ_FLATHASH_USE_SSE2)
+      return static_cast<ezUInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(uiHash7)), m_Control)));
+#elif EZ_ENABLED(EZ_FLATHASH_USE_NEON)
+      return ToBitMask(vceqq_u8(vdupq_n_u8(uiHash7), m_Control));
+#else
+      return MatchScalar([uiHash7](ezUInt8 c) { return c == uiHash7; });
+#endif
+    }
+
+    /// \brief Returns a bitmask of all slots that have never been used since the last rehash.
+    EZ_ALWAYS_INLINE ezUInt32 MatchEmpty() const { return Match(Empty); }
+
+    /// \brief Returns a bitmask of all slots that can take a new key.
+    EZ_ALWAYS_INLINE ezUInt32 MatchEmptyOrDeleted() const
+    {
+#if EZ_ENABLED(EZ_FLATHASH_USE_SSE2)
+      return static_cast<ezUInt32>(_mm_movemask_epi8(m_Control));
+#elif EZ_ENABLED(EZ_FLATHASH_USE_NEON)
+      return ToBitMask(vcltq_s8(vreinterpretq_s8_u8(m_Control), vdupq_n_s8(0)));
+#else
+      return MatchScalar([](ezUInt8 c) { return (c & 0x80) != 0; });
+#endif
+    }
+
+    /// \brief Returns a bitmask of all occupied slots.
+    EZ_ALWAYS_INLINE ezUInt32 MatchFull() const { return ~MatchEmptyOrDeleted() & 0xFFFFu; }
+
+  private:
+#if EZ_ENABLED(EZ_FLATHASH_USE_SSE2)
+    __m128i m_Control;
+#elif EZ_ENABLED(EZ_FLATHASH_USE_NEON)
+    static EZ_ALWAYS_INLINE ezUInt32 ToBitMask(uint8x16_t comparison)
+    {
+      alignas(16) static const ezUInt8 s_Bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+      const uint8x16_t masked = vandq_u8(comparison, vld1q_u8(s_Bits));
+      return static_cast<ezUInt32>(vaddv_u8(vget_low_u8(masked))) | (static_cast<ezUInt32>(vaddv_u8(vget_high_u8(masked))) << 8);
+    }
+
+    uint8x16_t m_Control;
+#else
+    template <typename Predicate>
+    EZ_ALWAYS_INLINE ezUInt32 MatchScalar(Predicate pred) const
+    {
+      ezUInt32 uiMask = 0;
+      for (ezUInt32 i = 0; i < Size; ++i)
+      {
+        if (pred(m_pControl[i]))
+          uiMask |= 1u << i;
+      }
+      return uiMask;
+    }
+
+    const ezUInt8* m_pControl;
+#endif
+  };
+
+  /// \brief Open-addressing storage shared by ezFlatHashMapBase and ezFlatHashSetBase.
+  ///
+  /// SlotType needs a member called 'key'. The table probes whole groups of slots (see FlatHashGroup), starting at the group selected by
+  /// the upper bits of the hash and advancing with triangular steps, which visits every group once.
+  /// A lookup stops at the first group that contains an empty slot. Therefore removed keys only leave an empty slot behind, if their group
+  /// already had one, otherwise they are marked as deleted until the next rehash.
+  template <typename SlotType, typename Hasher>
+  class FlatHashTable
+  {
+  public:
+    explicit FlatHashTable(ezAllocatorBase* pAllocator)
+      : m_pAllocator(pAllocator)
+    {
+    }
+
+    ~FlatHashTable()
+    {
+      Clear();
+      EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pSlots);
+      EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+    }
+
+    /// \brief Spreads the bits of the given hash, ezHashHelper only guarantees good distribution in some of the bits.
+    static EZ_ALWAYS_INLINE ezUInt32 MixHash(ezUInt32 uiHash)
+    {
+      const ezUInt64 uiProduct = static_cast<ezUInt64>(uiHash) * 0x9E3779B97F4A7C15ull;
+      return static_cast<ezUInt32>(uiProduct >> 32) ^ static_cast<ezUInt32>(uiProduct);
+    }
+
+    static EZ_ALWAYS_INLINE ezUInt8 GetHash7(ezUInt32 uiMixedHash) { return static_cast<ezUInt8>(uiMixedHash & 0x7F); }
+
+    static EZ_ALWAYS_INLINE bool IsFull(ezUInt8 uiControl) { return (uiControl & 0x80) == 0; }
+
+    /// \brief The maximum number of occupied and deleted slots for a given capacity, i.e. a load factor of 87.5%.
+    static EZ_ALWAYS_INLINE ezUInt32 GetMaxLoad(ezUInt32 uiCapacity) { return uiCapacity - uiCapacity / 8; }
+
+    static ezUInt32 GetCapacityForCount(ezUInt32 uiCount)
+    {
+      ezUInt32 uiCapacity = FlatHashGroup::Size;
+      while (GetMaxLoad(uiCapacity) < uiCount)
+      {
+        EZ_ASSERT_DEV(uiCapacity < 0x80000000u, "ezFlatHashMap/Set do not support more than 2 billion entries.");
+        uiCapacity *= 2;
+      }
+      return uiCapacity;
+    }
+
+    EZ_ALWAYS_INLINE bool IsFullSlot(ezUInt32 uiSlot) const { return IsFull(m_pControl[uiSlot]); }
+
+    template <typename CompatibleKeyType>
+    EZ_ALWAYS_INLINE ezUInt32 Find(const CompatibleKeyType& key) const
+    {
+      return FindWithHash(MixHash(Hasher::Hash(key)), key);
+    }
+
+    template <typename CompatibleKeyType>
+    ezUInt32 FindWithHash(ezUInt32 uiMixedHash, const CompatibleKeyType& key) const
+    {
+      if (m_uiCount == 0)
+        return ezInvalidIndex;
+
+      const ezUInt8 uiHash7 = GetHash7(uiMixedHash);
+      const ezUInt32 uiGroupMask = m_uiCapacity / FlatHashGroup::Size - 1;
+      ezUInt32 uiGroup = (uiMixedHash >> 7) & uiGroupMask;
+
+      for (ezUInt32 uiProbe = 1; uiProbe <= uiGroupMask + 1; ++uiProbe)
+      {
+        const ezUInt32 uiGroupStart = uiGroup * FlatHashGroup::Size;
+        const FlatHashGroup group(m_pControl + uiGroupStart);
+
+        for (ezUInt32 uiMatches = group.Match(uiHash7); uiMatches != 0; uiMatches &= uiMatches - 1)
+        {
+          const ezUInt32 uiSlot = uiGroupStart + ezMath::FirstBitLow(uiMatches);
+          if (Hasher::Equal(m_pSlots[uiSlot].key, key))
+            return uiSlot;
+        }
+
+        if (group.MatchEmpty() != 0)
+          break;
+
+        uiGroup = (uiGroup + uiProbe) & uiGroupMask;
+      }
+
+      return ezInvalidIndex;
+    }
+
+    /// \brief Returns the slot of the given key. If the key did not exist yet, a slot is reserved for it and the caller has to construct the
+    /// key and value in it.
+    template <typename CompatibleKeyType>
+    ezUInt32 FindOrPrepareInsert(const CompatibleKeyType& key, bool& out_bExisted)
+    {
+      const ezUInt32 uiMixedHash = MixHash(Hasher::Hash(key));
+
+      ezUInt32 uiSlot = FindWithHash(uiMixedHash, key);
+      out_bExisted = uiSlot != ezInvalidIndex;
+
+      if (out_bExisted)
+        return uiSlot;
+
+      if (m_uiCount + m_uiNumDeleted + 1 > GetMaxLoad(m_uiCapacity))
+      {
+        // if there are enough deleted slots, it is sufficient to rehash with the same capacity to get rid of them
+        const ezUInt32 uiRequiredCapacity = GetCapacityForCount(m_uiCount + 1);
+        SetCapacity(m_uiNumDeleted > m_uiCapacity / 4 ? ezMath::Max(uiRequiredCapacity, m_uiCapacity) : ezMath::Max(uiRequiredCapacity, m_uiCapacity * 2));
+      }
+
+      uiSlot = FindInsertSlot(uiMixedHash);
+
+      if (m_pControl[uiSlot] == FlatHashGroup::Deleted)
+        --m_uiNumDeleted;
+
+      m_pControl[uiSlot] = GetHash7(uiMixedHash);
+      ++m_uiCount;
+
+      return uiSlot;
+    }
+
+    /// \brief Destructs the slot and marks it as free.
+    void Erase(ezUInt32 uiSlot)
+    {
+      EZ_ASSERT_DEBUG(IsFullSlot(uiSlot), "Invalid slot index");
+
+      ezMemoryUtils::Destruct(&m_pSlots[uiSlot], 1);
+
+      const ezUInt32 uiGroupStart = uiSlot & ~(FlatHashGroup::Size - 1);
+      if (FlatHashGroup(m_pControl + uiGroupStart).MatchEmpty() != 0)
+      {
+        m_pControl[uiSlot] = FlatHashGroup::Empty;
+      }
+      else
+      {
+        m_pControl[uiSlot] = FlatHashGroup::Deleted;
+        ++m_uiNumDeleted;
+      }
+
+      --m_uiCount;
+    }
+
+    /// \brief Returns the first occupied slot at or after the given index, or the capacity if there is none.
+    ezUInt32 GetNextFullSlot(ezUInt32 uiSlot) const
+    {
+      while (uiSlot < m_uiCapacity)
+      {
+        const ezUInt32 uiGroupStart = uiSlot & ~(FlatHashGroup::Size - 1);
+        const ezUInt32 uiFull = FlatHashGroup(m_pControl + uiGroupStart).MatchFull() >> (uiSlot - uiGroupStart);
+
+        if (uiFull != 0)
+          return uiSlot + ezMath::FirstBitLow(uiFull);
+
+        uiSlot = uiGroupStart + FlatHashGroup::Size;
+      }
+
+      return m_uiCapacity;
+    }
+
+    void Reserve(ezUInt32 uiCount)
+    {
+      const ezUInt32 uiCapacity = GetCapacityForCount(uiCount);
+      if (uiCapacity > m_uiCapacity)
+        SetCapacity(uiCapacity);
+    }
+
+    void Compact()
+    {
+      if (m_uiCount == 0)
+      {
+        // completely deallocate all data, if the table is empty.
+        EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pSlots);
+        EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+        m_uiCapacity = 0;
+        m_uiNumDeleted = 0;
+      }
+      else
+      {
+        const ezUInt32 uiCapacity = GetCapacityForCount(m_uiCount);
+        if (uiCapacity != m_uiCapacity || m_uiNumDeleted > 0)
+          SetCapacity(uiCapacity);
+      }
+    }
+
+    void Clear()
+    {
+      if (m_uiCount > 0)
+      {
+        for (ezUInt32 uiSlot = GetNextFullSlot(0); uiSlot < m_uiCapacity; uiSlot = GetNextFullSlot(uiSlot + 1))
+        {
+          ezMemoryUtils::Destruct(&m_pSlots[uiSlot], 1);
+        }
+      }
+
+      if (m_pControl != nullptr)
+      {
+        ezMemoryUtils::PatternFill(m_pControl, FlatHashGroup::Empty, m_uiCapacity);
+      }
+
+      m_uiCount = 0;
+      m_uiNumDeleted = 0;
+    }
+
+    void CopyFrom(const FlatHashTable& rhs)
+    {
+      Clear();
+
+      if (rhs.m_uiCount == 0)
+        return;
+
+      // keep the exact layout, that way nothing needs to be rehashed
+      if (m_uiCapacity != rhs.m_uiCapacity)
+      {
+        EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pSlots);
+        EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+        m_uiCapacity = rhs.m_uiCapacity;
+        m_pSlots = EZ_NEW_RAW_BUFFER(m_pAllocator, SlotType, m_uiCapacity);
+        m_pControl = EZ_NEW_RAW_BUFFER(m_pAllocator, ezUInt8, m_uiCapacity);
+      }
+
+      ezMemoryUtils::Copy(m_pControl, rhs.m_pControl, m_uiCapacity);
+
+      for (ezUInt32 uiSlot = rhs.GetNextFullSlot(0); uiSlot < m_uiCapacity; uiSlot = rhs.GetNextFullSlot(uiSlot + 1))
+      {
+        ezMemoryUtils::CopyConstruct(&m_pSlots[uiSlot], rhs.m_pSlots[uiSlot], 1);
+      }
+
+      m_uiCount = rhs.m_uiCount;
+      m_uiNumDeleted = rhs.m_uiNumDeleted;
+    }
+
+    void MoveFrom(FlatHashTable&& rhs)
+    {
+      Clear();
+
+      if (m_pAllocator != rhs.m_pAllocator)
+      {
+        if (rhs.m_uiCount > 0)
+        {
+          if (m_uiCapacity != rhs.m_uiCapacity)
+          {
+            EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pSlots);
+            EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+            m_uiCapacity = rhs.m_uiCapacity;
+            m_pSlots = EZ_NEW_RAW_BUFFER(m_pAllocator, SlotType, m_uiCapacity);
+            m_pControl = EZ_NEW_RAW_BUFFER(m_pAllocator, ezUInt8, m_uiCapacity);
+          }
+
+          ezMemoryUtils::Copy(m_pControl, rhs.m_pControl, m_uiCapacity);
+
+          for (ezUInt32 uiSlot = rhs.GetNextFullSlot(0); uiSlot < m_uiCapacity; uiSlot = rhs.GetNextFullSlot(uiSlot + 1))
+          {
+            ezMemoryUtils::MoveConstruct(&m_pSlots[uiSlot], std::move(rhs.m_pSlots[uiSlot]));
+          }
+
+          m_uiCount = rhs.m_uiCount;
+          m_uiNumDeleted = rhs.m_uiNumDeleted;
+        }
+
+        rhs.Clear();
+      }
+      else
+      {
+        EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pSlots);
+        EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControl);
+
+        // Move all data over.
+        m_pSlots = rhs.m_pSlots;
+        m_pControl = rhs.m_pControl;
+        m_uiCount = rhs.m_uiCount;
+        m_uiNumDeleted = rhs.m_uiNumDeleted;
+        m_uiCapacity = rhs.m_uiCapacity;
+
+        // Temp copy forgets all its state.
+        rhs.m_pSlots = nullptr;
+        rhs.m_pControl = nullptr;
+        rhs.m_uiCount = 0;
+        rhs.m_uiNumDeleted = 0;
+        rhs.m_uiCapacity = 0;
+      }
+    }
+
+    void Swap(FlatHashTable& other)
+    {
+      ezMath::Swap(m_pSlots, other.m_pSlots);
+      ezMath::Swap(m_pControl, other.m_pControl);
+      ezMath::Swap(m_uiCount, other.m_uiCount);
+      ezMath::Swap(m_uiNumDeleted, other.m_uiNumDeleted);
+      ezMath::Swap(m_uiCapacity, other.m_uiCapacity);
+      ezMath::Swap(m_pAllocator, other.m_pAllocator);
+    }
+
+    ezUInt64 GetHeapMemoryUsage() const { return static_cast<ezUInt64>(m_uiCapacity) * (sizeof(SlotType) + sizeof(ezUInt8)); }
+
+    SlotType* m_pSlots = nullptr;
+    ezUInt8* m_pControl = nullptr;
+
+    ezUInt32 m_uiCount = 0;
+    ezUInt32 m_uiNumDeleted = 0;
+    ezUInt32 m_uiCapacity = 0;
+
+    ezAllocatorBase* m_pAllocator = nullptr;
+
+  private:
+    ezUInt32 FindInsertSlot(ezUInt32 uiMixedHash) const
+    {
+      const ezUInt32 uiGroupMask = m_uiCapacity / FlatHashGroup::Size - 1;
+      ezUInt32 uiGroup = (uiMixedHash >> 7) & uiGroupMask;
+
+      for (ezUInt32 uiProbe = 1;; ++uiProbe)
+      {
+        const ezUInt32 uiFree = FlatHashGroup(m_pControl + uiGroup * FlatHashGroup::Size).MatchEmptyOrDeleted();
+        if (uiFree != 0)
+          return uiGroup * FlatHashGroup::Size + ezMath::FirstBitLow(uiFree);
+
+        // the load factor guarantees that there is always a free slot
+        EZ_ASSERT_DEBUG(uiProbe <= uiGroupMask, "Implementation error");
+        uiGroup = (uiGroup + uiProbe) & uiGroupMask;
+      }
+    }
+
+    void SetCapacity(ezUInt32 uiCapacity)
+    {
+      EZ_ASSERT_DEV(ezMath::IsPowerOf2(uiCapacity) && uiCapacity >= FlatHashGroup::Size, "Invalid flat hash table capacity {}", uiCapacity);
+
+      const ezUInt32 uiOldCapacity = m_uiCapacity;
+      SlotType* pOldSlots = m_pSlots;
+      ezUInt8* pOldControl = m_pControl;
+
+      m_uiCapacity = uiCapacity;
+      m_uiNumDeleted = 0;
+      m_pSlots = EZ_NEW_RAW_BUFFER(m_pAllocator, SlotType, m_uiCapacity);
+      m_pControl = EZ_NEW_RAW_BUFFER(m_pAllocator, ezUInt8, m_uiCapacity);
+      ezMemoryUtils::PatternFill(m_pControl, FlatHashGroup::Empty, m_uiCapacity);
+
+      for (ezUInt32 uiSlot = 0; uiSlot < uiOldCapacity; ++uiSlot)
+      {
+        if (!IsFull(pOldControl[uiSlot]))
+          continue;
+
+        // keys are unique, so there is no need to search for them
+        const ezUInt32 uiMixedHash = MixHash(Hasher::Hash(pOldSlots[uiSlot].key));
+        const ezUInt32 uiNewSlot = FindInsertSlot(uiMixedHash);
+
+        m_pControl[uiNewSlot] = GetHash7(uiMixedHash);
+        ezMemoryUtils::RelocateConstruct(&m_pSlots[uiNewSlot], &pOldSlots[uiSlot], 1);
+      }
+
+      EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldSlots);
+      EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldControl);
+    }
+
+    EZ_DISALLOW_COPY_AND_ASSIGN(FlatHashTable);
+  };
+} // namespace ezInternal
@@ -6,6 +6,7 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/MemoryUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 ezProcessingStreamGroup::ezProcessingStreamGroup()
 {
@@ -161,10 +162,27 @@ void ezProcessingStreamGroup::Process()
 {
   EnsureStreamAssignmentValid();
 
-  // TODO: Identify which processors work on which streams and find independent groups and use separate tasks for them?
-  for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
+  // Runs of processors that support parallel processing are executed chunk by chunk,
+  // all other processors act as a barrier and see the results of everything that ran before them.
+  const ezUInt32 uiNumProcessors = m_Processors.GetCount();
+  for (ezUInt32 uiProcessor = 0; uiProcessor < uiNumProcessors;)
   {
-    pStreamProcessor->Process(m_uiNumActiveElements);
+    ezUInt32 uiEndProcessor = uiProcessor;
+    while (uiEndProcessor < uiNumProcessors && m_Processors[uiEndProcessor]->SupportsParallelProcessing())
+    {
+      ++uiEndProcessor;
+    }
+
+    if (uiEndProcessor > uiProcessor)
+    {
+      ProcessParallelProcessors(uiProcessor, uiEndProcessor);
+      uiProcessor = uiEndProcessor;
+    }
+    else
+    {
+      m_Processors[uiProcessor]->Process(m_uiNumActiveElements);
+      ++uiProcessor;
+    }
   }
 
   // Run any pending deletions which happened due to stream processor execution
@@ -175,6 +193,39 @@ void ezProcessingStreamGroup::Process()
   RunPendingSpawns();
 }
 
+void ezProcessingStreamGroup::ProcessParallelProcessors(ezUInt32 uiFirstProcessor, ezUInt32 uiEndProcessor)
+{
+  const ezUInt64 uiChunkSize = m_uiParallelProcessingChunkSize;
+  const ezUInt64 uiNumActiveElements = m_uiNumActiveElements;
+
+  if (uiChunkSize == 0 || uiNumActiveElements <= uiChunkSize)
+  {
+    for (ezUInt32 i = uiFirstProcessor; i < uiEndProcessor; ++i)
+    {
+      m_Processors[i]->Process(uiNumActiveElements);
+    }
+
+    return;
+  }
+
+  const ezUInt32 uiNumChunks = static_cast<ezUInt32>((uiNumActiveElements + uiChunkSize - 1) / uiChunkSize);
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumChunks,
+    [&](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) {
+      for (ezUInt32 uiChunk = uiStartChunk; uiChunk < uiEndChunk; ++uiChunk)
+      {
+        const ezUInt64 uiStartIndex = uiChunk * uiChunkSize;
+        const ezUInt64 uiNumElements = ezMath::Min(uiChunkSize, uiNumActiveElements - uiStartIndex);
+
+        for (ezUInt32 i = uiFirstProcessor; i < uiEndProcessor; ++i)
+        {
+          m_Processors[i]->ProcessRange(uiStartIndex, uiNumElements);
+        }
+      }
+    },
+    "ezProcessingStreamGroup::Process");
+}
 
 void ezProcessingStreamGroup::RunPendingDeletions()
 {
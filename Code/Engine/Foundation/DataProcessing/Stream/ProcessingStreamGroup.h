@@ -67,6 +67,16 @@ public:
   /// \brief Runs the stream processors which have been added to the stream group.
   void Process();
 
+  /// \brief Sets how many elements are processed per task when running processors in parallel.
+  ///
+  /// Consecutive processors that support parallel processing are then run on chunks of this size using ezTaskSystem::ParallelForIndexed.
+  /// Each chunk is passed through all of these processors in order, before the next sequential processor runs on all elements.
+  /// Zero (the default) disables parallel processing. Groups with fewer active elements than one chunk are always processed on the calling thread.
+  void SetParallelProcessingChunkSize(ezUInt32 uiChunkSize) { m_uiParallelProcessingChunkSize = uiChunkSize; }
+
+  /// \brief Returns the value set by SetParallelProcessingChunkSize().
+  ezUInt32 GetParallelProcessingChunkSize() const { return m_uiParallelProcessingChunkSize; }
+
   /// \brief Returns the number of elements the streams store.
   inline ezUInt64 GetNumElements() const { return m_uiNumElements; }
 
@@ -89,6 +99,9 @@ private:
 
   void SortProcessorsByPriority();
 
+  /// \brief Runs the processors in the range [uiFirstProcessor; uiEndProcessor), which all support parallel processing.
+  void ProcessParallelProcessors(ezUInt32 uiFirstProcessor, ezUInt32 uiEndProcessor);
+
   ezHybridArray<ezProcessingStreamProcessor*, 8> m_Processors;
 
   ezHybridArray<ezProcessingStream*, 8> m_DataStreams;
@@ -103,5 +116,7 @@ private:
 
   ezUInt64 m_uiHighestNumActiveElements;
 
+  ezUInt32 m_uiParallelProcessingChunkSize = 0;
+
   bool m_bStreamAssignmentDirty;
 };
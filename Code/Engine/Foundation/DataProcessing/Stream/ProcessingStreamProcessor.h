@@ -33,7 +33,18 @@ protected:
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) = 0;
 
   /// \brief The actual method which processes the data, will be called with the number of elements to process.
-  virtual void Process(ezUInt64 uiNumElements) = 0;
+  /// The default implementation forwards to ProcessRange() for all elements.
+  virtual void Process(ezUInt64 uiNumElements);
+
+  /// \brief Whether ProcessRange() may be called concurrently for disjoint ranges of elements.
+  ///
+  /// Processors that return true here must only read and write the elements inside the given range and must not modify any other state
+  /// during processing. Per-update state has to be prepared up front. They must not remove or spawn elements either, since that is not thread-safe.
+  virtual bool SupportsParallelProcessing() const { return false; }
+
+  /// \brief Processes the elements in the range [uiStartIndex; uiStartIndex + uiNumElements).
+  /// Must be implemented by all processors that return true from SupportsParallelProcessing() or that don't override Process().
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements);
 
   /// \brief Back pointer to the stream group - will be set to the owner stream group when adding the stream processor to the group.
   /// Can be used to get stream pointers in UpdateStreamBindings();
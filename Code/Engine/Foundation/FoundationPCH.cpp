@@ -61,9 +61,11 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_DataProcessing_Stream_Implementation_ProcessingStreamProcessor);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_Archive);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveBuilder);
+  EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveChunkedEntryReader);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveReader);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveUtils);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_DataDirTypeArchive);
+  EZ_STATICLINK_REFERENCE(Foundation_IO_FileSystem_Implementation_AsyncFileReadBatch);
   EZ_STATICLINK_REFERENCE(Foundation_IO_FileSystem_Implementation_DataDirType);
   EZ_STATICLINK_REFERENCE(Foundation_IO_FileSystem_Implementation_DataDirTypeFolder);
   EZ_STATICLINK_REFERENCE(Foundation_IO_FileSystem_Implementation_DeferredFileWriter);
@@ -73,6 +75,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_ChunkStream);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_CompressedStreamZlib);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_CompressedStreamZstd);
+  EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_CompressionDictionaryZstd);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_DeduplicationContext);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_DependencyFile);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_DirectoryWatcher);
@@ -12,6 +12,8 @@ enum class ezArchiveCompressionMode : ezUInt8
   Uncompressed,
   Compressed_zstd,
   Compressed_zip,
+  Compressed_zstd_chunked, ///< zstd, but split into independently compressed chunks with a seek table, see ezArchiveChunkedEntryReader.
+  Compressed_zstd_dictionary, ///< zstd, using the dictionary that is stored in ezArchiveTOC::m_CompressionDictionary.
 };
 
 /// \brief Data for a single file entry in an ezArchive file
@@ -103,6 +105,8 @@ public:
   ezHashTable<ezArchiveStoredString, ezUInt32> m_PathToEntryIndex;
   /// one large array holding all path strings for the file entries, to reduce allocations
   ezDynamicArray<ezUInt8> m_AllPathStrings;
+  /// the zstd dictionary for all entries that use ezArchiveCompressionMode::Compressed_zstd_dictionary, see ezCompressionDictionaryZstd
+  ezDynamicArray<ezUInt8> m_CompressionDictionary;
 
   /// \brief Returns the entry index for the given file or ezInvalidIndex, if not found.
   ezUInt32 FindEntry(const char* szFile) const;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/Archive/ArchiveUtils.h>
 
 #include <Foundation/Containers/Deque.h>
 #include <Foundation/Types/Delegate.h>
@@ -21,6 +22,24 @@ public:
   // all the source files from disk that should be put into the ezArchive
   ezDeque<SourceEntry> m_Entries;
 
+  /// \brief Files that are compressed with zstd and are at least this large (in bytes) get stored with ezArchiveCompressionMode::Compressed_zstd_chunked.
+  ///
+  /// Such entries can be read from any position and are decompressed in parallel. Zero disables chunked compression.
+  ezUInt64 m_uiChunkedCompressionThreshold = 0;
+
+  /// \brief The uncompressed size of the chunks of ezArchiveCompressionMode::Compressed_zstd_chunked entries.
+  ezUInt32 m_uiChunkSize = ezArchiveUtils::DefaultChunkSize;
+
+  /// \brief If non-zero, a zstd dictionary of up to this many bytes is trained on the small files and stored in the archive.
+  ///
+  /// All files that are compressed with zstd and are not larger than m_uiCompressionDictionaryMaxFileSize are then stored with
+  /// ezArchiveCompressionMode::Compressed_zstd_dictionary. Small files compress much better with a dictionary and decompress faster.
+  /// If there is not enough data to train a dictionary, the files are compressed without one.
+  ezUInt32 m_uiCompressionDictionarySize = 0;
+
+  /// \brief Files up to this size are used for training the compression dictionary and get compressed with it.
+  ezUInt64 m_uiCompressionDictionaryMaxFileSize = 64 * 1024;
+
   enum class InclusionMode
   {
     Exclude,       ///< Do not add this file to the archive
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/IO/Stream.h>
+#include <Foundation/Types/Delegate.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+/// \brief Reads the data of an ezArchive entry that was stored with ezArchiveCompressionMode::Compressed_zstd_chunked.
+///
+/// Such entries are split into chunks of a fixed uncompressed size, which are compressed independently of each other.
+/// The stored data starts with a seek table:
+///   ezUInt32 chunk size, ezUInt32 number of chunks, ezUInt64 start offset of every chunk plus the end offset of the last one.
+/// The offsets are relative to the start of the stored data.
+///
+/// This allows to jump to any position in the entry without decompressing everything before it (see SetReadPosition() and SkipBytes()).
+/// Reads that cover several whole chunks decompress them directly into the target buffer, in parallel on the ezTaskSystem worker threads.
+class EZ_FOUNDATION_DLL ezArchiveChunkedEntryReader : public ezStreamReader
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezArchiveChunkedEntryReader);
+
+public:
+  ezArchiveChunkedEntryReader();
+  ~ezArchiveChunkedEntryReader();
+
+  /// \brief Sets up the reader for the stored (compressed) data of an entry. Returns EZ_FAILURE, if the seek table is invalid.
+  ///
+  /// The stored data is not copied, it must stay valid as long as the reader is used.
+  ezResult Configure(const void* pStoredData, ezUInt64 uiStoredDataSize, ezUInt64 uiUncompressedDataSize); // [tested]
+
+  /// \brief Reads either uiBytesToRead or the amount of remaining bytes into pReadBuffer.
+  ///
+  /// If pReadBuffer is nullptr, the read position is only advanced, without decompressing anything.
+  virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override; // [tested]
+
+  /// \brief Advances the read position without decompressing anything.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override; // [tested]
+
+  /// \brief Sets the position (in uncompressed bytes) from which the next read starts.
+  void SetReadPosition(ezUInt64 uiReadPosition); // [tested]
+
+  /// \brief Returns the current read position in uncompressed bytes.
+  ezUInt64 GetReadPosition() const { return m_uiReadPosition; }
+
+  /// \brief Returns the size of the entry's uncompressed data.
+  ezUInt64 GetUncompressedDataSize() const { return m_uiUncompressedDataSize; }
+
+  /// \brief Writes \a uiSourceSize bytes from \a source to \a stream in the chunked format.
+  ///
+  /// The chunks are compressed in parallel. All compressed data is kept in memory until the seek table can be written.
+  /// \a out_uiWrittenBytes returns how many bytes were written to \a stream.
+  static ezResult WriteChunkedData(ezStreamWriter& stream, ezStreamReader& source, ezUInt64 uiSourceSize, ezUInt32 uiChunkSize, ezUInt64& out_uiWrittenBytes, ezDelegate<bool(ezUInt64, ezUInt64)> progress = {});
+
+private:
+  ezUInt64 GetChunkUncompressedSize(ezUInt32 uiChunk) const;
+  ezResult DecompressChunk(ezUInt32 uiChunk, void* pTarget, void* pContext) const;
+  ezResult DecompressChunks(ezUInt32 uiFirstChunk, ezUInt32 uiNumChunks, ezUInt8* pTarget);
+  void* GetDecompressionContext();
+
+  const ezUInt8* m_pStoredData = nullptr;
+  ezUInt64 m_uiStoredDataSize = 0;
+  ezUInt64 m_uiUncompressedDataSize = 0;
+  ezUInt64 m_uiReadPosition = 0;
+  ezUInt32 m_uiChunkSize = 0;
+  ezDynamicArray<ezUInt64> m_ChunkOffsets;
+
+  ezUInt32 m_uiCachedChunk = ezInvalidIndex;
+  ezDynamicArray<ezUInt8> m_ChunkCache;
+  /*ZSTD_DCtx*/ void* m_pDecompressionContext = nullptr;
+};
+
+#endif // BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/CompressionDictionaryZstd.h>
 #include <Foundation/IO/MemoryMappedFile.h>
 #include <Foundation/Types/UniquePtr.h>
 
+class ezArchiveChunkedEntryReader;
 class ezRawMemoryStreamReader;
 class ezStreamReader;
 
@@ -17,6 +19,11 @@ public:
   /// \brief Returns the table-of-contents for the previously opened archive.
   const ezArchiveTOC& GetArchiveTOC();
 
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  /// \brief Returns the dictionary for entries that use ezArchiveCompressionMode::Compressed_zstd_dictionary, or nullptr if the archive has none.
+  const ezCompressionDictionaryZstd* GetCompressionDictionary() const { return m_pCompressionDictionary.Borrow(); }
+#endif
+
   /// \brief Extracts the given entry to the target folder.
   ///
   /// Calls ExtractFileProgressCallback() to report progress.
@@ -30,9 +37,31 @@ public:
   /// \brief Sets up \a memReader for reading the raw (potentially compressed) data that is stored for the given entry in the archive.
   void ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawMemoryStreamReader& memReader) const;
 
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  /// \brief Sets up \a reader for an entry that was stored with ezArchiveCompressionMode::Compressed_zstd_chunked.
+  ezResult ConfigureChunkedEntryReader(ezUInt32 uiEntryIdx, ezArchiveChunkedEntryReader& reader) const;
+#endif
+
   /// \brief Creates a reader that will decompress the given file entry.
   ezUniquePtr<ezStreamReader> CreateEntryReader(ezUInt32 uiEntryIdx) const;
 
+  /// \brief Reads up to \a uiBytes of the uncompressed content of the given entry, starting at \a uiOffset.
+  ///
+  /// For entries stored with ezArchiveCompressionMode::Compressed_zstd_chunked only the chunks covering the requested range are decompressed,
+  /// other compressed entries have to be decompressed from the start. Returns the number of bytes that were read.
+  ezUInt64 ReadEntryData(ezUInt32 uiEntryIdx, ezUInt64 uiOffset, void* pBuffer, ezUInt64 uiBytes) const;
+
+  /// \brief Returns the content of the given entry directly from the memory mapped archive, without copying it.
+  ///
+  /// This only works for uncompressed entries, for compressed and empty entries an invalid array (nullptr) is returned.
+  /// The memory stays valid as long as the archive is open.
+  ezArrayPtr<const ezUInt8> GetEntryDataView(ezUInt32 uiEntryIdx) const;
+
+  /// \brief Hints the OS to read the (potentially compressed) data of the given entry into memory in the background.
+  ///
+  /// Call this for entries that will be accessed soon, to overlap the disk access with other work.
+  void PrefetchEntryData(ezUInt32 uiEntryIdx) const;
+
 protected:
   /// \brief Called by ExtractAllFiles() for progress reporting. Return false to abort.
   virtual bool ExtractNextFileCallback(ezUInt32 uiCurEntry, ezUInt32 uiMaxEntries, const char* szSourceFile) const;
@@ -45,4 +74,8 @@ protected:
   ezUInt8 m_uiArchiveVersion = 0;
   const void* m_pDataStart = nullptr;
   ezUInt64 m_uiMemFileSize = 0;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  ezUniquePtr<ezCompressionDictionaryZstd> m_pCompressionDictionary;
+#endif
 };
@@ -9,6 +9,7 @@ class ezStreamWriter;
 class ezMemoryMappedFile;
 class ezArchiveTOC;
 class ezArchiveEntry;
+class ezCompressionDictionaryZstd;
 class ezRawMemoryStreamReader;
 
 /// \brief Utilities for working with ezArchive files
@@ -16,6 +17,9 @@ namespace ezArchiveUtils
 {
   typedef ezDelegate<bool(ezUInt64, ezUInt64)> FileWriteProgressCallback;
 
+  /// \brief The default uncompressed size of the chunks of ezArchiveCompressionMode::Compressed_zstd_chunked entries.
+  constexpr ezUInt32 DefaultChunkSize = 1024 * 1024;
+
   /// \brief Returns a modifiable array of file extensions that the engine considers to be valid ezArchive file extensions.
   ///
   /// By default it always contains 'ezArchive'.
@@ -41,15 +45,19 @@ namespace ezArchiveUtils
   ///
   /// Appends information to the TOC for finding the data in the stream. Reads and updates inout_uiCurrentStreamPosition with the data byte
   /// offset. The progress callback is executed for every couple of KB of data that were written.
+  /// \a uiChunkSize is only used for ezArchiveCompressionMode::Compressed_zstd_chunked.
+  /// \a pDictionary is required for ezArchiveCompressionMode::Compressed_zstd_dictionary, it must be the one stored in the archive TOC.
   EZ_FOUNDATION_DLL ezResult WriteEntry(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset,
     ezArchiveCompressionMode compression, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition,
-    FileWriteProgressCallback progress = FileWriteProgressCallback());
+    FileWriteProgressCallback progress = FileWriteProgressCallback(), ezUInt32 uiChunkSize = DefaultChunkSize,
+    const ezCompressionDictionaryZstd* pDictionary = nullptr);
 
   /// \brief Similar to WriteEntry, but if compression is enabled, checks that compression makes enough of a difference.
   /// If compression does not reduce file size enough, the file is stored uncompressed instead.
   EZ_FOUNDATION_DLL ezResult WriteEntryOptimal(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset,
     ezArchiveCompressionMode compression, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition,
-    FileWriteProgressCallback progress = FileWriteProgressCallback());
+    FileWriteProgressCallback progress = FileWriteProgressCallback(), ezUInt32 uiChunkSize = DefaultChunkSize,
+    const ezCompressionDictionaryZstd* pDictionary = nullptr);
 
   /// \brief Configures \a memReader as a view into the data stored for \a entry in the archive file.
   ///
@@ -60,7 +68,8 @@ namespace ezArchiveUtils
   /// \brief Creates a new stream reader which allows to read the uncompressed data for the given archive entry.
   ///
   /// Under the hood it may create different types of stream readers to uncompress or decode the data.
-  EZ_FOUNDATION_DLL ezUniquePtr<ezStreamReader> CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData);
+  /// Entries that use ezArchiveCompressionMode::Compressed_zstd_dictionary require the archive's dictionary.
+  EZ_FOUNDATION_DLL ezUniquePtr<ezStreamReader> CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData, const ezCompressionDictionaryZstd* pDictionary = nullptr);
 
   EZ_FOUNDATION_DLL ezResult ReadZipHeader(ezStreamReader& stream, ezUInt8& out_uiVersion);
   EZ_FOUNDATION_DLL ezResult ExtractZipTOC(ezMemoryMappedFile& memFile, ezArchiveTOC& toc);
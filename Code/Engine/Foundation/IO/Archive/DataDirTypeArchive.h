@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/IO/Archive/ArchiveChunkedEntryReader.h>
 #include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/CompressedStreamZlib.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
@@ -14,6 +15,7 @@ namespace ezDataDirectory
 {
   class ArchiveReaderUncompressed;
   class ArchiveReaderZstd;
+  class ArchiveReaderZstdChunked;
   class ArchiveReaderZip;
 
   class EZ_FOUNDATION_DLL ArchiveType : public ezDataDirectoryType
@@ -26,6 +28,8 @@ namespace ezDataDirectory
 
     virtual const ezString128& GetRedirectedDataDirectoryPath() const override { return m_sRedirectedDataDirPath; }
 
+    virtual bool PrefersSequentialReads() const override { return true; }
+
   protected:
     virtual ezDataDirectoryReader* OpenFileToRead(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bSpecificallyThisDataDir) override;
 
@@ -39,6 +43,9 @@ namespace ezDataDirectory
 
     virtual void OnReaderWriterClose(ezDataDirectoryReaderWriterBase* pClosed) override;
 
+    friend class ArchiveReaderUncompressed;
+    friend class ArchiveReaderZstdChunked;
+
     ezString128 m_sRedirectedDataDirPath;
     ezString32 m_sArchiveSubFolder;
     ezTimestamp m_LastModificationTime;
@@ -51,6 +58,8 @@ namespace ezDataDirectory
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZstd>, 4> m_ReadersZstd;
     ezHybridArray<ArchiveReaderZstd*, 4> m_FreeReadersZstd;
+    ezHybridArray<ezUniquePtr<ArchiveReaderZstdChunked>, 4> m_ReadersZstdChunked;
+    ezHybridArray<ArchiveReaderZstdChunked*, 4> m_FreeReadersZstdChunked;
 #endif
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZip>, 4> m_ReadersZip;
@@ -68,6 +77,9 @@ namespace ezDataDirectory
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
     virtual ezUInt64 GetFileSize() const override;
+    virtual ezUInt64 GetStorageOffset() const override { return m_uiDataStartOffset; }
+    virtual ezArrayPtr<const ezUInt8> GetMappedContent() const override { return m_MappedContent; }
+    virtual void Prefetch() override;
 
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
@@ -77,6 +89,9 @@ namespace ezDataDirectory
 
     ezUInt64 m_uiUncompressedSize = 0;
     ezUInt64 m_uiCompressedSize = 0;
+    ezUInt64 m_uiDataStartOffset = 0;
+    ezUInt32 m_uiEntryIndex = 0;
+    ezArrayPtr<const ezUInt8> m_MappedContent; ///< Only set for uncompressed entries
     ezRawMemoryStreamReader m_MemStreamReader;
   };
 
@@ -97,6 +112,25 @@ namespace ezDataDirectory
     friend class ArchiveType;
 
     ezCompressedStreamReaderZstd m_CompressedStreamReader;
+    const ezCompressionDictionaryZstd* m_pDictionary = nullptr; ///< Only set for entries that were compressed with the archive's dictionary
+  };
+
+  class EZ_FOUNDATION_DLL ArchiveReaderZstdChunked : public ArchiveReaderUncompressed
+  {
+    EZ_DISALLOW_COPY_AND_ASSIGN(ArchiveReaderZstdChunked);
+
+  public:
+    ArchiveReaderZstdChunked(ezInt32 iDataDirUserData);
+    ~ArchiveReaderZstdChunked();
+
+    virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+
+  protected:
+    virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
+
+    friend class ArchiveType;
+
+    ezArchiveChunkedEntryReader m_ChunkedReader;
   };
 #endif
 
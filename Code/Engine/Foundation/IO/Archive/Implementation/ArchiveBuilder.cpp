@@ -2,6 +2,8 @@
 
 #include <Foundation/IO/Archive/ArchiveBuilder.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
+#include <Foundation/IO/CompressionDictionaryZstd.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/Log.h>
@@ -71,6 +73,77 @@ ezResult ezArchiveBuilder::WriteArchive(const char* szFile) const
   return WriteArchive(file);
 }
 
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+static void TrainCompressionDictionary(const ezDeque<ezArchiveBuilder::SourceEntry>& entries, ezUInt32 uiDictionarySize, ezUInt64 uiMaxFileSize, ezDynamicArray<ezUInt8>& out_Dictionary, ezDynamicArray<bool>& out_UseDictionary)
+{
+  EZ_LOG_BLOCK("TrainCompressionDictionary");
+
+  out_UseDictionary.SetCount(entries.GetCount(), false);
+
+  // the trainer doesn't look at more data than this anyway
+  const ezUInt64 uiMaxSampleData = ezMath::Min<ezUInt64>(static_cast<ezUInt64>(uiDictionarySize) * 100, 1024 * 1024 * 1024);
+
+  ezDynamicArray<ezUInt32> smallFiles;
+  ezUInt64 uiTotalSmallFileSize = 0;
+
+  for (ezUInt32 i = 0; i < entries.GetCount(); ++i)
+  {
+    if (entries[i].m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd)
+      continue;
+
+    ezFileReader file;
+    if (file.Open(entries[i].m_sAbsSourcePath).Failed() || file.GetFileSize() > uiMaxFileSize)
+      continue;
+
+    out_UseDictionary[i] = true;
+    smallFiles.PushBack(i);
+    uiTotalSmallFileSize += file.GetFileSize();
+  }
+
+  // if there are more small files than needed, sample every n-th one, so that all folders and file types are represented
+  const ezUInt32 uiStride = static_cast<ezUInt32>(ezMath::Max<ezUInt64>(1, (uiTotalSmallFileSize + uiMaxSampleData - 1) / uiMaxSampleData));
+
+  ezDynamicArray<ezUInt8> sampleData;
+  ezDynamicArray<ezUInt32> sampleEnds;
+
+  for (ezUInt32 i = 0; i < smallFiles.GetCount(); i += uiStride)
+  {
+    ezFileReader file;
+    if (file.Open(entries[smallFiles[i]].m_sAbsSourcePath).Failed())
+      continue;
+
+    if (sampleData.GetCount() + file.GetFileSize() > uiMaxSampleData)
+      continue;
+
+    const ezUInt32 uiSampleStart = sampleData.GetCount();
+    sampleData.SetCountUninitialized(uiSampleStart + static_cast<ezUInt32>(file.GetFileSize()));
+    sampleData.SetCountUninitialized(uiSampleStart + static_cast<ezUInt32>(file.ReadBytes(sampleData.GetData() + uiSampleStart, file.GetFileSize())));
+    sampleEnds.PushBack(sampleData.GetCount());
+  }
+
+  ezDynamicArray<ezArrayPtr<const ezUInt8>> samples;
+  samples.Reserve(sampleEnds.GetCount());
+
+  ezUInt32 uiSampleStart = 0;
+  for (ezUInt32 uiSampleEnd : sampleEnds)
+  {
+    samples.PushBack(sampleData.GetArrayPtr().GetSubArray(uiSampleStart, uiSampleEnd - uiSampleStart));
+    uiSampleStart = uiSampleEnd;
+  }
+
+  if (ezCompressionDictionaryZstd::Train(samples, uiDictionarySize, out_Dictionary).Failed())
+  {
+    ezLog::Info("Not enough small files to train a compression dictionary ({} files, {} bytes).", samples.GetCount(), sampleData.GetCount());
+    out_UseDictionary.Clear();
+    return;
+  }
+
+  ezLog::Info("Trained a {} byte compression dictionary on {} files.", out_Dictionary.GetCount(), samples.GetCount());
+}
+
+#endif
+
 ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& stream) const
 {
   EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteHeader(stream));
@@ -82,6 +155,24 @@ ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& stream) const
   ezUInt64 uiStreamSize = 0;
   const ezUInt32 uiNumEntries = m_Entries.GetCount();
 
+  const ezCompressionDictionaryZstd* pDictionary = nullptr;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  ezDynamicArray<bool> useDictionary;
+  ezUniquePtr<ezCompressionDictionaryZstd> pTrainedDictionary;
+
+  if (m_uiCompressionDictionarySize > 0)
+  {
+    TrainCompressionDictionary(m_Entries, m_uiCompressionDictionarySize, m_uiCompressionDictionaryMaxFileSize, toc.m_CompressionDictionary, useDictionary);
+
+    if (!toc.m_CompressionDictionary.IsEmpty())
+    {
+      pTrainedDictionary = EZ_DEFAULT_NEW(ezCompressionDictionaryZstd, toc.m_CompressionDictionary);
+      pDictionary = pTrainedDictionary.Borrow();
+    }
+  }
+#endif
+
   for (ezUInt32 i = 0; i < uiNumEntries; ++i)
   {
     const SourceEntry& e = m_Entries[i];
@@ -97,7 +188,27 @@ ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& stream) const
     if (!WriteNextFileCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath))
       return EZ_FAILURE;
 
-    EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(stream, e.m_sAbsSourcePath, uiPathStringOffset, e.m_CompressionMode, toc.m_Entries.ExpandAndGetRef(), uiStreamSize, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this)));
+    ezArchiveCompressionMode compression = e.m_CompressionMode;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    if (pDictionary != nullptr && useDictionary[i])
+    {
+      compression = ezArchiveCompressionMode::Compressed_zstd_dictionary;
+    }
+#endif
+
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+    if (compression == ezArchiveCompressionMode::Compressed_zstd && m_uiChunkedCompressionThreshold > 0)
+    {
+      ezFileStats stats;
+      if (ezOSFile::GetFileStats(e.m_sAbsSourcePath, stats).Succeeded() && stats.m_uiFileSize >= m_uiChunkedCompressionThreshold)
+      {
+        compression = ezArchiveCompressionMode::Compressed_zstd_chunked;
+      }
+    }
+#endif
+
+    EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(stream, e.m_sAbsSourcePath, uiPathStringOffset, compression, toc.m_Entries.ExpandAndGetRef(), uiStreamSize, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this), m_uiChunkSize, pDictionary));
   }
 
   EZ_SUCCEED_OR_RETURN(ezArchiveUtils::AppendTOC(stream, toc));
@@ -0,0 +1,325 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/Archive/ArchiveChunkedEntryReader.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+#  include <Foundation/IO/CompressedStreamZstd.h>
+#  include <Foundation/IO/MemoryStream.h>
+#  include <Foundation/Logging/Log.h>
+#  include <Foundation/Threading/AtomicInteger.h>
+#  include <Foundation/Threading/TaskSystem.h>
+#  include <zstd/zstd.h>
+
+ezArchiveChunkedEntryReader::ezArchiveChunkedEntryReader() = default;
+
+ezArchiveChunkedEntryReader::~ezArchiveChunkedEntryReader()
+{
+  if (m_pDecompressionContext != nullptr)
+  {
+    ZSTD_freeDCtx(reinterpret_cast<ZSTD_DCtx*>(m_pDecompressionContext));
+    m_pDecompressionContext = nullptr;
+  }
+}
+
+ezResult ezArchiveChunkedEntryReader::Configure(const void* pStoredData, ezUInt64 uiStoredDataSize, ezUInt64 uiUncompressedDataSize)
+{
+  m_pStoredData = static_cast<const ezUInt8*>(pStoredData);
+  m_uiStoredDataSize = uiStoredDataSize;
+  m_uiUncompressedDataSize = uiUncompressedDataSize;
+  m_uiReadPosition = 0;
+  m_uiCachedChunk = ezInvalidIndex;
+  m_ChunkOffsets.Clear();
+
+  ezRawMemoryStreamReader reader(pStoredData, uiStoredDataSize);
+
+  ezUInt32 uiNumChunks = 0;
+  if (uiStoredDataSize < sizeof(ezUInt32) * 2)
+  {
+    ezLog::Error("Archive is corrupt. Missing chunk table.");
+    return EZ_FAILURE;
+  }
+
+  reader >> m_uiChunkSize;
+  reader >> uiNumChunks;
+
+  const ezUInt64 uiHeaderSize = sizeof(ezUInt32) * 2 + (static_cast<ezUInt64>(uiNumChunks) + 1) * sizeof(ezUInt64);
+  const ezUInt64 uiNumRequiredChunks = m_uiChunkSize > 0 ? (uiUncompressedDataSize + m_uiChunkSize - 1) / m_uiChunkSize : 0;
+
+  if (m_uiChunkSize == 0 || uiNumChunks != uiNumRequiredChunks || uiHeaderSize > uiStoredDataSize)
+  {
+    ezLog::Error("Archive is corrupt. Invalid chunk table.");
+    return EZ_FAILURE;
+  }
+
+  m_ChunkOffsets.SetCountUninitialized(uiNumChunks + 1);
+
+  for (ezUInt64& uiOffset : m_ChunkOffsets)
+  {
+    reader >> uiOffset;
+  }
+
+  // the chunks must be stored one after another, behind the table
+  ezUInt64 uiPrevOffset = uiHeaderSize;
+  for (ezUInt64 uiOffset : m_ChunkOffsets)
+  {
+    if (uiOffset < uiPrevOffset || uiOffset > uiStoredDataSize)
+    {
+      ezLog::Error("Archive is corrupt. Invalid chunk offsets.");
+      m_ChunkOffsets.Clear();
+      return EZ_FAILURE;
+    }
+
+    uiPrevOffset = uiOffset;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezUInt64 ezArchiveChunkedEntryReader::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
+{
+  uiBytesToRead = ezMath::Min(uiBytesToRead, m_uiUncompressedDataSize - m_uiReadPosition);
+
+  if (pReadBuffer == nullptr)
+  {
+    m_uiReadPosition += uiBytesToRead;
+    return uiBytesToRead;
+  }
+
+  ezUInt8* pBuffer = static_cast<ezUInt8*>(pReadBuffer);
+  ezUInt64 uiBytesRead = 0;
+
+  while (uiBytesRead < uiBytesToRead)
+  {
+    const ezUInt32 uiChunk = static_cast<ezUInt32>(m_uiReadPosition / m_uiChunkSize);
+    const ezUInt64 uiOffsetInChunk = m_uiReadPosition % m_uiChunkSize;
+    const ezUInt64 uiRemaining = uiBytesToRead - uiBytesRead;
+
+    if (uiOffsetInChunk == 0 && uiChunk != m_uiCachedChunk && uiRemaining >= GetChunkUncompressedSize(uiChunk))
+    {
+      // whole chunks are decompressed directly into the target buffer
+      const ezUInt32 uiNumChunks = m_ChunkOffsets.GetCount() - 1;
+
+      ezUInt32 uiNumWholeChunks = 1;
+      ezUInt64 uiWholeChunkBytes = GetChunkUncompressedSize(uiChunk);
+
+      while (uiChunk + uiNumWholeChunks < uiNumChunks && uiWholeChunkBytes + GetChunkUncompressedSize(uiChunk + uiNumWholeChunks) <= uiRemaining)
+      {
+        uiWholeChunkBytes += GetChunkUncompressedSize(uiChunk + uiNumWholeChunks);
+        ++uiNumWholeChunks;
+      }
+
+      if (DecompressChunks(uiChunk, uiNumWholeChunks, pBuffer + uiBytesRead).Failed())
+        break;
+
+      uiBytesRead += uiWholeChunkBytes;
+      m_uiReadPosition += uiWholeChunkBytes;
+      continue;
+    }
+
+    if (uiChunk != m_uiCachedChunk)
+    {
+      m_ChunkCache.SetCountUninitialized(static_cast<ezUInt32>(GetChunkUncompressedSize(uiChunk)));
+
+      if (DecompressChunk(uiChunk, m_ChunkCache.GetData(), GetDecompressionContext()).Failed())
+      {
+        m_uiCachedChunk = ezInvalidIndex;
+        break;
+      }
+
+      m_uiCachedChunk = uiChunk;
+    }
+
+    const ezUInt64 uiBytesFromCache = ezMath::Min<ezUInt64>(uiRemaining, m_ChunkCache.GetCount() - uiOffsetInChunk);
+    ezMemoryUtils::Copy(pBuffer + uiBytesRead, m_ChunkCache.GetData() + uiOffsetInChunk, static_cast<size_t>(uiBytesFromCache));
+
+    uiBytesRead += uiBytesFromCache;
+    m_uiReadPosition += uiBytesFromCache;
+  }
+
+  return uiBytesRead;
+}
+
+ezUInt64 ezArchiveChunkedEntryReader::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  return ReadBytes(nullptr, uiBytesToSkip);
+}
+
+void ezArchiveChunkedEntryReader::SetReadPosition(ezUInt64 uiReadPosition)
+{
+  EZ_ASSERT_DEV(uiReadPosition <= m_uiUncompressedDataSize, "Read position {} is outside the entry data (size {})", uiReadPosition, m_uiUncompressedDataSize);
+
+  m_uiReadPosition = uiReadPosition;
+}
+
+ezUInt64 ezArchiveChunkedEntryReader::GetChunkUncompressedSize(ezUInt32 uiChunk) const
+{
+  const ezUInt64 uiChunkStart = static_cast<ezUInt64>(uiChunk) * m_uiChunkSize;
+  return ezMath::Min<ezUInt64>(m_uiChunkSize, m_uiUncompressedDataSize - uiChunkStart);
+}
+
+ezResult ezArchiveChunkedEntryReader::DecompressChunk(ezUInt32 uiChunk, void* pTarget, void* pContext) const
+{
+  const ezUInt64 uiUncompressedSize = GetChunkUncompressedSize(uiChunk);
+  const ezUInt64 uiStart = m_ChunkOffsets[uiChunk];
+  const ezUInt64 uiEnd = m_ChunkOffsets[uiChunk + 1];
+
+  const size_t res = ZSTD_decompressDCtx(reinterpret_cast<ZSTD_DCtx*>(pContext), pTarget, static_cast<size_t>(uiUncompressedSize), m_pStoredData + uiStart, static_cast<size_t>(uiEnd - uiStart));
+
+  if (ZSTD_isError(res) || res != uiUncompressedSize)
+  {
+    ezLog::Error("Decompressing chunk {} of an archive entry failed: '{}'", uiChunk, ZSTD_isError(res) ? ZSTD_getErrorName(res) : "size mismatch");
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezArchiveChunkedEntryReader::DecompressChunks(ezUInt32 uiFirstChunk, ezUInt32 uiNumChunks, ezUInt8* pTarget)
+{
+  if (uiNumChunks == 1)
+  {
+    return DecompressChunk(uiFirstChunk, pTarget, GetDecompressionContext());
+  }
+
+  ezAtomicInteger32 iNumFailed;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumChunks,
+    [this, uiFirstChunk, pTarget, &iNumFailed](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      // the contexts are not thread-safe, so every task uses its own
+      ZSTD_DCtx* pContext = ZSTD_createDCtx();
+
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        if (DecompressChunk(uiFirstChunk + i, pTarget + static_cast<ezUInt64>(i) * m_uiChunkSize, pContext).Failed())
+        {
+          iNumFailed.Increment();
+        }
+      }
+
+      ZSTD_freeDCtx(pContext);
+    },
+    "DecompressArchiveChunks");
+
+  return iNumFailed == 0 ? EZ_SUCCESS : EZ_FAILURE;
+}
+
+void* ezArchiveChunkedEntryReader::GetDecompressionContext()
+{
+  if (m_pDecompressionContext == nullptr)
+  {
+    m_pDecompressionContext = ZSTD_createDCtx();
+  }
+
+  return m_pDecompressionContext;
+}
+
+ezResult ezArchiveChunkedEntryReader::WriteChunkedData(ezStreamWriter& stream, ezStreamReader& source, ezUInt64 uiSourceSize, ezUInt32 uiChunkSize, ezUInt64& out_uiWrittenBytes, ezDelegate<bool(ezUInt64, ezUInt64)> progress)
+{
+  EZ_ASSERT_DEV(uiChunkSize > 0, "Invalid chunk size");
+
+  out_uiWrittenBytes = 0;
+
+  const ezUInt64 uiNumChunks64 = (uiSourceSize + uiChunkSize - 1) / uiChunkSize;
+  if (uiNumChunks64 >= ezInvalidIndex)
+  {
+    ezLog::Error("Too many chunks, use a larger chunk size.");
+    return EZ_FAILURE;
+  }
+
+  const ezUInt32 uiNumChunks = static_cast<ezUInt32>(uiNumChunks64);
+
+  // only a limited amount of chunks is read at a time, to bound the amount of uncompressed data in memory
+  const ezUInt32 uiMaxBatchBytes = 256 * 1024 * 1024;
+  const ezUInt32 uiNumWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1;
+  const ezUInt32 uiBatchSize = ezMath::Clamp(uiMaxBatchBytes / uiChunkSize, 1u, uiNumWorkers * 4);
+
+  ezDynamicArray<ezDynamicArray<ezUInt8>> compressedChunks;
+  compressedChunks.SetCount(uiNumChunks);
+
+  ezDynamicArray<ezUInt8> uncompressed;
+  uncompressed.SetCountUninitialized(static_cast<ezUInt32>(ezMath::Min<ezUInt64>(static_cast<ezUInt64>(uiBatchSize) * uiChunkSize, uiSourceSize)));
+
+  ezUInt64 uiBytesRead = 0;
+  ezAtomicInteger32 iNumFailedChunks;
+
+  for (ezUInt32 uiFirstChunk = 0; uiFirstChunk < uiNumChunks; uiFirstChunk += uiBatchSize)
+  {
+    const ezUInt32 uiBatchChunks = ezMath::Min(uiBatchSize, uiNumChunks - uiFirstChunk);
+    const ezUInt64 uiBatchBytes = ezMath::Min<ezUInt64>(static_cast<ezUInt64>(uiBatchChunks) * uiChunkSize, uiSourceSize - uiBytesRead);
+
+    if (source.ReadBytes(uncompressed.GetData(), uiBatchBytes) != uiBatchBytes)
+    {
+      ezLog::Error("Could not read the data that should be compressed.");
+      return EZ_FAILURE;
+    }
+
+    uiBytesRead += uiBatchBytes;
+
+    ezDynamicArray<ezUInt8>* pCompressedChunks = compressedChunks.GetData() + uiFirstChunk;
+    const ezUInt8* pUncompressed = uncompressed.GetData();
+    ezAtomicInteger32* pNumFailedChunks = &iNumFailedChunks;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiBatchChunks,
+      [pCompressedChunks, pUncompressed, pNumFailedChunks, uiChunkSize, uiBatchBytes](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        ZSTD_CCtx* pContext = ZSTD_createCCtx();
+
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          const ezUInt64 uiOffset = static_cast<ezUInt64>(i) * uiChunkSize;
+          const size_t uiSize = static_cast<size_t>(ezMath::Min<ezUInt64>(uiChunkSize, uiBatchBytes - uiOffset));
+
+          ezDynamicArray<ezUInt8>& compressed = pCompressedChunks[i];
+          compressed.SetCountUninitialized(static_cast<ezUInt32>(ZSTD_compressBound(uiSize)));
+
+          const size_t res = ZSTD_compressCCtx(pContext, compressed.GetData(), compressed.GetCount(), pUncompressed + uiOffset, uiSize, ezCompressedStreamWriterZstd::Compression::Default);
+          if (ZSTD_isError(res))
+          {
+            ezLog::Error("Compressing an archive chunk failed: '{0}'", ZSTD_getErrorName(res));
+            pNumFailedChunks->Increment();
+            compressed.Clear();
+            continue;
+          }
+
+          compressed.SetCount(static_cast<ezUInt32>(res));
+        }
+
+        ZSTD_freeCCtx(pContext);
+      },
+      "CompressArchiveChunks");
+
+    if (iNumFailedChunks > 0)
+      return EZ_FAILURE;
+
+    if (progress.IsValid() && !progress(uiBytesRead, uiSourceSize))
+      return EZ_FAILURE;
+  }
+
+  // seek table
+  stream << uiChunkSize;
+  stream << uiNumChunks;
+
+  ezUInt64 uiOffset = sizeof(ezUInt32) * 2 + (static_cast<ezUInt64>(uiNumChunks) + 1) * sizeof(ezUInt64);
+
+  for (const auto& compressed : compressedChunks)
+  {
+    stream << uiOffset;
+    uiOffset += compressed.GetCount();
+  }
+
+  stream << uiOffset;
+
+  for (const auto& compressed : compressedChunks)
+  {
+    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(compressed.GetData(), compressed.GetCount()));
+  }
+
+  out_uiWrittenBytes = uiOffset;
+  return EZ_SUCCESS;
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Archive_Implementation_ArchiveChunkedEntryReader);
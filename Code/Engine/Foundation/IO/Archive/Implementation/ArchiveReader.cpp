@@ -1,5 +1,6 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/IO/Archive/ArchiveChunkedEntryReader.h>
 #include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 
@@ -85,6 +86,15 @@ ezResult ezArchiveReader::OpenArchive(const char* szPath)
     }
   }
 
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  m_pCompressionDictionary.Clear();
+
+  if (!m_ArchiveTOC.m_CompressionDictionary.IsEmpty())
+  {
+    m_pCompressionDictionary = EZ_DEFAULT_NEW(ezCompressionDictionaryZstd, m_ArchiveTOC.m_CompressionDictionary);
+  }
+#  endif
+
   return EZ_SUCCESS;
 #else
   EZ_REPORT_FAILURE("Memory mapped files are unsupported on this platform.");
@@ -121,9 +131,64 @@ void ezArchiveReader::ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawM
   ezArchiveUtils::ConfigureRawMemoryStreamReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart, memReader);
 }
 
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+ezResult ezArchiveReader::ConfigureChunkedEntryReader(ezUInt32 uiEntryIdx, ezArchiveChunkedEntryReader& reader) const
+{
+  const ezArchiveEntry& entry = m_ArchiveTOC.m_Entries[uiEntryIdx];
+
+  if (entry.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd_chunked)
+    return EZ_FAILURE;
+
+  return reader.Configure(ezMemoryUtils::AddByteOffset(m_pDataStart, static_cast<ptrdiff_t>(entry.m_uiDataStartOffset)), entry.m_uiStoredDataSize, entry.m_uiUncompressedDataSize);
+}
+#endif
+
 ezUniquePtr<ezStreamReader> ezArchiveReader::CreateEntryReader(ezUInt32 uiEntryIdx) const
 {
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  return ezArchiveUtils::CreateEntryReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart, m_pCompressionDictionary.Borrow());
+#else
   return ezArchiveUtils::CreateEntryReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart);
+#endif
+}
+
+ezUInt64 ezArchiveReader::ReadEntryData(ezUInt32 uiEntryIdx, ezUInt64 uiOffset, void* pBuffer, ezUInt64 uiBytes) const
+{
+  ezUniquePtr<ezStreamReader> pReader = CreateEntryReader(uiEntryIdx);
+
+  if (pReader == nullptr)
+    return 0;
+
+  // the chunked reader skips without decompressing anything
+  if (pReader->SkipBytes(uiOffset) != uiOffset)
+    return 0;
+
+  return pReader->ReadBytes(pBuffer, uiBytes);
+}
+
+ezArrayPtr<const ezUInt8> ezArchiveReader::GetEntryDataView(ezUInt32 uiEntryIdx) const
+{
+  const ezArchiveEntry& entry = m_ArchiveTOC.m_Entries[uiEntryIdx];
+
+  if (entry.m_CompressionMode != ezArchiveCompressionMode::Uncompressed)
+    return {};
+
+  // ezArrayPtr can't address that much
+  if (entry.m_uiStoredDataSize > ezMath::MaxValue<ezUInt32>())
+    return {};
+
+  const ezUInt8* pData = static_cast<const ezUInt8*>(ezMemoryUtils::AddByteOffset(m_pDataStart, static_cast<ptrdiff_t>(entry.m_uiDataStartOffset)));
+  return ezArrayPtr<const ezUInt8>(pData, static_cast<ezUInt32>(entry.m_uiStoredDataSize));
+}
+
+void ezArchiveReader::PrefetchEntryData(ezUInt32 uiEntryIdx) const
+{
+  const ezArchiveEntry& entry = m_ArchiveTOC.m_Entries[uiEntryIdx];
+
+  // m_pDataStart points somewhere into the memory mapped file, depending on the archive type
+  const ezUInt64 uiDataStartInFile = static_cast<const ezUInt8*>(m_pDataStart) - static_cast<const ezUInt8*>(m_MemFile.GetReadPointer());
+
+  m_MemFile.Prefetch(uiDataStartInFile + entry.m_uiDataStartOffset, entry.m_uiStoredDataSize);
 }
 
 ezResult ezArchiveReader::ExtractFile(ezUInt32 uiEntryIdx, const char* szTargetFolder) const
@@ -133,6 +198,9 @@ ezResult ezArchiveReader::ExtractFile(ezUInt32 uiEntryIdx, const char* szTargetF
 
   ezUniquePtr<ezStreamReader> pReader = CreateEntryReader(uiEntryIdx);
 
+  if (pReader == nullptr)
+    return EZ_FAILURE;
+
   ezStringBuilder sOutputFile = szTargetFolder;
   sOutputFile.AppendPath(szFilePath);
 
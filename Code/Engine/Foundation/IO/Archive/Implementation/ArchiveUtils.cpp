@@ -2,7 +2,9 @@
 
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 
+#include <Foundation/IO/Archive/ArchiveChunkedEntryReader.h>
 #include <Foundation/IO/CompressedStreamZlib.h>
+#include <Foundation/IO/CompressionDictionaryZstd.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/MemoryMappedFile.h>
@@ -37,11 +39,13 @@ ezResult ezArchiveUtils::WriteHeader(ezStreamWriter& stream)
   const char* szTag = "EZARCHIVE";
   EZ_SUCCEED_OR_RETURN(stream.WriteBytes(szTag, 10));
 
-  const ezUInt8 uiArchiveVersion = 4;
+  const ezUInt8 uiArchiveVersion = 6;
 
   // Version 2: Added end-of-file marker for file corruption (cutoff) detection
   // Version 3: HashedStrings changed from MurmurHash to xxHash
   // Version 4: use 64 Bit string hashes
+  // Version 5: added ezArchiveCompressionMode::Compressed_zstd_chunked
+  // Version 6: added the compression dictionary to the TOC
   stream << uiArchiveVersion;
 
   const ezUInt8 uiPadding[5] = {0, 0, 0, 0, 0};
@@ -62,7 +66,7 @@ ezResult ezArchiveUtils::ReadHeader(ezStreamReader& stream, ezUInt8& out_uiVersi
   out_uiVersion = 0;
   stream >> out_uiVersion;
 
-  if (out_uiVersion != 1 && out_uiVersion != 2 && out_uiVersion != 3 && out_uiVersion != 4)
+  if (out_uiVersion < 1 || out_uiVersion > 6)
   {
     ezLog::Error("Unsupported archive version '{}'.", out_uiVersion);
     return EZ_FAILURE;
@@ -86,7 +90,7 @@ ezResult ezArchiveUtils::ReadHeader(ezStreamReader& stream, ezUInt8& out_uiVersi
   return EZ_SUCCESS;
 }
 
-ezResult ezArchiveUtils::WriteEntry(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset, ezArchiveCompressionMode compression, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition, FileWriteProgressCallback progress /*= FileWriteProgressCallback()*/)
+ezResult ezArchiveUtils::WriteEntry(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset, ezArchiveCompressionMode compression, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition, FileWriteProgressCallback progress /*= FileWriteProgressCallback()*/, ezUInt32 uiChunkSize /*= DefaultChunkSize*/, const ezCompressionDictionaryZstd* pDictionary /*= nullptr*/)
 {
   ezFileReader file;
   EZ_SUCCEED_OR_RETURN(file.Open(szAbsSourcePath, 1024 * 1024));
@@ -99,6 +103,21 @@ ezResult ezArchiveUtils::WriteEntry(ezStreamWriter& stream, const char* szAbsSou
   tocEntry.m_uiDataStartOffset = inout_uiCurrentStreamPosition;
   tocEntry.m_uiUncompressedDataSize = 0;
 
+  if (compression == ezArchiveCompressionMode::Compressed_zstd_chunked)
+  {
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    tocEntry.m_CompressionMode = compression;
+    tocEntry.m_uiUncompressedDataSize = uiMaxBytes;
+
+    EZ_SUCCEED_OR_RETURN(ezArchiveChunkedEntryReader::WriteChunkedData(stream, file, uiMaxBytes, uiChunkSize, tocEntry.m_uiStoredDataSize, progress));
+
+    inout_uiCurrentStreamPosition += tocEntry.m_uiStoredDataSize;
+    return EZ_SUCCESS;
+#else
+    compression = ezArchiveCompressionMode::Uncompressed;
+#endif
+  }
+
   ezStreamWriter* pWriter = &stream;
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -119,6 +138,16 @@ ezResult ezArchiveUtils::WriteEntry(ezStreamWriter& stream, const char* szAbsSou
 #endif
       break;
 
+    case ezArchiveCompressionMode::Compressed_zstd_dictionary:
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+      EZ_ASSERT_DEV(pDictionary != nullptr, "Compressing an entry with a dictionary requires the dictionary");
+      zstdWriter.SetOutputStream(&stream, ezCompressedStreamWriterZstd::Compression::Default, 4, pDictionary);
+      pWriter = &zstdWriter;
+#else
+      compression = ezArchiveCompressionMode::Uncompressed;
+#endif
+      break;
+
     default:
       EZ_ASSERT_NOT_IMPLEMENTED;
   }
@@ -149,6 +178,7 @@ ezResult ezArchiveUtils::WriteEntry(ezStreamWriter& stream, const char* szAbsSou
   {
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
     case ezArchiveCompressionMode::Compressed_zstd:
+    case ezArchiveCompressionMode::Compressed_zstd_dictionary:
       EZ_SUCCEED_OR_RETURN(zstdWriter.FinishCompressedStream());
       tocEntry.m_uiStoredDataSize = zstdWriter.GetWrittenBytes();
       break;
@@ -165,7 +195,7 @@ ezResult ezArchiveUtils::WriteEntry(ezStreamWriter& stream, const char* szAbsSou
   return EZ_SUCCESS;
 }
 
-ezResult ezArchiveUtils::WriteEntryOptimal(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset, ezArchiveCompressionMode compression, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition, FileWriteProgressCallback progress /*= FileWriteProgressCallback()*/)
+ezResult ezArchiveUtils::WriteEntryOptimal(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset, ezArchiveCompressionMode compression, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition, FileWriteProgressCallback progress /*= FileWriteProgressCallback()*/, ezUInt32 uiChunkSize /*= DefaultChunkSize*/, const ezCompressionDictionaryZstd* pDictionary /*= nullptr*/)
 {
   if (compression == ezArchiveCompressionMode::Uncompressed)
   {
@@ -177,7 +207,7 @@ ezResult ezArchiveUtils::WriteEntryOptimal(ezStreamWriter& stream, const char* s
     ezMemoryStreamWriter writer(&storage);
 
     ezUInt64 streamPos = inout_uiCurrentStreamPosition;
-    EZ_SUCCEED_OR_RETURN(WriteEntry(writer, szAbsSourcePath, uiPathStringOffset, compression, tocEntry, streamPos, progress));
+    EZ_SUCCEED_OR_RETURN(WriteEntry(writer, szAbsSourcePath, uiPathStringOffset, compression, tocEntry, streamPos, progress, uiChunkSize, pDictionary));
 
     if (tocEntry.m_uiStoredDataSize * 12 >= tocEntry.m_uiUncompressedDataSize * 10)
     {
@@ -214,7 +244,7 @@ public:
 
 #endif
 
-ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData)
+ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData, const ezCompressionDictionaryZstd* pDictionary /*= nullptr*/)
 {
   ezUniquePtr<ezStreamReader> reader;
 
@@ -237,6 +267,32 @@ ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEnt
       pRawReader->SetInputStream(&pRawReader->m_Source);
       break;
     }
+
+    case ezArchiveCompressionMode::Compressed_zstd_dictionary:
+    {
+      if (pDictionary == nullptr)
+      {
+        ezLog::Error("Archive entry was compressed with a dictionary, but the archive has none.");
+        break;
+      }
+
+      reader = EZ_DEFAULT_NEW(ezCompressedStreamReaderZstdWithSource);
+      ezCompressedStreamReaderZstdWithSource* pRawReader = static_cast<ezCompressedStreamReaderZstdWithSource*>(reader.Borrow());
+      ConfigureRawMemoryStreamReader(entry, pStartOfArchiveData, pRawReader->m_Source);
+      pRawReader->SetInputStream(&pRawReader->m_Source, pDictionary);
+      break;
+    }
+
+    case ezArchiveCompressionMode::Compressed_zstd_chunked:
+    {
+      reader = EZ_DEFAULT_NEW(ezArchiveChunkedEntryReader);
+      ezArchiveChunkedEntryReader* pChunkedReader = static_cast<ezArchiveChunkedEntryReader*>(reader.Borrow());
+      if (pChunkedReader->Configure(ezMemoryUtils::AddByteOffset(pStartOfArchiveData, static_cast<ptrdiff_t>(entry.m_uiDataStartOffset)), entry.m_uiStoredDataSize, entry.m_uiUncompressedDataSize).Failed())
+      {
+        reader.Clear();
+      }
+      break;
+    }
 #endif
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
     case ezArchiveCompressionMode::Compressed_zip:
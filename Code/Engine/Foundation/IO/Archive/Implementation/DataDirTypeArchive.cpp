@@ -73,16 +73,49 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char*
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
       case ezArchiveCompressionMode::Compressed_zstd:
+      case ezArchiveCompressionMode::Compressed_zstd_dictionary:
       {
+        if (pEntry->m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_dictionary && m_ArchiveReader.GetCompressionDictionary() == nullptr)
+        {
+          ezLog::Error("Archive is corrupt. '{}' was compressed with a dictionary, but the archive has none.", sArchivePath);
+          return nullptr;
+        }
+
+        ArchiveReaderZstd* pZstdReader = nullptr;
+
         if (!m_FreeReadersZstd.IsEmpty())
         {
-          pReader = m_FreeReadersZstd.PeekBack();
+          pZstdReader = m_FreeReadersZstd.PeekBack();
           m_FreeReadersZstd.PopBack();
         }
         else
         {
           m_ReadersZstd.PushBack(EZ_DEFAULT_NEW(ArchiveReaderZstd, 1));
-          pReader = m_ReadersZstd.PeekBack().Borrow();
+          pZstdReader = m_ReadersZstd.PeekBack().Borrow();
+        }
+
+        pZstdReader->m_pDictionary = nullptr;
+
+        if (pEntry->m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_dictionary)
+        {
+          pZstdReader->m_pDictionary = m_ArchiveReader.GetCompressionDictionary();
+        }
+
+        pReader = pZstdReader;
+        break;
+      }
+
+      case ezArchiveCompressionMode::Compressed_zstd_chunked:
+      {
+        if (!m_FreeReadersZstdChunked.IsEmpty())
+        {
+          pReader = m_FreeReadersZstdChunked.PeekBack();
+          m_FreeReadersZstdChunked.PopBack();
+        }
+        else
+        {
+          m_ReadersZstdChunked.PushBack(EZ_DEFAULT_NEW(ArchiveReaderZstdChunked, 3));
+          pReader = m_ReadersZstdChunked.PeekBack().Borrow();
         }
         break;
       }
@@ -112,12 +145,16 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char*
 
   pReader->m_uiUncompressedSize = pEntry->m_uiUncompressedDataSize;
   pReader->m_uiCompressedSize = pEntry->m_uiStoredDataSize;
+  pReader->m_uiDataStartOffset = pEntry->m_uiDataStartOffset;
+  pReader->m_uiEntryIndex = uiEntryIndex;
+  pReader->m_MappedContent = m_ArchiveReader.GetEntryDataView(uiEntryIndex);
 
   m_ArchiveReader.ConfigureRawMemoryStreamReader(uiEntryIndex, pReader->m_MemStreamReader);
 
   if (pReader->Open(sArchivePath, this, FileShareMode).Failed())
   {
-    EZ_DEFAULT_DELETE(pReader);
+    // the reader is owned by one of the pools, just make it available again
+    OnReaderWriterClose(pReader);
     return nullptr;
   }
 
@@ -240,6 +277,12 @@ void ezDataDirectory::ArchiveType::OnReaderWriterClose(ezDataDirectoryReaderWrit
     m_FreeReadersZstd.PushBack(static_cast<ArchiveReaderZstd*>(pClosed));
     return;
   }
+
+  if (pClosed->GetDataDirUserData() == 3)
+  {
+    m_FreeReadersZstdChunked.PushBack(static_cast<ArchiveReaderZstdChunked*>(pClosed));
+    return;
+  }
 #endif
 
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
@@ -272,6 +315,11 @@ ezUInt64 ezDataDirectory::ArchiveReaderUncompressed::GetFileSize() const
   return m_uiUncompressedSize;
 }
 
+void ezDataDirectory::ArchiveReaderUncompressed::Prefetch()
+{
+  static_cast<const ArchiveType*>(GetDataDirectory())->m_ArchiveReader.PrefetchEntryData(m_uiEntryIndex);
+}
+
 ezResult ezDataDirectory::ArchiveReaderUncompressed::InternalOpen(ezFileShareMode::Enum FileShareMode)
 {
   EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
@@ -305,10 +353,31 @@ ezResult ezDataDirectory::ArchiveReaderZstd::InternalOpen(ezFileShareMode::Enum
 {
   EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
 
-  m_CompressedStreamReader.SetInputStream(&m_MemStreamReader);
+  m_CompressedStreamReader.SetInputStream(&m_MemStreamReader, m_pDictionary);
   return EZ_SUCCESS;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+ezDataDirectory::ArchiveReaderZstdChunked::ArchiveReaderZstdChunked(ezInt32 iDataDirUserData)
+  : ArchiveReaderUncompressed(iDataDirUserData)
+{
+}
+
+ezDataDirectory::ArchiveReaderZstdChunked::~ArchiveReaderZstdChunked() = default;
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdChunked::Read(void* pBuffer, ezUInt64 uiBytes)
+{
+  return m_ChunkedReader.ReadBytes(pBuffer, uiBytes);
+}
+
+ezResult ezDataDirectory::ArchiveReaderZstdChunked::InternalOpen(ezFileShareMode::Enum FileShareMode)
+{
+  EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
+
+  return static_cast<const ArchiveType*>(GetDataDirectory())->m_ArchiveReader.ConfigureChunkedEntryReader(m_uiEntryIndex, m_ChunkedReader);
+}
+
 #endif
 
 //////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+/// \brief A zstd dictionary that can be shared by many ezCompressedStreamWriterZstd and ezCompressedStreamReaderZstd instances.
+///
+/// Small pieces of data (e.g. serialized assets) compress badly on their own, because the compressor has not seen enough data yet
+/// to find repetitions. A dictionary that contains data which is typical for such content primes the compressor and the decompressor,
+/// which results in much better compression ratios and also in faster decompression.
+///
+/// Data that was compressed with a dictionary can only be decompressed with exactly the same dictionary.
+/// The dictionary is immutable once it is created and can be used from multiple threads at the same time.
+class EZ_FOUNDATION_DLL ezCompressionDictionaryZstd
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezCompressionDictionaryZstd);
+
+public:
+  /// \brief Creates the dictionary from previously trained (or otherwise created) dictionary content.
+  ///
+  /// The compression level is baked into the dictionary and overrides the level that is passed to
+  /// ezCompressedStreamWriterZstd::SetOutputStream().
+  ezCompressionDictionaryZstd(ezArrayPtr<const ezUInt8> dictionary, ezCompressedStreamWriterZstd::Compression Ratio = ezCompressedStreamWriterZstd::Compression::Default); // [tested]
+  ~ezCompressionDictionaryZstd();
+
+  /// \brief Returns the content of the dictionary.
+  ezArrayPtr<const ezUInt8> GetData() const { return m_Data; }
+
+  /// \brief Builds a dictionary of up to \a uiMaxDictionarySize bytes out of the given samples.
+  ///
+  /// The samples should be typical representatives of the data that is going to be compressed with the dictionary.
+  /// The dictionary is assembled from the segments of the samples that share the most content with other samples
+  /// (similar to the 'cover' algorithm of the zstd dictionary builder). The segments that are most useful are placed at the end,
+  /// since zstd can reference those with the smallest offsets.
+  ///
+  /// Returns EZ_FAILURE, if there is not enough sample data to build a useful dictionary.
+  static ezResult Train(ezArrayPtr<const ezArrayPtr<const ezUInt8>> samples, ezUInt32 uiMaxDictionarySize, ezDynamicArray<ezUInt8>& out_Dictionary); // [tested]
+
+private:
+  friend class ezCompressedStreamReaderZstd;
+  friend class ezCompressedStreamWriterZstd;
+
+  ezDynamicArray<ezUInt8> m_Data;
+  /*ZSTD_CDict*/ void* m_pCDict = nullptr;
+  /*ZSTD_DDict*/ void* m_pDDict = nullptr;
+};
+
+#endif // BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+/// \brief Reads the content of many files at once in the background, through the ezFileSystem.
+///
+/// Add all files with AddFile() and then call Submit(). Submit() opens all files right away, the actual reading is done by tasks.
+/// Files from data directories that prefer sequential reads, e.g. archives, are coalesced: all files from such a data directory are read
+/// by one task, in the order in which they are stored. All other files are read by separate tasks, so that many reads are in flight at
+/// the same time.
+///
+/// Submit() returns the task group that does the reading. It can be used as a dependency for tasks that process the data
+/// (see ezTaskSystem::AddTaskGroupDependency()), or it can be waited on with WaitForCompletion(). The results must not be accessed
+/// before all reads are finished.
+///
+/// The batch must stay alive until all reads are finished, the destructor waits for them.
+class EZ_FOUNDATION_DLL ezAsyncFileReadBatch
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezAsyncFileReadBatch);
+
+public:
+  ezAsyncFileReadBatch();
+  ~ezAsyncFileReadBatch();
+
+  /// \brief Adds a file whose whole content should be read. Returns the index with which the result can be retrieved later.
+  ///
+  /// szFile can be anything that ezFileReader::Open() accepts.
+  ezUInt32 AddFile(const char* szFile); // [tested]
+
+  /// \brief Returns how many files have been added.
+  ezUInt32 GetNumFiles() const { return m_Requests.GetCount(); }
+
+  /// \brief Opens all added files and starts reading them. Returns the task group that executes the reads.
+  ///
+  /// Note that all tasks of the group run with the same priority. ezTaskPriority::FileAccess tasks are executed one after another by the
+  /// single file access thread, so the default priority is ezTaskPriority::LongRunning.
+  /// \a onFinished is called once all reads are done, e.g. to kick off processing of the data.
+  ezTaskGroupID Submit(ezTaskPriority::Enum priority = ezTaskPriority::LongRunning, ezOnTaskGroupFinishedCallback onFinished = {}); // [tested]
+
+  /// \brief Returns whether all reads are finished. Returns false, if Submit() has not been called yet.
+  bool IsFinished() const; // [tested]
+
+  /// \brief Blocks until all reads are finished. Other tasks are executed in the meantime.
+  void WaitForCompletion() const; // [tested]
+
+  /// \brief Returns EZ_FAILURE if the file could not be opened or not be read completely.
+  ezResult GetResult(ezUInt32 uiFile) const; // [tested]
+
+  /// \brief Returns the content of the file.
+  ezArrayPtr<const ezUInt8> GetData(ezUInt32 uiFile) const; // [tested]
+
+  /// \brief Returns the content of the file for modification, e.g. to move it into a different container.
+  ezDynamicArray<ezUInt8>& AccessData(ezUInt32 uiFile);
+
+  /// \brief Returns the absolute path of the file that was opened, including the data directory path.
+  const ezString& GetFilePathAbsolute(ezUInt32 uiFile) const; // [tested]
+
+private:
+  class ReadTask;
+
+  struct Request
+  {
+    ezString m_sFile;
+    ezString m_sAbsolutePath;
+    ezDataDirectoryReader* m_pReader = nullptr;
+    ezUInt64 m_uiStorageOffset = 0;
+    ezResult m_Result = EZ_FAILURE;
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  static void ReadFile(Request& request);
+
+  ezDynamicArray<Request> m_Requests;
+  ezDynamicArray<ezUInt32> m_ReadOrder;
+  ezTaskGroupID m_TaskGroup;
+  bool m_bSubmitted = false;
+};
@@ -245,6 +245,7 @@ public:
   static bool ResolveAssetRedirection(const char* szPathOrAssetGuid, ezStringBuilder& out_sRedirection);
 
 private:
+  friend class ezAsyncFileReadBatch;
   friend class ezDataDirectoryReaderWriterBase;
   friend class ezFileReaderBase;
   friend class ezFileWriterBase;
@@ -0,0 +1,186 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/FileSystem/AsyncFileReadBatch.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Profiling/Profiling.h>
+
+class ezAsyncFileReadBatch::ReadTask final : public ezTask
+{
+public:
+  ReadTask(ezAsyncFileReadBatch* pBatch, ezUInt32 uiFirstRead, ezUInt32 uiNumReads)
+    : m_pBatch(pBatch)
+    , m_uiFirstRead(uiFirstRead)
+    , m_uiNumReads(uiNumReads)
+  {
+    ConfigureTask("ezAsyncFileReadBatch", ezTaskNesting::Never);
+  }
+
+private:
+  virtual void Execute() override
+  {
+    for (ezUInt32 i = 0; i < m_uiNumReads; ++i)
+    {
+      ReadFile(m_pBatch->m_Requests[m_pBatch->m_ReadOrder[m_uiFirstRead + i]]);
+    }
+  }
+
+  ezAsyncFileReadBatch* m_pBatch;
+  ezUInt32 m_uiFirstRead;
+  ezUInt32 m_uiNumReads;
+};
+
+ezAsyncFileReadBatch::ezAsyncFileReadBatch() = default;
+
+ezAsyncFileReadBatch::~ezAsyncFileReadBatch()
+{
+  // the tasks reference the requests, so they must not outlive the batch
+  if (m_bSubmitted)
+  {
+    WaitForCompletion();
+  }
+}
+
+ezUInt32 ezAsyncFileReadBatch::AddFile(const char* szFile)
+{
+  EZ_ASSERT_DEV(!m_bSubmitted, "Files cannot be added after the batch has been submitted");
+
+  m_Requests.ExpandAndGetRef().m_sFile = szFile;
+  return m_Requests.GetCount() - 1;
+}
+
+ezTaskGroupID ezAsyncFileReadBatch::Submit(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback onFinished)
+{
+  EZ_ASSERT_DEV(!m_bSubmitted, "The batch has already been submitted");
+  m_bSubmitted = true;
+
+  EZ_PROFILE_SCOPE("ezAsyncFileReadBatch::Submit");
+
+  // Opening the files is cheap compared to reading them and tells us which data directory handles each file.
+  m_ReadOrder.Reserve(m_Requests.GetCount());
+
+  for (ezUInt32 i = 0; i < m_Requests.GetCount(); ++i)
+  {
+    Request& request = m_Requests[i];
+    request.m_pReader = ezFileSystem::GetFileReader(request.m_sFile, ezFileShareMode::SharedReads, true);
+
+    if (request.m_pReader == nullptr)
+      continue;
+
+    ezStringBuilder sAbsolutePath = request.m_pReader->GetDataDirectory()->GetRedirectedDataDirectoryPath();
+    sAbsolutePath.AppendPath(request.m_pReader->GetFilePath());
+    request.m_sAbsolutePath = sAbsolutePath;
+    request.m_uiStorageOffset = request.m_pReader->GetStorageOffset();
+
+    // lets the OS fetch the data while earlier files are still being read
+    request.m_pReader->Prefetch();
+
+    m_ReadOrder.PushBack(i);
+  }
+
+  auto GetCoalescingKey = [this](ezUInt32 uiRequest) -> const ezDataDirectoryType* {
+    const ezDataDirectoryType* pDataDir = m_Requests[uiRequest].m_pReader->GetDataDirectory();
+    return pDataDir->PrefersSequentialReads() ? pDataDir : nullptr;
+  };
+
+  // group the files of every coalesced data directory and sort them by their storage location
+  m_ReadOrder.Sort([&](ezUInt32 a, ezUInt32 b) {
+    const ezDataDirectoryType* pKeyA = GetCoalescingKey(a);
+    const ezDataDirectoryType* pKeyB = GetCoalescingKey(b);
+
+    if (pKeyA != pKeyB)
+      return pKeyA < pKeyB;
+
+    if (m_Requests[a].m_uiStorageOffset != m_Requests[b].m_uiStorageOffset)
+      return m_Requests[a].m_uiStorageOffset < m_Requests[b].m_uiStorageOffset;
+
+    return a < b;
+  });
+
+  m_TaskGroup = ezTaskSystem::CreateTaskGroup(priority, onFinished);
+
+  for (ezUInt32 uiFirst = 0; uiFirst < m_ReadOrder.GetCount();)
+  {
+    const ezDataDirectoryType* pKey = GetCoalescingKey(m_ReadOrder[uiFirst]);
+
+    ezUInt32 uiNumReads = 1;
+
+    if (pKey != nullptr)
+    {
+      while (uiFirst + uiNumReads < m_ReadOrder.GetCount() && GetCoalescingKey(m_ReadOrder[uiFirst + uiNumReads]) == pKey)
+      {
+        ++uiNumReads;
+      }
+    }
+
+    ezTaskSystem::AddTaskToGroup(m_TaskGroup, EZ_DEFAULT_NEW(ReadTask, this, uiFirst, uiNumReads));
+
+    uiFirst += uiNumReads;
+  }
+
+  ezTaskSystem::StartTaskGroup(m_TaskGroup);
+
+  return m_TaskGroup;
+}
+
+bool ezAsyncFileReadBatch::IsFinished() const
+{
+  return m_bSubmitted && ezTaskSystem::IsTaskGroupFinished(m_TaskGroup);
+}
+
+void ezAsyncFileReadBatch::WaitForCompletion() const
+{
+  EZ_ASSERT_DEV(m_bSubmitted, "The batch has not been submitted");
+
+  ezTaskSystem::WaitForGroup(m_TaskGroup);
+}
+
+ezResult ezAsyncFileReadBatch::GetResult(ezUInt32 uiFile) const
+{
+  EZ_ASSERT_DEBUG(IsFinished(), "The batch has not finished reading");
+  return m_Requests[uiFile].m_Result;
+}
+
+ezArrayPtr<const ezUInt8> ezAsyncFileReadBatch::GetData(ezUInt32 uiFile) const
+{
+  EZ_ASSERT_DEBUG(IsFinished(), "The batch has not finished reading");
+  return m_Requests[uiFile].m_Data;
+}
+
+ezDynamicArray<ezUInt8>& ezAsyncFileReadBatch::AccessData(ezUInt32 uiFile)
+{
+  EZ_ASSERT_DEBUG(IsFinished(), "The batch has not finished reading");
+  return m_Requests[uiFile].m_Data;
+}
+
+const ezString& ezAsyncFileReadBatch::GetFilePathAbsolute(ezUInt32 uiFile) const
+{
+  return m_Requests[uiFile].m_sAbsolutePath;
+}
+
+void ezAsyncFileReadBatch::ReadFile(Request& request)
+{
+  EZ_PROFILE_SCOPE("ReadFile");
+
+  ezDataDirectoryReader* pReader = request.m_pReader;
+  request.m_pReader = nullptr;
+
+  const ezUInt64 uiFileSize = pReader->GetFileSize();
+  request.m_Data.SetCountUninitialized(static_cast<ezUInt32>(uiFileSize));
+
+  ezUInt64 uiBytesRead = 0;
+  while (uiBytesRead < uiFileSize)
+  {
+    const ezUInt64 uiRead = pReader->Read(request.m_Data.GetData() + uiBytesRead, uiFileSize - uiBytesRead);
+    if (uiRead == 0)
+      break;
+
+    uiBytesRead += uiRead;
+  }
+
+  pReader->Close();
+
+  request.m_Data.SetCount(static_cast<ezUInt32>(uiBytesRead));
+  request.m_Result = uiBytesRead == uiFileSize ? EZ_SUCCESS : EZ_FAILURE;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_FileSystem_Implementation_AsyncFileReadBatch);
@@ -36,6 +36,12 @@ public:
   ///        reloading and reapplying of configurations, without dismounting and remounting the data directory.
   virtual void ReloadExternalConfigs(){};
 
+  /// \brief Returns true if reading many files from this data directory is faster when done one after another, in storage order.
+  ///
+  /// This is the case for data directories that pack all files into one container, e.g. archives.
+  /// ezAsyncFileReadBatch uses this to decide whether to coalesce reads. See ezDataDirectoryReader::GetStorageOffset().
+  virtual bool PrefersSequentialReads() const { return false; }
+
 protected:
   friend class ezFileSystem;
 
@@ -163,6 +169,20 @@ public:
   }
 
   virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) = 0;
+
+  /// \brief Returns where the file's data is located inside its data directory's storage, if that is meaningful.
+  ///
+  /// Only used to sort reads for data directories that return true from ezDataDirectoryType::PrefersSequentialReads().
+  virtual ezUInt64 GetStorageOffset() const { return 0; }
+
+  /// \brief If the entire file content is directly accessible in memory, e.g. an uncompressed file in a memory mapped archive, this returns
+  /// it without copying. Otherwise an invalid array (nullptr) is returned and the content has to be read with Read().
+  ///
+  /// The memory stays valid as long as the reader is open.
+  virtual ezArrayPtr<const ezUInt8> GetMappedContent() const { return {}; }
+
+  /// \brief Hints that the file content will be read soon, so that the data directory can start fetching it in the background.
+  virtual void Prefetch() {}
 };
 
 /// \brief A base class for writers that handle writing to a (virtual) file inside a data directory.
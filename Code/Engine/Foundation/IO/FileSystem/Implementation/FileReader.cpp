@@ -16,9 +16,10 @@ ezResult ezFileReader::Open(const char* szFile, ezUInt32 uiCacheSize /*= 1024 *
 
   m_Cache.SetCountUninitialized(uiCacheSize);
 
+  // the cache is filled on the first read, so nothing is copied for users that only access GetMappedContent()
   m_uiCacheReadPosition = 0;
-  m_uiBytesCached = m_pDataDirReader->Read(&m_Cache[0], m_Cache.GetCount());
-  m_bEOF = m_uiBytesCached > 0 ? false : true;
+  m_uiBytesCached = 0;
+  m_bEOF = false;
 
   return EZ_SUCCESS;
 }
@@ -59,7 +60,21 @@ ezUInt64 ezFileReader::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
     m_uiCacheReadPosition += uiChunkSize;
     uiBytesToRead -= uiChunkSize;
 
+    // large reads bypass the cache, which allows the data directory reader to fill the target buffer in one go
+    if (m_uiCacheReadPosition >= m_uiBytesCached && uiBytesToRead >= m_Cache.GetCount())
+    {
+      const ezUInt64 uiDirectRead = m_pDataDirReader->Read(&pBuffer[uiBufferPosition], uiBytesToRead);
+      uiBufferPosition += uiDirectRead;
+      uiBytesToRead -= uiDirectRead;
 
+      if (uiDirectRead == 0)
+      {
+        m_bEOF = true;
+        return uiBufferPosition;
+      }
+
+      continue;
+    }
 
     // if the cache is depleted, refill it
     // this will even be triggered if EXACTLY the amount of available bytes was read
@@ -36,6 +36,12 @@ public:
   /// \brief Returns the current total size of the file.
   ezUInt64 GetFileSize() const { return m_pDataDirReader->GetFileSize(); }
 
+  /// \brief Returns the entire file content without copying it, if the data directory has it in memory already (e.g. uncompressed files in
+  /// memory mapped archives). Returns an invalid array (nullptr) otherwise.
+  ///
+  /// The memory stays valid as long as the file is open. Reading through the stream interface is not affected by this.
+  ezArrayPtr<const ezUInt8> GetMappedContent() const { return m_pDataDirReader->GetMappedContent(); }
+
 protected:
   ezDataDirectoryReader* GetFileReader(const char* szFile, ezFileShareMode::Enum FileShareMode, bool bAllowFileEvents)
   {
@@ -1,6 +1,7 @@
 #include <Foundation/FoundationPCH.h>
 
 #include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/CompressionDictionaryZstd.h>
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
 
@@ -22,7 +23,7 @@ ezCompressedStreamReaderZstd::~ezCompressedStreamReaderZstd()
   }
 }
 
-void ezCompressedStreamReaderZstd::SetInputStream(ezStreamReader* pInputStream)
+void ezCompressedStreamReaderZstd::SetInputStream(ezStreamReader* pInputStream, const ezCompressionDictionaryZstd* pDictionary /*= nullptr*/)
 {
   m_InBuffer.pos = 0;
   m_InBuffer.size = 0;
@@ -35,6 +36,11 @@ void ezCompressedStreamReaderZstd::SetInputStream(ezStreamReader* pInputStream)
   }
 
   ZSTD_initDStream(reinterpret_cast<ZSTD_DStream*>(m_pZstdDStream));
+
+  if (pDictionary != nullptr)
+  {
+    ZSTD_DCtx_refDDict(reinterpret_cast<ZSTD_DStream*>(m_pZstdDStream), reinterpret_cast<const ZSTD_DDict*>(pDictionary->m_pDDict));
+  }
 }
 
 ezUInt64 ezCompressedStreamReaderZstd::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
@@ -158,7 +164,7 @@ ezCompressedStreamWriterZstd::~ezCompressedStreamWriterZstd()
   }
 }
 
-void ezCompressedStreamWriterZstd::SetOutputStream(ezStreamWriter* pOutputStream, Compression Ratio /*= Compression::Default*/, ezUInt32 uiCompressionCacheSizeKB /*= 4*/)
+void ezCompressedStreamWriterZstd::SetOutputStream(ezStreamWriter* pOutputStream, Compression Ratio /*= Compression::Default*/, ezUInt32 uiCompressionCacheSizeKB /*= 4*/, const ezCompressionDictionaryZstd* pDictionary /*= nullptr*/)
 {
   if (m_pOutputStream == pOutputStream)
     return;
@@ -181,6 +187,11 @@ void ezCompressedStreamWriterZstd::SetOutputStream(ezStreamWriter* pOutputStream
 
     ZSTD_initCStream(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), (int)Ratio);
 
+    if (pDictionary != nullptr)
+    {
+      ZSTD_CCtx_refCDict(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), reinterpret_cast<const ZSTD_CDict*>(pDictionary->m_pCDict));
+    }
+
     m_CompressedCache.SetCountUninitialized(ezMath::Max(1U, uiCompressionCacheSizeKB) * 1024);
 
     m_OutBuffer.dst = m_CompressedCache.GetData();
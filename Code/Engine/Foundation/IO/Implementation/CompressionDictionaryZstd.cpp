@@ -0,0 +1,222 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/CompressionDictionaryZstd.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+#  include <zstd/zstd.h>
+
+ezCompressionDictionaryZstd::ezCompressionDictionaryZstd(ezArrayPtr<const ezUInt8> dictionary, ezCompressedStreamWriterZstd::Compression Ratio)
+{
+  m_Data = dictionary;
+
+  m_pCDict = ZSTD_createCDict(m_Data.GetData(), m_Data.GetCount(), (int)Ratio);
+  m_pDDict = ZSTD_createDDict(m_Data.GetData(), m_Data.GetCount());
+
+  EZ_ASSERT_DEV(m_pCDict != nullptr && m_pDDict != nullptr, "Creating the zstd dictionary failed.");
+}
+
+ezCompressionDictionaryZstd::~ezCompressionDictionaryZstd()
+{
+  ZSTD_freeCDict(reinterpret_cast<ZSTD_CDict*>(m_pCDict));
+  ZSTD_freeDDict(reinterpret_cast<ZSTD_DDict*>(m_pDDict));
+}
+
+namespace
+{
+  // every dictionary segment is scored by the 8 byte sequences it contains
+  constexpr ezUInt32 s_uiDmerSize = 8;
+  constexpr ezUInt32 s_uiSegmentSize = 256;
+  constexpr ezUInt32 s_uiHashBits = 20;
+  constexpr ezUInt32 s_uiInvalidDmer = 0xFFFFFFFFu;
+
+  // more sample data improves the dictionary only marginally, but costs a lot of time
+  constexpr ezUInt32 s_uiMaxSampleDataPerDictionaryByte = 100;
+
+  EZ_ALWAYS_INLINE ezUInt32 HashDmer(const ezUInt8* pData)
+  {
+    ezUInt64 uiValue;
+    ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&uiValue), pData, sizeof(ezUInt64));
+    return static_cast<ezUInt32>((uiValue * 0x9E3779B97F4A7C15ull) >> (64 - s_uiHashBits));
+  }
+} // namespace
+
+ezResult ezCompressionDictionaryZstd::Train(ezArrayPtr<const ezArrayPtr<const ezUInt8>> samples, ezUInt32 uiMaxDictionarySize, ezDynamicArray<ezUInt8>& out_Dictionary)
+{
+  static_assert(s_uiDmerSize == sizeof(ezUInt64), "HashDmer() reads exactly one dmer");
+
+  out_Dictionary.Clear();
+
+  // concatenate the samples and compute the hash of every dmer that lies completely inside its sample
+  ezDynamicArray<ezUInt8> corpus;
+  ezDynamicArray<ezUInt32> dmerAtPos;
+
+  const ezUInt64 uiMaxCorpusSize = ezMath::Min<ezUInt64>(static_cast<ezUInt64>(uiMaxDictionarySize) * s_uiMaxSampleDataPerDictionaryByte, ezMath::MaxValue<ezUInt32>() / 2);
+
+  ezDynamicArray<ezUInt32> dmerFrequency;
+  dmerFrequency.SetCount(1u << s_uiHashBits);
+
+  // the last sample in which a dmer was encountered, to count every dmer only once per sample
+  ezDynamicArray<ezUInt32> dmerLastSample;
+  dmerLastSample.SetCount(1u << s_uiHashBits, s_uiInvalidDmer);
+
+  // if there is more sample data than needed, use every n-th sample, so that all kinds of input are represented, not just the first ones
+  ezUInt64 uiTotalSampleSize = 0;
+  for (const ezArrayPtr<const ezUInt8>& sample : samples)
+  {
+    uiTotalSampleSize += sample.GetCount();
+  }
+
+  const ezUInt32 uiSampleStride = static_cast<ezUInt32>(ezMath::Max<ezUInt64>(1, (uiTotalSampleSize + uiMaxCorpusSize - 1) / uiMaxCorpusSize));
+
+  for (ezUInt32 uiSample = 0; uiSample < samples.GetCount(); uiSample += uiSampleStride)
+  {
+    const ezArrayPtr<const ezUInt8> sample = samples[uiSample];
+
+    if (corpus.GetCount() + sample.GetCount() > uiMaxCorpusSize)
+      continue;
+
+    const ezUInt32 uiSampleStart = corpus.GetCount();
+    corpus.PushBackRange(sample);
+    dmerAtPos.SetCountUninitialized(corpus.GetCount());
+
+    for (ezUInt32 i = 0; i < sample.GetCount(); ++i)
+    {
+      if (i + s_uiDmerSize > sample.GetCount())
+      {
+        dmerAtPos[uiSampleStart + i] = s_uiInvalidDmer;
+        continue;
+      }
+
+      const ezUInt32 uiDmer = HashDmer(sample.GetPtr() + i);
+      dmerAtPos[uiSampleStart + i] = uiDmer;
+
+      if (dmerLastSample[uiDmer] != uiSample)
+      {
+        dmerLastSample[uiDmer] = uiSample;
+        ++dmerFrequency[uiDmer];
+      }
+    }
+  }
+
+  const ezUInt32 uiCorpusSize = corpus.GetCount();
+
+  if (uiMaxDictionarySize < s_uiSegmentSize || uiCorpusSize < uiMaxDictionarySize)
+    return EZ_FAILURE;
+
+  // The corpus is split into epochs and the best segment of every epoch is picked.
+  // This is much faster than searching the best segment in the entire corpus again and again, and it keeps the dictionary diverse.
+  const ezUInt32 uiNumEpochs = ezMath::Max(1u, uiMaxDictionarySize / s_uiSegmentSize);
+  const ezUInt32 uiEpochSize = ezMath::Max(s_uiSegmentSize, uiCorpusSize / uiNumEpochs);
+  const ezUInt32 uiMaxDmersInSegment = s_uiSegmentSize - s_uiDmerSize + 1;
+
+  ezDynamicArray<ezUInt16> dmerInWindow;
+  dmerInWindow.SetCount(1u << s_uiHashBits);
+
+  struct Segment
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiScore;
+    ezUInt32 m_uiStart;
+    ezUInt32 m_uiEnd;
+  };
+
+  ezDynamicArray<Segment> segments;
+  segments.Reserve(uiNumEpochs + 1);
+
+  for (ezUInt32 uiEpochStart = 0; uiEpochStart < uiCorpusSize; uiEpochStart += uiEpochSize)
+  {
+    const ezUInt32 uiEpochEnd = ezMath::Min(uiEpochStart + uiEpochSize, uiCorpusSize);
+
+    // slide a window over all dmers of the epoch, the score of a segment is the sum of the frequencies of its distinct dmers
+    ezUInt64 uiScore = 0;
+    ezUInt64 uiBestScore = 0;
+    ezUInt32 uiBestStart = 0;
+    ezUInt32 uiWindowStart = uiEpochStart;
+
+    for (ezUInt32 uiPos = uiEpochStart; uiPos < uiEpochEnd; ++uiPos)
+    {
+      const ezUInt32 uiDmer = dmerAtPos[uiPos];
+      if (uiDmer != s_uiInvalidDmer && dmerInWindow[uiDmer]++ == 0)
+      {
+        uiScore += dmerFrequency[uiDmer];
+      }
+
+      if (uiPos - uiWindowStart + 1 > uiMaxDmersInSegment)
+      {
+        const ezUInt32 uiOldDmer = dmerAtPos[uiWindowStart];
+        if (uiOldDmer != s_uiInvalidDmer && --dmerInWindow[uiOldDmer] == 0)
+        {
+          uiScore -= dmerFrequency[uiOldDmer];
+        }
+
+        ++uiWindowStart;
+      }
+
+      if (uiScore > uiBestScore)
+      {
+        uiBestScore = uiScore;
+        uiBestStart = uiWindowStart;
+      }
+    }
+
+    for (ezUInt32 uiPos = uiWindowStart; uiPos < uiEpochEnd; ++uiPos)
+    {
+      if (dmerAtPos[uiPos] != s_uiInvalidDmer)
+      {
+        dmerInWindow[dmerAtPos[uiPos]] = 0;
+      }
+    }
+
+    if (uiBestScore == 0)
+      continue;
+
+    const ezUInt32 uiSegmentEnd = ezMath::Min(uiBestStart + s_uiSegmentSize, uiCorpusSize);
+
+    // the content of the selected segment is covered now, don't select it again in later epochs
+    for (ezUInt32 uiPos = uiBestStart; uiPos < ezMath::Min(uiBestStart + uiMaxDmersInSegment, uiCorpusSize); ++uiPos)
+    {
+      if (dmerAtPos[uiPos] != s_uiInvalidDmer)
+      {
+        dmerFrequency[dmerAtPos[uiPos]] = 0;
+      }
+    }
+
+    Segment& segment = segments.ExpandAndGetRef();
+    segment.m_uiScore = uiBestScore;
+    segment.m_uiStart = uiBestStart;
+    segment.m_uiEnd = uiSegmentEnd;
+  }
+
+  // the segments with the highest scores go to the end of the dictionary, where they are the cheapest to reference
+  segments.Sort([](const Segment& a, const Segment& b) { return a.m_uiScore > b.m_uiScore; });
+
+  out_Dictionary.SetCountUninitialized(uiMaxDictionarySize);
+  ezUInt32 uiDictionaryStart = uiMaxDictionarySize;
+
+  for (ezUInt32 i = 0; i < segments.GetCount() && uiDictionaryStart > 0; ++i)
+  {
+    const Segment& segment = segments[i];
+    const ezUInt32 uiCopySize = ezMath::Min(segment.m_uiEnd - segment.m_uiStart, uiDictionaryStart);
+    uiDictionaryStart -= uiCopySize;
+    ezMemoryUtils::Copy(out_Dictionary.GetData() + uiDictionaryStart, corpus.GetData() + segment.m_uiEnd - uiCopySize, uiCopySize);
+  }
+
+  out_Dictionary.RemoveAtAndCopy(0, uiDictionaryStart);
+
+  if (out_Dictionary.IsEmpty())
+    return EZ_FAILURE;
+
+  // zstd would interpret content that starts with its magic number as a structured dictionary
+  if (out_Dictionary.GetCount() >= 4 && out_Dictionary[0] == 0x37 && out_Dictionary[1] == 0xA4 && out_Dictionary[2] == 0x30 && out_Dictionary[3] == 0xEC)
+  {
+    out_Dictionary[0] = 0;
+  }
+
+  return EZ_SUCCESS;
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Implementation_CompressionDictionaryZstd);
@@ -9,15 +9,12 @@ EZ_FOUNDATION_INTERNAL_HEADER
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #if EZ_ENABLED(EZ_PLATFORM_LINUX)
 #  include <linux/version.h>
 #endif
 
-#if EZ_ENABLED(EZ_PLATFORM_OSX)
-#  include <unistd.h>
-#endif
-
 struct ezMemoryMappedFileImpl
 {
   ezMemoryMappedFile::Mode m_Mode = ezMemoryMappedFile::Mode::None;
@@ -217,3 +214,18 @@ ezUInt64 ezMemoryMappedFile::GetFileSize() const
 {
   return m_Impl->m_uiFileSize;
 }
+
+void ezMemoryMappedFile::Prefetch(ezUInt64 uiOffset, ezUInt64 uiSize) const
+{
+  if (m_Impl->m_pMappedFilePtr == nullptr || uiOffset >= m_Impl->m_uiFileSize)
+    return;
+
+  uiSize = ezMath::Min(uiSize, m_Impl->m_uiFileSize - uiOffset);
+
+  // madvise requires a page aligned start address
+  static const ezUInt64 s_uiPageSize = static_cast<ezUInt64>(sysconf(_SC_PAGESIZE));
+  const ezUInt64 uiAlignedOffset = uiOffset - (uiOffset % s_uiPageSize);
+
+  // failure is not an error, the data will just be read on first access
+  madvise(ezMemoryUtils::AddByteOffset(m_Impl->m_pMappedFilePtr, static_cast<ptrdiff_t>(uiAlignedOffset)), static_cast<size_t>(uiSize + uiOffset - uiAlignedOffset), MADV_WILLNEED);
+}
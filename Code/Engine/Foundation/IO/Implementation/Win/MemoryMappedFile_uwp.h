@@ -51,3 +51,5 @@ ezUInt64 ezMemoryMappedFile::GetFileSize() const
 {
   return m_Impl->m_uiFileSize;
 }
+
+void ezMemoryMappedFile::Prefetch(ezUInt64 uiOffset, ezUInt64 uiSize) const {}
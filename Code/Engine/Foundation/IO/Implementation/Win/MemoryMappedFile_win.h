@@ -191,3 +191,16 @@ ezUInt64 ezMemoryMappedFile::GetFileSize() const
 {
   return m_Impl->m_uiFileSize;
 }
+
+void ezMemoryMappedFile::Prefetch(ezUInt64 uiOffset, ezUInt64 uiSize) const
+{
+  if (m_Impl->m_pMappedFilePtr == nullptr || uiOffset >= m_Impl->m_uiFileSize)
+    return;
+
+  WIN32_MEMORY_RANGE_ENTRY range;
+  range.VirtualAddress = ezMemoryUtils::AddByteOffset(m_Impl->m_pMappedFilePtr, static_cast<ptrdiff_t>(uiOffset));
+  range.NumberOfBytes = static_cast<SIZE_T>(ezMath::Min(uiSize, m_Impl->m_uiFileSize - uiOffset));
+
+  // failure is not an error, the data will just be read on first access
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
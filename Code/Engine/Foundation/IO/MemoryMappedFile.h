@@ -61,6 +61,13 @@ public:
   /// \brief Returns a pointer for writing the mapped file. Asserts that the memory mapping was successful and the mode was ReadWrite.
   void* GetWritePointer(ezUInt64 uiOffset = 0, OffsetBase base = OffsetBase::Start);
 
+  /// \brief Tells the OS that the given range of the mapping will be accessed soon, so that it can start reading it from disk in the
+  /// background.
+  ///
+  /// This is only a hint, it does not block and the data is not guaranteed to be resident afterwards. Does nothing on platforms that do not
+  /// support it.
+  void Prefetch(ezUInt64 uiOffset, ezUInt64 uiSize) const;
+
 private:
   ezUniquePtr<ezMemoryMappedFileImpl> m_Impl;
 };
@@ -3,12 +3,30 @@
 #include <Foundation/Communication/DataTransfer.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
+#include <Foundation/Containers/Map.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
 #include <Foundation/IO/JSONWriter.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Memory/MemoryTracker.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
 #include <Foundation/Threading/ThreadUtils.h>
+#include <Foundation/Utilities/Stats.h>
+
+#include <atomic>
+
+#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+#  if EZ_ENABLED(EZ_COMPILER_MSVC)
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#endif
 
 #if EZ_ENABLED(EZ_USE_PROFILING)
 
@@ -48,6 +66,11 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, ProfilingSystem)
 EZ_END_SUBSYSTEM_DECLARATION;
 // clang-format on
 
+struct ezProfilingSystem::CounterTrackData
+{
+  ezDeque<ezProfilingSystem::CounterSample> m_Samples; // protected by s_TracksMutex
+};
+
 namespace
 {
   enum
@@ -59,6 +82,7 @@ namespace
   enum
   {
     BUFFER_SIZE_FRAMES = 120 * 60,
+    BUFFER_SIZE_COUNTER_SAMPLES = BUFFER_SIZE_FRAMES * 4,
   };
 
   typedef ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::GPUScope)> GPUScopesBuffer;
@@ -91,6 +115,78 @@ namespace
     return static_cast<CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>*>(pEventBuffer);
   }
 
+  struct InternedScope
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const char* m_szName;
+    const char* m_szFunctionName;
+    ezUInt64 m_uiBeginTicks;
+    ezUInt64 m_uiEndTicks;
+  };
+
+  /// Ring buffer for interned scopes. Only the owning thread writes to it and it never waits for readers.
+  /// Readers detect entries that were overwritten while they copied them and drop those.
+  struct InternedScopesBuffer
+  {
+    static constexpr ezUInt32 Capacity = 32 * 1024; // must be a power of two
+
+    void Add(const InternedScope& scope)
+    {
+      const ezInt64 iPos = m_iWritePos.load(std::memory_order_relaxed);
+      m_Scopes[iPos & (Capacity - 1)] = scope;
+
+      // publishes the scope
+      m_iWritePos.store(iPos + 1, std::memory_order_release);
+    }
+
+    /// Copies all scopes from position iFrom up to the current write position.
+    /// Returns the position up to which the scopes have been read. out_uiNumLost receives the number of scopes that were
+    /// overwritten before they could be read.
+    ezInt64 Snapshot(ezInt64 iFrom, ezDynamicArray<InternedScope>& out_Scopes, ezUInt32& out_uiNumLost) const
+    {
+      const ezInt64 iEnd = m_iWritePos.load(std::memory_order_acquire);
+      iFrom = ezMath::Max(iFrom, m_iFirstValidPos.load(std::memory_order_acquire));
+
+      ezInt64 iStart = ezMath::Max(iFrom, iEnd - (ezInt64)Capacity);
+
+      out_Scopes.SetCountUninitialized(static_cast<ezUInt32>(iEnd - iStart));
+      for (ezInt64 i = iStart; i < iEnd; ++i)
+      {
+        out_Scopes[static_cast<ezUInt32>(i - iStart)] = m_Scopes[i & (Capacity - 1)];
+      }
+
+      // the writer may have wrapped around while we were copying, drop everything it might have touched in the mean time
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const ezInt64 iFirstIntact = m_iWritePos.load(std::memory_order_relaxed) - Capacity + 1;
+      if (iFirstIntact > iStart)
+      {
+        const ezUInt32 uiNumDropped = static_cast<ezUInt32>(ezMath::Min(iFirstIntact - iStart, iEnd - iStart));
+        out_Scopes.RemoveAtAndCopy(0, uiNumDropped);
+        iStart += uiNumDropped;
+      }
+
+      out_uiNumLost = static_cast<ezUInt32>(iStart - ezMath::Min(iFrom, iStart));
+      return iEnd;
+    }
+
+    /// Marks all scopes that were written so far as consumed.
+    void Clear() { m_iFirstValidPos.store(m_iWritePos.load(std::memory_order_acquire), std::memory_order_release); }
+
+    ezUInt64 m_uiThreadId = 0;
+
+    /// Only modified by the owning thread.
+    std::atomic<ezInt64> m_iWritePos = {0};
+
+    /// Moved forward by Clear(), everything before it is ignored by readers.
+    std::atomic<ezInt64> m_iFirstValidPos = {0};
+
+    /// Only used by the trace streaming thread.
+    ezInt64 m_iStreamedPos = 0;
+
+    InternedScope m_Scopes[Capacity];
+  };
+
   ezCVarFloat cvar_ProfilingDiscardThresholdMS("Profiling.DiscardThresholdMS", 0.1f, ezCVarFlags::Default, "Discard profiling scopes if their duration is shorter than this in milliseconds.");
 
   ezStaticRingBuffer<ezTime, BUFFER_SIZE_FRAMES> s_FrameStartTimes;
@@ -109,8 +205,161 @@ namespace
   static ezDynamicArray<CpuScopesBufferBase*> s_AllCpuScopes;
   static ezMutex s_AllCpuScopesMutex;
 
+  static thread_local InternedScopesBuffer* s_InternedScopes = nullptr;
+  static ezDynamicArray<InternedScopesBuffer*> s_AllInternedScopes; // protected by s_AllCpuScopesMutex
+
+  // maps time stamp counter ticks to ezTime
+  struct TickCalibration
+  {
+    ezUInt64 m_uiTicks = 0;
+    ezTime m_Time;
+    double m_fSecondsPerTick = 1e-9;
+  };
+
+  // the tick rate is measured over the entire run time, the reference point moves along every frame to keep the conversion precise.
+  // readers on other threads use the slot that is not currently written to
+  static TickCalibration s_TickCalibration[2];
+  static ezInt32 s_iCurrentTickCalibration = 0;
+  static ezUInt64 s_uiFirstCalibrationTicks = 0;
+  static ezTime s_FirstCalibrationTime;
+  static ezUInt64 s_uiDiscardThresholdTicks = 0;
+
   static GPUScopesBuffer* s_GPUScopes;
 
+  struct HistogramTrackData
+  {
+    ezProfilingSystem::HistogramFrame m_CurrentFrame;
+    ezDeque<ezProfilingSystem::HistogramFrame> m_Frames;
+  };
+
+  /// Counter samples of one thread that were not moved into their tracks yet.
+  /// The owning thread only locks its own buffer, the mutex is only contended while the samples are merged.
+  struct CounterSamplesBuffer
+  {
+    enum
+    {
+      MAX_PENDING_SAMPLES = 4 * 1024 ///< Once a thread has recorded this many samples, it merges them right away.
+    };
+
+    struct Entry
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezProfilingSystem::CounterTrackHandle m_hTrack;
+      ezProfilingSystem::CounterSample m_Sample;
+      ezUInt32 m_uiOrder; // only used while merging, keeps samples with the same time stamp in the order they were recorded
+    };
+
+    ezUInt64 m_uiThreadId = 0;
+    ezMutex m_Mutex;
+    ezDynamicArray<Entry> m_Samples;
+  };
+
+  static ezMutex s_TracksMutex;
+  static ezTime s_CurrentFrameStartTime; // protected by s_TracksMutex
+  static ezMap<ezString, ezProfilingSystem::CounterTrackData> s_CounterTracks; // the values are never removed, their addresses are used as handles
+  static ezMap<ezString, HistogramTrackData> s_HistogramTracks;
+
+  static thread_local CounterSamplesBuffer* s_CounterSamples = nullptr;
+  static ezDynamicArray<CounterSamplesBuffer*> s_AllCounterSamples;       // protected by s_TracksMutex
+  static ezDynamicArray<CounterSamplesBuffer::Entry> s_MergedCounterSamples; // protected by s_TracksMutex
+
+  /// Moves the samples of all threads into their counter tracks. Has to be called while s_TracksMutex is locked.
+  void MergeCounterSamples()
+  {
+    for (CounterSamplesBuffer* pBuffer : s_AllCounterSamples)
+    {
+      EZ_LOCK(pBuffer->m_Mutex);
+      s_MergedCounterSamples.PushBackRange(pBuffer->m_Samples);
+      pBuffer->m_Samples.Clear();
+    }
+
+    for (ezUInt32 i = 0; i < s_MergedCounterSamples.GetCount(); ++i)
+    {
+      s_MergedCounterSamples[i].m_uiOrder = i;
+    }
+
+    // the samples of different threads interleave
+    s_MergedCounterSamples.Sort([](const CounterSamplesBuffer::Entry& a, const CounterSamplesBuffer::Entry& b) {
+      if (a.m_Sample.m_Time != b.m_Sample.m_Time)
+        return a.m_Sample.m_Time < b.m_Sample.m_Time;
+
+      return a.m_uiOrder < b.m_uiOrder;
+    });
+
+    for (const CounterSamplesBuffer::Entry& entry : s_MergedCounterSamples)
+    {
+      auto& samples = entry.m_hTrack->m_Samples;
+
+      if (!samples.IsEmpty() && samples.PeekBack().m_fValue == entry.m_Sample.m_fValue)
+        continue;
+
+      if (samples.GetCount() >= BUFFER_SIZE_COUNTER_SAMPLES)
+      {
+        samples.PopFront();
+      }
+
+      samples.PushBack(entry.m_Sample);
+    }
+
+    s_MergedCounterSamples.Clear();
+  }
+
+  void ResetHistogramFrame(ezProfilingSystem::HistogramFrame& frame, ezTime frameStartTime)
+  {
+    ezMemoryUtils::ZeroFill(&frame, 1);
+    frame.m_FrameStartTime = frameStartTime;
+  }
+
+  struct StatCounterTrack
+  {
+    ezString m_sStatName;
+    ezProfilingSystem::CounterTrackHandle m_hTrack = nullptr;
+  };
+
+  // caches the counter track of every stat, keyed by the hash of the stat name
+  // only accessed from MirrorStatsToCounters, which ezStats calls while holding its own mutex
+  static ezHashTable<ezUInt64, StatCounterTrack> s_StatCounterTracks;
+
+  void MirrorStatsToCounters(const ezStats::StatsEventData& e)
+  {
+    if (e.m_EventType == ezStats::StatsEventData::Remove || !e.m_NewStatValue.IsNumber())
+      return;
+
+    StatCounterTrack& cached = s_StatCounterTracks[ezHashingUtils::StringHash(e.m_szStatName)];
+
+    if (cached.m_hTrack == nullptr)
+    {
+      ezStringBuilder sName("Stats/", e.m_szStatName);
+      cached.m_sStatName = e.m_szStatName;
+      cached.m_hTrack = ezProfilingSystem::GetCounterTrack(sName);
+    }
+    else if (cached.m_sStatName != e.m_szStatName)
+    {
+      // hash collision, don't cache anything for the second stat
+      ezStringBuilder sName("Stats/", e.m_szStatName);
+      ezProfilingSystem::SetCounterValue(sName, e.m_NewStatValue.ConvertTo<double>());
+      return;
+    }
+
+    ezProfilingSystem::SetCounterValue(cached.m_hTrack, e.m_NewStatValue.ConvertTo<double>());
+  }
+
+  void RecordFrameCounters()
+  {
+    ezUInt64 uiMemoryInUse = 0;
+    for (auto it = ezMemoryTracker::GetIterator(); it.IsValid(); ++it)
+    {
+      // child allocators are already accounted for in their parents
+      if (it.ParentId().IsInvalidated())
+      {
+        uiMemoryInUse += it.Stats().m_uiAllocationSize;
+      }
+    }
+
+    EZ_PROFILE_COUNTER("Memory/In Use (MB)", static_cast<double>(uiMemoryInUse) / (1024.0 * 1024.0));
+  }
+
   static ezEventSubscriptionID s_PluginEventSubscription = 0;
   void PluginEvent(const ezPluginEvent& e)
   {
@@ -121,6 +370,224 @@ namespace
       ezProfilingSystem::Clear();
     }
   }
+
+  void UpdateTickCalibration()
+  {
+    const ezUInt64 uiTicks = ezProfilingSystem::GetTimestampTicks();
+    const ezTime now = ezTime::Now();
+
+    if (s_uiFirstCalibrationTicks == 0)
+    {
+      s_uiFirstCalibrationTicks = uiTicks;
+      s_FirstCalibrationTime = now;
+    }
+
+    const ezInt32 iNext = 1 - s_iCurrentTickCalibration;
+    TickCalibration& calibration = s_TickCalibration[iNext];
+    calibration = s_TickCalibration[s_iCurrentTickCalibration];
+    calibration.m_uiTicks = uiTicks;
+    calibration.m_Time = now;
+
+    // the longer the interval, the more precise the result
+    const ezTime elapsed = now - s_FirstCalibrationTime;
+    if (elapsed.IsPositive() && uiTicks > s_uiFirstCalibrationTicks)
+    {
+      calibration.m_fSecondsPerTick = elapsed.GetSeconds() / static_cast<double>(uiTicks - s_uiFirstCalibrationTicks);
+    }
+
+    ezAtomicUtils::Set(s_iCurrentTickCalibration, iNext);
+
+    s_uiDiscardThresholdTicks = static_cast<ezUInt64>(ezTime::Milliseconds(cvar_ProfilingDiscardThresholdMS).GetSeconds() / calibration.m_fSecondsPerTick);
+  }
+
+  /// Writes all interned scopes into a Chrome trace event file (JSON array format) while the application is running.
+  /// The closing bracket is optional in that format, so the file stays loadable even if the process never gets to finish it.
+  class ezProfilingTraceStreamer : public ezThread
+  {
+  public:
+    ezProfilingTraceStreamer()
+      : ezThread("Profiling Trace Streamer")
+    {
+    }
+
+    ezResult Open(const char* szFile, ezTime flushInterval)
+    {
+      EZ_SUCCEED_OR_RETURN(m_File.Open(szFile, ezFileOpenMode::Write));
+
+      m_FlushInterval = flushInterval;
+
+#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+      m_uiProcessID = static_cast<ezUInt32>(ezProcess::GetCurrentProcessID());
+#  endif
+
+      // only stream what happens from now on
+      {
+        EZ_LOCK(s_AllCpuScopesMutex);
+        for (InternedScopesBuffer* pBuffer : s_AllInternedScopes)
+        {
+          pBuffer->m_iStreamedPos = pBuffer->m_iWritePos.load(std::memory_order_acquire);
+        }
+      }
+
+      m_sText = "[\n";
+      return EZ_SUCCESS;
+    }
+
+    void Stop()
+    {
+      m_bStop = true;
+      m_Signal.RaiseSignal();
+      Join();
+
+      // the last event was written with a trailing comma, an empty object keeps the JSON valid
+      m_File.Write("{}]\n", 4).IgnoreResult();
+      m_File.Close();
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (!m_bStop)
+      {
+        m_Signal.WaitForSignal(m_FlushInterval);
+        Flush();
+      }
+
+      return 0;
+    }
+
+    void Flush()
+    {
+      // only copy the raw scopes while holding the locks, the formatting happens afterwards
+      m_Scopes.Clear();
+      m_Threads.Clear();
+
+      {
+        EZ_LOCK(s_ThreadInfosMutex);
+        EZ_LOCK(s_AllCpuScopesMutex);
+
+        for (InternedScopesBuffer* pBuffer : s_AllInternedScopes)
+        {
+          ThreadScopes& thread = m_Threads.ExpandAndGetRef();
+          thread.m_uiThreadId = pBuffer->m_uiThreadId;
+          thread.m_uiFirstScope = m_Scopes.GetCount();
+
+          if (!m_KnownThreads.Contains(pBuffer->m_uiThreadId))
+          {
+            m_KnownThreads.PushBack(pBuffer->m_uiThreadId);
+            thread.m_bNewThread = true;
+            thread.m_sName = GetThreadName(pBuffer->m_uiThreadId);
+          }
+
+          pBuffer->m_iStreamedPos = pBuffer->Snapshot(pBuffer->m_iStreamedPos, m_TempScopes, thread.m_uiNumLost);
+          m_Scopes.PushBackRange(m_TempScopes);
+        }
+      }
+
+      for (ezUInt32 t = 0; t < m_Threads.GetCount(); ++t)
+      {
+        const ThreadScopes& thread = m_Threads[t];
+        const ezUInt32 uiEndScope = (t + 1 < m_Threads.GetCount()) ? m_Threads[t + 1].m_uiFirstScope : m_Scopes.GetCount();
+
+        if (thread.m_bNewThread && !thread.m_sName.IsEmpty())
+        {
+          WriteThreadName(thread.m_uiThreadId, thread.m_sName);
+        }
+
+        if (thread.m_uiNumLost > 0)
+        {
+          const double fFirstTimestamp = thread.m_uiFirstScope < uiEndScope ? ezProfilingSystem::TicksToTime(m_Scopes[thread.m_uiFirstScope].m_uiBeginTicks).GetMicroseconds() : 0.0;
+          m_sText.AppendFormat("{\"name\":\"{} scopes lost\",\"ph\":\"i\",\"s\":\"t\",\"pid\":{},\"tid\":{},\"ts\":{}},\n", thread.m_uiNumLost, m_uiProcessID,
+            thread.m_uiThreadId + 2, ezArgF(fFirstTimestamp, 3));
+        }
+
+        for (ezUInt32 i = thread.m_uiFirstScope; i < uiEndScope; ++i)
+        {
+          const InternedScope& scope = m_Scopes[i];
+          const ezTime begin = ezProfilingSystem::TicksToTime(scope.m_uiBeginTicks);
+          const ezTime end = ezProfilingSystem::TicksToTime(scope.m_uiEndTicks);
+
+          m_sText.Append("{\"name\":\"");
+          AppendEscaped(scope.m_szName);
+          m_sText.AppendFormat("\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{},\"dur\":{}},\n", m_uiProcessID, thread.m_uiThreadId + 2,
+            ezArgF(begin.GetMicroseconds(), 3), ezArgF((end - begin).GetMicroseconds(), 3));
+        }
+      }
+
+      if (!m_sText.IsEmpty())
+      {
+        m_File.Write(m_sText.GetData(), m_sText.GetElementCount()).IgnoreResult();
+        m_sText.Clear();
+      }
+    }
+
+    /// Has to be called while s_ThreadInfosMutex is locked.
+    static ezString GetThreadName(ezUInt64 uiThreadId)
+    {
+      for (const ezProfilingSystem::ThreadInfo& info : s_ThreadInfos)
+      {
+        if (info.m_uiThreadId == uiThreadId)
+          return info.m_sName;
+      }
+
+      return ezString();
+    }
+
+    void WriteThreadName(ezUInt64 uiThreadId, const ezString& sName)
+    {
+      m_sText.AppendFormat("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{\"name\":\"", m_uiProcessID, uiThreadId + 2);
+      AppendEscaped(sName.GetData());
+      m_sText.Append("\"}},\n");
+    }
+
+    void AppendEscaped(const char* szText)
+    {
+      const char* szStart = szText;
+
+      for (const char* c = szText; *c != '\0'; ++c)
+      {
+        if (*c == '"' || *c == '\\')
+        {
+          m_sText.Append(ezStringView(szStart, c));
+          m_sText.Append("\\");
+          szStart = c;
+        }
+        else if (static_cast<ezUInt8>(*c) < 0x20)
+        {
+          // JSON doesn't allow raw control characters inside of strings
+          m_sText.Append(ezStringView(szStart, c));
+          m_sText.AppendFormat("\\u{}", ezArgU(static_cast<ezUInt8>(*c), 4, true, 16));
+          szStart = c + 1;
+        }
+      }
+
+      m_sText.Append(szStart);
+    }
+
+    ezOSFile m_File;
+    ezTime m_FlushInterval;
+    ezUInt32 m_uiProcessID = 0;
+    volatile bool m_bStop = false;
+    ezThreadSignal m_Signal;
+
+    struct ThreadScopes
+    {
+      ezUInt64 m_uiThreadId = 0;
+      ezUInt32 m_uiFirstScope = 0;
+      ezUInt32 m_uiNumLost = 0;
+      bool m_bNewThread = false;
+      ezString m_sName;
+    };
+
+    ezStringBuilder m_sText;
+    ezDynamicArray<InternedScope> m_Scopes;
+    ezDynamicArray<InternedScope> m_TempScopes;
+    ezHybridArray<ThreadScopes, 16> m_Threads;
+    ezHybridArray<ezUInt64, 16> m_KnownThreads;
+  };
+
+  static ezMutex s_TraceStreamerMutex;
+  static ezProfilingTraceStreamer* s_pTraceStreamer = nullptr;
 } // namespace
 
 void ezProfilingSystem::ProfilingData::Clear()
@@ -134,6 +601,8 @@ void ezProfilingSystem::ProfilingData::Clear()
   m_FrameStartTimes.Clear();
   m_GPUScopes.Clear();
   m_ThreadInfos.Clear();
+  m_CounterTracks.Clear();
+  m_HistogramTracks.Clear();
 }
 
 void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_Merged, ezArrayPtr<const ProfilingData*> inputs)
@@ -194,6 +663,64 @@ void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_Merged, ezArrayP
     }
   }
 
+  // merge m_CounterTracks and m_HistogramTracks by name
+  {
+    for (const auto& pd : inputs)
+    {
+      for (const auto& track : pd->m_CounterTracks)
+      {
+        CounterTrack* pTarget = nullptr;
+        for (auto& existing : out_Merged.m_CounterTracks)
+        {
+          if (existing.m_sName == track.m_sName)
+          {
+            pTarget = &existing;
+            break;
+          }
+        }
+
+        if (pTarget == nullptr)
+        {
+          pTarget = &out_Merged.m_CounterTracks.ExpandAndGetRef();
+          pTarget->m_sName = track.m_sName;
+        }
+
+        pTarget->m_Samples.PushBackRange(track.m_Samples);
+      }
+
+      for (const auto& track : pd->m_HistogramTracks)
+      {
+        HistogramTrack* pTarget = nullptr;
+        for (auto& existing : out_Merged.m_HistogramTracks)
+        {
+          if (existing.m_sName == track.m_sName)
+          {
+            pTarget = &existing;
+            break;
+          }
+        }
+
+        if (pTarget == nullptr)
+        {
+          pTarget = &out_Merged.m_HistogramTracks.ExpandAndGetRef();
+          pTarget->m_sName = track.m_sName;
+        }
+
+        pTarget->m_Frames.PushBackRange(track.m_Frames);
+      }
+    }
+
+    for (auto& track : out_Merged.m_CounterTracks)
+    {
+      track.m_Samples.Sort([](const CounterSample& a, const CounterSample& b) { return a.m_Time < b.m_Time; });
+    }
+
+    for (auto& track : out_Merged.m_HistogramTracks)
+    {
+      track.m_Frames.Sort([](const HistogramFrame& a, const HistogramFrame& b) { return a.m_FrameStartTime < b.m_FrameStartTime; });
+    }
+  }
+
   // merge m_AllEventBuffers
   {
     struct CountAndIndex
@@ -454,6 +981,88 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
       }
     }
 
+    // counters
+    {
+      for (const CounterTrack& track : m_CounterTracks)
+      {
+        for (const CounterSample& sample : track.m_Samples)
+        {
+          writer.BeginObject();
+          writer.AddVariableString("name", track.m_sName);
+          writer.AddVariableUInt32("pid", m_uiProcessID);
+          writer.AddVariableUInt64("ts", static_cast<ezUInt64>(sample.m_Time.GetMicroseconds()));
+          writer.AddVariableString("ph", "C");
+
+          writer.BeginObject("args");
+          writer.AddVariableDouble("value", sample.m_fValue);
+          writer.EndObject();
+
+          writer.EndObject();
+        }
+
+        if (writer.HadWriteError())
+        {
+          return EZ_FAILURE;
+        }
+      }
+    }
+
+    // histograms, one stacked counter with all buckets per frame plus the maximum latency
+    {
+      ezStringBuilder bucketNames[HistogramFrame::NUM_BUCKETS];
+      for (ezUInt32 b = 0; b < HistogramFrame::NUM_BUCKETS; ++b)
+      {
+        if (b + 1 < HistogramFrame::NUM_BUCKETS)
+          bucketNames[b].Format("<= {} us", static_cast<ezUInt64>(GetHistogramBucketUpperBound(b).GetMicroseconds()));
+        else
+          bucketNames[b].Format("> {} us", static_cast<ezUInt64>(GetHistogramBucketUpperBound(b - 1).GetMicroseconds()));
+      }
+
+      ezStringBuilder sMaxName;
+
+      for (const HistogramTrack& track : m_HistogramTracks)
+      {
+        sMaxName.Set(track.m_sName, " (max ms)");
+
+        for (const HistogramFrame& frame : track.m_Frames)
+        {
+          const ezUInt64 uiTimestamp = static_cast<ezUInt64>(frame.m_FrameStartTime.GetMicroseconds());
+
+          writer.BeginObject();
+          writer.AddVariableString("name", track.m_sName);
+          writer.AddVariableUInt32("pid", m_uiProcessID);
+          writer.AddVariableUInt64("ts", uiTimestamp);
+          writer.AddVariableString("ph", "C");
+
+          writer.BeginObject("args");
+          for (ezUInt32 b = 0; b < HistogramFrame::NUM_BUCKETS; ++b)
+          {
+            writer.AddVariableUInt32(bucketNames[b], frame.m_BucketCounts[b]);
+          }
+          writer.EndObject();
+
+          writer.EndObject();
+
+          writer.BeginObject();
+          writer.AddVariableString("name", sMaxName);
+          writer.AddVariableUInt32("pid", m_uiProcessID);
+          writer.AddVariableUInt64("ts", uiTimestamp);
+          writer.AddVariableString("ph", "C");
+
+          writer.BeginObject("args");
+          writer.AddVariableDouble("value", frame.m_MaxLatency.GetMilliseconds());
+          writer.EndObject();
+
+          writer.EndObject();
+        }
+
+        if (writer.HadWriteError())
+        {
+          return EZ_FAILURE;
+        }
+      }
+    }
+
     writer.EndArray();
   }
 
@@ -480,6 +1089,34 @@ void ezProfilingSystem::Clear()
     }
   }
 
+  {
+    EZ_LOCK(s_AllCpuScopesMutex);
+    for (auto pInternedScopes : s_AllInternedScopes)
+    {
+      pInternedScopes->Clear();
+    }
+  }
+
+  {
+    EZ_LOCK(s_TracksMutex);
+
+    for (CounterSamplesBuffer* pBuffer : s_AllCounterSamples)
+    {
+      EZ_LOCK(pBuffer->m_Mutex);
+      pBuffer->m_Samples.Clear();
+    }
+
+    for (auto it = s_CounterTracks.GetIterator(); it.IsValid(); ++it)
+    {
+      it.Value().m_Samples.Clear();
+    }
+
+    for (auto it = s_HistogramTracks.GetIterator(); it.IsValid(); ++it)
+    {
+      it.Value().m_Frames.Clear();
+    }
+  }
+
   s_FrameStartTimes.Clear();
 
   if (s_GPUScopes != nullptr)
@@ -538,6 +1175,74 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& profilingData,
         ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
       }
     }
+
+    // interned scopes are merged into the buffer of the same thread, their writers are not stopped for this
+    ezDynamicArray<InternedScope> internedScopes;
+    for (InternedScopesBuffer* pSourceBuffer : s_AllInternedScopes)
+    {
+      ezUInt32 uiNumLost = 0;
+      pSourceBuffer->Snapshot(0, internedScopes, uiNumLost);
+
+      CPUScopesBufferFlat* pTargetEventBuffer = nullptr;
+      for (CPUScopesBufferFlat& eventBuffer : profilingData.m_AllEventBuffers)
+      {
+        if (eventBuffer.m_uiThreadId == pSourceBuffer->m_uiThreadId)
+        {
+          pTargetEventBuffer = &eventBuffer;
+          break;
+        }
+      }
+
+      if (pTargetEventBuffer == nullptr)
+      {
+        pTargetEventBuffer = &profilingData.m_AllEventBuffers.ExpandAndGetRef();
+        pTargetEventBuffer->m_uiThreadId = pSourceBuffer->m_uiThreadId;
+      }
+
+      pTargetEventBuffer->m_Data.Reserve(pTargetEventBuffer->m_Data.GetCount() + internedScopes.GetCount());
+      for (const InternedScope& sourceEvent : internedScopes)
+      {
+        CPUScope& copiedEvent = pTargetEventBuffer->m_Data.ExpandAndGetRef();
+        copiedEvent.m_szFunctionName = sourceEvent.m_szFunctionName;
+        copiedEvent.m_BeginTime = TicksToTime(sourceEvent.m_uiBeginTicks);
+        copiedEvent.m_EndTime = TicksToTime(sourceEvent.m_uiEndTicks);
+        ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
+      }
+    }
+  }
+
+  {
+    EZ_LOCK(s_TracksMutex);
+
+    MergeCounterSamples();
+
+    profilingData.m_CounterTracks.Reserve(s_CounterTracks.GetCount());
+    for (auto it = s_CounterTracks.GetIterator(); it.IsValid(); ++it)
+    {
+      CounterTrack& track = profilingData.m_CounterTracks.ExpandAndGetRef();
+      track.m_sName = it.Key();
+
+      const auto& samples = it.Value().m_Samples;
+      track.m_Samples.SetCountUninitialized(samples.GetCount());
+      for (ezUInt32 i = 0; i < samples.GetCount(); ++i)
+      {
+        track.m_Samples[i] = samples[i];
+      }
+    }
+
+    profilingData.m_HistogramTracks.Reserve(s_HistogramTracks.GetCount());
+    for (auto it = s_HistogramTracks.GetIterator(); it.IsValid(); ++it)
+    {
+      HistogramTrack& track = profilingData.m_HistogramTracks.ExpandAndGetRef();
+      track.m_sName = it.Key();
+
+      const auto& frames = it.Value().m_Frames;
+      track.m_Frames.SetCountUninitialized(frames.GetCount());
+      for (ezUInt32 i = 0; i < frames.GetCount(); ++i)
+      {
+        track.m_Frames[i] = frames[i];
+      }
+    }
   }
 
   profilingData.m_uiFrameCount = s_uiFrameCount;
@@ -572,6 +1277,7 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& profilingData,
 void ezProfilingSystem::SetDiscardThreshold(ezTime threshold)
 {
   cvar_ProfilingDiscardThresholdMS = static_cast<float>(threshold.GetMilliseconds());
+  s_uiDiscardThresholdTicks = static_cast<ezUInt64>(threshold.GetSeconds() / s_TickCalibration[s_iCurrentTickCalibration].m_fSecondsPerTick);
 }
 
 // static
@@ -590,7 +1296,225 @@ void ezProfilingSystem::StartNewFrame()
     s_FrameStartTimes.PopFront();
   }
 
-  s_FrameStartTimes.PushBack(ezTime::Now());
+  const ezTime now = ezTime::Now();
+  s_FrameStartTimes.PushBack(now);
+
+  UpdateTickCalibration();
+  RecordFrameCounters();
+
+  // store the counter samples and the histograms of the previous frame
+  {
+    EZ_LOCK(s_TracksMutex);
+
+    MergeCounterSamples();
+
+    s_CurrentFrameStartTime = now;
+
+    for (auto it = s_HistogramTracks.GetIterator(); it.IsValid(); ++it)
+    {
+      HistogramTrackData& track = it.Value();
+
+      if (track.m_CurrentFrame.m_uiNumSamples > 0)
+      {
+        if (track.m_Frames.GetCount() >= BUFFER_SIZE_FRAMES)
+        {
+          track.m_Frames.PopFront();
+        }
+
+        track.m_Frames.PushBack(track.m_CurrentFrame);
+      }
+
+      ResetHistogramFrame(track.m_CurrentFrame, now);
+    }
+  }
+}
+
+// static
+ezProfilingSystem::CounterTrackHandle ezProfilingSystem::GetCounterTrack(const char* szName)
+{
+  EZ_LOCK(s_TracksMutex);
+
+  return &s_CounterTracks[szName];
+}
+
+// static
+void ezProfilingSystem::SetCounterValue(const char* szName, double fValue)
+{
+  SetCounterValue(GetCounterTrack(szName), fValue);
+}
+
+// static
+void ezProfilingSystem::SetCounterValue(CounterTrackHandle hTrack, double fValue)
+{
+  CounterSamplesBuffer* pSamples = s_CounterSamples;
+
+  if (pSamples == nullptr)
+  {
+    pSamples = EZ_DEFAULT_NEW(CounterSamplesBuffer);
+    pSamples->m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
+    s_CounterSamples = pSamples;
+
+    {
+      EZ_LOCK(s_TracksMutex);
+      s_AllCounterSamples.PushBack(pSamples);
+    }
+  }
+
+  bool bMergeNow = false;
+
+  {
+    // only this thread's buffer is locked, the samples are moved into the tracks once per frame
+    EZ_LOCK(pSamples->m_Mutex);
+
+    CounterSamplesBuffer::Entry& entry = pSamples->m_Samples.ExpandAndGetRef();
+    entry.m_hTrack = hTrack;
+    entry.m_Sample.m_Time = ezTime::Now();
+    entry.m_Sample.m_fValue = fValue;
+
+    bMergeNow = pSamples->m_Samples.GetCount() >= CounterSamplesBuffer::MAX_PENDING_SAMPLES;
+  }
+
+  // don't let the buffer grow indefinitely, if no frames are started
+  if (bMergeNow)
+  {
+    EZ_LOCK(s_TracksMutex);
+    MergeCounterSamples();
+  }
+}
+
+// static
+void ezProfilingSystem::AddHistogramSample(const char* szName, ezTime latency)
+{
+  EZ_LOCK(s_TracksMutex);
+
+  bool bExisted = false;
+  auto it = s_HistogramTracks.FindOrAdd(szName, &bExisted);
+  HistogramFrame& frame = it.Value().m_CurrentFrame;
+
+  if (!bExisted)
+  {
+    ResetHistogramFrame(frame, s_CurrentFrameStartTime);
+  }
+
+  frame.m_BucketCounts[GetHistogramBucket(latency)]++;
+  frame.m_MaxLatency = ezMath::Max(frame.m_MaxLatency, latency);
+  frame.m_TotalLatency += latency;
+  frame.m_uiNumSamples++;
+}
+
+// static
+ezUInt32 ezProfilingSystem::GetHistogramBucket(ezTime latency)
+{
+  const double fMicroseconds = latency.GetMicroseconds();
+
+  ezUInt32 uiBucket = 0;
+  double fUpperBound = 1.0;
+
+  while (uiBucket + 1 < HistogramFrame::NUM_BUCKETS && fMicroseconds > fUpperBound)
+  {
+    ++uiBucket;
+    fUpperBound *= 2.0;
+  }
+
+  return uiBucket;
+}
+
+// static
+ezTime ezProfilingSystem::GetHistogramBucketUpperBound(ezUInt32 uiBucket)
+{
+  if (uiBucket + 1 >= HistogramFrame::NUM_BUCKETS)
+    return ezTime::Seconds(ezMath::Infinity<double>());
+
+  return ezTime::Microseconds(static_cast<double>(1u << uiBucket));
+}
+
+// static
+ezUInt64 ezProfilingSystem::GetTimestampTicks()
+{
+#  if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+  // invariant on all CPUs of the last decade, i.e. it runs at a constant rate and is synchronized across cores
+  return __rdtsc();
+#  else
+  return static_cast<ezUInt64>(ezTime::Now().GetNanoseconds());
+#  endif
+}
+
+// static
+ezTime ezProfilingSystem::TicksToTime(ezUInt64 uiTicks)
+{
+  const TickCalibration& calibration = s_TickCalibration[ezAtomicUtils::Read(s_iCurrentTickCalibration)];
+
+  const double fDeltaTicks = static_cast<double>(static_cast<ezInt64>(uiTicks - calibration.m_uiTicks));
+  return calibration.m_Time + ezTime::Seconds(fDeltaTicks * calibration.m_fSecondsPerTick);
+}
+
+// static
+void ezProfilingSystem::AddInternedCPUScope(const char* szStaticName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks)
+{
+  // discard?
+  if (uiEndTicks - uiBeginTicks < s_uiDiscardThresholdTicks)
+    return;
+
+  InternedScopesBuffer* pScopes = s_InternedScopes;
+
+  if (pScopes == nullptr)
+  {
+    pScopes = EZ_DEFAULT_NEW(InternedScopesBuffer);
+    pScopes->m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
+    s_InternedScopes = pScopes;
+
+    {
+      EZ_LOCK(s_AllCpuScopesMutex);
+      s_AllInternedScopes.PushBack(pScopes);
+    }
+  }
+
+  InternedScope scope;
+  scope.m_szName = szStaticName;
+  scope.m_szFunctionName = szFunctionName;
+  scope.m_uiBeginTicks = uiBeginTicks;
+  scope.m_uiEndTicks = uiEndTicks;
+
+  pScopes->Add(scope);
+}
+
+// static
+ezResult ezProfilingSystem::StartTraceStreaming(const char* szFile, ezTime flushInterval)
+{
+  EZ_LOCK(s_TraceStreamerMutex);
+
+  if (s_pTraceStreamer != nullptr)
+    return EZ_FAILURE;
+
+  ezProfilingTraceStreamer* pStreamer = EZ_DEFAULT_NEW(ezProfilingTraceStreamer);
+  if (pStreamer->Open(szFile, flushInterval).Failed())
+  {
+    EZ_DEFAULT_DELETE(pStreamer);
+    return EZ_FAILURE;
+  }
+
+  pStreamer->Start();
+  s_pTraceStreamer = pStreamer;
+  return EZ_SUCCESS;
+}
+
+// static
+void ezProfilingSystem::StopTraceStreaming()
+{
+  EZ_LOCK(s_TraceStreamerMutex);
+
+  if (s_pTraceStreamer == nullptr)
+    return;
+
+  s_pTraceStreamer->Stop();
+  EZ_DEFAULT_DELETE(s_pTraceStreamer);
+}
+
+// static
+bool ezProfilingSystem::IsTraceStreaming()
+{
+  EZ_LOCK(s_TraceStreamerMutex);
+  return s_pTraceStreamer != nullptr;
 }
 
 // static
@@ -657,12 +1581,20 @@ void ezProfilingSystem::Initialize()
 
   s_MainThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
 
+  // only records the reference point, the tick rate is measured relative to it every frame
+  // until the first frame starts, ticks are assumed to be nanoseconds
+  UpdateTickCalibration();
+
   s_PluginEventSubscription = ezPlugin::Events().AddEventHandler(&PluginEvent);
+
+  ezStats::AddEventHandler(&MirrorStatsToCounters);
 }
 
 // static
 void ezProfilingSystem::Reset()
 {
+  StopTraceStreaming();
+
   EZ_LOCK(s_ThreadInfosMutex);
   EZ_LOCK(s_AllCpuScopesMutex);
   for (ezUInt32 i = 0; i < s_DeadThreadIDs.GetCount(); i++)
@@ -689,10 +1621,36 @@ void ezProfilingSystem::Reset()
         s_AllCpuScopes.RemoveAtAndCopy(k);
       }
     }
+    for (ezUInt32 k = 0; k < s_AllInternedScopes.GetCount(); k++)
+    {
+      InternedScopesBuffer* pInternedScopes = s_AllInternedScopes[k];
+      if (pInternedScopes->m_uiThreadId == uiThreadId)
+      {
+        EZ_DEFAULT_DELETE(pInternedScopes);
+        s_AllInternedScopes.RemoveAtAndCopy(k);
+      }
+    }
+
+    EZ_LOCK(s_TracksMutex);
+
+    for (ezUInt32 k = 0; k < s_AllCounterSamples.GetCount(); k++)
+    {
+      CounterSamplesBuffer* pCounterSamples = s_AllCounterSamples[k];
+      if (pCounterSamples->m_uiThreadId == uiThreadId)
+      {
+        // keep the samples that the thread recorded before it exited
+        MergeCounterSamples();
+
+        EZ_DEFAULT_DELETE(pCounterSamples);
+        s_AllCounterSamples.RemoveAtAndCopy(k);
+      }
+    }
   }
   s_DeadThreadIDs.Clear();
 
   ezPlugin::Events().RemoveEventHandler(s_PluginEventSubscription);
+
+  ezStats::RemoveEventHandler(&MirrorStatsToCounters);
 }
 
 // static
@@ -757,6 +1715,20 @@ ezProfilingScope::~ezProfilingScope()
 
 //////////////////////////////////////////////////////////////////////////
 
+ezProfilingInternedScope::ezProfilingInternedScope(const char* szStaticName, const char* szFunctionName)
+  : m_szName(szStaticName)
+  , m_szFunction(szFunctionName)
+  , m_uiBeginTicks(ezProfilingSystem::GetTimestampTicks())
+{
+}
+
+ezProfilingInternedScope::~ezProfilingInternedScope()
+{
+  ezProfilingSystem::AddInternedCPUScope(m_szName, m_szFunction, m_uiBeginTicks, ezProfilingSystem::GetTimestampTicks());
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 thread_local ezProfilingListScope* ezProfilingListScope::s_pCurrentList = nullptr;
 
 ezProfilingListScope::ezProfilingListScope(const char* szListName, const char* szFirstSectionName, const char* szFunctionName)
@@ -822,6 +1794,51 @@ void ezProfilingSystem::AddGPUScope(const char* szName, ezTime beginTime, ezTime
 
 void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_Merged, ezArrayPtr<const ProfilingData*> inputs) {}
 
+ezProfilingSystem::CounterTrackHandle ezProfilingSystem::GetCounterTrack(const char* szName)
+{
+  return nullptr;
+}
+
+void ezProfilingSystem::SetCounterValue(CounterTrackHandle hTrack, double fValue) {}
+
+void ezProfilingSystem::SetCounterValue(const char* szName, double fValue) {}
+
+void ezProfilingSystem::AddHistogramSample(const char* szName, ezTime latency) {}
+
+ezUInt32 ezProfilingSystem::GetHistogramBucket(ezTime latency)
+{
+  return 0;
+}
+
+ezTime ezProfilingSystem::GetHistogramBucketUpperBound(ezUInt32 uiBucket)
+{
+  return ezTime();
+}
+
+ezUInt64 ezProfilingSystem::GetTimestampTicks()
+{
+  return 0;
+}
+
+ezTime ezProfilingSystem::TicksToTime(ezUInt64 uiTicks)
+{
+  return ezTime();
+}
+
+void ezProfilingSystem::AddInternedCPUScope(const char* szStaticName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks) {}
+
+ezResult ezProfilingSystem::StartTraceStreaming(const char* szFile, ezTime flushInterval)
+{
+  return EZ_FAILURE;
+}
+
+void ezProfilingSystem::StopTraceStreaming() {}
+
+bool ezProfilingSystem::IsTraceStreaming()
+{
+  return false;
+}
+
 #endif
 
 EZ_STATICLINK_FILE(Foundation, Foundation_Profiling_Implementation_Profiling);
@@ -25,6 +25,24 @@ protected:
   ezTime m_BeginTime;
 };
 
+/// \brief A cheaper variant of ezProfilingScope for names that stay valid for the entire lifetime of the process.
+///
+/// Instead of copying the name, only the pointer is stored, together with two raw timestamps (see ezProfilingSystem::GetTimestampTicks()).
+/// The scope is written into a lock-free ring buffer that belongs to the calling thread.
+///
+/// You shouldn't need to use this directly, just use the macro EZ_PROFILE_SCOPE_INTERNED provided below.
+class EZ_FOUNDATION_DLL ezProfilingInternedScope
+{
+public:
+  ezProfilingInternedScope(const char* szStaticName, const char* szFunctionName);
+  ~ezProfilingInternedScope();
+
+protected:
+  const char* m_szName;
+  const char* m_szFunction;
+  ezUInt64 m_uiBeginTicks;
+};
+
 /// \brief This class implements a profiling scope similar to ezProfilingScope, but with additional sub-scopes which can be added easily without
 /// introducing actual C++ scopes.
 ///
@@ -94,6 +112,44 @@ public:
     char m_szName[NAME_SIZE];
   };
 
+  /// \brief One value of a counter track.
+  struct CounterSample
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezTime m_Time;
+    double m_fValue;
+  };
+
+  /// \brief A named value that changes over time, e.g. the memory in use or the number of queued tasks.
+  struct CounterTrack
+  {
+    ezString m_sName;
+    ezDynamicArray<CounterSample> m_Samples;
+  };
+
+  /// \brief The distribution of all latencies that were recorded for one histogram track during a single frame.
+  ///
+  /// The buckets grow exponentially, see GetHistogramBucketUpperBound().
+  struct HistogramFrame
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    static constexpr ezUInt32 NUM_BUCKETS = 16;
+
+    ezTime m_FrameStartTime;
+    ezTime m_MaxLatency;
+    ezTime m_TotalLatency;
+    ezUInt32 m_uiNumSamples;
+    ezUInt32 m_BucketCounts[NUM_BUCKETS];
+  };
+
+  struct HistogramTrack
+  {
+    ezString m_sName;
+    ezDynamicArray<HistogramFrame> m_Frames;
+  };
+
   struct EZ_FOUNDATION_DLL ProfilingData
   {
     ezUInt32 m_uiFramesThreadID = 0;
@@ -109,6 +165,9 @@ public:
 
     ezDynamicArray<GPUScope> m_GPUScopes;
 
+    ezDynamicArray<CounterTrack> m_CounterTracks;
+    ezDynamicArray<HistogramTrack> m_HistogramTracks;
+
     /// \brief Writes profiling data as JSON to the output stream.
     ezResult Write(ezStreamWriter& outputStream) const;
 
@@ -135,6 +194,63 @@ public:
   /// \brief Get current frame counter
   static ezUInt64 GetFrameCount();
 
+  struct CounterTrackData;
+
+  /// \brief Identifies a counter track. Counter tracks are never deleted, so a handle stays valid for the lifetime of the process.
+  using CounterTrackHandle = CounterTrackData*;
+
+  /// \brief Returns the counter track with the given name, creates it if necessary.
+  ///
+  /// Looking up the track is the expensive part of recording a counter value, so code that updates a counter frequently should store the handle.
+  static CounterTrackHandle GetCounterTrack(const char* szName);
+
+  /// \brief Records the current value of a counter track. Consecutive samples with the same value are only stored once.
+  ///
+  /// The samples are buffered per thread and moved into their tracks once per frame (see StartNewFrame()) and by Capture().
+  /// Use EZ_PROFILE_COUNTER instead of calling this directly.
+  static void SetCounterValue(CounterTrackHandle hTrack, double fValue);
+
+  /// \brief Same as above, but looks up the track by name first.
+  static void SetCounterValue(const char* szName, double fValue);
+
+  /// \brief Adds a latency sample to a histogram track. The samples are accumulated and stored once per frame (see StartNewFrame()).
+  ///
+  /// Use EZ_PROFILE_HISTOGRAM instead of calling this directly.
+  static void AddHistogramSample(const char* szName, ezTime latency);
+
+  /// \brief Returns the index of the histogram bucket into which the given latency falls.
+  static ezUInt32 GetHistogramBucket(ezTime latency);
+
+  /// \brief Returns the largest latency that is counted in the given bucket. Bucket 0 covers up to one microsecond and each following bucket doubles
+  /// that. The last bucket has no upper bound.
+  static ezTime GetHistogramBucketUpperBound(ezUInt32 uiBucket);
+
+  /// \brief Returns a high resolution timestamp. Uses the CPU time stamp counter where available.
+  ///
+  /// Use TicksToTime() to convert the value into the same time base as ezTime::Now().
+  static ezUInt64 GetTimestampTicks();
+
+  /// \brief Converts a value returned by GetTimestampTicks() into an ezTime.
+  static ezTime TicksToTime(ezUInt64 uiTicks);
+
+  /// \brief Adds a scope to the lock-free buffer of the calling thread. The name is not copied, so it must stay valid for the entire lifetime of the process.
+  ///
+  /// Use EZ_PROFILE_SCOPE_INTERNED instead of calling this directly.
+  static void AddInternedCPUScope(const char* szStaticName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks);
+
+  /// \brief Starts a background thread that continuously appends all interned CPU scopes to the given file.
+  ///
+  /// The file uses the Chrome trace event format (JSON array), which can be loaded into chrome://tracing or ui.perfetto.dev,
+  /// even if the application crashes before StopTraceStreaming() is called.
+  /// Scopes that were recorded with EZ_PROFILE_SCOPE are not part of the stream, since their buffers are not safe to read while they are written.
+  static ezResult StartTraceStreaming(const char* szFile, ezTime flushInterval = ezTime::Milliseconds(250));
+
+  /// \brief Writes all outstanding scopes, closes the file and stops the streaming thread.
+  static void StopTraceStreaming();
+
+  /// \brief Returns whether StartTraceStreaming() is currently active.
+  static bool IsTraceStreaming();
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ProfilingSystem);
   friend ezUInt32 RunThread(ezThread* pThread);
@@ -170,6 +286,36 @@ public:
 /// \sa EZ_PROFILE_LIST_SCOPE
 #  define EZ_PROFILE_SCOPE(szScopeName) ezProfilingScope EZ_CONCAT(_ezProfilingScope, EZ_SOURCE_LINE)(szScopeName, EZ_SOURCE_FUNCTION)
 
+/// \brief Profiles the current scope using the given string literal as the name.
+///
+/// Compared to EZ_PROFILE_SCOPE this has a much lower overhead and never takes a lock, which makes it suitable for very hot code paths
+/// and for profiling that stays enabled all the time. The name must be a string literal, since only its address is recorded.
+///
+/// \sa ezProfilingInternedScope
+/// \sa ezProfilingSystem::StartTraceStreaming
+#  define EZ_PROFILE_SCOPE_INTERNED(szStaticScopeName) \
+    ezProfilingInternedScope EZ_CONCAT(_ezProfilingScope, EZ_SOURCE_LINE)("" szStaticScopeName, EZ_SOURCE_FUNCTION)
+
+/// \brief Records the current value of a counter track, e.g. EZ_PROFILE_COUNTER("Resources/Loading", uiNumLoading).
+///
+/// Counters show up as separate tracks on the same timeline as the profiling scopes.
+///
+/// The track is looked up only once per call site, so the name has to be the same every time the line is executed.
+///
+/// \sa ezProfilingSystem::SetCounterValue
+#  define EZ_PROFILE_COUNTER(szName, value)                                                                                     \
+    do                                                                                                                          \
+    {                                                                                                                           \
+      static const ezProfilingSystem::CounterTrackHandle EZ_CONCAT(_ezCounterTrack, EZ_SOURCE_LINE) =                           \
+        ezProfilingSystem::GetCounterTrack(szName);                                                                             \
+      ezProfilingSystem::SetCounterValue(EZ_CONCAT(_ezCounterTrack, EZ_SOURCE_LINE), static_cast<double>(value));              \
+    } while (false)
+
+/// \brief Adds a latency sample to a histogram track. The distribution is stored once per frame.
+///
+/// \sa ezProfilingSystem::AddHistogramSample
+#  define EZ_PROFILE_HISTOGRAM(szName, latency) ezProfilingSystem::AddHistogramSample(szName, latency)
+
 /// \brief Profiles the current scope using the given name as the overall list scope name and the section name for the first section in the list.
 ///
 /// Use EZ_PROFILE_LIST_NEXT_SECTION to start a new section in the list scope.
@@ -194,6 +340,12 @@ public:
 
 #  define EZ_PROFILE_SCOPE(Name) /*empty*/
 
+#  define EZ_PROFILE_SCOPE_INTERNED(szStaticScopeName) /*empty*/
+
+#  define EZ_PROFILE_COUNTER(szName, value) /*empty*/
+
+#  define EZ_PROFILE_HISTOGRAM(szName, latency) /*empty*/
+
 #  define EZ_PROFILE_LIST_SCOPE(szListName, szFirstSectionName) /*empty*/
 
 #  define EZ_PROFILE_LIST_NEXT_SECTION(szNextSectionName) /*empty*/
@@ -39,6 +39,9 @@ public:
   template <int N = 4>
   bool NoneSet() const; // [tested]
 
+  /// \brief Returns a bitmask with bit i set if component i is set.
+  ezUInt32 GetBitmask() const; // [tested]
+
 public:
   ezInternal::QuadBool m_v;
 };
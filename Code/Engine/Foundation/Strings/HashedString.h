@@ -14,7 +14,8 @@ class ezTempHashedString;
 /// (it's a pointer comparison).\n
 /// Copying ezHashedString objects around and assigning between them is very fast as well.\n
 /// \n
-/// Assigning from some other string type is rather slow though, as it requires thread synchronization.\n
+/// Assigning from some other string type is slower, as it requires a lookup in the central storage. Strings that already exist are found
+/// without taking any lock, adding new ones only locks one of many shards of the storage.\n
 /// You can also get access to the actual string data via GetString().\n
 /// \n
 /// You should use ezHashedString whenever the size of the encapsulating object is important and when changes to the string itself
@@ -32,9 +33,36 @@ public:
     ezString m_sString;
   };
 
-  // Do NOT use a hash-table! The map does not relocate memory when it resizes, which is a vital aspect for the hashed strings to work.
-  typedef ezMap<ezUInt64, HashedData, ezCompareHelper<ezUInt64>, ezStaticAllocatorWrapper> StringStorage;
-  typedef StringStorage::Iterator HashedType;
+  /// \brief One string in the central storage. Entries are never relocated, which is a vital aspect for the hashed strings to work.
+  struct HashedEntry
+  {
+    HashedData m_Value;
+    ezUInt64 m_Key = 0;
+
+    /// \brief The next entry in the same bucket. Written only while the bucket's shard is locked, but read without any lock.
+    HashedEntry* volatile m_pNext = nullptr;
+  };
+
+  /// \brief References one entry in the central string storage.
+  class HashedType
+  {
+  public:
+    HashedType() = default;
+    explicit HashedType(HashedEntry* pElement)
+      : m_pElement(pElement)
+    {
+    }
+
+    EZ_ALWAYS_INLINE bool IsValid() const { return m_pElement != nullptr; }
+    EZ_ALWAYS_INLINE ezUInt64 Key() const { return m_pElement->m_Key; }
+    EZ_ALWAYS_INLINE HashedData& Value() const { return m_pElement->m_Value; }
+
+    EZ_ALWAYS_INLINE bool operator==(const HashedType& rhs) const { return m_pElement == rhs.m_pElement; }
+    EZ_ALWAYS_INLINE bool operator!=(const HashedType& rhs) const { return m_pElement != rhs.m_pElement; }
+
+  private:
+    HashedEntry* m_pElement = nullptr;
+  };
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
   /// \brief This will remove all hashed strings from the central storage, that are not referenced anymore.
@@ -69,7 +97,7 @@ public:
   /// \brief Moves the given ezHashedString.
   void operator=(ezHashedString&& rhs); // [tested]
 
-  /// \brief Assigning a new string from a string constant is a slow operation, but the hash computation can happen at compile time.
+  /// \brief Assigning a new string from a string constant requires a lookup in the central storage, but the hash computation can happen at compile time.
   ///
   /// If you need to create an object to compare ezHashedString objects against, prefer to use ezTempHashedString. It will only compute
   /// the strings hash value, but does not require any thread synchronization.
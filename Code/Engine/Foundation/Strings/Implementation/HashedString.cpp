@@ -4,12 +4,118 @@
 #include <Foundation/Strings/HashedString.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+namespace
+{
+  // New strings only lock the shard that their hash maps to, so threads adding different strings rarely wait for each other.
+  // Existing strings are found without any lock, each bucket is a singly linked list that is only modified while its shard is locked.
+  constexpr ezUInt32 NumShards = 64;
+  constexpr ezUInt32 NumBucketsPerShard = 1024;
+
+  // Entries that ClearUnusedStrings() decided to delete get this ref count, so that lookups can't revive them anymore.
+  constexpr ezInt32 DeadRefCount = -0x40000000;
+
+  struct alignas(64) HashedStringShard
+  {
+    ezMutex m_Mutex;
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    // Epoch based reclamation: lock-free readers register in the slot of the current epoch. Before deleting unlinked entries,
+    // ClearUnusedStrings() advances the epoch and waits until the slot of the previous one has drained.
+    volatile ezInt32 m_iEpoch = 0;
+    volatile ezInt32 m_iActiveReaders[2] = {0, 0};
+#endif
+
+    ezHashedString::HashedEntry* volatile m_Buckets[NumBucketsPerShard] = {};
+  };
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  class ShardReadScope
+  {
+  public:
+    explicit ShardReadScope(HashedStringShard& shard)
+      : m_Shard(shard)
+    {
+      while (true)
+      {
+        const ezInt32 iEpoch = ezAtomicUtils::Read(m_Shard.m_iEpoch);
+        m_iSlot = iEpoch & 1;
+        ezAtomicUtils::Increment(m_Shard.m_iActiveReaders[m_iSlot]);
+
+        // if the epoch moved on in the mean time, the cleanup might not wait for the slot that we registered in
+        if (ezAtomicUtils::Read(m_Shard.m_iEpoch) == iEpoch)
+          break;
+
+        ezAtomicUtils::Decrement(m_Shard.m_iActiveReaders[m_iSlot]);
+      }
+    }
+
+    ~ShardReadScope() { ezAtomicUtils::Decrement(m_Shard.m_iActiveReaders[m_iSlot]); }
+
+  private:
+    HashedStringShard& m_Shard;
+    ezInt32 m_iSlot = 0;
+  };
+
+  bool TryAddReference(ezHashedString::HashedEntry* pEntry)
+  {
+    while (true)
+    {
+      const ezInt32 iRefCount = pEntry->m_Value.m_iRefCount;
+
+      if (iRefCount < 0)
+        return false;
+
+      if (pEntry->m_Value.m_iRefCount.TestAndSet(iRefCount, iRefCount + 1))
+        return true;
+    }
+  }
+#endif
+
+  ezHashedString::HashedEntry* FindEntry(ezHashedString::HashedEntry* const volatile& bucket, ezUInt64 uiHash)
+  {
+    for (ezHashedString::HashedEntry* pEntry = bucket; pEntry != nullptr; pEntry = pEntry->m_pNext)
+    {
+      if (pEntry->m_Key == uiHash)
+        return pEntry;
+    }
+
+    return nullptr;
+  }
+
+  void PublishEntry(ezHashedString::HashedEntry* volatile& link, ezHashedString::HashedEntry* pExpected, ezHashedString::HashedEntry* pNew)
+  {
+    // full barrier, the entry must be completely initialized before lock-free readers can reach it
+    const bool bSuccess = ezAtomicUtils::TestAndSet(reinterpret_cast<void**>(const_cast<ezHashedString::HashedEntry**>(&link)), pExpected, pNew);
+    EZ_IGNORE_UNUSED(bSuccess);
+    EZ_ASSERT_DEBUG(bSuccess, "Hashed string buckets may only be modified while their shard is locked");
+  }
+
+  void CheckForCollision(const ezHashedString::HashedEntry* pEntry, ezStringView szString)
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pEntry->m_Value.m_sString != szString)
+    {
+      // TODO: I think this should be a more serious issue
+      ezLog::Error("Hash collision encountered: Strings \"{}\" and \"{}\" both hash to {}.", ezArgSensitive(pEntry->m_Value.m_sString), ezArgSensitive(szString), pEntry->m_Key);
+    }
+#endif
+  }
+} // namespace
 
 struct HashedStringData
 {
-  ezMutex m_Mutex;
-  ezHashedString::StringStorage m_Storage;
+  HashedStringShard m_Shards[NumShards];
   ezHashedString::HashedType m_Empty;
+
+  HashedStringShard& GetShard(ezUInt64 uiHash) { return m_Shards[(uiHash >> 58) & (NumShards - 1)]; }
+  static ezHashedString::HashedEntry* volatile& GetBucket(HashedStringShard& shard, ezUInt64 uiHash) { return shard.m_Buckets[uiHash & (NumBucketsPerShard - 1)]; }
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  // only one ClearUnusedStrings() may advance the epochs at a time
+  ezMutex m_ClearMutex;
+#endif
 };
 
 static HashedStringData* s_pHSData;
@@ -23,37 +129,56 @@ ezHashedString::HashedType ezHashedString::AddHashedString(ezStringView szString
   if (s_pHSData == nullptr)
     InitHashedString();
 
-  EZ_LOCK(s_pHSData->m_Mutex);
-
-  // try to find the existing string
-  bool bExisted = false;
-  auto ret = s_pHSData->m_Storage.FindOrAdd(uiHash, &bExisted);
+  HashedStringShard& shard = s_pHSData->GetShard(uiHash);
+  HashedEntry* volatile& bucket = HashedStringData::GetBucket(shard, uiHash);
 
-  // if it already exists, just increase the refcount
-  if (bExisted)
+  // try to find the existing string without locking
   {
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-    if (ret.Value().m_sString != szString)
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    ShardReadScope readScope(shard);
+
+    HashedEntry* pEntry = FindEntry(bucket, uiHash);
+    if (pEntry != nullptr && TryAddReference(pEntry))
     {
-      // TODO: I think this should be a more serious issue
-      ezLog::Error("Hash collision encountered: Strings \"{}\" and \"{}\" both hash to {}.", ezArgSensitive(ret.Value().m_sString), ezArgSensitive(szString), uiHash);
+      CheckForCollision(pEntry, szString);
+      return HashedType(pEntry);
+    }
+#else
+    HashedEntry* pEntry = FindEntry(bucket, uiHash);
+    if (pEntry != nullptr)
+    {
+      CheckForCollision(pEntry, szString);
+      return HashedType(pEntry);
     }
 #endif
+  }
+
+  EZ_LOCK(shard.m_Mutex);
+
+  // another thread might have added it in the mean time
+  // entries that are about to be deleted are unlinked while the lock is held, so anything we find here is alive
+  if (HashedEntry* pEntry = FindEntry(bucket, uiHash))
+  {
+    CheckForCollision(pEntry, szString);
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    ret.Value().m_iRefCount.Increment();
+    pEntry->m_Value.m_iRefCount.Increment();
 #endif
+
+    return HashedType(pEntry);
   }
-  else
-  {
-    ezHashedString::HashedData& d = ret.Value();
+
+  HashedEntry* pEntry = EZ_NEW(ezStaticAllocatorWrapper::GetAllocator(), HashedEntry);
+  pEntry->m_Key = uiHash;
+  pEntry->m_Value.m_sString = szString;
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    d.m_iRefCount = 1;
+  pEntry->m_Value.m_iRefCount = 1;
 #endif
-    d.m_sString = szString;
-  }
+  pEntry->m_pNext = bucket;
+
+  PublishEntry(bucket, pEntry->m_pNext, pEntry);
 
-  return ret;
+  return HashedType(pEntry);
 }
 
 EZ_MSVC_ANALYSIS_WARNING_POP
@@ -79,19 +204,57 @@ void ezHashedString::InitHashedString()
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
 ezUInt32 ezHashedString::ClearUnusedStrings()
 {
-  EZ_LOCK(s_pHSData->m_Mutex);
+  EZ_LOCK(s_pHSData->m_ClearMutex);
 
   ezUInt32 uiDeleted = 0;
+  ezDynamicArray<HashedEntry*> unlinked;
 
-  for (auto it = s_pHSData->m_Storage.GetIterator(); it.IsValid();)
+  for (HashedStringShard& shard : s_pHSData->m_Shards)
   {
-    if (it.Value().m_iRefCount == 0)
+    unlinked.Clear();
+
     {
-      it = s_pHSData->m_Storage.Remove(it);
-      ++uiDeleted;
+      EZ_LOCK(shard.m_Mutex);
+
+      for (HashedEntry* volatile& bucket : shard.m_Buckets)
+      {
+        HashedEntry* volatile* pLink = &bucket;
+
+        while (HashedEntry* pEntry = *pLink)
+        {
+          // only entries that nobody references anymore can be claimed, a concurrent lookup either revives it before this or fails afterwards
+          if (pEntry->m_Value.m_iRefCount.TestAndSet(0, DeadRefCount))
+          {
+            // the entry keeps its next pointer, so that readers that currently look at it can continue walking the bucket
+            PublishEntry(*pLink, pEntry, pEntry->m_pNext);
+            unlinked.PushBack(pEntry);
+          }
+          else
+          {
+            pLink = &pEntry->m_pNext;
+          }
+        }
+      }
     }
-    else
-      ++it;
+
+    if (unlinked.IsEmpty())
+      continue;
+
+    // wait until no reader can hold a pointer to the unlinked entries anymore
+    const ezInt32 iEpoch = ezAtomicUtils::Read(shard.m_iEpoch);
+    ezAtomicUtils::Set(shard.m_iEpoch, iEpoch + 1);
+
+    while (ezAtomicUtils::Read(shard.m_iActiveReaders[iEpoch & 1]) != 0)
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    for (HashedEntry* pEntry : unlinked)
+    {
+      EZ_DELETE(ezStaticAllocatorWrapper::GetAllocator(), pEntry);
+    }
+
+    uiDeleted += unlinked.GetCount();
   }
 
   return uiDeleted;
@@ -81,6 +81,8 @@ void ezSystemInformation::Initialize()
     strcpy(s_SystemInformation.m_sHostName, "");
   }
 
+  DetectCPUFeatures();
+
   s_SystemInformation.m_bIsInitialized = true;
 }
 
@@ -2,9 +2,77 @@
 
 #include <Foundation/System/SystemInformation.h>
 
+#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+#  if EZ_ENABLED(EZ_COMPILER_MSVC)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
 // Storage for the current configuration
 ezSystemInformation ezSystemInformation::s_SystemInformation;
 
+#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+namespace
+{
+  void CpuId(ezUInt32 uiLeaf, ezUInt32 uiSubLeaf, ezUInt32* out_pRegisters)
+  {
+#  if EZ_ENABLED(EZ_COMPILER_MSVC)
+    int registers[4];
+    __cpuidex(registers, static_cast<int>(uiLeaf), static_cast<int>(uiSubLeaf));
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      out_pRegisters[i] = static_cast<ezUInt32>(registers[i]);
+    }
+#  else
+    __cpuid_count(uiLeaf, uiSubLeaf, out_pRegisters[0], out_pRegisters[1], out_pRegisters[2], out_pRegisters[3]);
+#  endif
+  }
+
+  ezUInt64 GetExtendedControlRegister()
+  {
+#  if EZ_ENABLED(EZ_COMPILER_MSVC)
+    return _xgetbv(0);
+#  else
+    ezUInt32 uiLow, uiHigh;
+    __asm__ volatile("xgetbv" : "=a"(uiLow), "=d"(uiHigh) : "c"(0));
+    return (static_cast<ezUInt64>(uiHigh) << 32) | uiLow;
+#  endif
+  }
+} // namespace
+#endif
+
+void ezSystemInformation::DetectCPUFeatures()
+{
+  s_SystemInformation.m_bSupportsAVX2 = false;
+  s_SystemInformation.m_bSupportsAVX512 = false;
+
+#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+  ezUInt32 registers[4]; // eax, ebx, ecx, edx
+
+  CpuId(0, 0, registers);
+  const ezUInt32 uiMaxLeaf = registers[0];
+  if (uiMaxLeaf < 7)
+    return;
+
+  // The CPU may support the wide registers, but they are only usable if the OS saves them on context switches.
+  CpuId(1, 0, registers);
+  const bool bOSXSave = (registers[2] & EZ_BIT(27)) != 0;
+  const bool bAVX = (registers[2] & EZ_BIT(28)) != 0;
+  if (!bOSXSave || !bAVX)
+    return;
+
+  const ezUInt64 uiXCR0 = GetExtendedControlRegister();
+  const bool bOSSavesYMM = (uiXCR0 & 0x06) == 0x06; // SSE and AVX state
+  const bool bOSSavesZMM = (uiXCR0 & 0xE6) == 0xE6; // additionally opmask and upper ZMM state
+
+  CpuId(7, 0, registers);
+  s_SystemInformation.m_bSupportsAVX2 = bOSSavesYMM && (registers[1] & EZ_BIT(5)) != 0;
+  s_SystemInformation.m_bSupportsAVX512 = bOSSavesZMM && (registers[1] & EZ_BIT(16)) != 0;
+#endif
+}
+
 // Include inline file
 #if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
 #  include <Foundation/System/Implementation/Win/SystemInformation_win.h>
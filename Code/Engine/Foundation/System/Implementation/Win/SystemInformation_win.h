@@ -109,6 +109,8 @@ void ezSystemInformation::Initialize()
   GetComputerNameA(s_SystemInformation.m_sHostName, &bufCharCount);
 #endif
 
+  DetectCPUFeatures();
+
   s_SystemInformation.m_bIsInitialized = true;
 }
 
@@ -25,6 +25,12 @@ public:
   /// \brief Returns true if the process is currently running on a 64-bit OS.
   inline bool Is64BitOS() const { return m_b64BitOS; }
 
+  /// \brief Returns true if both the CPU and the OS support AVX2 (256 bit wide integer and float operations).
+  inline bool SupportsAVX2() const { return m_bSupportsAVX2; }
+
+  /// \brief Returns true if both the CPU and the OS support the AVX-512 foundation instructions (512 bit wide operations).
+  inline bool SupportsAVX512() const { return m_bSupportsAVX512; }
+
   inline const char* GetPlatformName() const { return m_szPlatformName; }
 
   inline const char* GetHostName() const { return m_sHostName; }
@@ -52,10 +58,13 @@ private:
   const char* m_szBuildConfiguration;
   char m_sHostName[256];
   bool m_b64BitOS;
+  bool m_bSupportsAVX2;
+  bool m_bSupportsAVX512;
   bool m_bIsInitialized;
 
 
   static void Initialize();
+  static void DetectCPUFeatures();
 
   static ezSystemInformation s_SystemInformation;
 };
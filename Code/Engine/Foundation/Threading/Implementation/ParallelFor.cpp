@@ -1,15 +1,17 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 /// \brief This is a helper class that splits up task items via index ranges.
 class IndexedTask final : public ezTask
 {
 public:
-  IndexedTask(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, ezUInt32 uiItemsPerInvocation)
+  IndexedTask(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, ezUInt32 uiItemsPerInvocation, bool bMeasureBusyTime = false)
     : m_uiStartIndex(uiStartIndex)
     , m_uiNumItems(uiNumItems)
     , m_uiItemsPerInvocation(uiItemsPerInvocation)
+    , m_bMeasureBusyTime(bMeasureBusyTime)
     , m_TaskCallback(std::move(taskCallback))
   {
   }
@@ -22,20 +24,228 @@ public:
 
   void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
   {
-    const ezUInt32 uiSliceStartIndex = uiInvocation * m_uiItemsPerInvocation;
+    const ezTime tStart = m_bMeasureBusyTime ? ezTime::Now() : ezTime::Zero();
+
+    const ezUInt32 uiSliceStartIndex = m_uiStartIndex + uiInvocation * m_uiItemsPerInvocation;
     const ezUInt32 uiSliceEndIndex = ezMath::Min(uiSliceStartIndex + m_uiItemsPerInvocation, m_uiStartIndex + m_uiNumItems);
 
     // Run through the calculated slice, the end index is exclusive, i.e., should not be handled by this instance.
-    m_TaskCallback(uiSliceStartIndex, uiSliceEndIndex);
+    if (uiSliceStartIndex < uiSliceEndIndex)
+    {
+      m_TaskCallback(uiSliceStartIndex, uiSliceEndIndex);
+    }
+
+    if (m_bMeasureBusyTime)
+    {
+      m_iBusyNanoseconds.Add(static_cast<ezInt64>((ezTime::Now() - tStart).GetNanoseconds()));
+    }
   }
 
+  ezTime GetBusyTime() const { return ezTime::Nanoseconds(static_cast<double>(m_iBusyNanoseconds)); }
+
 private:
   ezUInt32 m_uiStartIndex;
   ezUInt32 m_uiNumItems;
   ezUInt32 m_uiItemsPerInvocation;
+  bool m_bMeasureBusyTime;
+  ezParallelForIndexedFunction m_TaskCallback;
+  mutable ezAtomicInteger64 m_iBusyNanoseconds;
+};
+
+/// \brief Processes an index range by lazy binary splitting.
+///
+/// Every invocation owns one range slot. Initially the first slot holds the entire range and all others are empty.
+/// An invocation takes chunks of 'grain size' items from the front of its own range. Once its range is empty, it looks for the slot with the
+/// most remaining items and steals the upper half of it. Thus ranges only get subdivided when there actually is an idle thread to work on
+/// the other half.
+class LazyIndexedTask final : public ezTask
+{
+public:
+  LazyIndexedTask(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, ezUInt32 uiGrainSize, ezUInt32 uiNumSlots, bool bMeasureBusyTime)
+    : m_uiGrainSize(uiGrainSize)
+    , m_bMeasureBusyTime(bMeasureBusyTime)
+    , m_TaskCallback(std::move(taskCallback))
+  {
+    EZ_ASSERT_DEV(uiNumSlots <= MaxSlots, "Too many range slots");
+
+    m_uiNumSlots = uiNumSlots;
+    m_Slots[0].m_iRange = Pack(uiStartIndex, uiStartIndex + uiNumItems);
+  }
+
+  static constexpr ezUInt32 MaxSlots = 64;
+
+  void Execute() override { ExecuteWithMultiplicity(0); }
+
+  void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+  {
+    const ezTime tStart = m_bMeasureBusyTime ? ezTime::Now() : ezTime::Zero();
+
+    ezUInt32 uiNumChunks = 0;
+    ezUInt32 uiFirst, uiEnd;
+
+    while (true)
+    {
+      while (ClaimChunk(uiInvocation, uiFirst, uiEnd))
+      {
+        m_TaskCallback(uiFirst, uiEnd);
+        ++uiNumChunks;
+      }
+
+      if (!StealHalf(uiInvocation))
+        break;
+    }
+
+    if (m_bMeasureBusyTime)
+    {
+      m_iNumChunks.Add(uiNumChunks);
+      m_iBusyNanoseconds.Add(static_cast<ezInt64>((ezTime::Now() - tStart).GetNanoseconds()));
+    }
+  }
+
+  ezUInt32 GetNumChunks() const { return static_cast<ezUInt32>(m_iNumChunks); }
+  ezUInt32 GetNumSplits() const { return static_cast<ezUInt32>(m_iNumSplits); }
+  ezTime GetBusyTime() const { return ezTime::Nanoseconds(static_cast<double>(m_iBusyNanoseconds)); }
+
+private:
+  // begin in the lower, end in the upper 32 bits, so that both can be modified with a single CAS
+  static ezInt64 Pack(ezUInt32 uiBegin, ezUInt32 uiEnd) { return static_cast<ezInt64>((static_cast<ezUInt64>(uiEnd) << 32) | uiBegin); }
+  static ezUInt32 GetBegin(ezInt64 iRange) { return static_cast<ezUInt32>(static_cast<ezUInt64>(iRange) & 0xFFFFFFFFu); }
+  static ezUInt32 GetEnd(ezInt64 iRange) { return static_cast<ezUInt32>(static_cast<ezUInt64>(iRange) >> 32); }
+
+  bool ClaimChunk(ezUInt32 uiSlot, ezUInt32& out_uiFirst, ezUInt32& out_uiEnd) const
+  {
+    volatile ezInt64& iRange = m_Slots[uiSlot].m_iRange;
+
+    while (true)
+    {
+      const ezInt64 iOld = ezAtomicUtils::Read(iRange);
+      const ezUInt32 uiBegin = GetBegin(iOld);
+      const ezUInt32 uiEnd = GetEnd(iOld);
+
+      if (uiBegin >= uiEnd)
+        return false;
+
+      const ezUInt32 uiChunkEnd = ezMath::Min(uiEnd, uiBegin + m_uiGrainSize);
+
+      if (ezAtomicUtils::TestAndSet(iRange, iOld, Pack(uiChunkEnd, uiEnd)))
+      {
+        out_uiFirst = uiBegin;
+        out_uiEnd = uiChunkEnd;
+        return true;
+      }
+    }
+  }
+
+  bool StealHalf(ezUInt32 uiSlot) const
+  {
+    while (true)
+    {
+      ezUInt32 uiVictim = ezInvalidIndex;
+      ezUInt32 uiMaxRemaining = 0;
+      ezInt64 iVictimRange = 0;
+
+      for (ezUInt32 i = 0; i < m_uiNumSlots; ++i)
+      {
+        if (i == uiSlot)
+          continue;
+
+        const ezInt64 iRange = ezAtomicUtils::Read(m_Slots[i].m_iRange);
+        const ezUInt32 uiBegin = GetBegin(iRange);
+        const ezUInt32 uiEnd = GetEnd(iRange);
+
+        if (uiBegin < uiEnd && uiEnd - uiBegin > uiMaxRemaining)
+        {
+          uiVictim = i;
+          uiMaxRemaining = uiEnd - uiBegin;
+          iVictimRange = iRange;
+        }
+      }
+
+      if (uiVictim == ezInvalidIndex)
+        return false;
+
+      const ezUInt32 uiBegin = GetBegin(iVictimRange);
+      const ezUInt32 uiEnd = GetEnd(iVictimRange);
+
+      // take the upper half, or everything if the remaining range is too small to be split into two chunks
+      const ezUInt32 uiMid = (uiMaxRemaining >= 2 * m_uiGrainSize) ? uiBegin + uiMaxRemaining / 2 : uiBegin;
+
+      if (ezAtomicUtils::TestAndSet(m_Slots[uiVictim].m_iRange, iVictimRange, Pack(uiBegin, uiMid)))
+      {
+        // nobody steals from our slot while it is empty, so a plain exchange is sufficient
+        ezAtomicUtils::Set(m_Slots[uiSlot].m_iRange, Pack(uiMid, uiEnd));
+
+        if (m_bMeasureBusyTime)
+        {
+          m_iNumSplits.Increment();
+        }
+
+        return true;
+      }
+    }
+  }
+
+  struct alignas(64) Slot
+  {
+    volatile ezInt64 m_iRange = 0;
+  };
+
+  ezUInt32 m_uiNumSlots = 0;
+  ezUInt32 m_uiGrainSize = 1;
+  bool m_bMeasureBusyTime = false;
   ezParallelForIndexedFunction m_TaskCallback;
+
+  mutable Slot m_Slots[MaxSlots];
+  mutable ezAtomicInteger32 m_iNumChunks;
+  mutable ezAtomicInteger32 m_iNumSplits;
+  mutable ezAtomicInteger64 m_iBusyNanoseconds;
 };
 
+void ezParallelForStats::AddSample(ezUInt32 uiNumItems, ezTime duration, ezTime busyTime, ezUInt32 uiGrainSize, ezUInt32 uiNumChunks, ezUInt32 uiNumSplits)
+{
+  m_LastDuration = duration;
+  m_LastBusyTime = busyTime;
+  m_uiLastNumItems = uiNumItems;
+  m_uiLastGrainSize = uiGrainSize;
+  m_uiLastNumChunks = uiNumChunks;
+  m_uiLastNumSplits = uiNumSplits;
+  ++m_uiNumCalls;
+
+  if (uiNumItems == 0)
+    return;
+
+  const ezTime itemCost = busyTime / uiNumItems;
+
+  if (m_AverageItemCost.IsZero())
+  {
+    m_AverageItemCost = itemCost;
+  }
+  else
+  {
+    // exponential moving average, smooths out single frames that got interrupted by the OS
+    m_AverageItemCost = m_AverageItemCost * 0.75 + itemCost * 0.25;
+  }
+}
+
+ezUInt32 ezParallelForParams::DetermineGrainSize(ezUInt32 uiNumTaskItems) const
+{
+  ezUInt32 uiGrainSize = ezMath::Max(uiBinSize, 1u);
+
+  if (pStats != nullptr && pStats->m_AverageItemCost.IsPositive())
+  {
+    const double fItems = targetChunkDuration.GetSeconds() / pStats->m_AverageItemCost.GetSeconds();
+    uiGrainSize = ezMath::Max(uiGrainSize, static_cast<ezUInt32>(ezMath::Min(fItems + 0.5, static_cast<double>(uiNumTaskItems))));
+  }
+  else
+  {
+    // without any timing data, limit the overhead to a fixed number of chunks per thread
+    const ezUInt32 uiNumWorkers = ezMath::Max(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), 1u);
+    uiGrainSize = ezMath::Max(uiGrainSize, uiNumTaskItems / (uiNumWorkers * ezMath::Max(uiMaxTasksPerThread, 1u) * 16));
+  }
+
+  return uiGrainSize;
+}
+
 ezUInt32 ezParallelForParams::DetermineMultiplicity(ezUInt32 uiNumTaskItems) const
 {
   // If we have not exceeded the threading threshold we will indicate to use serial execution.
@@ -82,31 +292,104 @@ ezUInt32 ezParallelForParams::DetermineItemsPerInvocation(ezUInt32 uiNumTaskItem
   return uiItemsPerInvocation;
 }
 
+bool ezTaskSystem::AreNestedTasksAllowed()
+{
+  return tl_TaskWorkerInfo.m_bAllowNestedTasks;
+}
+
+static void ParallelForIndexedLazy(
+  ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, const char* taskName, const ezParallelForParams& params)
+{
+  // timing is only needed to feed the statistics, skip it otherwise
+  const ezTime tStart = params.pStats ? ezTime::Now() : ezTime::Zero();
+
+  // a task that is flagged to never wait for other tasks has to do all the work itself
+  const ezUInt32 uiGrainSize = tl_TaskWorkerInfo.m_bAllowNestedTasks ? params.DetermineGrainSize(uiNumItems) : uiNumItems;
+
+  if (uiGrainSize >= uiNumItems)
+  {
+    {
+      EZ_PROFILE_SCOPE(taskName ? taskName : "Generic Indexed Task");
+      taskCallback(uiStartIndex, uiStartIndex + uiNumItems);
+    }
+
+    if (params.pStats)
+    {
+      const ezTime duration = ezTime::Now() - tStart;
+      params.pStats->AddSample(uiNumItems, duration, duration, uiGrainSize, 1, 0);
+    }
+
+    return;
+  }
+
+  // one invocation per thread that can help, the waiting thread helps as well
+  const ezUInt32 uiNumWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1;
+  const ezUInt32 uiNumChunks = (uiNumItems + uiGrainSize - 1) / uiGrainSize;
+  const ezUInt32 uiMultiplicity = ezMath::Min(ezMath::Min(uiNumWorkers, uiNumChunks), LazyIndexedTask::MaxSlots);
+
+  ezAllocatorBase* pAllocator = (params.pTaskAllocator != nullptr) ? params.pTaskAllocator : ezFoundation::GetDefaultAllocator();
+
+  ezSharedPtr<LazyIndexedTask> pTask = EZ_NEW(pAllocator, LazyIndexedTask, uiStartIndex, uiNumItems, std::move(taskCallback), uiGrainSize, uiMultiplicity, params.pStats != nullptr);
+  pTask->ConfigureTask(taskName ? taskName : "Generic Indexed Task", params.nestingMode);
+  pTask->SetMultiplicity(uiMultiplicity);
+
+  ezTaskGroupID taskGroupId = ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::EarlyThisFrame);
+  ezTaskSystem::WaitForGroup(taskGroupId);
+
+  if (params.pStats)
+  {
+    params.pStats->AddSample(uiNumItems, ezTime::Now() - tStart, pTask->GetBusyTime(), uiGrainSize, pTask->GetNumChunks(), pTask->GetNumSplits());
+  }
+}
+
 void ezTaskSystem::ParallelForIndexed(
   ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, const char* taskName, const ezParallelForParams& params)
 {
-  const ezUInt32 uiMultiplicity = params.DetermineMultiplicity(uiNumItems);
-  const ezUInt32 uiItemsPerInvocation = params.DetermineItemsPerInvocation(uiNumItems, uiMultiplicity);
+  if (params.splitMode == ezParallelForSplitMode::Lazy)
+  {
+    ParallelForIndexedLazy(uiStartIndex, uiNumItems, std::move(taskCallback), taskName, params);
+    return;
+  }
+
+  const ezTime tStart = params.pStats ? ezTime::Now() : ezTime::Zero();
 
+  // a task that is flagged to never wait for other tasks has to do all the work itself
+  const ezUInt32 uiMultiplicity = tl_TaskWorkerInfo.m_bAllowNestedTasks ? params.DetermineMultiplicity(uiNumItems) : 0;
+  const ezUInt32 uiItemsPerInvocation = params.DetermineItemsPerInvocation(uiNumItems, uiMultiplicity);
+  ezTime busyTime;
 
   if (uiMultiplicity == 0)
   {
     IndexedTask indexedTask(uiStartIndex, uiNumItems, std::move(taskCallback), uiItemsPerInvocation);
-    indexedTask.ConfigureTask(taskName ? taskName : "Generic Indexed Task", ezTaskNesting::Never);
+    indexedTask.ConfigureTask(taskName ? taskName : "Generic Indexed Task", params.nestingMode);
+
+    {
+      EZ_PROFILE_SCOPE(indexedTask.m_sTaskName);
+      indexedTask.Execute();
+    }
 
-    EZ_PROFILE_SCOPE(indexedTask.m_sTaskName);
-    indexedTask.Execute();
+    if (params.pStats)
+    {
+      busyTime = ezTime::Now() - tStart;
+    }
   }
   else
   {
     ezAllocatorBase* pAllocator = (params.pTaskAllocator != nullptr) ? params.pTaskAllocator : ezFoundation::GetDefaultAllocator();
 
-    ezSharedPtr<IndexedTask> pIndexedTask = EZ_NEW(pAllocator, IndexedTask, uiStartIndex, uiNumItems, std::move(taskCallback), uiItemsPerInvocation);
-    pIndexedTask->ConfigureTask(taskName ? taskName : "Generic Indexed Task", ezTaskNesting::Never);
+    ezSharedPtr<IndexedTask> pIndexedTask = EZ_NEW(pAllocator, IndexedTask, uiStartIndex, uiNumItems, std::move(taskCallback), uiItemsPerInvocation, params.pStats != nullptr);
+    pIndexedTask->ConfigureTask(taskName ? taskName : "Generic Indexed Task", params.nestingMode);
 
     pIndexedTask->SetMultiplicity(uiMultiplicity);
     ezTaskGroupID taskGroupId = ezTaskSystem::StartSingleTask(pIndexedTask, ezTaskPriority::EarlyThisFrame);
     ezTaskSystem::WaitForGroup(taskGroupId);
+
+    busyTime = pIndexedTask->GetBusyTime();
+  }
+
+  if (params.pStats)
+  {
+    params.pStats->AddSample(uiNumItems, ezTime::Now() - tStart, busyTime, uiItemsPerInvocation, ezMath::Max(uiMultiplicity, 1u), 0);
   }
 }
 
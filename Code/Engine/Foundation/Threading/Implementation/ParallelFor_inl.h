@@ -45,7 +45,20 @@ template <typename ElemType>
 void ezTaskSystem::ParallelForInternal(
   ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& config)
 {
-  const ezUInt32 uiMultiplicity = config.DetermineMultiplicity(taskItems.GetCount());
+  if (config.splitMode == ezParallelForSplitMode::Lazy || config.pStats != nullptr)
+  {
+    // range splitting and timing are implemented by the indexed version, just map the index ranges back to slices
+    ParallelForIndexed(
+      0, taskItems.GetCount(),
+      [taskItems, &taskCallback](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        taskCallback(uiStartIndex, taskItems.GetSubArray(uiStartIndex, uiEndIndex - uiStartIndex));
+      },
+      taskName ? taskName : "Generic ArrayPtr Task", config);
+    return;
+  }
+
+  // a task that is flagged to never wait for other tasks has to do all the work itself
+  const ezUInt32 uiMultiplicity = AreNestedTasksAllowed() ? config.DetermineMultiplicity(taskItems.GetCount()) : 0;
   const ezUInt32 uiItemsPerInvocation = config.DetermineItemsPerInvocation(taskItems.GetCount(), uiMultiplicity);
 
 
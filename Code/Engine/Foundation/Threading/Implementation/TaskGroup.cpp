@@ -22,14 +22,72 @@ void ezTaskGroup::WaitForFinish(ezTaskGroupID group) const
 
 void ezTaskGroup::Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback callback)
 {
-  m_bInUse = true;
+  m_bInUse.store(true, std::memory_order_relaxed);
   m_bStartedByUser = false;
-  m_uiGroupCounter += 2; // even if it wraps around, it will never be zero, thus zero stays an invalid group counter
   m_Tasks.Clear();
   m_DependsOnGroups.Clear();
-  m_OthersDependingOnMe.Clear();
   m_Priority = priority;
   m_OnFinishedCallback = callback;
+  m_pFirstDependent.store(nullptr, std::memory_order_relaxed);
+
+  // publishes the reset above, a thread that sees the new counter in TryAddDependent() also sees the empty list of dependents
+  // even if it wraps around, it will never be zero, thus zero stays an invalid group counter
+  m_uiGroupCounter.fetch_add(2, std::memory_order_release);
+}
+
+// the value of m_pFirstDependent once a group has finished, no further dependents may be added then
+static ezUInt8 s_DependentsClosed = 0;
+
+bool ezTaskGroup::TryAddDependent(ezUInt32 uiExpectedGroupCounter, Dependency* pDependency)
+{
+  // As long as m_iPendingRegistrations is non-zero, this group can't be reused (see IsAvailableForReuse()).
+  // Both the increment and the counter checks are sequentially consistent, so either the thread that finishes this group sees the pending
+  // registration and doesn't reuse the group, or this thread sees the counter that was changed when the group finished.
+  m_iPendingRegistrations.fetch_add(1);
+
+  bool bAdded = false;
+
+  if (m_uiGroupCounter.load() == uiExpectedGroupCounter)
+  {
+    while (true)
+    {
+      void* pHead = m_pFirstDependent.load(std::memory_order_acquire);
+
+      if (pHead == &s_DependentsClosed)
+        break;
+
+      pDependency->m_pNextDependent = static_cast<Dependency*>(pHead);
+
+      if (m_pFirstDependent.compare_exchange_weak(pHead, pDependency, std::memory_order_acq_rel, std::memory_order_relaxed))
+      {
+        bAdded = true;
+        break;
+      }
+    }
+
+    if (bAdded && m_uiGroupCounter.load() != uiExpectedGroupCounter)
+    {
+      // The group finished while the dependency was registered. If nothing was added on top of it and the list isn't closed yet,
+      // take the registration back, the dependency is fulfilled already. Otherwise the finishing thread will notify the dependent.
+      void* pExpected = pDependency;
+      if (m_pFirstDependent.compare_exchange_strong(pExpected, pDependency->m_pNextDependent, std::memory_order_acq_rel, std::memory_order_relaxed))
+      {
+        bAdded = false;
+      }
+    }
+  }
+
+  m_iPendingRegistrations.fetch_sub(1, std::memory_order_release);
+  return bAdded;
+}
+
+ezTaskGroup::Dependency* ezTaskGroup::CloseDependents()
+{
+  void* pHead = m_pFirstDependent.exchange(&s_DependentsClosed, std::memory_order_acq_rel);
+
+  EZ_ASSERT_DEBUG(pHead != &s_DependentsClosed, "Task group has been finished twice");
+
+  return static_cast<Dependency*>(pHead);
 }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
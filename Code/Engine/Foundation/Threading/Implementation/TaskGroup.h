@@ -5,6 +5,8 @@
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
 #include <Foundation/Types/SharedPtr.h>
 
+#include <atomic>
+
 /// \internal Represents the state of a group of tasks that can be waited on
 class ezTaskGroup
 {
@@ -23,17 +25,40 @@ private:
   EZ_ALWAYS_INLINE static void DebugCheckTaskGroup(ezTaskGroupID groupID, ezMutex& mutex) {}
 #endif
 
+  /// \brief An entry in m_DependsOnGroups.
+  ///
+  /// Once the owning group is started, the entry is also a node in the intrusive list of dependents of the group that it depends on.
+  struct Dependency
+  {
+    ezTaskGroupID m_DependsOn;
+    ezTaskGroup* m_pDependent = nullptr;
+    Dependency* m_pNextDependent = nullptr;
+  };
+
   /// \brief Puts the calling thread to sleep until this group is fully finished.
   void WaitForFinish(ezTaskGroupID group) const;
   void Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback callback);
 
-  bool m_bInUse = true;
+  /// \brief Returns whether the group can be reused, i.e. it is finished and no other thread is about to add itself as a dependent.
+  bool IsAvailableForReuse() const { return !m_bInUse.load(std::memory_order_acquire) && m_iPendingRegistrations.load() == 0; }
+
+  /// \brief Adds \a pDependency to the list of groups that get notified when this group finishes.
+  ///
+  /// Returns false, if the group has already finished (or is finishing right now), in which case the dependency is fulfilled already.
+  /// \a uiExpectedGroupCounter is the group counter of the ID that the dependency was added with.
+  bool TryAddDependent(ezUInt32 uiExpectedGroupCounter, Dependency* pDependency);
+
+  /// \brief Prevents any further dependents from being added and returns the list of dependents that were added so far.
+  Dependency* CloseDependents();
+
+  std::atomic<bool> m_bInUse = {true};
   bool m_bStartedByUser = false;
   ezUInt16 m_uiTaskGroupIndex = 0xFFFF; // only there as a debugging aid
-  ezUInt32 m_uiGroupCounter = 1;
+  std::atomic<ezUInt32> m_uiGroupCounter = {1};
   ezHybridArray<ezSharedPtr<ezTask>, 16> m_Tasks;
-  ezHybridArray<ezTaskGroupID, 4> m_DependsOnGroups;
-  ezHybridArray<ezTaskGroupID, 8> m_OthersDependingOnMe;
+  ezHybridArray<Dependency, 4> m_DependsOnGroups;
+  std::atomic<void*> m_pFirstDependent = {nullptr};  // lock-free list of the groups that depend on this one, see TryAddDependent()
+  std::atomic<ezInt32> m_iPendingRegistrations = {0}; // number of threads that are currently inside TryAddDependent()
   ezAtomicInteger32 m_iNumActiveDependencies;
   ezAtomicInteger32 m_iNumRemainingTasks;
   ezOnTaskGroupFinishedCallback m_OnFinishedCallback;
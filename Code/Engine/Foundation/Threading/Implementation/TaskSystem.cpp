@@ -38,6 +38,7 @@ void ezTaskSystem::Startup()
 
   tl_TaskWorkerInfo.m_WorkerType = ezWorkerThreadType::MainThread;
   tl_TaskWorkerInfo.m_iWorkerIndex = 0;
+  tl_TaskWorkerInfo.m_pLocalQueues = &s_ThreadState->m_MainThreadQueues;
 
   // initialize with the default number of worker threads
   SetWorkerThreadCount();
@@ -47,6 +48,8 @@ void ezTaskSystem::Shutdown()
 {
   StopWorkerThreads();
 
+  tl_TaskWorkerInfo.m_pLocalQueues = nullptr;
+
   s_State.Clear();
   s_ThreadState.Clear();
 }
@@ -12,6 +12,7 @@ class ezTaskGroup;
 class ezTaskWorkerThread;
 class ezTaskSystemState;
 class ezTaskSystemThreadState;
+struct ezTaskThreadQueues;
 class ezDGMLGraph;
 class ezAllocatorBase;
 
@@ -162,6 +163,46 @@ enum class ezTaskNesting
   Never,
 };
 
+/// \brief Describes how ezTaskSystem::ParallelFor distributes the items over the worker threads.
+enum class ezParallelForSplitMode
+{
+  Static, ///< The items are split into a fixed number of equally sized bins up front (see ezParallelForParams::uiBinSize).
+  Lazy,   ///< Ranges are only split in half when an idle thread steals from them. Adapts to the number of cores and uneven workloads.
+};
+
+/// \brief Timing data of a ParallelFor call site.
+///
+/// Pass a pointer to an instance through ezParallelForParams::pStats to have every call report how long it took.
+/// In ezParallelForSplitMode::Lazy the measured cost per item is used to pick the grain size of the next call,
+/// such that each chunk of work takes roughly ezParallelForParams::targetChunkDuration.
+///
+/// The stats are not synchronized, so the same instance must not be used by multiple ParallelFor calls that run at the same time.
+struct EZ_FOUNDATION_DLL ezParallelForStats
+{
+  /// \brief Records the results of one ParallelFor call.
+  void AddSample(ezUInt32 uiNumItems, ezTime duration, ezTime busyTime, ezUInt32 uiGrainSize, ezUInt32 uiNumChunks, ezUInt32 uiNumSplits);
+
+  /// \brief Wall clock time of the last call.
+  ezTime m_LastDuration;
+
+  /// \brief Processing time of the last call, summed up over all threads that participated.
+  ezTime m_LastBusyTime;
+
+  /// \brief Smoothed processing time of a single item. Zero until the first call has finished.
+  ezTime m_AverageItemCost;
+
+  ezUInt32 m_uiLastNumItems = 0;
+  ezUInt32 m_uiLastGrainSize = 0;
+
+  /// \brief Into how many pieces the work was cut by the last call. 1, if it was executed serially.
+  ezUInt32 m_uiLastNumChunks = 0;
+
+  /// \brief How often ranges were split by stealing threads in the last call.
+  ezUInt32 m_uiLastNumSplits = 0;
+
+  ezUInt32 m_uiNumCalls = 0;
+};
+
 /// \brief Settings for ezTaskSystem::ParallelFor invocations.
 struct EZ_FOUNDATION_DLL ezParallelForParams
 {
@@ -170,6 +211,7 @@ struct EZ_FOUNDATION_DLL ezParallelForParams
   /// The minimum number of items that must be processed by a task instance.
   /// If the overall number of tasks lies below this value, all work will be executed purely serially
   /// without involving any tasks at all.
+  /// In ezParallelForSplitMode::Lazy this is the minimum grain size.
   ezUInt32 uiBinSize = 1;
 
   /// Indicates how many tasks per thread may be spawned at most by a ParallelFor invocation.
@@ -182,6 +224,16 @@ struct EZ_FOUNDATION_DLL ezParallelForParams
 
   ezTaskNesting nestingMode = ezTaskNesting::Never;
 
+  /// How the items are distributed over the worker threads.
+  ezParallelForSplitMode splitMode = ezParallelForSplitMode::Static;
+
+  /// Optional. If set, every invocation reports its timing here. In ezParallelForSplitMode::Lazy the data is also used to adapt the grain size.
+  ezParallelForStats* pStats = nullptr;
+
+  /// In ezParallelForSplitMode::Lazy, the grain size is chosen such that one chunk of work takes about this long.
+  /// Only has an effect once pStats holds timing data.
+  ezTime targetChunkDuration = ezTime::Microseconds(50);
+
   /// The allocator used to for the tasks that the parallel-for uses internally. If null, will use the default allocator.
   ezAllocatorBase* pTaskAllocator = nullptr;
 
@@ -192,6 +244,10 @@ struct EZ_FOUNDATION_DLL ezParallelForParams
   /// Returns the number of task items to work on per invocation (multiplicity).
   /// This is aligned with the multiplicity, i.e., multiplicity * bin_size >= # task items.
   ezUInt32 DetermineItemsPerInvocation(ezUInt32 uiNumTaskItems, ezUInt32 uiMultiplicity) const;
+
+  /// Returns the smallest number of items that ezParallelForSplitMode::Lazy hands to the callback at once.
+  /// If this is not smaller than the number of items, the work is executed serially.
+  ezUInt32 DetermineGrainSize(ezUInt32 uiNumTaskItems) const;
 };
 
 using ezParallelForIndexedFunction = ezDelegate<void(ezUInt32, ezUInt32), 48>;
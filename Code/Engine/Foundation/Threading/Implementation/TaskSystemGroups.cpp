@@ -4,6 +4,7 @@
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/Implementation/TaskGroup.h>
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
@@ -18,7 +19,7 @@ ezTaskGroupID ezTaskSystem::CreateTaskGroup(ezTaskPriority::Enum Priority, ezOnT
   // this search could be speed up with a stack of free groups
   for (; i < s_State->m_TaskGroups.GetCount(); ++i)
   {
-    if (!s_State->m_TaskGroups[i].m_bInUse)
+    if (s_State->m_TaskGroups[i].IsAvailableForReuse())
     {
       goto foundtaskgroup;
     }
@@ -58,7 +59,9 @@ void ezTaskSystem::AddTaskGroupDependency(ezTaskGroupID groupID, ezTaskGroupID D
 
   ezTaskGroup::DebugCheckTaskGroup(groupID, s_TaskSystemMutex);
 
-  groupID.m_pTaskGroup->m_DependsOnGroups.PushBack(DependsOn);
+  ezTaskGroup::Dependency& dep = groupID.m_pTaskGroup->m_DependsOnGroups.ExpandAndGetRef();
+  dep.m_DependsOn = DependsOn;
+  dep.m_pDependent = groupID.m_pTaskGroup;
 }
 
 void ezTaskSystem::AddTaskGroupDependencyBatch(ezArrayPtr<const ezTaskGroupDependency> batch)
@@ -80,37 +83,25 @@ void ezTaskSystem::StartTaskGroup(ezTaskGroupID groupID)
 
   ezTaskGroup::DebugCheckTaskGroup(groupID, s_TaskSystemMutex);
 
-  ezInt32 iActiveDependencies = 0;
+  ezTaskGroup& tg = *groupID.m_pTaskGroup;
 
-  {
-    EZ_LOCK(s_TaskSystemMutex);
-
-    ezTaskGroup& tg = *groupID.m_pTaskGroup;
-
-    tg.m_bStartedByUser = true;
-
-    for (ezUInt32 i = 0; i < tg.m_DependsOnGroups.GetCount(); ++i)
-    {
-      if (!IsTaskGroupFinished(tg.m_DependsOnGroups[i]))
-      {
-        ezTaskGroup& Dependency = *tg.m_DependsOnGroups[i].m_pTaskGroup;
+  tg.m_bStartedByUser = true;
 
-        // add this task group to the list of dependencies, such that when that group finishes, this task group can get woken up
-        Dependency.m_OthersDependingOnMe.PushBack(groupID);
+  // count how many other groups need to finish before this task group can be executed
+  // the additional one prevents dependencies that finish while we are still registering, from scheduling this group prematurely
+  tg.m_iNumActiveDependencies = static_cast<ezInt32>(tg.m_DependsOnGroups.GetCount()) + 1;
 
-        // count how many other groups need to finish before this task group can be executed
-        ++iActiveDependencies;
-      }
-    }
-
-    if (iActiveDependencies != 0)
+  for (ezTaskGroup::Dependency& dep : tg.m_DependsOnGroups)
+  {
+    // add this task group to the list of dependents, such that when that group finishes, this task group can get woken up
+    if (!dep.m_DependsOn.m_pTaskGroup->TryAddDependent(dep.m_DependsOn.m_uiGroupCounter, &dep))
     {
-      // atomic integers are quite slow, so do not use them in the loop, where they are not yet needed
-      tg.m_iNumActiveDependencies = iActiveDependencies;
+      // that group has already finished, this can't reach zero, due to the additional count
+      tg.m_iNumActiveDependencies.Decrement();
     }
   }
 
-  if (iActiveDependencies == 0)
+  if (tg.m_iNumActiveDependencies.Decrement() == 0)
   {
     ScheduleGroupTasks(groupID.m_pTaskGroup, false);
   }
@@ -118,8 +109,6 @@ void ezTaskSystem::StartTaskGroup(ezTaskGroupID groupID)
 
 void ezTaskSystem::StartTaskGroupBatch(ezArrayPtr<const ezTaskGroupID> batch)
 {
-  EZ_LOCK(s_TaskSystemMutex);
-
   for (const ezTaskGroupID& group : batch)
   {
     StartTaskGroup(group);
@@ -145,6 +134,11 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
 
   ezInt32 iRemainingTasks = 0;
 
+  // As soon as the last task is queued, other threads may execute it, which can finish the group and clear its task array.
+  // Therefore everything that is needed after that point is read upfront.
+  const ezTaskPriority::Enum priority = pGroup->m_Priority;
+  const ezUInt32 uiNumTasks = pGroup->m_Tasks.GetCount();
+
   // add all the tasks to the task list, so that they will be processed
   {
     EZ_LOCK(s_TaskSystemMutex);
@@ -156,32 +150,53 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
     {
       iRemainingTasks += ezMath::Max(1u, pTask->m_uiMultiplicity);
       pTask->m_iRemainingRuns = ezMath::Max(1u, pTask->m_uiMultiplicity);
+      pTask->m_bTaskIsScheduled = true;
     }
 
     pGroup->m_iNumRemainingTasks = iRemainingTasks;
 
 
-    for (ezUInt32 task = 0; task < pGroup->m_Tasks.GetCount(); ++task)
+    // 'this frame' tasks that never wait are put into the work-stealing queue of the scheduling thread (if it has one)
+    // other threads will steal them from there, without having to take the lock
+    ezTaskThreadQueues* pLocalQueues = ezTaskThreadQueues::IsQueuedLocally(priority) ? tl_TaskWorkerInfo.m_pLocalQueues : nullptr;
+
+    for (ezUInt32 task = 0; task < uiNumTasks; ++task)
     {
-      auto& pTask = pGroup->m_Tasks[task];
+      const ezSharedPtr<ezTask> pTask = pGroup->m_Tasks[task];
+      const ezUInt32 uiNumInvocations = ezMath::Max(1u, pTask->m_uiMultiplicity);
+      const bool bQueueLocally = pLocalQueues != nullptr && pTask->m_NestingMode == ezTaskNesting::Never;
 
-      for (ezUInt32 mult = 0; mult < ezMath::Max(1u, pTask->m_uiMultiplicity); ++mult)
+      for (ezUInt32 mult = 0; mult < uiNumInvocations; ++mult)
       {
+        if (bQueueLocally)
+        {
+          ezTaskWorkStealingQueue::Item item;
+          item.m_pBelongsToGroup = pGroup;
+          item.m_uiTaskIndex = task;
+          item.m_uiInvocation = mult;
+
+          if (pLocalQueues->GetQueue(priority).PushBottom(item))
+            continue;
+
+          // the queue is full, use the global task list instead
+        }
+
         TaskData td;
         td.m_pBelongsToGroup = pGroup;
         td.m_pTask = pTask;
-        td.m_pTask->m_bTaskIsScheduled = true;
         td.m_uiInvocation = mult;
 
         if (bHighPriority)
-          s_State->m_Tasks[pGroup->m_Priority].PushFront(td);
+          s_State->m_Tasks[priority].PushFront(td);
         else
-          s_State->m_Tasks[pGroup->m_Priority].PushBack(td);
+          s_State->m_Tasks[priority].PushBack(td);
+
+        s_State->m_iNumQueuedTasks[priority].Increment();
       }
     }
 
     // send the proper thread signal, to make sure one of the correct worker threads is awake
-    switch (pGroup->m_Priority)
+    switch (priority)
     {
       case ezTaskPriority::EarlyThisFrame:
       case ezTaskPriority::ThisFrame:
@@ -246,7 +261,17 @@ ezResult ezTaskSystem::CancelGroup(ezTaskGroupID Group, ezOnTaskRunning::Enum On
 
   ezResult res = EZ_SUCCESS;
 
-  auto TasksCopy = Group.m_pTaskGroup->m_Tasks;
+  ezHybridArray<ezSharedPtr<ezTask>, 16> TasksCopy;
+
+  {
+    // a finishing group clears its task array while holding this lock
+    EZ_LOCK(Group.m_pTaskGroup->m_CondVarGroupFinished);
+
+    if (ezTaskSystem::IsTaskGroupFinished(Group))
+      return EZ_SUCCESS;
+
+    TasksCopy = Group.m_pTaskGroup->m_Tasks;
+  }
 
   // first cancel ALL the tasks in the group, without waiting for anything
   for (ezUInt32 task = 0; task < TasksCopy.GetCount(); ++task)
@@ -273,7 +298,7 @@ ezResult ezTaskSystem::CancelGroup(ezTaskGroupID Group, ezOnTaskRunning::Enum On
 
 void ezTaskSystem::WaitForGroup(ezTaskGroupID Group)
 {
-  EZ_PROFILE_SCOPE("WaitForGroup");
+  EZ_PROFILE_SCOPE_INTERNED("WaitForGroup");
 
   EZ_ASSERT_DEV(tl_TaskWorkerInfo.m_bAllowNestedTasks, "The executing task '{}' is flagged to never wait for other tasks but does so anyway. Remove the flag or remove the wait-dependency.", tl_TaskWorkerInfo.m_szTaskName);
 
@@ -314,7 +339,7 @@ void ezTaskSystem::WaitForGroup(ezTaskGroupID Group)
 
 void ezTaskSystem::WaitForCondition(ezDelegate<bool()> condition)
 {
-  EZ_PROFILE_SCOPE("WaitForCondition");
+  EZ_PROFILE_SCOPE_INTERNED("WaitForCondition");
 
   EZ_ASSERT_DEV(tl_TaskWorkerInfo.m_bAllowNestedTasks, "The executing task '{}' is flagged to never wait for other tasks but does so anyway. Remove the flag or remove the wait-dependency.", tl_TaskWorkerInfo.m_szTaskName);
 
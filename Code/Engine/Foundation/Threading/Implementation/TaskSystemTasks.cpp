@@ -3,6 +3,7 @@
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/Implementation/TaskGroup.h>
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
@@ -48,21 +49,25 @@ void ezTaskSystem::TaskHasFinished(const ezSharedPtr<ezTask>& pTask, ezTaskGroup
 
       // set this task group to be finished such that no one tries to append further dependencies
       pGroup->m_uiGroupCounter += 2;
+
+      // unless an outside reference is held onto a task, this will deallocate the tasks
+      // the lock synchronizes this with CancelGroup()
+      pGroup->m_Tasks.Clear();
     }
 
     // wake up all threads that are waiting for this group
     pGroup->m_CondVarGroupFinished.SignalAll();
 
-    {
-      EZ_LOCK(s_TaskSystemMutex);
+    // from now on no other group can add itself as a dependent
+    ezTaskGroup::Dependency* pDependent = pGroup->CloseDependents();
 
-      for (ezUInt32 dep = 0; dep < pGroup->m_OthersDependingOnMe.GetCount(); ++dep)
-      {
-        DependencyHasFinished(pGroup->m_OthersDependingOnMe[dep].m_pTaskGroup);
-      }
+    while (pDependent != nullptr)
+    {
+      // the dependent group may get scheduled, finished and reused right away, so don't touch the node afterwards
+      ezTaskGroup* pDependentGroup = pDependent->m_pDependent;
+      pDependent = pDependent->m_pNextDependent;
 
-      // unless an outside reference is held onto a task, this will deallocate the tasks
-      pGroup->m_Tasks.Clear();
+      DependencyHasFinished(pDependentGroup);
     }
 
     if (pGroup->m_OnFinishedCallback.IsValid())
@@ -74,7 +79,7 @@ void ezTaskSystem::TaskHasFinished(const ezSharedPtr<ezTask>& pTask, ezTaskGroup
     }
 
     // set this task available for reuse
-    pGroup->m_bInUse = false;
+    pGroup->m_bInUse.store(false, std::memory_order_release);
   }
 }
 
@@ -86,29 +91,150 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
   EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}",
     FirstPriority, LastPriority);
 
+  while (true)
+  {
+    TaskData td;
+
+    // go through all the task lists that this thread is willing to work on
+    for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+    {
+      const ezTaskPriority::Enum priority = static_cast<ezTaskPriority::Enum>(prio);
+      const bool bQueuedLocally = ezTaskThreadQueues::IsQueuedLocally(priority);
+
+      // the work-stealing queues only contain tasks that never wait, so every thread may execute them
+
+      if (bQueuedLocally && PopLocalTask(priority, td))
+        return td;
+
+      if (PopGlobalTask(priority, bOnlyTasksThatNeverWait, WaitingForGroup, td))
+        return td;
+
+      if (bQueuedLocally && StealTask(priority, td))
+        return td;
+    }
+
+    if (pWorkerState == nullptr)
+      return td;
+
+    EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+
+    // We don't hold any lock while looking for tasks, so a task may have been queued after we looked at its queue,
+    // but before this thread was marked as idle. In that case the scheduling thread may not have seen a reason to wake us up,
+    // so check again, now that everyone can see that this thread is idle.
+    if (!HasQueuedTasks(FirstPriority, LastPriority))
+      return td;
+
+    // if this fails, another thread has woken us up in the mean time, so we won't go to sleep anyway
+    if (pWorkerState->CompareAndSwap((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active) != (int)ezTaskWorkerState::Idle)
+      return td;
+  }
+}
+
+bool ezTaskSystem::PopLocalTask(ezTaskPriority::Enum Priority, TaskData& out_Task)
+{
+  ezTaskThreadQueues* pQueues = tl_TaskWorkerInfo.m_pLocalQueues;
+
+  if (pQueues == nullptr)
+    return false;
+
+  ezTaskWorkStealingQueue::Item item;
+  if (!pQueues->GetQueue(Priority).PopBottom(item))
+    return false;
+
+  out_Task.m_pBelongsToGroup = item.m_pBelongsToGroup;
+  out_Task.m_pTask = item.m_pBelongsToGroup->m_Tasks[item.m_uiTaskIndex];
+  out_Task.m_uiInvocation = item.m_uiInvocation;
+  return true;
+}
+
+bool ezTaskSystem::PopGlobalTask(ezTaskPriority::Enum Priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task)
+{
+  // don't bother taking the lock, if there is nothing to do anyway
+  if (s_State->m_iNumQueuedTasks[Priority] <= 0)
+    return false;
+
   EZ_LOCK(s_TaskSystemMutex);
 
-  // go through all the task lists that this thread is willing to work on
-  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+  for (auto it = s_State->m_Tasks[Priority].GetIterator(); it.IsValid(); ++it)
   {
-    for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
+    if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
     {
-      if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
-      {
-        TaskData td = *it;
+      out_Task = *it;
 
-        s_State->m_Tasks[prio].Remove(it);
-        return td;
+      s_State->m_Tasks[Priority].Remove(it);
+      s_State->m_iNumQueuedTasks[Priority].Decrement();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ezTaskSystem::StealTask(ezTaskPriority::Enum Priority, TaskData& out_Task)
+{
+  ezTaskThreadQueues* pOwnQueues = tl_TaskWorkerInfo.m_pLocalQueues;
+
+  // the main thread plus all short task workers
+  const ezUInt32 uiNumVictims = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks] + 1;
+  const ezUInt32 uiFirstVictim = pOwnQueues != nullptr ? pOwnQueues->m_uiNextVictim : 0;
+
+  for (ezUInt32 i = 0; i < uiNumVictims; ++i)
+  {
+    const ezUInt32 uiVictim = (uiFirstVictim + i) % uiNumVictims;
+    ezTaskThreadQueues& victim = GetThreadQueues(uiVictim);
+
+    if (&victim == pOwnQueues)
+      continue;
+
+    ezTaskWorkStealingQueue::Item item;
+    const ezTaskStealResult result = victim.GetQueue(Priority).Steal(item);
+
+    if (result == ezTaskStealResult::Success)
+    {
+      if (pOwnQueues != nullptr)
+      {
+        // a thread that had work to steal, probably has more of it
+        pOwnQueues->m_uiNextVictim = uiVictim;
+        pOwnQueues->m_iNumSteals.Increment();
       }
+
+      out_Task.m_pBelongsToGroup = item.m_pBelongsToGroup;
+      out_Task.m_pTask = item.m_pBelongsToGroup->m_Tasks[item.m_uiTaskIndex];
+      out_Task.m_uiInvocation = item.m_uiInvocation;
+      return true;
+    }
+
+    if (result == ezTaskStealResult::Abort && pOwnQueues != nullptr)
+    {
+      pOwnQueues->m_iNumFailedSteals.Increment();
     }
   }
 
-  if (pWorkerState)
+  return false;
+}
+
+bool ezTaskSystem::HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority)
+{
+  const ezUInt32 uiNumThreadQueues = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks] + 1;
+
+  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
   {
-    EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+    const ezTaskPriority::Enum priority = static_cast<ezTaskPriority::Enum>(prio);
+
+    if (s_State->m_iNumQueuedTasks[priority] > 0)
+      return true;
+
+    if (ezTaskThreadQueues::IsQueuedLocally(priority))
+    {
+      for (ezUInt32 i = 0; i < uiNumThreadQueues; ++i)
+      {
+        if (!GetThreadQueues(i).GetQueue(priority).IsEmpty())
+          return true;
+      }
+    }
   }
 
-  return TaskData();
+  return false;
 }
 
 bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait,
@@ -176,13 +302,16 @@ ezResult ezTaskSystem::CancelTask(const ezSharedPtr<ezTask>& pTask, ezOnTaskRunn
         {
           if (it->m_pTask == pTask)
           {
+            const TaskData td = *it;
+
             s_State->m_Tasks[i].Remove(it);
+            s_State->m_iNumQueuedTasks[i].Decrement();
 
             // we set the task to finished, even though it was not executed
             pTask->m_iRemainingRuns = 0;
 
             // tell the system that one task of that group is 'finished', to ensure its dependencies will get scheduled
-            TaskHasFinished(it->m_pTask, it->m_pBelongsToGroup);
+            TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
             return EZ_SUCCESS;
           }
 
@@ -193,7 +322,8 @@ ezResult ezTaskSystem::CancelTask(const ezSharedPtr<ezTask>& pTask, ezOnTaskRunn
   }
 
   // if we made it here, the task was already running
-  // thus we just wait for it to finish
+  // or it is in one of the work-stealing queues, where it will be skipped, since the cancel flag is set
+  // either way we just wait for it to finish
 
   if (OnTaskRunning == ezOnTaskRunning::WaitTillFinished)
   {
@@ -268,6 +398,13 @@ void ezTaskSystem::ReprioritizeFrameTasks()
     // remove the tasks from their current queue
     s_State->m_Tasks[i].Clear();
   }
+
+  // tasks in the work-stealing queues are not moved, those queues only hold 'this frame' tasks
+
+  for (ezUInt32 i = (ezUInt32)ezTaskPriority::EarlyThisFrame; i <= (ezUInt32)ezTaskPriority::In9Frames; ++i)
+  {
+    s_State->m_iNumQueuedTasks[i] = static_cast<ezInt32>(s_State->m_Tasks[i].GetCount());
+  }
 }
 
 void ezTaskSystem::ExecuteSomeFrameTasks(ezTime smoothFrameTime)
@@ -402,6 +539,57 @@ void ezTaskSystem::FinishFrameTasks()
       }
     }
   }
+
+  // Publish the queue depths, so that they show up next to the profiling scopes
+  {
+    auto CountQueued = [](ezTaskPriority::Enum first, ezTaskPriority::Enum last) {
+      ezInt32 iCount = 0;
+      for (ezUInt32 p = first; p <= last; ++p)
+      {
+        iCount += s_State->m_iNumQueuedTasks[p];
+      }
+      return iCount;
+    };
+
+    ezInt32 iThisFrame = CountQueued(ezTaskPriority::EarlyThisFrame, ezTaskPriority::LateThisFrame);
+
+    const ezUInt32 uiNumThreadQueues = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks] + 1;
+    for (ezUInt32 i = 0; i < uiNumThreadQueues; ++i)
+    {
+      ezTaskThreadQueues& queues = GetThreadQueues(i);
+      for (ezUInt32 q = 0; q < ezTaskThreadQueues::NumQueues; ++q)
+      {
+        iThisFrame += queues.m_Queues[q].GetCount();
+      }
+    }
+
+    EZ_PROFILE_COUNTER("TaskSystem/Queued This Frame", iThisFrame);
+    EZ_PROFILE_COUNTER("TaskSystem/Queued Next Frames", CountQueued(ezTaskPriority::EarlyNextFrame, ezTaskPriority::In9Frames));
+    EZ_PROFILE_COUNTER("TaskSystem/Queued Long Running", CountQueued(ezTaskPriority::LongRunningHighPriority, ezTaskPriority::LongRunning));
+    EZ_PROFILE_COUNTER("TaskSystem/Queued File Access", CountQueued(ezTaskPriority::FileAccessHighPriority, ezTaskPriority::FileAccess));
+    EZ_PROFILE_COUNTER("TaskSystem/Queued Main Thread", CountQueued(ezTaskPriority::ThisFrameMainThread, ezTaskPriority::SomeFrameMainThread));
+  }
+
+  // Publish the work stealing statistics of the last frame
+  // the workers reset their counters in UpdateThreadUtilization, the main thread has no worker object, so its counters are reset here
+  {
+    ezUInt32 uiNumSteals = s_ThreadState->m_MainThreadQueues.m_iNumSteals.Set(0);
+    ezUInt32 uiNumFailedSteals = s_ThreadState->m_MainThreadQueues.m_iNumFailedSteals.Set(0);
+
+    const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+    for (ezUInt32 t = 0; t < uiNumWorkers; ++t)
+    {
+      ezUInt32 uiWorkerSteals = 0;
+      ezUInt32 uiWorkerFailedSteals = 0;
+      s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][t]->GetThreadUtilization(nullptr, &uiWorkerSteals, &uiWorkerFailedSteals);
+
+      uiNumSteals += uiWorkerSteals;
+      uiNumFailedSteals += uiWorkerFailedSteals;
+    }
+
+    EZ_PROFILE_COUNTER("TaskSystem/Steals", uiNumSteals);
+    EZ_PROFILE_COUNTER("TaskSystem/Failed Steals", uiNumFailedSteals);
+  }
 }
 
 
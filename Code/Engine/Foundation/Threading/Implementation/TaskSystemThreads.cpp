@@ -2,8 +2,10 @@
 
 #include <Foundation/Logging/Log.h>
 #include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/Implementation/TaskGroup.h>
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
+#include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 ezUInt32 ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::Enum type)
@@ -93,6 +95,10 @@ void ezTaskSystem::StopWorkerThreads()
     for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
     {
       s_ThreadState->m_Workers[type][i]->Join();
+
+      // don't lose the tasks that this thread scheduled, but that nobody picked up yet
+      RequeueTasksFromThreadQueues(s_ThreadState->m_Workers[type][i]->GetLocalQueues());
+
       EZ_DEFAULT_DELETE(s_ThreadState->m_Workers[type][i]);
     }
 
@@ -185,9 +191,45 @@ ezWorkerThreadType::Enum ezTaskSystem::GetCurrentThreadWorkerType()
   return tl_TaskWorkerInfo.m_WorkerType;
 }
 
-double ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::Enum Type, ezUInt32 uiThreadIndex, ezUInt32* pNumTasksExecuted /*= nullptr*/)
+double ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::Enum Type, ezUInt32 uiThreadIndex, ezUInt32* pNumTasksExecuted /*= nullptr*/,
+  ezUInt32* pNumTasksStolen /*= nullptr*/, ezUInt32* pNumFailedSteals /*= nullptr*/)
+{
+  return s_ThreadState->m_Workers[Type][uiThreadIndex]->GetThreadUtilization(pNumTasksExecuted, pNumTasksStolen, pNumFailedSteals);
+}
+
+ezTaskThreadQueues& ezTaskSystem::GetThreadQueues(ezUInt32 uiIndex)
+{
+  if (uiIndex == 0)
+    return s_ThreadState->m_MainThreadQueues;
+
+  return s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][uiIndex - 1]->GetLocalQueues();
+}
+
+void ezTaskSystem::RequeueTasksFromThreadQueues(ezTaskThreadQueues& queues)
 {
-  return s_ThreadState->m_Workers[Type][uiThreadIndex]->GetThreadUtilization(pNumTasksExecuted);
+  EZ_LOCK(s_TaskSystemMutex);
+
+  for (ezUInt32 prio = ezTaskThreadQueues::FirstPriority; prio <= (ezUInt32)ezTaskThreadQueues::LastPriority; ++prio)
+  {
+    const ezTaskPriority::Enum priority = static_cast<ezTaskPriority::Enum>(prio);
+
+    // the owning thread is gone, so stealing is the only thing that still happens on this queue
+    ezTaskWorkStealingQueue::Item item;
+    ezTaskStealResult result;
+    while ((result = queues.GetQueue(priority).Steal(item)) != ezTaskStealResult::Empty)
+    {
+      if (result == ezTaskStealResult::Abort)
+        continue;
+
+      TaskData td;
+      td.m_pBelongsToGroup = item.m_pBelongsToGroup;
+      td.m_pTask = item.m_pBelongsToGroup->m_Tasks[item.m_uiTaskIndex];
+      td.m_uiInvocation = item.m_uiInvocation;
+
+      s_State->m_Tasks[priority].PushBack(td);
+      s_State->m_iNumQueuedTasks[priority].Increment();
+    }
+  }
 }
 
 void ezTaskSystem::DetermineTasksToExecuteOnThread(ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority)
@@ -116,8 +116,9 @@ void ezTaskSystem::WriteStateSnapshotToDGML(ezDGMLGraph& graph)
 
     const ezDGMLGraph::NodeId ownNodeId = groupNodeIds[&tg];
 
-    for (const ezTaskGroupID& dependsOn : tg.m_DependsOnGroups)
+    for (const ezTaskGroup::Dependency& dep : tg.m_DependsOnGroups)
     {
+      const ezTaskGroupID& dependsOn = dep.m_DependsOn;
       ezDGMLGraph::NodeId otherNodeId;
 
       // filter out already fulfilled dependencies
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+
+#include <atomic>
+
+/// \internal The result of ezTaskWorkStealingQueue::Steal()
+enum class ezTaskStealResult
+{
+  Success, ///< An item was taken from the queue.
+  Empty,   ///< The queue did not contain any items.
+  Abort,   ///< The queue contained items, but another thread won the race for the one we tried to take.
+};
+
+/// \internal A fixed size, lock-free work-stealing deque (Chase-Lev).
+///
+/// Only the owning thread may call PushBottom() and PopBottom(). It works on the queue in LIFO order, which keeps the data of
+/// recently spawned tasks hot in its cache. Any other thread may call Steal() at any time, which takes items in FIFO order from the other
+/// end of the queue, i.e. the oldest and typically largest chunks of work.
+///
+/// The queue does not grow. If PushBottom() fails, the caller has to put the item somewhere else (the ezTaskSystem then falls back to its
+/// global task lists).
+///
+/// The memory orders follow the C11 formulation of the algorithm by Le, Pop, Cohen and Zappa Nardelli, so that it also works on weakly ordered
+/// CPUs.
+class ezTaskWorkStealingQueue
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskWorkStealingQueue);
+
+public:
+  /// \brief Identifies a single scheduled invocation of a task.
+  ///
+  /// Tasks are referenced through their group and the index in the group's task array, since the group keeps the task alive until all its
+  /// invocations are done and the array is not modified while tasks are scheduled.
+  struct Item
+  {
+    ezTaskGroup* m_pBelongsToGroup = nullptr;
+    ezUInt32 m_uiTaskIndex = 0;
+    ezUInt32 m_uiInvocation = 0;
+  };
+
+  /// \brief Must be a power of two.
+  static constexpr ezUInt32 Capacity = 512;
+
+  ezTaskWorkStealingQueue() = default;
+
+  /// \brief Adds an item at the owner's end of the queue. Returns false, if the queue is full. May only be called by the owning thread.
+  bool PushBottom(const Item& item)
+  {
+    const ezInt64 b = m_iBottom.load(std::memory_order_relaxed);
+    const ezInt64 t = m_iTop.load(std::memory_order_acquire);
+
+    if (b - t >= (ezInt64)Capacity)
+      return false;
+
+    m_Items[b & (Capacity - 1)].Store(item);
+
+    // makes the item visible before thieves can see the new bottom
+    std::atomic_thread_fence(std::memory_order_release);
+    m_iBottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// \brief Takes the most recently pushed item. Returns false, if the queue is empty. May only be called by the owning thread.
+  bool PopBottom(Item& out_Item)
+  {
+    const ezInt64 b = m_iBottom.load(std::memory_order_relaxed) - 1;
+    m_iBottom.store(b, std::memory_order_relaxed);
+
+    // thieves must see the reservation before we read top
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    ezInt64 t = m_iTop.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+      // the queue was empty
+      m_iBottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    m_Items[b & (Capacity - 1)].Load(out_Item);
+
+    if (t != b)
+    {
+      // more than one item was left, no thief can interfere
+      return true;
+    }
+
+    // this was the last item, race against the thieves for it
+    const bool bWon = m_iTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    m_iBottom.store(b + 1, std::memory_order_relaxed);
+    return bWon;
+  }
+
+  /// \brief Takes the oldest item. May be called by any thread.
+  ezTaskStealResult Steal(Item& out_Item)
+  {
+    ezInt64 t = m_iTop.load(std::memory_order_acquire);
+
+    // pairs with the fence in PopBottom(), so that the owner and a thief never both take the last item
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const ezInt64 b = m_iBottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+      return ezTaskStealResult::Empty;
+
+    // the item may get overwritten right after we read it, but in that case top has moved and the CAS below fails
+    Item item;
+    m_Items[t & (Capacity - 1)].Load(item);
+
+    if (!m_iTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return ezTaskStealResult::Abort;
+
+    out_Item = item;
+    return ezTaskStealResult::Success;
+  }
+
+  /// \brief Returns whether the queue currently looks empty. The result may be outdated by the time it is used.
+  bool IsEmpty() const { return m_iTop.load(std::memory_order_relaxed) >= m_iBottom.load(std::memory_order_relaxed); }
+
+  /// \brief Returns the number of items in the queue. The result may be outdated by the time it is used.
+  ezUInt32 GetCount() const
+  {
+    const ezInt64 iCount = m_iBottom.load(std::memory_order_relaxed) - m_iTop.load(std::memory_order_relaxed);
+    return iCount > 0 ? static_cast<ezUInt32>(iCount) : 0;
+  }
+
+private:
+  /// \brief A thief may read a slot while the owner overwrites it, so every member is accessed atomically. Torn reads are discarded by the CAS on top.
+  struct Slot
+  {
+    void Store(const Item& item)
+    {
+      m_pBelongsToGroup.store(item.m_pBelongsToGroup, std::memory_order_relaxed);
+      m_uiTaskIndex.store(item.m_uiTaskIndex, std::memory_order_relaxed);
+      m_uiInvocation.store(item.m_uiInvocation, std::memory_order_relaxed);
+    }
+
+    void Load(Item& out_Item) const
+    {
+      out_Item.m_pBelongsToGroup = m_pBelongsToGroup.load(std::memory_order_relaxed);
+      out_Item.m_uiTaskIndex = m_uiTaskIndex.load(std::memory_order_relaxed);
+      out_Item.m_uiInvocation = m_uiInvocation.load(std::memory_order_relaxed);
+    }
+
+    std::atomic<ezTaskGroup*> m_pBelongsToGroup = {nullptr};
+    std::atomic<ezUInt32> m_uiTaskIndex = {0};
+    std::atomic<ezUInt32> m_uiInvocation = {0};
+  };
+
+  // top and bottom are modified by different threads, keep them on separate cache lines
+  std::atomic<ezInt64> m_iTop = {0};
+  ezUInt8 m_Padding0[64 - sizeof(std::atomic<ezInt64>)];
+  std::atomic<ezInt64> m_iBottom = {0};
+  ezUInt8 m_Padding1[64 - sizeof(std::atomic<ezInt64>)];
+
+  Slot m_Items[Capacity];
+};
+
+/// \internal The work-stealing queues that belong to one thread.
+///
+/// The main thread and every short-task worker thread own one set of queues. Tasks that such a thread schedules with a 'this frame'
+/// priority and ezTaskNesting::Never go into its own queues, instead of the global, mutex protected task lists.
+/// Idle threads steal from the queues of all other threads.
+struct ezTaskThreadQueues
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskThreadQueues);
+
+  ezTaskThreadQueues() = default;
+
+  /// \brief The first priority that is handled through work-stealing queues.
+  static constexpr ezTaskPriority::Enum FirstPriority = ezTaskPriority::EarlyThisFrame;
+
+  /// \brief The last priority that is handled through work-stealing queues.
+  static constexpr ezTaskPriority::Enum LastPriority = ezTaskPriority::LateThisFrame;
+
+  static constexpr ezUInt32 NumQueues = LastPriority - FirstPriority + 1;
+
+  static bool IsQueuedLocally(ezTaskPriority::Enum priority) { return priority >= FirstPriority && priority <= LastPriority; }
+
+  ezTaskWorkStealingQueue& GetQueue(ezTaskPriority::Enum priority) { return m_Queues[priority - FirstPriority]; }
+
+  ezTaskWorkStealingQueue m_Queues[NumQueues];
+
+  /// \brief Rotates through the potential victims, so that not all thieves hammer the same queue. Only used by the owning thread.
+  ezUInt32 m_uiNextVictim = 0;
+
+  /// \brief How many tasks this thread took from other threads' queues.
+  ezAtomicInteger32 m_iNumSteals;
+
+  /// \brief How often this thread found a task in another thread's queue, but lost the race for it.
+  ezAtomicInteger32 m_iNumFailedSteals;
+};
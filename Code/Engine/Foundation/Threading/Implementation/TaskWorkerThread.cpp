@@ -49,6 +49,12 @@ ezUInt32 ezTaskWorkerThread::Run()
   tl_TaskWorkerInfo.m_iWorkerIndex = m_uiWorkerThreadNumber;
   tl_TaskWorkerInfo.m_pWorkerState = &m_WorkerState;
 
+  // only short tasks are scheduled through the work-stealing queues
+  if (m_WorkerType == ezWorkerThreadType::ShortTasks)
+  {
+    tl_TaskWorkerInfo.m_pLocalQueues = &m_LocalQueues;
+  }
+
   const bool bIsReserve = m_uiWorkerThreadNumber >= ezTaskSystem::s_ThreadState->m_uiMaxWorkersToUse[m_WorkerType];
 
   ezTaskPriority::Enum FirstPriority;
@@ -134,15 +140,29 @@ void ezTaskWorkerThread::UpdateThreadUtilization(ezTime TimePassed)
   m_fLastThreadUtilization = tActive.GetSeconds() / TimePassed.GetSeconds();
   m_uiLastNumTasksExecuted = m_uiNumTasksExecuted;
   m_uiNumTasksExecuted = 0;
+
+  m_uiLastNumTasksStolen = m_LocalQueues.m_iNumSteals.Set(0);
+  m_uiLastNumFailedSteals = m_LocalQueues.m_iNumFailedSteals.Set(0);
 }
 
-double ezTaskWorkerThread::GetThreadUtilization(ezUInt32* pNumTasksExecuted /*= nullptr*/)
+double ezTaskWorkerThread::GetThreadUtilization(
+  ezUInt32* pNumTasksExecuted /*= nullptr*/, ezUInt32* pNumTasksStolen /*= nullptr*/, ezUInt32* pNumFailedSteals /*= nullptr*/)
 {
   if (pNumTasksExecuted)
   {
     *pNumTasksExecuted = m_uiLastNumTasksExecuted;
   }
 
+  if (pNumTasksStolen)
+  {
+    *pNumTasksStolen = m_uiLastNumTasksStolen;
+  }
+
+  if (pNumFailedSteals)
+  {
+    *pNumFailedSteals = m_uiLastNumFailedSteals;
+  }
+
   return m_fLastThreadUtilization;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
 
 #include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadSignal.h>
@@ -37,8 +38,9 @@ private:
   ///@{
 
 public:
-  /// \brief Returns the last utilization value (0 - 1 range). Optionally returns how many tasks it executed recently.
-  double GetThreadUtilization(ezUInt32* pNumTasksExecuted = nullptr);
+  /// \brief Returns the last utilization value (0 - 1 range). Optionally returns how many tasks it executed recently,
+  /// and how many tasks it stole from other threads (or failed to steal, because another thread was faster).
+  double GetThreadUtilization(ezUInt32* pNumTasksExecuted = nullptr, ezUInt32* pNumTasksStolen = nullptr, ezUInt32* pNumFailedSteals = nullptr);
 
   /// \brief Computes the thread utilization by dividing the thread active time by the time that has passed since the last update.
   void UpdateThreadUtilization(ezTime TimePassed);
@@ -47,6 +49,8 @@ private:
   bool m_bExecutingTask = false;
   ezUInt16 m_uiLastNumTasksExecuted = 0;
   ezUInt16 m_uiNumTasksExecuted = 0;
+  ezUInt32 m_uiLastNumTasksStolen = 0;
+  ezUInt32 m_uiLastNumFailedSteals = 0;
   ezTime m_StartedWorkingTime;
   ezTime m_ThreadActiveTime;
   double m_fLastThreadUtilization = 0.0;
@@ -75,6 +79,18 @@ private:
   ezAtomicInteger32 m_WorkerState; // ezTaskWorkerState
 
   ///@}
+
+  /// \name Work Stealing
+  ///@{
+
+public:
+  /// \brief The queues into which this thread puts the tasks that it schedules, and from which other threads may steal.
+  ezTaskThreadQueues& GetLocalQueues() { return m_LocalQueues; }
+
+private:
+  ezTaskThreadQueues m_LocalQueues;
+
+  ///@}
 };
 
 /// \internal Thread local state used by the task system (and for better debugging)
@@ -85,6 +101,7 @@ struct ezTaskWorkerInfo
   bool m_bAllowNestedTasks = true;
   const char* m_szTaskName = nullptr;
   ezAtomicInteger32* m_pWorkerState = nullptr;
+  ezTaskThreadQueues* m_pLocalQueues = nullptr;
 };
 
 extern thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
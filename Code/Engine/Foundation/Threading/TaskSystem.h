@@ -72,6 +72,9 @@ public:
   /// Therefore when bWaitForIt is true, this function might block for a very long time.
   /// It is advised to implement tasks that need to be canceled regularly (e.g. path searches for units that might die)
   /// in a way that allows for quick canceling.
+  ///
+  /// Tasks that sit in the work-stealing queue of some thread cannot be removed from it. For those EZ_FAILURE is returned as well,
+  /// however, since the cancel flag is set, they will be skipped without being executed once a thread picks them up.
   static ezResult CancelTask(const ezSharedPtr<ezTask>& pTask, ezOnTaskRunning::Enum OnTaskRunning = ezOnTaskRunning::WaitTillFinished); // [tested]
 
   struct TaskData
@@ -83,6 +86,9 @@ public:
 
 private:
   /// \brief Searches for a task of priority between \a FirstPriority and \a LastPriority (inclusive).
+  ///
+  /// For each priority it first looks into the calling thread's own work-stealing queue, then into the global task list
+  /// and finally tries to steal a task from the work-stealing queues of the other threads.
   static TaskData GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait,
     const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
@@ -90,6 +96,26 @@ private:
   static bool ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait,
     const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
+  /// \brief Takes the most recently queued task of the given priority from the calling thread's work-stealing queue.
+  static bool PopLocalTask(ezTaskPriority::Enum Priority, TaskData& out_Task);
+
+  /// \brief Takes a task of the given priority from the global task list, if there is one that the calling thread may execute.
+  static bool PopGlobalTask(ezTaskPriority::Enum Priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task);
+
+  /// \brief Tries to take a task of the given priority from the work-stealing queue of any other thread.
+  static bool StealTask(ezTaskPriority::Enum Priority, TaskData& out_Task);
+
+  /// \brief Returns whether any queue currently contains tasks of priority between \a FirstPriority and \a LastPriority (inclusive).
+  static bool HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority);
+
+  /// \brief Returns the work-stealing queues of the main thread (index 0) or of the short task worker thread with index uiIndex - 1.
+  static ezTaskThreadQueues& GetThreadQueues(ezUInt32 uiIndex);
+
+  /// \brief Moves all tasks that are left in the given work-stealing queues into the global task lists.
+  ///
+  /// Must only be called when the owning thread has stopped running.
+  static void RequeueTasksFromThreadQueues(ezTaskThreadQueues& queues);
+
   /// \brief Called whenever a task has been finished/canceled. Makes sure that groups are marked as finished when all tasks are done.
   static void TaskHasFinished(const ezSharedPtr<ezTask>& pTask, ezTaskGroup* pGroup);
 
@@ -212,7 +238,10 @@ public:
   /// per frame.
   ///
   /// Also optionally returns the number of tasks that were finished during the last frame.
-  static double GetThreadUtilization(ezWorkerThreadType::Enum Type, ezUInt32 uiThreadIndex, ezUInt32* pNumTasksExecuted = nullptr);
+  /// For short task threads it can additionally return how many tasks the thread stole from the work-stealing queues of other threads
+  /// during the last frame, and how often it tried to steal a task but another thread was faster.
+  static double GetThreadUtilization(ezWorkerThreadType::Enum Type, ezUInt32 uiThreadIndex, ezUInt32* pNumTasksExecuted = nullptr,
+    ezUInt32* pNumTasksStolen = nullptr, ezUInt32* pNumFailedSteals = nullptr);
 
 private:
   friend class ezTaskWorkerThread;
@@ -271,6 +300,9 @@ private:
   static void ParallelForInternal(
     ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& config);
 
+  /// \brief Returns false while the calling thread executes a task that is flagged with ezTaskNesting::Never. Such a task has to do all the work itself.
+  static bool AreNestedTasksAllowed();
+
   ///@}
 
   /// \name Utilities
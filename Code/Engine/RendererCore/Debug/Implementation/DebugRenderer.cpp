@@ -822,7 +822,7 @@ void ezDebugRenderer::DrawTexturedTriangles(const ezDebugRendererContext& contex
     return;
 
   ezResourceLock<ezTexture2DResource> pTexture(hTexture, ezResourceAcquireMode::AllowLoadingFallback);
-  auto hResourceView = ezGALDevice::GetDefaultDevice()->GetDefaultResourceView(pTexture->GetGALTexture());
+  auto hResourceView = pTexture->GetGALResourceView();
 
   EZ_LOCK(s_Mutex);
 
@@ -867,7 +867,7 @@ void ezDebugRenderer::Draw2DRectangle(const ezDebugRendererContext& context, con
 void ezDebugRenderer::Draw2DRectangle(const ezDebugRendererContext& context, const ezRectFloat& rectInPixel, float fDepth, const ezColor& color, const ezTexture2DResourceHandle& hTexture)
 {
   ezResourceLock<ezTexture2DResource> pTexture(hTexture, ezResourceAcquireMode::AllowLoadingFallback);
-  Draw2DRectangle(context, rectInPixel, fDepth, color, ezGALDevice::GetDefaultDevice()->GetDefaultResourceView(pTexture->GetGALTexture()));
+  Draw2DRectangle(context, rectInPixel, fDepth, color, pTexture->GetGALResourceView());
 }
 
 void ezDebugRenderer::Draw2DRectangle(const ezDebugRendererContext& context, const ezRectFloat& rectInPixel, float fDepth, const ezColor& color, ezGALResourceViewHandle hResourceView)
@@ -108,6 +108,7 @@ private:
   ezMaterialResourceDescriptor m_Desc;
 
   friend class ezRenderContext;
+  friend class ezTextureStreamingManager;
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(RendererCore, MaterialResource);
 
   ezEvent<const ezMaterialResource*, ezMutex> m_ModifiedEvent;
@@ -5,6 +5,7 @@
 #include <Core/WorldSerializer/WorldWriter.h>
 #include <RendererCore/Meshes/MeshComponentBase.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererCore/Textures/TextureStreamingManager.h>
 #include <RendererFoundation/Device/Device.h>
 
 //////////////////////////////////////////////////////////////////////////
@@ -168,6 +169,9 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
   ezResourceLock<ezMeshResource> pMesh(m_hMesh, ezResourceAcquireMode::AllowLoadingFallback);
   ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> parts = pMesh->GetSubMeshes();
 
+  const bool bReportTextureUsage = ezTextureStreamingManager::IsEnabled();
+  const float fScreenSize = bReportTextureUsage ? ezTextureStreamingManager::ComputeScreenSize(GetOwner()->GetGlobalBounds().GetSphere(), *msg.m_pView) : 0.0f;
+
   for (ezUInt32 uiPartIndex = 0; uiPartIndex < parts.GetCount(); ++uiPartIndex)
   {
     const ezUInt32 uiMaterialIndex = parts[uiPartIndex].m_uiMaterialIndex;
@@ -179,6 +183,11 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
     else
       hMaterial = pMesh->GetMaterials()[uiMaterialIndex];
 
+    if (bReportTextureUsage)
+    {
+      ezTextureStreamingManager::ReportMaterialUsage(hMaterial, fScreenSize);
+    }
+
     ezMeshRenderData* pRenderData = CreateRenderData();
     {
       pRenderData->m_GlobalTransform = GetOwner()->GetGlobalTransform() * pRenderData->m_GlobalTransform;
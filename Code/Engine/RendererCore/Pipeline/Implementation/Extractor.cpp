@@ -1,5 +1,6 @@
 #include <RendererCore/RendererCorePCH.h>
 
+#include <Core/World/SpatialSystem_LooseOctree.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Configuration/CVar.h>
@@ -35,6 +36,18 @@ namespace
         ezHybridArray<ezBoundingBox, 16> boxes;
         pSpatialSystemGrid->GetAllCellBoxes(boxes, filterCategory);
 
+        for (auto& box : boxes)
+        {
+          ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
+        }
+      }
+      else if (auto pSpatialSystemOctree = ezDynamicCast<const ezSpatialSystem_LooseOctree*>(&spatialSystem))
+      {
+        ezSpatialData::Category filterCategory = ezSpatialData::FindCategory(cvar_SpatialVisDataOnlyCategory.GetValue());
+
+        ezHybridArray<ezBoundingBox, 16> boxes;
+        pSpatialSystemOctree->GetAllNodeBoxes(boxes, filterCategory);
+
         for (auto& box : boxes)
         {
           ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
@@ -78,6 +91,14 @@ namespace
           ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
         }
       }
+      else if (auto pSpatialSystemOctree = ezDynamicCast<const ezSpatialSystem_LooseOctree*>(&spatialSystem))
+      {
+        ezBoundingBox box;
+        if (pSpatialSystemOctree->GetNodeBoxForSpatialData(pObject->GetSpatialData(), box).Succeeded())
+        {
+          ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
+        }
+      }
     }
   }
 #endif
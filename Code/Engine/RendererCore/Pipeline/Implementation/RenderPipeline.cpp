@@ -1,5 +1,6 @@
 #include <RendererCore/RendererCorePCH.h>
 
+#include <Core/Graphics/OcclusionBuffer.h>
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
 #include <RendererCore/Debug/DebugRenderer.h>
@@ -19,6 +20,9 @@ ezCVarBool ezRenderPipeline::cvar_SpatialCullingVis("Spatial.Culling.Vis", false
 ezCVarBool cvar_SpatialCullingShowStats("Spatial.Culling.ShowStats", false, ezCVarFlags::Default, "Display some stats of the visibility culling");
 #endif
 
+ezCVarBool cvar_SpatialCullingOcclusion("Spatial.Culling.Occlusion", false, ezCVarFlags::Default, "Enables software occlusion culling against the objects in the 'Occluder' spatial category");
+ezCVarInt cvar_SpatialCullingOcclusionHeight("Spatial.Culling.OcclusionHeight", 128, ezCVarFlags::Default, "Vertical resolution of the software occlusion buffer, the width follows the aspect ratio of the view");
+
 ezRenderPipeline::ezRenderPipeline()
   : m_PipelineState(PipelineState::Uninitialized)
 {
@@ -932,6 +936,11 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
   queryParams.m_pStats = bRecordStats ? &stats : nullptr;
 #endif
 
+  if (cvar_SpatialCullingOcclusion)
+  {
+    queryParams.m_pOcclusionBuffer = RasterizeOccluders(view, frustum);
+  }
+
   view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, queryParams, m_visibleObjects);
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -957,6 +966,9 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
     sb.Format("Num Objects Passed: {0}", stats.m_uiNumObjectsPassed);
     ezDebugRenderer::DrawInfoText(hView, ezDebugRenderer::ScreenPlacement::TopLeft, "VisCulling", sb, ezColor::LimeGreen);
 
+    sb.Format("Num Objects Occluded: {0}", stats.m_uiNumObjectsOccluded);
+    ezDebugRenderer::DrawInfoText(hView, ezDebugRenderer::ScreenPlacement::TopLeft, "VisCulling", sb, ezColor::LimeGreen);
+
     // Exponential moving average for better readability.
     m_AverageCullingTime = ezMath::Lerp(m_AverageCullingTime, stats.m_TimeTaken, 0.05f);
 
@@ -969,6 +981,50 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 #endif
 }
 
+const ezOcclusionBuffer* ezRenderPipeline::RasterizeOccluders(const ezView& view, const ezFrustum& frustum)
+{
+  EZ_PROFILE_SCOPE("Rasterize Occluders");
+
+  ezSpatialSystem::QueryParams queryParams;
+  queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::Occluder.GetBitmask();
+  queryParams.m_IncludeTags = view.m_IncludeTags;
+  queryParams.m_ExcludeTags = view.m_ExcludeTags;
+
+  m_visibleOccluders.Clear();
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, queryParams, m_visibleOccluders);
+
+  if (m_visibleOccluders.IsEmpty())
+    return nullptr;
+
+  // same matrices as in ezView::ComputeCullingFrustum
+  const ezCamera* pCamera = view.GetCullingCamera();
+  const ezRectFloat& viewport = view.GetViewport();
+  const float fViewportAspectRatio = viewport.width / viewport.height;
+
+  ezMat4 projectionMatrix;
+  pCamera->GetProjectionMatrix(fViewportAspectRatio, projectionMatrix);
+
+  const ezUInt32 uiHeight = ezMath::Clamp(cvar_SpatialCullingOcclusionHeight.GetValue(), 16, 1024);
+  const ezUInt32 uiWidth = ezMath::Clamp(static_cast<ezUInt32>(uiHeight * fViewportAspectRatio), 16u, 4096u);
+
+  if (m_pOcclusionBuffer == nullptr)
+  {
+    m_pOcclusionBuffer = EZ_DEFAULT_NEW(ezOcclusionBuffer);
+  }
+
+  m_pOcclusionBuffer->Begin(uiWidth, uiHeight, projectionMatrix * pCamera->GetViewMatrix());
+
+  for (const ezGameObject* pOccluder : m_visibleOccluders)
+  {
+    // the local box is tighter than the global one for rotated objects, which keeps the occluder conservative
+    m_pOcclusionBuffer->RasterizeBox(pOccluder->GetLocalBounds().GetBox(), pOccluder->GetGlobalTransform().GetAsMat4());
+  }
+
+  m_pOcclusionBuffer->End();
+
+  return m_pOcclusionBuffer.Borrow();
+}
+
 void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
 {
   //EZ_PROFILE_AND_MARKER(pRenderContext->GetGALContext(), m_sName.GetData());
@@ -8,6 +8,8 @@
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
 class ezProfilingId;
+class ezOcclusionBuffer;
+class ezFrustum;
 class ezView;
 class ezRenderPipelinePass;
 class ezFrameDataProviderBase;
@@ -84,6 +86,7 @@ private:
 
   void ExtractData(const ezView& view);
   void FindVisibleObjects(const ezView& view);
+  const ezOcclusionBuffer* RasterizeOccluders(const ezView& view, const ezFrustum& frustum);
 
   void Render(ezRenderContext* pRenderer);
 
@@ -96,6 +99,10 @@ private: // Member data
   ezExtractedRenderData m_Data[2];
   ezDynamicArray<const ezGameObject*> m_visibleObjects;
 
+  // Software occlusion culling, see cvar Spatial.Culling.Occlusion
+  ezUniquePtr<ezOcclusionBuffer> m_pOcclusionBuffer;
+  ezDynamicArray<const ezGameObject*> m_visibleOccluders;
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezTime m_AverageCullingTime;
 #endif
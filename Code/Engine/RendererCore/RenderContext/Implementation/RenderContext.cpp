@@ -233,7 +233,7 @@ void ezRenderContext::BindTexture2D(const ezTempHashedString& sSlotName, const e
   if (hTexture.IsValid())
   {
     ezResourceLock<ezTexture2DResource> pTexture(hTexture, acquireMode);
-    BindTexture2D(sSlotName, ezGALDevice::GetDefaultDevice()->GetDefaultResourceView(pTexture->GetGALTexture()));
+    BindTexture2D(sSlotName, pTexture->GetGALResourceView());
     BindSamplerState(sSlotName, pTexture->GetGALSamplerState());
   }
   else
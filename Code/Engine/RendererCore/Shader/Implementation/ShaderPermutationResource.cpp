@@ -335,16 +335,8 @@ ezResourceLoadData ezShaderPermutationResourceLoader::OpenDataStream(const ezRes
     // write the permutation file info back to the output stream, so that the resource can read it as well
     permutationBinary.Write(w).IgnoreResult();
 
-    for (ezUInt32 stage = ezGALShaderStage::VertexShader; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-    {
-      const ezUInt32 uiStageHash = permutationBinary.m_uiShaderStageHashes[stage];
-
-      if (uiStageHash == 0) // not used
-        continue;
-
-      // this is where the preloading happens
-      ezShaderStageBinary::LoadStageBinary((ezGALShaderStage::Enum)stage, uiStageHash);
-    }
+    // read all stage files concurrently in the background, UpdateContent() finds them in the cache or waits for the ones that are still being read
+    ezShaderStageBinary::PreloadStageBinaries(ezMakeArrayPtr(permutationBinary.m_uiShaderStageHashes));
   }
 
   res.m_pDataStream = &pData->m_Reader;
@@ -1,7 +1,9 @@
 #include <RendererCore/RendererCorePCH.h>
 
+#include <Foundation/IO/FileSystem/AsyncFileReadBatch.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <RendererCore/Shader/ShaderStageBinary.h>
 #include <RendererCore/Shader/Types.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
@@ -153,7 +155,54 @@ ezShaderResourceBinding::~ezShaderResourceBinding() {}
 
 //////////////////////////////////////////////////////////////////////////
 
+ezMutex ezShaderStageBinary::s_ShaderStageBinariesMutex;
 ezMap<ezUInt32, ezShaderStageBinary> ezShaderStageBinary::s_ShaderStageBinaries[ezGALShaderStage::ENUM_COUNT];
+ezMap<ezUInt32, ezTaskGroupID> ezShaderStageBinary::s_PreloadingStageBinaries[ezGALShaderStage::ENUM_COUNT];
+
+/// Parses the stage binaries that were read by PreloadStageBinaries() and puts them into the cache. Runs once all reads are done.
+class ezShaderStageBinaryPreloadTask final : public ezTask
+{
+public:
+  ezShaderStageBinaryPreloadTask() { ConfigureTask("Preload Shader Stage Binaries", ezTaskNesting::Never); }
+
+  ezAsyncFileReadBatch m_Batch;
+  ezUInt32 m_StageHashes[ezGALShaderStage::ENUM_COUNT] = {};
+  ezUInt32 m_FileIndices[ezGALShaderStage::ENUM_COUNT] = {};
+
+private:
+  virtual void Execute() override
+  {
+    for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+    {
+      const ezUInt32 uiFile = m_FileIndices[stage];
+
+      if (uiFile == ezInvalidIndex)
+        continue;
+
+      ezShaderStageBinary shaderStageBinary;
+      bool bValid = false;
+
+      // LoadStageBinary() will try again and log the problem
+      if (m_Batch.GetResult(uiFile).Succeeded())
+      {
+        const ezArrayPtr<const ezUInt8> data = m_Batch.GetData(uiFile);
+        ezRawMemoryStreamReader reader(data.GetPtr(), data.GetCount());
+
+        bValid = shaderStageBinary.Read(reader).Succeeded();
+      }
+
+      EZ_LOCK(ezShaderStageBinary::s_ShaderStageBinariesMutex);
+
+      ezShaderStageBinary::s_PreloadingStageBinaries[stage].Remove(m_StageHashes[stage]);
+
+      // another loading lane may have been faster
+      if (bValid && !ezShaderStageBinary::s_ShaderStageBinaries[stage].Contains(m_StageHashes[stage]))
+      {
+        ezShaderStageBinary::s_ShaderStageBinaries[stage].Insert(m_StageHashes[stage], std::move(shaderStageBinary));
+      }
+    }
+  }
+};
 
 ezShaderStageBinary::ezShaderStageBinary() = default;
 
@@ -327,10 +376,8 @@ ezShaderConstantBufferLayout* ezShaderStageBinary::CreateConstantBufferLayout()
 
 ezResult ezShaderStageBinary::WriteStageBinary(ezLogInterface* pLog) const
 {
-  ezStringBuilder sShaderStageFile = ezShaderManager::GetCacheDirectory();
-
-  sShaderStageFile.AppendPath(ezShaderManager::GetActivePlatform().GetData());
-  sShaderStageFile.AppendFormat("/{0}_{1}.ezShaderStage", ezGALShaderStage::Names[m_Stage], ezArgU(m_uiSourceHash, 8, true, 16, true));
+  ezStringBuilder sShaderStageFile;
+  GetStageBinaryFile(m_Stage, m_uiSourceHash, sShaderStageFile);
 
   ezFileWriter StageFileOut;
   if (StageFileOut.Open(sShaderStageFile.GetData()).Failed())
@@ -351,14 +398,27 @@ ezResult ezShaderStageBinary::WriteStageBinary(ezLogInterface* pLog) const
 // static
 ezShaderStageBinary* ezShaderStageBinary::LoadStageBinary(ezGALShaderStage::Enum Stage, ezUInt32 uiHash)
 {
+  ezTaskGroupID preloadGroup;
+
+  {
+    EZ_LOCK(s_ShaderStageBinariesMutex);
+    s_PreloadingStageBinaries[Stage].TryGetValue(uiHash, preloadGroup);
+  }
+
+  // the file is being read already, waiting for it is cheaper than reading it a second time
+  if (preloadGroup.IsValid())
+  {
+    ezTaskSystem::WaitForGroup(preloadGroup);
+  }
+
+  EZ_LOCK(s_ShaderStageBinariesMutex);
+
   auto itStage = s_ShaderStageBinaries[Stage].Find(uiHash);
 
   if (!itStage.IsValid())
   {
-    ezStringBuilder sShaderStageFile = ezShaderManager::GetCacheDirectory();
-
-    sShaderStageFile.AppendPath(ezShaderManager::GetActivePlatform().GetData());
-    sShaderStageFile.AppendFormat("/{0}_{1}.ezShaderStage", ezGALShaderStage::Names[Stage], ezArgU(uiHash, 8, true, 16, true));
+    ezStringBuilder sShaderStageFile;
+    GetStageBinaryFile(Stage, uiHash, sShaderStageFile);
 
     ezFileReader StageFileIn;
     if (StageFileIn.Open(sShaderStageFile.GetData()).Failed())
@@ -392,9 +452,87 @@ ezShaderStageBinary* ezShaderStageBinary::LoadStageBinary(ezGALShaderStage::Enum
   return pShaderStageBinary;
 }
 
+// static
+ezTaskGroupID ezShaderStageBinary::PreloadStageBinaries(ezArrayPtr<const ezUInt32> stageHashes)
+{
+  EZ_ASSERT_DEV(stageHashes.GetCount() == ezGALShaderStage::ENUM_COUNT, "One hash per shader stage is expected");
+
+  // the task owns the batch, so it stays alive until the read data has been parsed
+  ezSharedPtr<ezShaderStageBinaryPreloadTask> pTask = EZ_DEFAULT_NEW(ezShaderStageBinaryPreloadTask);
+  ezTaskGroupID parseGroup;
+
+  {
+    EZ_LOCK(s_ShaderStageBinariesMutex);
+
+    ezStringBuilder sShaderStageFile;
+    for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+    {
+      pTask->m_FileIndices[stage] = ezInvalidIndex;
+
+      if (stageHashes[stage] == 0 || s_ShaderStageBinaries[stage].Contains(stageHashes[stage]) || s_PreloadingStageBinaries[stage].Contains(stageHashes[stage]))
+        continue;
+
+      if (!parseGroup.IsValid())
+      {
+        parseGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::LongRunning);
+      }
+
+      // other threads wait for this group instead of reading the file themselves, the task removes the entry again
+      s_PreloadingStageBinaries[stage].Insert(stageHashes[stage], parseGroup);
+
+      GetStageBinaryFile((ezGALShaderStage::Enum)stage, stageHashes[stage], sShaderStageFile);
+      pTask->m_StageHashes[stage] = stageHashes[stage];
+      pTask->m_FileIndices[stage] = pTask->m_Batch.AddFile(sShaderStageFile);
+    }
+  }
+
+  if (!parseGroup.IsValid())
+    return ezTaskGroupID();
+
+  // the stages are read at the same time, instead of one after another, the parsing runs once all of them are done
+  const ezTaskGroupID readGroup = pTask->m_Batch.Submit();
+
+  ezTaskSystem::AddTaskToGroup(parseGroup, pTask);
+  ezTaskSystem::AddTaskGroupDependency(parseGroup, readGroup);
+  ezTaskSystem::StartTaskGroup(parseGroup);
+
+  return parseGroup;
+}
+
+// static
+void ezShaderStageBinary::GetStageBinaryFile(ezGALShaderStage::Enum Stage, ezUInt32 uiHash, ezStringBuilder& out_sFile)
+{
+  out_sFile = ezShaderManager::GetCacheDirectory();
+
+  out_sFile.AppendPath(ezShaderManager::GetActivePlatform().GetData());
+  out_sFile.AppendFormat("/{0}_{1}.ezShaderStage", ezGALShaderStage::Names[Stage], ezArgU(uiHash, 8, true, 16, true));
+}
+
 // static
 void ezShaderStageBinary::OnEngineShutdown()
 {
+  ezHybridArray<ezTaskGroupID, 16> preloadGroups;
+
+  {
+    EZ_LOCK(s_ShaderStageBinariesMutex);
+
+    for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+    {
+      for (auto it = s_PreloadingStageBinaries[stage].GetIterator(); it.IsValid(); ++it)
+      {
+        preloadGroups.PushBack(it.Value());
+      }
+    }
+  }
+
+  // the preload tasks write into the cache
+  for (const ezTaskGroupID& group : preloadGroups)
+  {
+    ezTaskSystem::WaitForGroup(group);
+  }
+
+  EZ_LOCK(s_ShaderStageBinariesMutex);
+
   for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
   {
     s_ShaderStageBinaries[stage].Clear();
@@ -4,6 +4,8 @@
 #include <Foundation/Containers/Map.h>
 #include <Foundation/IO/Stream.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Types/Enum.h>
 #include <RendererCore/RendererCoreDLL.h>
 #include <RendererFoundation/Descriptors/Descriptors.h>
@@ -142,6 +144,7 @@ private:
   friend class ezShaderCompiler;
   friend class ezShaderPermutationResource;
   friend class ezShaderPermutationResourceLoader;
+  friend class ezShaderStageBinaryPreloadTask;
 
   ezUInt32 m_uiSourceHash = 0;
   ezGALShaderStage::Enum m_Stage = ezGALShaderStage::ENUM_COUNT;
@@ -153,7 +156,19 @@ private:
   ezResult WriteStageBinary(ezLogInterface* pLog) const;
   static ezShaderStageBinary* LoadStageBinary(ezGALShaderStage::Enum Stage, ezUInt32 uiHash);
 
+  /// \brief Starts reading all stage binaries that are not in the cache yet. The files are read concurrently through an ezAsyncFileReadBatch.
+  ///
+  /// \a stageHashes holds one hash per ezGALShaderStage, zero for unused stages.
+  /// Does not wait for the reads, LoadStageBinary() waits for a stage that is still being read, instead of reading it a second time.
+  /// Returns the task group that puts the read binaries into the cache, or an invalid ID if there was nothing to read.
+  static ezTaskGroupID PreloadStageBinaries(ezArrayPtr<const ezUInt32> stageHashes);
+
+  static void GetStageBinaryFile(ezGALShaderStage::Enum Stage, ezUInt32 uiHash, ezStringBuilder& out_sFile);
+
   static void OnEngineShutdown();
 
+  // several resource loading lanes may load shader permutations at the same time
+  static ezMutex s_ShaderStageBinariesMutex;
   static ezMap<ezUInt32, ezShaderStageBinary> s_ShaderStageBinaries[ezGALShaderStage::ENUM_COUNT];
+  static ezMap<ezUInt32, ezTaskGroupID> s_PreloadingStageBinaries[ezGALShaderStage::ENUM_COUNT];
 };
@@ -33,23 +33,25 @@ ezTexture2DResource::ezTexture2DResource(ezResource::DoUpdate ResourceUpdateThre
 
 ezResourceLoadDesc ezTexture2DResource::UnloadData(Unload WhatToUnload)
 {
-  if (m_uiLoadedTextures > 0)
+  if (WhatToUnload == Unload::OneQualityLevel && m_uiLoadedQualityLevels > 1 && !m_bLoadedFallback)
   {
-    for (ezInt32 r = 0; r < 2; ++r)
+    // the mipmap of the dropped quality level stays in the texture, it is just not sampled anymore
+    --m_uiLoadedQualityLevels;
+    UpdateResourceView();
+  }
+  else
+  {
+    if (!m_hGALTexture.IsInvalidated())
     {
-      --m_uiLoadedTextures;
-
-      if (!m_hGALTexture[m_uiLoadedTextures].IsInvalidated())
-      {
-        ezGALDevice::GetDefaultDevice()->DestroyTexture(m_hGALTexture[m_uiLoadedTextures]);
-        m_hGALTexture[m_uiLoadedTextures].Invalidate();
-      }
-
-      m_uiMemoryGPU[m_uiLoadedTextures] = 0;
-
-      if (WhatToUnload == Unload::OneQualityLevel || m_uiLoadedTextures == 0)
-        break;
+      ezGALDevice::GetDefaultDevice()->DestroyTexture(m_hGALTexture);
+      m_hGALTexture.Invalidate();
     }
+
+    m_hGALResourceView.Invalidate();
+    m_uiMemoryGPU = 0;
+    m_uiLoadedQualityLevels = 0;
+    m_uiTextureQualityLevels = 0;
+    m_bLoadedFallback = false;
   }
 
   if (WhatToUnload == Unload::AllQualityLevels)
@@ -62,12 +64,40 @@ ezResourceLoadDesc ezTexture2DResource::UnloadData(Unload WhatToUnload)
   }
 
   ezResourceLoadDesc res;
-  res.m_uiQualityLevelsDiscardable = m_uiLoadedTextures;
-  res.m_uiQualityLevelsLoadable = 2 - m_uiLoadedTextures;
-  res.m_State = m_uiLoadedTextures == 0 ? ezResourceState::Unloaded : ezResourceState::Loaded;
+  res.m_uiQualityLevelsDiscardable = m_bLoadedFallback ? 0 : m_uiLoadedQualityLevels;
+  res.m_uiQualityLevelsLoadable = (m_bLoadedFallback || m_uiNumQualityLevelsInFile == 0) ? 1 : m_uiNumQualityLevelsInFile - m_uiLoadedQualityLevels;
+  res.m_State = m_uiLoadedQualityLevels == 0 ? ezResourceState::Unloaded : ezResourceState::Loaded;
   return res;
 }
 
+void ezTexture2DResource::UpdateResourceView()
+{
+  ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
+  const ezGALTextureCreationDescription& desc = pDevice->GetTexture(m_hGALTexture)->GetDescription();
+
+  // every quality level above the mip tail adds one mipmap, the dropped ones are at the top of the mip chain
+  const ezUInt32 uiDroppedMipLevels = m_uiTextureQualityLevels - m_uiLoadedQualityLevels;
+
+  if (uiDroppedMipLevels == 0)
+  {
+    m_hGALResourceView = pDevice->GetDefaultResourceView(m_hGALTexture);
+  }
+  else
+  {
+    ezGALResourceViewCreationDescription viewDesc;
+    viewDesc.m_hTexture = m_hGALTexture;
+    viewDesc.m_uiMostDetailedMipLevel = uiDroppedMipLevels;
+    viewDesc.m_uiMipLevelsToUse = desc.m_uiMipLevelCount - uiDroppedMipLevels;
+    viewDesc.m_uiArraySize = desc.m_uiArraySize;
+
+    // the device keeps the view with the texture and destroys both together
+    m_hGALResourceView = pDevice->CreateResourceView(viewDesc);
+  }
+
+  m_uiWidth = ezMath::Max(desc.m_uiWidth >> uiDroppedMipLevels, 1u);
+  m_uiHeight = ezMath::Max(desc.m_uiHeight >> uiDroppedMipLevels, 1u);
+}
+
 void ezTexture2DResource::FillOutDescriptor(ezTexture2DResourceDescriptor& td, const ezImage* pImage, bool bSRGB, ezUInt32 uiNumMipLevels,
   ezUInt32& out_MemoryUsed, ezHybridArray<ezGALSystemMemoryDescription, 32>& initData)
 {
@@ -166,78 +196,110 @@ ezResourceLoadDesc ezTexture2DResource::UpdateContent(ezStreamReader* Stream)
   const bool bIsRenderTarget = texFormat.m_iRenderTargetResolutionX != 0;
   EZ_ASSERT_DEV(!bIsRenderTarget, "Render targets are not supported by regular 2D texture resources");
 
+  const ezUInt32 uiNumMipLevels = pImage->GetNumMipLevels();
+
+  // the mip tail holds the 6 smallest mipmaps (or more, if there would be too many quality levels), every quality level above adds one mipmap
+  ezUInt32 uiNumQualityLevels = 1;
+  if (!ezTextureUtils::s_bForceFullQualityAlways && uiNumMipLevels > 6)
   {
+    uiNumQualityLevels = ezMath::Min(uiNumMipLevels - 5, MaxQualityLevels);
+  }
+
+  const ezUInt32 uiNumMipmapsLowRes = uiNumMipLevels - (uiNumQualityLevels - 1);
 
-    const ezUInt32 uiNumMipmapsLowRes = ezTextureUtils::s_bForceFullQualityAlways ? pImage->GetNumMipLevels() : ezMath::Min(pImage->GetNumMipLevels(), 6U);
-    ezUInt32 uiUploadNumMipLevels = 0;
-    bool bCouldLoadMore = false;
+  ezUInt32 uiTargetQualityLevel = 0;
 
-    if (bIsFallback)
+  if (bIsFallback)
+  {
+    if (m_uiLoadedQualityLevels == 0)
     {
-      if (m_uiLoadedTextures == 0)
-      {
-        // only upload fallback textures, if we don't have any texture data at all, yet
-        bCouldLoadMore = true;
-        uiUploadNumMipLevels = uiNumMipmapsLowRes;
-      }
-      else if (m_uiLoadedTextures == 1)
-      {
-        // ignore this texture entirely, if we already have low res data
-        // but assume we could load a higher resolution version
-        bCouldLoadMore = true;
-        ezLog::Debug("Ignoring fallback texture data, low-res resource data is already loaded.");
-      }
-      else
-      {
-        ezLog::Debug("Ignoring fallback texture data, resource is already fully loaded.");
-      }
+      // only upload fallback textures, if we don't have any texture data at all, yet
+      uiTargetQualityLevel = 1;
+    }
+    else
+    {
+      ezLog::Debug("Ignoring fallback texture data, texture data is already loaded.");
+    }
+  }
+  else
+  {
+    if (m_uiLoadedQualityLevels == 0)
+    {
+      // load the mip tail first, so that something can be shown as quickly as possible
+      uiTargetQualityLevel = 1;
     }
     else
     {
-      if (m_uiLoadedTextures == 0)
+      // without a limit, the full texture is loaded right after the mip tail (or the fallback texture)
+      uiTargetQualityLevel = ezMath::Clamp<ezUInt32>(GetQualityLevelLimit(), 1, uiNumQualityLevels);
+
+      if (m_bLoadedFallback)
       {
-        bCouldLoadMore = uiNumMipmapsLowRes < pImage->GetNumMipLevels();
-        uiUploadNumMipLevels = uiNumMipmapsLowRes;
+        // the fallback texture is replaced below
       }
-      else if (m_uiLoadedTextures == 1)
+      else if (uiTargetQualityLevel <= m_uiLoadedQualityLevels)
       {
-        uiUploadNumMipLevels = pImage->GetNumMipLevels();
+        ezLog::Debug("Ignoring texture data, resource already has the requested quality.");
+        uiTargetQualityLevel = 0;
       }
-      else
+      else if (uiTargetQualityLevel <= m_uiTextureQualityLevels)
       {
-        // ignore the texture, if we already have fully loaded data
-        ezLog::Debug("Ignoring texture data, resource is already fully loaded.");
+        // the mipmaps of dropped quality levels are still in the texture, they only need to be sampled again
+        m_uiLoadedQualityLevels = static_cast<ezUInt8>(uiTargetQualityLevel);
+        UpdateResourceView();
+        uiTargetQualityLevel = 0;
       }
     }
 
-    if (uiUploadNumMipLevels > 0)
-    {
-      EZ_ASSERT_DEBUG(m_uiLoadedTextures < 2, "Invalid texture upload");
+    m_uiNumQualityLevelsInFile = static_cast<ezUInt8>(uiNumQualityLevels);
+    m_uiFullQualityExtent = ezMath::Max(pImage->GetWidth(0), pImage->GetHeight(0));
 
-      ezHybridArray<ezGALSystemMemoryDescription, 32> initData;
-      FillOutDescriptor(td, pImage, texFormat.m_bSRGB, uiUploadNumMipLevels, m_uiMemoryGPU[m_uiLoadedTextures], initData);
+    for (ezUInt32 uiQualityLevel = 1; uiQualityLevel <= uiNumQualityLevels; ++uiQualityLevel)
+    {
+      // the mip tail needs the memory of all its mipmaps, every quality level above adds the memory of one larger mipmap
+      const ezUInt32 uiFirstMip = uiNumQualityLevels - uiQualityLevel;
+      const ezUInt32 uiEndMip = uiQualityLevel == 1 ? uiNumMipLevels : uiFirstMip + 1;
 
-      ezTextureUtils::ConfigureSampler(static_cast<ezTextureFilterSetting::Enum>(texFormat.m_TextureFilter.GetValue()), td.m_SamplerDesc);
+      ezUInt32 uiMemory = 0;
+      for (ezUInt32 mip = uiFirstMip; mip < uiEndMip; ++mip)
+      {
+        uiMemory += static_cast<ezUInt32>(pImage->GetDepthPitch(mip)) * pImage->GetNumFaces() * pImage->GetNumArrayIndices();
+      }
 
-      // ignore its return value here, we build our own
-      CreateResource(std::move(td));
+      m_uiQualityLevelMemoryGPU[uiQualityLevel - 1] = uiMemory;
     }
+  }
 
-    {
-      ezResourceLoadDesc res;
-      res.m_uiQualityLevelsDiscardable = m_uiLoadedTextures;
-      res.m_uiQualityLevelsLoadable = bCouldLoadMore ? 1 : 0;
-      res.m_State = ezResourceState::Loaded;
+  if (uiTargetQualityLevel > 0)
+  {
+    // the new texture holds all mipmaps up to the target quality level and replaces the previous one
+    m_uiLoadedQualityLevels = static_cast<ezUInt8>(uiTargetQualityLevel - 1);
 
-      return res;
-    }
+    ezHybridArray<ezGALSystemMemoryDescription, 32> initData;
+    FillOutDescriptor(td, pImage, texFormat.m_bSRGB, uiNumMipmapsLowRes + uiTargetQualityLevel - 1, m_uiMemoryGPU, initData);
+
+    ezTextureUtils::ConfigureSampler(static_cast<ezTextureFilterSetting::Enum>(texFormat.m_TextureFilter.GetValue()), td.m_SamplerDesc);
+
+    // ignore its return value here, we build our own
+    CreateResource(std::move(td));
+
+    m_bLoadedFallback = bIsFallback;
+  }
+
+  {
+    ezResourceLoadDesc res;
+    res.m_uiQualityLevelsDiscardable = m_bLoadedFallback ? 0 : m_uiLoadedQualityLevels;
+    res.m_uiQualityLevelsLoadable = m_bLoadedFallback ? 1 : static_cast<ezUInt8>(uiNumQualityLevels - m_uiLoadedQualityLevels);
+    res.m_State = ezResourceState::Loaded;
+
+    return res;
   }
 }
 
 void ezTexture2DResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezTexture2DResource);
-  out_NewMemoryUsage.m_uiMemoryGPU = m_uiMemoryGPU[0] + m_uiMemoryGPU[1];
+  out_NewMemoryUsage.m_uiMemoryGPU = m_uiMemoryGPU;
 }
 
 EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezTexture2DResource, ezTexture2DResourceDescriptor)
@@ -254,10 +316,16 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezTexture2DResource, ezTexture2DResourceDescrip
   m_uiWidth = descriptor.m_DescGAL.m_uiWidth;
   m_uiHeight = descriptor.m_DescGAL.m_uiHeight;
 
-  m_hGALTexture[m_uiLoadedTextures] = pDevice->CreateTexture(descriptor.m_DescGAL, descriptor.m_InitialContent);
-  EZ_ASSERT_DEV(!m_hGALTexture[m_uiLoadedTextures].IsInvalidated(), "Texture Data could not be uploaded to the GPU");
+  if (!m_hGALTexture.IsInvalidated())
+  {
+    // the resource only has one texture, the new one replaces it
+    pDevice->DestroyTexture(m_hGALTexture);
+  }
+
+  m_hGALTexture = pDevice->CreateTexture(descriptor.m_DescGAL, descriptor.m_InitialContent);
+  EZ_ASSERT_DEV(!m_hGALTexture.IsInvalidated(), "Texture Data could not be uploaded to the GPU");
 
-  pDevice->GetTexture(m_hGALTexture[m_uiLoadedTextures])->SetDebugName(GetResourceDescription());
+  pDevice->GetTexture(m_hGALTexture)->SetDebugName(GetResourceDescription());
 
   if (!m_hSamplerState.IsInvalidated())
   {
@@ -267,7 +335,9 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezTexture2DResource, ezTexture2DResourceDescrip
   m_hSamplerState = pDevice->CreateSamplerState(descriptor.m_SamplerDesc);
   EZ_ASSERT_DEV(!m_hSamplerState.IsInvalidated(), "Sampler state error");
 
-  ++m_uiLoadedTextures;
+  ++m_uiLoadedQualityLevels;
+  m_uiTextureQualityLevels = m_uiLoadedQualityLevels;
+  UpdateResourceView();
 
   return ret;
 }
@@ -325,10 +395,10 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezRenderToTexture2DResource, ezRenderToTexture2
   ezGALTextureCreationDescription descGAL;
   descGAL.SetAsRenderTarget(m_uiWidth, m_uiHeight, m_Format, descriptor.m_SampleCount);
 
-  m_hGALTexture[m_uiLoadedTextures] = pDevice->CreateTexture(descGAL, descriptor.m_InitialContent);
-  EZ_ASSERT_DEV(!m_hGALTexture[m_uiLoadedTextures].IsInvalidated(), "Texture data could not be uploaded to the GPU");
+  m_hGALTexture = pDevice->CreateTexture(descGAL, descriptor.m_InitialContent);
+  EZ_ASSERT_DEV(!m_hGALTexture.IsInvalidated(), "Texture data could not be uploaded to the GPU");
 
-  pDevice->GetTexture(m_hGALTexture[m_uiLoadedTextures])->SetDebugName(GetResourceDescription());
+  pDevice->GetTexture(m_hGALTexture)->SetDebugName(GetResourceDescription());
 
   if (!m_hSamplerState.IsInvalidated())
   {
@@ -338,25 +408,25 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezRenderToTexture2DResource, ezRenderToTexture2
   m_hSamplerState = pDevice->CreateSamplerState(descriptor.m_SamplerDesc);
   EZ_ASSERT_DEV(!m_hSamplerState.IsInvalidated(), "Sampler state error");
 
-  ++m_uiLoadedTextures;
+  ++m_uiLoadedQualityLevels;
+  m_uiTextureQualityLevels = m_uiLoadedQualityLevels;
+  UpdateResourceView();
 
   return ret;
 }
 
 ezResourceLoadDesc ezRenderToTexture2DResource::UnloadData(Unload WhatToUnload)
 {
-  for (ezInt32 r = 0; r < 2; ++r)
+  if (!m_hGALTexture.IsInvalidated())
   {
-    if (!m_hGALTexture[r].IsInvalidated())
-    {
-      ezGALDevice::GetDefaultDevice()->DestroyTexture(m_hGALTexture[r]);
-      m_hGALTexture[r].Invalidate();
-    }
-
-    m_uiMemoryGPU[r] = 0;
+    ezGALDevice::GetDefaultDevice()->DestroyTexture(m_hGALTexture);
+    m_hGALTexture.Invalidate();
   }
 
-  m_uiLoadedTextures = 0;
+  m_hGALResourceView.Invalidate();
+  m_uiMemoryGPU = 0;
+  m_uiLoadedQualityLevels = 0;
+  m_uiTextureQualityLevels = 0;
 
   if (!m_hSamplerState.IsInvalidated())
   {
@@ -365,15 +435,15 @@ ezResourceLoadDesc ezRenderToTexture2DResource::UnloadData(Unload WhatToUnload)
   }
 
   ezResourceLoadDesc res;
-  res.m_uiQualityLevelsDiscardable = m_uiLoadedTextures;
-  res.m_uiQualityLevelsLoadable = 2 - m_uiLoadedTextures;
+  res.m_uiQualityLevelsDiscardable = m_uiLoadedQualityLevels;
+  res.m_uiQualityLevelsLoadable = 2 - m_uiLoadedQualityLevels;
   res.m_State = ezResourceState::Unloaded;
   return res;
 }
 
 ezGALRenderTargetViewHandle ezRenderToTexture2DResource::GetRenderTargetView() const
 {
-  return ezGALDevice::GetDefaultDevice()->GetDefaultRenderTargetView(m_hGALTexture[0]);
+  return ezGALDevice::GetDefaultDevice()->GetDefaultRenderTargetView(m_hGALTexture);
 }
 
 void ezRenderToTexture2DResource::AddRenderView(ezViewHandle hView)
@@ -433,7 +503,7 @@ ezResourceLoadDesc ezRenderToTexture2DResource::UpdateContent(ezStreamReader* St
   EZ_ASSERT_DEV(bIsRenderTarget, "Trying to create a RenderToTexture resource from data that is not set up as a render-target");
 
   {
-    EZ_ASSERT_DEV(m_uiLoadedTextures == 0, "not implemented");
+    EZ_ASSERT_DEV(m_uiLoadedQualityLevels == 0, "not implemented");
 
     if (texFormat.m_iRenderTargetResolutionX == -1)
     {
@@ -460,7 +530,7 @@ ezResourceLoadDesc ezRenderToTexture2DResource::UpdateContent(ezStreamReader* St
 
     ezTextureUtils::ConfigureSampler(static_cast<ezTextureFilterSetting::Enum>(texFormat.m_TextureFilter.GetValue()), td.m_SamplerDesc);
 
-    m_uiLoadedTextures = 0;
+    m_uiLoadedQualityLevels = 0;
 
     CreateResource(std::move(td));
   }
@@ -475,7 +545,7 @@ ezResourceLoadDesc ezRenderToTexture2DResource::UpdateContent(ezStreamReader* St
 void ezRenderToTexture2DResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezRenderToTexture2DResource);
-  out_NewMemoryUsage.m_uiMemoryGPU = m_uiMemoryGPU[0] + m_uiMemoryGPU[1];
+  out_NewMemoryUsage.m_uiMemoryGPU = m_uiMemoryGPU;
 }
 
 EZ_STATICLINK_FILE(RendererCore, RendererCore_Textures_Texture2DResource);
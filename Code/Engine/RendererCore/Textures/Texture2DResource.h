@@ -32,6 +32,14 @@ struct EZ_RENDERERCORE_DLL ezTexture2DResourceDescriptor
   ezArrayPtr<ezGALSystemMemoryDescription> m_InitialContent;
 };
 
+/// \brief A 2D texture resource.
+///
+/// Textures that are loaded from file have one quality level for the smallest mipmaps (the 'mip tail') and one additional quality level
+/// for every larger mipmap. By default the mip tail is loaded first and the full texture right afterwards.
+/// If the number of quality levels is limited through ezResourceManager::SetResourceQualityLevelLimit() (see ezTextureStreamingManager),
+/// only that many quality levels are loaded. All loaded mipmaps are kept in a single GPU texture. Dropping a quality level only clamps the
+/// resource view to the smaller mipmaps, so it takes effect immediately. The memory of dropped mipmaps is released once the texture is
+/// loaded again or unloaded.
 class EZ_RENDERERCORE_DLL ezTexture2DResource : public ezResource
 {
   EZ_ADD_DYNAMIC_REFLECTION(ezTexture2DResource, ezResource);
@@ -40,6 +48,9 @@ class EZ_RENDERERCORE_DLL ezTexture2DResource : public ezResource
   EZ_RESOURCE_DECLARE_CREATEABLE(ezTexture2DResource, ezTexture2DResourceDescriptor);
 
 public:
+  /// \brief The maximum number of quality levels of a texture. Textures with more mipmaps have a larger mip tail.
+  static constexpr ezUInt32 MaxQualityLevels = 12;
+
   ezTexture2DResource();
 
   EZ_ALWAYS_INLINE ezGALResourceFormat::Enum GetFormat() const { return m_Format; }
@@ -50,9 +61,22 @@ public:
   static void FillOutDescriptor(ezTexture2DResourceDescriptor& td, const ezImage* pImage, bool bSRGB, ezUInt32 uiNumMipLevels,
     ezUInt32& out_MemoryUsed, ezHybridArray<ezGALSystemMemoryDescription, 32>& initData);
 
-  const ezGALTextureHandle& GetGALTexture() const { return m_hGALTexture[m_uiLoadedTextures - 1]; }
+  const ezGALTextureHandle& GetGALTexture() const { return m_hGALTexture; }
+
+  /// \brief Returns the view through which the texture should be sampled. It excludes the mipmaps of dropped quality levels.
+  const ezGALResourceViewHandle& GetGALResourceView() const { return m_hGALResourceView; }
+
   const ezGALSamplerStateHandle& GetGALSamplerState() const { return m_hSamplerState; }
 
+  /// \brief Returns how many quality levels the texture file provides. Returns 0 as long as no data was loaded from file.
+  EZ_ALWAYS_INLINE ezUInt8 GetNumQualityLevelsInFile() const { return m_uiNumQualityLevelsInFile; }
+
+  /// \brief Returns how much GPU memory the given quality level (1 = mip tail) adds to the texture.
+  EZ_ALWAYS_INLINE ezUInt32 GetQualityLevelMemoryGPU(ezUInt8 uiQualityLevel) const { return m_uiQualityLevelMemoryGPU[uiQualityLevel - 1]; }
+
+  /// \brief Returns the width or height (whichever is larger) of the largest mipmap in the texture file.
+  EZ_ALWAYS_INLINE ezUInt32 GetFullQualityExtent() const { return m_uiFullQualityExtent; }
+
 protected:
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override;
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
@@ -60,9 +84,19 @@ protected:
 
   ezTexture2DResource(DoUpdate ResourceUpdateThread);
 
-  ezUInt8 m_uiLoadedTextures = 0;
-  ezGALTextureHandle m_hGALTexture[2];
-  ezUInt32 m_uiMemoryGPU[2] = {0, 0};
+  /// \brief Updates the resource view and the size after the number of loaded quality levels or the GAL texture changed.
+  void UpdateResourceView();
+
+  ezUInt8 m_uiLoadedQualityLevels = 0;  ///< How many quality levels can be sampled through m_hGALResourceView.
+  ezUInt8 m_uiTextureQualityLevels = 0; ///< How many quality levels m_hGALTexture holds, including dropped ones.
+  bool m_bLoadedFallback = false;
+  ezGALTextureHandle m_hGALTexture;
+  ezGALResourceViewHandle m_hGALResourceView;
+  ezUInt32 m_uiMemoryGPU = 0;
+
+  ezUInt8 m_uiNumQualityLevelsInFile = 0;
+  ezUInt32 m_uiQualityLevelMemoryGPU[MaxQualityLevels] = {};
+  ezUInt32 m_uiFullQualityExtent = 0;
 
   ezGALTextureType::Enum m_Type = ezGALTextureType::Invalid;
   ezGALResourceFormat::Enum m_Format = ezGALResourceFormat::Invalid;
@@ -0,0 +1,514 @@
+#include <RendererCore/RendererCorePCH.h>
+
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <RendererCore/Material/MaterialResource.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererCore/Textures/Texture2DResource.h>
+#include <RendererCore/Textures/TextureStreamingManager.h>
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, TextureStreamingManager)
+
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "Foundation",
+    "Core",
+    "RenderWorld"
+  END_SUBSYSTEM_DEPENDENCIES
+
+  ON_HIGHLEVELSYSTEMS_STARTUP
+  {
+    ezTextureStreamingManager::OnEngineStartup();
+  }
+
+  ON_HIGHLEVELSYSTEMS_SHUTDOWN
+  {
+    ezTextureStreamingManager::OnEngineShutdown();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
+ezCVarBool cvar_RenderingTextureStreamingEnable("Rendering.TextureStreaming.Enable", false, ezCVarFlags::Save, "Streams texture mipmaps in and out depending on their size on screen");
+ezCVarInt cvar_RenderingTextureStreamingBudgetMB("Rendering.TextureStreaming.BudgetMB", 512, ezCVarFlags::Save, "How much GPU memory streamed textures may use");
+
+namespace
+{
+  // unused textures keep their quality for a while, so that turning the camera around does not reload everything
+  static const ezTime s_KeepUnusedQuality = ezTime::Seconds(2);
+
+  // textures that were not used for a long time are not streamed anymore (they stay at their mip tail)
+  static const ezTime s_StopTrackingUnused = ezTime::Seconds(10);
+
+  template <typename HandleType>
+  struct UsageReport
+  {
+    HandleType m_hResource;
+    float m_fScreenSize = 0.0f;
+  };
+
+  using MaterialReports = ezHashTable<ezUInt64, UsageReport<ezMaterialResourceHandle>>;
+  using TextureReports = ezHashTable<ezUInt64, UsageReport<ezTexture2DResourceHandle>>;
+
+  /// Usage reports of one thread. The owning thread only locks its own buffer, the mutex is only contended while the reports are merged.
+  struct ReportBuffer
+  {
+    ezMutex m_Mutex;
+    MaterialReports m_Materials;
+    TextureReports m_Textures;
+  };
+
+  // the buffers are owned by ezTextureStreamingManager::Data, the generation tells whether they belong to the current engine run
+  static thread_local ReportBuffer* s_pReportBuffer = nullptr;
+  static thread_local ezUInt32 s_uiReportBufferGeneration = 0;
+  static ezUInt32 s_uiGeneration = 0;
+
+  template <typename HandleType>
+  void AddUsageReport(ezHashTable<ezUInt64, UsageReport<HandleType>>& reports, const HandleType& hResource, float fScreenSize)
+  {
+    UsageReport<HandleType>& report = reports[hResource.GetResourceIDHash()];
+    report.m_hResource = hResource;
+    report.m_fScreenSize = ezMath::Max(report.m_fScreenSize, fScreenSize);
+  }
+} // namespace
+
+struct ezTextureStreamingManager::Data
+{
+
+  struct TrackedTexture
+  {
+    ezTexture2DResourceHandle m_hTexture;
+    float m_fScreenSize = 0.0f;
+    ezTime m_LastUsed;
+    ezUInt8 m_uiQualityLevelLimit = 0xFF;
+    ezUInt8 m_uiDesiredQualityLevel = 0;
+    ezUInt32 m_QualityLevelMemory[ezTexture2DResource::MaxQualityLevels] = {};
+  };
+
+  ezMutex m_ReportBuffersMutex;
+  ezDynamicArray<ezUniquePtr<ReportBuffer>> m_ReportBuffers; // protected by m_ReportBuffersMutex
+
+  MaterialReports m_ReportedMaterials;
+  TextureReports m_ReportedTextures;
+
+  ezHashTable<ezUInt64, TrackedTexture> m_Textures;
+
+  ezDynamicArray<TrackedTexture*> m_Candidates;
+  ezDynamicArray<TextureInfo> m_CandidateInfos;
+  ezDynamicArray<ezUInt8> m_CandidateQualityLevels;
+  ezDynamicArray<ezUInt64> m_ToRemove;
+
+  Stats m_Stats;
+};
+
+ezTextureStreamingManager::Data* ezTextureStreamingManager::s_pData = nullptr;
+
+namespace
+{
+  ReportBuffer& GetReportBuffer(ezMutex& buffersMutex, ezDynamicArray<ezUniquePtr<ReportBuffer>>& buffers)
+  {
+    if (s_pReportBuffer == nullptr || s_uiReportBufferGeneration != s_uiGeneration)
+    {
+      ezUniquePtr<ReportBuffer> pBuffer = EZ_DEFAULT_NEW(ReportBuffer);
+      s_pReportBuffer = pBuffer.Borrow();
+      s_uiReportBufferGeneration = s_uiGeneration;
+
+      EZ_LOCK(buffersMutex);
+      buffers.PushBack(std::move(pBuffer));
+    }
+
+    return *s_pReportBuffer;
+  }
+} // namespace
+
+// static
+bool ezTextureStreamingManager::IsEnabled()
+{
+  return cvar_RenderingTextureStreamingEnable;
+}
+
+// static
+void ezTextureStreamingManager::ReportTextureUsage(const ezTexture2DResourceHandle& hTexture, float fScreenSize)
+{
+  if (!hTexture.IsValid() || s_pData == nullptr || !IsEnabled())
+    return;
+
+  ReportBuffer& buffer = GetReportBuffer(s_pData->m_ReportBuffersMutex, s_pData->m_ReportBuffers);
+
+  EZ_LOCK(buffer.m_Mutex);
+  AddUsageReport(buffer.m_Textures, hTexture, fScreenSize);
+}
+
+// static
+void ezTextureStreamingManager::ReportMaterialUsage(const ezMaterialResourceHandle& hMaterial, float fScreenSize)
+{
+  if (!hMaterial.IsValid() || s_pData == nullptr || !IsEnabled())
+    return;
+
+  ReportBuffer& buffer = GetReportBuffer(s_pData->m_ReportBuffersMutex, s_pData->m_ReportBuffers);
+
+  EZ_LOCK(buffer.m_Mutex);
+  AddUsageReport(buffer.m_Materials, hMaterial, fScreenSize);
+}
+
+// static
+float ezTextureStreamingManager::ComputeScreenSize(const ezBoundingSphere& sphere, const ezView& view)
+{
+  const ezCamera* pCamera = view.GetCamera();
+  const ezRectFloat& viewport = view.GetViewport();
+
+  if (pCamera == nullptr || viewport.height <= 0.0f)
+    return 0.0f;
+
+  const float fAspectRatio = viewport.width / viewport.height;
+
+  float fHalfHeight = 0.0f;
+
+  if (pCamera->IsPerspective())
+  {
+    const float fDistance = (sphere.m_vCenter - pCamera->GetPosition()).GetLength();
+    if (fDistance <= sphere.m_fRadius)
+      return viewport.height;
+
+    fHalfHeight = ezMath::Tan(pCamera->GetFovY(fAspectRatio) * 0.5f) * fDistance;
+  }
+  else
+  {
+    fHalfHeight = pCamera->GetDimensionY(fAspectRatio) * 0.5f;
+  }
+
+  if (fHalfHeight <= 0.0f)
+    return viewport.height;
+
+  return ezMath::Min(sphere.m_fRadius / fHalfHeight, 1.0f) * viewport.height;
+}
+
+// static
+ezUInt8 ezTextureStreamingManager::ComputeDesiredQualityLevel(ezUInt8 uiNumQualityLevels, ezUInt32 uiFullQualityExtent, float fScreenSize)
+{
+  // every quality level below the highest one halves the resolution
+  ezUInt8 uiQualityLevel = uiNumQualityLevels;
+  ezUInt32 uiExtent = uiFullQualityExtent;
+
+  while (uiQualityLevel > 1 && static_cast<float>(uiExtent / 2) >= fScreenSize)
+  {
+    uiExtent /= 2;
+    --uiQualityLevel;
+  }
+
+  return uiQualityLevel;
+}
+
+// static
+ezUInt64 ezTextureStreamingManager::ComputeQualityLevels(ezArrayPtr<const TextureInfo> textures, ezUInt64 uiMemoryBudget, ezArrayPtr<ezUInt8> out_QualityLevels)
+{
+  EZ_ASSERT_DEV(textures.GetCount() == out_QualityLevels.GetCount(), "Invalid number of output quality levels");
+
+  ezUInt64 uiMemory = 0;
+
+  ezDynamicArray<ezUInt32> order;
+  order.SetCountUninitialized(textures.GetCount());
+
+  for (ezUInt32 i = 0; i < textures.GetCount(); ++i)
+  {
+    const TextureInfo& texture = textures[i];
+    EZ_ASSERT_DEV(texture.m_QualityLevelMemory.GetCount() >= texture.m_uiNumQualityLevels, "Memory is missing for some quality levels");
+
+    out_QualityLevels[i] = ezMath::Min<ezUInt8>(texture.m_uiNumQualityLevels, 1);
+
+    if (out_QualityLevels[i] > 0)
+    {
+      uiMemory += texture.m_QualityLevelMemory[0];
+    }
+
+    order[i] = i;
+  }
+
+  order.Sort([&](ezUInt32 a, ezUInt32 b) { return textures[a].m_fPriority > textures[b].m_fPriority; });
+
+  // Textures with a priority above zero come first, the others only get what is left.
+  // Within each group, every round gives one more quality level to all textures that are furthest away from their desired quality,
+  // so if the budget runs out, all textures end up the same number of quality levels below their desired one.
+  ezUInt32 uiGroupStart = 0;
+
+  while (uiGroupStart < order.GetCount())
+  {
+    const bool bPositivePriority = textures[order[uiGroupStart]].m_fPriority > 0.0f;
+
+    ezUInt32 uiGroupEnd = uiGroupStart;
+    ezUInt32 uiMaxDeficit = 0;
+
+    for (; uiGroupEnd < order.GetCount(); ++uiGroupEnd)
+    {
+      const TextureInfo& texture = textures[order[uiGroupEnd]];
+      if ((texture.m_fPriority > 0.0f) != bPositivePriority)
+        break;
+
+      const ezUInt32 uiDesired = ezMath::Min(texture.m_uiDesiredQualityLevel, texture.m_uiNumQualityLevels);
+      if (uiDesired > out_QualityLevels[order[uiGroupEnd]])
+      {
+        uiMaxDeficit = ezMath::Max<ezUInt32>(uiMaxDeficit, uiDesired - out_QualityLevels[order[uiGroupEnd]]);
+      }
+    }
+
+    for (ezUInt32 uiDeficit = uiMaxDeficit; uiDeficit > 0; --uiDeficit)
+    {
+      for (ezUInt32 o = uiGroupStart; o < uiGroupEnd; ++o)
+      {
+        const ezUInt32 i = order[o];
+        const TextureInfo& texture = textures[i];
+        const ezUInt32 uiDesired = ezMath::Min(texture.m_uiDesiredQualityLevel, texture.m_uiNumQualityLevels);
+
+        if (uiDesired < out_QualityLevels[i] + uiDeficit)
+          continue;
+
+        const ezUInt32 uiLevelMemory = texture.m_QualityLevelMemory[out_QualityLevels[i]];
+
+        // a texture that does not fit is skipped, a smaller one might still fit
+        if (uiMemory + uiLevelMemory > uiMemoryBudget)
+          continue;
+
+        uiMemory += uiLevelMemory;
+        ++out_QualityLevels[i];
+      }
+    }
+
+    uiGroupStart = uiGroupEnd;
+  }
+
+  return uiMemory;
+}
+
+// static
+const ezTextureStreamingManager::Stats& ezTextureStreamingManager::GetStats()
+{
+  return s_pData->m_Stats;
+}
+
+// static
+void ezTextureStreamingManager::OnEngineStartup()
+{
+  s_pData = EZ_DEFAULT_NEW(ezTextureStreamingManager::Data);
+  ++s_uiGeneration;
+
+  ezRenderWorld::GetExtractionEvent().AddEventHandler(OnExtractionEvent);
+}
+
+// static
+void ezTextureStreamingManager::OnEngineShutdown()
+{
+  ezRenderWorld::GetExtractionEvent().RemoveEventHandler(OnExtractionEvent);
+
+  StopStreaming();
+
+  EZ_DEFAULT_DELETE(s_pData);
+}
+
+// static
+void ezTextureStreamingManager::OnExtractionEvent(const ezRenderWorldExtractionEvent& e)
+{
+  if (e.m_Type != ezRenderWorldExtractionEvent::Type::EndExtraction)
+    return;
+
+  if (!IsEnabled())
+  {
+    StopStreaming();
+    return;
+  }
+
+  Update();
+}
+
+// static
+void ezTextureStreamingManager::Update()
+{
+  EZ_PROFILE_SCOPE("Texture Streaming Update");
+
+  const ezTime tNow = ezTime::Now();
+
+  MaterialReports& reportedMaterials = s_pData->m_ReportedMaterials;
+  TextureReports& reportedTextures = s_pData->m_ReportedTextures;
+
+  // merge the reports of all threads
+  {
+    EZ_LOCK(s_pData->m_ReportBuffersMutex);
+
+    for (auto& pBuffer : s_pData->m_ReportBuffers)
+    {
+      EZ_LOCK(pBuffer->m_Mutex);
+
+      for (auto it = pBuffer->m_Materials.GetIterator(); it.IsValid(); ++it)
+      {
+        AddUsageReport(reportedMaterials, it.Value().m_hResource, it.Value().m_fScreenSize);
+      }
+
+      for (auto it = pBuffer->m_Textures.GetIterator(); it.IsValid(); ++it)
+      {
+        AddUsageReport(reportedTextures, it.Value().m_hResource, it.Value().m_fScreenSize);
+      }
+
+      pBuffer->m_Materials.Clear();
+      pBuffer->m_Textures.Clear();
+    }
+  }
+
+  // resolve the materials to their textures
+  for (auto it = reportedMaterials.GetIterator(); it.IsValid(); ++it)
+  {
+    ezResourceLock<ezMaterialResource> pMaterial(it.Value().m_hResource, ezResourceAcquireMode::AllowLoadingFallback_NeverFail);
+
+    if (pMaterial.GetAcquireResult() != ezResourceAcquireResult::Final)
+      continue;
+
+    for (auto itTexture = pMaterial->GetOrUpdateCachedValues()->m_Texture2DBindings.GetIterator(); itTexture.IsValid(); ++itTexture)
+    {
+      const ezTexture2DResourceHandle& hTexture = itTexture.Value();
+      if (!hTexture.IsValid())
+        continue;
+
+      AddUsageReport(reportedTextures, hTexture, it.Value().m_fScreenSize);
+    }
+  }
+
+  for (auto it = reportedTextures.GetIterator(); it.IsValid(); ++it)
+  {
+    bool bExisted = false;
+    Data::TrackedTexture& texture = s_pData->m_Textures.FindOrAdd(it.Key(), &bExisted);
+
+    if (!bExisted)
+    {
+      texture.m_hTexture = it.Value().m_hResource;
+
+      // don't let the texture load its full quality before the first decision was made
+      texture.m_uiQualityLevelLimit = 1;
+      ezResourceManager::SetResourceQualityLevelLimit(texture.m_hTexture, texture.m_uiQualityLevelLimit);
+    }
+
+    texture.m_fScreenSize = it.Value().m_fScreenSize;
+    texture.m_LastUsed = tNow;
+  }
+
+  // the tables keep their memory for the next frame
+  reportedMaterials.Clear();
+  reportedTextures.Clear();
+
+  // stop streaming textures that were unloaded or not used for a long time (once they are down to their mip tail)
+  s_pData->m_ToRemove.Clear();
+
+  for (auto it = s_pData->m_Textures.GetIterator(); it.IsValid(); ++it)
+  {
+    if (ezResourceManager::GetLoadingState(it.Value().m_hTexture) == ezResourceState::Unloaded)
+    {
+      s_pData->m_ToRemove.PushBack(it.Key());
+    }
+    else if (tNow - it.Value().m_LastUsed > s_StopTrackingUnused)
+    {
+      ezResourceLock<ezTexture2DResource> pTexture(it.Value().m_hTexture, ezResourceAcquireMode::PointerOnly);
+
+      if (pTexture->GetNumQualityLevelsDiscardable() <= 1)
+      {
+        s_pData->m_ToRemove.PushBack(it.Key());
+      }
+    }
+  }
+
+  for (ezUInt64 uiKey : s_pData->m_ToRemove)
+  {
+    Data::TrackedTexture texture;
+    if (s_pData->m_Textures.Remove(uiKey, &texture))
+    {
+      // untracked textures are not limited anymore
+      ezResourceManager::SetResourceQualityLevelLimit(texture.m_hTexture, 0xFF);
+    }
+  }
+
+  // gather the textures whose size is known
+  s_pData->m_Candidates.Clear();
+  s_pData->m_CandidateInfos.Clear();
+
+  Stats& stats = s_pData->m_Stats;
+  stats = Stats();
+  stats.m_uiNumStreamedTextures = s_pData->m_Textures.GetCount();
+  stats.m_uiMemoryBudget = static_cast<ezUInt64>(ezMath::Max<int>(cvar_RenderingTextureStreamingBudgetMB, 0)) * 1024 * 1024;
+
+  for (auto it = s_pData->m_Textures.GetIterator(); it.IsValid(); ++it)
+  {
+    Data::TrackedTexture& texture = it.Value();
+    ezResourceLock<ezTexture2DResource> pTexture(texture.m_hTexture, ezResourceAcquireMode::PointerOnly);
+
+    stats.m_uiResidentMemory += pTexture->GetMemoryUsage().m_uiMemoryGPU;
+
+    const ezUInt8 uiNumQualityLevels = pTexture->GetNumQualityLevelsInFile();
+
+    if (pTexture->GetLoadingState() != ezResourceState::Loaded || uiNumQualityLevels == 0)
+      continue;
+
+    for (ezUInt8 uiQualityLevel = 1; uiQualityLevel <= uiNumQualityLevels; ++uiQualityLevel)
+    {
+      texture.m_QualityLevelMemory[uiQualityLevel - 1] = pTexture->GetQualityLevelMemoryGPU(uiQualityLevel);
+    }
+
+    texture.m_uiDesiredQualityLevel = ComputeDesiredQualityLevel(uiNumQualityLevels, pTexture->GetFullQualityExtent(), texture.m_fScreenSize);
+
+    TextureInfo& info = s_pData->m_CandidateInfos.ExpandAndGetRef();
+    info.m_uiNumQualityLevels = uiNumQualityLevels;
+    info.m_uiDesiredQualityLevel = (tNow - texture.m_LastUsed) > s_KeepUnusedQuality ? 1 : texture.m_uiDesiredQualityLevel;
+    info.m_fPriority = texture.m_LastUsed == tNow ? ezMath::Max(texture.m_fScreenSize, ezMath::SmallEpsilon<float>()) : 0.0f;
+    info.m_QualityLevelMemory = ezArrayPtr<const ezUInt32>(texture.m_QualityLevelMemory, uiNumQualityLevels);
+
+    for (ezUInt8 uiQualityLevel = 1; uiQualityLevel <= info.m_uiDesiredQualityLevel; ++uiQualityLevel)
+    {
+      stats.m_uiDesiredMemory += texture.m_QualityLevelMemory[uiQualityLevel - 1];
+    }
+
+    s_pData->m_Candidates.PushBack(&texture);
+  }
+
+  // distribute the budget and move every texture one step towards its quality level
+  s_pData->m_CandidateQualityLevels.SetCountUninitialized(s_pData->m_Candidates.GetCount());
+  stats.m_uiTargetMemory = ComputeQualityLevels(s_pData->m_CandidateInfos, stats.m_uiMemoryBudget, s_pData->m_CandidateQualityLevels);
+
+  for (ezUInt32 i = 0; i < s_pData->m_Candidates.GetCount(); ++i)
+  {
+    Data::TrackedTexture& texture = *s_pData->m_Candidates[i];
+    const ezUInt8 uiQualityLevel = s_pData->m_CandidateQualityLevels[i];
+
+    ezResourceLock<ezTexture2DResource> pTexture(texture.m_hTexture, ezResourceAcquireMode::PointerOnly);
+
+    if (texture.m_uiQualityLevelLimit != uiQualityLevel || pTexture->GetNumQualityLevelsDiscardable() > uiQualityLevel)
+    {
+      texture.m_uiQualityLevelLimit = uiQualityLevel;
+      ezResourceManager::SetResourceQualityLevelLimit(texture.m_hTexture, uiQualityLevel);
+    }
+  }
+}
+
+// static
+void ezTextureStreamingManager::StopStreaming()
+{
+  if (s_pData->m_Textures.IsEmpty())
+    return;
+
+  // all textures may load their full quality again
+  for (auto it = s_pData->m_Textures.GetIterator(); it.IsValid(); ++it)
+  {
+    ezResourceManager::SetResourceQualityLevelLimit(it.Value().m_hTexture, 0xFF);
+  }
+
+  s_pData->m_Textures.Clear();
+  s_pData->m_Stats = Stats();
+
+  EZ_LOCK(s_pData->m_ReportBuffersMutex);
+
+  for (auto& pBuffer : s_pData->m_ReportBuffers)
+  {
+    EZ_LOCK(pBuffer->m_Mutex);
+    pBuffer->m_Materials.Clear();
+    pBuffer->m_Textures.Clear();
+  }
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Textures_TextureStreamingManager);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Foundation/Math/BoundingSphere.h>
+#include <RendererCore/Declarations.h>
+
+class ezView;
+struct ezRenderWorldExtractionEvent;
+
+/// \brief Decides how many quality levels (mipmaps) of every streamed ezTexture2DResource are kept in GPU memory.
+///
+/// During extraction, components report how large their materials or textures appear on screen. Once all views are extracted,
+/// the manager computes which quality level every reported texture would need and then distributes the GPU memory budget
+/// (cvar 'Rendering.TextureStreaming.BudgetMB') over all streamed textures. If the budget is too small, all textures lose the same
+/// number of mipmaps, textures that are large on screen lose them last.
+///
+/// The result is applied through ezResourceManager::SetResourceQualityLevelLimit(), so mipmaps are streamed in by the regular
+/// resource loading and streamed out one quality level per frame.
+///
+/// Only textures for which usage was reported are streamed, all other textures are always loaded in full quality.
+/// Textures that are not used anymore keep their quality for a while, as long as the budget allows it, and are then reduced to their mip tail.
+class EZ_RENDERERCORE_DLL ezTextureStreamingManager
+{
+public:
+  /// \brief Returns whether texture streaming is enabled (cvar 'Rendering.TextureStreaming.Enable').
+  static bool IsEnabled();
+
+  /// \brief Reports that the given texture is visible at the given size (in pixels) in some view. Can be called from multiple threads.
+  static void ReportTextureUsage(const ezTexture2DResourceHandle& hTexture, float fScreenSize);
+
+  /// \brief Reports that all 2D textures of the given material are visible at the given size (in pixels). Can be called from multiple threads.
+  static void ReportMaterialUsage(const ezMaterialResourceHandle& hMaterial, float fScreenSize);
+
+  /// \brief Returns how many pixels the bounding sphere covers vertically in the given view.
+  static float ComputeScreenSize(const ezBoundingSphere& sphere, const ezView& view);
+
+  /// \brief Returns the lowest quality level at which a texture with the given number of quality levels and full resolution
+  /// has at least as many pixels as it covers on screen.
+  static ezUInt8 ComputeDesiredQualityLevel(ezUInt8 uiNumQualityLevels, ezUInt32 uiFullQualityExtent, float fScreenSize); // [tested]
+
+  struct TextureInfo
+  {
+    /// How many quality levels the texture has in total.
+    ezUInt8 m_uiNumQualityLevels = 0;
+
+    /// The quality level that the texture should have, if there is enough memory.
+    ezUInt8 m_uiDesiredQualityLevel = 0;
+
+    /// Textures with a higher priority keep their desired quality longer. Textures with a priority of zero or below only get memory that
+    /// is left over after all other textures got their desired quality.
+    float m_fPriority = 0.0f;
+
+    /// The GPU memory that each quality level adds on top of all lower quality levels.
+    ezArrayPtr<const ezUInt32> m_QualityLevelMemory;
+  };
+
+  /// \brief Picks a quality level for each texture, such that all of them together need at most \a uiMemoryBudget bytes.
+  ///
+  /// Every texture gets at least its lowest quality level, even if that exceeds the budget.
+  /// Returns how much memory the textures need with the chosen quality levels.
+  static ezUInt64 ComputeQualityLevels(ezArrayPtr<const TextureInfo> textures, ezUInt64 uiMemoryBudget, ezArrayPtr<ezUInt8> out_QualityLevels); // [tested]
+
+  struct Stats
+  {
+    ezUInt32 m_uiNumStreamedTextures = 0;
+    ezUInt64 m_uiMemoryBudget = 0;
+    ezUInt64 m_uiDesiredMemory = 0;  ///< How much memory all streamed textures would need in their desired quality.
+    ezUInt64 m_uiTargetMemory = 0;   ///< How much memory all streamed textures need in the quality that fits the budget.
+    ezUInt64 m_uiResidentMemory = 0; ///< How much memory all streamed textures use right now.
+  };
+
+  /// \brief Returns the statistics of the last update.
+  static const Stats& GetStats();
+
+private:
+  EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(RendererCore, TextureStreamingManager);
+
+  static void OnEngineStartup();
+  static void OnEngineShutdown();
+
+  static void OnExtractionEvent(const ezRenderWorldExtractionEvent& e);
+  static void Update();
+  static void StopStreaming();
+
+  struct Data;
+  static Data* s_pData;
+};
@@ -12,6 +12,10 @@
 #  include <tmmintrin.h>
 #endif
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_41
+#  include <smmintrin.h>
+#endif
+
 namespace
 {
   // 3D vector: 11/11/10 floating-point components
@@ -35,6 +39,61 @@ namespace
     } p;
     ezUInt32 v;
   };
+
+  /// Lookup tables that give exactly the same results as converting between ezColorGammaUB and ezColor,
+  /// but without evaluating ezMath::Pow for every channel.
+  struct SrgbConversionTables
+  {
+    SrgbConversionTables()
+    {
+      for (ezUInt32 i = 0; i < 256; ++i)
+      {
+        m_ToLinear[i] = ezColor::GammaToLinear(ezMath::ColorByteToFloat(static_cast<ezUInt8>(i)));
+      }
+
+      // m_ToGammaThresholds[i] is the smallest linear value that is converted to a gamma value of at least i.
+      // Positive floats sort like their bit patterns, so the thresholds can be found with a binary search on the bits.
+      m_ToGammaThresholds[0] = 0.0f;
+      for (ezUInt32 i = 1; i < 256; ++i)
+      {
+        ezUInt32 uiLow = ezIntFloatUnion(0.0f).i;
+        ezUInt32 uiHigh = ezIntFloatUnion(1.0f).i;
+
+        while (uiLow < uiHigh)
+        {
+          const ezUInt32 uiMid = uiLow + (uiHigh - uiLow) / 2;
+
+          if (ezMath::ColorFloatToByte(ezColor::LinearToGamma(ezIntFloatUnion(uiMid).f)) >= i)
+            uiHigh = uiMid;
+          else
+            uiLow = uiMid + 1;
+        }
+
+        m_ToGammaThresholds[i] = ezIntFloatUnion(uiLow).f;
+      }
+    }
+
+    EZ_ALWAYS_INLINE ezUInt8 ToGamma(float fLinear) const
+    {
+      // find the last threshold that is not larger than the value, NaN fails all comparisons and ends up at zero
+      ezUInt32 uiIndex = 0;
+      for (ezUInt32 uiStep = 128; uiStep > 0; uiStep >>= 1)
+      {
+        uiIndex = (fLinear >= m_ToGammaThresholds[uiIndex + uiStep]) ? uiIndex + uiStep : uiIndex;
+      }
+
+      return static_cast<ezUInt8>(uiIndex);
+    }
+
+    float m_ToLinear[256];
+    float m_ToGammaThresholds[256];
+  };
+
+  const SrgbConversionTables& GetSrgbConversionTables()
+  {
+    static SrgbConversionTables tables;
+    return tables;
+  }
 } // namespace
 
 ezColorBaseUB ezDecompressA4B4G4R4(ezUInt16 uiColor)
@@ -246,11 +305,54 @@ class ezImageConversionStep_Compress16bpp : ezImageConversionStepLinear
   }
 };
 
-#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_41
+
+// Converts four floats to halfs (in the lower 16 bits of every lane) with exactly the same results as ezFloat16.
+// Returns false if any of the values needs a denormalized half, those are rare and left to ezFloat16.
+static bool ConvertFloatToHalf(__m128i floatBits, __m128i& out_halfBits)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i sign = _mm_and_si128(_mm_srli_epi32(floatBits, 16), _mm_set1_epi32(0x8000));
+  const __m128i exponent = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(floatBits, 23), _mm_set1_epi32(0xFF)), _mm_set1_epi32(127 - 15));
+  const __m128i mantissa = _mm_and_si128(floatBits, _mm_set1_epi32(0x007FFFFF));
+  const __m128i halfMantissa = _mm_srli_epi32(mantissa, 13);
+
+  const __m128i underflow = _mm_cmplt_epi32(exponent, _mm_set1_epi32(-10));
+  const __m128i overflow = _mm_cmpgt_epi32(exponent, _mm_set1_epi32(30));
+  const __m128i denormal = _mm_andnot_si128(underflow, _mm_cmplt_epi32(exponent, _mm_set1_epi32(1)));
+
+  if (_mm_movemask_epi8(denormal) != 0)
+    return false;
+
+  // NaN keeps its mantissa, but must not turn into Inf
+  const __m128i nan = _mm_andnot_si128(_mm_cmpeq_epi32(mantissa, zero), _mm_cmpeq_epi32(exponent, _mm_set1_epi32(0xFF - (127 - 15))));
+  const __m128i nanMantissa = _mm_and_si128(nan, _mm_or_si128(halfMantissa, _mm_and_si128(_mm_cmpeq_epi32(halfMantissa, zero), _mm_set1_epi32(1))));
+
+  const __m128i infinity = _mm_or_si128(_mm_or_si128(sign, _mm_set1_epi32(0x7C00)), nanMantissa);
+  const __m128i normal = _mm_or_si128(sign, _mm_or_si128(_mm_slli_epi32(exponent, 10), halfMantissa));
 
-static bool IsAligned(const void* pointer)
+  out_halfBits = _mm_andnot_si128(underflow, _mm_blendv_epi8(normal, infinity, overflow));
+  return true;
+}
+
+// Converts four halfs (in the lower 16 bits of every lane) to floats with exactly the same results as ezFloat16.
+static __m128 ConvertHalfToFloat(__m128i halfBits)
 {
-  return reinterpret_cast<size_t>(pointer) % 16 == 0;
+  const __m128i exponentMask = _mm_set1_epi32(0x7C00 << 13);
+
+  __m128i bits = _mm_slli_epi32(_mm_and_si128(halfBits, _mm_set1_epi32(0x7FFF)), 13);
+  const __m128i exponent = _mm_and_si128(bits, exponentMask);
+  bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+  // Inf and NaN get the maximum float exponent
+  bits = _mm_add_epi32(bits, _mm_and_si128(_mm_cmpeq_epi32(exponent, exponentMask), _mm_set1_epi32((128 - 16) << 23)));
+
+  // Zero and denormals are renormalized by adding the implicit one and subtracting it again as a float
+  const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(113 << 23));
+  const __m128 renormalized = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))), magic);
+  const __m128 result = _mm_blendv_ps(_mm_castsi128_ps(bits), renormalized, _mm_castsi128_ps(_mm_cmpeq_epi32(exponent, _mm_setzero_si128())));
+
+  return _mm_or_ps(result, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(halfBits, _mm_set1_epi32(0x8000)), 16)));
 }
 
 #endif
@@ -280,7 +382,6 @@ struct ezImageSwizzleConversion32_2103 : public ezImageConversionStepLinear
     void* targetPointer = target.GetPtr();
 
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    if (IsAligned(sourcePointer) && IsAligned(targetPointer))
     {
 #  if EZ_SSE_LEVEL >= EZ_SSE_30
       const ezUInt32 elementsPerBatch = 8;
@@ -290,11 +391,11 @@ struct ezImageSwizzleConversion32_2103 : public ezImageConversionStepLinear
       // Intel optimization manual, Color Pixel Format Conversion Using SSE3
       while (numElements >= elementsPerBatch)
       {
-        __m128i in0 = reinterpret_cast<const __m128i*>(sourcePointer)[0];
-        __m128i in1 = reinterpret_cast<const __m128i*>(sourcePointer)[1];
+        __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer) + 0);
+        __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer) + 1);
 
-        reinterpret_cast<__m128i*>(targetPointer)[0] = _mm_shuffle_epi8(in0, shuffleMask);
-        reinterpret_cast<__m128i*>(targetPointer)[1] = _mm_shuffle_epi8(in1, shuffleMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer) + 0, _mm_shuffle_epi8(in0, shuffleMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer) + 1, _mm_shuffle_epi8(in1, shuffleMask));
 
         sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
         targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
@@ -309,13 +410,13 @@ struct ezImageSwizzleConversion32_2103 : public ezImageConversionStepLinear
       // Intel optimization manual, Color Pixel Format Conversion Using SSE2
       while (numElements >= elementsPerBatch)
       {
-        __m128i in0 = reinterpret_cast<const __m128i*>(sourcePointer)[0];
-        __m128i in1 = reinterpret_cast<const __m128i*>(sourcePointer)[1];
+        __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer) + 0);
+        __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer) + 1);
 
-        reinterpret_cast<__m128i*>(targetPointer)[0] =
-          _mm_or_si128(_mm_and_si128(in0, mask1), _mm_and_si128(_mm_or_si128(_mm_slli_epi32(in0, 16), _mm_srli_epi32(in0, 16)), mask2));
-        reinterpret_cast<__m128i*>(targetPointer)[1] =
-          _mm_or_si128(_mm_and_si128(in1, mask1), _mm_and_si128(_mm_or_si128(_mm_slli_epi32(in1, 16), _mm_srli_epi32(in1, 16)), mask2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer) + 0,
+          _mm_or_si128(_mm_and_si128(in0, mask1), _mm_and_si128(_mm_or_si128(_mm_slli_epi32(in0, 16), _mm_srli_epi32(in0, 16)), mask2)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer) + 1,
+          _mm_or_si128(_mm_and_si128(in1, mask1), _mm_and_si128(_mm_or_si128(_mm_slli_epi32(in1, 16), _mm_srli_epi32(in1, 16)), mask2)));
 
         sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
         targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
@@ -367,7 +468,6 @@ struct ezImageConversion_BGRX_BGRA : public ezImageConversionStepLinear
     void* targetPointer = target.GetPtr();
 
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
-    if (IsAligned(sourcePointer) && IsAligned(targetPointer))
     {
       const ezUInt32 elementsPerBatch = 4;
 
@@ -378,7 +478,7 @@ struct ezImageConversion_BGRX_BGRA : public ezImageConversionStepLinear
         const __m128i* pSource = reinterpret_cast<const __m128i*>(sourcePointer);
         __m128i* pTarget = reinterpret_cast<__m128i*>(targetPointer);
 
-        pTarget[0] = _mm_or_si128(pSource[0], mask);
+        _mm_storeu_si128(pTarget, _mm_or_si128(_mm_loadu_si128(pSource), mask));
 
         sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
         targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
@@ -524,9 +624,17 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+    const SrgbConversionTables& tables = GetSrgbConversionTables();
+
     while (numElements)
     {
-      *reinterpret_cast<ezColorGammaUB*>(targetPointer) = *reinterpret_cast<const ezColor*>(sourcePointer);
+      const float* pSource = static_cast<const float*>(sourcePointer);
+      ezUInt8* pTarget = static_cast<ezUInt8*>(targetPointer);
+
+      pTarget[0] = tables.ToGamma(pSource[0]);
+      pTarget[1] = tables.ToGamma(pSource[1]);
+      pTarget[2] = tables.ToGamma(pSource[2]);
+      pTarget[3] = ezMath::ColorFloatToByte(pSource[3]);
 
       sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride);
       targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride);
@@ -563,6 +671,41 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_41
+    {
+      const ezUInt32 elementsPerBatch = 8;
+
+      __m128 zero = _mm_setzero_ps();
+      __m128 one = _mm_set1_ps(1.0f);
+      __m128 scale = _mm_set1_ps(65535.0f);
+      __m128 half = _mm_set1_ps(0.5f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128 float0 = _mm_loadu_ps(static_cast<const float*>(sourcePointer) + 0);
+        __m128 float1 = _mm_loadu_ps(static_cast<const float*>(sourcePointer) + 4);
+
+        // Clamp NaN to zero
+        float0 = _mm_and_ps(_mm_cmpord_ps(float0, zero), float0);
+        float1 = _mm_and_ps(_mm_cmpord_ps(float1, zero), float1);
+
+        // Saturate
+        float0 = _mm_max_ps(zero, _mm_min_ps(one, float0));
+        float1 = _mm_max_ps(zero, _mm_min_ps(one, float1));
+
+        // Scale, add 0.5f and truncate for rounding as required by D3D spec
+        __m128i int0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(float0, scale), half));
+        __m128i int1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(float1, scale), half));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer), _mm_packus_epi32(int0, int1));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
 
@@ -602,6 +745,33 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_41
+    {
+      const ezUInt32 elementsPerBatch = 8;
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i half0, half1;
+        if (ConvertFloatToHalf(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer) + 0), half0) &&
+            ConvertFloatToHalf(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer) + 1), half1))
+        {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer), _mm_packus_epi32(half0, half1));
+        }
+        else
+        {
+          for (ezUInt32 i = 0; i < elementsPerBatch; ++i)
+          {
+            static_cast<ezFloat16*>(targetPointer)[i] = static_cast<const float*>(sourcePointer)[i];
+          }
+        }
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
 
@@ -682,6 +852,33 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_41
+    {
+      const ezUInt32 elementsPerBatch = 16;
+
+      __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer));
+
+        __m128i int0 = _mm_cvtepu8_epi32(bytes);
+        __m128i int1 = _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 4));
+        __m128i int2 = _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 8));
+        __m128i int3 = _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 12));
+
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 0, _mm_mul_ps(_mm_cvtepi32_ps(int0), scale));
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 4, _mm_mul_ps(_mm_cvtepi32_ps(int1), scale));
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 8, _mm_mul_ps(_mm_cvtepi32_ps(int2), scale));
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 12, _mm_mul_ps(_mm_cvtepi32_ps(int3), scale));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
       *reinterpret_cast<float*>(targetPointer) = ezMath::ColorByteToFloat(*reinterpret_cast<const ezUInt8*>(sourcePointer));
@@ -715,9 +912,17 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+    const SrgbConversionTables& tables = GetSrgbConversionTables();
+
     while (numElements)
     {
-      *reinterpret_cast<ezColor*>(targetPointer) = *reinterpret_cast<const ezColorGammaUB*>(sourcePointer);
+      const ezUInt8* pSource = static_cast<const ezUInt8*>(sourcePointer);
+      float* pTarget = static_cast<float*>(targetPointer);
+
+      pTarget[0] = tables.m_ToLinear[pSource[0]];
+      pTarget[1] = tables.m_ToLinear[pSource[1]];
+      pTarget[2] = tables.m_ToLinear[pSource[2]];
+      pTarget[3] = ezMath::ColorByteToFloat(pSource[3]);
 
       sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride);
       targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride);
@@ -754,6 +959,29 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_41
+    {
+      const ezUInt32 elementsPerBatch = 8;
+
+      __m128 scale = _mm_set1_ps(1.0f / 65535.0f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i shorts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer));
+
+        __m128i int0 = _mm_cvtepu16_epi32(shorts);
+        __m128i int1 = _mm_cvtepu16_epi32(_mm_srli_si128(shorts, 8));
+
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 0, _mm_mul_ps(_mm_cvtepi32_ps(int0), scale));
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 4, _mm_mul_ps(_mm_cvtepi32_ps(int1), scale));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
       *reinterpret_cast<float*>(targetPointer) = ezMath::ColorShortToFloat(*reinterpret_cast<const ezUInt16*>(sourcePointer));
@@ -792,6 +1020,24 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_41
+    {
+      const ezUInt32 elementsPerBatch = 8;
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i halfs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePointer));
+
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 0, ConvertHalfToFloat(_mm_cvtepu16_epi32(halfs)));
+        _mm_storeu_ps(static_cast<float*>(targetPointer) + 4, ConvertHalfToFloat(_mm_cvtepu16_epi32(_mm_srli_si128(halfs, 8))));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
       *reinterpret_cast<float*>(targetPointer) = *reinterpret_cast<const ezFloat16*>(sourcePointer);
@@ -2,6 +2,8 @@
 
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Math/Math.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 #include <Texture/Image/ImageConversion.h>
 
@@ -140,6 +142,46 @@ namespace
       return scratchBuffers.GetCount() - 1;
     }
   }
+
+  // Large enough that the task overhead does not matter, small enough that the data of one task stays in the cache.
+  constexpr ezUInt32 s_uiElementsPerConversionTask = 16 * 1024;
+
+  ezResult ConvertPixelsParallel(const ezImageConversionStepLinear* pStep, ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numElements,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat)
+  {
+    const ezUInt32 sourceBpp = ezImageFormat::GetBitsPerPixel(sourceFormat);
+    const ezUInt32 targetBpp = ezImageFormat::GetBitsPerPixel(targetFormat);
+
+    // When converting in place, a task could overwrite the source data of another task, unless both formats have the same size.
+    const bool bOverlapping = source.GetPtr() < target.GetEndPtr() && target.GetPtr() < source.GetEndPtr();
+
+    if (numElements <= s_uiElementsPerConversionTask || sourceBpp % 8 != 0 || targetBpp % 8 != 0 || (bOverlapping && sourceBpp != targetBpp))
+    {
+      return pStep->ConvertPixels(source, target, numElements, sourceFormat, targetFormat);
+    }
+
+    const ezUInt32 uiNumTasks = (numElements + s_uiElementsPerConversionTask - 1) / s_uiElementsPerConversionTask;
+
+    ezAtomicInteger32 iNumFailed;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiNumTasks,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        const ezUInt64 uiFirstElement = ezUInt64(uiStartIndex) * s_uiElementsPerConversionTask;
+        const ezUInt64 uiNumTaskElements = ezMath::Min<ezUInt64>(ezUInt64(uiEndIndex) * s_uiElementsPerConversionTask, numElements) - uiFirstElement;
+
+        ezConstByteBlobPtr taskSource = source.GetSubArray(uiFirstElement * sourceBpp / 8, uiNumTaskElements * sourceBpp / 8);
+        ezByteBlobPtr taskTarget = target.GetSubArray(uiFirstElement * targetBpp / 8, uiNumTaskElements * targetBpp / 8);
+
+        if (pStep->ConvertPixels(taskSource, taskTarget, uiNumTaskElements, sourceFormat, targetFormat).Failed())
+        {
+          iNumFailed.Increment();
+        }
+      },
+      "ConvertPixels");
+
+    return iNumFailed == 0 ? EZ_SUCCESS : EZ_FAILURE;
+  }
 } // namespace
 
 ezImageConversionStep::ezImageConversionStep()
@@ -485,8 +527,8 @@ ezResult ezImageConversion::ConvertRaw(
     }
     else
     {
-      if (static_cast<const ezImageConversionStepLinear*>(path[i].m_step)
-            ->ConvertPixels(source, stepTarget, numElements, path[i].m_sourceFormat, path[i].m_targetFormat)
+      if (ConvertPixelsParallel(static_cast<const ezImageConversionStepLinear*>(path[i].m_step), source, stepTarget, numElements,
+            path[i].m_sourceFormat, path[i].m_targetFormat)
             .Failed())
       {
         return EZ_FAILURE;
@@ -520,8 +562,8 @@ ezResult ezImageConversion::ConvertSingleStep(
     {
       // we have to do the computation in 64-bit otherwise it might overflow for very large textures (8k x 4k or bigger).
       ezUInt64 numElements = ezUInt64(8) * target.GetByteBlobPtr().GetCount() / (ezUInt64)ezImageFormat::GetBitsPerPixel(targetFormat);
-      return static_cast<const ezImageConversionStepLinear*>(pStep)->ConvertPixels(
-        source.GetByteBlobPtr(), target.GetByteBlobPtr(), (ezUInt32)numElements, sourceFormat, targetFormat);
+      return ConvertPixelsParallel(static_cast<const ezImageConversionStepLinear*>(pStep), source.GetByteBlobPtr(), target.GetByteBlobPtr(),
+        (ezUInt32)numElements, sourceFormat, targetFormat);
     }
     else
     {
@@ -555,39 +597,56 @@ ezResult ezImageConversion::ConvertSingleStepDecompress(
         const ezUInt64 targetRowPitch = target.GetRowPitch(mipLevel);
         const ezUInt32 targetBytesPerPixel = ezImageFormat::GetBitsPerPixel(targetFormat) / 8;
 
-        // Decompress into a temp memory block so we don't have to explicitly handle the case where the image is not a multiple of the block
-        // size
-        ezHybridArray<ezUInt8, 256> tempBuffer;
-        tempBuffer.SetCount(numBlocksX * blockSizeX * blockSizeY * targetBytesPerPixel);
-
         for (ezUInt32 slice = 0; slice < source.GetDepth(mipLevel); slice++)
         {
-          for (ezUInt32 blockY = 0; blockY < numBlocksY; blockY++)
-          {
-            ezImageView sourceRowView = source.GetRowView(mipLevel, face, arrayIndex, blockY, slice);
+          ezAtomicInteger32 iNumFailed;
 
-            if (static_cast<const ezImageConversionStepDecompressBlocks*>(pStep)
-                  ->DecompressBlocks(sourceRowView.GetByteBlobPtr(), ezByteBlobPtr(tempBuffer.GetData(), tempBuffer.GetCount()), numBlocksX,
-                    sourceFormat, targetFormat)
-                  .Failed())
-            {
-              return EZ_FAILURE;
-            }
+          // every row of blocks is independent, large images are decompressed in parallel
+          ezParallelForParams params;
+          params.uiBinSize = ezMath::Max(1u, s_uiElementsPerConversionTask / ezMath::Max(1u, numBlocksX * blockSizeX * blockSizeY));
 
-            for (ezUInt32 blockX = 0; blockX < numBlocksX; blockX++)
-            {
-              ezUInt8* targetPointer = target.GetPixelPointer<ezUInt8>(mipLevel, face, arrayIndex, blockX * blockSizeX, blockY * blockSizeY, slice);
+          ezTaskSystem::ParallelForIndexed(
+            0, numBlocksY,
+            [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+              // Decompress into a temp memory block so we don't have to explicitly handle the case where the image is not a multiple of the
+              // block size
+              ezHybridArray<ezUInt8, 256> tempBuffer;
+              tempBuffer.SetCount(numBlocksX * blockSizeX * blockSizeY * targetBytesPerPixel);
 
-              // Copy into actual target, clamping to image dimensions
-              ezUInt32 copyWidth = ezMath::Min(blockSizeX, width - blockX * blockSizeX);
-              ezUInt32 copyHeight = ezMath::Min(blockSizeY, height - blockY * blockSizeY);
-              for (ezUInt32 row = 0; row < copyHeight; row++)
+              for (ezUInt32 blockY = uiStartIndex; blockY < uiEndIndex; blockY++)
               {
-                memcpy(targetPointer, &tempBuffer[(blockX * blockSizeX + row) * blockSizeY * targetBytesPerPixel],
-                  ezMath::SafeMultiply32(copyWidth, targetBytesPerPixel));
-                targetPointer += targetRowPitch;
+                ezImageView sourceRowView = source.GetRowView(mipLevel, face, arrayIndex, blockY, slice);
+
+                if (static_cast<const ezImageConversionStepDecompressBlocks*>(pStep)
+                      ->DecompressBlocks(sourceRowView.GetByteBlobPtr(), ezByteBlobPtr(tempBuffer.GetData(), tempBuffer.GetCount()), numBlocksX,
+                        sourceFormat, targetFormat)
+                      .Failed())
+                {
+                  iNumFailed.Increment();
+                  return;
+                }
+
+                for (ezUInt32 blockX = 0; blockX < numBlocksX; blockX++)
+                {
+                  ezUInt8* targetPointer = target.GetPixelPointer<ezUInt8>(mipLevel, face, arrayIndex, blockX * blockSizeX, blockY * blockSizeY, slice);
+
+                  // Copy into actual target, clamping to image dimensions
+                  ezUInt32 copyWidth = ezMath::Min(blockSizeX, width - blockX * blockSizeX);
+                  ezUInt32 copyHeight = ezMath::Min(blockSizeY, height - blockY * blockSizeY);
+                  for (ezUInt32 row = 0; row < copyHeight; row++)
+                  {
+                    memcpy(targetPointer, &tempBuffer[(blockX * blockSizeX + row) * blockSizeY * targetBytesPerPixel],
+                      ezMath::SafeMultiply32(copyWidth, targetBytesPerPixel));
+                    targetPointer += targetRowPitch;
+                  }
+                }
               }
-            }
+            },
+            "DecompressBlocks", params);
+
+          if (iNumFailed > 0)
+          {
+            return EZ_FAILURE;
           }
         }
       }
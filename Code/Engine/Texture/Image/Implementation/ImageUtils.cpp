@@ -3,6 +3,7 @@
 #include <Texture/Image/ImageUtils.h>
 
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
 #include <Texture/Image/ImageFilter.h>
@@ -635,6 +636,48 @@ inline static void FilterLine(
   }
 }
 
+/// Computes a single target sample, when every sample along the filtered axis is a block of numPixels consecutive pixels (e.g. a row when
+/// filtering vertically). All pixels of a block share the same weights and source indices, so those are only looked up once per block
+/// and the inner loop walks linearly through memory.
+static void FilterBlock(ezUInt32 numSourceElements, const ezSimdVec4f* __restrict sourceBegin, ezSimdVec4f* __restrict targetBlock, ezUInt32 stride, ezUInt32 numPixels, const ezImageFilterWeights& weights, ezUInt32 targetIndex, ezInt32 firstSourceIdx, ezImageAddressMode::Enum addressMode, const ezSimdVec4f& borderColor)
+{
+  for (ezUInt32 x = 0; x < numPixels; ++x)
+  {
+    targetBlock[x] = ezSimdVec4f(0.0f, 0.0f, 0.0f, 0.0f);
+  }
+
+  const ezUInt32 numWeights = weights.GetNumWeights();
+  for (ezUInt32 weightIdx = 0; weightIdx < numWeights; ++weightIdx)
+  {
+    const ezSimdVec4f weight(weights.GetWeight(targetIndex, weightIdx));
+
+    bool useBorderColor = false;
+    const ezUInt32 sourceIdx = ezImageUtils::GetSampleIndex(numSourceElements, firstSourceIdx + static_cast<ezInt32>(weightIdx), addressMode, useBorderColor);
+
+    if (useBorderColor)
+    {
+      for (ezUInt32 x = 0; x < numPixels; ++x)
+      {
+        targetBlock[x] = ezSimdVec4f::MulAdd(borderColor, weight, targetBlock[x]);
+      }
+    }
+    else
+    {
+      const ezSimdVec4f* __restrict sourceBlock = sourceBegin + sourceIdx * stride;
+      for (ezUInt32 x = 0; x < numPixels; ++x)
+      {
+        targetBlock[x] = ezSimdVec4f::MulAdd(sourceBlock[x], weight, targetBlock[x]);
+      }
+    }
+  }
+}
+
+/// Returns how many lines of the given length are filtered by one task, such that the task overhead doesn't matter.
+static ezUInt32 GetLinesPerTask(ezUInt64 lineLength)
+{
+  return static_cast<ezUInt32>(ezMath::Max<ezUInt64>(1, 16 * 1024 / ezMath::Max<ezUInt64>(lineLength, 1)));
+}
+
 static void DownScaleFastLine(ezUInt32 pixelStride, const ezUInt8* src, ezUInt8* dest, ezUInt32 lengthIn, ezUInt32 strideIn, ezUInt32 lengthOut, ezUInt32 strideOut)
 {
   const ezUInt32 downScaleFactor = lengthIn / lengthOut;
@@ -683,15 +726,23 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_Result, ezUInt3
   ezImage intermediate;
   intermediate.ResetAndAlloc(intermediateHeader);
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; arrayIndex++)
   {
-    for (ezUInt32 face = 0; face < numFaces; face++)
-    {
-      for (ezUInt32 row = 0; row < originalHeight; row++)
-      {
-        DownScaleFastLine(pixelStride, image.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), originalWidth, pixelStride, width, pixelStride);
-      }
-    }
+    ezParallelForParams params;
+    params.uiBinSize = GetLinesPerTask(originalWidth);
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numArrayElements * numFaces * originalHeight,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 line = uiStartIndex; line < uiEndIndex; ++line)
+        {
+          const ezUInt32 row = line % originalHeight;
+          const ezUInt32 face = (line / originalHeight) % numFaces;
+          const ezUInt32 arrayIndex = line / (originalHeight * numFaces);
+
+          DownScaleFastLine(pixelStride, image.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), originalWidth, pixelStride, width, pixelStride);
+        }
+      },
+      "DownScaleFastX", params);
   }
 
   // input and output images may be the same, so we can't access the original image below this point
@@ -700,7 +751,7 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_Result, ezUInt3
   outHeader.SetWidth(width);
   outHeader.SetHeight(height);
   outHeader.SetNumArrayIndices(numArrayElements);
-  outHeader.SetNumArrayIndices(numFaces);
+  outHeader.SetNumFaces(numFaces);
   outHeader.SetImageFormat(format);
 
   out_Result.ResetAndAlloc(outHeader);
@@ -708,15 +759,23 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_Result, ezUInt3
   EZ_ASSERT_DEBUG(intermediate.GetRowPitch() < ezMath::MaxValue<ezUInt32>(), "Row pitch exceeds ezUInt32 max value.");
   EZ_ASSERT_DEBUG(out_Result.GetRowPitch() < ezMath::MaxValue<ezUInt32>(), "Row pitch exceeds ezUInt32 max value.");
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; arrayIndex++)
   {
-    for (ezUInt32 face = 0; face < numFaces; face++)
-    {
-      for (ezUInt32 col = 0; col < width; col++)
-      {
-        DownScaleFastLine(pixelStride, intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col), out_Result.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col), originalHeight, static_cast<ezUInt32>(intermediate.GetRowPitch()), height, static_cast<ezUInt32>(out_Result.GetRowPitch()));
-      }
-    }
+    ezParallelForParams params;
+    params.uiBinSize = GetLinesPerTask(originalHeight);
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numArrayElements * numFaces * width,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 line = uiStartIndex; line < uiEndIndex; ++line)
+        {
+          const ezUInt32 col = line % width;
+          const ezUInt32 face = (line / width) % numFaces;
+          const ezUInt32 arrayIndex = line / (width * numFaces);
+
+          DownScaleFastLine(pixelStride, intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col), out_Result.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col), originalHeight, static_cast<ezUInt32>(intermediate.GetRowPitch()), height, static_cast<ezUInt32>(out_Result.GetRowPitch()));
+        }
+      },
+      "DownScaleFastY", params);
   }
 }
 
@@ -893,6 +952,11 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
   ezHybridArray<ezInt32, 256> firstSampleIndices;
   firstSampleIndices.Reserve(ezMath::Max(width, height, depth));
 
+  const ezSimdVec4f simdBorderColor(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+
+  // All lines (resp. rows and slices) of all faces and array slices are independent of each other, so every pass is split up into tasks.
+  // The vertical and depth passes filter whole rows resp. slices at once, instead of walking through memory with a large stride.
+
   if (width != originalWidth)
   {
     ezImageFilterWeights weights(*filter, originalWidth, width);
@@ -916,21 +980,25 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetWidth(width);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
+    ezParallelForParams params;
+    params.uiBinSize = GetLinesPerTask(originalWidth);
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numArrayElements * numFaces * originalDepth * originalHeight,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 line = uiStartIndex; line < uiEndIndex; ++line)
         {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 y = line % originalHeight;
+          const ezUInt32 z = (line / originalHeight) % originalDepth;
+          const ezUInt32 face = (line / (originalHeight * originalDepth)) % numFaces;
+          const ezUInt32 arrayIndex = line / (originalHeight * originalDepth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, simdBorderColor);
         }
-      }
-    }
+      },
+      "ScaleImageX", params);
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -959,21 +1027,25 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetHeight(height);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
+    ezParallelForParams params;
+    params.uiBinSize = GetLinesPerTask(width);
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numArrayElements * numFaces * originalDepth * height,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 row = uiStartIndex; row < uiEndIndex; ++row)
         {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 y = row % height;
+          const ezUInt32 z = (row / height) % originalDepth;
+          const ezUInt32 face = (row / (height * originalDepth)) % numFaces;
+          const ezUInt32 arrayIndex = row / (height * originalDepth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, 0, z);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterBlock(originalHeight, filterSource, filterTarget, width, width, weights, y, firstSampleIndices[y], addressModeV, simdBorderColor);
         }
-      }
-    }
+      },
+      "ScaleImageY", params);
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1002,21 +1074,24 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetDepth(depth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 y = 0; y < height; ++y)
+    ezParallelForParams params;
+    params.uiBinSize = GetLinesPerTask(ezUInt64(width) * height);
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numArrayElements * numFaces * depth,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 slice = uiStartIndex; slice < uiEndIndex; ++slice)
         {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 z = slice % depth;
+          const ezUInt32 face = (slice / depth) % numFaces;
+          const ezUInt32 arrayIndex = slice / (depth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, 0, 0);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, 0, z);
+          FilterBlock(originalDepth, filterSource, filterTarget, width * height, width * height, weights, z, firstSampleIndices[z], addressModeW, simdBorderColor);
         }
-      }
-    }
+      },
+      "ScaleImageZ", params);
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1054,58 +1129,69 @@ void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, c
 
   target.ResetAndAlloc(header);
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < source.GetNumArrayIndices(); arrayIndex++)
-  {
-    for (ezUInt32 face = 0; face < source.GetNumFaces(); face++)
-    {
-      ezImageHeader currentMipMapHeader = header;
-      currentMipMapHeader.SetNumMipLevels(1);
-      currentMipMapHeader.SetNumFaces(1);
-      currentMipMapHeader.SetNumArrayIndices(1);
-
-      auto sourceView = source.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
-      auto targetView = target.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
-
-      memcpy(targetView.GetPtr(), sourceView.GetPtr(), static_cast<size_t>(targetView.GetCount()));
+  const ezUInt32 numFaces = source.GetNumFaces();
 
-      float targetCoverage = 0.0f;
-      if (mipMapOptions.m_preserveCoverage)
-      {
-        targetCoverage = EvaluateAverageCoverage(source.GetSubImageView(0, face, arrayIndex).GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
-      }
+  // The mip chains of all faces and array slices are independent of each other. Scale3D splits up the larger mipmaps further.
+  ezParallelForParams params;
+  params.nestingMode = ezTaskNesting::Maybe;
 
-      for (ezUInt32 mipMapLevel = 0; mipMapLevel < numMipMaps - 1; mipMapLevel++)
+  ezTaskSystem::ParallelForIndexed(
+    0, source.GetNumArrayIndices() * numFaces,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 subImage = uiStartIndex; subImage < uiEndIndex; ++subImage)
       {
-        ezImageHeader nextMipMapHeader = currentMipMapHeader;
-        nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
-        nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
-        nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
+        const ezUInt32 face = subImage % numFaces;
+        const ezUInt32 arrayIndex = subImage / numFaces;
 
-        auto sourceData = target.GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
-        ezImage currentMipMap;
-        currentMipMap.ResetAndUseExternalStorage(currentMipMapHeader, sourceData);
+        ezImageHeader currentMipMapHeader = header;
+        currentMipMapHeader.SetNumMipLevels(1);
+        currentMipMapHeader.SetNumFaces(1);
+        currentMipMapHeader.SetNumArrayIndices(1);
 
-        auto dstData = target.GetSubImageView(mipMapLevel + 1, face, arrayIndex).GetByteBlobPtr();
-        ezImage nextMipMap;
-        nextMipMap.ResetAndUseExternalStorage(nextMipMapHeader, dstData);
+        auto sourceView = source.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
+        auto targetView = target.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
 
-        ezImageUtils::Scale3D(currentMipMap, nextMipMap, nextMipMapHeader.GetWidth(), nextMipMapHeader.GetHeight(), nextMipMapHeader.GetDepth(), mipMapOptions.m_filter, mipMapOptions.m_addressModeU, mipMapOptions.m_addressModeV, mipMapOptions.m_addressModeW, mipMapOptions.m_borderColor)
-          .IgnoreResult();
+        memcpy(targetView.GetPtr(), sourceView.GetPtr(), static_cast<size_t>(targetView.GetCount()));
 
+        float targetCoverage = 0.0f;
         if (mipMapOptions.m_preserveCoverage)
         {
-          NormalizeCoverage(nextMipMap.GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold, targetCoverage);
+          targetCoverage = EvaluateAverageCoverage(source.GetSubImageView(0, face, arrayIndex).GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
         }
 
-        if (mipMapOptions.m_renormalizeNormals)
+        for (ezUInt32 mipMapLevel = 0; mipMapLevel < numMipMaps - 1; mipMapLevel++)
         {
-          RenormalizeNormalMap(nextMipMap);
-        }
+          ezImageHeader nextMipMapHeader = currentMipMapHeader;
+          nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
+          nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
+          nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
+
+          auto sourceData = target.GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
+          ezImage currentMipMap;
+          currentMipMap.ResetAndUseExternalStorage(currentMipMapHeader, sourceData);
+
+          auto dstData = target.GetSubImageView(mipMapLevel + 1, face, arrayIndex).GetByteBlobPtr();
+          ezImage nextMipMap;
+          nextMipMap.ResetAndUseExternalStorage(nextMipMapHeader, dstData);
 
-        currentMipMapHeader = nextMipMapHeader;
+          ezImageUtils::Scale3D(currentMipMap, nextMipMap, nextMipMapHeader.GetWidth(), nextMipMapHeader.GetHeight(), nextMipMapHeader.GetDepth(), mipMapOptions.m_filter, mipMapOptions.m_addressModeU, mipMapOptions.m_addressModeV, mipMapOptions.m_addressModeW, mipMapOptions.m_borderColor)
+            .IgnoreResult();
+
+          if (mipMapOptions.m_preserveCoverage)
+          {
+            NormalizeCoverage(nextMipMap.GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold, targetCoverage);
+          }
+
+          if (mipMapOptions.m_renormalizeNormals)
+          {
+            RenormalizeNormalMap(nextMipMap);
+          }
+
+          currentMipMapHeader = nextMipMapHeader;
+        }
       }
-    }
-  }
+    },
+    "GenerateMipMaps", params);
 }
 
 void ezImageUtils::ReconstructNormalZ(ezImage& image)
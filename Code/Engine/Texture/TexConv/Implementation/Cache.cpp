@@ -0,0 +1,360 @@
+#include <Texture/TexturePCH.h>
+
+#include <Foundation/Algorithm/HashStream.h>
+#include <Foundation/IO/FileSystem/DeferredFileWriter.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/OSFile.h>
+#include <Texture/TexConv/TexConvProcessor.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+#  include <Foundation/IO/CompressedStreamZstd.h>
+#endif
+
+namespace
+{
+  // increase this whenever the processing of input files or mipmap chains changes, to invalidate all cached data
+  constexpr ezUInt32 s_uiCacheVersion = 2;
+
+  constexpr const char* s_szInputImageExtension = "ezTexConvInput";
+  constexpr const char* s_szMipChainExtension = "ezTexConvMips";
+
+  void GetCacheFilePath(const ezString& sCacheDirectory, ezUInt64 uiCacheKey, const char* szExtension, ezStringBuilder& out_sPath)
+  {
+    out_sPath.Format("{}/{}.{}", sCacheDirectory, ezArgU(uiCacheKey, 16, true, 16, true), szExtension);
+    out_sPath.MakeCleanPath();
+  }
+
+  void WriteImage(ezStreamWriter& stream, const ezImage& image)
+  {
+    stream << static_cast<ezUInt32>(image.GetImageFormat());
+    stream << image.GetWidth();
+    stream << image.GetHeight();
+    stream << image.GetDepth();
+    stream << image.GetNumMipLevels();
+    stream << image.GetNumFaces();
+    stream << image.GetNumArrayIndices();
+
+    const ezConstByteBlobPtr data = image.GetByteBlobPtr();
+    stream.WriteBytes(data.GetPtr(), data.GetCount()).IgnoreResult();
+  }
+
+  ezResult ReadImage(ezStreamReader& stream, ezImage& out_Image)
+  {
+    ezUInt32 uiFormat = 0;
+    ezUInt32 uiWidth = 0, uiHeight = 0, uiDepth = 0;
+    ezUInt32 uiNumMipLevels = 0, uiNumFaces = 0, uiNumArrayIndices = 0;
+
+    stream >> uiFormat;
+    stream >> uiWidth;
+    stream >> uiHeight;
+    stream >> uiDepth;
+    stream >> uiNumMipLevels;
+    stream >> uiNumFaces;
+    stream >> uiNumArrayIndices;
+
+    if (uiFormat == ezImageFormat::UNKNOWN || uiFormat >= ezImageFormat::NUM_FORMATS || uiWidth == 0 || uiHeight == 0 || uiDepth == 0 ||
+        uiNumMipLevels == 0 || uiNumFaces == 0 || uiNumArrayIndices == 0)
+    {
+      return EZ_FAILURE;
+    }
+
+    ezImageHeader header;
+    header.SetImageFormat(static_cast<ezImageFormat::Enum>(uiFormat));
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetDepth(uiDepth);
+    header.SetNumMipLevels(uiNumMipLevels);
+    header.SetNumFaces(uiNumFaces);
+    header.SetNumArrayIndices(uiNumArrayIndices);
+
+    out_Image.ResetAndAlloc(header);
+
+    const ezByteBlobPtr data = out_Image.GetByteBlobPtr();
+    if (stream.ReadBytes(data.GetPtr(), data.GetCount()) != data.GetCount())
+    {
+      out_Image.Clear();
+      return EZ_FAILURE;
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  void EnforceCacheSizeLimit(const ezString& sCacheDirectory, ezUInt32 uiSizeLimitMB)
+  {
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+    if (uiSizeLimitMB == 0)
+      return;
+
+    const ezUInt64 uiSizeLimit = static_cast<ezUInt64>(uiSizeLimitMB) * 1024 * 1024;
+
+    ezDynamicArray<ezFileStats> items;
+    ezOSFile::GatherAllItemsInFolder(items, sCacheDirectory, ezFileSystemIteratorFlags::ReportFiles);
+
+    ezDynamicArray<ezFileStats> cacheFiles;
+    ezUInt64 uiTotalSize = 0;
+
+    for (const ezFileStats& item : items)
+    {
+      if (ezPathUtils::HasExtension(item.m_sName, s_szInputImageExtension) || ezPathUtils::HasExtension(item.m_sName, s_szMipChainExtension))
+      {
+        uiTotalSize += item.m_uiFileSize;
+        cacheFiles.PushBack(item);
+      }
+    }
+
+    if (uiTotalSize <= uiSizeLimit)
+      return;
+
+    // cache hits do not touch the files, so the modification time is when an entry was written, remove the oldest ones first
+    cacheFiles.Sort([](const ezFileStats& lhs, const ezFileStats& rhs) {
+      return lhs.m_LastModificationTime.GetInt64(ezSIUnitOfTime::Microsecond) < rhs.m_LastModificationTime.GetInt64(ezSIUnitOfTime::Microsecond);
+    });
+
+    // clean up to well below the limit, so that not every following conversion has to scan the directory and delete a file
+    const ezUInt64 uiTargetSize = uiSizeLimit / 4 * 3;
+
+    ezStringBuilder sPath;
+    for (const ezFileStats& item : cacheFiles)
+    {
+      if (uiTotalSize <= uiTargetSize)
+        break;
+
+      item.GetFullPath(sPath);
+
+      // another TexConv process may be reading the file right now, it is removed by a later cleanup then
+      if (ezOSFile::DeleteFile(sPath).Succeeded())
+      {
+        uiTotalSize -= item.m_uiFileSize;
+      }
+    }
+#endif
+  }
+
+  template <typename WriteFunc>
+  void WriteCacheFile(const ezString& sCacheDirectory, ezUInt32 uiSizeLimitMB, const ezStringBuilder& sPath, WriteFunc write)
+  {
+    ezDeferredFileWriter file;
+    file.SetOutput(sPath);
+
+    // the mipmap chains are stored as 32 bit float to keep the output identical to an uncached conversion, compress them losslessly instead
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    const ezUInt8 uiCompressionMode = 1;
+    file << uiCompressionMode;
+
+    ezCompressedStreamWriterZstd compressor(&file, ezCompressedStreamWriterZstd::Compression::Fastest);
+    write(compressor);
+    compressor.FinishCompressedStream().IgnoreResult();
+#else
+    const ezUInt8 uiCompressionMode = 0;
+    file << uiCompressionMode;
+
+    write(file);
+#endif
+
+    // failing to write the cache is not an error, the next conversion just has to do all the work again
+    if (ezOSFile::CreateDirectoryStructure(sCacheDirectory).Failed() || file.Close().Failed())
+    {
+      file.Discard();
+      ezLog::Warning("Could not write intermediate cache file '{}'", sPath);
+      return;
+    }
+
+    EnforceCacheSizeLimit(sCacheDirectory, uiSizeLimitMB);
+  }
+
+  template <typename ReadFunc>
+  ezResult ReadCacheFile(const ezStringBuilder& sPath, ReadFunc read)
+  {
+    ezFileReader file;
+    if (file.Open(sPath).Failed())
+      return EZ_FAILURE;
+
+    ezUInt8 uiCompressionMode = 0;
+    file >> uiCompressionMode;
+
+    switch (uiCompressionMode)
+    {
+      case 0:
+        return read(file);
+
+      case 1:
+      {
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+        ezCompressedStreamReaderZstd decompressorZstd;
+        decompressorZstd.SetInputStream(&file);
+        return read(decompressorZstd);
+#else
+        ezLog::Warning("Intermediate cache file '{}' is compressed with zstandard, but support for this compressor is not compiled in.", sPath);
+        return EZ_FAILURE;
+#endif
+      }
+
+      default:
+        ezLog::Warning("Intermediate cache file '{}' is compressed with an unknown algorithm.", sPath);
+        return EZ_FAILURE;
+    }
+  }
+} // namespace
+
+bool ezTexConvProcessor::IsIntermediateCacheEnabled() const
+{
+  // the cache is keyed by file content, images that were passed in directly are not hashed
+  return !m_Descriptor.m_sIntermediateCacheDirectory.IsEmpty() && !m_Descriptor.m_InputFiles.IsEmpty() && m_Descriptor.m_InputImages.IsEmpty();
+}
+
+ezResult ezTexConvProcessor::HashInputFiles()
+{
+  m_InputFileHashes.Clear();
+
+  ezDynamicArray<ezUInt8> buffer;
+  buffer.SetCountUninitialized(64 * 1024);
+
+  for (const auto& file : m_Descriptor.m_InputFiles)
+  {
+    ezFileReader reader;
+    if (reader.Open(file).Failed())
+    {
+      ezLog::Error("Could not open input file '{0}'.", ezArgSensitive(file, "File"));
+      return EZ_FAILURE;
+    }
+
+    ezHashStreamWriter64 hash(s_uiCacheVersion);
+
+    while (true)
+    {
+      const ezUInt64 uiRead = reader.ReadBytes(buffer.GetData(), buffer.GetCount());
+
+      if (uiRead == 0)
+        break;
+
+      hash.WriteBytes(buffer.GetData(), uiRead).IgnoreResult();
+    }
+
+    m_InputFileHashes.PushBack(hash.GetHashValue());
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezUInt64 ezTexConvProcessor::ComputeMipChainCacheKey() const
+{
+  ezHashStreamWriter64 key(s_uiCacheVersion);
+
+  for (ezUInt64 uiFileHash : m_InputFileHashes)
+  {
+    key << uiFileHash;
+  }
+
+  // the usage may be detected from the file name
+  key.WriteString(ezPathUtils::GetFileName(m_Descriptor.m_InputFiles[0])).IgnoreResult();
+
+  for (const auto& mapping : m_Descriptor.m_ChannelMappings)
+  {
+    for (const auto& channel : mapping.m_Channel)
+    {
+      key << channel.m_iInputImageIndex;
+      key << static_cast<ezInt32>(channel.m_ChannelValue);
+    }
+  }
+
+  // everything that affects the content of the mipmap chain, but not the output format and not the ez specific file header
+  key << static_cast<ezInt32>(m_Descriptor.m_OutputType.GetValue());
+  key << static_cast<ezInt32>(m_Descriptor.m_Usage.GetValue());
+  key << m_Descriptor.m_uiMinResolution;
+  key << m_Descriptor.m_uiMaxResolution;
+  key << m_Descriptor.m_uiDownscaleSteps;
+  key << static_cast<ezInt32>(m_Descriptor.m_MipmapMode.GetValue());
+  key << static_cast<ezInt32>(m_Descriptor.m_AddressModeU.GetValue());
+  key << static_cast<ezInt32>(m_Descriptor.m_AddressModeV.GetValue());
+  key << static_cast<ezInt32>(m_Descriptor.m_AddressModeW.GetValue());
+  key << m_Descriptor.m_bPreserveMipmapCoverage;
+  key << m_Descriptor.m_fMipmapAlphaThreshold;
+  key << m_Descriptor.m_uiDilateColor;
+  key << m_Descriptor.m_bFlipHorizontal;
+  key << m_Descriptor.m_bPremultiplyAlpha;
+  key << m_Descriptor.m_fHdrExposureBias;
+  key << m_Descriptor.m_fMaxValue;
+  key << static_cast<ezInt32>(m_Descriptor.m_BumpMapFilter.GetValue());
+
+  return key.GetHashValue();
+}
+
+ezResult ezTexConvProcessor::LoadCachedInputImage(ezUInt32 uiInputIndex, ezImage& out_Image) const
+{
+  if (uiInputIndex >= m_InputFileHashes.GetCount())
+    return EZ_FAILURE;
+
+  ezStringBuilder sPath;
+  GetCacheFilePath(m_Descriptor.m_sIntermediateCacheDirectory, m_InputFileHashes[uiInputIndex], s_szInputImageExtension, sPath);
+
+  return ReadCacheFile(sPath, [&](ezStreamReader& stream) { return ReadImage(stream, out_Image); });
+}
+
+void ezTexConvProcessor::StoreCachedInputImage(ezUInt32 uiInputIndex, const ezImage& image) const
+{
+  if (uiInputIndex >= m_InputFileHashes.GetCount())
+    return;
+
+  // DDS files are not compressed, reading them is as fast as reading the cache
+  if (ezPathUtils::HasExtension(m_Descriptor.m_InputFiles[uiInputIndex].GetData(), "dds"))
+    return;
+
+  ezStringBuilder sPath;
+  GetCacheFilePath(m_Descriptor.m_sIntermediateCacheDirectory, m_InputFileHashes[uiInputIndex], s_szInputImageExtension, sPath);
+
+  WriteCacheFile(m_Descriptor.m_sIntermediateCacheDirectory, m_Descriptor.m_uiIntermediateCacheSizeLimitMB, sPath,
+    [&](ezStreamWriter& stream) { WriteImage(stream, image); });
+}
+
+ezResult ezTexConvProcessor::LoadCachedMipChain(
+  ezUInt64 uiCacheKey, ezImage& out_MipChain, MipChainInfo& out_Info, ezEnum<ezImageFormat>& out_OutputImageFormat) const
+{
+  ezStringBuilder sPath;
+  GetCacheFilePath(m_Descriptor.m_sIntermediateCacheDirectory, uiCacheKey, s_szMipChainExtension, sPath);
+
+  EZ_SUCCEED_OR_RETURN(ReadCacheFile(sPath, [&](ezStreamReader& stream) {
+    ezInt32 iUsage = 0;
+    stream >> iUsage;
+    stream >> out_Info.m_uiNumChannelsUsed;
+    stream >> out_Info.m_uiInputWidth;
+    stream >> out_Info.m_uiInputHeight;
+    out_Info.m_Usage = static_cast<ezTexConvUsage::Enum>(iUsage);
+
+    return ReadImage(stream, out_MipChain);
+  }));
+
+  EZ_LOG_BLOCK("Cached Mipmap Chain", sPath);
+
+  ezEnum<ezImageFormat> outputFormat;
+  ezUInt32 uiTargetResolutionX = 0;
+  ezUInt32 uiTargetResolutionY = 0;
+  EZ_SUCCEED_OR_RETURN(ChooseOutputFormatAndResolution(out_Info, outputFormat, uiTargetResolutionX, uiTargetResolutionY));
+
+  // the output format may require a different block alignment than the one the mipmap chain was generated for
+  if (out_MipChain.GetWidth() != uiTargetResolutionX || out_MipChain.GetHeight() != uiTargetResolutionY)
+  {
+    ezLog::Info("Cached mipmap chain has a different resolution, regenerating it.");
+    return EZ_FAILURE;
+  }
+
+  ezLog::Info("Reusing the cached mipmap chain.");
+
+  out_OutputImageFormat = outputFormat;
+  return EZ_SUCCESS;
+}
+
+void ezTexConvProcessor::StoreCachedMipChain(ezUInt64 uiCacheKey, const ezImage& mipChain, const MipChainInfo& info) const
+{
+  ezStringBuilder sPath;
+  GetCacheFilePath(m_Descriptor.m_sIntermediateCacheDirectory, uiCacheKey, s_szMipChainExtension, sPath);
+
+  WriteCacheFile(m_Descriptor.m_sIntermediateCacheDirectory, m_Descriptor.m_uiIntermediateCacheSizeLimitMB, sPath, [&](ezStreamWriter& stream) {
+    stream << static_cast<ezInt32>(info.m_Usage.GetValue());
+    stream << info.m_uiNumChannelsUsed;
+    stream << info.m_uiInputWidth;
+    stream << info.m_uiInputHeight;
+    WriteImage(stream, mipChain);
+  });
+}
+
+EZ_STATICLINK_FILE(Texture, Texture_TexConv_Implementation_Cache);
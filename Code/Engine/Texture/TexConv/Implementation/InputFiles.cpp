@@ -33,14 +33,21 @@ ezResult ezTexConvProcessor::LoadInputImages()
   {
     m_Descriptor.m_InputImages.Reserve(m_Descriptor.m_InputFiles.GetCount());
 
-    for (const auto& file : m_Descriptor.m_InputFiles)
+    for (ezUInt32 i = 0; i < m_Descriptor.m_InputFiles.GetCount(); ++i)
     {
+      const auto& file = m_Descriptor.m_InputFiles[i];
+
       auto& img = m_Descriptor.m_InputImages.ExpandAndGetRef();
+      if (LoadCachedInputImage(i, img).Succeeded())
+        continue;
+
       if (img.LoadFrom(file).Failed())
       {
         ezLog::Error("Could not load input file '{0}'.", ezArgSensitive(file, "File"));
         return EZ_FAILURE;
       }
+
+      StoreCachedInputImage(i, img);
     }
   }
 
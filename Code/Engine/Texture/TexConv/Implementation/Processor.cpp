@@ -31,72 +31,114 @@ ezResult ezTexConvProcessor::Process()
   }
   else
   {
-    EZ_SUCCEED_OR_RETURN(LoadInputImages());
+    ezImage mipChain;
+    MipChainInfo mipChainInfo;
+    ezEnum<ezImageFormat> OutputImageFormat;
 
-    EZ_SUCCEED_OR_RETURN(AdjustUsage(m_Descriptor.m_InputFiles[0], m_Descriptor.m_InputImages[0], m_Descriptor.m_Usage));
+    ezUInt64 uiCacheKey = 0;
+    bool bCached = false;
 
-    ezStringBuilder sUsage;
-    ezReflectionUtils::EnumerationToString(
-      ezGetStaticRTTI<ezTexConvUsage>(), m_Descriptor.m_Usage.GetValue(), sUsage, ezReflectionUtils::EnumConversionMode::ValueNameOnly);
-    ezLog::Info("-usage is '{}'", sUsage);
+    if (IsIntermediateCacheEnabled())
+    {
+      EZ_SUCCEED_OR_RETURN(HashInputFiles());
 
-    EZ_SUCCEED_OR_RETURN(ForceSRGBFormats());
+      uiCacheKey = ComputeMipChainCacheKey();
+      bCached = LoadCachedMipChain(uiCacheKey, mipChain, mipChainInfo, OutputImageFormat).Succeeded();
+    }
 
-    ezUInt32 uiNumChannelsUsed = 0;
-    EZ_SUCCEED_OR_RETURN(DetectNumChannels(m_Descriptor.m_ChannelMappings, uiNumChannelsUsed));
+    if (!bCached)
+    {
+      EZ_SUCCEED_OR_RETURN(GenerateMipChain(mipChain, mipChainInfo, OutputImageFormat));
 
-    ezEnum<ezImageFormat> OutputImageFormat;
+      if (uiCacheKey != 0)
+      {
+        StoreCachedMipChain(uiCacheKey, mipChain, mipChainInfo);
+      }
+    }
 
-    EZ_SUCCEED_OR_RETURN(ChooseOutputFormat(OutputImageFormat, m_Descriptor.m_Usage, uiNumChannelsUsed));
+    EZ_SUCCEED_OR_RETURN(GenerateOutput(std::move(mipChain), m_OutputImage, OutputImageFormat));
 
-    ezLog::Info("Output image format is '{}'", ezImageFormat::GetName(OutputImageFormat));
+    EZ_SUCCEED_OR_RETURN(GenerateThumbnailOutput(m_OutputImage, m_ThumbnailOutputImage, m_Descriptor.m_uiThumbnailOutputResolution));
 
-    ezUInt32 uiTargetResolutionX = 0;
-    ezUInt32 uiTargetResolutionY = 0;
+    EZ_SUCCEED_OR_RETURN(GenerateLowResOutput(m_OutputImage, m_LowResOutputImage, m_Descriptor.m_uiLowResMipmaps));
+  }
 
-    EZ_SUCCEED_OR_RETURN(DetermineTargetResolution(m_Descriptor.m_InputImages[0], OutputImageFormat, uiTargetResolutionX, uiTargetResolutionY));
+  return EZ_SUCCESS;
+}
 
-    ezLog::Info("Target resolution is '{} x {}'", uiTargetResolutionX, uiTargetResolutionY);
+ezResult ezTexConvProcessor::GenerateMipChain(ezImage& out_MipChain, MipChainInfo& out_Info, ezEnum<ezImageFormat>& out_OutputImageFormat)
+{
+  EZ_SUCCEED_OR_RETURN(LoadInputImages());
 
-    EZ_SUCCEED_OR_RETURN(ConvertAndScaleInputImages(uiTargetResolutionX, uiTargetResolutionY, m_Descriptor.m_Usage));
+  EZ_SUCCEED_OR_RETURN(AdjustUsage(m_Descriptor.m_InputFiles[0], m_Descriptor.m_InputImages[0], m_Descriptor.m_Usage));
 
-    EZ_SUCCEED_OR_RETURN(ClampInputValues(m_Descriptor.m_InputImages, m_Descriptor.m_fMaxValue));
+  ezStringBuilder sUsage;
+  ezReflectionUtils::EnumerationToString(
+    ezGetStaticRTTI<ezTexConvUsage>(), m_Descriptor.m_Usage.GetValue(), sUsage, ezReflectionUtils::EnumConversionMode::ValueNameOnly);
+  ezLog::Info("-usage is '{}'", sUsage);
 
-    if (m_Descriptor.m_Usage == ezTexConvUsage::BumpMap)
-    {
-      EZ_SUCCEED_OR_RETURN(ConvertToNormalMap(m_Descriptor.m_InputImages));
-      m_Descriptor.m_Usage = ezTexConvUsage::NormalMap;
-    }
+  EZ_SUCCEED_OR_RETURN(ForceSRGBFormats());
 
-    ezImage assembledImg;
-    if (m_Descriptor.m_OutputType == ezTexConvOutputType::Texture2D || m_Descriptor.m_OutputType == ezTexConvOutputType::None)
-    {
-      EZ_SUCCEED_OR_RETURN(Assemble2DTexture(m_Descriptor.m_InputImages[0].GetHeader(), assembledImg));
+  out_Info.m_Usage = m_Descriptor.m_Usage;
+  out_Info.m_uiInputWidth = m_Descriptor.m_InputImages[0].GetWidth();
+  out_Info.m_uiInputHeight = m_Descriptor.m_InputImages[0].GetHeight();
 
-      EZ_SUCCEED_OR_RETURN(DilateColor2D(assembledImg));
-    }
-    else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Cubemap)
-    {
-      EZ_SUCCEED_OR_RETURN(AssembleCubemap(assembledImg));
-    }
-    else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Volume)
-    {
-      EZ_SUCCEED_OR_RETURN(Assemble3DTexture(assembledImg));
-    }
+  EZ_SUCCEED_OR_RETURN(DetectNumChannels(m_Descriptor.m_ChannelMappings, out_Info.m_uiNumChannelsUsed));
 
-    EZ_SUCCEED_OR_RETURN(AdjustHdrExposure(assembledImg));
+  ezUInt32 uiTargetResolutionX = 0;
+  ezUInt32 uiTargetResolutionY = 0;
 
-    EZ_SUCCEED_OR_RETURN(
-      GenerateMipmaps(assembledImg, 0, uiNumChannelsUsed == 1 ? MipmapChannelMode::SingleChannel : MipmapChannelMode::AllChannels));
+  EZ_SUCCEED_OR_RETURN(ChooseOutputFormatAndResolution(out_Info, out_OutputImageFormat, uiTargetResolutionX, uiTargetResolutionY));
 
-    EZ_SUCCEED_OR_RETURN(PremultiplyAlpha(assembledImg));
+  EZ_SUCCEED_OR_RETURN(ConvertAndScaleInputImages(uiTargetResolutionX, uiTargetResolutionY, m_Descriptor.m_Usage));
 
-    EZ_SUCCEED_OR_RETURN(GenerateOutput(std::move(assembledImg), m_OutputImage, OutputImageFormat));
+  EZ_SUCCEED_OR_RETURN(ClampInputValues(m_Descriptor.m_InputImages, m_Descriptor.m_fMaxValue));
 
-    EZ_SUCCEED_OR_RETURN(GenerateThumbnailOutput(m_OutputImage, m_ThumbnailOutputImage, m_Descriptor.m_uiThumbnailOutputResolution));
+  if (m_Descriptor.m_Usage == ezTexConvUsage::BumpMap)
+  {
+    EZ_SUCCEED_OR_RETURN(ConvertToNormalMap(m_Descriptor.m_InputImages));
+    m_Descriptor.m_Usage = ezTexConvUsage::NormalMap;
+  }
 
-    EZ_SUCCEED_OR_RETURN(GenerateLowResOutput(m_OutputImage, m_LowResOutputImage, m_Descriptor.m_uiLowResMipmaps));
+  if (m_Descriptor.m_OutputType == ezTexConvOutputType::Texture2D || m_Descriptor.m_OutputType == ezTexConvOutputType::None)
+  {
+    EZ_SUCCEED_OR_RETURN(Assemble2DTexture(m_Descriptor.m_InputImages[0].GetHeader(), out_MipChain));
+
+    EZ_SUCCEED_OR_RETURN(DilateColor2D(out_MipChain));
   }
+  else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Cubemap)
+  {
+    EZ_SUCCEED_OR_RETURN(AssembleCubemap(out_MipChain));
+  }
+  else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Volume)
+  {
+    EZ_SUCCEED_OR_RETURN(Assemble3DTexture(out_MipChain));
+  }
+
+  EZ_SUCCEED_OR_RETURN(AdjustHdrExposure(out_MipChain));
+
+  EZ_SUCCEED_OR_RETURN(
+    GenerateMipmaps(out_MipChain, 0, out_Info.m_uiNumChannelsUsed == 1 ? MipmapChannelMode::SingleChannel : MipmapChannelMode::AllChannels));
+
+  EZ_SUCCEED_OR_RETURN(PremultiplyAlpha(out_MipChain));
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezTexConvProcessor::ChooseOutputFormatAndResolution(
+  const MipChainInfo& info, ezEnum<ezImageFormat>& out_Format, ezUInt32& out_uiTargetResolutionX, ezUInt32& out_uiTargetResolutionY) const
+{
+  EZ_SUCCEED_OR_RETURN(ChooseOutputFormat(out_Format, info.m_Usage, info.m_uiNumChannelsUsed));
+
+  ezLog::Info("Output image format is '{}'", ezImageFormat::GetName(out_Format));
+
+  ezImageHeader inputHeader;
+  inputHeader.SetWidth(info.m_uiInputWidth);
+  inputHeader.SetHeight(info.m_uiInputHeight);
+
+  EZ_SUCCEED_OR_RETURN(DetermineTargetResolution(inputHeader, out_Format, out_uiTargetResolutionX, out_uiTargetResolutionY));
+
+  ezLog::Info("Target resolution is '{} x {}'", out_uiTargetResolutionX, out_uiTargetResolutionY);
 
   return EZ_SUCCESS;
 }
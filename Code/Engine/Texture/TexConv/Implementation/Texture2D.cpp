@@ -83,7 +83,7 @@ ezResult ezTexConvProcessor::Assemble2DSlice(
 }
 
 ezResult ezTexConvProcessor::DetermineTargetResolution(
-  const ezImage& image, ezEnum<ezImageFormat> OutputImageFormat, ezUInt32& out_uiTargetResolutionX, ezUInt32& out_uiTargetResolutionY) const
+  const ezImageHeader& image, ezEnum<ezImageFormat> OutputImageFormat, ezUInt32& out_uiTargetResolutionX, ezUInt32& out_uiTargetResolutionY) const
 {
   EZ_ASSERT_DEV(out_uiTargetResolutionX == 0 && out_uiTargetResolutionY == 0, "Target resolution already determined");
 
@@ -94,7 +94,7 @@ ezResult ezTexConvProcessor::LoadAtlasInputs(const ezTextureAtlasCreationDesc& a
         }
 
         ezUInt32 uiResX = 0, uiResY = 0;
-        EZ_SUCCEED_OR_RETURN(DetermineTargetResolution(item.m_InputImage[layer], ezImageFormat::UNKNOWN, uiResX, uiResY));
+        EZ_SUCCEED_OR_RETURN(DetermineTargetResolution(item.m_InputImage[layer].GetHeader(), ezImageFormat::UNKNOWN, uiResX, uiResY));
 
         EZ_SUCCEED_OR_RETURN(ConvertAndScaleImage(srcItem.m_sLayerInput[layer], item.m_InputImage[layer], uiResX, uiResY, atlasDesc.m_Layers[layer].m_Usage));
       }
@@ -112,7 +112,7 @@ ezResult ezTexConvProcessor::LoadAtlasInputs(const ezTextureAtlasCreationDesc& a
       }
 
       ezUInt32 uiResX = 0, uiResY = 0;
-      EZ_SUCCEED_OR_RETURN(DetermineTargetResolution(alphaImg, ezImageFormat::UNKNOWN, uiResX, uiResY));
+      EZ_SUCCEED_OR_RETURN(DetermineTargetResolution(alphaImg.GetHeader(), ezImageFormat::UNKNOWN, uiResX, uiResY));
 
       EZ_SUCCEED_OR_RETURN(ConvertAndScaleImage(srcItem.m_sAlphaInput, alphaImg, uiResX, uiResY, ezTexConvUsage::Linear));
 
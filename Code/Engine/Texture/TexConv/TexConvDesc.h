@@ -83,4 +83,12 @@ public:
 
   // Bump map filter
   ezEnum<ezTexConvBumpMapFilter> m_BumpMapFilter;
+
+  // Intermediate cache
+  // Directory in which decoded input files and finished mipmap chains are stored, keyed by the input file contents and all relevant settings.
+  // Repeated conversions and conversions that only change the output format reuse them. Empty disables the cache.
+  ezString m_sIntermediateCacheDirectory;
+
+  // When the cache directory grows larger than this, the oldest cache files are deleted. Zero disables the limit.
+  ezUInt32 m_uiIntermediateCacheSizeLimitMB = 1024;
 };
@@ -46,7 +46,7 @@ private:
 
   ezResult ChooseOutputFormat(ezEnum<ezImageFormat>& out_Format, ezEnum<ezTexConvUsage> usage, ezUInt32 uiNumChannels) const;
   ezResult DetermineTargetResolution(
-    const ezImage& image, ezEnum<ezImageFormat> OutputImageFormat, ezUInt32& out_uiTargetResolutionX, ezUInt32& out_uiTargetResolutionY) const;
+    const ezImageHeader& image, ezEnum<ezImageFormat> OutputImageFormat, ezUInt32& out_uiTargetResolutionX, ezUInt32& out_uiTargetResolutionY) const;
   ezResult Assemble2DTexture(const ezImageHeader& refImg, ezImage& dst) const;
   ezResult AssembleCubemap(ezImage& dst) const;
   ezResult Assemble3DTexture(ezImage& dst) const;
@@ -93,4 +93,32 @@ private:
   // Texture Atlas
 
   ezResult GenerateTextureAtlas(ezMemoryStreamWriter& stream);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Mipmap Chain
+
+  /// The results of the content analysis that are needed to pick the output format and resolution.
+  struct MipChainInfo
+  {
+    ezEnum<ezTexConvUsage> m_Usage;
+    ezUInt32 m_uiNumChannelsUsed = 0;
+    ezUInt32 m_uiInputWidth = 0;
+    ezUInt32 m_uiInputHeight = 0;
+  };
+
+  ezResult GenerateMipChain(ezImage& out_MipChain, MipChainInfo& out_Info, ezEnum<ezImageFormat>& out_OutputImageFormat);
+  ezResult ChooseOutputFormatAndResolution(const MipChainInfo& info, ezEnum<ezImageFormat>& out_Format, ezUInt32& out_uiTargetResolutionX, ezUInt32& out_uiTargetResolutionY) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Intermediate Cache
+
+  bool IsIntermediateCacheEnabled() const;
+  ezResult HashInputFiles();
+  ezUInt64 ComputeMipChainCacheKey() const;
+  ezResult LoadCachedInputImage(ezUInt32 uiInputIndex, ezImage& out_Image) const;
+  void StoreCachedInputImage(ezUInt32 uiInputIndex, const ezImage& image) const;
+  ezResult LoadCachedMipChain(ezUInt64 uiCacheKey, ezImage& out_MipChain, MipChainInfo& out_Info, ezEnum<ezImageFormat>& out_OutputImageFormat) const;
+  void StoreCachedMipChain(ezUInt64 uiCacheKey, const ezImage& mipChain, const MipChainInfo& info) const;
+
+  ezHybridArray<ezUInt64, 4> m_InputFileHashes;
 };
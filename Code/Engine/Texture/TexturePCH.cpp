@@ -44,6 +44,7 @@ EZ_STATICLINK_LIBRARY(Texture)
   EZ_STATICLINK_REFERENCE(Texture_Image_Implementation_ImageFormatMappings);
   EZ_STATICLINK_REFERENCE(Texture_Image_Implementation_ImageUtils);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_AutoUsage);
+  EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_Cache);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_InputFiles);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_OutputFormat);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_Processor);
@@ -94,13 +94,21 @@ static void PerFrameUpdateHandler(const ezGameApplicationExecutionEvent& e)
         for (ezUInt32 t = 0; t < ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks); ++t)
         {
           ezUInt32 uiNumTasks = 0;
-          const double Utilization = ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::ShortTasks, t, &uiNumTasks);
+          ezUInt32 uiNumSteals = 0;
+          ezUInt32 uiNumFailedSteals = 0;
+          const double Utilization = ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::ShortTasks, t, &uiNumTasks, &uiNumSteals, &uiNumFailedSteals);
 
           s.Format("Utilization/Short{0}_Load[%%]", ezArgI(t, 2, true));
           ezStats::SetStat(s.GetData(), Utilization * 100.0);
 
           s.Format("Utilization/Short{0}_Tasks", ezArgI(t, 2, true));
           ezStats::SetStat(s.GetData(), uiNumTasks);
+
+          s.Format("Utilization/Short{0}_Steals", ezArgI(t, 2, true));
+          ezStats::SetStat(s.GetData(), uiNumSteals);
+
+          s.Format("Utilization/Short{0}_FailedSteals", ezArgI(t, 2, true));
+          ezStats::SetStat(s.GetData(), uiNumFailedSteals);
         }
 
         for (ezUInt32 t = 0; t < ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks); ++t)
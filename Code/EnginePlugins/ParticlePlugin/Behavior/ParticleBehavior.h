@@ -37,5 +37,12 @@ protected:
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
   virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) { m_TimeDiff = tDiff; }
 
+  /// \brief For behaviors that only update every n-th particle per step, starting at uiFirstToUpdate.
+  /// Returns the first index at or after uiStartIndex that is due for an update.
+  static ezUInt64 GetFirstIndexToUpdate(ezUInt64 uiStartIndex, ezUInt32 uiFirstToUpdate, ezUInt32 uiUpdateInterval)
+  {
+    return uiStartIndex + (uiFirstToUpdate + uiUpdateInterval - uiStartIndex % uiUpdateInterval) % uiUpdateInterval;
+  }
+
   ezTime m_TimeDiff;
 };
@@ -151,107 +151,119 @@ void ezParticleBehavior_ColorGradient::InitializeElements(ezUInt64 uiStartIndex,
   }
 }
 
-void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_ColorGradient::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
+
   if (!GetOwnerEffect()->IsVisible())
   {
     // set the update interval such that once the effect becomes visible,
     // all particles get fully updated
     m_uiCurrentUpdateInterval = 1;
     m_uiFirstToUpdate = 0;
+    m_uiStepUpdateInterval = 0;
     return;
   }
 
   if (!m_hGradient.IsValid())
+  {
+    m_uiStepUpdateInterval = 0;
     return;
+  }
 
-  EZ_PROFILE_SCOPE("PFX: Color Gradient");
+  {
+    ezResourceLock<ezColorGradientResource> pGradient(m_hGradient, ezResourceAcquireMode::BlockTillLoaded);
+
+    if (pGradient.GetAcquireResult() == ezResourceAcquireResult::MissingFallback)
+    {
+      m_uiStepUpdateInterval = 0;
+      return;
+    }
+
+    m_StepGradient = pGradient->GetDescriptor().m_Gradient;
+  }
+
+  m_uiStepFirstToUpdate = m_uiFirstToUpdate;
+  m_uiStepUpdateInterval = m_uiCurrentUpdateInterval;
+
+  // adjust which index is the first to update
+  {
+    ++m_uiFirstToUpdate;
+    if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
+      m_uiFirstToUpdate = 0;
+  }
+
+  /// \todo Use level of detail to reduce the update interval further
+  /// up close, with a high interval, animations appear choppy, especially when fading stuff out at the end
+
+  // reset the update interval to the default
+  m_uiCurrentUpdateInterval = 2;
+}
+
+void ezParticleBehavior_ColorGradient::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  if (m_uiStepUpdateInterval == 0)
+    return;
 
-  ezResourceLock<ezColorGradientResource> pGradient(m_hGradient, ezResourceAcquireMode::BlockTillLoaded);
+  const ezUInt64 uiFirstIndex = GetFirstIndexToUpdate(uiStartIndex, m_uiStepFirstToUpdate, m_uiStepUpdateInterval);
+  const ezUInt64 uiEndIndex = uiStartIndex + uiNumElements;
 
-  if (pGradient.GetAcquireResult() == ezResourceAcquireResult::MissingFallback)
+  if (uiFirstIndex >= uiEndIndex)
     return;
 
-  const ezColorGradient& gradient = pGradient->GetDescriptor().m_Gradient;
+  EZ_PROFILE_SCOPE("PFX: Color Gradient");
+
+  const ezColorGradient& gradient = m_StepGradient;
 
-  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiNumElements, 0);
+  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiEndIndex - uiFirstIndex, uiFirstIndex);
 
-  // skip the first n particles
-  itColor.Advance(m_uiFirstToUpdate);
+  // only every n-th particle is updated,
+  // this is to reduce the number of particles that need to be fully evaluated,
+  // since sampling the color gradient is pretty expensive
+  const ezUInt32 uiUpdateInterval = m_uiStepUpdateInterval;
 
   if (m_GradientMode == ezParticleColorGradientMode::Age)
   {
-    ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
-
-    // skip the first n particles
-    itLifeTime.Advance(m_uiFirstToUpdate);
+    ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiEndIndex - uiFirstIndex, uiFirstIndex);
 
     while (!itLifeTime.HasReachedEnd())
     {
-      // if (itLifeTime.Current().y > 0)
-      {
-        const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-        const float posx = 1.0f - fLifeTimeFraction;
-
-        ezColor rgba;
-        ezUInt8 alpha;
-        gradient.EvaluateColor(posx, rgba);
-        gradient.EvaluateAlpha(posx, alpha);
-        rgba.a = ezMath::ColorByteToFloat(alpha);
-
-        itColor.Current() = rgba * m_TintColor;
-      }
-
-      // skip the next n items
-      // this is to reduce the number of particles that need to be fully evaluated,
-      // since sampling the color gradient is pretty expensive
-      itLifeTime.Advance(m_uiCurrentUpdateInterval);
-      itColor.Advance(m_uiCurrentUpdateInterval);
+      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
+      const float posx = 1.0f - fLifeTimeFraction;
+
+      ezColor rgba;
+      ezUInt8 alpha;
+      gradient.EvaluateColor(posx, rgba);
+      gradient.EvaluateAlpha(posx, alpha);
+      rgba.a = ezMath::ColorByteToFloat(alpha);
+
+      itColor.Current() = rgba * m_TintColor;
+
+      itLifeTime.Advance(uiUpdateInterval);
+      itColor.Advance(uiUpdateInterval);
     }
   }
   else if (m_GradientMode == ezParticleColorGradientMode::Speed)
   {
-    ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
-
-    // skip the first n particles
-    itVelocity.Advance(m_uiFirstToUpdate);
+    ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiEndIndex - uiFirstIndex, uiFirstIndex);
 
     while (!itVelocity.HasReachedEnd())
     {
-      // if (itLifeTime.Current().y > 0)
-      {
-        const float fSpeed = itVelocity.Current().GetLength();
-        const float posx = fSpeed / m_fMaxSpeed; // no need to clamp the range, the color lookup will already do that
-
-        ezColor rgba;
-        ezUInt8 alpha;
-        gradient.EvaluateColor(posx, rgba);
-        gradient.EvaluateAlpha(posx, alpha);
-        rgba.a = ezMath::ColorByteToFloat(alpha);
-
-        itColor.Current() = rgba * m_TintColor;
-      }
-
-      // skip the next n items
-      // this is to reduce the number of particles that need to be fully evaluated,
-      // since sampling the color gradient is pretty expensive
-      itVelocity.Advance(m_uiCurrentUpdateInterval);
-      itColor.Advance(m_uiCurrentUpdateInterval);
-    }
-  }
+      const float fSpeed = itVelocity.Current().GetLength();
+      const float posx = fSpeed / m_fMaxSpeed; // no need to clamp the range, the color lookup will already do that
 
-  // adjust which index is the first to update
-  {
-    ++m_uiFirstToUpdate;
-    if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
-      m_uiFirstToUpdate = 0;
-  }
+      ezColor rgba;
+      ezUInt8 alpha;
+      gradient.EvaluateColor(posx, rgba);
+      gradient.EvaluateAlpha(posx, alpha);
+      rgba.a = ezMath::ColorByteToFloat(alpha);
 
-  /// \todo Use level of detail to reduce the update interval further
-  /// up close, with a high interval, animations appear choppy, especially when fading stuff out at the end
+      itColor.Current() = rgba * m_TintColor;
 
-  // reset the update interval to the default
-  m_uiCurrentUpdateInterval = 2;
+      itVelocity.Advance(uiUpdateInterval);
+      itColor.Advance(uiUpdateInterval);
+    }
+  }
 }
 
 
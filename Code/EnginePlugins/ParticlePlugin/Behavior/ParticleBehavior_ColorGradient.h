@@ -47,7 +47,9 @@ protected:
   friend class ezParticleBehaviorFactory_ColorGradient;
 
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
+  virtual bool SupportsParallelProcessing() const override { return true; }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   ezProcessingStream* m_pStreamLifeTime = nullptr;
   ezProcessingStream* m_pStreamColor = nullptr;
@@ -55,4 +57,11 @@ protected:
   ezColor m_InitColor;
   ezUInt8 m_uiFirstToUpdate = 0;
   ezUInt8 m_uiCurrentUpdateInterval = 8;
+
+  // which particles get updated in the current step, 0 as the interval means none
+  ezUInt8 m_uiStepFirstToUpdate = 0;
+  ezUInt8 m_uiStepUpdateInterval = 0;
+
+  // copy of the gradient for the current step, so that ProcessRange() doesn't need to acquire the resource for every chunk
+  ezColorGradient m_StepGradient;
 };
@@ -59,70 +59,79 @@ void ezParticleBehavior_FadeOut::CreateRequiredStreams()
   CreateStream("Color", ezProcessingStream::DataType::Half4, &m_pStreamColor, false);
 }
 
-void ezParticleBehavior_FadeOut::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_FadeOut::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
+
   if (!GetOwnerEffect()->IsVisible())
   {
     // set the update interval such that once the effect becomes visible,
     // all particles get fully updated
     m_uiCurrentUpdateInterval = 1;
     m_uiFirstToUpdate = 0;
+    m_uiStepUpdateInterval = 0;
     return;
   }
 
-  EZ_PROFILE_SCOPE("PFX: Fade Out");
-
-  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
-  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiNumElements, 0);
+  m_uiStepFirstToUpdate = m_uiFirstToUpdate;
+  m_uiStepUpdateInterval = m_uiCurrentUpdateInterval;
 
-  // skip the first n particles
+  // adjust which index is the first to update
   {
-    for (ezUInt32 i = 0; i < m_uiFirstToUpdate; ++i)
-    {
-      itLifeTime.Advance();
-      itColor.Advance();
-    }
-
     ++m_uiFirstToUpdate;
     if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
       m_uiFirstToUpdate = 0;
   }
 
-  if (m_fStartAlpha <= 1.0f)
+  /// \todo Use level of detail to reduce the update interval further
+  /// up close, with a high interval, animations appear choppy, especially when fading stuff out at the end
+
+  // reset the update interval to the default
+  m_uiCurrentUpdateInterval = 2;
+}
+
+void ezParticleBehavior_FadeOut::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  if (m_uiStepUpdateInterval == 0)
+    return;
+
+  const ezUInt64 uiFirstIndex = GetFirstIndexToUpdate(uiStartIndex, m_uiStepFirstToUpdate, m_uiStepUpdateInterval);
+  const ezUInt64 uiEndIndex = uiStartIndex + uiNumElements;
+
+  if (uiFirstIndex >= uiEndIndex)
+    return;
+
+  EZ_PROFILE_SCOPE("PFX: Fade Out");
+
+  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiEndIndex - uiFirstIndex, uiFirstIndex);
+  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiEndIndex - uiFirstIndex, uiFirstIndex);
+
+  // alpha only has to be clamped to 1, if the start value is above that
+  const float fMaxAlpha = ezMath::Min(m_fStartAlpha, 1.0f);
+
+  if (m_fExponent == 1.0f)
   {
+    // the default linear fade out doesn't need the expensive pow
     while (!itLifeTime.HasReachedEnd())
     {
       const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-      itColor.Current().a = m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent);
+      itColor.Current().a = ezMath::Min(fMaxAlpha, m_fStartAlpha * fLifeTimeFraction);
 
-      for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-      {
-        itLifeTime.Advance();
-        itColor.Advance();
-      }
+      itLifeTime.Advance(m_uiStepUpdateInterval);
+      itColor.Advance(m_uiStepUpdateInterval);
     }
   }
   else
   {
-    // this case has to clamp alpha to 1
     while (!itLifeTime.HasReachedEnd())
     {
       const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-      itColor.Current().a = ezMath::Min(1.0f, m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent));
+      itColor.Current().a = ezMath::Min(fMaxAlpha, m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent));
 
-      for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-      {
-        itLifeTime.Advance();
-        itColor.Advance();
-      }
+      itLifeTime.Advance(m_uiStepUpdateInterval);
+      itColor.Advance(m_uiStepUpdateInterval);
     }
   }
-
-  /// \todo Use level of detail to reduce the update interval further
-  /// up close, with a high interval, animations appear choppy, especially when fading stuff out at the end
-
-  // reset the update interval to the default
-  m_uiCurrentUpdateInterval = 2;
 }
 
 
@@ -73,22 +73,47 @@ void ezParticleBehavior_Gravity::CreateRequiredStreams()
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Gravity::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
-  EZ_PROFILE_SCOPE("PFX: Gravity");
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
 
   const ezVec3 vGravity = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity() : ezVec3(0.0f, 0.0f, -10.0f);
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
-  const ezVec3 addGravity = vGravity * m_fGravityFactor * tDiff;
+  m_vAddGravity = vGravity * m_fGravityFactor * (float)tDiff.GetSeconds();
+}
+
+void ezParticleBehavior_Gravity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_PROFILE_SCOPE("PFX: Gravity");
 
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  EZ_ASSERT_DEBUG(m_pStreamVelocity->GetElementStride() == sizeof(ezVec3), "Velocity stream is expected to be tightly packed");
 
-  while (!itVelocity.HasReachedEnd())
+  // the velocities are tightly packed, so four of them fill exactly three SIMD registers
+  // and the gravity vector repeats within those registers with a different rotation each
+  const ezVec3 g = m_vAddGravity;
+  const ezSimdVec4f vAdd0(g.x, g.y, g.z, g.x);
+  const ezSimdVec4f vAdd1(g.y, g.z, g.x, g.y);
+  const ezSimdVec4f vAdd2(g.z, g.x, g.y, g.z);
+
+  float* pVelocity = m_pStreamVelocity->GetWritableData<float>() + uiStartIndex * 3;
+
+  const ezUInt64 uiNumBlocks = uiNumElements / 4;
+  for (ezUInt64 i = 0; i < uiNumBlocks; ++i, pVelocity += 12)
   {
-    itVelocity.Current() += addGravity;
+    ezSimdVec4f v0, v1, v2;
+    v0.Load<4>(pVelocity + 0);
+    v1.Load<4>(pVelocity + 4);
+    v2.Load<4>(pVelocity + 8);
+
+    (v0 + vAdd0).Store<4>(pVelocity + 0);
+    (v1 + vAdd1).Store<4>(pVelocity + 4);
+    (v2 + vAdd2).Store<4>(pVelocity + 8);
+  }
 
-    itVelocity.Advance();
+  ezVec3* pRemainingVelocity = reinterpret_cast<ezVec3*>(pVelocity);
+  for (ezUInt64 i = uiNumBlocks * 4; i < uiNumElements; ++i, ++pRemainingVelocity)
+  {
+    *pRemainingVelocity += g;
   }
 }
 
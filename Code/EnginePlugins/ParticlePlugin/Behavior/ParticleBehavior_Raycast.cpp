@@ -131,69 +131,106 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Raycast");
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  if (m_pPhysicsModule == nullptr)
+    return;
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<const ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  const float tDiff = (float)m_TimeDiff.GetSeconds();
 
-  ezPhysicsCastResult hitResult;
+  m_RayElements.Clear();
+  m_RayStarts.Clear();
+  m_RayDirs.Clear();
+  m_RayDistances.Clear();
 
-  ezUInt32 i = 0;
-  while (!itPosition.HasReachedEnd())
+  // collect the movement of all particles first, so that all rays can be cast with a single batch query
   {
-    const ezVec3 vLastPos = itLastPosition.Current();
-    const ezVec3 vCurPos = itPosition.Current().GetAsVec3();
+    ezProcessingStreamIterator<const ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
+    ezProcessingStreamIterator<const ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
 
-    if (!vLastPos.IsZero())
+    ezUInt32 i = 0;
+    while (!itPosition.HasReachedEnd())
     {
-      const ezVec3 vChange = vCurPos - vLastPos;
+      const ezVec3 vLastPos = itLastPosition.Current();
+      const ezVec3 vCurPos = itPosition.Current().GetAsVec3();
 
-      if (!vChange.IsZero(0.001f))
+      if (!vLastPos.IsZero())
       {
-        ezVec3 vDirection = vChange;
+        ezVec3 vDirection = vCurPos - vLastPos;
 
-        const float fMaxLen = vDirection.GetLengthAndNormalize();
-
-        if (m_pPhysicsModule != nullptr && m_pPhysicsModule->Raycast(hitResult, vLastPos, vDirection, fMaxLen, ezPhysicsQueryParameters(m_uiCollisionLayer)))
+        if (!vDirection.IsZero(0.001f))
         {
-          if (m_Reaction == ezParticleRaycastHitReaction::Bounce)
-          {
-            const ezVec3 vNewDir = vChange.GetReflectedVector(hitResult.m_vNormal) * m_fBounceFactor;
-
-            itPosition.Current() = ezVec3(hitResult.m_vPosition + hitResult.m_vNormal * 0.05f + vNewDir).GetAsVec4(0);
-            itVelocity.Current() = vNewDir / tDiff;
-          }
-          else if (m_Reaction == ezParticleRaycastHitReaction::Die)
-          {
-            /// \todo Get current element index from iterator ?
-            m_pStreamGroup->RemoveElement(i);
-          }
-          else if (m_Reaction == ezParticleRaycastHitReaction::Stop)
-          {
-            itVelocity.Current().SetZero();
-          }
-
-          if (!m_sOnCollideEvent.IsEmpty())
-          {
-            ezParticleEvent e;
-            e.m_EventType = m_sOnCollideEvent;
-            e.m_vPosition = hitResult.m_vPosition;
-            e.m_vNormal = hitResult.m_vNormal;
-            e.m_vDirection = vDirection;
-
-            GetOwnerEffect()->AddParticleEvent(e);
-          }
+          const float fMaxLen = vDirection.GetLengthAndNormalize();
+
+          m_RayElements.PushBack(i);
+          m_RayStarts.PushBack(vLastPos);
+          m_RayDirs.PushBack(vDirection);
+          m_RayDistances.PushBack(fMaxLen);
         }
       }
+
+      itPosition.Advance();
+      itLastPosition.Advance();
+
+      ++i;
     }
+  }
+
+  const ezUInt32 uiNumRays = m_RayElements.GetCount();
+  if (uiNumRays == 0)
+    return;
+
+  m_HitResults.SetCount(uiNumRays);
+  m_Hits.SetCount(uiNumRays);
+
+  ezPhysicsCastBatch rays;
+  rays.m_Starts = m_RayStarts;
+  rays.m_Dirs = m_RayDirs;
+  rays.m_Distances = m_RayDistances;
+
+  if (m_pPhysicsModule->RaycastBatch(m_HitResults, m_Hits, rays, ezPhysicsQueryParameters(m_uiCollisionLayer)) > 0)
+  {
+    ezVec4* pPosition = m_pStreamPosition->GetWritableData<ezVec4>();
+    ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>();
+
+    for (ezUInt32 uiRay = 0; uiRay < uiNumRays; ++uiRay)
+    {
+      if (!m_Hits[uiRay])
+        continue;
 
-    itPosition.Advance();
-    itLastPosition.Advance();
-    itVelocity.Advance();
+      const ezPhysicsCastResult& hitResult = m_HitResults[uiRay];
+      const ezUInt32 i = m_RayElements[uiRay];
 
-    ++i;
+      if (m_Reaction == ezParticleRaycastHitReaction::Bounce)
+      {
+        const ezVec3 vChange = pPosition[i].GetAsVec3() - m_RayStarts[uiRay];
+        const ezVec3 vNewDir = vChange.GetReflectedVector(hitResult.m_vNormal) * m_fBounceFactor;
+
+        pPosition[i] = ezVec3(hitResult.m_vPosition + hitResult.m_vNormal * 0.05f + vNewDir).GetAsVec4(0);
+        pVelocity[i] = vNewDir / tDiff;
+      }
+      else if (m_Reaction == ezParticleRaycastHitReaction::Die)
+      {
+        m_pStreamGroup->RemoveElement(i);
+      }
+      else if (m_Reaction == ezParticleRaycastHitReaction::Stop)
+      {
+        pVelocity[i].SetZero();
+      }
+
+      if (!m_sOnCollideEvent.IsEmpty())
+      {
+        ezParticleEvent e;
+        e.m_EventType = m_sOnCollideEvent;
+        e.m_vPosition = hitResult.m_vPosition;
+        e.m_vNormal = hitResult.m_vNormal;
+        e.m_vDirection = m_RayDirs[uiRay];
+
+        GetOwnerEffect()->AddParticleEvent(e);
+      }
+    }
   }
+
+  // don't keep the hit surfaces alive
+  m_HitResults.Clear();
 }
 
 void ezParticleBehavior_Raycast::RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule)
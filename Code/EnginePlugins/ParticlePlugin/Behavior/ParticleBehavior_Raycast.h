@@ -1,10 +1,9 @@
 #pragma once
 
+#include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Foundation/Strings/String.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior.h>
 
-class ezPhysicsWorldModuleInterface;
-
 struct EZ_PARTICLEPLUGIN_DLL ezParticleRaycastHitReaction
 {
   typedef ezUInt8 StorageType;
@@ -70,4 +69,12 @@ protected:
   ezProcessingStream* m_pStreamPosition = nullptr;
   ezProcessingStream* m_pStreamLastPosition = nullptr;
   ezProcessingStream* m_pStreamVelocity = nullptr;
+
+  // rays of the moving particles, kept around to reuse the memory
+  ezDynamicArray<ezUInt32> m_RayElements;
+  ezDynamicArray<ezVec3> m_RayStarts;
+  ezDynamicArray<ezVec3> m_RayDirs;
+  ezDynamicArray<float> m_RayDistances;
+  ezDynamicArray<ezPhysicsCastResult> m_HitResults;
+  ezDynamicArray<bool> m_Hits;
 };
@@ -95,8 +95,10 @@ void ezParticleBehavior_SizeCurve::InitializeElements(ezUInt64 uiStartIndex, ezU
   }
 }
 
-void ezParticleBehavior_SizeCurve::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_SizeCurve::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
+
   if (!GetOwnerEffect()->IsVisible())
   {
     // reduce the update interval when the effect is not visible
@@ -108,60 +110,67 @@ void ezParticleBehavior_SizeCurve::Process(ezUInt64 uiNumElements)
   }
 
   if (!m_hCurve.IsValid())
+  {
+    m_uiStepUpdateInterval = 0;
     return;
+  }
 
-  EZ_PROFILE_SCOPE("PFX: Size Curve");
+  {
+    ezResourceLock<ezCurve1DResource> pCurve(m_hCurve, ezResourceAcquireMode::BlockTillLoaded);
 
-  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
-  ezProcessingStreamIterator<ezFloat16> itSize(m_pStreamSize, uiNumElements, 0);
+    if (pCurve.GetAcquireResult() == ezResourceAcquireResult::MissingFallback || pCurve->GetDescriptor().m_Curves.IsEmpty())
+    {
+      m_uiStepUpdateInterval = 0;
+      return;
+    }
+
+    m_StepCurve = pCurve->GetDescriptor().m_Curves[0];
+  }
 
-  ezResourceLock<ezCurve1DResource> pCurve(m_hCurve, ezResourceAcquireMode::BlockTillLoaded);
+  // the interval may have just been reduced
+  m_uiStepFirstToUpdate = m_uiFirstToUpdate % m_uiCurrentUpdateInterval;
+  m_uiStepUpdateInterval = m_uiCurrentUpdateInterval;
+
+  ++m_uiFirstToUpdate;
+  if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
+    m_uiFirstToUpdate = 0;
+}
 
-  if (pCurve.GetAcquireResult() == ezResourceAcquireResult::MissingFallback)
+void ezParticleBehavior_SizeCurve::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  if (m_uiStepUpdateInterval == 0)
     return;
 
-  if (pCurve->GetDescriptor().m_Curves.IsEmpty())
+  const ezUInt64 uiFirstIndex = GetFirstIndexToUpdate(uiStartIndex, m_uiStepFirstToUpdate, m_uiStepUpdateInterval);
+  const ezUInt64 uiEndIndex = uiStartIndex + uiNumElements;
+
+  if (uiFirstIndex >= uiEndIndex)
     return;
 
-  auto& curve = pCurve->GetDescriptor().m_Curves[0];
+  EZ_PROFILE_SCOPE("PFX: Size Curve");
 
-  double fMinX, fMaxX;
-  curve.QueryExtents(fMinX, fMaxX);
+  const ezCurve1D& curve = m_StepCurve;
 
-  // skip the first n particles
-  {
-    for (ezUInt32 i = 0; i < m_uiFirstToUpdate; ++i)
-    {
-      itLifeTime.Advance();
-      itSize.Advance();
-    }
+  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiEndIndex - uiFirstIndex, uiFirstIndex);
+  ezProcessingStreamIterator<ezFloat16> itSize(m_pStreamSize, uiEndIndex - uiFirstIndex, uiFirstIndex);
 
-    ++m_uiFirstToUpdate;
-    if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
-      m_uiFirstToUpdate = 0;
-  }
+  // only every n-th particle is updated,
+  // this is to reduce the number of particles that need to be fully evaluated,
+  // since sampling the curve is expensive
+  const ezUInt32 uiUpdateInterval = m_uiStepUpdateInterval;
 
   while (!itLifeTime.HasReachedEnd())
   {
-    // if (itLifeTime.Current().y > 0)
-    {
-      const float fLifeTimeFraction = 1.0f - (itLifeTime.Current().x * itLifeTime.Current().y);
+    const float fLifeTimeFraction = 1.0f - (itLifeTime.Current().x * itLifeTime.Current().y);
 
-      const double evalPos = curve.ConvertNormalizedPos(fLifeTimeFraction);
-      double val = curve.Evaluate(evalPos);
-      val = curve.NormalizeValue(val);
+    const double evalPos = curve.ConvertNormalizedPos(fLifeTimeFraction);
+    double val = curve.Evaluate(evalPos);
+    val = curve.NormalizeValue(val);
 
-      itSize.Current() = m_fBaseSize + (float)val * m_fCurveScale;
-    }
+    itSize.Current() = m_fBaseSize + (float)val * m_fCurveScale;
 
-    // skip the next n items
-    // this is to reduce the number of particles that need to be fully evaluated,
-    // since sampling the curve is expensive
-    for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-    {
-      itLifeTime.Advance();
-      itSize.Advance();
-    }
+    itLifeTime.Advance(uiUpdateInterval);
+    itSize.Advance(uiUpdateInterval);
   }
 }
 
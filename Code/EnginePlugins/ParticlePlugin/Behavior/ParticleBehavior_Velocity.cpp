@@ -105,43 +105,70 @@ void ezParticleBehavior_Velocity::CreateRequiredStreams()
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+void ezParticleBehavior_Velocity::StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles)
 {
-  EZ_PROFILE_SCOPE("PFX: Velocity");
+  ezParticleBehavior::StepParticleSystem(tDiff, uiNumNewParticles);
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  const float fTimeDiff = (float)tDiff.GetSeconds();
   const ezVec3 vDown = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity().GetNormalized() : ezVec3(0.0f, 0.0f, -1.0f);
-  const ezVec3 vRise = vDown * tDiff * -m_fRiseSpeed;
+  const ezVec3 vRise = vDown * fTimeDiff * -m_fRiseSpeed;
 
   ezVec3 vWind(0);
   if (m_pWindModule != nullptr)
   {
     ezVec3 vCurWind = m_pWindModule->GetWindAt(GetOwnerSystem()->GetTransform().m_vPosition);
-    vCurWind = ezMath::Lerp(m_vLastWind, vCurWind, tDiff);
+    vCurWind = ezMath::Lerp(m_vLastWind, vCurWind, fTimeDiff);
 
-    vWind = vCurWind * m_fWindInfluence * tDiff;
+    vWind = vCurWind * m_fWindInfluence * fTimeDiff;
 
     m_vLastWind = vCurWind;
   }
 
-  const ezVec3 vAddPos0 = vRise + vWind;
-
-  ezSimdVec4f vAddPos;
-  vAddPos.Load<3>(&vAddPos0.x);
+  m_vAddPosition = vRise + vWind;
 
   const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
-  const float fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+  m_fFrictionFactor = ezMath::Pow(0.5f, fTimeDiff * fFriction);
+}
+
+void ezParticleBehavior_Velocity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_PROFILE_SCOPE("PFX: Velocity");
+
+  ezSimdVec4f vAddPos;
+  vAddPos.Load<3>(&m_vAddPosition.x);
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, uiStartIndex);
 
   while (!itPosition.HasReachedEnd())
   {
     itPosition.Current() += vAddPos;
-    itVelocity.Current() *= fFrictionFactor;
 
     itPosition.Advance();
-    itVelocity.Advance();
+  }
+
+  // without friction the velocities stay the same
+  if (m_fFrictionFactor == 1.0f)
+    return;
+
+  EZ_ASSERT_DEBUG(m_pStreamVelocity->GetElementStride() == sizeof(ezVec3), "Velocity stream is expected to be tightly packed");
+
+  // all velocity components are scaled the same way, so the tightly packed stream can be treated as a plain float array
+  const ezSimdFloat fFrictionFactor = m_fFrictionFactor;
+  float* pVelocity = m_pStreamVelocity->GetWritableData<float>() + uiStartIndex * 3;
+  const ezUInt64 uiNumFloats = uiNumElements * 3;
+
+  ezUInt64 i = 0;
+  for (; i + 4 <= uiNumFloats; i += 4)
+  {
+    ezSimdVec4f v;
+    v.Load<4>(pVelocity + i);
+    v *= fFrictionFactor;
+    v.Store<4>(pVelocity + i);
+  }
+
+  for (; i < uiNumFloats; ++i)
+  {
+    pVelocity[i] *= m_fFrictionFactor;
   }
 }
 
@@ -41,7 +41,9 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Velocity;
 
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual void StepParticleSystem(const ezTime& tDiff, ezUInt32 uiNumNewParticles) override;
+  virtual bool SupportsParallelProcessing() const override { return true; }
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
@@ -53,4 +55,7 @@ protected:
   ezProcessingStream* m_pStreamVelocity;
 
   ezVec3 m_vLastWind = ezVec3::ZeroVector();
+
+  ezVec3 m_vAddPosition = ezVec3::ZeroVector();
+  float m_fFrictionFactor = 1.0f;
 };
@@ -1,6 +1,7 @@
 #include <ParticlePlugin/ParticlePluginPCH.h>
 
 #include <Core/Assets/AssetFileHeader.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <ParticlePlugin/Resources/ParticleEffectResource.h>
 
 // clang-format off
@@ -63,7 +64,16 @@ void ezParticleEffectResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage
 
 EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezParticleEffectResource, ezParticleEffectResourceDescriptor)
 {
-  m_Desc = descriptor;
+  // the descriptor owns its particle systems, a plain copy would share them with the caller
+  // serializing also sets up the default processors, which effects created in code would otherwise lack
+  {
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    descriptor.Save(writer);
+
+    ezMemoryStreamReader reader(&storage);
+    m_Desc.Load(reader);
+  }
 
   ezResourceLoadDesc res;
   res.m_State = ezResourceState::Loaded;
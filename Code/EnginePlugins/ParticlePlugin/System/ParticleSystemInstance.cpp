@@ -351,6 +351,10 @@ void ezParticleSystemInstance::Construct(ezUInt32 uiMaxParticles, ezWorld* pWorl
 
   m_StreamInfo.Clear();
   m_StreamGroup.SetSize(uiMaxParticles);
+
+  // only large systems are split up, for small ones the task overhead would outweigh the gain
+  // instances are recycled, so this has to be reset here and not in the constructor
+  m_StreamGroup.SetParallelProcessingChunkSize(4096);
 }
 
 void ezParticleSystemInstance::Destruct()
@@ -46,6 +46,9 @@ public:
   ezUInt64 GetMaxParticles() const { return m_StreamGroup.GetNumElements(); }
   ezUInt64 GetNumActiveParticles() const { return m_StreamGroup.GetNumActiveElements(); }
 
+  /// \brief Sets how many particles are simulated per task. Zero simulates all particles on the calling thread. See ezProcessingStreamGroup::SetParallelProcessingChunkSize().
+  void SetParallelProcessingChunkSize(ezUInt32 uiChunkSize) { m_StreamGroup.SetParallelProcessingChunkSize(uiChunkSize); }
+
 
 
   /// \brief Returns the desired stream, if it already exists, nullptr otherwise.
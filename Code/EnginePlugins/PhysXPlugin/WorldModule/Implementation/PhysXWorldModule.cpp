@@ -216,6 +216,33 @@ namespace
       out_Result.m_hSurface = ezSurfaceResourceHandle(pSurface);
     }
   }
+
+  PxQueryFilterData CreateQueryFilterData(const ezPhysicsQueryParameters& params, PxQueryFlags flags)
+  {
+    PxQueryFilterData filterData;
+    filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
+    filterData.flags = flags | PxQueryFlag::ePREFILTER;
+
+    if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
+    {
+      filterData.flags |= PxQueryFlag::eSTATIC;
+    }
+
+    if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
+    {
+      filterData.flags |= PxQueryFlag::eDYNAMIC;
+    }
+
+    return filterData;
+  }
+
+  ezParallelForParams GetQueryBatchParallelForParams()
+  {
+    // a single query is cheap, only split the batch if every task has enough work to do
+    ezParallelForParams params;
+    params.uiBinSize = 64;
+    return params;
+  }
 } // namespace
 
 EZ_DEFINE_AS_POD_TYPE(PxOverlapHit);
@@ -403,31 +430,21 @@ bool ezPhysXWorldModule::Raycast(ezPhysicsCastResult& out_Result, const ezVec3&
   if (fDistance <= 0.001f || vDir.IsZero())
     return false;
 
-  PxQueryFilterData filterData;
-  filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
-  filterData.flags = PxQueryFlag::ePREFILTER;
+  PxQueryFlags flags;
 
   if (params.m_bIgnoreInitialOverlap)
   {
     // the postFilter will discard hits from initial overlaps (ie. when the raycast starts inside a shape)
-    filterData.flags |= PxQueryFlag::ePOSTFILTER;
-  }
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
-  {
-    filterData.flags |= PxQueryFlag::eSTATIC;
-  }
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
-  {
-    filterData.flags |= PxQueryFlag::eDYNAMIC;
+    flags |= PxQueryFlag::ePOSTFILTER;
   }
 
   if (collection == ezPhysicsHitCollection::Any)
   {
-    filterData.flags |= PxQueryFlag::eANY_HIT;
+    flags |= PxQueryFlag::eANY_HIT;
   }
 
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, flags);
+
   ezPxRaycastCallback closestHit;
   ezPxQueryFilter queryFilter;
   queryFilter.m_bIncludeQueryShapes = params.m_bIncludeQueryShapes;
@@ -449,21 +466,8 @@ bool ezPhysXWorldModule::RaycastAll(ezPhysicsCastResultArray& out_Results, const
   if (fDistance <= 0.001f || vDir.IsZero())
     return false;
 
-  PxQueryFilterData filterData;
-  filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
-
   // PxQueryFlag::eNO_BLOCK : All hits are reported as touching. Overrides eBLOCK returned from user filters with eTOUCH.
-  filterData.flags = PxQueryFlag::ePREFILTER | PxQueryFlag::eNO_BLOCK;
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
-  {
-    filterData.flags |= PxQueryFlag::eSTATIC;
-  }
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
-  {
-    filterData.flags |= PxQueryFlag::eDYNAMIC;
-  }
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, PxQueryFlag::eNO_BLOCK);
 
   ezArrayPtr<PxRaycastHit> raycastHits = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), PxRaycastHit, 256);
   PxRaycastBuffer allHits(raycastHits.GetPtr(), raycastHits.GetCount());
@@ -525,25 +529,7 @@ bool ezPhysXWorldModule::SweepTestCapsule(ezPhysicsCastResult& out_Result, float
 
 bool ezPhysXWorldModule::SweepTest(ezPhysicsCastResult& out_Result, const physx::PxGeometry& geometry, const physx::PxTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
 {
-  PxQueryFilterData filterData;
-  filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
-
-  filterData.flags = PxQueryFlag::ePREFILTER;
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
-  {
-    filterData.flags |= PxQueryFlag::eSTATIC;
-  }
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
-  {
-    filterData.flags |= PxQueryFlag::eDYNAMIC;
-  }
-
-  if (collection == ezPhysicsHitCollection::Any)
-  {
-    filterData.flags |= PxQueryFlag::eANY_HIT;
-  }
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, collection == ezPhysicsHitCollection::Any ? PxQueryFlags(PxQueryFlag::eANY_HIT) : PxQueryFlags());
 
   ezPxSweepCallback closestHit;
   ezPxQueryFilter queryFilter;
@@ -590,20 +576,7 @@ bool ezPhysXWorldModule::OverlapTestCapsule(float fCapsuleRadius, float fCapsule
 
 bool ezPhysXWorldModule::OverlapTest(const physx::PxGeometry& geometry, const physx::PxTransform& transform, const ezPhysicsQueryParameters& params) const
 {
-  PxQueryFilterData filterData;
-  filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
-
-  filterData.flags = PxQueryFlag::ePREFILTER | PxQueryFlag::eANY_HIT;
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
-  {
-    filterData.flags |= PxQueryFlag::eSTATIC;
-  }
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
-  {
-    filterData.flags |= PxQueryFlag::eDYNAMIC;
-  }
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, PxQueryFlag::eANY_HIT);
 
   ezPxOverlapCallback closestHit;
   ezPxQueryFilter queryFilter;
@@ -620,21 +593,8 @@ void ezPhysXWorldModule::QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Re
 
   out_Results.m_Results.Clear();
 
-  PxQueryFilterData filterData;
-  filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
-
   // PxQueryFlag::eNO_BLOCK : All hits are reported as touching. Overrides eBLOCK returned from user filters with eTOUCH.
-  filterData.flags = PxQueryFlag::ePREFILTER | PxQueryFlag::eNO_BLOCK;
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
-  {
-    filterData.flags |= PxQueryFlag::eSTATIC;
-  }
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
-  {
-    filterData.flags |= PxQueryFlag::eDYNAMIC;
-  }
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, PxQueryFlag::eNO_BLOCK);
 
   ezPxQueryFilter queryFilter;
   queryFilter.m_bIncludeQueryShapes = params.m_bIncludeQueryShapes;
@@ -671,6 +631,161 @@ void ezPhysXWorldModule::QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Re
   }
 }
 
+ezUInt32 ezPhysXWorldModule::RaycastBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsCastBatch& rays, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  EZ_PROFILE_SCOPE("RaycastBatch");
+
+  const ezUInt32 uiNumRays = rays.GetCount();
+  EZ_ASSERT_DEV(rays.m_Dirs.GetCount() == uiNumRays && rays.m_Distances.GetCount() == uiNumRays, "Invalid ray batch");
+  EZ_ASSERT_DEV(out_Results.GetCount() >= uiNumRays && out_Hits.GetCount() >= uiNumRays, "Output arrays are too small");
+
+  PxQueryFlags flags;
+
+  if (params.m_bIgnoreInitialOverlap)
+  {
+    // the postFilter will discard hits from initial overlaps (ie. when the raycast starts inside a shape)
+    flags |= PxQueryFlag::ePOSTFILTER;
+  }
+
+  if (collection == ezPhysicsHitCollection::Any)
+  {
+    flags |= PxQueryFlag::eANY_HIT;
+  }
+
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, flags);
+
+  ezAtomicInteger32 iNumHits;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumRays,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      ezPxRaycastCallback closestHit;
+      ezPxQueryFilter queryFilter;
+      queryFilter.m_bIncludeQueryShapes = params.m_bIncludeQueryShapes;
+
+      ezInt32 iNumTaskHits = 0;
+
+      // scene queries only need a read lock, so all tasks can query the scene at the same time
+      EZ_PX_READ_LOCK(*m_pPxScene);
+
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        const ezVec3& vDir = rays.m_Dirs[i];
+        const float fDistance = rays.m_Distances[i];
+
+        out_Hits[i] = false;
+
+        if (fDistance <= 0.001f || vDir.IsZero())
+          continue;
+
+        if (m_pPxScene->raycast(ezPxConversionUtils::ToVec3(rays.m_Starts[i]), ezPxConversionUtils::ToVec3(vDir), fDistance, closestHit, PxHitFlag::eDEFAULT, filterData, &queryFilter))
+        {
+          // the result arrays are typically reused, don't keep any data of previous hits
+          out_Results[i] = ezPhysicsCastResult();
+          FillHitResult(closestHit.block, out_Results[i]);
+
+          out_Hits[i] = true;
+          ++iNumTaskHits;
+        }
+      }
+
+      iNumHits.Add(iNumTaskHits);
+    },
+    "PhysX RaycastBatch", GetQueryBatchParallelForParams());
+
+  return static_cast<ezUInt32>(iNumHits);
+}
+
+ezUInt32 ezPhysXWorldModule::SweepBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsCastBatch& spheres, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
+{
+  EZ_PROFILE_SCOPE("SweepBatch");
+
+  const ezUInt32 uiNumSpheres = spheres.GetCount();
+  EZ_ASSERT_DEV(spheres.m_Dirs.GetCount() == uiNumSpheres && spheres.m_Distances.GetCount() == uiNumSpheres && spheres.m_Radii.GetCount() == uiNumSpheres, "Invalid sweep batch");
+  EZ_ASSERT_DEV(out_Results.GetCount() >= uiNumSpheres && out_Hits.GetCount() >= uiNumSpheres, "Output arrays are too small");
+
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, collection == ezPhysicsHitCollection::Any ? PxQueryFlags(PxQueryFlag::eANY_HIT) : PxQueryFlags());
+
+  ezAtomicInteger32 iNumHits;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumSpheres,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      ezPxSweepCallback closestHit;
+      ezPxQueryFilter queryFilter;
+      queryFilter.m_bIncludeQueryShapes = params.m_bIncludeQueryShapes;
+
+      ezInt32 iNumTaskHits = 0;
+
+      EZ_PX_READ_LOCK(*m_pPxScene);
+
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        PxSphereGeometry sphere;
+        sphere.radius = spheres.m_Radii[i];
+
+        const PxTransform transform = ezPxConversionUtils::ToTransform(spheres.m_Starts[i], ezQuat::IdentityQuaternion());
+
+        out_Hits[i] = false;
+
+        if (m_pPxScene->sweep(sphere, transform, ezPxConversionUtils::ToVec3(spheres.m_Dirs[i]), spheres.m_Distances[i], closestHit, PxHitFlag::eDEFAULT, filterData, &queryFilter))
+        {
+          // the result arrays are typically reused, don't keep any data of previous hits
+          out_Results[i] = ezPhysicsCastResult();
+          FillHitResult(closestHit.block, out_Results[i]);
+
+          out_Hits[i] = true;
+          ++iNumTaskHits;
+        }
+      }
+
+      iNumHits.Add(iNumTaskHits);
+    },
+    "PhysX SweepBatch", GetQueryBatchParallelForParams());
+
+  return static_cast<ezUInt32>(iNumHits);
+}
+
+ezUInt32 ezPhysXWorldModule::OverlapBatch(ezArrayPtr<bool> out_Overlaps, const ezPhysicsOverlapBatch& spheres, const ezPhysicsQueryParameters& params) const
+{
+  EZ_PROFILE_SCOPE("OverlapBatch");
+
+  const ezUInt32 uiNumSpheres = spheres.GetCount();
+  EZ_ASSERT_DEV(spheres.m_Radii.GetCount() == uiNumSpheres, "Invalid overlap batch");
+  EZ_ASSERT_DEV(out_Overlaps.GetCount() >= uiNumSpheres, "Output array is too small");
+
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, PxQueryFlag::eANY_HIT);
+
+  ezAtomicInteger32 iNumOverlaps;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumSpheres,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      ezPxOverlapCallback closestHit;
+      ezPxQueryFilter queryFilter;
+      queryFilter.m_bIncludeQueryShapes = params.m_bIncludeQueryShapes;
+
+      ezInt32 iNumTaskOverlaps = 0;
+
+      EZ_PX_READ_LOCK(*m_pPxScene);
+
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        PxSphereGeometry sphere;
+        sphere.radius = spheres.m_Radii[i];
+
+        const PxTransform transform = ezPxConversionUtils::ToTransform(spheres.m_Positions[i], ezQuat::IdentityQuaternion());
+
+        out_Overlaps[i] = m_pPxScene->overlap(sphere, transform, closestHit, filterData, &queryFilter);
+        iNumTaskOverlaps += out_Overlaps[i] ? 1 : 0;
+      }
+
+      iNumOverlaps.Add(iNumTaskOverlaps);
+    },
+    "PhysX OverlapBatch", GetQueryBatchParallelForParams());
+
+  return static_cast<ezUInt32>(iNumOverlaps);
+}
 
 void ezPhysXWorldModule::AddStaticCollisionBox(ezGameObject* pObject, ezVec3 boxSize)
 {
@@ -32,6 +32,12 @@ void PlacementTask::Clear()
   m_OutputTransforms.Clear();
   m_TempData.Clear();
   m_ValidPoints.Clear();
+
+  m_RayStarts.Clear();
+  m_RayDirs.Clear();
+  m_RayDistances.Clear();
+  m_HitResults.Clear();
+  m_Hits.Clear();
 }
 
 void PlacementTask::Execute()
@@ -65,29 +71,61 @@ void PlacementTask::FindPlacementPoints()
   ezUInt32 uiCollisionLayer = pOutput->m_uiCollisionLayer;
 
   auto& patternPoints = pOutput->m_pPattern->m_Points;
+  const ezUInt32 uiNumPoints = patternPoints.GetCount();
 
-  for (ezUInt32 i = 0; i < patternPoints.GetCount(); ++i)
+  const bool bRaycast = m_pData->m_pPhysicsModule != nullptr && m_pData->m_pOutput->m_Mode == ezProcPlacementMode::Raycast;
+  if (bRaycast)
   {
-    auto& patternPoint = patternPoints[i];
-    ezSimdVec4f patternCoords = ezSimdConversion::ToVec3(patternPoint.m_Coordinates.GetAsVec3(0.0f));
+    // cast the rays for all pattern points with a single batch query
+    m_RayStarts.SetCountUninitialized(uiNumPoints);
+    m_RayDirs.SetCountUninitialized(uiNumPoints);
+    m_RayDistances.SetCountUninitialized(uiNumPoints);
 
-    ezPhysicsCastResult hitResult;
-
-    if (m_pData->m_pPhysicsModule != nullptr && m_pData->m_pOutput->m_Mode == ezProcPlacementMode::Raycast)
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
     {
+      ezSimdVec4f patternCoords = ezSimdConversion::ToVec3(patternPoints[i].m_Coordinates.GetAsVec3(0.0f));
+
       ezSimdVec4f rayStart = (vXY + patternCoords * pOutput->m_fFootprint);
       rayStart += ezSimdRandom::FloatMinMax(ezSimdVec4i(i), vMinOffset, vMaxOffset, seed);
       rayStart.SetZ(fZStart);
 
-      if (!m_pData->m_pPhysicsModule->Raycast(hitResult, ezSimdConversion::ToVec3(rayStart), rayDir, fZRange, ezPhysicsQueryParameters(uiCollisionLayer, ezPhysicsShapeType::Static)))
+      m_RayStarts[i] = ezSimdConversion::ToVec3(rayStart);
+      m_RayDirs[i] = rayDir;
+      m_RayDistances[i] = fZRange;
+    }
+
+    m_HitResults.SetCount(uiNumPoints);
+    m_Hits.SetCount(uiNumPoints);
+
+    ezPhysicsCastBatch rays;
+    rays.m_Starts = m_RayStarts;
+    rays.m_Dirs = m_RayDirs;
+    rays.m_Distances = m_RayDistances;
+
+    m_pData->m_pPhysicsModule->RaycastBatch(m_HitResults, m_Hits, rays, ezPhysicsQueryParameters(uiCollisionLayer, ezPhysicsShapeType::Static));
+  }
+
+  for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+  {
+    auto& patternPoint = patternPoints[i];
+    ezSimdVec4f patternCoords = ezSimdConversion::ToVec3(patternPoint.m_Coordinates.GetAsVec3(0.0f));
+
+    ezPhysicsCastResult fixedHitResult;
+    const ezPhysicsCastResult* pHitResult = &fixedHitResult;
+
+    if (bRaycast)
+    {
+      if (!m_Hits[i])
         continue;
 
+      pHitResult = &m_HitResults[i];
+
       if (pOutput->m_hSurface.IsValid())
       {
-        if (!hitResult.m_hSurface.IsValid())
+        if (!pHitResult->m_hSurface.IsValid())
           continue;
 
-        ezResourceLock<ezSurfaceResource> hitSurface(hitResult.m_hSurface, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+        ezResourceLock<ezSurfaceResource> hitSurface(pHitResult->m_hSurface, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
         if (hitSurface.GetAcquireResult() == ezResourceAcquireResult::MissingFallback)
           continue;
 
@@ -100,13 +138,13 @@ void PlacementTask::FindPlacementPoints()
       ezSimdVec4f rayStart = (vXY + patternCoords * pOutput->m_fFootprint);
       rayStart += ezSimdRandom::FloatMinMax(ezSimdVec4i(i), vMinOffset, vMaxOffset, seed);
 
-      hitResult.m_vPosition = ezSimdConversion::ToVec3(rayStart);
-      hitResult.m_fDistance = 0;
-      hitResult.m_vNormal.Set(0, 0, 1);
+      fixedHitResult.m_vPosition = ezSimdConversion::ToVec3(rayStart);
+      fixedHitResult.m_fDistance = 0;
+      fixedHitResult.m_vNormal.Set(0, 0, 1);
     }
 
     bool bInBoundingBox = false;
-    ezSimdVec4f hitPosition = ezSimdConversion::ToVec3(hitResult.m_vPosition);
+    ezSimdVec4f hitPosition = ezSimdConversion::ToVec3(pHitResult->m_vPosition);
     ezSimdVec4f allOne = ezSimdVec4f(1.0f);
     for (auto& globalToLocalBox : m_pData->m_GlobalToLocalBoxTransforms)
     {
@@ -121,9 +159,9 @@ void PlacementTask::FindPlacementPoints()
     if (bInBoundingBox)
     {
       PlacementPoint& placementPoint = m_InputPoints.ExpandAndGetRef();
-      placementPoint.m_vPosition = hitResult.m_vPosition;
+      placementPoint.m_vPosition = pHitResult->m_vPosition;
       placementPoint.m_fScale = 1.0f;
-      placementPoint.m_vNormal = hitResult.m_vNormal;
+      placementPoint.m_vNormal = pHitResult->m_vNormal;
       placementPoint.m_uiColorIndex = 0;
       placementPoint.m_uiObjectIndex = 0;
       placementPoint.m_uiPointIndex = i;
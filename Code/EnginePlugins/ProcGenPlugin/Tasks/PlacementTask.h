@@ -1,10 +1,10 @@
 #pragma once
 
+#include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Foundation/CodeUtils/Expression/ExpressionVM.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <ProcGenPlugin/Declarations.h>
 
-class ezPhysicsWorldModuleInterface;
 class ezVolumeCollection;
 
 namespace ezProcGenInternal
@@ -38,6 +38,12 @@ namespace ezProcGenInternal
     ezDynamicArray<float> m_TempData;
     ezDynamicArray<ezUInt32> m_ValidPoints;
 
+    ezDynamicArray<ezVec3> m_RayStarts;
+    ezDynamicArray<ezVec3> m_RayDirs;
+    ezDynamicArray<float> m_RayDistances;
+    ezDynamicArray<ezPhysicsCastResult> m_HitResults;
+    ezDynamicArray<bool> m_Hits;
+
     ezExpressionVM m_VM;
   };
 } // namespace ezProcGenInternal
@@ -23,6 +23,18 @@
     
     If no -out is specified, it is determined to be where the input file is located.
 
+-chunked <MB>
+    Files of at least this size (in MB) are compressed in independent chunks.
+    
+    Such files can be read from any position and get decompressed in parallel.
+    Zero (the default) disables chunked compression.
+
+-dictionary <KB>
+    Size of the compression dictionary that is trained on all small files.
+    
+    Small files compress much better with a dictionary.
+    Zero (the default) disables the dictionary, 112 is a good size for most data.
+
 -unpack <paths>
     One or multiple paths to ezArchive files that shall be extracted.
     
@@ -68,6 +80,22 @@ If no -out is specified, it is determined to be where the input file is located.
 ",
   "");
 
+ezCommandLineOptionInt opt_Chunked("_ArchiveTool", "-chunked", "\
+Files of at least this size (in MB) are compressed in independent chunks.\n\
+\n\
+Such files can be read from any position and get decompressed in parallel.\n\
+Zero (the default) disables chunked compression.\n\
+",
+  0, 0);
+
+ezCommandLineOptionInt opt_Dictionary("_ArchiveTool", "-dictionary", "\
+Size of the compression dictionary that is trained on all small files.\n\
+\n\
+Small files compress much better with a dictionary.\n\
+Zero (the default) disables the dictionary, 112 is a good size for most data.\n\
+",
+  0, 0, 1024);
+
 ezCommandLineOptionDoc opt_Unpack("_ArchiveTool", "-unpack", "<paths>", "\
 One or multiple paths to ezArchive files that shall be extracted.\n\
 \n\
@@ -234,7 +262,8 @@ public:
       {
         const char* szArg = GetArgument(a);
 
-        if (ezStringUtils::IsEqual_NoCase(szArg, "-out"))
+        // all inputs have to come before the other options
+        if (ezStringUtils::StartsWith(szArg, "-"))
           break;
 
         m_sInputs.PushBack(ezOSFile::MakePathAbsoluteWithCWD(szArg));
@@ -311,6 +340,8 @@ public:
   ezResult Pack()
   {
     ezArchiveBuilderImpl archive;
+    archive.m_uiChunkedCompressionThreshold = static_cast<ezUInt64>(opt_Chunked.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified)) * 1024 * 1024;
+    archive.m_uiCompressionDictionarySize = static_cast<ezUInt32>(opt_Dictionary.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified)) * 1024;
 
     for (const auto& folder : m_sInputs)
     {
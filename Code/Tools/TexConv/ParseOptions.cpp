@@ -55,6 +55,15 @@ ezCommandLineOptionPath opt_LowOut("_TexConv", "-lowOut",
 ",
   "");
 
+ezCommandLineOptionPath opt_Cache("_TexConv", "-cache",
+  "\
+  Absolute path to a directory for intermediate results.\n\
+  Decoded input files and mipmap chains are reused when the inputs and settings did not change.\n\
+",
+  "");
+
+ezCommandLineOptionInt opt_CacheSizeLimit("_TexConv", "-cacheSizeLimit", "Size in MB up to which the -cache directory may grow before the oldest files are deleted. 0 disables the limit.", 1024, 0, 1024 * 1024);
+
 ezCommandLineOptionInt opt_LowMips("_TexConv", "-lowMips", "Number of mipmaps to use from main result as low-res data.", 0, 0, 8);
 
 ezCommandLineOptionInt opt_MinRes("_TexConv", "-minRes", "The minimum resolution allowed for the output.", 16, 4, 8 * 1024);
@@ -421,6 +430,9 @@ ezResult ezTexConv::ParseMiscOptions()
 
   m_Processor.m_Descriptor.m_fMaxValue = opt_Clamp.GetOptionValue(ezCommandLineOption::LogMode::Always);
 
+  m_Processor.m_Descriptor.m_sIntermediateCacheDirectory = opt_Cache.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified);
+  m_Processor.m_Descriptor.m_uiIntermediateCacheSizeLimitMB = opt_CacheSizeLimit.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified);
+
   return EZ_SUCCESS;
 }
 
@@ -1,7 +1,10 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
+#include <Foundation/Types/UniquePtr.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
 
@@ -286,3 +289,502 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+namespace
+{
+  class ConcurrencyTestResourceTypeLoader : public TestResourceTypeLoader
+  {
+  public:
+    virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override
+    {
+      const ezInt32 iLoading = m_iNumLoading.Increment();
+
+      ezInt32 iMax = m_iMaxNumLoading;
+      while (iLoading > iMax && !m_iMaxNumLoading.TestAndSet(iMax, iLoading))
+      {
+        iMax = m_iMaxNumLoading;
+      }
+
+      // give other lanes the chance to pick up work in the meantime
+      ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+
+      return TestResourceTypeLoader::OpenDataStream(pResource);
+    }
+
+    virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData) override
+    {
+      m_iNumLoading.Decrement();
+
+      TestResourceTypeLoader::CloseDataStream(pResource, LoaderData);
+    }
+
+    ezAtomicInteger32 m_iNumLoading;
+    ezAtomicInteger32 m_iMaxNumLoading;
+  };
+
+  /// Holds up its lane while loading the resource called 'Gate', until the gate is opened. Records in which order all other resources are loaded.
+  class GatedTestResourceTypeLoader : public TestResourceTypeLoader
+  {
+  public:
+    virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override
+    {
+      if (pResource->GetResourceID() == "Gate")
+      {
+        m_iGateEntered = 1;
+
+        while (m_iGateOpen == 0)
+        {
+          ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+        }
+      }
+      else
+      {
+        EZ_LOCK(m_Mutex);
+        m_LoadOrder.PushBack(pResource->GetResourceID());
+      }
+
+      return TestResourceTypeLoader::OpenDataStream(pResource);
+    }
+
+    void WaitForGate()
+    {
+      while (m_iGateEntered == 0)
+      {
+        ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+      }
+    }
+
+    bool WasLoaded(const char* szResourceID)
+    {
+      EZ_LOCK(m_Mutex);
+      return m_LoadOrder.Contains(szResourceID);
+    }
+
+    ezAtomicInteger32 m_iGateEntered;
+    ezAtomicInteger32 m_iGateOpen;
+    ezMutex m_Mutex;
+    ezDynamicArray<ezString> m_LoadOrder;
+  };
+
+  void WaitForLoadingToFinish()
+  {
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, ConcurrentLoading)
+{
+  ConcurrencyTestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  const ezUInt32 uiOldMaxLoads = ezResourceManager::GetMaxConcurrentDataLoads();
+  EZ_SCOPE_EXIT(ezResourceManager::SetMaxConcurrentDataLoads(uiOldMaxLoads));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Type Limit")
+  {
+    ezResourceManager::SetMaxConcurrentDataLoads(4);
+    ezResourceManager::SetResourceTypeMaxConcurrentLoads<TestResource>(2);
+    EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeMaxConcurrentLoads<TestResource>(0));
+
+    const ezUInt64 uiNumStartedBefore = ezResourceManager::GetLoadingQueueStats(ezResourcePriority::Medium).m_uiNumStarted;
+
+    const ezUInt32 uiNumResources = 50;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Concurrent-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    // blocking on a resource makes it critical, which ignores the type limit, so wait until everything is loaded first
+    WaitForLoadingToFinish();
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+
+      pTestResource->Test();
+    }
+
+    EZ_TEST_BOOL(TypeLoader.m_iMaxNumLoading >= 1);
+    EZ_TEST_BOOL(TypeLoader.m_iMaxNumLoading <= 2);
+
+    const ezResourceManager::LoadingQueueStats stats = ezResourceManager::GetLoadingQueueStats(ezResourcePriority::Medium);
+    EZ_TEST_BOOL(stats.m_uiNumStarted > uiNumStartedBefore);
+    EZ_TEST_BOOL(stats.m_MaxLatency >= ezTime::Zero());
+
+    hResources.Clear();
+
+    WaitForLoadingToFinish();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, LoadingOrder)
+{
+  GatedTestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  const ezUInt32 uiOldMaxLoads = ezResourceManager::GetMaxConcurrentDataLoads();
+  EZ_SCOPE_EXIT(ezResourceManager::SetMaxConcurrentDataLoads(uiOldMaxLoads));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Priority Order")
+  {
+    // a single lane, which is held up by the gate until all other resources are queued
+    ezResourceManager::SetMaxConcurrentDataLoads(1);
+
+    TestResourceHandle hGate = ezResourceManager::LoadResource<TestResource>("Gate");
+    ezResourceManager::PreloadResource(hGate);
+    TypeLoader.WaitForGate();
+
+    // queued from least to most important
+    const ezResourcePriority priorities[] = {ezResourcePriority::VeryLow, ezResourcePriority::Low, ezResourcePriority::Medium, ezResourcePriority::High, ezResourcePriority::VeryHigh};
+    const char* szResourceIDs[] = {"Priority-VeryLow", "Priority-Low", "Priority-Medium", "Priority-High", "Priority-VeryHigh"};
+
+    ezHybridArray<TestResourceHandle, 5> hResources;
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(priorities); ++i)
+    {
+      TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>(szResourceIDs[i]);
+      hResources.PushBack(hResource);
+
+      {
+        ezResourceLock<TestResource> pTestResource(hResource, ezResourceAcquireMode::PointerOnly);
+        pTestResource->SetPriority(priorities[i]);
+      }
+
+      ezResourceManager::PreloadResource(hResource);
+    }
+
+    TypeLoader.m_iGateOpen = 1;
+    WaitForLoadingToFinish();
+
+    if (EZ_TEST_INT(TypeLoader.m_LoadOrder.GetCount(), EZ_ARRAY_SIZE(szResourceIDs)))
+    {
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(szResourceIDs); ++i)
+      {
+        EZ_TEST_STRING(TypeLoader.m_LoadOrder[i], szResourceIDs[EZ_ARRAY_SIZE(szResourceIDs) - 1 - i]);
+      }
+    }
+
+    hGate.Invalidate();
+    hResources.Clear();
+    ezResourceManager::FreeAllUnusedResources();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Critical Loads ignore Type Limit")
+  {
+    TypeLoader.m_iGateEntered = 0;
+    TypeLoader.m_iGateOpen = 0;
+    TypeLoader.m_LoadOrder.Clear();
+
+    ezResourceManager::SetMaxConcurrentDataLoads(4);
+    ezResourceManager::SetResourceTypeMaxConcurrentLoads<TestResource>(1);
+    EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeMaxConcurrentLoads<TestResource>(0));
+
+    // the gate uses up the only load that the type may have in flight
+    TestResourceHandle hGate = ezResourceManager::LoadResource<TestResource>("Gate");
+    ezResourceManager::PreloadResource(hGate);
+    TypeLoader.WaitForGate();
+
+    TestResourceHandle hCapped = ezResourceManager::LoadResource<TestResource>("Capped");
+    ezResourceManager::PreloadResource(hCapped);
+
+    // this would wait forever, if critical loads had to respect the limit as well
+    TestResourceHandle hCritical = ezResourceManager::LoadResource<TestResource>("Critical");
+    {
+      ezResourceLock<TestResource> pTestResource(hCritical, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    EZ_TEST_BOOL(TypeLoader.WasLoaded("Critical"));
+    EZ_TEST_BOOL(!TypeLoader.WasLoaded("Capped"));
+
+    TypeLoader.m_iGateOpen = 1;
+    WaitForLoadingToFinish();
+
+    EZ_TEST_BOOL(TypeLoader.WasLoaded("Capped"));
+
+    hGate.Invalidate();
+    hCapped.Invalidate();
+    hCritical.Invalidate();
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+namespace
+{
+  using QualityLevelTestResourceHandle = ezTypedResourceHandle<class QualityLevelTestResource>;
+
+  /// Loads one additional quality level with every UpdateContent() call.
+  class QualityLevelTestResource : public ezResource
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(QualityLevelTestResource, ezResource);
+    EZ_RESOURCE_DECLARE_COMMON_CODE(QualityLevelTestResource);
+
+  public:
+    static constexpr ezUInt8 NumQualityLevels = 4;
+
+    QualityLevelTestResource()
+      : ezResource(ezResource::DoUpdate::OnAnyThread, 1)
+    {
+    }
+
+  protected:
+    virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override
+    {
+      m_uiLoadedQualityLevels = (WhatToUnload == Unload::OneQualityLevel && m_uiLoadedQualityLevels > 0) ? m_uiLoadedQualityLevels - 1 : 0;
+
+      ezResourceLoadDesc ld;
+      ld.m_State = m_uiLoadedQualityLevels > 0 ? ezResourceState::Loaded : ezResourceState::Unloaded;
+      ld.m_uiQualityLevelsDiscardable = m_uiLoadedQualityLevels;
+      ld.m_uiQualityLevelsLoadable = NumQualityLevels - m_uiLoadedQualityLevels;
+
+      return ld;
+    }
+
+    virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override
+    {
+      ++m_uiLoadedQualityLevels;
+
+      ezResourceLoadDesc ld;
+      ld.m_State = ezResourceState::Loaded;
+      ld.m_uiQualityLevelsDiscardable = m_uiLoadedQualityLevels;
+      ld.m_uiQualityLevelsLoadable = NumQualityLevels - m_uiLoadedQualityLevels;
+
+      return ld;
+    }
+
+    virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override
+    {
+      out_NewMemoryUsage.m_uiMemoryCPU = sizeof(QualityLevelTestResource);
+      out_NewMemoryUsage.m_uiMemoryGPU = m_uiLoadedQualityLevels * 1024;
+    }
+
+  private:
+    ezUInt8 m_uiLoadedQualityLevels = 0;
+  };
+
+  EZ_RESOURCE_IMPLEMENT_COMMON_CODE(QualityLevelTestResource);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(QualityLevelTestResource, 1, ezRTTIDefaultAllocator<QualityLevelTestResource>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  void WaitForLoading()
+  {
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, QualityLevelLimit)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<QualityLevelTestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<QualityLevelTestResource>(nullptr));
+
+  QualityLevelTestResourceHandle hResource = ezResourceManager::LoadResource<QualityLevelTestResource>("QualityLevels");
+
+  auto GetNumLoadedQualityLevels = [&]() {
+    ezResourceLock<QualityLevelTestResource> pResource(hResource, ezResourceAcquireMode::PointerOnly);
+    return pResource->GetNumQualityLevelsDiscardable();
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Limit Loading")
+  {
+    ezResourceManager::SetResourceQualityLevelLimit(hResource, 2);
+    ezResourceManager::PreloadResource(hResource);
+    WaitForLoading();
+
+    EZ_TEST_INT(GetNumLoadedQualityLevels(), 2);
+
+    ezResourceLock<QualityLevelTestResource> pResource(hResource, ezResourceAcquireMode::PointerOnly);
+    EZ_TEST_INT(pResource->GetQualityLevelLimit(), 2);
+    EZ_TEST_INT(pResource->GetNumQualityLevelsLoadable(), 2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Raise Limit")
+  {
+    ezResourceManager::SetResourceQualityLevelLimit(hResource, 3);
+    WaitForLoading();
+
+    EZ_TEST_INT(GetNumLoadedQualityLevels(), 3);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Lower Limit")
+  {
+    // every call unloads one quality level
+    ezResourceManager::SetResourceQualityLevelLimit(hResource, 1);
+    EZ_TEST_INT(GetNumLoadedQualityLevels(), 2);
+
+    ezResourceManager::SetResourceQualityLevelLimit(hResource, 1);
+    EZ_TEST_INT(GetNumLoadedQualityLevels(), 1);
+
+    ezResourceManager::SetResourceQualityLevelLimit(hResource, 1);
+    EZ_TEST_INT(GetNumLoadedQualityLevels(), 1);
+
+    ezResourceLock<QualityLevelTestResource> pResource(hResource, ezResourceAcquireMode::PointerOnly);
+    EZ_TEST_INT(pResource->GetMemoryUsage().m_uiMemoryGPU, 1024);
+    EZ_TEST_BOOL(pResource->GetLoadingState() == ezResourceState::Loaded);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Remove Limit")
+  {
+    ezResourceManager::SetResourceQualityLevelLimit(hResource, 0xFF);
+    WaitForLoading();
+
+    EZ_TEST_INT(GetNumLoadedQualityLevels(), QualityLevelTestResource::NumQualityLevels);
+  }
+
+  hResource.Invalidate();
+  WaitForLoading();
+  ezResourceManager::FreeAllUnusedResources();
+  EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<QualityLevelTestResource>()->GetCount(), 0);
+}
+
+namespace
+{
+  /// Acquires all resources over and over again, like render extraction does every frame.
+  class AcquireTestThread : public ezThread
+  {
+  public:
+    AcquireTestThread(ezArrayPtr<const TestResourceHandle> resources, ezUInt32 uiNumRounds, bool bLockResourceManager)
+      : ezThread("Acquire Test Thread")
+      , m_Resources(resources)
+      , m_uiNumRounds(uiNumRounds)
+      , m_bLockResourceManager(bLockResourceManager)
+    {
+    }
+
+    virtual ezUInt32 Run() override
+    {
+      for (ezUInt32 uiRound = 0; uiRound < m_uiNumRounds; ++uiRound)
+      {
+        for (const TestResourceHandle& hResource : m_Resources)
+        {
+          if (m_bLockResourceManager)
+          {
+            // what every acquisition used to cost, before fully loaded resources skipped the resource manager mutex
+            EZ_LOCK(ezResourceManager::GetMutex());
+            Acquire(hResource);
+          }
+          else
+          {
+            Acquire(hResource);
+          }
+        }
+      }
+
+      return 0;
+    }
+
+    ezUInt32 m_uiNumFailed = 0;
+
+  private:
+    void Acquire(const TestResourceHandle& hResource)
+    {
+      ezResourceLock<TestResource> pResource(hResource, ezResourceAcquireMode::AllowLoadingFallback);
+
+      if (pResource.GetAcquireResult() != ezResourceAcquireResult::Final)
+      {
+        ++m_uiNumFailed;
+      }
+    }
+
+    ezArrayPtr<const TestResourceHandle> m_Resources;
+    ezUInt32 m_uiNumRounds = 0;
+    bool m_bLockResourceManager = false;
+  };
+
+  ezTime RunAcquireTestThreads(ezArrayPtr<const TestResourceHandle> resources, ezUInt32 uiNumRounds, bool bLockResourceManager)
+  {
+    constexpr ezUInt32 uiNumThreads = 16;
+    ezUniquePtr<AcquireTestThread> threads[uiNumThreads];
+
+    for (ezUInt32 t = 0; t < uiNumThreads; ++t)
+    {
+      threads[t] = EZ_DEFAULT_NEW(AcquireTestThread, resources, uiNumRounds, bLockResourceManager);
+    }
+
+    ezStopwatch sw;
+
+    for (ezUInt32 t = 0; t < uiNumThreads; ++t)
+    {
+      threads[t]->Start();
+    }
+
+    for (ezUInt32 t = 0; t < uiNumThreads; ++t)
+    {
+      threads[t]->Join();
+    }
+
+    const ezTime tDiff = sw.Checkpoint();
+
+    for (ezUInt32 t = 0; t < uiNumThreads; ++t)
+    {
+      EZ_TEST_INT(threads[t]->m_uiNumFailed, 0);
+    }
+
+    return tDiff;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, ConcurrentAcquire)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  const ezUInt32 uiNumResources = 1000;
+  const ezUInt32 uiNumRounds = 100;
+
+  ezDynamicArray<TestResourceHandle> hResources;
+  hResources.Reserve(uiNumResources);
+
+  ezStringBuilder sResourceID;
+  for (ezUInt32 i = 0; i < uiNumResources; ++i)
+  {
+    sResourceID.Format("Acquire-{}", i);
+    hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+  }
+
+  for (const TestResourceHandle& hResource : hResources)
+  {
+    ezResourceLock<TestResource> pResource(hResource, ezResourceAcquireMode::BlockTillLoaded);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Loaded Resources")
+  {
+    const ezTime tLockFree = RunAcquireTestThreads(hResources, uiNumRounds, false);
+    const ezTime tLocked = RunAcquireTestThreads(hResources, uiNumRounds, true);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Acquiring %u resources %u times on 16 threads: %.2fms lock-free, %.2fms with the resource manager mutex (%.1fx)",
+      uiNumResources, uiNumRounds, tLockFree.GetMilliseconds(), tLocked.GetMilliseconds(), tLocked.GetSeconds() / ezMath::Max(tLockFree.GetSeconds(), 0.000001));
+  }
+
+  hResources.Clear();
+  WaitForLoading();
+  ezResourceManager::FreeAllUnusedResources();
+  EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+}
@@ -6,7 +6,9 @@
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/System/Process.h>
 #include <Foundation/System/ProcessGroup.h>
+#include <TestFramework/Utilities/TestLogInterface.h>
 #include <Texture/Image/Image.h>
+#include <Texture/TexConv/TexConvProcessor.h>
 
 #if EZ_ENABLED(EZ_SUPPORTS_PROCESSES) && EZ_ENABLED(EZ_PLATFORM_WINDOWS) && defined(BUILDSYSTEM_TEXCONV_PRESENT)
 
@@ -310,3 +312,82 @@ ezTestAppRun ezTexConvTest::RunSubTest(ezInt32 iIdentifier, ezUInt32 uiInvocatio
 static ezTexConvTest s_ezTexConvTest;
 
 #endif
+
+EZ_CREATE_SIMPLE_TEST_GROUP(TexConv);
+
+EZ_CREATE_SIMPLE_TEST(TexConv, IntermediateCache)
+{
+  const ezStringBuilder sReadDir(">sdk/", ezTestFramework::GetInstance()->GetRelTestDataPath());
+  const ezStringBuilder sWriteDir = ezTestFramework::GetInstance()->GetAbsOutputPath();
+
+  if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sReadDir, "TexConvCacheTest", "testdata").Succeeded()))
+    return;
+
+  // the cache files are written through the file system
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sWriteDir, "TexConvCacheTest", "output", ezFileSystem::AllowWrites).Succeeded());
+
+  ezStringBuilder sInputFile;
+  EZ_TEST_BOOL(ezFileSystem::ResolvePath(":testdata/TexConv/EZ.png", &sInputFile, nullptr).Succeeded());
+
+  // entries left over from previous runs have the same keys, they don't change the outcome
+  const ezStringBuilder sCacheDir(sWriteDir, "/TexConvCache");
+
+  // normal maps are stored in uncompressed formats with and without compression, so this works on all platforms
+  auto Convert = [&](ezTexConvCompressionMode::Enum compression, const char* szCacheDir, ezImage& out_Image) -> ezResult {
+    ezTexConvProcessor processor;
+    processor.m_Descriptor.m_InputFiles.PushBack(sInputFile);
+
+    ezTexConvSliceChannelMapping& mapping = processor.m_Descriptor.m_ChannelMappings.ExpandAndGetRef();
+    mapping.m_Channel[0].m_iInputImageIndex = 0;
+    mapping.m_Channel[1].m_iInputImageIndex = 0;
+    mapping.m_Channel[2].m_iInputImageIndex = 0;
+
+    processor.m_Descriptor.m_Usage = ezTexConvUsage::NormalMap;
+    processor.m_Descriptor.m_MipmapMode = ezTexConvMipmapMode::Linear;
+    processor.m_Descriptor.m_CompressionMode = compression;
+    processor.m_Descriptor.m_sIntermediateCacheDirectory = szCacheDir;
+
+    EZ_SUCCEED_OR_RETURN(processor.Process());
+
+    out_Image.ResetAndMove(std::move(processor.m_OutputImage));
+    return EZ_SUCCESS;
+  };
+
+  auto AreImagesIdentical = [](const ezImage& a, const ezImage& b) -> bool {
+    if (a.GetImageFormat() != b.GetImageFormat() || a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight() || a.GetNumMipLevels() != b.GetNumMipLevels())
+      return false;
+
+    ezConstByteBlobPtr dataA = a.GetByteBlobPtr();
+    ezConstByteBlobPtr dataB = b.GetByteBlobPtr();
+
+    return dataA.GetCount() == dataB.GetCount() && ezMemoryUtils::IsEqual(dataA.GetPtr(), dataB.GetPtr(), static_cast<size_t>(dataA.GetCount()));
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Change only the output format")
+  {
+    ezImage uncached;
+    EZ_TEST_BOOL(Convert(ezTexConvCompressionMode::Medium, "", uncached).Succeeded());
+    EZ_TEST_BOOL(uncached.GetImageFormat() == ezImageFormat::R8G8_UNORM);
+
+    // fills the cache
+    ezImage uncompressed;
+    EZ_TEST_BOOL(Convert(ezTexConvCompressionMode::None, sCacheDir, uncompressed).Succeeded());
+    EZ_TEST_BOOL(uncompressed.GetImageFormat() == ezImageFormat::R16G16_UNORM);
+
+    // the compression only affects the output format, so the cached mipmap chain is used
+    ezImage cached;
+
+    {
+      ezTestLogInterface log;
+      ezTestLogSystemScope logSystemScope(&log);
+
+      log.ExpectMessage("Reusing the cached mipmap chain", ezLogMsgType::InfoMsg);
+
+      EZ_TEST_BOOL(Convert(ezTexConvCompressionMode::Medium, sCacheDir, cached).Succeeded());
+    }
+
+    EZ_TEST_BOOL(AreImagesIdentical(cached, uncached));
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("TexConvCacheTest");
+}
@@ -1,7 +1,9 @@
 #include <CoreTest/CoreTestPCH.h>
 
+#include <Core/Graphics/OcclusionBuffer.h>
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
@@ -55,270 +57,424 @@ namespace
   }
   EZ_END_COMPONENT_TYPE;
   // clang-format on
-} // namespace
 
-EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
-{
-  ezWorldDesc worldDesc("Test");
-  worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  void TestSpatialSystem(ezSpatialSystemType::Enum spatialSystemType)
+  {
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+    worldDesc.m_SpatialSystemType = spatialSystemType;
 
-  ezWorld world(worldDesc);
-  EZ_LOCK(world.GetWriteMarker());
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
 
-  auto& rng = world.GetRandomNumberGenerator();
-  double range = 10000.0;
+    auto& rng = world.GetRandomNumberGenerator();
+    double range = 10000.0;
 
-  ezDynamicArray<ezGameObject*> objects;
-  objects.Reserve(1000);
+    ezDynamicArray<ezGameObject*> objects;
+    objects.Reserve(1000);
 
-  for (ezUInt32 i = 0; i < 1000; ++i)
-  {
-    float x = (float)rng.DoubleMinMax(-range, range);
-    float y = (float)rng.DoubleMinMax(-range, range);
-    float z = (float)rng.DoubleMinMax(-range, range);
+    for (ezUInt32 i = 0; i < 1000; ++i)
+    {
+      float x = (float)rng.DoubleMinMax(-range, range);
+      float y = (float)rng.DoubleMinMax(-range, range);
+      float z = (float)rng.DoubleMinMax(-range, range);
 
-    ezGameObjectDesc desc;
-    desc.m_bDynamic = (i >= 500);
-    desc.m_LocalPosition = ezVec3(x, y, z);
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = (i >= 500);
+      desc.m_LocalPosition = ezVec3(x, y, z);
 
-    ezGameObject* pObject = nullptr;
-    world.CreateObject(desc, pObject);
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
 
-    objects.PushBack(pObject);
+      objects.PushBack(pObject);
 
-    TestBoundsComponent* pComponent = nullptr;
-    TestBoundsComponent::CreateComponent(pObject, pComponent);
-  }
+      TestBoundsComponent* pComponent = nullptr;
+      TestBoundsComponent::CreateComponent(pObject, pComponent);
+    }
 
-  world.Update();
+    world.Update();
 
-  ezSpatialSystem::QueryParams queryParams;
-  queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
 
-  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInSphere")
-  {
-    ezBoundingSphere testSphere(ezVec3(100.0f, 60.0f, 400.0f), 3000.0f);
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInSphere")
+    {
+      ezBoundingSphere testSphere(ezVec3(100.0f, 60.0f, 400.0f), 3000.0f);
 
-    ezDynamicArray<ezGameObject*> objectsInSphere;
-    ezHashSet<ezGameObject*> uniqueObjects;
-    world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, objectsInSphere);
+      ezDynamicArray<ezGameObject*> objectsInSphere;
+      ezHashSet<ezGameObject*> uniqueObjects;
+      world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, objectsInSphere);
 
-    for (auto pObject : objectsInSphere)
-    {
-      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+      for (auto pObject : objectsInSphere)
+      {
+        ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
 
-      EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
-      EZ_TEST_BOOL(pObject->IsStatic());
-    }
+        EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        EZ_TEST_BOOL(pObject->IsStatic());
+      }
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
-    {
-      ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
-      if (testSphere.Overlaps(objSphere))
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
       {
-        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
+        if (testSphere.Overlaps(objSphere))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        }
       }
-    }
 
-    objectsInSphere.Clear();
-    uniqueObjects.Clear();
+      objectsInSphere.Clear();
+      uniqueObjects.Clear();
 
-    world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, [&](ezGameObject* pObject) {
-      objectsInSphere.PushBack(pObject);
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      world.GetSpatialSystem()->FindObjectsInSphere(testSphere, queryParams, [&](ezGameObject* pObject) {
+        objectsInSphere.PushBack(pObject);
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
 
-      return ezVisitorExecution::Continue;
-    });
+        return ezVisitorExecution::Continue;
+      });
 
-    for (auto pObject : objectsInSphere)
-    {
-      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+      for (auto pObject : objectsInSphere)
+      {
+        ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
 
-      EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
-      EZ_TEST_BOOL(pObject->IsStatic());
+        EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
+        EZ_TEST_BOOL(pObject->IsStatic());
+      }
+
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
+        if (testSphere.Overlaps(objSphere))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        }
+      }
     }
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInBox")
     {
-      ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
-      if (testSphere.Overlaps(objSphere))
+      ezBoundingBox testBox;
+      testBox.SetCenterAndHalfExtents(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(3000.0f));
+
+      ezDynamicArray<ezGameObject*> objectsInBox;
+      ezHashSet<ezGameObject*> uniqueObjects;
+      world.GetSpatialSystem()->FindObjectsInBox(testBox, queryParams, objectsInBox);
+
+      for (auto pObject : objectsInBox)
       {
-        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        ezBoundingBox objBox = pObject->GetGlobalBounds().GetBox();
+
+        EZ_TEST_BOOL(testBox.Overlaps(objBox));
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        EZ_TEST_BOOL(pObject->IsStatic());
       }
-    }
-  }
 
-  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInBox")
-  {
-    ezBoundingBox testBox;
-    testBox.SetCenterAndHalfExtents(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(3000.0f));
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
+        if (testBox.Overlaps(objBox))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        }
+      }
 
-    ezDynamicArray<ezGameObject*> objectsInBox;
-    ezHashSet<ezGameObject*> uniqueObjects;
-    world.GetSpatialSystem()->FindObjectsInBox(testBox, queryParams, objectsInBox);
+      objectsInBox.Clear();
+      uniqueObjects.Clear();
 
-    for (auto pObject : objectsInBox)
-    {
-      ezBoundingBox objBox = pObject->GetGlobalBounds().GetBox();
+      world.GetSpatialSystem()->FindObjectsInBox(testBox, queryParams, [&](ezGameObject* pObject) {
+        objectsInBox.PushBack(pObject);
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+
+        return ezVisitorExecution::Continue;
+      });
 
-      EZ_TEST_BOOL(testBox.Overlaps(objBox));
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
-      EZ_TEST_BOOL(pObject->IsStatic());
+      for (auto pObject : objectsInBox)
+      {
+        ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+
+        EZ_TEST_BOOL(testBox.Overlaps(objSphere));
+        EZ_TEST_BOOL(pObject->IsStatic());
+      }
+
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
+        if (testBox.Overlaps(objBox))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        }
+      }
     }
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
     {
-      ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
-      if (testBox.Overlaps(objBox))
+      constexpr uint32_t numUpdates = 13;
+
+      // update a few times to increase internal frame counter
+      for (uint32_t i = 0; i < numUpdates; ++i)
       {
-        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        world.Update();
       }
-    }
 
-    objectsInBox.Clear();
-    uniqueObjects.Clear();
+      queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
 
-    world.GetSpatialSystem()->FindObjectsInBox(testBox, queryParams, [&](ezGameObject* pObject) {
-      objectsInBox.PushBack(pObject);
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::ZeroVector(), ezVec3::UnitXAxis(), ezVec3::UnitZAxis());
+      ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::Degree(80.0f), 1.0f, 1.0f, 10000.0f);
 
-      return ezVisitorExecution::Continue;
-    });
+      ezFrustum testFrustum;
+      testFrustum.SetFrustum(projection * lookAt);
 
-    for (auto pObject : objectsInBox)
-    {
-      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+      ezDynamicArray<const ezGameObject*> visibleObjects;
+      ezHashSet<const ezGameObject*> uniqueObjects;
+      world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, visibleObjects);
 
-      EZ_TEST_BOOL(testBox.Overlaps(objSphere));
-      EZ_TEST_BOOL(pObject->IsStatic());
-    }
+      EZ_TEST_BOOL(!visibleObjects.IsEmpty());
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
-    {
-      ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
-      if (testBox.Overlaps(objBox))
+      for (auto pObject : visibleObjects)
       {
-        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        EZ_TEST_BOOL(testFrustum.Overlaps(pObject->GetGlobalBoundsSimd().GetSphere()));
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        EZ_TEST_BOOL(pObject->IsDynamic());
+        EZ_TEST_BOOL(pObject->GetNumFramesSinceVisible() == 0);
       }
-    }
-  }
 
-  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
-  {
-    constexpr uint32_t numUpdates = 13;
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        ezGameObject* pObject = it;
+
+        if (testFrustum.GetObjectPosition(pObject->GetGlobalBounds().GetSphere()) == ezVolumePosition::Outside)
+        {
+          EZ_TEST_BOOL(pObject->GetNumFramesSinceVisible() >= numUpdates);
+        }
+      }
+
+      // Move some objects
+      const double range = 500.0f;
+
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        if (it->IsDynamic())
+        {
+          ezVec3 pos = it->GetLocalPosition();
+
+          pos.x += (float)rng.DoubleMinMax(-range, range);
+          pos.y += (float)rng.DoubleMinMax(-range, range);
+          pos.z += (float)rng.DoubleMinMax(-range, range);
+
+          it->SetLocalPosition(pos);
+        }
+      }
 
-    // update a few times to increase internal frame counter
-    for (uint32_t i = 0; i < numUpdates; ++i)
-    {
       world.Update();
+
+      // Check that last frame visible doesn't reset entirely after moving
+      for (const ezGameObject* pObject : visibleObjects)
+      {
+        EZ_TEST_BOOL(pObject->GetNumFramesSinceVisible() == 1);
+      }
     }
 
-    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects Parallel")
+    {
+      queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
 
-    ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::ZeroVector(), ezVec3::UnitXAxis(), ezVec3::UnitZAxis());
-    ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::Degree(80.0f), 1.0f, 1.0f, 10000.0f);
+      ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::ZeroVector(), ezVec3::UnitXAxis(), ezVec3::UnitZAxis());
+      ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::Degree(80.0f), 1.0f, 1.0f, 10000.0f);
 
-    ezFrustum testFrustum;
-    testFrustum.SetFrustum(projection * lookAt);
+      ezFrustum testFrustum;
+      testFrustum.SetFrustum(projection * lookAt);
 
-    ezDynamicArray<const ezGameObject*> visibleObjects;
-    ezHashSet<const ezGameObject*> uniqueObjects;
-    world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, visibleObjects);
+      ezCVarInt* pThreshold = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("Spatial.Culling.ParallelThreshold"));
+      EZ_TEST_BOOL(pThreshold != nullptr);
+      const int iOldThreshold = *pThreshold;
 
-    EZ_TEST_BOOL(!visibleObjects.IsEmpty());
+      ezDynamicArray<const ezGameObject*> serialObjects;
+      *pThreshold = 0;
+      world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, serialObjects);
 
-    for (auto pObject : visibleObjects)
-    {
-      EZ_TEST_BOOL(testFrustum.Overlaps(pObject->GetGlobalBoundsSimd().GetSphere()));
-      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
-      EZ_TEST_BOOL(pObject->IsDynamic());
-      EZ_TEST_BOOL(pObject->GetNumFramesSinceVisible() == 0);
+      ezDynamicArray<const ezGameObject*> parallelObjects;
+      *pThreshold = 1;
+      world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, parallelObjects);
+
+      *pThreshold = iOldThreshold;
+
+      // the parallel path writes its results in the same order as the serial one
+      EZ_TEST_BOOL(!serialObjects.IsEmpty());
+      EZ_TEST_BOOL(serialObjects == parallelObjects);
     }
 
-    // Check for missing objects
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects Occlusion")
     {
-      ezGameObject* pObject = it;
+      queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
 
-      if (testFrustum.GetObjectPosition(pObject->GetGlobalBounds().GetSphere()) == ezVolumePosition::Outside)
+      ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::ZeroVector(), ezVec3::UnitXAxis(), ezVec3::UnitZAxis());
+      ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::Degree(80.0f), 1.0f, 1.0f, 10000.0f, ezClipSpaceDepthRange::ZeroToOne);
+      const ezMat4 viewProjection = projection * lookAt;
+
+      ezFrustum testFrustum;
+      testFrustum.SetFrustum(viewProjection, ezClipSpaceDepthRange::ZeroToOne);
+
+      ezDynamicArray<const ezGameObject*> allObjects;
+      world.GetSpatialSystem()->FindVisibleObjects(testFrustum, queryParams, allObjects);
+
+      // a wall that covers the whole screen
+      const float fWallDistance = 3000.0f;
+      ezBoundingBox wall;
+      wall.SetElements(ezVec3(fWallDistance, -20000.0f, -20000.0f), ezVec3(fWallDistance + 10.0f, 20000.0f, 20000.0f));
+
+      ezOcclusionBuffer occlusionBuffer;
+      occlusionBuffer.Begin(64, 64, viewProjection);
+      occlusionBuffer.RasterizeBox(wall, ezMat4::IdentityMatrix());
+      occlusionBuffer.End();
+
+      EZ_TEST_BOOL(occlusionBuffer.HasOccluders());
+
+      ezSpatialSystem::QueryParams occlusionQueryParams = queryParams;
+      occlusionQueryParams.m_pOcclusionBuffer = &occlusionBuffer;
+
+      ezDynamicArray<const ezGameObject*> unoccludedObjects;
+      world.GetSpatialSystem()->FindVisibleObjects(testFrustum, occlusionQueryParams, unoccludedObjects);
+
+      EZ_TEST_BOOL(!unoccludedObjects.IsEmpty());
+      EZ_TEST_BOOL(unoccludedObjects.GetCount() < allObjects.GetCount());
+
+      ezHashSet<const ezGameObject*> unoccludedSet;
+      for (auto pObject : unoccludedObjects)
       {
-        EZ_TEST_BOOL(pObject->GetNumFramesSinceVisible() >= numUpdates);
+        unoccludedSet.Insert(pObject);
+      }
+
+      for (auto pObject : allObjects)
+      {
+        const ezBoundingSphere sphere = pObject->GetGlobalBounds().GetSphere();
+
+        if (sphere.m_vCenter.x + sphere.m_fRadius < fWallDistance)
+        {
+          // objects in front of the wall must never be culled
+          EZ_TEST_BOOL(unoccludedSet.Contains(pObject));
+        }
+        else if (!unoccludedSet.Contains(pObject))
+        {
+          EZ_TEST_BOOL(sphere.m_vCenter.x - sphere.m_fRadius > fWallDistance);
+        }
       }
     }
 
-    // Move some objects
-    const double range = 500.0f;
+    if (false)
+    {
+      ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+      EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(outputPath.GetData(), "test", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+
+      ezFileWriter fileWriter;
+      if (fileWriter.Open(":output/profiling.json") == EZ_SUCCESS)
+      {
+        ezProfilingSystem::ProfilingData profilingData;
+        ezProfilingSystem::Capture(profilingData);
+        profilingData.Write(fileWriter).IgnoreResult();
+        ezLog::Info("Profiling capture saved to '{0}'.", fileWriter.GetFilePathAbsolute().GetData());
+      }
+    }
 
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Update dynamic objects")
     {
-      if (it->IsDynamic())
+      ezSpatialSystem::QueryParams dynamicQueryParams;
+      dynamicQueryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+      // add a child to some dynamic objects, so that the bounds of more than one hierarchy level change
+      ezDynamicArray<ezGameObject*> children;
+      for (ezUInt32 i = 500; i < objects.GetCount(); i += 4)
       {
-        ezVec3 pos = it->GetLocalPosition();
+        ezGameObjectDesc desc;
+        desc.m_bDynamic = true;
+        desc.m_hParent = objects[i]->GetHandle();
+        desc.m_LocalPosition = ezVec3(0, 0, 50.0f);
 
-        pos.x += (float)rng.DoubleMinMax(-range, range);
-        pos.y += (float)rng.DoubleMinMax(-range, range);
-        pos.z += (float)rng.DoubleMinMax(-range, range);
+        ezGameObject* pChild = nullptr;
+        world.CreateObject(desc, pChild);
+        children.PushBack(pChild);
 
-        it->SetLocalPosition(pos);
+        TestBoundsComponent* pComponent = nullptr;
+        TestBoundsComponent::CreateComponent(pChild, pComponent);
       }
-    }
 
-    world.Update();
+      world.Update();
 
-    // Check that last frame visible doesn't reset entirely after moving
-    for (const ezGameObject* pObject : visibleObjects)
-    {
-      EZ_TEST_BOOL(pObject->GetNumFramesSinceVisible() == 1);
-    }
-  }
+      for (ezUInt32 i = 500; i < objects.GetCount(); ++i)
+      {
+        objects[i]->SetLocalPosition(objects[i]->GetLocalPosition() + ezVec3(5000.0f, -3000.0f, 1000.0f));
+      }
 
-  if (false)
-  {
-    ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
-    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(outputPath.GetData(), "test", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+      world.Update();
 
-    ezFileWriter fileWriter;
-    if (fileWriter.Open(":output/profiling.json") == EZ_SUCCESS)
-    {
-      ezProfilingSystem::ProfilingData profilingData;
-      ezProfilingSystem::Capture(profilingData);
-      profilingData.Write(fileWriter).IgnoreResult();
-      ezLog::Info("Profiling capture saved to '{0}'.", fileWriter.GetFilePathAbsolute().GetData());
-    }
-  }
+      auto CheckFound = [&](ezGameObject* pObject) {
+        ezBoundingSphere testSphere(pObject->GetGlobalPosition(), 1.0f);
 
-  // Test multiple categories for spatial data
-  EZ_TEST_BLOCK(ezTestBlock::Enabled, "MultipleCategories")
-  {
-    for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
-    {
-      ezGameObject* pObject = objects[i];
+        bool bFound = false;
+        world.GetSpatialSystem()->FindObjectsInSphere(testSphere, dynamicQueryParams, [&](ezGameObject* pFoundObject) {
+          bFound |= (pFoundObject == pObject);
+          return bFound ? ezVisitorExecution::Stop : ezVisitorExecution::Continue;
+        });
 
-      TestBoundsComponent* pComponent = nullptr;
-      TestBoundsComponent::CreateComponent(pObject, pComponent);
-      pComponent->m_SpecialCategory = s_SpecialTestCategory;
-    }
+        EZ_TEST_BOOL(bFound);
+      };
 
-    world.Update();
+      for (ezUInt32 i = 500; i < objects.GetCount(); ++i)
+      {
+        CheckFound(objects[i]);
+      }
 
-    ezDynamicArray<ezGameObjectHandle> allObjects;
-    allObjects.Reserve(world.GetObjectCount());
+      for (ezGameObject* pChild : children)
+      {
+        CheckFound(pChild);
+        world.DeleteObjectNow(pChild->GetHandle());
+      }
 
-    for (auto it = world.GetObjects(); it.IsValid(); ++it)
-    {
-      allObjects.PushBack(it->GetHandle());
+      world.Update();
     }
 
-    for (ezUInt32 i = allObjects.GetCount(); i-- > 0;)
+    // Test multiple categories for spatial data
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "MultipleCategories")
     {
-      world.DeleteObjectNow(allObjects[i]);
-    }
+      for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
+      {
+        ezGameObject* pObject = objects[i];
 
-    world.Update();
+        TestBoundsComponent* pComponent = nullptr;
+        TestBoundsComponent::CreateComponent(pObject, pComponent);
+        pComponent->m_SpecialCategory = s_SpecialTestCategory;
+      }
+
+      world.Update();
+
+      ezDynamicArray<ezGameObjectHandle> allObjects;
+      allObjects.Reserve(world.GetObjectCount());
+
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        allObjects.PushBack(it->GetHandle());
+      }
+
+      for (ezUInt32 i = allObjects.GetCount(); i-- > 0;)
+      {
+        world.DeleteObjectNow(allObjects[i]);
+      }
+
+      world.Update();
+    }
   }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+{
+  TestSpatialSystem(ezSpatialSystemType::RegularGrid);
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_LooseOctree)
+{
+  TestSpatialSystem(ezSpatialSystemType::LooseOctree);
 }
@@ -1,6 +1,9 @@
 #include <CoreTest/CoreTestPCH.h>
 
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
+#include <Foundation/Math/Random.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 
@@ -289,3 +292,174 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+namespace
+{
+  enum class SpatialDistribution
+  {
+    SmallProps,     ///< many small objects spread uniformly over a large area
+    PropsAndTerrain ///< small objects mixed with a few huge terrain chunks
+  };
+
+  void GenerateSpatialBounds(SpatialDistribution distribution, ezUInt32 uiNumObjects, ezDynamicArray<ezSimdBBoxSphere>& out_Bounds)
+  {
+    ezRandom rng;
+    rng.Initialize(42);
+
+    const double fRange = 8000.0;
+
+    out_Bounds.Clear();
+    out_Bounds.Reserve(uiNumObjects);
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezVec3 vCenter((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-50.0, 50.0));
+      ezVec3 vHalfExtents((float)rng.DoubleMinMax(0.5, 4.0), (float)rng.DoubleMinMax(0.5, 4.0), (float)rng.DoubleMinMax(0.5, 4.0));
+
+      if (distribution == SpatialDistribution::PropsAndTerrain && (i % 100) == 0)
+      {
+        vHalfExtents.Set(512.0f, 512.0f, 64.0f);
+      }
+
+      ezBoundingBox box;
+      box.SetCenterAndHalfExtents(vCenter, vHalfExtents);
+      out_Bounds.PushBack(ezSimdConversion::ToBBoxSphere(ezBoundingBoxSphere(box)));
+    }
+  }
+
+  void ProfileSpatialSystem(ezSpatialSystem& spatialSystem, const char* szName, const ezDynamicArray<ezSimdBBoxSphere>& bounds)
+  {
+    const ezUInt32 uiNumObjects = bounds.GetCount();
+    const ezUInt32 uiNumQueries = 1000;
+
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezDynamicArray<ezSpatialDataHandle> handles;
+    handles.Reserve(uiNumObjects);
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      handles.PushBack(spatialSystem.CreateSpatialData(bounds[i], nullptr, queryParams.m_uiCategoryBitmask, ezTagSet()));
+    }
+
+    ezTime tDiff = sw.Checkpoint();
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: Inserting %u objects: %.2fms", szName, uiNumObjects, tDiff.GetMilliseconds());
+
+    {
+      ezDynamicArray<ezSimdBBoxSphere> movedBounds;
+      movedBounds.SetCountUninitialized(uiNumObjects);
+
+      ezDynamicArray<ezSpatialSystem::BoundsUpdate> updates;
+      updates.SetCountUninitialized(uiNumObjects);
+
+      const ezSimdVec4f vOffset(3.0f, -2.0f, 0.0f, 0.0f);
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        movedBounds[i] = bounds[i];
+        movedBounds[i].m_CenterAndRadius += vOffset;
+
+        updates[i].m_hData = handles[i];
+        updates[i].m_pBounds = &movedBounds[i];
+      }
+
+      sw.Checkpoint();
+
+      spatialSystem.UpdateSpatialDataBoundsBatch(updates);
+
+      tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: Updating %u objects: %.2fms", szName, uiNumObjects, tDiff.GetMilliseconds());
+    }
+
+    ezRandom rng;
+    rng.Initialize(17);
+
+    ezUInt32 uiNumFound = 0;
+    auto countCallback = [&](ezGameObject*) {
+      ++uiNumFound;
+      return ezVisitorExecution::Continue;
+    };
+
+    sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      ezVec3 vCenter((float)rng.DoubleMinMax(-8000.0, 8000.0), (float)rng.DoubleMinMax(-8000.0, 8000.0), 0.0f);
+      spatialSystem.FindObjectsInSphere(ezBoundingSphere(vCenter, 100.0f), queryParams, countCallback);
+    }
+
+    tDiff = sw.Checkpoint();
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: %u sphere queries (%u objects found): %.2fms", szName, uiNumQueries, uiNumFound, tDiff.GetMilliseconds());
+
+    uiNumFound = 0;
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      ezVec3 vCenter((float)rng.DoubleMinMax(-8000.0, 8000.0), (float)rng.DoubleMinMax(-8000.0, 8000.0), 0.0f);
+
+      ezBoundingBox box;
+      box.SetCenterAndHalfExtents(vCenter, ezVec3(100.0f));
+      spatialSystem.FindObjectsInBox(box, queryParams, countCallback);
+    }
+
+    tDiff = sw.Checkpoint();
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: %u box queries (%u objects found): %.2fms", szName, uiNumQueries, uiNumFound, tDiff.GetMilliseconds());
+
+    uiNumFound = 0;
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    for (ezUInt32 i = 0; i < uiNumQueries / 10; ++i)
+    {
+      ezVec3 vPosition((float)rng.DoubleMinMax(-8000.0, 8000.0), (float)rng.DoubleMinMax(-8000.0, 8000.0), 10.0f);
+      ezVec3 vForward((float)rng.DoubleMinMax(-1.0, 1.0), (float)rng.DoubleMinMax(-1.0, 1.0), 0.0f);
+      vForward.NormalizeIfNotZero(ezVec3(1, 0, 0)).IgnoreResult();
+
+      ezFrustum frustum;
+      frustum.SetFrustum(vPosition, vForward, ezVec3(0, 0, 1), ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, 1000.0f);
+
+      visibleObjects.Clear();
+      spatialSystem.FindVisibleObjects(frustum, queryParams, visibleObjects);
+
+      uiNumFound += visibleObjects.GetCount();
+    }
+
+    tDiff = sw.Checkpoint();
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: %u frustum queries (%u objects found): %.2fms", szName, uiNumQueries / 10, uiNumFound, tDiff.GetMilliseconds());
+
+    for (auto& hData : handles)
+    {
+      spatialSystem.DeleteSpatialData(hData);
+    }
+  }
+
+  void ProfileSpatialSystems(SpatialDistribution distribution)
+  {
+    ezDynamicArray<ezSimdBBoxSphere> bounds;
+    GenerateSpatialBounds(distribution, 200000, bounds);
+
+    {
+      ezSpatialSystem_RegularGrid grid;
+      ProfileSpatialSystem(grid, "Regular Grid", bounds);
+    }
+
+    {
+      ezSpatialSystem_LooseOctree octree;
+      ProfileSpatialSystem(octree, "Loose Octree", bounds);
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystem)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Small props")
+  {
+    ProfileSpatialSystems(SpatialDistribution::SmallProps);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Props and terrain chunks")
+  {
+    ProfileSpatialSystems(SpatialDistribution::PropsAndTerrain);
+  }
+}
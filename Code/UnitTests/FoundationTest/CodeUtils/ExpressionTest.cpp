@@ -6,6 +6,7 @@
 #include <Foundation/CodeUtils/Expression/ExpressionVM.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Utilities/DGMLWriter.h>
 
 namespace
@@ -208,4 +209,306 @@ EZ_CREATE_SIMPLE_TEST(CodeUtils, Expression)
     const float d = 40;
     EZ_TEST_FLOAT(Execute(testByteCode, a, b, c, d), 55.0f, ezMath::DefaultEpsilon<float>());
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Common subexpressions")
+  {
+    ezExpressionByteCode referenceByteCode;
+    {
+      ezStringView code = "var s = sin(a + b); output = s * c + s * d";
+      Compile(code, referenceByteCode);
+    }
+
+    ezExpressionByteCode testByteCode;
+
+    ezStringView code = "output = sin(a + b) * c + sin(a + b - 0) * d";
+    Compile(code, testByteCode);
+    EZ_TEST_BOOL(CompareByteCode(testByteCode, referenceByteCode));
+
+    const float a = 1;
+    const float b = 2;
+    const float c = 3;
+    const float d = 4;
+    EZ_TEST_FLOAT(Execute(testByteCode, a, b, c, d), ezMath::Sin(ezAngle::Radian(a + b)) * (c + d), ezMath::LargeEpsilon<float>());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Strength reduction")
+  {
+    ezExpressionByteCode referenceByteCode;
+    {
+      ezStringView code = "output = min(abs(a), 2) * 6";
+      Compile(code, referenceByteCode);
+    }
+
+    ezExpressionByteCode testByteCode;
+
+    ezStringView code = "output = min(min(abs(abs((a - 0) * 1)), 4), 2) * 6";
+    Compile(code, testByteCode);
+    EZ_TEST_BOOL(CompareByteCode(testByteCode, referenceByteCode));
+
+    EZ_TEST_FLOAT(Execute(testByteCode, -5.0f), 12.0f, ezMath::DefaultEpsilon<float>());
+    EZ_TEST_FLOAT(Execute(testByteCode, -1.0f), 6.0f, ezMath::DefaultEpsilon<float>());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Strength reduction keeps float semantics")
+  {
+    auto CompileUnoptimized = [&](ezStringView code, ezExpressionByteCode& out_ByteCode) {
+      compiler.SetOptimizationsEnabled(false);
+      Compile(code, out_ByteCode);
+      compiler.SetOptimizationsEnabled(true);
+    };
+
+    // Merging the constants would round differently: 1 + (2 + 2^25) == 2^25, but 3 + 2^25 == 2^25 + 4
+    {
+      ezStringView code = "output = 1 + (2 + a)";
+
+      ezExpressionByteCode referenceByteCode;
+      CompileUnoptimized(code, referenceByteCode);
+
+      ezExpressionByteCode testByteCode;
+      Compile(code, testByteCode);
+
+      const float a = 33554432.0f;
+      EZ_TEST_FLOAT(Execute(referenceByteCode, a), 33554432.0f, 0.0f);
+      EZ_TEST_FLOAT(Execute(testByteCode, a), Execute(referenceByteCode, a), 0.0f);
+    }
+
+    // x + 0 turns -0 into +0, so it must not be removed
+    {
+      ezStringView code = "output = a + 0";
+
+      ezExpressionByteCode referenceByteCode;
+      CompileUnoptimized(code, referenceByteCode);
+
+      ezExpressionByteCode testByteCode;
+      Compile(code, testByteCode);
+
+      EZ_TEST_BOOL(!std::signbit(Execute(referenceByteCode, -0.0f)));
+      EZ_TEST_BOOL(!std::signbit(Execute(testByteCode, -0.0f)));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Multiply-add")
+  {
+    ezStringView code = "output = a * b + c";
+
+    ezExpressionByteCode referenceByteCode;
+    compiler.SetOptimizationsEnabled(false);
+    Compile(code, referenceByteCode);
+    compiler.SetOptimizationsEnabled(true);
+
+    ezExpressionByteCode testByteCode;
+    Compile(code, testByteCode);
+
+    // 3 loads, 1 store and a single multiply-add instead of a multiplication and an addition
+    EZ_TEST_INT(referenceByteCode.GetNumInstructions(), 6);
+    EZ_TEST_INT(testByteCode.GetNumInstructions(), 5);
+
+    ezStringBuilder sDiff;
+    testByteCode.DisassembleDiff(referenceByteCode, sDiff);
+    EZ_TEST_BOOL(sDiff.FindSubString("+ MulAdd_RRR") != nullptr);
+    EZ_TEST_BOOL(sDiff.FindSubString("- Mul_RR") != nullptr);
+    EZ_TEST_BOOL(sDiff.FindSubString("- Add_RR") != nullptr);
+    EZ_TEST_BOOL(sDiff.FindSubString("  Load") != nullptr);
+
+    EZ_TEST_FLOAT(Execute(referenceByteCode, 2, 3, 4), 10.0f, ezMath::DefaultEpsilon<float>());
+    EZ_TEST_FLOAT(Execute(testByteCode, 2, 3, 4), 10.0f, ezMath::DefaultEpsilon<float>());
+
+    // The constant is passed in place as first operand
+    code = "output = (a * 2 + b) + (3 * c + d)";
+    Compile(code, testByteCode);
+    EZ_TEST_INT(testByteCode.GetNumInstructions(), 8);
+    EZ_TEST_FLOAT(Execute(testByteCode, 1, 2, 3, 4), 17.0f, ezMath::DefaultEpsilon<float>());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Dead stores")
+  {
+    ezExpressionByteCode referenceByteCode;
+    {
+      ezStringView code = "output = a * 2";
+      Compile(code, referenceByteCode);
+    }
+
+    ezExpressionAST ast;
+    auto pInput = ast.CreateInput(s_sA, ezProcessingStream::DataType::Float);
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sOutput, ezProcessingStream::DataType::Float, ast.CreateUnaryOperator(ezExpressionAST::NodeType::Sqrt, pInput)));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sOutput, ezProcessingStream::DataType::Float, ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pInput, ast.CreateConstant(2.0f))));
+
+    ezExpressionByteCode testByteCode;
+    EZ_TEST_BOOL(compiler.Compile(ast, testByteCode).Succeeded());
+    EZ_TEST_BOOL(CompareByteCode(testByteCode, referenceByteCode));
+
+    EZ_TEST_FLOAT(Execute(testByteCode, 3.0f), 6.0f, ezMath::DefaultEpsilon<float>());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Function constant folding")
+  {
+    vm.RegisterDefaultFunctions();
+
+    ezExpressionByteCode referenceByteCode;
+    {
+      ezStringView code = "output = Random(a, 7) * 2";
+      Compile(code, referenceByteCode);
+    }
+
+    EZ_TEST_INT(referenceByteCode.GetFunctions().GetCount(), 1);
+    const float fExpectedValue = Execute(referenceByteCode, 3.0f);
+
+    // Functions are only folded if they are registered with the compiler
+    compiler.RegisterDefaultFunctions();
+
+    ezExpressionByteCode testByteCode;
+
+    ezStringView code = "output = Random(2 + 1, 7) * 2";
+    Compile(code, testByteCode);
+    EZ_TEST_INT(testByteCode.GetFunctions().GetCount(), 0);
+    EZ_TEST_INT(testByteCode.GetNumInstructions(), 2);
+
+    EZ_TEST_FLOAT(Execute(testByteCode), fExpectedValue, 0.0f);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(CodeUtils, ExpressionVMExecutionModes)
+{
+  // These expressions are built like the ones that the ProcGen nodes generate for the sample graphs:
+  // perlin noise remapped to a range, height and slope ranges with fade out, blended together, and random values per point.
+  const char* szPlacementGraph = "var noise = PerlinNoise(px / 50 + 0.3, py / 50 + 0.7, pz / 50, 3) * 1.5 - 0.25\n"
+                                 "var height = saturate(min((pz + 10) / 42, (200 - pz) / 42))\n"
+                                 "var slope = saturate(min((acos(min(1, nz)) + 0.0001) / 0.0001, (1.05 - acos(min(1, nz))) / 0.21))\n"
+                                 "density = saturate(noise * height * slope)\n"
+                                 "scale = Random(pointIndex, 11)\n"
+                                 "colorIndex = Random(pointIndex, 13)\n"
+                                 "objectIndex = Random(pointIndex, 17)";
+
+  const char* szVertexColorGraph = "var noise = PerlinNoise(px / 10, py / 10, pz / 10, 2)\n"
+                                   "var height = saturate(min((pz - 5) / 20, (100 - pz) / 20))\n"
+                                   "density = max(noise * 0.5 + 0.5 * height, abs(sin(px * 0.1) * cos(py * 0.1)))\n"
+                                   "scale = sqrt(abs(px * py)) / (1 + abs(pz))\n"
+                                   "colorIndex = clamp(nz * noise, 0, 1)\n"
+                                   "objectIndex = Random(px, 3)";
+
+  static ezHashedString s_sInputs[] = {ezMakeHashedString("px"), ezMakeHashedString("py"), ezMakeHashedString("pz"), ezMakeHashedString("nz"), ezMakeHashedString("pointIndex")};
+  static ezHashedString s_sOutputs[] = {ezMakeHashedString("density"), ezMakeHashedString("scale"), ezMakeHashedString("colorIndex"), ezMakeHashedString("objectIndex")};
+
+  constexpr ezUInt32 uiNumInputs = EZ_ARRAY_SIZE(s_sInputs);
+  constexpr ezUInt32 uiNumOutputs = EZ_ARRAY_SIZE(s_sOutputs);
+
+  // not a multiple of 4 to test the last partially filled register
+  constexpr ezUInt32 uiNumInstances = 100003;
+
+  ezDynamicArray<float> inputData[uiNumInputs];
+  for (auto& data : inputData)
+  {
+    data.SetCountUninitialized(uiNumInstances);
+  }
+
+  for (ezUInt32 i = 0; i < uiNumInstances; ++i)
+  {
+    inputData[0][i] = static_cast<float>(i % 317) * 1.3f;
+    inputData[1][i] = static_cast<float>(i / 317) * 1.3f;
+    inputData[2][i] = ezMath::Sin(ezAngle::Radian(i * 0.01f)) * 150.0f + 50.0f;
+    inputData[3][i] = ezMath::Cos(ezAngle::Radian(i * 0.003f)) * 0.5f + 0.5f;
+    inputData[4][i] = static_cast<float>(i);
+  }
+
+  ezExpressionParser::Stream inputStreamDescs[uiNumInputs] = {
+    ezExpressionParser::Stream(s_sInputs[0].GetData(), ezProcessingStream::DataType::Float),
+    ezExpressionParser::Stream(s_sInputs[1].GetData(), ezProcessingStream::DataType::Float),
+    ezExpressionParser::Stream(s_sInputs[2].GetData(), ezProcessingStream::DataType::Float),
+    ezExpressionParser::Stream(s_sInputs[3].GetData(), ezProcessingStream::DataType::Float),
+    ezExpressionParser::Stream(s_sInputs[4].GetData(), ezProcessingStream::DataType::Float),
+  };
+
+  ezExpressionParser::Stream outputStreamDescs[uiNumOutputs] = {
+    ezExpressionParser::Stream(s_sOutputs[0].GetData(), ezProcessingStream::DataType::Float),
+    ezExpressionParser::Stream(s_sOutputs[1].GetData(), ezProcessingStream::DataType::Float),
+    ezExpressionParser::Stream(s_sOutputs[2].GetData(), ezProcessingStream::DataType::Float),
+    ezExpressionParser::Stream(s_sOutputs[3].GetData(), ezProcessingStream::DataType::Float),
+  };
+
+  ezHybridArray<ezProcessingStream, 8> inputs;
+  for (ezUInt32 i = 0; i < uiNumInputs; ++i)
+  {
+    inputs.PushBack(ezProcessingStream(s_sInputs[i], inputData[i].GetByteArrayPtr(), ezProcessingStream::DataType::Float));
+  }
+
+  ezExpressionParser parser;
+  ezExpressionCompiler compiler;
+  ezExpressionVM vm;
+  vm.RegisterDefaultFunctions();
+
+  auto RunGraph = [&](const char* szGraphName, const char* szCode) {
+    ezExpressionAST ast;
+    EZ_TEST_BOOL(parser.Parse(szCode, inputStreamDescs, outputStreamDescs, {}, ast).Succeeded());
+
+    ezExpressionByteCode byteCode;
+    EZ_TEST_BOOL(compiler.Compile(ast, byteCode).Succeeded());
+
+    struct Mode
+    {
+      ezExpressionVM::ExecutionMode::Enum m_ExecutionMode;
+      ezExpressionVM::InstructionSet::Enum m_InstructionSet;
+      const char* m_szName;
+    };
+
+    // the wide instruction sets fall back to SSE if the CPU does not support them
+    const Mode modes[] = {
+      {ezExpressionVM::ExecutionMode::SingleBlock, ezExpressionVM::InstructionSet::SSE, "SingleBlock SSE"},
+      {ezExpressionVM::ExecutionMode::Tiled, ezExpressionVM::InstructionSet::SSE, "Tiled SSE"},
+      {ezExpressionVM::ExecutionMode::TiledParallel, ezExpressionVM::InstructionSet::SSE, "TiledParallel SSE"},
+      {ezExpressionVM::ExecutionMode::Tiled, ezExpressionVM::InstructionSet::AVX2, "Tiled AVX2"},
+      {ezExpressionVM::ExecutionMode::Tiled, ezExpressionVM::InstructionSet::AVX512, "Tiled AVX512"},
+      {ezExpressionVM::ExecutionMode::TiledParallel, ezExpressionVM::InstructionSet::AVX512, "TiledParallel AVX512"},
+    };
+
+    ezDynamicArray<float> outputData[EZ_ARRAY_SIZE(modes)][uiNumOutputs];
+
+    for (ezUInt32 uiMode = 0; uiMode < EZ_ARRAY_SIZE(modes); ++uiMode)
+    {
+      ezHybridArray<ezProcessingStream, 8> outputs;
+      for (ezUInt32 i = 0; i < uiNumOutputs; ++i)
+      {
+        outputData[uiMode][i].SetCount(uiNumInstances);
+        outputs.PushBack(ezProcessingStream(s_sOutputs[i], outputData[uiMode][i].GetByteArrayPtr(), ezProcessingStream::DataType::Float));
+      }
+
+      vm.SetExecutionMode(modes[uiMode].m_ExecutionMode);
+      vm.SetMaxInstructionSet(modes[uiMode].m_InstructionSet);
+
+      // first run allocates the registers
+      EZ_TEST_BOOL(vm.Execute(byteCode, inputs, outputs, uiNumInstances).Succeeded());
+
+      constexpr ezUInt32 uiNumRuns = 10;
+
+      ezStopwatch sw;
+      for (ezUInt32 uiRun = 0; uiRun < uiNumRuns; ++uiRun)
+      {
+        vm.Execute(byteCode, inputs, outputs, uiNumInstances).IgnoreResult();
+      }
+      const ezTime tDiff = sw.Checkpoint();
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s graph, %s: %.3fms per %u instances", szGraphName, modes[uiMode].m_szName, tDiff.GetMilliseconds() / uiNumRuns, uiNumInstances);
+    }
+
+    vm.SetExecutionMode(ezExpressionVM::ExecutionMode::Default);
+    vm.SetMaxInstructionSet(ezExpressionVM::InstructionSet::Default);
+
+    // all modes and instruction sets must produce exactly the same results
+    for (ezUInt32 uiMode = 1; uiMode < EZ_ARRAY_SIZE(modes); ++uiMode)
+    {
+      for (ezUInt32 i = 0; i < uiNumOutputs; ++i)
+      {
+        EZ_TEST_BOOL(ezMemoryUtils::IsEqual(outputData[uiMode][i].GetData(), outputData[0][i].GetData(), uiNumInstances));
+      }
+    }
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Placement")
+  {
+    RunGraph("Placement", szPlacementGraph);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "VertexColor")
+  {
+    RunGraph("VertexColor", szVertexColorGraph);
+  }
 }
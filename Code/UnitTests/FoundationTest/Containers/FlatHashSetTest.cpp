@@ -0,0 +1,261 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Containers/FlatHashSet.h>
+#include <Foundation/Strings/String.h>
+
+namespace FlatHashSetTestDetail
+{
+  typedef ezConstructionCounter st;
+
+  struct Collision
+  {
+    ezUInt32 hash;
+    int key;
+
+    inline Collision(ezUInt32 hash, int key)
+    {
+      this->hash = hash;
+      this->key = key;
+    }
+
+    inline bool operator==(const Collision& other) const { return key == other.key; }
+
+    EZ_DECLARE_POD_TYPE();
+  };
+} // namespace FlatHashSetTestDetail
+
+template <>
+struct ezHashHelper<FlatHashSetTestDetail::Collision>
+{
+  EZ_ALWAYS_INLINE static ezUInt32 Hash(const FlatHashSetTestDetail::Collision& value) { return value.hash; }
+
+  EZ_ALWAYS_INLINE static bool Equal(const FlatHashSetTestDetail::Collision& a, const FlatHashSetTestDetail::Collision& b) { return a == b; }
+};
+
+EZ_CREATE_SIMPLE_TEST(Containers, FlatHashSet)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Constructor")
+  {
+    ezFlatHashSet<ezInt32> table1;
+
+    EZ_TEST_BOOL(table1.GetCount() == 0);
+    EZ_TEST_BOOL(table1.IsEmpty());
+
+    ezUInt32 counter = 0;
+    for (auto it = table1.GetIterator(); it.IsValid(); ++it)
+    {
+      ++counter;
+    }
+    EZ_TEST_INT(counter, 0);
+
+    EZ_TEST_BOOL(begin(table1) == end(table1));
+    EZ_TEST_BOOL(cbegin(table1) == cend(table1));
+    table1.Reserve(10);
+    EZ_TEST_BOOL(begin(table1) == end(table1));
+    EZ_TEST_BOOL(cbegin(table1) == cend(table1));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Copy Constructor/Assignment/Iterator")
+  {
+    ezFlatHashSet<ezInt32> table1;
+
+    for (ezInt32 i = 0; i < 64; ++i)
+    {
+      ezInt32 key;
+
+      do
+      {
+        key = rand() % 100000;
+      } while (table1.Contains(key));
+
+      table1.Insert(key);
+    }
+
+    ezFlatHashSet<ezInt32> table2;
+    table2 = table1;
+    ezFlatHashSet<ezInt32> table3(table1);
+
+    EZ_TEST_INT(table1.GetCount(), 64);
+    EZ_TEST_INT(table2.GetCount(), 64);
+    EZ_TEST_INT(table3.GetCount(), 64);
+    EZ_TEST_BOOL(table1 == table2);
+    EZ_TEST_BOOL(table1 == table3);
+
+    ezUInt32 uiCounter = 0;
+    for (const auto& value : table1)
+    {
+      EZ_TEST_BOOL(table2.Contains(value));
+      EZ_TEST_BOOL(table3.Contains(value));
+      ++uiCounter;
+    }
+    EZ_TEST_INT(uiCounter, table1.GetCount());
+
+    table2.Remove(*begin(table1));
+    EZ_TEST_BOOL(table1 != table2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Move Copy Constructor/Assignment")
+  {
+    ezFlatHashSet<FlatHashSetTestDetail::st> set1;
+    for (ezInt32 i = 0; i < 64; ++i)
+    {
+      set1.Insert(ezConstructionCounter(i));
+    }
+
+    ezUInt64 memoryUsage = set1.GetHeapMemoryUsage();
+
+    ezFlatHashSet<FlatHashSetTestDetail::st> set2;
+    set2 = std::move(set1);
+
+    EZ_TEST_INT(set1.GetCount(), 0);
+    EZ_TEST_INT(set1.GetHeapMemoryUsage(), 0);
+    EZ_TEST_INT(set2.GetCount(), 64);
+    EZ_TEST_INT(set2.GetHeapMemoryUsage(), memoryUsage);
+
+    ezFlatHashSet<FlatHashSetTestDetail::st> set3(std::move(set2));
+
+    EZ_TEST_INT(set2.GetCount(), 0);
+    EZ_TEST_INT(set2.GetHeapMemoryUsage(), 0);
+    EZ_TEST_INT(set3.GetCount(), 64);
+    EZ_TEST_INT(set3.GetHeapMemoryUsage(), memoryUsage);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Collision Tests")
+  {
+    ezFlatHashSet<FlatHashSetTestDetail::Collision> set2;
+
+    for (int i = 0; i < 40; ++i)
+    {
+      EZ_TEST_BOOL(!set2.Insert(FlatHashSetTestDetail::Collision(i % 2, i)));
+    }
+
+    for (int i = 0; i < 40; i += 3)
+    {
+      EZ_TEST_BOOL(set2.Remove(FlatHashSetTestDetail::Collision(i % 2, i)));
+    }
+
+    for (int i = 0; i < 40; ++i)
+    {
+      EZ_TEST_BOOL(set2.Contains(FlatHashSetTestDetail::Collision(i % 2, i)) == ((i % 3) != 0));
+    }
+
+    EZ_TEST_INT(set2.GetCount(), 26);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Clear")
+  {
+    EZ_TEST_BOOL(FlatHashSetTestDetail::st::HasAllDestructed());
+
+    {
+      ezFlatHashSet<FlatHashSetTestDetail::st> m1;
+      m1.Insert(FlatHashSetTestDetail::st(1));
+      EZ_TEST_BOOL(FlatHashSetTestDetail::st::HasDone(2, 1)); // for inserting new elements 1 temporary is created (and destroyed)
+
+      m1.Insert(FlatHashSetTestDetail::st(3));
+      EZ_TEST_BOOL(FlatHashSetTestDetail::st::HasDone(2, 1)); // for inserting new elements 2 temporary is created (and destroyed)
+
+      m1.Insert(FlatHashSetTestDetail::st(1));
+      EZ_TEST_BOOL(FlatHashSetTestDetail::st::HasDone(1, 1)); // nothing new to create, so only the one temporary is used
+
+      m1.Clear();
+      EZ_TEST_BOOL(FlatHashSetTestDetail::st::HasDone(0, 2));
+      EZ_TEST_BOOL(FlatHashSetTestDetail::st::HasAllDestructed());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Insert/Remove/Compact")
+  {
+    ezFlatHashSet<ezInt32> a;
+
+    EZ_TEST_BOOL(a.GetHeapMemoryUsage() == 0);
+
+    for (ezInt32 i = 0; i < 1000; ++i)
+    {
+      EZ_TEST_BOOL(!a.Insert(i));
+      EZ_TEST_INT(a.GetCount(), i + 1);
+    }
+
+    for (ezInt32 i = 0; i < 1000; ++i)
+    {
+      EZ_TEST_BOOL(a.Insert(i));
+    }
+
+    EZ_TEST_BOOL(a.GetHeapMemoryUsage() >= 1000 * (sizeof(ezInt32)));
+
+    for (ezInt32 i = 0; i < 500; ++i)
+    {
+      EZ_TEST_BOOL(a.Remove(i));
+    }
+
+    a.Compact();
+
+    for (ezInt32 i = 0; i < 1000; ++i)
+    {
+      EZ_TEST_BOOL(a.Contains(i) == (i >= 500));
+    }
+
+    a.Clear();
+    a.Compact();
+
+    EZ_TEST_BOOL(a.GetHeapMemoryUsage() == 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Remove (Iterator)")
+  {
+    ezFlatHashSet<ezInt32> a;
+
+    for (ezInt32 i = 0; i < 1000; ++i)
+      a.Insert(i);
+
+    ezFlatHashSet<ezInt32>::ConstIterator it = a.GetIterator();
+
+    for (ezInt32 i = 0; i < 1000 - 1; ++i)
+    {
+      ezInt32 value = it.Key();
+      it = a.Remove(it);
+      EZ_TEST_BOOL(!a.Contains(value));
+      EZ_TEST_BOOL(it.IsValid());
+      EZ_TEST_INT(a.GetCount(), 1000 - 1 - i);
+    }
+    it = a.Remove(it);
+    EZ_TEST_BOOL(!it.IsValid());
+    EZ_TEST_BOOL(a.IsEmpty());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CompatibleKeyType / Find")
+  {
+    ezFlatHashSet<ezString> set;
+    ezStringBuilder tmp;
+
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      tmp.Format("stuff{}bla", i);
+      set.Insert(tmp);
+    }
+
+    EZ_TEST_BOOL(set.Contains("stuff42bla"));
+    EZ_TEST_BOOL(!set.Contains("stuff100bla"));
+    EZ_TEST_STRING(set.Find(ezStringView("stuff7bla")).Key(), "stuff7bla");
+    EZ_TEST_BOOL(!set.Find("nothing").IsValid());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Swap")
+  {
+    ezFlatHashSet<ezInt32> set1;
+    ezFlatHashSet<ezInt32> set2;
+
+    for (ezInt32 i = 0; i < 100; ++i)
+    {
+      set1.Insert(i);
+      set2.Insert(-i - 1);
+    }
+
+    set1.Swap(set2);
+
+    for (ezInt32 i = 0; i < 100; ++i)
+    {
+      EZ_TEST_BOOL(set2.Contains(i));
+      EZ_TEST_BOOL(set1.Contains(-i - 1));
+    }
+  }
+}
@@ -52,6 +52,54 @@ protected:
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(AddOneStreamProcessor, 1, ezRTTIDefaultAllocator<AddOneStreamProcessor>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+// Processors for testing the parallel processing
+
+class ParallelAddOneStreamProcessor : public AddOneStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ParallelAddOneStreamProcessor, AddOneStreamProcessor);
+
+protected:
+  virtual bool SupportsParallelProcessing() const override { return true; }
+
+  virtual void Process(ezUInt64 uiNumElements) override { ProcessRange(0, uiNumElements); }
+
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, uiStartIndex);
+
+    while (!streamIterator.HasReachedEnd())
+    {
+      streamIterator.Current() += 1.0f;
+
+      streamIterator.Advance();
+    }
+  }
+};
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ParallelAddOneStreamProcessor, 1, ezRTTIDefaultAllocator<ParallelAddOneStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+class DoubleStreamProcessor : public AddOneStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(DoubleStreamProcessor, AddOneStreamProcessor);
+
+protected:
+  virtual void Process(ezUInt64 uiNumElements) override
+  {
+    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, 0);
+
+    while (!streamIterator.HasReachedEnd())
+    {
+      streamIterator.Current() *= 2.0f;
+
+      streamIterator.Advance();
+    }
+  }
+};
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(DoubleStreamProcessor, 1, ezRTTIDefaultAllocator<DoubleStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
 EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
 {
   ezProcessingStreamGroup Group;
@@ -157,3 +205,64 @@ EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ParallelProcessing)
+{
+  ezProcessingStreamGroup Group;
+  ezProcessingStream* pStream = Group.AddStream("Stream", ezProcessingStream::DataType::Float);
+
+  ezProcessingStreamSpawnerZeroInitialized* pSpawner = EZ_DEFAULT_NEW(ezProcessingStreamSpawnerZeroInitialized);
+  pSpawner->SetStreamName(pStream->GetName());
+  Group.AddProcessor(pSpawner);
+
+  // parallel processors before and after a sequential one, which must see the results of all chunks
+  ezProcessingStreamProcessor* pProcessors[3] = {
+    EZ_DEFAULT_NEW(ParallelAddOneStreamProcessor), EZ_DEFAULT_NEW(DoubleStreamProcessor), EZ_DEFAULT_NEW(ParallelAddOneStreamProcessor)};
+
+  for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(pProcessors); ++i)
+  {
+    static_cast<AddOneStreamProcessor*>(pProcessors[i])->SetStreamName(pStream->GetName());
+    pProcessors[i]->m_fPriority = static_cast<float>(i);
+    Group.AddProcessor(pProcessors[i]);
+  }
+
+  Group.SetSize(1000);
+  Group.SetParallelProcessingChunkSize(64);
+  EZ_TEST_INT(Group.GetParallelProcessingChunkSize(), 64);
+
+  Group.InitializeElements(1000);
+  Group.Process();
+
+  EZ_TEST_INT(Group.GetNumActiveElements(), 1000);
+
+  Group.Process();
+
+  {
+    ezProcessingStreamIterator<float> streamIterator(pStream, Group.GetNumActiveElements(), 0);
+
+    int iElementsVisited = 0;
+    while (!streamIterator.HasReachedEnd())
+    {
+      EZ_TEST_FLOAT(streamIterator.Current(), 3.0f, 0.0f);
+
+      streamIterator.Advance();
+      iElementsVisited++;
+    }
+
+    EZ_TEST_INT(iElementsVisited, 1000);
+  }
+
+  // processing on the calling thread must give the same result, (3 + 1) * 2 + 1
+  Group.SetParallelProcessingChunkSize(0);
+  Group.Process();
+
+  {
+    ezProcessingStreamIterator<float> streamIterator(pStream, Group.GetNumActiveElements(), 0);
+    while (!streamIterator.HasReachedEnd())
+    {
+      EZ_TEST_FLOAT(streamIterator.Current(), 9.0f, 0.0f);
+
+      streamIterator.Advance();
+    }
+  }
+}
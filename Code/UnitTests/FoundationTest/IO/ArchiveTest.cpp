@@ -1,6 +1,8 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/Archive/ArchiveBuilder.h>
+#include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/Archive/DataDirTypeArchive.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
@@ -153,6 +155,165 @@ EZ_CREATE_SIMPLE_TEST(IO, Archive)
       return;
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mapped Content")
+  {
+    ezStringBuilder sFileSrc;
+    ezStringBuilder sFileDst;
+    ezDynamicArray<ezUInt8> srcContent;
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < EZ_ARRAY_SIZE(szFileList); ++uiFileIdx)
+    {
+      sFileSrc.Set(":output/", szTestData, "/", szFileList[uiFileIdx]);
+      sFileDst.Set(":archive/", szFileList[uiFileIdx]);
+
+      ezFileReader src;
+      ezFileReader dst;
+      EZ_TEST_BOOL(src.Open(sFileSrc).Succeeded());
+      EZ_TEST_BOOL(dst.Open(sFileDst).Succeeded());
+
+      // the folder data directory never has the content in memory
+      EZ_TEST_BOOL(src.GetMappedContent().GetPtr() == nullptr);
+
+      const ezArrayPtr<const ezUInt8> mapped = dst.GetMappedContent();
+
+      // files that are stored uncompressed are directly accessible
+      const ezStringView sExt = ezPathUtils::GetFileExtension(szFileList[uiFileIdx]);
+      if (sExt == "jpg" || sExt == "zip")
+      {
+        EZ_TEST_BOOL(mapped.GetPtr() != nullptr);
+      }
+
+      if (mapped.GetPtr() == nullptr)
+        continue;
+
+      srcContent.SetCountUninitialized(static_cast<ezUInt32>(src.GetFileSize()));
+      EZ_TEST_INT(src.ReadBytes(srcContent.GetData(), srcContent.GetCount()), srcContent.GetCount());
+
+      EZ_TEST_INT(mapped.GetCount(), srcContent.GetCount());
+      EZ_TEST_BOOL(mapped == srcContent.GetArrayPtr());
+    }
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("Clear");
+}
+
+#endif
+
+#if (EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && defined(BUILDSYSTEM_ENABLE_ZSTD_SUPPORT))
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveDictionary)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveDictionaryTest");
+  sOutputFolder.MakeCleanPath();
+
+  // make sure it is empty
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+  ezOSFile::CreateDirectoryStructure(sOutputFolder).IgnoreResult();
+
+  if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "Clear", "output", ezFileSystem::AllowWrites).Succeeded()))
+    return;
+
+  // many small files with similar content, that is what the dictionary is good for
+  const ezUInt32 uiNumFiles = 128;
+  const char* szWords[] = {"Position", "Rotation", "Scale", "Material", "Mesh", "Texture", "Color", "Enabled", "Children", "Component"};
+
+  ezStringBuilder sFile;
+  ezStringBuilder sContent;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Generate Data")
+  {
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < uiNumFiles; ++uiFileIdx)
+    {
+      sContent.Clear();
+      for (ezUInt32 i = 0; i < 40; ++i)
+      {
+        sContent.AppendFormat("{} = {}; // {}\n", szWords[(uiFileIdx + i) % EZ_ARRAY_SIZE(szWords)], uiFileIdx * 7 + i, szWords[(uiFileIdx * 3 + i) % EZ_ARRAY_SIZE(szWords)]);
+      }
+
+      sFile.Format(":output/Data/Folder{}/File{}.txt", uiFileIdx % 4, uiFileIdx);
+
+      ezFileWriter file;
+      if (!EZ_TEST_BOOL(file.Open(sFile).Succeeded()))
+        return;
+
+      EZ_TEST_BOOL(file.WriteBytes(sContent.GetData(), sContent.GetElementCount()).Succeeded());
+    }
+  }
+
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Data.ezArchive");
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    ezArchiveBuilder builder;
+    builder.m_uiCompressionDictionarySize = 8 * 1024;
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < uiNumFiles; ++uiFileIdx)
+    {
+      auto& entry = builder.m_Entries.ExpandAndGetRef();
+      entry.m_sAbsSourcePath = ezStringBuilder().Format("{}/Data/Folder{}/File{}.txt", sOutputFolder, uiFileIdx % 4, uiFileIdx);
+      entry.m_sRelTargetPath = ezStringBuilder().Format("Folder{}/File{}.txt", uiFileIdx % 4, uiFileIdx);
+      entry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+    }
+
+    EZ_TEST_BOOL(builder.WriteArchive(sArchiveFile).Succeeded());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Archive Version")
+  {
+    ezFileReader file;
+    if (!EZ_TEST_BOOL(file.Open(sArchiveFile).Succeeded()))
+      return;
+
+    ezUInt8 uiVersion = 0;
+    EZ_TEST_BOOL(ezArchiveUtils::ReadHeader(file, uiVersion).Succeeded());
+    EZ_TEST_INT(uiVersion, 6);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read Archive")
+  {
+    ezArchiveReader reader;
+    if (!EZ_TEST_BOOL(reader.OpenArchive(sArchiveFile).Succeeded()))
+      return;
+
+    const ezArchiveTOC& toc = reader.GetArchiveTOC();
+    EZ_TEST_INT(toc.m_Entries.GetCount(), uiNumFiles);
+    EZ_TEST_BOOL(!toc.m_CompressionDictionary.IsEmpty());
+    EZ_TEST_BOOL(reader.GetCompressionDictionary() != nullptr);
+
+    ezUInt32 uiNumDictionaryEntries = 0;
+    ezDynamicArray<ezUInt8> srcContent;
+    ezDynamicArray<ezUInt8> dstContent;
+
+    for (ezUInt32 uiFileIdx = 0; uiFileIdx < uiNumFiles; ++uiFileIdx)
+    {
+      const ezUInt32 uiEntryIdx = toc.FindEntry(ezStringBuilder().Format("Folder{}/File{}.txt", uiFileIdx % 4, uiFileIdx));
+      if (!EZ_TEST_BOOL(uiEntryIdx != ezInvalidIndex))
+        continue;
+
+      if (toc.m_Entries[uiEntryIdx].m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_dictionary)
+        ++uiNumDictionaryEntries;
+
+      sFile.Format(":output/Data/Folder{}/File{}.txt", uiFileIdx % 4, uiFileIdx);
+
+      ezFileReader src;
+      if (!EZ_TEST_BOOL(src.Open(sFile).Succeeded()))
+        continue;
+
+      srcContent.SetCountUninitialized(static_cast<ezUInt32>(src.GetFileSize()));
+      EZ_TEST_INT(src.ReadBytes(srcContent.GetData(), srcContent.GetCount()), srcContent.GetCount());
+
+      ezUniquePtr<ezStreamReader> pDst = reader.CreateEntryReader(uiEntryIdx);
+      dstContent.SetCountUninitialized(srcContent.GetCount() + 1);
+      EZ_TEST_INT(pDst->ReadBytes(dstContent.GetData(), dstContent.GetCount()), srcContent.GetCount());
+      dstContent.SetCountUninitialized(srcContent.GetCount());
+
+      EZ_TEST_BOOL(dstContent == srcContent);
+    }
+
+    EZ_TEST_BOOL(uiNumDictionaryEntries > 0);
+  }
+
   ezFileSystem::RemoveDataDirectoryGroup("Clear");
 }
 
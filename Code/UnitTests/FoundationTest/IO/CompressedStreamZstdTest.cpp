@@ -1,6 +1,8 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
+#include <Foundation/IO/Archive/ArchiveChunkedEntryReader.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/CompressionDictionaryZstd.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/Stream.h>
 
@@ -136,4 +138,179 @@ EZ_CREATE_SIMPLE_TEST(IO, CompressedStreamZstd)
   }
 }
 
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveChunkedEntryReader)
+{
+  // a counting sequence, so that every position in the data has a unique value
+  ezDynamicArray<ezUInt32> TestData;
+  TestData.SetCountUninitialized(1024 * 1024);
+
+  for (ezUInt32 i = 0; i < TestData.GetCount(); ++i)
+  {
+    TestData[i] = i;
+  }
+
+  const ezUInt64 uiDataSize = TestData.GetCount() * sizeof(ezUInt32);
+
+  // deliberately not a multiple of 4, so that reads cross chunk borders at odd positions
+  const ezUInt32 uiChunkSize = 64 * 1024 + 3;
+
+  ezMemoryStreamStorage StreamStorage;
+  ezArchiveChunkedEntryReader ChunkedReader;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "WriteChunkedData")
+  {
+    ezRawMemoryStreamReader source(TestData.GetData(), uiDataSize);
+    ezMemoryStreamWriter writer(&StreamStorage);
+
+    ezUInt64 uiWrittenBytes = 0;
+    EZ_TEST_BOOL(ezArchiveChunkedEntryReader::WriteChunkedData(writer, source, uiDataSize, uiChunkSize, uiWrittenBytes).Succeeded());
+    EZ_TEST_INT(uiWrittenBytes, StreamStorage.GetStorageSize());
+    EZ_TEST_BOOL(uiWrittenBytes < uiDataSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Configure")
+  {
+    {
+      ezMuteLog logIgnore;
+      ezLogSystemScope logScope(&logIgnore);
+
+      // a truncated seek table must be rejected
+      EZ_TEST_BOOL(ChunkedReader.Configure(StreamStorage.GetData(), 12, uiDataSize).Failed());
+
+      // the uncompressed size must match the chunk count
+      EZ_TEST_BOOL(ChunkedReader.Configure(StreamStorage.GetData(), StreamStorage.GetStorageSize(), uiDataSize * 2).Failed());
+    }
+
+    EZ_TEST_BOOL(ChunkedReader.Configure(StreamStorage.GetData(), StreamStorage.GetStorageSize(), uiDataSize).Succeeded());
+    EZ_TEST_INT(ChunkedReader.GetUncompressedDataSize(), uiDataSize);
+    EZ_TEST_INT(ChunkedReader.GetReadPosition(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ReadBytes")
+  {
+    ezDynamicArray<ezUInt32> TestDataRead;
+    TestDataRead.SetCountUninitialized(TestData.GetCount());
+
+    // small reads go through the chunk cache, large reads decompress in parallel
+    EZ_TEST_INT(ChunkedReader.ReadBytes(TestDataRead.GetData(), 10), 10);
+    EZ_TEST_INT(ChunkedReader.ReadBytes(ezMemoryUtils::AddByteOffset(TestDataRead.GetData(), 10), uiDataSize), uiDataSize - 10);
+
+    EZ_TEST_BOOL(TestData == TestDataRead);
+
+    EZ_TEST_INT(ChunkedReader.ReadBytes(TestDataRead.GetData(), 4), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SetReadPosition / SkipBytes")
+  {
+    ChunkedReader.SetReadPosition(0);
+
+    EZ_TEST_INT(ChunkedReader.SkipBytes(uiChunkSize * 3), uiChunkSize * 3);
+    EZ_TEST_INT(ChunkedReader.GetReadPosition(), uiChunkSize * 3);
+
+    ezUInt32 uiValue = 0;
+    for (ezUInt32 uiIndex : {7u, 123456u, 1024u * 1024u - 1u, 0u, 500000u})
+    {
+      ChunkedReader.SetReadPosition(uiIndex * sizeof(ezUInt32));
+      EZ_TEST_INT(ChunkedReader.ReadBytes(&uiValue, sizeof(ezUInt32)), sizeof(ezUInt32));
+      EZ_TEST_INT(uiValue, uiIndex);
+    }
+
+    // a range spanning several whole chunks that does not start at a chunk border
+    ezDynamicArray<ezUInt32> Range;
+    Range.SetCountUninitialized(100000);
+
+    ChunkedReader.SetReadPosition(5000 * sizeof(ezUInt32));
+    EZ_TEST_INT(ChunkedReader.ReadBytes(Range.GetData(), Range.GetCount() * sizeof(ezUInt32)), Range.GetCount() * sizeof(ezUInt32));
+    EZ_TEST_BOOL(Range.GetArrayPtr() == TestData.GetArrayPtr().GetSubArray(5000, Range.GetCount()));
+
+    // skipping past the end is clamped
+    ChunkedReader.SetReadPosition(uiDataSize - 8);
+    EZ_TEST_INT(ChunkedReader.SkipBytes(100), 8);
+    EZ_TEST_INT(ChunkedReader.ReadBytes(&uiValue, sizeof(ezUInt32)), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(IO, CompressionDictionaryZstd)
+{
+  // many small documents that share their structure, similar to serialized assets
+  ezDynamicArray<ezString> Documents;
+  {
+    ezStringBuilder sDoc;
+
+    for (ezUInt32 i = 0; i < 2000; ++i)
+    {
+      sDoc.Format("Material{{ Shader = \"Shaders/Materials/DefaultMaterial.ezShader\", BaseColor = ({0}, {1}, {2}), Roughness = {3}, "
+                  "Metallic = {4}, BaseTexture = \"Textures/Surface{5}_D.dds\", NormalTexture = \"Textures/Surface{5}_N.dds\" }}",
+        i % 7, i % 13, i % 17, i % 5, i % 3, i);
+
+      Documents.PushBack(sDoc);
+    }
+  }
+
+  ezDynamicArray<ezArrayPtr<const ezUInt8>> Samples;
+  for (const ezString& sDoc : Documents)
+  {
+    Samples.PushBack(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(sDoc.GetData()), sDoc.GetElementCount()));
+  }
+
+  ezDynamicArray<ezUInt8> DictionaryData;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Train")
+  {
+    // not enough data
+    EZ_TEST_BOOL(ezCompressionDictionaryZstd::Train(Samples.GetArrayPtr().GetSubArray(0, 10), 16 * 1024, DictionaryData).Failed());
+
+    EZ_TEST_BOOL(ezCompressionDictionaryZstd::Train(Samples, 16 * 1024, DictionaryData).Succeeded());
+    EZ_TEST_BOOL(!DictionaryData.IsEmpty());
+    EZ_TEST_BOOL(DictionaryData.GetCount() <= 16 * 1024);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compress and Decompress")
+  {
+    ezCompressionDictionaryZstd Dictionary(DictionaryData);
+
+    EZ_TEST_BOOL(Dictionary.GetData() == DictionaryData.GetArrayPtr());
+
+    ezUInt64 uiSizeWithDictionary = 0;
+    ezUInt64 uiSizeWithoutDictionary = 0;
+
+    ezCompressedStreamWriterZstd CompressedWriter;
+    ezCompressedStreamReaderZstd CompressedReader;
+    ezDynamicArray<ezUInt8> Decompressed;
+
+    for (const ezArrayPtr<const ezUInt8>& sample : Samples)
+    {
+      ezMemoryStreamStorage StorageWithDict;
+      ezMemoryStreamStorage StorageWithoutDict;
+
+      {
+        ezMemoryStreamWriter MemoryWriter(&StorageWithDict);
+        CompressedWriter.SetOutputStream(&MemoryWriter, ezCompressedStreamWriterZstd::Compression::Default, 4, &Dictionary);
+        EZ_TEST_BOOL(CompressedWriter.WriteBytes(sample.GetPtr(), sample.GetCount()).Succeeded());
+        EZ_TEST_BOOL(CompressedWriter.FinishCompressedStream().Succeeded());
+      }
+
+      {
+        ezMemoryStreamWriter MemoryWriter(&StorageWithoutDict);
+        CompressedWriter.SetOutputStream(&MemoryWriter);
+        EZ_TEST_BOOL(CompressedWriter.WriteBytes(sample.GetPtr(), sample.GetCount()).Succeeded());
+        EZ_TEST_BOOL(CompressedWriter.FinishCompressedStream().Succeeded());
+      }
+
+      uiSizeWithDictionary += StorageWithDict.GetStorageSize();
+      uiSizeWithoutDictionary += StorageWithoutDict.GetStorageSize();
+
+      ezMemoryStreamReader MemoryReader(&StorageWithDict);
+      CompressedReader.SetInputStream(&MemoryReader, &Dictionary);
+
+      Decompressed.SetCountUninitialized(sample.GetCount());
+      EZ_TEST_INT(CompressedReader.ReadBytes(Decompressed.GetData(), sample.GetCount()), sample.GetCount());
+      EZ_TEST_BOOL(Decompressed.GetArrayPtr() == sample);
+    }
+
+    // the dictionary must make a real difference for such data
+    EZ_TEST_BOOL(uiSizeWithDictionary * 2 < uiSizeWithoutDictionary);
+  }
+}
+
 #endif
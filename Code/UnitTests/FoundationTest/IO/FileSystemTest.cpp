@@ -1,5 +1,6 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
+#include <Foundation/IO/FileSystem/AsyncFileReadBatch.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
@@ -149,6 +150,67 @@ Only concrete and clocks.\n\
     FileIn.Close();
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ezAsyncFileReadBatch")
+  {
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      ezStringBuilder sFile;
+      sFile.Format(":output1/AsyncRead{}.txt", i);
+
+      ezFileWriter FileOut;
+      EZ_TEST_BOOL(FileOut.Open(sFile) == EZ_SUCCESS);
+
+      for (ezUInt32 r = 0; r <= i; ++r)
+      {
+        EZ_TEST_BOOL(FileOut.WriteBytes(sFileContent.GetData(), sFileContent.GetElementCount()) == EZ_SUCCESS);
+      }
+    }
+
+    ezAsyncFileReadBatch batch;
+    EZ_TEST_BOOL(!batch.IsFinished());
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      ezStringBuilder sFile;
+      sFile.Format("AsyncRead{}.txt", i);
+      EZ_TEST_INT(batch.AddFile(sFile), i);
+    }
+
+    const ezUInt32 uiMissingFile = batch.AddFile("AsyncReadDoesNotExist.txt");
+    EZ_TEST_INT(batch.GetNumFiles(), 9);
+
+    batch.Submit();
+    batch.WaitForCompletion();
+    EZ_TEST_BOOL(batch.IsFinished());
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      EZ_TEST_BOOL(batch.GetResult(i).Succeeded());
+
+      const ezArrayPtr<const ezUInt8> data = batch.GetData(i);
+      EZ_TEST_INT(data.GetCount(), sFileContent.GetElementCount() * (i + 1));
+
+      for (ezUInt32 r = 0; r <= i; ++r)
+      {
+        EZ_TEST_BOOL(ezMemoryUtils::IsEqual(data.GetPtr() + r * sFileContent.GetElementCount(), reinterpret_cast<const ezUInt8*>(sFileContent.GetData()), sFileContent.GetElementCount()));
+      }
+
+      ezStringBuilder sAbs = sOutputFolder1Resolved;
+      sAbs.AppendFormat("/AsyncRead{}.txt", i);
+      EZ_TEST_STRING(batch.GetFilePathAbsolute(i), sAbs);
+    }
+
+    EZ_TEST_BOOL(batch.GetResult(uiMissingFile).Failed());
+    EZ_TEST_INT(batch.GetData(uiMissingFile).GetCount(), 0);
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      ezStringBuilder sFile;
+      sFile.Format(":output1/AsyncRead{}.txt", i);
+      ezFileSystem::DeleteFile(sFile);
+    }
+  }
+
 #if EZ_DISABLED(EZ_PLATFORM_WINDOWS_UWP)
 
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read File (Absolute Path)")
@@ -4,6 +4,7 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Math/Float16.h>
 #include <Texture/Image/Formats/BmpFileFormat.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/Image/Formats/ImageFileFormat.h>
@@ -185,3 +186,136 @@ EZ_CREATE_SIMPLE_TEST(Image, Image)
 
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
+
+EZ_CREATE_SIMPLE_TEST(Image, ConvertRaw)
+{
+  // large enough to be split into multiple tasks and not a multiple of any SIMD batch size
+  const ezUInt32 uiNumPixels = 100003;
+
+  ezDynamicArray<ezColor> source;
+  source.SetCountUninitialized(uiNumPixels);
+
+  for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+  {
+    source[i] = ezColor((i % 1201) / 1000.0f - 0.1f, (i % 997) / 900.0f, (i % 89) * 1e-4f, ((i * 7) % 256) / 255.0f);
+  }
+
+  // values that need special treatment in the conversion kernels
+  source[0] = ezColor(ezMath::NaN<float>(), ezMath::Infinity<float>(), -ezMath::Infinity<float>(), 70000.0f);
+  source[1] = ezColor(1e-5f, -1e-6f, 6e-8f, -0.0f);
+
+  auto ConvertRaw = [&](const void* pSource, void* pTarget, ezUInt32 uiSourceBytesPerPixel, ezUInt32 uiTargetBytesPerPixel,
+                      ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) {
+    return ezImageConversion::ConvertRaw(ezMakeByteBlobPtr(pSource, uiNumPixels * uiSourceBytesPerPixel),
+      ezMakeByteBlobPtr(pTarget, uiNumPixels * uiTargetBytesPerPixel), uiNumPixels, sourceFormat, targetFormat);
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RGBA32F <-> RGBA8 sRGB")
+  {
+    ezDynamicArray<ezColorGammaUB> gamma;
+    gamma.SetCountUninitialized(uiNumPixels);
+    EZ_TEST_BOOL(ConvertRaw(source.GetData(), gamma.GetData(), 16, 4, ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::R8G8B8A8_UNORM_SRGB).Succeeded());
+
+    ezDynamicArray<ezColor> linear;
+    linear.SetCountUninitialized(uiNumPixels);
+    EZ_TEST_BOOL(ConvertRaw(gamma.GetData(), linear.GetData(), 4, 16, ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::R32G32B32A32_FLOAT).Succeeded());
+
+    ezUInt32 uiNumMismatches = 0;
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      const ezColorGammaUB expectedGamma = source[i];
+      const ezColor expectedLinear = gamma[i];
+
+      if (gamma[i] != expectedGamma || linear[i] != expectedLinear)
+        ++uiNumMismatches;
+    }
+
+    EZ_TEST_INT(uiNumMismatches, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RGBA32F <-> RGBA16F")
+  {
+    ezDynamicArray<ezFloat16> half;
+    half.SetCountUninitialized(uiNumPixels * 4);
+    EZ_TEST_BOOL(ConvertRaw(source.GetData(), half.GetData(), 16, 8, ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::R16G16B16A16_FLOAT).Succeeded());
+
+    ezDynamicArray<float> full;
+    full.SetCountUninitialized(uiNumPixels * 4);
+    EZ_TEST_BOOL(ConvertRaw(half.GetData(), full.GetData(), 8, 16, ezImageFormat::R16G16B16A16_FLOAT, ezImageFormat::R32G32B32A32_FLOAT).Succeeded());
+
+    const float* pSource = source.GetData()->GetData();
+
+    ezUInt32 uiNumMismatches = 0;
+    for (ezUInt32 i = 0; i < uiNumPixels * 4; ++i)
+    {
+      const ezFloat16 expectedHalf = pSource[i];
+      const float expectedFull = half[i];
+
+      if (half[i].GetRawData() != expectedHalf.GetRawData() || ezIntFloatUnion(full[i]).i != ezIntFloatUnion(expectedFull).i)
+        ++uiNumMismatches;
+    }
+
+    EZ_TEST_INT(uiNumMismatches, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RGBA32F <-> RGBA8 / RGBA16")
+  {
+    ezDynamicArray<ezUInt8> bytes;
+    bytes.SetCountUninitialized(uiNumPixels * 4);
+    EZ_TEST_BOOL(ConvertRaw(source.GetData(), bytes.GetData(), 16, 4, ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::R8G8B8A8_UNORM).Succeeded());
+
+    ezDynamicArray<ezUInt16> shorts;
+    shorts.SetCountUninitialized(uiNumPixels * 4);
+    EZ_TEST_BOOL(ConvertRaw(source.GetData(), shorts.GetData(), 16, 8, ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::R16G16B16A16_UNORM).Succeeded());
+
+    ezDynamicArray<float> fromBytes;
+    fromBytes.SetCountUninitialized(uiNumPixels * 4);
+    EZ_TEST_BOOL(ConvertRaw(bytes.GetData(), fromBytes.GetData(), 4, 16, ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::R32G32B32A32_FLOAT).Succeeded());
+
+    ezDynamicArray<float> fromShorts;
+    fromShorts.SetCountUninitialized(uiNumPixels * 4);
+    EZ_TEST_BOOL(ConvertRaw(shorts.GetData(), fromShorts.GetData(), 8, 16, ezImageFormat::R16G16B16A16_UNORM, ezImageFormat::R32G32B32A32_FLOAT).Succeeded());
+
+    const float* pSource = source.GetData()->GetData();
+
+    ezUInt32 uiNumMismatches = 0;
+    for (ezUInt32 i = 0; i < uiNumPixels * 4; ++i)
+    {
+      if (bytes[i] != ezMath::ColorFloatToByte(pSource[i]) || shorts[i] != ezMath::ColorFloatToShort(pSource[i]))
+        ++uiNumMismatches;
+
+      if (fromBytes[i] != ezMath::ColorByteToFloat(bytes[i]) || fromShorts[i] != ezMath::ColorShortToFloat(shorts[i]))
+        ++uiNumMismatches;
+    }
+
+    EZ_TEST_INT(uiNumMismatches, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BGRA8 -> RGBA8")
+  {
+    ezDynamicArray<ezUInt32> bgra;
+    bgra.SetCountUninitialized(uiNumPixels);
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      bgra[i] = i * 2654435761u;
+    }
+
+    // in place and unaligned
+    ezDynamicArray<ezUInt8> rgba;
+    rgba.SetCountUninitialized(uiNumPixels * 4 + 1);
+    ezMemoryUtils::Copy(rgba.GetData() + 1, reinterpret_cast<const ezUInt8*>(bgra.GetData()), uiNumPixels * 4);
+    EZ_TEST_BOOL(ConvertRaw(rgba.GetData() + 1, rgba.GetData() + 1, 4, 4, ezImageFormat::B8G8R8A8_UNORM, ezImageFormat::R8G8B8A8_UNORM).Succeeded());
+
+    ezUInt32 uiNumMismatches = 0;
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      const ezUInt8* pSource = reinterpret_cast<const ezUInt8*>(&bgra[i]);
+      const ezUInt8* pTarget = rgba.GetData() + 1 + i * 4;
+
+      if (pTarget[0] != pSource[2] || pTarget[1] != pSource[1] || pTarget[2] != pSource[0] || pTarget[3] != pSource[3])
+        ++uiNumMismatches;
+    }
+
+    EZ_TEST_INT(uiNumMismatches, 0);
+  }
+}
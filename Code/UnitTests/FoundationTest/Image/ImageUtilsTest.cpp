@@ -3,8 +3,59 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageUtils.h>
 
+namespace
+{
+  void CreateTestImage(ezImage& out_image, ezImageFormat::Enum format, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth, ezUInt32 uiNumFaces, ezUInt32 uiNumArrayIndices)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(format);
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetDepth(uiDepth);
+    header.SetNumFaces(uiNumFaces);
+    header.SetNumArrayIndices(uiNumArrayIndices);
+    out_image.ResetAndAlloc(header);
+
+    if (format == ezImageFormat::R32G32B32A32_FLOAT)
+    {
+      ezBlobPtr<float> values = out_image.GetBlobPtr<float>();
+      for (ezUInt64 i = 0; i < values.GetCount(); ++i)
+      {
+        values[i] = static_cast<float>((i * 7919) % 256) / 255.0f;
+      }
+    }
+    else
+    {
+      ezByteBlobPtr values = out_image.GetByteBlobPtr();
+      for (ezUInt64 i = 0; i < values.GetCount(); ++i)
+      {
+        values[i] = static_cast<ezUInt8>((i * 7919) % 256);
+      }
+    }
+  }
+
+  /// Runs the function in a task that never waits for other tasks, so all parallel loops inside of it are executed serially.
+  void RunSerially(ezDelegate<void()> func)
+  {
+    ezSharedPtr<ezTask> pTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "SerialImageUtils", func);
+    ezTaskSystem::WaitForGroup(ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::EarlyThisFrame));
+  }
+
+  bool AreImagesIdentical(const ezImageView& a, const ezImageView& b)
+  {
+    if (a.GetImageFormat() != b.GetImageFormat() || a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight() || a.GetDepth() != b.GetDepth())
+      return false;
+
+    ezConstByteBlobPtr dataA = a.GetByteBlobPtr();
+    ezConstByteBlobPtr dataB = b.GetByteBlobPtr();
+
+    return dataA.GetCount() == dataB.GetCount() && ezMemoryUtils::IsEqual(dataA.GetPtr(), dataB.GetPtr(), static_cast<size_t>(dataA.GetCount()));
+  }
+} // namespace
 
 EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
 {
@@ -116,5 +167,111 @@ EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
     EZ_TEST_INT(uiError, 1433);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D Volume")
+  {
+    // the depth differs from the height, to make sure every pass uses its own dimension
+    ezImage source;
+    CreateTestImage(source, ezImageFormat::R32G32B32A32_FLOAT, 128, 96, 40, 1, 1);
+
+    ezImage scaled, scaledSerial;
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, scaled, 64, 48, 24).Succeeded());
+    RunSerially([&]() { ezImageUtils::Scale3D(source, scaledSerial, 64, 48, 24).IgnoreResult(); });
+
+    EZ_TEST_INT(scaled.GetWidth(), 64);
+    EZ_TEST_INT(scaled.GetHeight(), 48);
+    EZ_TEST_INT(scaled.GetDepth(), 24);
+    EZ_TEST_BOOL(AreImagesIdentical(scaled, scaledSerial));
+
+    // a constant volume stays constant
+    ezBlobPtr<float> values = source.GetBlobPtr<float>();
+    for (ezUInt64 i = 0; i < values.GetCount(); ++i)
+    {
+      values[i] = 0.5f;
+    }
+
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, scaled, 64, 48, 24).Succeeded());
+
+    bool bConstant = true;
+    for (float fValue : scaled.GetBlobPtr<float>())
+    {
+      bConstant &= ezMath::IsEqual(fValue, 0.5f, 0.0001f);
+    }
+
+    EZ_TEST_BOOL(bConstant);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "DownScaleFast Cubemap and Array")
+  {
+    const ezUInt32 uiNumFaces[] = {6, 1};
+    const ezUInt32 uiNumArrayIndices[] = {1, 4};
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(uiNumFaces); ++i)
+    {
+      ezImage source;
+      CreateTestImage(source, ezImageFormat::R8G8B8A8_UNORM, 256, 256, 1, uiNumFaces[i], uiNumArrayIndices[i]);
+
+      // power of two factors without a filter use the fast path
+      ezImage scaled, scaledSerial;
+      EZ_TEST_BOOL(ezImageUtils::Scale(source, scaled, 128, 64).Succeeded());
+      RunSerially([&]() { ezImageUtils::Scale(source, scaledSerial, 128, 64).IgnoreResult(); });
+
+      EZ_TEST_INT(scaled.GetNumFaces(), uiNumFaces[i]);
+      EZ_TEST_INT(scaled.GetNumArrayIndices(), uiNumArrayIndices[i]);
+      EZ_TEST_BOOL(AreImagesIdentical(scaled, scaledSerial));
+
+      // every sub-image is scaled like an image of its own
+      for (ezUInt32 uiArrayIndex = 0; uiArrayIndex < uiNumArrayIndices[i]; ++uiArrayIndex)
+      {
+        for (ezUInt32 uiFace = 0; uiFace < uiNumFaces[i]; ++uiFace)
+        {
+          ezImage subImage, scaledSubImage;
+          subImage.ResetAndCopy(source.GetSubImageView(0, uiFace, uiArrayIndex));
+          EZ_TEST_BOOL(ezImageUtils::Scale(subImage, scaledSubImage, 128, 64).Succeeded());
+
+          EZ_TEST_BOOL(AreImagesIdentical(scaled.GetSubImageView(0, uiFace, uiArrayIndex), scaledSubImage));
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GenerateMipMaps Cubemap and Array")
+  {
+    const ezUInt32 uiNumFaces[] = {6, 1};
+    const ezUInt32 uiNumArrayIndices[] = {1, 3};
+
+    ezImageUtils::MipMapOptions options;
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(uiNumFaces); ++i)
+    {
+      ezImage source;
+      CreateTestImage(source, ezImageFormat::R32G32B32A32_FLOAT, 128, 128, 1, uiNumFaces[i], uiNumArrayIndices[i]);
+
+      ezImage mipMaps, mipMapsSerial;
+      ezImageUtils::GenerateMipMaps(source, mipMaps, options);
+      RunSerially([&]() { ezImageUtils::GenerateMipMaps(source, mipMapsSerial, options); });
+
+      EZ_TEST_INT(mipMaps.GetNumMipLevels(), 8);
+      EZ_TEST_INT(mipMaps.GetNumFaces(), uiNumFaces[i]);
+      EZ_TEST_INT(mipMaps.GetNumArrayIndices(), uiNumArrayIndices[i]);
+      EZ_TEST_BOOL(AreImagesIdentical(mipMaps, mipMapsSerial));
+
+      // every sub-image gets the same mip chain as an image of its own
+      for (ezUInt32 uiArrayIndex = 0; uiArrayIndex < uiNumArrayIndices[i]; ++uiArrayIndex)
+      {
+        for (ezUInt32 uiFace = 0; uiFace < uiNumFaces[i]; ++uiFace)
+        {
+          ezImage subImage, subImageMipMaps;
+          subImage.ResetAndCopy(source.GetSubImageView(0, uiFace, uiArrayIndex));
+          ezImageUtils::GenerateMipMaps(subImage, subImageMipMaps, options);
+
+          for (ezUInt32 uiMipLevel = 0; uiMipLevel < mipMaps.GetNumMipLevels(); ++uiMipLevel)
+          {
+            EZ_TEST_BOOL(AreImagesIdentical(mipMaps.GetSubImageView(uiMipLevel, uiFace, uiArrayIndex), subImageMipMaps.GetSubImageView(uiMipLevel)));
+          }
+        }
+      }
+    }
+  }
+
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
@@ -0,0 +1,169 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/FlatHashMap.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Containers/Map.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Time/Time.h>
+
+#include <unordered_map>
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_SAMPLES = 2,
+    MAX_NUM_KEYS = 1024 * 64,
+#else
+    NUM_SAMPLES = 8,
+    MAX_NUM_KEYS = 1024 * 1024,
+#endif
+  };
+
+  struct EzContainerAdapter
+  {
+    template <typename Container>
+    EZ_ALWAYS_INLINE static void Insert(Container& c, ezUInt64 uiKey, ezUInt32 uiValue)
+    {
+      c.Insert(uiKey, uiValue);
+    }
+
+    template <typename Container>
+    EZ_ALWAYS_INLINE static ezUInt32 Lookup(const Container& c, ezUInt64 uiKey)
+    {
+      const ezUInt32* pValue = c.GetValue(uiKey);
+      return pValue != nullptr ? *pValue : 0;
+    }
+
+    template <typename Container>
+    EZ_ALWAYS_INLINE static void Remove(Container& c, ezUInt64 uiKey)
+    {
+      c.Remove(uiKey);
+    }
+  };
+
+  struct StdContainerAdapter
+  {
+    template <typename Container>
+    EZ_ALWAYS_INLINE static void Insert(Container& c, ezUInt64 uiKey, ezUInt32 uiValue)
+    {
+      c.emplace(uiKey, uiValue);
+    }
+
+    template <typename Container>
+    EZ_ALWAYS_INLINE static ezUInt32 Lookup(const Container& c, ezUInt64 uiKey)
+    {
+      auto it = c.find(uiKey);
+      return it != c.end() ? it->second : 0;
+    }
+
+    template <typename Container>
+    EZ_ALWAYS_INLINE static void Remove(Container& c, ezUInt64 uiKey)
+    {
+      c.erase(uiKey);
+    }
+  };
+
+  void GenerateKeys(ezUInt32 uiNumKeys, ezUInt64 uiSeed, ezDynamicArray<ezUInt64>& out_keys)
+  {
+    out_keys.SetCountUninitialized(uiNumKeys);
+
+    // splitmix64, unique keys with the lowest bit set to uiSeed, so that the two key sets never overlap
+    ezUInt64 uiState = 0x1234567ull;
+    for (ezUInt32 i = 0; i < uiNumKeys; ++i)
+    {
+      uiState += 0x9E3779B97F4A7C15ull;
+      ezUInt64 z = uiState;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      out_keys[i] = ((z ^ (z >> 31)) << 1) | uiSeed;
+    }
+  }
+
+  template <typename Container, typename Adapter>
+  void RunBenchmark(const char* szName, const ezDynamicArray<ezUInt64>& keys, const ezDynamicArray<ezUInt64>& missingKeys)
+  {
+    const ezUInt32 uiNumKeys = keys.GetCount();
+    const double fNumOps = static_cast<double>(uiNumKeys) * NUM_SAMPLES;
+
+    ezTime tInsert, tLookupHit, tLookupMiss, tErase;
+    ezUInt32 uiSum = 0;
+
+    for (ezUInt32 n = 0; n < NUM_SAMPLES; ++n)
+    {
+      Container c;
+
+      ezTime t0 = ezTime::Now();
+      for (ezUInt32 i = 0; i < uiNumKeys; ++i)
+      {
+        Adapter::Insert(c, keys[i], i);
+      }
+
+      ezTime t1 = ezTime::Now();
+      for (ezUInt32 i = 0; i < uiNumKeys; ++i)
+      {
+        uiSum += Adapter::Lookup(c, keys[i]);
+      }
+
+      ezTime t2 = ezTime::Now();
+      for (ezUInt32 i = 0; i < uiNumKeys; ++i)
+      {
+        uiSum += Adapter::Lookup(c, missingKeys[i]);
+      }
+
+      ezTime t3 = ezTime::Now();
+      for (ezUInt32 i = 0; i < uiNumKeys; ++i)
+      {
+        Adapter::Remove(c, keys[i]);
+      }
+
+      ezTime t4 = ezTime::Now();
+
+      tInsert += t1 - t0;
+      tLookupHit += t2 - t1;
+      tLookupMiss += t3 - t2;
+      tErase += t4 - t3;
+    }
+
+    ezLog::Info("[test]{0} ({1} keys): insert {2}ns, lookup-hit {3}ns, lookup-miss {4}ns, erase {5}ns", szName, uiNumKeys,
+      ezArgF(tInsert.GetNanoseconds() / fNumOps, 1), ezArgF(tLookupHit.GetNanoseconds() / fNumOps, 1),
+      ezArgF(tLookupMiss.GetNanoseconds() / fNumOps, 1), ezArgF(tErase.GetNanoseconds() / fNumOps, 1), uiSum);
+  }
+} // namespace
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, HashContainers)
+{
+  ezDynamicArray<ezUInt64> keys;
+  ezDynamicArray<ezUInt64> missingKeys;
+
+  for (ezUInt32 uiNumKeys = 1024; uiNumKeys <= MAX_NUM_KEYS; uiNumKeys *= 16)
+  {
+    GenerateKeys(uiNumKeys, 0, keys);
+    GenerateKeys(uiNumKeys, 1, missingKeys);
+
+    EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezFlatHashMap<ezUInt64, ezUInt32>")
+    {
+      RunBenchmark<ezFlatHashMap<ezUInt64, ezUInt32>, EzContainerAdapter>("ezFlatHashMap", keys, missingKeys);
+    }
+
+    EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezHashTable<ezUInt64, ezUInt32>")
+    {
+      RunBenchmark<ezHashTable<ezUInt64, ezUInt32>, EzContainerAdapter>("ezHashTable", keys, missingKeys);
+    }
+
+    EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezMap<ezUInt64, ezUInt32>")
+    {
+      RunBenchmark<ezMap<ezUInt64, ezUInt32>, EzContainerAdapter>("ezMap", keys, missingKeys);
+    }
+
+    EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "std::unordered_map<ezUInt64, ezUInt32>")
+    {
+      RunBenchmark<std::unordered_map<ezUInt64, ezUInt32>, StdContainerAdapter>("std::unordered_map", keys, missingKeys);
+    }
+  }
+}
@@ -2,8 +2,10 @@
 
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/ThreadUtils.h>
+#include <Foundation/Utilities/Stats.h>
 
 namespace
 {
@@ -52,4 +54,183 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
 
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Interned scopes")
+  {
+    ezProfilingSystem::Clear();
+
+    // refines the tick calibration
+    ezProfilingSystem::StartNewFrame();
+
+    const ezUInt64 uiTicks0 = ezProfilingSystem::GetTimestampTicks();
+    const ezTime time0 = ezTime::Now();
+
+    {
+      EZ_PROFILE_SCOPE_INTERNED("Interned scope");
+
+      ezTime endTime = ezTime::Now() + ezTime::Milliseconds(1);
+      while (ezTime::Now() < endTime)
+      {
+      }
+    }
+
+    const ezUInt64 uiTicks1 = ezProfilingSystem::GetTimestampTicks();
+    EZ_TEST_BOOL(uiTicks1 > uiTicks0);
+
+    // the tick calibration should roughly match the regular clock
+    EZ_TEST_BOOL(ezMath::Abs((ezProfilingSystem::TicksToTime(uiTicks0) - time0).GetMilliseconds()) < 5.0);
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezProfilingSystem::Capture(profilingData);
+
+    const ezUInt64 uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
+
+    bool bFound = false;
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      if (eventBuffer.m_uiThreadId != uiThreadId)
+        continue;
+
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        if (ezStringUtils::IsEqual(scope.m_szName, "Interned scope"))
+        {
+          bFound = true;
+          EZ_TEST_BOOL(scope.m_EndTime - scope.m_BeginTime >= ezTime::Milliseconds(0.9));
+        }
+      }
+    }
+
+    EZ_TEST_BOOL(bFound);
+
+    WriteOutProfilingCapture(":output/profilingInternedScopes.json");
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Trace streaming")
+  {
+    ezStringBuilder sTracePath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    sTracePath.AppendPath("profilingTraceStream.json");
+
+    EZ_TEST_BOOL(ezProfilingSystem::StartTraceStreaming(sTracePath, ezTime::Milliseconds(10)).Succeeded());
+    EZ_TEST_BOOL(ezProfilingSystem::IsTraceStreaming());
+
+    // only one stream at a time
+    EZ_TEST_BOOL(ezProfilingSystem::StartTraceStreaming(sTracePath).Failed());
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      EZ_PROFILE_SCOPE_INTERNED("Streamed \"scope\"\t");
+
+      ezTime endTime = ezTime::Now() + ezTime::Milliseconds(1);
+      while (ezTime::Now() < endTime)
+      {
+      }
+    }
+
+    ezProfilingSystem::StopTraceStreaming();
+    EZ_TEST_BOOL(!ezProfilingSystem::IsTraceStreaming());
+
+    ezOSFile file;
+    if (EZ_TEST_BOOL(file.Open(sTracePath, ezFileOpenMode::Read).Succeeded()))
+    {
+      ezDynamicArray<ezUInt8> content;
+      file.ReadAll(content);
+      content.PushBack(0);
+
+      const char* szContent = reinterpret_cast<const char*>(content.GetData());
+      EZ_TEST_BOOL(ezStringUtils::StartsWith(szContent, "["));
+      EZ_TEST_BOOL(ezStringUtils::EndsWith(szContent, "]\n"));
+      EZ_TEST_BOOL(ezStringUtils::FindSubString(szContent, "\"name\":\"Streamed \\\"scope\\\"\\u0009\",\"ph\":\"X\"") != nullptr);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Counters and histograms")
+  {
+    ezProfilingSystem::Clear();
+
+    EZ_TEST_INT(ezProfilingSystem::GetHistogramBucket(ezTime::Microseconds(0.5)), 0);
+    EZ_TEST_INT(ezProfilingSystem::GetHistogramBucket(ezTime::Microseconds(1)), 0);
+    EZ_TEST_INT(ezProfilingSystem::GetHistogramBucket(ezTime::Microseconds(3)), 2);
+    EZ_TEST_INT(ezProfilingSystem::GetHistogramBucket(ezTime::Seconds(10)), ezProfilingSystem::HistogramFrame::NUM_BUCKETS - 1);
+    EZ_TEST_BOOL(ezProfilingSystem::GetHistogramBucketUpperBound(2) == ezTime::Microseconds(4));
+
+    EZ_PROFILE_COUNTER("ProfilingTest/Counter", 1);
+    EZ_PROFILE_COUNTER("ProfilingTest/Counter", 1); // same value, not stored again
+    EZ_PROFILE_COUNTER("ProfilingTest/Counter", 2.5);
+
+    // every call site caches its handle, they all refer to the same track
+    EZ_TEST_BOOL(ezProfilingSystem::GetCounterTrack("ProfilingTest/Counter") == ezProfilingSystem::GetCounterTrack("ProfilingTest/Counter"));
+
+    // the second update uses the cached track of the stat
+    ezStats::SetStat("ProfilingTest/Stat", 41);
+    ezStats::SetStat("ProfilingTest/Stat", 42);
+
+    ezProfilingSystem::StartNewFrame();
+
+    EZ_PROFILE_HISTOGRAM("ProfilingTest/Histogram", ezTime::Microseconds(3));
+    EZ_PROFILE_HISTOGRAM("ProfilingTest/Histogram", ezTime::Microseconds(3.5));
+    EZ_PROFILE_HISTOGRAM("ProfilingTest/Histogram", ezTime::Milliseconds(2));
+
+    ezProfilingSystem::StartNewFrame();
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezProfilingSystem::Capture(profilingData);
+
+    auto FindCounter = [](const ezProfilingSystem::ProfilingData& data, const char* szName) -> const ezProfilingSystem::CounterTrack* {
+      for (const auto& track : data.m_CounterTracks)
+      {
+        if (track.m_sName == szName)
+          return &track;
+      }
+      return nullptr;
+    };
+
+    const ezProfilingSystem::CounterTrack* pCounter = FindCounter(profilingData, "ProfilingTest/Counter");
+    if (EZ_TEST_BOOL(pCounter != nullptr))
+    {
+      EZ_TEST_INT(pCounter->m_Samples.GetCount(), 2);
+      EZ_TEST_DOUBLE(pCounter->m_Samples.PeekBack().m_fValue, 2.5, 0.0);
+    }
+
+    const ezProfilingSystem::CounterTrack* pStat = FindCounter(profilingData, "Stats/ProfilingTest/Stat");
+    if (EZ_TEST_BOOL(pStat != nullptr))
+    {
+      EZ_TEST_INT(pStat->m_Samples.GetCount(), 2);
+      EZ_TEST_DOUBLE(pStat->m_Samples.PeekBack().m_fValue, 42.0, 0.0);
+    }
+
+    ezStats::RemoveStat("ProfilingTest/Stat");
+
+    const ezProfilingSystem::HistogramTrack* pHistogram = nullptr;
+    for (const auto& track : profilingData.m_HistogramTracks)
+    {
+      if (track.m_sName == "ProfilingTest/Histogram")
+        pHistogram = &track;
+    }
+
+    if (EZ_TEST_BOOL(pHistogram != nullptr) && EZ_TEST_INT(pHistogram->m_Frames.GetCount(), 1))
+    {
+      const auto& frame = pHistogram->m_Frames[0];
+      EZ_TEST_INT(frame.m_uiNumSamples, 3);
+      EZ_TEST_INT(frame.m_BucketCounts[2], 2);
+      EZ_TEST_INT(frame.m_BucketCounts[ezProfilingSystem::GetHistogramBucket(ezTime::Milliseconds(2))], 1);
+      EZ_TEST_BOOL(frame.m_MaxLatency == ezTime::Milliseconds(2));
+    }
+
+    // merging a capture with itself concatenates the tracks of the same name
+    {
+      const ezProfilingSystem::ProfilingData* inputs[] = {&profilingData, &profilingData};
+
+      ezProfilingSystem::ProfilingData merged;
+      ezProfilingSystem::ProfilingData::Merge(merged, ezMakeArrayPtr(inputs));
+
+      const ezProfilingSystem::CounterTrack* pMergedCounter = FindCounter(merged, "ProfilingTest/Counter");
+      if (EZ_TEST_BOOL(pMergedCounter != nullptr))
+      {
+        EZ_TEST_INT(pMergedCounter->m_Samples.GetCount(), 4);
+      }
+    }
+
+    WriteOutProfilingCapture(":output/profilingCounters.json");
+  }
 }
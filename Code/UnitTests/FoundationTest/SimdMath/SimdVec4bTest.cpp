@@ -90,5 +90,10 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdVec4b)
 
     EZ_TEST_BOOL(a.AllSet<1>());
     EZ_TEST_BOOL(b.NoneSet<1>());
+
+    EZ_TEST_INT(a.GetBitmask(), 0x5);
+    EZ_TEST_INT(b.GetBitmask(), 0x6);
+    EZ_TEST_INT(c.GetBitmask(), 0x0);
+    EZ_TEST_INT((!c).GetBitmask(), 0xF);
   }
 }
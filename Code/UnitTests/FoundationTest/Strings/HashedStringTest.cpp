@@ -1,6 +1,7 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 EZ_CREATE_SIMPLE_TEST(Strings, HashedString)
 {
@@ -200,5 +201,60 @@ EZ_CREATE_SIMPLE_TEST(Strings, HashedString)
     EZ_TEST_INT(ezHashedString::ClearUnusedStrings(), 3);
     EZ_TEST_INT(ezHashedString::ClearUnusedStrings(), 0);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Multithreaded Assign")
+  {
+    constexpr ezUInt32 uiNumStrings = 64;
+
+    ezHashedString reference[uiNumStrings];
+    for (ezUInt32 i = 0; i < uiNumStrings; ++i)
+    {
+      ezStringBuilder tmp;
+      tmp.Format("MT String {}", i);
+      reference[i].Assign(tmp);
+    }
+
+    ezAtomicInteger32 iNumMismatches;
+
+    ezParallelForParams params;
+    params.uiBinSize = 16;
+
+    for (ezUInt32 uiRun = 0; uiRun < 4; ++uiRun)
+    {
+      ezTaskSystem::ParallelForIndexed(
+        0, 1024,
+        [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          ezStringBuilder tmp;
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            // mix strings that already exist with strings that are only used temporarily and get cleared concurrently
+            tmp.Format("MT String {}", i % uiNumStrings);
+            ezHashedString sExisting;
+            sExisting.Assign(tmp);
+
+            tmp.Format("MT Temp String {}", i);
+            ezHashedString sTemp;
+            sTemp.Assign(tmp);
+
+            if (sExisting != reference[i % uiNumStrings] || sTemp.GetView() != tmp.GetView())
+              iNumMismatches.Increment();
+
+            if ((i % 128) == 0)
+              ezHashedString::ClearUnusedStrings();
+          }
+        },
+        "HashedString MT Test", params);
+    }
+
+    EZ_TEST_INT(iNumMismatches, 0);
+
+    ezHashedString::ClearUnusedStrings();
+    for (ezUInt32 i = 0; i < uiNumStrings; ++i)
+    {
+      ezStringBuilder tmp;
+      tmp.Format("MT String {}", i);
+      EZ_TEST_STRING(reference[i].GetData(), tmp.GetData());
+    }
+  }
 #endif
 }
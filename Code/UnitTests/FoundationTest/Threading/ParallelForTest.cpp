@@ -212,4 +212,90 @@ EZ_CREATE_SIMPLE_TEST(Threading, ParallelFor)
     // check the resulting sum
     EZ_TEST_INT(uiNumbersSum, 4 * uiNumbersCheckSum);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Indexed, Lazy)")
+  {
+    const ezUInt32 uiStartIndex = 1000;
+    const ezUInt32 uiNumItems = 10000;
+
+    ezDynamicArray<ezAtomicInteger32> visited;
+    visited.SetCount(uiNumItems);
+
+    ezParallelForStats stats;
+
+    ezParallelForParams lazyParams;
+    lazyParams.splitMode = ezParallelForSplitMode::Lazy;
+    lazyParams.uiBinSize = 16;
+    lazyParams.pStats = &stats;
+
+    for (ezUInt32 uiRun = 0; uiRun < 3; ++uiRun)
+    {
+      ezTaskSystem::ParallelForIndexed(
+        uiStartIndex, uiNumItems,
+        [&visited](ezUInt32 uiFirst, ezUInt32 uiEnd) {
+          EZ_TEST_BOOL(uiFirst >= uiStartIndex);
+          EZ_TEST_BOOL(uiEnd <= uiStartIndex + uiNumItems);
+          EZ_TEST_BOOL(uiFirst < uiEnd);
+
+          for (ezUInt32 i = uiFirst; i < uiEnd; ++i)
+          {
+            visited[i - uiStartIndex].Increment();
+          }
+        },
+        "ParallelForIndexed Lazy Test", lazyParams);
+
+      // every item must be processed exactly once per run
+      for (ezUInt32 i = 0; i < uiNumItems; ++i)
+      {
+        EZ_TEST_INT(visited[i], (ezInt32)uiRun + 1);
+      }
+
+      EZ_TEST_INT(stats.m_uiNumCalls, uiRun + 1);
+      EZ_TEST_INT(stats.m_uiLastNumItems, uiNumItems);
+      EZ_TEST_BOOL(stats.m_uiLastGrainSize >= lazyParams.uiBinSize);
+      EZ_TEST_BOOL(stats.m_uiLastNumChunks >= 1);
+      EZ_TEST_BOOL(stats.m_LastDuration.IsPositive());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Array, Lazy)")
+  {
+    // reset
+    ResetSharedVariables();
+
+    ezParallelForParams lazyParams;
+    lazyParams.splitMode = ezParallelForSplitMode::Lazy;
+
+    ezTaskSystem::ParallelForSingleIndex(
+      numbers.GetArrayPtr(),
+      [&dataAccessMutex, &uiNumbersSum](ezUInt32 uiIndex, ezUInt32 uiNumber) {
+        EZ_LOCK(dataAccessMutex);
+        uiNumbersSum += uiNumber + (uiIndex + 1);
+      },
+      "ParallelFor Array Lazy Test", lazyParams);
+
+    // check the resulting sum
+    EZ_TEST_INT(uiNumbersSum, 2 * uiNumbersCheckSum);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Adaptive Grain Size")
+  {
+    ezParallelForStats stats;
+
+    ezParallelForParams lazyParams;
+    lazyParams.splitMode = ezParallelForSplitMode::Lazy;
+    lazyParams.pStats = &stats;
+    lazyParams.targetChunkDuration = ezTime::Microseconds(100);
+
+    // pretend each item takes 1 microsecond
+    stats.AddSample(1000, ezTime::Milliseconds(1), ezTime::Milliseconds(1), 1, 1, 0);
+    EZ_TEST_INT(lazyParams.DetermineGrainSize(100000), 100);
+
+    // never exceeds the number of items, which means serial execution
+    EZ_TEST_INT(lazyParams.DetermineGrainSize(50), 50);
+
+    // never goes below the bin size
+    lazyParams.uiBinSize = 500;
+    EZ_TEST_INT(lazyParams.DetermineGrainSize(100000), 500);
+  }
 }
@@ -2,7 +2,9 @@
 
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Threading/DelegateTask.h>
 #include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/ThreadUtils.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Utilities/DGMLWriter.h>
 
@@ -550,6 +552,218 @@ EZ_CREATE_SIMPLE_TEST(Threading, TaskSystem)
     EZ_TEST_BOOL(t[2]->IsMultiplicityDone());
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Task Group Batches")
+  {
+    const ezUInt32 uiNumGroups = 64;
+    ezSharedPtr<ezTestTask> t[uiNumGroups];
+    ezTaskGroupID g[uiNumGroups];
+    ezHybridArray<ezTaskGroupDependency, uiNumGroups> dependencies;
+    ezHybridArray<ezTaskGroupID, uiNumGroups> startOrder;
+
+    for (ezUInt32 i = 0; i < uiNumGroups; ++i)
+    {
+      t[i] = EZ_DEFAULT_NEW(ezTestTask);
+      t[i]->m_uiIterations = 1;
+      t[i]->m_pDependency = i > 0 ? t[i - 1].Borrow() : nullptr;
+
+      g[i] = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+      ezTaskSystem::AddTaskToGroup(g[i], t[i]);
+
+      if (i > 0)
+      {
+        ezTaskGroupDependency& dep = dependencies.ExpandAndGetRef();
+        dep.m_TaskGroup = g[i];
+        dep.m_DependsOn = g[i - 1];
+      }
+    }
+
+    ezTaskSystem::AddTaskGroupDependencyBatch(dependencies);
+
+    // start the groups in reverse order, so that most of them have to wait for their dependency to finish
+    for (ezUInt32 i = uiNumGroups; i > 0; --i)
+    {
+      startOrder.PushBack(g[i - 1]);
+    }
+
+    ezTaskSystem::StartTaskGroupBatch(startOrder);
+    ezTaskSystem::WaitForGroup(g[uiNumGroups - 1]);
+
+    for (ezUInt32 i = 0; i < uiNumGroups; ++i)
+    {
+      EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(g[i]));
+      EZ_TEST_BOOL(t[i]->IsDone());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Reuse Groups while adding Dependents")
+  {
+    // several threads create short dependency chains at the same time, so groups finish and get reused by one thread,
+    // while another thread is still adding a dependent to them
+    static constexpr ezUInt32 uiNumChainTasks = 4;
+    static constexpr ezUInt32 uiNumIterations = 500;
+
+    ezAtomicInteger32 iNumDependentsExecuted;
+    ezAtomicInteger32 iNumOrderViolations;
+
+    auto chainTask = [&]() {
+      for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+      {
+        ezAtomicInteger32 iFirstDone;
+
+        ezTaskGroupID first = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+        ezTaskSystem::AddTaskToGroup(first, EZ_DEFAULT_NEW(ezDelegateTask<void>, "First", [&iFirstDone]() { iFirstDone = 1; }));
+
+        ezTaskGroupID second = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+        ezTaskSystem::AddTaskToGroup(second, EZ_DEFAULT_NEW(ezDelegateTask<void>, "Second", [&]() {
+          if (iFirstDone == 0)
+            iNumOrderViolations.Increment();
+
+          iNumDependentsExecuted.Increment();
+        }));
+
+        // the first group may already be finished and reused by another thread, when the dependency gets registered
+        ezTaskSystem::StartTaskGroup(first);
+        ezTaskSystem::AddTaskGroupDependency(second, first);
+        ezTaskSystem::StartTaskGroup(second);
+
+        ezTaskSystem::WaitForGroup(second);
+      }
+    };
+
+    ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::LongRunning);
+
+    for (ezUInt32 i = 0; i < uiNumChainTasks; ++i)
+    {
+      ezSharedPtr<ezTask> pTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "ChainTask", chainTask);
+      pTask->ConfigureTask("ChainTask", ezTaskNesting::Maybe);
+      ezTaskSystem::AddTaskToGroup(group, pTask);
+    }
+
+    ezTaskSystem::StartTaskGroup(group);
+    chainTask();
+    ezTaskSystem::WaitForGroup(group);
+
+    EZ_TEST_INT(iNumDependentsExecuted, (uiNumChainTasks + 1) * uiNumIterations);
+    EZ_TEST_INT(iNumOrderViolations, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Nested Tasks with Work Stealing")
+  {
+    // tasks that are started from within other tasks go into the work-stealing queue of the executing worker thread
+    // the worker then helps with its own tasks while waiting for them, and all other workers steal from it
+    static constexpr ezUInt32 uiNumOuterTasks = 8;
+    static constexpr ezUInt32 uiNumInnerItems = 1000;
+
+    ezAtomicInteger32 iNumItemsProcessed;
+
+    // resets the per-frame steal statistics, so that only the tasks of this block are counted
+    ezTaskSystem::FinishFrameTasks();
+
+    auto outerTask = [&]() {
+      ezParallelForParams params;
+      params.uiBinSize = 1;
+      params.uiMaxTasksPerThread = 64;
+
+      ezTaskSystem::ParallelForIndexed(
+        0, uiNumInnerItems,
+        [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            iNumItemsProcessed.Increment();
+          }
+        },
+        "NestedParallelFor", params);
+    };
+
+    ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+
+    for (ezUInt32 i = 0; i < uiNumOuterTasks; ++i)
+    {
+      ezSharedPtr<ezTask> pTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "OuterTask", outerTask);
+      pTask->ConfigureTask("OuterTask", ezTaskNesting::Maybe);
+      ezTaskSystem::AddTaskToGroup(group, pTask);
+    }
+
+    ezTaskSystem::StartTaskGroup(group);
+    ezTaskSystem::WaitForGroup(group);
+
+    EZ_TEST_INT(iNumItemsProcessed, uiNumOuterTasks * uiNumInnerItems);
+
+    // updates the per-frame steal statistics
+    ezTaskSystem::FinishFrameTasks();
+
+    ezUInt32 uiTotalTasks = 0;
+    ezUInt32 uiTotalSteals = 0;
+    for (ezUInt32 t = 0; t < ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks); ++t)
+    {
+      ezUInt32 uiNumTasks = 0;
+      ezUInt32 uiNumSteals = 0;
+      ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::ShortTasks, t, &uiNumTasks, &uiNumSteals);
+
+      uiTotalTasks += uiNumTasks;
+      uiTotalSteals += uiNumSteals;
+    }
+
+    EZ_TEST_BOOL(uiTotalTasks > 0);
+
+    // every nested task processes at least one item and can only be stolen once
+    EZ_TEST_BOOL(uiTotalSteals <= uiNumOuterTasks * uiNumInnerItems);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ParallelFor in Tasks that never wait")
+  {
+    // tasks flagged with ezTaskNesting::Never may not wait for other tasks, so a parallel for inside them has to run inline
+    static constexpr ezUInt32 uiNumOuterTasks = 4;
+    static constexpr ezUInt32 uiNumInnerItems = 1000;
+
+    ezAtomicInteger32 iNumItemsProcessed;
+    ezAtomicInteger32 iNumForeignThreadItems;
+
+    auto outerTask = [&]() {
+      const ezThreadID taskThreadId = ezThreadUtils::GetCurrentThreadID();
+
+      auto innerLoop = [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          iNumItemsProcessed.Increment();
+
+          if (ezThreadUtils::GetCurrentThreadID() != taskThreadId)
+          {
+            iNumForeignThreadItems.Increment();
+          }
+        }
+      };
+
+      ezParallelForParams params;
+      params.uiBinSize = 1;
+      params.uiMaxTasksPerThread = 64;
+
+      ezTaskSystem::ParallelForIndexed(0, uiNumInnerItems, innerLoop, "NeverNestedParallelFor", params);
+
+      ezUInt32 items[uiNumInnerItems];
+      ezTaskSystem::ParallelForSingle(
+        ezMakeArrayPtr(items), [&](ezUInt32&) { innerLoop(0, 1); }, "NeverNestedArrayParallelFor", params);
+
+      params.splitMode = ezParallelForSplitMode::Lazy;
+      ezTaskSystem::ParallelForIndexed(0, uiNumInnerItems, innerLoop, "NeverNestedLazyParallelFor", params);
+    };
+
+    ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+
+    for (ezUInt32 i = 0; i < uiNumOuterTasks; ++i)
+    {
+      // ezDelegateTask is configured with ezTaskNesting::Never
+      ezSharedPtr<ezTask> pTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "NeverNestedTask", outerTask);
+      ezTaskSystem::AddTaskToGroup(group, pTask);
+    }
+
+    ezTaskSystem::StartTaskGroup(group);
+    ezTaskSystem::WaitForGroup(group);
+
+    EZ_TEST_INT(iNumItemsProcessed, uiNumOuterTasks * uiNumInnerItems * 3);
+    EZ_TEST_INT(iNumForeignThreadItems, 0);
+  }
+
   // capture profiling info for testing
   /*ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
 
@@ -1,6 +1,7 @@
 #include <GameEngineTest/GameEngineTestPCH.h>
 
 #include "Basics.h"
+#include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Foundation/Basics/Platform/Win/IncludeWindows.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/ConsoleWriter.h>
@@ -197,6 +198,7 @@ void ezGameEngineTestBasics::SetupSubTests()
   AddSubTest("Debug Rendering", SubTests::DebugRendering);
   AddSubTest("Debug Rendering - No Lines", SubTests::DebugRendering2);
   AddSubTest("Load Scene", SubTests::LoadScene);
+  AddSubTest("Physics Query Batches", SubTests::PhysicsQueryBatches);
 }
 
 ezResult ezGameEngineTestBasics::InitializeSubTest(ezInt32 iIdentifier)
@@ -229,6 +231,12 @@ ezResult ezGameEngineTestBasics::InitializeSubTest(ezInt32 iIdentifier)
     return EZ_SUCCESS;
   }
 
+  if (iIdentifier == SubTests::PhysicsQueryBatches)
+  {
+    m_pOwnApplication->SubTestPhysicsQueryBatchesSetup();
+    return EZ_SUCCESS;
+  }
+
   return EZ_FAILURE;
 }
 
@@ -251,6 +259,9 @@ ezTestAppRun ezGameEngineTestBasics::RunSubTest(ezInt32 iIdentifier, ezUInt32 ui
   if (iIdentifier == SubTests::LoadScene)
     return m_pOwnApplication->SubTestLoadSceneExec(m_iFrame);
 
+  if (iIdentifier == SubTests::PhysicsQueryBatches)
+    return m_pOwnApplication->SubTestPhysicsQueryBatchesExec(m_iFrame);
+
   EZ_ASSERT_NOT_IMPLEMENTED;
   return ezTestAppRun::Quit;
 }
@@ -556,3 +567,175 @@ ezTestAppRun ezGameEngineTestApplication_Basics::SubTestLoadSceneExec(ezInt32 iC
 
   return ezTestAppRun::Continue;
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  constexpr ezUInt32 s_uiNumBatchQueries = 40;
+
+  void CompareCastResults(const ezPhysicsCastResult& batchResult, const ezPhysicsCastResult& singleResult)
+  {
+    EZ_TEST_INT(batchResult.m_uiShapeId, singleResult.m_uiShapeId);
+    EZ_TEST_FLOAT(batchResult.m_fDistance, singleResult.m_fDistance, 0.001f);
+    EZ_TEST_VEC3(batchResult.m_vPosition, singleResult.m_vPosition, 0.001f);
+    EZ_TEST_VEC3(batchResult.m_vNormal, singleResult.m_vNormal, 0.001f);
+  }
+
+  /// Runs the same queries through the batched and the single query functions and checks that the results match.
+  /// Returns the number of raycast hits.
+  ezUInt32 CompareQueryBatchesWithSingleQueries(const ezPhysicsWorldModuleInterface* pPhysics, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection)
+  {
+    ezVec3 starts[s_uiNumBatchQueries];
+    ezVec3 dirs[s_uiNumBatchQueries];
+    float distances[s_uiNumBatchQueries];
+    float radii[s_uiNumBatchQueries];
+    ezVec3 positions[s_uiNumBatchQueries];
+
+    for (ezUInt32 i = 0; i < s_uiNumBatchQueries; ++i)
+    {
+      // the queries sample the row of boxes, some of them pass through the gaps between the boxes
+      const float y = -2.0f + i * 0.4f;
+
+      starts[i].Set(0.0f, y, 0.0f);
+      dirs[i].Set(1.0f, 0.0f, 0.0f);
+      distances[i] = (i % 4 == 3) ? 5.0f : 20.0f; // too short to reach the boxes
+      radii[i] = 0.25f;
+      positions[i].Set(10.0f, y, 0.0f);
+    }
+
+    ezPhysicsCastBatch casts;
+    casts.m_Starts = ezMakeArrayPtr(starts);
+    casts.m_Dirs = ezMakeArrayPtr(dirs);
+    casts.m_Distances = ezMakeArrayPtr(distances);
+    casts.m_Radii = ezMakeArrayPtr(radii);
+
+    ezPhysicsOverlapBatch overlaps;
+    overlaps.m_Positions = ezMakeArrayPtr(positions);
+    overlaps.m_Radii = ezMakeArrayPtr(radii);
+
+    ezPhysicsCastResult batchResults[s_uiNumBatchQueries];
+    bool batchHits[s_uiNumBatchQueries];
+
+    const ezUInt32 uiNumRaycastHits = pPhysics->RaycastBatch(ezMakeArrayPtr(batchResults), ezMakeArrayPtr(batchHits), casts, params, collection);
+
+    for (ezUInt32 i = 0; i < s_uiNumBatchQueries; ++i)
+    {
+      ezPhysicsCastResult singleResult;
+      const bool bSingleHit = pPhysics->Raycast(singleResult, starts[i], dirs[i], distances[i], params, collection);
+
+      EZ_TEST_BOOL_MSG(batchHits[i] == bSingleHit, "Raycast {}", i);
+
+      if (batchHits[i] && bSingleHit)
+      {
+        CompareCastResults(batchResults[i], singleResult);
+      }
+    }
+
+    const ezUInt32 uiNumSweepHits = pPhysics->SweepBatch(ezMakeArrayPtr(batchResults), ezMakeArrayPtr(batchHits), casts, params, collection);
+    ezUInt32 uiNumSingleSweepHits = 0;
+
+    for (ezUInt32 i = 0; i < s_uiNumBatchQueries; ++i)
+    {
+      ezPhysicsCastResult singleResult;
+      const bool bSingleHit = pPhysics->SweepTestSphere(singleResult, radii[i], starts[i], dirs[i], distances[i], params, collection);
+
+      EZ_TEST_BOOL_MSG(batchHits[i] == bSingleHit, "Sweep {}", i);
+
+      if (batchHits[i] && bSingleHit)
+      {
+        CompareCastResults(batchResults[i], singleResult);
+      }
+
+      uiNumSingleSweepHits += bSingleHit ? 1 : 0;
+    }
+
+    EZ_TEST_INT(uiNumSweepHits, uiNumSingleSweepHits);
+
+    bool batchOverlaps[s_uiNumBatchQueries];
+    const ezUInt32 uiNumOverlaps = pPhysics->OverlapBatch(ezMakeArrayPtr(batchOverlaps), overlaps, params);
+    ezUInt32 uiNumSingleOverlaps = 0;
+
+    for (ezUInt32 i = 0; i < s_uiNumBatchQueries; ++i)
+    {
+      const bool bSingleOverlap = pPhysics->OverlapTestSphere(radii[i], positions[i], params);
+
+      EZ_TEST_BOOL_MSG(batchOverlaps[i] == bSingleOverlap, "Overlap {}", i);
+
+      uiNumSingleOverlaps += bSingleOverlap ? 1 : 0;
+    }
+
+    EZ_TEST_INT(uiNumOverlaps, uiNumSingleOverlaps);
+
+    return uiNumRaycastHits;
+  }
+} // namespace
+
+void ezGameEngineTestApplication_Basics::SubTestPhysicsQueryBatchesSetup()
+{
+  EZ_LOCK(m_pWorld->GetWriteMarker());
+
+  m_pWorld->Clear();
+
+  ezPhysicsWorldModuleInterface* pPhysics = m_pWorld->GetOrCreateModule<ezPhysicsWorldModuleInterface>();
+
+  if (pPhysics == nullptr)
+    return;
+
+  // a row of boxes with gaps in between, so that the queries produce hits and misses
+  for (ezInt32 i = 0; i < 4; ++i)
+  {
+    ezGameObjectDesc go;
+    go.m_LocalPosition.Set(10.0f, i * 4.0f, 0.0f);
+
+    ezGameObject* pObject;
+    m_pWorld->CreateObject(go, pObject);
+
+    pPhysics->AddStaticCollisionBox(pObject, ezVec3(2.0f));
+  }
+}
+
+ezTestAppRun ezGameEngineTestApplication_Basics::SubTestPhysicsQueryBatchesExec(ezInt32 iCurFrame)
+{
+  if (Run() == ezApplication::Execution::Quit)
+    return ezTestAppRun::Quit;
+
+  // the physics shapes are only added to the scene during the first world update
+  if (iCurFrame < 1)
+    return ezTestAppRun::Continue;
+
+  EZ_LOCK(m_pWorld->GetReadMarker());
+
+  const ezPhysicsWorldModuleInterface* pPhysics = m_pWorld->GetModule<ezPhysicsWorldModuleInterface>();
+
+  if (!EZ_TEST_BOOL_MSG(pPhysics != nullptr, "No physics plugin loaded"))
+    return ezTestAppRun::Quit;
+
+  ezPhysicsQueryParameters params(0);
+
+  // closest and any hit collection, the batch must report the same hits as the single queries
+  const ezUInt32 uiNumHits = CompareQueryBatchesWithSingleQueries(pPhysics, params, ezPhysicsHitCollection::Closest);
+  EZ_TEST_BOOL(uiNumHits > 0 && uiNumHits < s_uiNumBatchQueries);
+  EZ_TEST_INT(CompareQueryBatchesWithSingleQueries(pPhysics, params, ezPhysicsHitCollection::Any), uiNumHits);
+
+  // ignoring the first box filters out some of the hits
+  {
+    ezPhysicsCastResult firstBox;
+    EZ_TEST_BOOL(pPhysics->Raycast(firstBox, ezVec3(0, 0, 0), ezVec3(1, 0, 0), 20.0f, params));
+
+    ezPhysicsQueryParameters ignoreParams = params;
+    ignoreParams.m_uiIgnoreShapeId = firstBox.m_uiShapeId;
+
+    const ezUInt32 uiNumFilteredHits = CompareQueryBatchesWithSingleQueries(pPhysics, ignoreParams, ezPhysicsHitCollection::Closest);
+    EZ_TEST_BOOL(uiNumFilteredHits > 0 && uiNumFilteredHits < uiNumHits);
+  }
+
+  // all boxes are static, so querying only dynamic shapes must not hit anything
+  {
+    ezPhysicsQueryParameters dynamicParams(0, ezPhysicsShapeType::Dynamic);
+
+    EZ_TEST_INT(CompareQueryBatchesWithSingleQueries(pPhysics, dynamicParams, ezPhysicsHitCollection::Closest), 0);
+  }
+
+  return ezTestAppRun::Quit;
+}
@@ -22,6 +22,9 @@ public:
 
   void SubTestLoadSceneSetup();
   ezTestAppRun SubTestLoadSceneExec(ezInt32 iCurFrame);
+
+  void SubTestPhysicsQueryBatchesSetup();
+  ezTestAppRun SubTestPhysicsQueryBatchesExec(ezInt32 iCurFrame);
 };
 
 class ezGameEngineTestBasics : public ezGameEngineTest
@@ -40,6 +43,7 @@ private:
     DebugRendering,
     DebugRendering2,
     LoadScene,
+    PhysicsQueryBatches,
   };
 
   virtual void SetupSubTests() override;
@@ -3,7 +3,15 @@
 #include "ParticlesTest.h"
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
+#include <ParticlePlugin/Behavior/ParticleBehavior_FadeOut.h>
+#include <ParticlePlugin/Behavior/ParticleBehavior_Gravity.h>
+#include <ParticlePlugin/Behavior/ParticleBehavior_Velocity.h>
 #include <ParticlePlugin/Components/ParticleComponent.h>
+#include <ParticlePlugin/Emitter/ParticleEmitter_Burst.h>
+#include <ParticlePlugin/Initializer/ParticleInitializer_VelocityCone.h>
+#include <ParticlePlugin/System/ParticleSystemDescriptor.h>
+#include <ParticlePlugin/System/ParticleSystemInstance.h>
+#include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 
 static ezGameEngineTestParticles s_GameEngineTestParticles;
 
@@ -51,6 +59,7 @@ void ezGameEngineTestParticles::SetupSubTests()
   AddSubTest("DistanceEmitter", SubTests::DistanceEmitter);
   AddSubTest("SharedInstances", SubTests::SharedInstances);
   AddSubTest("LocalSpaceSim", SubTests::LocalSpaceSim);
+  AddSubTest("SimulationThroughput", SubTests::SimulationThroughput);
 }
 
 ezResult ezGameEngineTestParticles::InitializeSubTest(ezInt32 iIdentifier)
@@ -89,6 +98,11 @@ ezResult ezGameEngineTestParticles::InitializeSubTest(ezInt32 iIdentifier)
     m_pOwnApplication->SetupSceneSubTest("Particles/AssetCache/Common/LocalSpaceSim.ezObjectGraph");
     return EZ_SUCCESS;
   }
+  else if (iIdentifier == SubTests::SimulationThroughput)
+  {
+    m_pOwnApplication->SetupThroughputSubTest();
+    return EZ_SUCCESS;
+  }
   else
   {
     const char* szEffects[] = {
@@ -129,6 +143,11 @@ ezTestAppRun ezGameEngineTestParticles::RunSubTest(ezInt32 iIdentifier, ezUInt32
 {
   ++m_iFrame;
 
+  if (iIdentifier == SubTests::SimulationThroughput)
+  {
+    return m_pOwnApplication->ExecThroughputSubTest(m_iFrame);
+  }
+
   return m_pOwnApplication->ExecParticleSubTest(m_iFrame);
 }
 
@@ -184,3 +203,181 @@ ezTestAppRun ezGameEngineTestApplication_Particles::ExecParticleSubTest(ezInt32
 
   return ezTestAppRun::Continue;
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  constexpr ezUInt32 s_uiThroughputParticles = 200000;
+  constexpr ezInt32 s_iThroughputWarmupFrames = 10;
+  constexpr ezInt32 s_iThroughputMeasuredFrames = 60;
+  constexpr ezInt32 s_iThroughputComparedFrames = 10;
+
+  ezParticleEffectHandle CreateThroughputInstance(ezWorld* pWorld, const ezParticleEffectResourceHandle& hEffect)
+  {
+    const void* pSharedInstanceOwner = nullptr;
+    return pWorld->GetOrCreateModule<ezParticleWorldModule>()->CreateEffectInstance(
+      hEffect, 42, nullptr, pSharedInstanceOwner, ezArrayPtr<ezParticleEffectFloatParam>(), ezArrayPtr<ezParticleEffectColorParam>());
+  }
+
+  ezParticleSystemInstance* GetThroughputSystem(ezWorld* pWorld, const ezParticleEffectHandle& hEffect)
+  {
+    ezParticleEffectInstance* pEffect = nullptr;
+    if (!pWorld->GetOrCreateModule<ezParticleWorldModule>()->TryGetEffectInstance(hEffect, pEffect) || pEffect->GetParticleSystems().IsEmpty())
+      return nullptr;
+
+    return pEffect->GetParticleSystems()[0];
+  }
+} // namespace
+
+void ezGameEngineTestApplication_Particles::SetupThroughputSubTest()
+{
+  LoadScene("Particles/AssetCache/Common/Particles1.ezObjectGraph").IgnoreResult();
+
+  const char* szEffectID = "ParticleThroughputEffect";
+  m_hThroughputEffect = ezResourceManager::GetExistingResource<ezParticleEffectResource>(szEffectID);
+
+  if (!m_hThroughputEffect.IsValid())
+  {
+    // a single system with enough particles to be split up into many chunks, that are simulated in parallel
+    // it has no type, so that rendering does not influence the measurement
+    ezParticleSystemDescriptor* pSystem = ezGetStaticRTTI<ezParticleSystemDescriptor>()->GetAllocator()->Allocate<ezParticleSystemDescriptor>();
+    pSystem->m_LifeTime.m_Value = ezTime::Seconds(60);
+
+    {
+      ezParticleEmitterFactory_Burst* pBurst = ezGetStaticRTTI<ezParticleEmitterFactory_Burst>()->GetAllocator()->Allocate<ezParticleEmitterFactory_Burst>();
+      pBurst->m_uiSpawnCountMin = s_uiThroughputParticles;
+
+      // emitters can only be added through reflection
+      ezParticleEmitterFactory* pEmitter = pBurst;
+      auto pEmittersProp = static_cast<ezAbstractArrayProperty*>(ezGetStaticRTTI<ezParticleSystemDescriptor>()->FindPropertyByName("Emitters"));
+      pEmittersProp->Insert(pSystem, 0, &pEmitter);
+    }
+
+    // random start velocities, so that a mix-up of particles between the chunks is detected
+    ezParticleInitializerFactory_VelocityCone* pVelocityCone = ezGetStaticRTTI<ezParticleInitializerFactory_VelocityCone>()->GetAllocator()->Allocate<ezParticleInitializerFactory_VelocityCone>();
+    pVelocityCone->m_Angle = ezAngle::Degree(45);
+    pVelocityCone->m_Speed.m_Value = 2.0f;
+    pVelocityCone->m_Speed.m_fVariance = 0.5f;
+    pSystem->AddInitializerFactory(pVelocityCone);
+
+    pSystem->AddBehaviorFactory(ezGetStaticRTTI<ezParticleBehaviorFactory_Gravity>()->GetAllocator()->Allocate<ezParticleBehaviorFactory_Gravity>());
+
+    ezParticleBehaviorFactory_Velocity* pVelocity = ezGetStaticRTTI<ezParticleBehaviorFactory_Velocity>()->GetAllocator()->Allocate<ezParticleBehaviorFactory_Velocity>();
+    pVelocity->m_fFriction = 0.5f;
+    pSystem->AddBehaviorFactory(pVelocity);
+
+    pSystem->AddBehaviorFactory(ezGetStaticRTTI<ezParticleBehaviorFactory_FadeOut>()->GetAllocator()->Allocate<ezParticleBehaviorFactory_FadeOut>());
+
+    ezParticleEffectResourceDescriptor desc;
+    desc.m_Effect.m_InvisibleUpdateRate = ezEffectInvisibleUpdateRate::FullUpdate;
+    desc.m_Effect.AddParticleSystem(pSystem);
+
+    m_hThroughputEffect = ezResourceManager::CreateResource<ezParticleEffectResource>(szEffectID, std::move(desc), "Particle Throughput Test");
+  }
+
+  // the effect is created without a component, to be able to inspect its particles
+  EZ_LOCK(m_pWorld->GetWriteMarker());
+  m_hThroughputInstance = CreateThroughputInstance(m_pWorld.Borrow(), m_hThroughputEffect);
+  m_hChunkedInstance.Invalidate();
+  m_hSerialInstance.Invalidate();
+}
+
+void ezGameEngineTestApplication_Particles::StartThroughputComparison()
+{
+  EZ_LOCK(m_pWorld->GetWriteMarker());
+
+  if (const ezParticleSystemInstance* pSystem = GetThroughputSystem(m_pWorld.Borrow(), m_hThroughputInstance))
+  {
+    EZ_TEST_INT(pSystem->GetNumActiveParticles(), s_uiThroughputParticles);
+  }
+  else
+  {
+    EZ_TEST_FAILURE("Particle throughput effect was not created", "");
+  }
+
+  m_pWorld->GetOrCreateModule<ezParticleWorldModule>()->DestroyEffectInstance(m_hThroughputInstance, true, nullptr);
+  m_hThroughputInstance.Invalidate();
+
+  // two identical effects, one is simulated in chunks, the other one serially
+  m_hChunkedInstance = CreateThroughputInstance(m_pWorld.Borrow(), m_hThroughputEffect);
+  m_hSerialInstance = CreateThroughputInstance(m_pWorld.Borrow(), m_hThroughputEffect);
+
+  if (ezParticleSystemInstance* pSystem = GetThroughputSystem(m_pWorld.Borrow(), m_hSerialInstance))
+  {
+    pSystem->SetParallelProcessingChunkSize(0);
+  }
+}
+
+void ezGameEngineTestApplication_Particles::CompareThroughputResults()
+{
+  EZ_LOCK(m_pWorld->GetReadMarker());
+
+  const ezParticleSystemInstance* pChunked = GetThroughputSystem(m_pWorld.Borrow(), m_hChunkedInstance);
+  const ezParticleSystemInstance* pSerial = GetThroughputSystem(m_pWorld.Borrow(), m_hSerialInstance);
+
+  if (!EZ_TEST_BOOL(pChunked != nullptr && pSerial != nullptr))
+    return;
+
+  EZ_TEST_INT(pChunked->GetNumActiveParticles(), s_uiThroughputParticles);
+  EZ_TEST_INT(pSerial->GetNumActiveParticles(), s_uiThroughputParticles);
+
+  if (pChunked->GetNumActiveParticles() != pSerial->GetNumActiveParticles())
+    return;
+
+  struct StreamDesc
+  {
+    const char* m_szName;
+    ezProcessingStream::DataType m_Type;
+  };
+
+  const StreamDesc streams[] = {
+    {"Position", ezProcessingStream::DataType::Float4},
+    {"Velocity", ezProcessingStream::DataType::Float3},
+    {"LifeTime", ezProcessingStream::DataType::Half2},
+  };
+
+  for (const StreamDesc& stream : streams)
+  {
+    const ezProcessingStream* pChunkedStream = pChunked->QueryStream(stream.m_szName, stream.m_Type);
+    const ezProcessingStream* pSerialStream = pSerial->QueryStream(stream.m_szName, stream.m_Type);
+
+    if (!EZ_TEST_BOOL_MSG(pChunkedStream != nullptr && pSerialStream != nullptr, "Stream '%s' is missing", stream.m_szName))
+      continue;
+
+    const ezUInt64 uiNumBytes = pChunked->GetNumActiveParticles() * pChunkedStream->GetElementStride();
+    EZ_TEST_BOOL_MSG(ezMemoryUtils::IsEqual(pChunkedStream->GetData<ezUInt8>(), pSerialStream->GetData<ezUInt8>(), static_cast<size_t>(uiNumBytes)),
+      "Chunked and serial simulation differ in stream '%s'", stream.m_szName);
+  }
+}
+
+ezTestAppRun ezGameEngineTestApplication_Particles::ExecThroughputSubTest(ezInt32 iCurFrame)
+{
+  // the first frames spawn all particles and load the remaining resources
+  if (iCurFrame == s_iThroughputWarmupFrames)
+  {
+    m_ThroughputTimer.StopAndReset();
+    m_ThroughputTimer.Resume();
+  }
+
+  if (Run() == ezApplication::Execution::Quit)
+    return ezTestAppRun::Quit;
+
+  if (iCurFrame == s_iThroughputWarmupFrames + s_iThroughputMeasuredFrames - 1)
+  {
+    const ezTime tFrame = m_ThroughputTimer.GetRunningTotal() / s_iThroughputMeasuredFrames;
+
+    ezLog::Info("Particle simulation: {} particles, {} ms per frame, {} million particles per second", s_uiThroughputParticles,
+      ezArgF(tFrame.GetMilliseconds(), 3), ezArgF(s_uiThroughputParticles / tFrame.GetSeconds() / 1000000.0, 2));
+
+    StartThroughputComparison();
+  }
+
+  if (iCurFrame == s_iThroughputWarmupFrames + s_iThroughputMeasuredFrames + s_iThroughputComparedFrames - 1)
+  {
+    CompareThroughputResults();
+    return ezTestAppRun::Quit;
+  }
+
+  return ezTestAppRun::Continue;
+}
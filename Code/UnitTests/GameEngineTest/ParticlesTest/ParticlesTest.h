@@ -3,6 +3,8 @@
 #include <GameEngineTest/GameEngineTestPCH.h>
 
 #include "../TestClass/TestClass.h"
+#include <Foundation/Time/Stopwatch.h>
+#include <ParticlePlugin/Resources/ParticleEffectResource.h>
 
 class ezGameEngineTestApplication_Particles : public ezGameEngineTestApplication
 {
@@ -12,6 +14,19 @@ public:
   void SetupSceneSubTest(const char* szFile);
   void SetupParticleSubTest(const char* szFile);
   ezTestAppRun ExecParticleSubTest(ezInt32 iCurFrame);
+
+  void SetupThroughputSubTest();
+  ezTestAppRun ExecThroughputSubTest(ezInt32 iCurFrame);
+
+private:
+  void StartThroughputComparison();
+  void CompareThroughputResults();
+
+  ezParticleEffectResourceHandle m_hThroughputEffect;
+  ezParticleEffectHandle m_hThroughputInstance;
+  ezParticleEffectHandle m_hChunkedInstance;
+  ezParticleEffectHandle m_hSerialInstance;
+  ezStopwatch m_ThroughputTimer;
 };
 
 class ezGameEngineTestParticles : public ezGameEngineTest
@@ -56,6 +71,7 @@ private:
     SharedInstances,
     EventReactionEffect,
     LocalSpaceSim,
+    SimulationThroughput,
   };
 
   virtual void SetupSubTests() override;
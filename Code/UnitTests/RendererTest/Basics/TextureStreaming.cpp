@@ -0,0 +1,86 @@
+#include <RendererTest/RendererTestPCH.h>
+
+#include <RendererCore/Textures/TextureStreamingManager.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(TextureStreaming);
+
+EZ_CREATE_SIMPLE_TEST(TextureStreaming, DesiredQualityLevel)
+{
+  // 1024 * 1024 texture with 11 mipmaps: mip tail of 6 mipmaps (32 * 32) and 5 quality levels above it
+  EZ_TEST_INT(ezTextureStreamingManager::ComputeDesiredQualityLevel(6, 1024, 2000.0f), 6);
+  EZ_TEST_INT(ezTextureStreamingManager::ComputeDesiredQualityLevel(6, 1024, 1024.0f), 6);
+  EZ_TEST_INT(ezTextureStreamingManager::ComputeDesiredQualityLevel(6, 1024, 1000.0f), 6);
+  EZ_TEST_INT(ezTextureStreamingManager::ComputeDesiredQualityLevel(6, 1024, 512.0f), 5);
+  EZ_TEST_INT(ezTextureStreamingManager::ComputeDesiredQualityLevel(6, 1024, 100.0f), 3);
+  EZ_TEST_INT(ezTextureStreamingManager::ComputeDesiredQualityLevel(6, 1024, 1.0f), 1);
+  EZ_TEST_INT(ezTextureStreamingManager::ComputeDesiredQualityLevel(6, 1024, 0.0f), 1);
+  EZ_TEST_INT(ezTextureStreamingManager::ComputeDesiredQualityLevel(1, 32, 1000.0f), 1);
+}
+
+EZ_CREATE_SIMPLE_TEST(TextureStreaming, QualityLevels)
+{
+  // every quality level needs four times the memory of the one below
+  const ezUInt32 memory[] = {1, 4, 16, 64, 256};
+
+  ezTextureStreamingManager::TextureInfo textures[3];
+  for (auto& texture : textures)
+  {
+    texture.m_uiNumQualityLevels = 5;
+    texture.m_uiDesiredQualityLevel = 5;
+    texture.m_QualityLevelMemory = ezMakeArrayPtr(memory);
+  }
+
+  textures[0].m_fPriority = 100.0f;
+  textures[1].m_fPriority = 10.0f;
+  textures[2].m_fPriority = 0.0f;
+
+  ezUInt8 levels[3] = {};
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Enough Memory")
+  {
+    EZ_TEST_INT(ezTextureStreamingManager::ComputeQualityLevels(ezMakeArrayPtr(textures), 10000, ezMakeArrayPtr(levels)), 3 * 341);
+    EZ_TEST_INT(levels[0], 5);
+    EZ_TEST_INT(levels[1], 5);
+    EZ_TEST_INT(levels[2], 5);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Desired Quality")
+  {
+    textures[1].m_uiDesiredQualityLevel = 2;
+    textures[2].m_uiDesiredQualityLevel = 7;
+
+    EZ_TEST_INT(ezTextureStreamingManager::ComputeQualityLevels(ezMakeArrayPtr(textures), 10000, ezMakeArrayPtr(levels)), 341 + 5 + 341);
+    EZ_TEST_INT(levels[0], 5);
+    EZ_TEST_INT(levels[1], 2);
+    EZ_TEST_INT(levels[2], 5);
+
+    textures[1].m_uiDesiredQualityLevel = 5;
+    textures[2].m_uiDesiredQualityLevel = 5;
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Even Reduction")
+  {
+    // not enough for two full textures, both used textures lose one quality level, the unused one gets what is left over
+    EZ_TEST_INT(ezTextureStreamingManager::ComputeQualityLevels(ezMakeArrayPtr(textures), 400, ezMakeArrayPtr(levels)), 85 + 85 + 85);
+    EZ_TEST_INT(levels[0], 4);
+    EZ_TEST_INT(levels[1], 4);
+    EZ_TEST_INT(levels[2], 4);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Priority")
+  {
+    // only one used texture can have one quality level more, the one with the higher priority gets it
+    EZ_TEST_INT(ezTextureStreamingManager::ComputeQualityLevels(ezMakeArrayPtr(textures), 500, ezMakeArrayPtr(levels)), 341 + 85 + 21);
+    EZ_TEST_INT(levels[0], 5);
+    EZ_TEST_INT(levels[1], 4);
+    EZ_TEST_INT(levels[2], 3);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mip Tail Exceeds Budget")
+  {
+    EZ_TEST_INT(ezTextureStreamingManager::ComputeQualityLevels(ezMakeArrayPtr(textures), 0, ezMakeArrayPtr(levels)), 3);
+    EZ_TEST_INT(levels[0], 1);
+    EZ_TEST_INT(levels[1], 1);
+    EZ_TEST_INT(levels[2], 1);
+  }
+}